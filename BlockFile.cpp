@@ -0,0 +1,404 @@
+/**********************************************
+ * BlockFile Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: The POSIX headers and calls are guarded for Windows, which reads blocks with a locked seek.
+ *--------------------------------
+ * Purpose:
+ * This module implements the block file writer and reader. The reader takes the
+ * whole index into memory when it opens the file and reads blocks with pread, so
+ * any number of threads can read blocks of one open file; Windows, without pread,
+ * serializes the reads instead. A scan runs a pipeline:
+ * worker threads claim blocks in order and decompress each into a slot of a small
+ * ring, and the calling thread visits the slots in order, freeing each for the
+ * block a ring's length further on.
+ **********************************************/
+#include "BlockFile.h"
+#include "Lz4Block.h"
+#include "RecordChecksum.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define O_CLOEXEC _O_BINARY // No descriptors are inherited; blocks must not pass through text mode
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//================================
+// Constants
+//================================
+static const char BLOCK_MAGIC[8] = {'I', 'T', 'R', 'K', 'B', 'L', 'K', '1'};
+static const size_t SLOTS_PER_THREAD = 2;      // Blocks decompressed ahead of the visit, per worker
+
+// The end of a block file.
+struct BlockTrailer {
+    char magic[8];
+    uint32_t recordSize;
+    uint32_t blockBytes;        // BLOCK_BYTES when written
+    uint64_t records;
+    uint64_t indexOffset;
+    uint32_t blocks;
+    uint32_t indexChecksum;     // CRC32C of the index entries
+};
+static_assert(sizeof(BlockTrailer) == 40, "The block trailer is 40 bytes");
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: readAt
+ * Description: Reads length bytes at offset, retrying short reads.
+ * Returns: bool - False if the file ends first or cannot be read
+ **********************************************/
+static bool readAt(int fd, void* buffer, size_t length, long long offset) {
+    char* at = static_cast<char*>(buffer);
+#ifdef _WIN32
+    // No positional reads: the scan's threads share the descriptor, so each seek and read is done under a lock
+    static std::mutex seekMutex;
+    std::lock_guard<std::mutex> lock(seekMutex);
+    if (_lseeki64(fd, offset, SEEK_SET) < 0)
+        return false;
+    while (length > 0) {
+        int count = _read(fd, at, static_cast<unsigned int>(std::min<size_t>(length, 1 << 30)));
+        if (count <= 0)
+            return false;
+        at += count;
+        length -= static_cast<size_t>(count);
+    }
+#else
+    while (length > 0) {
+        ssize_t count = ::pread(fd, at, length, static_cast<off_t>(offset));
+        if (count <= 0)
+            return false;
+        at += count;
+        length -= static_cast<size_t>(count);
+        offset += count;
+    }
+#endif
+    return true;
+}
+
+/**********************************************
+ * Function: fileLength
+ * Description: Returns the length of an open file, or -1 if it cannot be found.
+ **********************************************/
+static long long fileLength(int fd) {
+#ifdef _WIN32
+    return _lseeki64(fd, 0, SEEK_END);
+#else
+    return static_cast<long long>(::lseek(fd, 0, SEEK_END));
+#endif
+}
+
+//================================
+// BlockWriter
+//================================
+
+/**********************************************
+ * Constructor: BlockWriter
+ * Description: Creates the file. A block holds as many whole records as fit in
+ *              BLOCK_BYTES, and at least one.
+ * Parameters:
+ * - path: The file to write
+ * - recordSize: The size of every record
+ **********************************************/
+BlockWriter::BlockWriter(const std::string& path, size_t recordSize)
+    : out(path, std::ios::binary | std::ios::trunc), recordSize(recordSize),
+      blockRecords(std::max<size_t>(1, BLOCK_BYTES / recordSize)), block(blockRecords * recordSize),
+      compressed(Lz4Block::bound(blockRecords * recordSize)) {}
+
+/**********************************************
+ * Function: append
+ * Description: Copies a record into the block being filled, writing the block out once it is full.
+ * Parameters:
+ * - record: The record, recordSize bytes
+ * - key: The record's key, kept in the index for the first record of each block
+ * Returns: bool - False if the file could not be written
+ **********************************************/
+bool BlockWriter::append(const void* record, long long key) {
+    if (filled == 0)
+        firstKey = key;
+    std::memcpy(block.data() + filled * recordSize, record, recordSize);
+    if (++filled == blockRecords)
+        return flush();
+    return static_cast<bool>(out);
+}
+
+/**********************************************
+ * Function: flush
+ * Description: Compresses the block being filled and writes it, or writes it as it
+ *              is if compression does not make it smaller.
+ * Returns: bool - False if the file could not be written
+ **********************************************/
+bool BlockWriter::flush() {
+    if (filled == 0)
+        return static_cast<bool>(out);
+    size_t rawSize = filled * recordSize;
+    size_t size = Lz4Block::compress(block.data(), rawSize, compressed.data(), compressed.size());
+    bool packed = size > 0 && size < rawSize;
+    const char* stored = packed ? compressed.data() : block.data();
+    if (!packed)
+        size = rawSize;
+
+    BlockEntry entry{};
+    entry.offset = static_cast<uint64_t>(totals.storedBytes);
+    entry.storedSize = static_cast<uint32_t>(size);
+    entry.records = static_cast<uint32_t>(filled);
+    entry.firstKey = firstKey;
+    entry.checksum = RecordChecksum::crc32c(stored, size);
+    entry.compressed = packed ? 1 : 0;
+    index.push_back(entry);
+    out.write(stored, static_cast<std::streamsize>(size));
+
+    totals.records += static_cast<long long>(filled);
+    totals.rawBytes += static_cast<long long>(rawSize);
+    totals.storedBytes += static_cast<long long>(size);
+    totals.blocks++;
+    filled = 0;
+    return static_cast<bool>(out);
+}
+
+/**********************************************
+ * Function: close
+ * Description: Writes the last block, then the index, then the trailer.
+ * Returns: bool - False if any part of the file could not be written
+ **********************************************/
+bool BlockWriter::close() {
+    flush();
+    BlockTrailer trailer{};
+    std::memcpy(trailer.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    trailer.recordSize = static_cast<uint32_t>(recordSize);
+    trailer.blockBytes = static_cast<uint32_t>(BLOCK_BYTES);
+    trailer.records = static_cast<uint64_t>(totals.records);
+    trailer.indexOffset = static_cast<uint64_t>(totals.storedBytes);
+    trailer.blocks = static_cast<uint32_t>(index.size());
+    trailer.indexChecksum = RecordChecksum::crc32c(index.data(), index.size() * sizeof(BlockEntry));
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(BlockEntry)));
+    out.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    totals.storedBytes += static_cast<long long>(index.size() * sizeof(BlockEntry) + sizeof(trailer));
+    out.close();
+    return !out.fail();
+}
+
+const BlockStats& BlockWriter::stats() const { return totals; }
+
+//================================
+// BlockReader
+//================================
+
+/**********************************************
+ * Constructor: BlockReader
+ * Description:
+ * Opens the file and reads its trailer and index. The file is only used if the
+ * index passes its CRC32C and every entry lies inside the file and describes
+ * whole records, so a damaged index can never lead a read astray.
+ * Parameters:
+ * - path: The block file
+ **********************************************/
+BlockReader::BlockReader(const std::string& path) : path(path) {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    long long end = fileLength(fd);
+    BlockTrailer trailer;
+    if (end < static_cast<long long>(sizeof(trailer)) ||
+        !readAt(fd, &trailer, sizeof(trailer), end - static_cast<long long>(sizeof(trailer))) ||
+        std::memcmp(trailer.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0 || trailer.recordSize == 0 ||
+        trailer.indexOffset + static_cast<uint64_t>(trailer.blocks) * sizeof(BlockEntry) + sizeof(trailer) != static_cast<uint64_t>(end))
+        return;
+    fileBytes = end;
+    storedRecordSize = trailer.recordSize;
+    index.resize(trailer.blocks);
+    if (!readAt(fd, index.data(), index.size() * sizeof(BlockEntry), static_cast<long long>(trailer.indexOffset)) ||
+        RecordChecksum::crc32c(index.data(), index.size() * sizeof(BlockEntry)) != trailer.indexChecksum)
+        return;
+    size_t maximumRecords = std::max<size_t>(1, trailer.blockBytes / trailer.recordSize);
+    uint64_t records = 0;
+    for (const BlockEntry& entry : index) {
+        if (entry.records == 0 || entry.records > maximumRecords || entry.offset + entry.storedSize > trailer.indexOffset)
+            return;
+        records += entry.records;
+    }
+    if (records != trailer.records)
+        return;
+    recordCount = static_cast<long long>(records);
+    ok = true;
+}
+
+/**********************************************
+ * Destructor: ~BlockReader
+ * Description: Closes the file.
+ **********************************************/
+BlockReader::~BlockReader() {
+    if (fd >= 0)
+        ::close(fd);
+}
+
+bool BlockReader::valid() const { return ok; }
+size_t BlockReader::recordSize() const { return storedRecordSize; }
+long long BlockReader::records() const { return ok ? recordCount : 0; }
+size_t BlockReader::blocks() const { return ok ? index.size() : 0; }
+size_t BlockReader::blockRecords(size_t block) const { return index[block].records; }
+long long BlockReader::firstKey(size_t block) const { return index[block].firstKey; }
+
+/**********************************************
+ * Function: findBlock
+ * Description: Finds the last block whose first key is at most key by binary search of the index.
+ * Parameters:
+ * - key: The key to find
+ * Returns: size_t - The block, or blocks() if key is before the first block
+ **********************************************/
+size_t BlockReader::findBlock(long long key) const {
+    if (!ok)
+        return 0;
+    auto after = std::upper_bound(index.begin(), index.end(), key,
+                                  [](long long wanted, const BlockEntry& entry) { return wanted < entry.firstKey; });
+    if (after == index.begin())
+        return index.size();
+    return static_cast<size_t>(after - index.begin()) - 1;
+}
+
+/**********************************************
+ * Function: readBlock
+ * Description: Reads one block, checks its CRC32C and decompresses it. The
+ *              decompressor checks every length, so even a block whose damage the
+ *              CRC32C missed cannot overrun records.
+ * Parameters:
+ * - block: The block number
+ * - records: Receives the block's records
+ * Returns: bool - False if the block is damaged or cannot be read
+ **********************************************/
+bool BlockReader::readBlock(size_t block, std::vector<char>& records) const {
+    if (!ok || block >= index.size())
+        return false;
+    const BlockEntry& entry = index[block];
+    size_t rawSize = static_cast<size_t>(entry.records) * storedRecordSize;
+    records.resize(rawSize);
+    if (!entry.compressed) {
+        return entry.storedSize == rawSize && readAt(fd, records.data(), rawSize, static_cast<long long>(entry.offset)) &&
+               RecordChecksum::crc32c(records.data(), rawSize) == entry.checksum;
+    }
+    std::vector<char> stored(entry.storedSize);
+    return readAt(fd, stored.data(), stored.size(), static_cast<long long>(entry.offset)) &&
+           RecordChecksum::crc32c(stored.data(), stored.size()) == entry.checksum &&
+           Lz4Block::decompress(stored.data(), stored.size(), records.data(), rawSize);
+}
+
+/**********************************************
+ * Function: scan
+ * Description:
+ * Visits every block in file order. With more than one block, worker threads
+ * claim blocks in order and decompress each into slot block % slots once the
+ * visit has finished with the block that used the slot before; the calling
+ * thread waits for each slot in turn and visits it. A damaged block is reported
+ * and skipped.
+ * Parameters:
+ * - visit: Called with the records of each block and their number
+ * Returns: bool - False if a block was skipped
+ **********************************************/
+bool BlockReader::scan(const std::function<void(const char* records, size_t count)>& visit) const {
+    size_t count = blocks();
+    size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), count);
+    bool intact = true;
+    auto skip = [&](size_t block) {
+        std::cerr << path << ": block " << block << " fails its checksum and is skipped; run --scrub to check every block." << std::endl;
+        intact = false;
+    };
+    if (threadCount <= 1) {
+        std::vector<char> records;
+        for (size_t block = 0; block < count; block++) {
+            if (readBlock(block, records))
+                visit(records.data(), index[block].records);
+            else
+                skip(block);
+        }
+        return intact;
+    }
+
+    enum SlotState { EMPTY, READY, DAMAGED };
+    struct Slot {
+        std::vector<char> records;
+        SlotState state = EMPTY;
+    };
+    size_t slotCount = threadCount * SLOTS_PER_THREAD;
+    std::vector<Slot> slots(slotCount);
+    std::mutex slotMutex;
+    std::condition_variable changed;
+    size_t visited = 0;         // Blocks the visit has finished with
+    bool stopping = false;
+    std::atomic<size_t> nextBlock(0);
+    auto work = [&]() {
+        for (size_t block = nextBlock++; block < count; block = nextBlock++) {
+            Slot& slot = slots[block % slotCount];
+            {
+                std::unique_lock<std::mutex> lock(slotMutex);
+                changed.wait(lock, [&]() { return stopping || block < visited + slotCount; });
+                if (stopping)
+                    return;
+            }
+            bool read = readBlock(block, slot.records);
+            {
+                std::lock_guard<std::mutex> lock(slotMutex);
+                slot.state = read ? READY : DAMAGED;
+            }
+            changed.notify_all();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++)
+        threads.emplace_back(work);
+
+    for (size_t block = 0; block < count; block++) {
+        Slot& slot = slots[block % slotCount];
+        SlotState state;
+        {
+            std::unique_lock<std::mutex> lock(slotMutex);
+            changed.wait(lock, [&]() { return slot.state != EMPTY; });
+            state = slot.state;
+        }
+        if (state == READY)
+            visit(slot.records.data(), index[block].records);
+        else
+            skip(block);
+        {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            slot.state = EMPTY;
+            visited = block + 1;
+        }
+        changed.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    for (std::thread& thread : threads)
+        thread.join();
+    return intact;
+}
+
+/**********************************************
+ * Function: stats
+ * Description: Returns the sizes of the file from its index.
+ **********************************************/
+BlockStats BlockReader::stats() const {
+    BlockStats stats;
+    if (!ok)
+        return stats;
+    stats.records = recordCount;
+    stats.rawBytes = recordCount * static_cast<long long>(storedRecordSize);
+    stats.storedBytes = fileBytes;
+    stats.blocks = index.size();
+    return stats;
+}
@@ -0,0 +1,182 @@
+/**********************************************
+ * BlockFile Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module stores fixed-size records in compressed blocks, for data that is
+ * written once and then only read, such as the archives of closed change items.
+ * Their records are mostly zero-padded text, which compresses many times over.
+ * Records are grouped into blocks of at most 64 KiB, whole records only, and each
+ * block is compressed by itself with Lz4Block, or stored as it is if that does not
+ * make it smaller. Since no block depends on another, one record is found by
+ * reading the block index and one block, and a scan decompresses several blocks
+ * at once on separate threads.
+ *
+ * A block file holds the blocks, then the block index, then a trailer:
+ *
+ *     [block 0] [block 1] ... [index entry per block] [trailer]
+ *
+ * An index entry gives a block's offset, stored size, record count, CRC32C of the
+ * stored bytes and the key of its first record, so a file written in key order is
+ * searched by key without reading any block but the one holding it. The trailer
+ * gives the record size, the number of blocks and records, where the index starts
+ * and the index's own CRC32C; it is written last, so a file cut short is rejected.
+ * A block file is never changed once written: it is replaced by a new one.
+ **********************************************/
+#ifndef BLOCKFILE_H
+#define BLOCKFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const size_t BLOCK_BYTES = 64 << 10;     // Uncompressed bytes per block at most
+
+//=============================
+// Record Types
+//=============================
+
+// One entry of the block index, as stored.
+struct BlockEntry {
+    uint64_t offset;            // Where the block starts
+    uint32_t storedSize;        // Bytes of the block as stored
+    uint32_t records;           // Records in the block
+    int64_t firstKey;           // Key of the block's first record
+    uint32_t checksum;          // CRC32C of the stored bytes
+    uint32_t compressed;        // 1 if the block is compressed, 0 if stored as it is
+};
+static_assert(sizeof(BlockEntry) == 32, "Block index entries are 32 bytes");
+
+// Sizes of a block file.
+struct BlockStats {
+    long long records = 0;
+    long long rawBytes = 0;         // The records uncompressed
+    long long storedBytes = 0;      // The whole file, index and trailer included
+    size_t blocks = 0;
+
+    double ratio() const { return storedBytes > 0 ? static_cast<double>(rawBytes) / static_cast<double>(storedBytes) : 0.0; }
+};
+
+//=============================
+// Class Declarations
+//=============================
+
+// Writes a new block file, record by record. Used by one thread at a time.
+class BlockWriter {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    BlockWriter(const std::string& path, size_t recordSize);
+    // Description: Creates the file, replacing any file of that name.
+
+    BlockWriter(const BlockWriter&) = delete;
+    BlockWriter& operator=(const BlockWriter&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    bool append(const void* record, long long key);
+    // Description: Adds a record. key is the record's key, e.g. its change ID; the records of a file
+    //              meant to be searched by key are appended in key order.
+    // Returns: bool - False if the file could not be written.
+
+    //----------------------------------------------------------
+    bool close();
+    // Description: Writes the last block, the index and the trailer. Nothing appended is readable before.
+    // Returns: bool - False if any part of the file could not be written.
+
+    //----------------------------------------------------------
+    const BlockStats& stats() const;
+    // Description: Returns the sizes written so far; complete after close.
+
+private:
+    bool flush();
+
+    std::ofstream out;
+    size_t recordSize;
+    size_t blockRecords;            // Records per full block
+    std::vector<char> block;        // Records of the block being filled
+    size_t filled = 0;
+    long long firstKey = 0;
+    std::vector<char> compressed;
+    std::vector<BlockEntry> index;
+    BlockStats totals;
+};
+
+// Reads a block file. Any number of threads may read blocks at once.
+class BlockReader {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    explicit BlockReader(const std::string& path);
+    // Description: Opens the file and reads its trailer and index.
+
+    //----------------------------------------------------------
+    ~BlockReader();
+    // Description: Closes the file.
+
+    BlockReader(const BlockReader&) = delete;
+    BlockReader& operator=(const BlockReader&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    bool valid() const;
+    // Description: Returns false for a missing or empty file, or one whose trailer or index is damaged
+    //              or cut short.
+
+    //----------------------------------------------------------
+    size_t recordSize() const;
+    long long records() const;
+    size_t blocks() const;
+    size_t blockRecords(size_t block) const;
+    long long firstKey(size_t block) const;
+    // Description: Describe the file and its blocks.
+
+    //----------------------------------------------------------
+    size_t findBlock(long long key) const;
+    // Description: For a file written in key order, returns the only block that can hold key,
+    //              or blocks() if none can.
+
+    //----------------------------------------------------------
+    bool readBlock(size_t block, std::vector<char>& records) const;
+    // Description: Reads and decompresses one block into records, checking its CRC32C first.
+    // Returns: bool - False if the block is damaged.
+
+    //----------------------------------------------------------
+    bool scan(const std::function<void(const char* records, size_t count)>& visit) const;
+    // Description: Calls visit with the records of every block, in file order. Blocks are read and
+    //              decompressed ahead on up to one thread per core while visit runs on this one.
+    //              A damaged block is reported and skipped.
+    // Returns: bool - False if a block was skipped.
+
+    //----------------------------------------------------------
+    BlockStats stats() const;
+    // Description: Returns the sizes of the file.
+
+private:
+    std::string path;
+    int fd = -1;
+    long long fileBytes = 0;
+    size_t storedRecordSize = 0;
+    long long recordCount = 0;
+    std::vector<BlockEntry> index;
+    bool ok = false;
+};
+
+#endif // BLOCKFILE_H
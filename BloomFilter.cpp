@@ -0,0 +1,559 @@
+/**********************************************
+ * BloomFilter Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Rebuilds and replica key loads read data files in any record version.
+ * - 2026-10-19: Rebuilds read archives block by block; added addBlockFile.
+ *--------------------------------
+ * Purpose:
+ * This module implements the persisted blocked Bloom filters. A filter file is a
+ * 64-byte header followed by the blocks; each block is eight 64-bit words and a
+ * key sets one bit in every word, chosen by multiplying its hash with eight odd
+ * constants. Bits and counters in the shared mapping are only changed with atomic
+ * operations, so threads and processes never lose each other's updates.
+ **********************************************/
+#include "BloomFilter.h"
+#include "BlockFile.h"
+#include "FileFormat.h"
+#include "StorageLayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//================================
+// Constants
+//================================
+static const char FILTER_MAGIC[8] = {'T', 'R', 'K', 'B', 'L', 'O', 'O', 'M'};
+static const int WORDS_PER_BLOCK = 8;
+static const int BITS_PER_BLOCK = WORDS_PER_BLOCK * 64;
+static const uint32_t BLOCK_SALTS[WORDS_PER_BLOCK] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+//================================
+// Record Types
+//================================
+
+// The start of a filter file. Every field is 8 bytes so it can be updated atomically in place.
+struct FilterHeader {
+    char magic[8];
+    uint64_t blockCount;
+    uint64_t retired;          // Set once a rebuilt file has replaced this one
+    uint64_t keys;
+    uint64_t lookups;
+    uint64_t definiteMisses;
+    uint64_t falsePositives;
+    uint64_t reserved;
+};
+static_assert(sizeof(FilterHeader) == 64, "The blocks start on a cache line");
+
+// A filter file mapped into this process.
+struct BloomFilter::Mapping {
+    void* base = nullptr;
+    size_t length = 0;
+    FilterHeader* header = nullptr;
+    uint64_t* blocks = nullptr;
+
+    long long capacity() const {
+        return static_cast<long long>(header->blockCount) * BITS_PER_BLOCK / FILTER_BITS_PER_KEY;
+    }
+
+    ~Mapping() {
+#ifndef _WIN32
+        if (base != nullptr)
+            munmap(base, length);
+#endif
+    }
+};
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: registry
+ * Description: Returns every filter constructed in this process.
+ **********************************************/
+static std::vector<BloomFilter*>& registry() {
+    static std::vector<BloomFilter*> filters;
+    return filters;
+}
+
+/**********************************************
+ * Function: hashKey
+ * Description: Hashes a key with FNV-1a, then mixes the result so that keys differing
+ *              only in their last byte still land in unrelated blocks. The hash is
+ *              stored implicitly in the file, so it must never change.
+ **********************************************/
+static uint64_t hashKey(std::string_view key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+/**********************************************
+ * Function: blockOf
+ * Description: Maps the high half of a hash onto a block without a division.
+ **********************************************/
+static uint64_t* blockOf(uint64_t* blocks, uint64_t blockCount, uint64_t hash) {
+    uint64_t block = ((hash >> 32) * blockCount) >> 32;
+    return blocks + block * WORDS_PER_BLOCK;
+}
+
+/**********************************************
+ * Function: bitOf
+ * Description: Returns the bit a hash sets in one word of its block.
+ **********************************************/
+static uint64_t bitOf(uint64_t hash, int word) {
+    uint32_t product = static_cast<uint32_t>(hash) * BLOCK_SALTS[word];
+    return 1ULL << (product >> 26);
+}
+
+/**********************************************
+ * Function: counter
+ * Description: Views a header field as an atomic counter.
+ **********************************************/
+static std::atomic_ref<uint64_t> counter(uint64_t& field) {
+    return std::atomic_ref<uint64_t>(field);
+}
+
+/**********************************************
+ * Function: expectedRate
+ * Description:
+ * Predicts the false positive rate of a filter. The keys per block follow a
+ * Poisson distribution; a block holding j keys answers "maybe" for an absent key
+ * when all eight of its words have the probed bit set.
+ * Parameters:
+ * - keys: The keys added
+ * - blockCount: The number of blocks
+ * Returns: double - The rate between 0 and 1
+ **********************************************/
+static double expectedRate(long long keys, uint64_t blockCount) {
+    if (blockCount == 0 || keys <= 0)
+        return 0;
+    double mean = static_cast<double>(keys) / static_cast<double>(blockCount);
+    double rate = 0;
+    double probability = std::exp(-mean);
+    int last = static_cast<int>(mean * 4 + 64);
+    for (int j = 0; j <= last; j++) {
+        if (j > 0)
+            probability *= mean / j;
+        rate += probability * std::pow(1 - std::pow(63.0 / 64.0, j), WORDS_PER_BLOCK);
+    }
+    return rate;
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Constructor: BloomFilter
+ * Description: Records where the filter and its data live and registers the filter.
+ **********************************************/
+BloomFilter::BloomFilter(const char* filterFile, const char* anchorFile, long long lockOffset, size_t recordSize,
+                         std::vector<std::string> (*dataFiles)(), void (*recordKeys)(const char* record, const KeyVisitor& visit))
+    : filterPath(filterFile), anchorPath(anchorFile), anchorOffset(lockOffset), recordBytes(recordSize), files(dataFiles), keysOf(recordKeys), current(nullptr) {
+    registry().push_back(this);
+}
+
+/**********************************************
+ * Destructor: BloomFilter
+ * Description: Unregisters the filter; the mappings are released with it.
+ **********************************************/
+BloomFilter::~BloomFilter() {
+    std::vector<BloomFilter*>& filters = registry();
+    filters.erase(std::remove(filters.begin(), filters.end(), this), filters.end());
+}
+
+/**********************************************
+ * Constructor: WriteScope
+ * Description: Takes the shared lock on the sentinel byte of the filter's data file.
+ **********************************************/
+BloomFilter::WriteScope::WriteScope(const BloomFilter& filter) : anchorLock(filter.anchorPath.c_str(), filter.anchorOffset, 1, false) {}
+
+#ifndef _WIN32
+
+/**********************************************
+ * Function: openMapping
+ * Description: Maps the filter file if it is complete and not retired.
+ * Returns: Mapping* - The new mapping, owned by mappings, or nullptr.
+ **********************************************/
+BloomFilter::Mapping* BloomFilter::openMapping() {
+    int fd = open(filterPath.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+    struct stat status;
+    FilterHeader header;
+    bool usable = fstat(fd, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(FilterHeader)) &&
+                  pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                  memcmp(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC)) == 0 && header.blockCount > 0 && header.retired == 0 &&
+                  static_cast<uint64_t>(status.st_size) == sizeof(FilterHeader) + header.blockCount * WORDS_PER_BLOCK * sizeof(uint64_t);
+    if (!usable) {
+        close(fd);
+        return nullptr;
+    }
+
+    auto mapping = std::make_unique<Mapping>();
+    mapping->length = static_cast<size_t>(status.st_size);
+    mapping->base = mmap(nullptr, mapping->length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping->base == MAP_FAILED) {
+        mapping->base = nullptr;
+        return nullptr;
+    }
+    mapping->header = static_cast<FilterHeader*>(mapping->base);
+    mapping->blocks = reinterpret_cast<uint64_t*>(static_cast<char*>(mapping->base) + sizeof(FilterHeader));
+    mappings.push_back(std::move(mapping));
+    return mappings.back().get();
+}
+
+/**********************************************
+ * Function: init
+ * Description: Maps the existing filter, or builds one from the data.
+ * Returns: bool - True if lookups can use the filter.
+ **********************************************/
+bool BloomFilter::init() {
+    {
+        std::lock_guard<std::mutex> lock(mappingMutex);
+        if (current.load() != nullptr)
+            return true;
+        Mapping* mapping = openMapping();
+        if (mapping != nullptr) {
+            current.store(mapping);
+            return true;
+        }
+    }
+    return rebuild(0);
+}
+
+/**********************************************
+ * Function: active
+ * Description: Returns the current mapping, switching to the replacement file first
+ *              if another process has retired the mapped one.
+ * Returns: Mapping* - The mapping, or nullptr if the filter is unavailable.
+ **********************************************/
+BloomFilter::Mapping* BloomFilter::active() {
+    Mapping* mapping = current.load(std::memory_order_acquire);
+    if (mapping == nullptr || counter(mapping->header->retired).load(std::memory_order_acquire) == 0)
+        return mapping;
+
+    std::lock_guard<std::mutex> lock(mappingMutex);
+    mapping = current.load();
+    if (counter(mapping->header->retired).load(std::memory_order_acquire) != 0) {
+        Mapping* replacement = openMapping();
+        if (replacement != nullptr)
+            current.store(replacement, std::memory_order_release);
+        else
+            return nullptr; // Being replaced right now; scan until the new file is in place
+        mapping = replacement;
+    }
+    return mapping;
+}
+
+/**********************************************
+ * Function: rebuild
+ * Description:
+ * Builds a new filter from every key in the data and renames it over the filter
+ * file. Runs under the exclusive lock, so no writer is between adding a key and
+ * writing its record. The counters carry over, and the old file is marked retired
+ * for the processes still mapping it. The file lock is always taken before
+ * mappingMutex, the order in which writers take them too.
+ * Parameters:
+ * - minimumKeys: The capacity the new filter needs at least
+ * Returns: bool - True if a filter is mapped afterwards.
+ **********************************************/
+bool BloomFilter::rebuild(long long minimumKeys) {
+    RecordLock rebuildLock(anchorPath.c_str(), anchorOffset, 1, true);
+    std::lock_guard<std::mutex> lock(mappingMutex);
+
+    // Another thread or process may have rebuilt it while this one waited for the lock
+    Mapping* existing = openMapping();
+    if (existing != nullptr && static_cast<long long>(existing->header->keys) <= existing->capacity()) {
+        current.store(existing, std::memory_order_release);
+        return true;
+    }
+
+    std::vector<uint64_t> hashes;
+    std::vector<char> record(recordBytes);
+    for (const std::string& path : files()) {
+        if (StorageLayout::isArchive(path)) {
+            BlockReader(path).scan([&](const char* records, size_t count) {
+                for (size_t i = 0; i < count; i++)
+                    keysOf(records + i * recordBytes, [&](std::string_view key) { hashes.push_back(hashKey(key)); });
+            });
+            continue;
+        }
+        VersionedReader reader(path);
+        std::ifstream infile(path, std::ios::binary);
+        while (reader.usable() && reader.read(infile, record.data(), 1) == 1)
+            keysOf(record.data(), [&](std::string_view key) { hashes.push_back(hashKey(key)); });
+    }
+
+    long long capacity = std::max({FILTER_MIN_KEYS, minimumKeys, static_cast<long long>(hashes.size()) * 2});
+    uint64_t blockCount = static_cast<uint64_t>((capacity * FILTER_BITS_PER_KEY + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK);
+    std::vector<uint64_t> blocks(blockCount * WORDS_PER_BLOCK, 0);
+    for (uint64_t hash : hashes) {
+        uint64_t* block = blockOf(blocks.data(), blockCount, hash);
+        for (int word = 0; word < WORDS_PER_BLOCK; word++)
+            block[word] |= bitOf(hash, word);
+    }
+
+    FilterHeader header{};
+    memcpy(header.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC));
+    header.blockCount = blockCount;
+    header.keys = hashes.size();
+    if (existing != nullptr) {
+        header.lookups = counter(existing->header->lookups).load();
+        header.definiteMisses = counter(existing->header->definiteMisses).load();
+        header.falsePositives = counter(existing->header->falsePositives).load();
+    }
+
+    std::string temporary = filterPath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size() * sizeof(uint64_t)));
+        out.close();
+        if (out.fail()) {
+            std::cerr << "Failed to write " << temporary << "." << std::endl;
+            return current.load() != nullptr;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, filterPath, error);
+    if (error) {
+        std::cerr << "Failed to replace " << filterPath << ": " << error.message() << std::endl;
+        return current.load() != nullptr;
+    }
+
+    if (existing != nullptr)
+        counter(existing->header->retired).store(1, std::memory_order_release);
+    Mapping* mapped = current.load();
+    if (mapped != nullptr)
+        counter(mapped->header->retired).store(1, std::memory_order_release);
+
+    Mapping* replacement = openMapping();
+    if (replacement != nullptr)
+        current.store(replacement, std::memory_order_release);
+    return replacement != nullptr;
+}
+
+/**********************************************
+ * Function: mayContain
+ * Description: Probes the key's block. Counts the lookup, and the miss if it is one.
+ * Parameters:
+ * - key: The key looked up
+ * Returns: bool - False if the key was certainly never added.
+ **********************************************/
+bool BloomFilter::mayContain(std::string_view key) {
+    Mapping* mapping = active();
+    if (mapping == nullptr)
+        return true;
+
+    counter(mapping->header->lookups).fetch_add(1, std::memory_order_relaxed);
+    uint64_t hash = hashKey(key);
+    uint64_t* block = blockOf(mapping->blocks, mapping->header->blockCount, hash);
+    for (int word = 0; word < WORDS_PER_BLOCK; word++) {
+        if ((counter(block[word]).load(std::memory_order_relaxed) & bitOf(hash, word)) == 0) {
+            counter(mapping->header->definiteMisses).fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: falsePositive
+ * Description: Counts a "maybe" that turned out to be a miss.
+ **********************************************/
+void BloomFilter::falsePositive() {
+    Mapping* mapping = active();
+    if (mapping != nullptr)
+        counter(mapping->header->falsePositives).fetch_add(1, std::memory_order_relaxed);
+}
+
+/**********************************************
+ * Function: add
+ * Description: Sets the key's bits in the shared mapping.
+ * Parameters:
+ * - key: The key of the record about to be written
+ **********************************************/
+void BloomFilter::add(std::string_view key) {
+    Mapping* mapping = active();
+    if (mapping == nullptr)
+        return;
+    uint64_t hash = hashKey(key);
+    uint64_t* block = blockOf(mapping->blocks, mapping->header->blockCount, hash);
+    for (int word = 0; word < WORDS_PER_BLOCK; word++)
+        counter(block[word]).fetch_or(bitOf(hash, word), std::memory_order_relaxed);
+    counter(mapping->header->keys).fetch_add(1, std::memory_order_relaxed);
+}
+
+/**********************************************
+ * Function: growIfFull
+ * Description: Rebuilds the filter at twice its key count once it is over capacity.
+ **********************************************/
+void BloomFilter::growIfFull() {
+    Mapping* mapping = active();
+    if (mapping == nullptr)
+        return;
+    long long keys = static_cast<long long>(counter(mapping->header->keys).load(std::memory_order_relaxed));
+    if (keys <= mapping->capacity())
+        return;
+    rebuild(keys * 2);
+}
+
+/**********************************************
+ * Function: stats
+ * Description: Reads the filter's counters from the shared header.
+ **********************************************/
+FilterStats BloomFilter::stats() {
+    FilterStats stats;
+    stats.file = filterPath;
+    Mapping* mapping = active();
+    if (mapping == nullptr)
+        return stats;
+    stats.keys = static_cast<long long>(counter(mapping->header->keys).load());
+    stats.capacity = mapping->capacity();
+    stats.lookups = static_cast<long long>(counter(mapping->header->lookups).load());
+    stats.definiteMisses = static_cast<long long>(counter(mapping->header->definiteMisses).load());
+    stats.falsePositives = static_cast<long long>(counter(mapping->header->falsePositives).load());
+    stats.expectedRate = expectedRate(stats.keys, mapping->header->blockCount);
+    long long absent = stats.falsePositives + stats.definiteMisses;
+    stats.observedRate = absent > 0 ? static_cast<double>(stats.falsePositives) / static_cast<double>(absent) : 0;
+    return stats;
+}
+
+#else
+
+// Without shared mappings every lookup answers "maybe" and falls through to the scan.
+BloomFilter::Mapping* BloomFilter::openMapping() { return nullptr; }
+bool BloomFilter::init() { return false; }
+BloomFilter::Mapping* BloomFilter::active() { return nullptr; }
+bool BloomFilter::rebuild(long long) { return false; }
+bool BloomFilter::mayContain(std::string_view) { return true; }
+void BloomFilter::falsePositive() {}
+void BloomFilter::add(std::string_view) {}
+void BloomFilter::growIfFull() {}
+FilterStats BloomFilter::stats() {
+    FilterStats stats;
+    stats.file = filterPath;
+    return stats;
+}
+
+#endif
+
+/**********************************************
+ * Function: addRecords
+ * Description:
+ * Adds the keys of the records from offset from up to offset to of source. Used by
+ * the replica, which appends records by copying bytes rather than through the
+ * entity modules, before it copies them.
+ * Parameters:
+ * - source: The file holding the records
+ * - from: The offset of the first record
+ * - to: The offset just past the last record
+ **********************************************/
+void BloomFilter::addRecords(const std::string& source, long long from, long long to) {
+    VersionedReader reader(source);
+    if (!reader.usable())
+        return;
+    std::ifstream infile(source, std::ios::binary);
+    infile.seekg(from);
+    std::vector<char> record(recordBytes);
+    long long storedBytes = static_cast<long long>(reader.storedSize());
+    for (long long offset = from; offset + storedBytes <= to; offset += storedBytes) {
+        if (reader.read(infile, record.data(), 1) != 1)
+            break;
+        keysOf(record.data(), [this](std::string_view key) { add(key); });
+    }
+}
+
+/**********************************************
+ * Function: addBlockFile
+ * Description: Adds the keys of every record of a block file.
+ * Parameters:
+ * - source: The block file, in the current record version
+ **********************************************/
+void BloomFilter::addBlockFile(const std::string& source) {
+    BlockReader reader(source);
+    if (reader.recordSize() != recordBytes)
+        return;
+    reader.scan([this](const char* records, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            keysOf(records + i * recordBytes, [this](std::string_view key) { add(key); });
+    });
+}
+
+/**********************************************
+ * Function: forDataFile
+ * Description: Finds the filter whose data files include path and initializes it.
+ * Parameters:
+ * - path: A data file
+ * Returns: BloomFilter* - The filter, or nullptr if no filter covers the file.
+ **********************************************/
+BloomFilter* BloomFilter::forDataFile(const std::string& path) {
+    for (BloomFilter* filter : registry()) {
+        std::vector<std::string> covered = filter->files();
+        if (std::find(covered.begin(), covered.end(), path) != covered.end())
+            return filter->init() ? filter : nullptr;
+    }
+    return nullptr;
+}
+
+/**********************************************
+ * Function: allStats
+ * Description: Collects the counters of every filter that has been initialized.
+ **********************************************/
+std::vector<FilterStats> BloomFilter::allStats() {
+    std::vector<FilterStats> all;
+    for (BloomFilter* filter : registry()) {
+        if (filter->current.load() != nullptr)
+            all.push_back(filter->stats());
+    }
+    return all;
+}
+
+/**********************************************
+ * Function: printStats
+ * Description: Prints one line of counters per filter.
+ * Returns: int - The process exit status.
+ **********************************************/
+int BloomFilter::printStats() {
+    std::vector<FilterStats> all = allStats();
+    if (all.empty()) {
+        std::cout << "No lookup filters are in use." << std::endl;
+        return 1;
+    }
+    std::cout << std::left << std::setw(22) << "filter" << std::right << std::setw(10) << "keys" << std::setw(10) << "capacity"
+              << std::setw(12) << "lookups" << std::setw(12) << "misses" << std::setw(10) << "false +"
+              << std::setw(11) << "observed" << std::setw(11) << "expected" << std::endl;
+    for (const FilterStats& stats : all) {
+        std::cout << std::left << std::setw(22) << stats.file << std::right << std::setw(10) << stats.keys
+                  << std::setw(10) << stats.capacity << std::setw(12) << stats.lookups << std::setw(12) << stats.definiteMisses
+                  << std::setw(10) << stats.falsePositives << std::fixed << std::setprecision(3)
+                  << std::setw(10) << stats.observedRate * 100 << "%" << std::setw(10) << stats.expectedRate * 100 << "%"
+                  << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**********************************************
+ * BloomFilter Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: recordSize is the size of a record in the current version.
+ * - 2026-10-19: Added addBlockFile.
+ *--------------------------------
+ * Purpose:
+ * This module keeps a persisted Bloom filter of the keys of a data file, so that
+ * looking up a key that does not exist usually costs a few memory reads instead
+ * of a scan of the whole file. A "no" from the filter is certain; a "maybe" is
+ * followed by the usual scan, and a scan that then finds nothing is counted as a
+ * false positive.
+ *
+ * The filter is blocked: every key sets eight bits inside one 64-byte block, so a
+ * lookup touches a single cache line. It lives in its own file, mapped shared into
+ * every process using the data directory, so keys added by one process are seen
+ * by all the others at once, and lookups need no system call at all. Writers add
+ * the key before the record itself is written, holding a shared lock on a sentinel
+ * byte of the data file (for change items, the snapshot commit lock they hold anyway); a filter that has grown past its capacity is rebuilt
+ * twice as large from the data under the exclusive lock, and the old file is
+ * marked retired so every process switches over on its next lookup. A missing or
+ * damaged filter file is rebuilt from the data when the entity module starts.
+ *
+ * Lookup, miss and false positive counts are kept in the filter file as well, so
+ * the reported false positive rates cover every process.
+ **********************************************/
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FileLock.h"
+
+//=============================
+// Constants
+//=============================
+const long long FILTER_LOCK_OFFSET = 0x7FFFFFFF00000004LL;   // Data file sentinel: shared while adding keys, exclusive while rebuilding
+const long long FILTER_MIN_KEYS = 16384;                     // Smallest capacity a filter is built with
+const int FILTER_BITS_PER_KEY = 16;                          // About 0.1% false positives at capacity
+
+const char* const ITEM_FILTER_FILE = "ChangeItem.bloom";
+const char* const REQUEST_FILTER_FILE = "ChangeRequest.bloom";
+const char* const RELEASE_FILTER_FILE = "ProductRelease.bloom";
+const char* const PRODUCT_FILTER_FILE = "Product.bloom";
+const char* const REQUESTER_FILTER_FILE = "req.bloom";
+
+//=============================
+// Record Types
+//=============================
+
+// The counters of one filter, as reported by --filter-stats.
+struct FilterStats {
+    std::string file;
+    long long keys = 0;                 // Keys added, counting repeats
+    long long capacity = 0;             // Keys the filter is sized for
+    long long lookups = 0;
+    long long definiteMisses = 0;       // Lookups answered without reading the data
+    long long falsePositives = 0;       // "Maybe" answers whose scan found nothing
+    double expectedRate = 0;            // False positive rate predicted from the fill
+    double observedRate = 0;            // falsePositives / (falsePositives + definiteMisses)
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class BloomFilter {
+public:
+    using KeyVisitor = std::function<void(std::string_view)>;
+
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    BloomFilter(const char* filterFile, const char* anchorFile, long long lockOffset, size_t recordSize,
+                std::vector<std::string> (*dataFiles)(), void (*recordKeys)(const char* record, const KeyVisitor& visit));
+    // Description: Describes the filter of one entity. Nothing is read until init.
+    // Parameters:
+    // - const char* filterFile: The file holding the filter.
+    // - const char* anchorFile: The data file whose sentinel byte guards the filter.
+    // - long long lockOffset: The sentinel byte, usually FILTER_LOCK_OFFSET. A sentinel every writer
+    //   of the entity already holds shared can be reused instead of taking a WriteScope.
+    // - size_t recordSize: The size of a packed record in the current version; files in an
+    //                      older version are read through a VersionedReader.
+    // - dataFiles: Returns every file holding records, for rebuilds.
+    // - recordKeys: Calls visit with each key of a packed record.
+
+    //----------------------------------------------------------
+    ~BloomFilter();
+    // Description: Unmaps the filter.
+
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator=(const BloomFilter&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    bool init();
+    // Description: Maps the filter file, building it from the data if it is missing or damaged.
+    // Returns: bool - False if no filter is available; lookups then always answer "maybe".
+
+    //----------------------------------------------------------
+    bool mayContain(std::string_view key);
+    // Description: Returns false only if no record has the key. Costs no file I/O.
+
+    //----------------------------------------------------------
+    void falsePositive();
+    // Description: Called when a scan after a "maybe" found nothing.
+
+    //----------------------------------------------------------
+    void add(std::string_view key);
+    // Description: Adds a key. The caller holds a WriteScope and has not written the record yet.
+
+    //----------------------------------------------------------
+    void growIfFull();
+    // Description: Rebuilds the filter twice as large once it holds more keys than it was
+    //              sized for. Called by writers before they take any lock.
+
+    //----------------------------------------------------------
+    FilterStats stats();
+    // Description: Returns the filter's counters.
+
+    //----------------------------------------------------------
+    void addRecords(const std::string& source, long long from, long long to);
+    // Description: Adds the keys of the packed records between two offsets of source, such as
+    //              the records a replica is about to append. The caller holds a WriteScope.
+
+    //----------------------------------------------------------
+    void addBlockFile(const std::string& source);
+    // Description: Adds the keys of every record of a block file, such as an archive a replica
+    //              is about to put in place. The caller holds a WriteScope.
+
+    //----------------------------------------------------------
+    static BloomFilter* forDataFile(const std::string& path);
+    // Description: Returns the filter covering a data file, initialized, or nullptr if none does.
+
+    //----------------------------------------------------------
+    static std::vector<FilterStats> allStats();
+    // Description: Returns the counters of every initialized filter of this process.
+
+    //----------------------------------------------------------
+    static int printStats();
+    // Description: Prints the counters of every initialized filter.
+    // Returns: int - The process exit status.
+
+    // Held by a writer from adding a key until its record is written, so that a
+    // rebuild never misses a record whose key went into the filter it replaces.
+    class WriteScope {
+    public:
+        explicit WriteScope(const BloomFilter& filter);
+    private:
+        RecordLock anchorLock;
+    };
+
+private:
+    struct Mapping;
+
+    Mapping* active();
+    Mapping* openMapping();
+    bool rebuild(long long minimumKeys);
+
+    std::string filterPath;
+    std::string anchorPath;
+    long long anchorOffset;
+    size_t recordBytes;
+    std::vector<std::string> (*files)();
+    void (*keysOf)(const char* record, const KeyVisitor& visit);
+    std::atomic<Mapping*> current;
+    std::vector<std::unique_ptr<Mapping>> mappings;   // Retired mappings stay valid for threads still reading them
+    std::mutex mappingMutex;
+};
+
+//=============================
+// Helper Functions
+//=============================
+
+// Views the bytes of an integer key, such as a change ID. The integer must outlive the view.
+inline std::string_view integerKey(const int& value) {
+    return std::string_view(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+#endif // BLOOMFILTER_H
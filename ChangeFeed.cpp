@@ -0,0 +1,197 @@
+/**********************************************
+ * ChangeFeed Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: publish takes the change item a change request is about.
+ * - 2026-10-19: publish is traced as a span.
+ *--------------------------------
+ * Purpose:
+ * This module implements the change feed on top of a file of fixed-size
+ * FeedEvent records. Appends serialize on the append sentinel lock of the feed
+ * file, so the sequence number taken from the file size is unique. Readers need
+ * no lock: they only read whole records below the end they saw.
+ **********************************************/
+#include "ChangeFeed.h"
+#include "FileLock.h"
+#include "Trace.h"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+//================================
+// Constants
+//================================
+static const size_t READ_BATCH = 256;                 // Events read per round while tailing
+static const int TAIL_POLL_MS = 200;                  // Pause while no new events arrive
+
+static const char* ENTITY_NAMES[] = {"ChangeItem", "ChangeRequest", "ProductRelease", "Product", "Requester"};
+static const char* KIND_NAMES[] = {"created", "state", "priority"};
+static const char* STATE_NAMES[] = {"ASSESSED", "INPROGRESS", "DONE", "CANCELLED"};
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: endSequence
+ * Description: Counts the whole records in the feed file.
+ * Returns: long long - The sequence number the next event will get.
+ **********************************************/
+long long ChangeFeed::endSequence() {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(FEED_FILE, error);
+    return error ? 0 : static_cast<long long>(size / sizeof(FeedEvent));
+}
+
+/**********************************************
+ * Function: publish
+ * Description:
+ * Appends an event under the feed's append lock. A partial record left by a
+ * crashed writer is cut off first, so the record count stays the sequence number.
+ * Parameters:
+ * - entity, kind: What happened
+ * - changeId: The ChangeItem or ChangeRequest ID, or -1
+ * - product: The product the event belongs to, or ""
+ * - key: The release ID, requester or product name, or ""
+ * - state, priority: The ChangeItem's values after the event, or -1
+ * - previous: The changed value before the event, or -1
+ * - linkedId: The ChangeItem a ChangeRequest is about, or -1
+ **********************************************/
+void ChangeFeed::publish(FeedEvent::Entity entity, FeedEvent::Kind kind, int changeId, const std::string& product,
+                         const std::string& key, int state, int priority, int previous, int linkedId) {
+    Trace::Span span("change_feed.publish", "feed");
+    FeedEvent event{};
+    event.timestamp = static_cast<long long>(std::time(nullptr));
+    event.changeId = changeId;
+    event.entity = entity;
+    event.kind = kind;
+    event.state = static_cast<int8_t>(state);
+    event.priority = static_cast<int8_t>(priority);
+    event.previous = static_cast<int8_t>(previous);
+    strncpy(event.product, product.c_str(), sizeof(event.product) - 1);
+    strncpy(event.key, key.c_str(), sizeof(event.key) - 1);
+    event.linkedId = linkedId < 0 ? 0 : linkedId + 1;
+
+    RecordLock appendLock(FEED_FILE, APPEND_LOCK_OFFSET, 1, true);
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(FEED_FILE, error);
+    if (!error && size % sizeof(FeedEvent) != 0)
+        std::filesystem::resize_file(FEED_FILE, size - size % sizeof(FeedEvent), error);
+    event.sequence = endSequence();
+
+    std::ofstream feed(FEED_FILE, std::ios::binary | std::ios::app);
+    feed.write(reinterpret_cast<const char*>(&event), sizeof(FeedEvent));
+    feed.close(); // On disk before the append lock is released
+    if (feed.fail())
+        std::cerr << "Failed to append to the change feed." << std::endl;
+}
+
+/**********************************************
+ * Function: matches
+ * Description: Returns true if the event passes the filter.
+ **********************************************/
+bool ChangeFeed::matches(const FeedEvent& event, const FeedFilter& filter) {
+    if (filter.entity >= 0 && event.entity != filter.entity)
+        return false;
+    if (!filter.product.empty() && filter.product != event.product)
+        return false;
+    if (filter.state >= 0 && event.state != filter.state)
+        return false;
+    return true;
+}
+
+/**********************************************
+ * Function: read
+ * Description:
+ * Reads the feed from fromSequence on and keeps the matching events. Stops at the
+ * end of the feed or after maxEvents matches.
+ * Parameters:
+ * - fromSequence: The first sequence number to look at
+ * - filter: Which events to keep
+ * - maxEvents: The most events to return
+ * - events: Receives the matching events
+ * Returns: long long - The sequence number to continue reading from.
+ **********************************************/
+long long ChangeFeed::read(long long fromSequence, const FeedFilter& filter, size_t maxEvents, std::vector<FeedEvent>& events) {
+    if (fromSequence < 0)
+        fromSequence = 0;
+    long long end = endSequence();
+    std::ifstream feed(FEED_FILE, std::ios::binary);
+    feed.seekg(fromSequence * static_cast<long long>(sizeof(FeedEvent)));
+
+    long long next = fromSequence;
+    size_t found = 0;
+    FeedEvent event;
+    while (next < end && found < maxEvents && feed.read(reinterpret_cast<char*>(&event), sizeof(FeedEvent))) {
+        next++;
+        if (matches(event, filter)) {
+            events.push_back(event);
+            found++;
+        }
+    }
+    return next;
+}
+
+/**********************************************
+ * Function: describe
+ * Description: Formats an event as one line of text.
+ * Parameters: const FeedEvent& event - The event
+ * Returns: std::string - e.g. "17 2026-10-19T10:00:00 ChangeItem 42 state Widget ASSESSED -> INPROGRESS"
+ **********************************************/
+std::string ChangeFeed::describe(const FeedEvent& event) {
+    char when[32];
+    std::time_t timestamp = static_cast<std::time_t>(event.timestamp);
+    std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", std::localtime(&timestamp));
+
+    std::ostringstream line;
+    line << event.sequence << " " << when << " " << (event.entity < 5 ? ENTITY_NAMES[event.entity] : "?");
+    if (event.changeId >= 0)
+        line << " " << event.changeId;
+    line << " " << (event.kind < 3 ? KIND_NAMES[event.kind] : "?");
+    if (event.product[0] != '\0')
+        line << " " << event.product;
+    if (event.key[0] != '\0')
+        line << " " << event.key;
+    if (event.linkedId > 0)
+        line << " item " << event.linkedId - 1;
+
+    auto stateName = [](int state) { return state >= 0 && state < 4 ? STATE_NAMES[state] : "?"; };
+    if (event.kind == FeedEvent::STATE_CHANGED)
+        line << " " << stateName(event.previous) << " -> " << stateName(event.state);
+    else if (event.kind == FeedEvent::PRIORITY_CHANGED)
+        line << " " << static_cast<int>(event.previous) << " -> " << static_cast<int>(event.priority);
+    else if (event.state >= 0)
+        line << " " << stateName(event.state) << " priority " << static_cast<int>(event.priority);
+    return line.str();
+}
+
+/**********************************************
+ * Function: tailFeed
+ * Description:
+ * Prints matching events from fromSequence on, then polls for new ones. A
+ * negative fromSequence starts at the current end, showing only new events.
+ * Parameters:
+ * - fromSequence: The first sequence number to print
+ * - filter: Which events to print
+ * Returns: int - The process exit status.
+ **********************************************/
+int ChangeFeed::tailFeed(long long fromSequence, const FeedFilter& filter) {
+    long long next = fromSequence < 0 ? endSequence() : fromSequence;
+    std::vector<FeedEvent> events;
+    for (;;) {
+        events.clear();
+        long long after = read(next, filter, READ_BATCH, events);
+        for (const FeedEvent& event : events)
+            std::cout << describe(event) << std::endl;
+        if (after == next)
+            std::this_thread::sleep_for(std::chrono::milliseconds(TAIL_POLL_MS));
+        next = after;
+    }
+    return 0;
+}
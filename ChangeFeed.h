@@ -0,0 +1,115 @@
+/**********************************************
+ * ChangeFeed Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: FEED_FILE is shared with the replica.
+ * - 2026-10-19: Added FeedEvent::linkedId in the former tail padding.
+ *--------------------------------
+ * Purpose:
+ * This module keeps an append-only feed of everything that happens to the
+ * tracker's data: every ChangeItem, ChangeRequest, ProductRelease, Product and
+ * Requester that is created, and every state or priority change of a ChangeItem.
+ * Each event gets the next sequence number, which is simply its position in
+ * ChangeFeed.txt, so numbers are gapless and increase in the order the events
+ * happened. Consumers remember the next sequence number they want and read on
+ * from there, optionally filtered by entity, product or state.
+ *
+ * Events are appended right after the data file was written. A crash between the
+ * two writes loses the event, never the data.
+ **********************************************/
+#ifndef CHANGEFEED_H
+#define CHANGEFEED_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const char* const FEED_FILE = "ChangeFeed.txt";
+
+//=============================
+// Record Types
+//=============================
+
+// One event of the feed, stored as a fixed-size record.
+struct FeedEvent {
+    enum Entity : uint8_t {
+        CHANGE_ITEM,
+        CHANGE_REQUEST,
+        PRODUCT_RELEASE,
+        PRODUCT,
+        REQUESTER
+    };
+
+    enum Kind : uint8_t {
+        CREATED,
+        STATE_CHANGED,
+        PRIORITY_CHANGED
+    };
+
+    long long sequence;     // Position in the feed
+    long long timestamp;    // Seconds since the epoch
+    int32_t changeId;       // ChangeItem or ChangeRequest ID, otherwise -1
+    uint8_t entity;
+    uint8_t kind;
+    int8_t state;           // ChangeItem state after the event, otherwise -1
+    int8_t priority;        // ChangeItem priority after the event, otherwise -1
+    int8_t previous;        // The state or priority before a change, otherwise -1
+    char product[11];       // The product the event belongs to, if any
+    char key[32];           // Release ID, requester name or email, product name
+    int32_t linkedId;       // ChangeRequest: the ChangeItem it is about plus one, otherwise 0
+};
+
+static_assert(sizeof(FeedEvent) == 72, "linkedId takes the tail padding; older events hold 0 there");
+
+// Which events a reader wants. Empty or -1 fields match everything.
+struct FeedFilter {
+    int entity = -1;
+    std::string product;
+    int state = -1;
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class ChangeFeed {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static void publish(FeedEvent::Entity entity, FeedEvent::Kind kind, int changeId, const std::string& product,
+                        const std::string& key, int state, int priority, int previous, int linkedId = -1);
+    // Description: Appends an event with the next sequence number and the current time.
+    //              Safe to call from several threads and processes at once.
+
+    //----------------------------------------------------------
+    static long long read(long long fromSequence, const FeedFilter& filter, size_t maxEvents, std::vector<FeedEvent>& events);
+    // Description: Appends to events up to maxEvents events from fromSequence on that
+    //              match the filter.
+    // Returns: long long - The sequence number to continue reading from.
+
+    //----------------------------------------------------------
+    static long long endSequence();
+    // Description: Returns the sequence number the next event will get.
+
+    //----------------------------------------------------------
+    static bool matches(const FeedEvent& event, const FeedFilter& filter);
+    // Description: Returns true if the event passes the filter.
+
+    //----------------------------------------------------------
+    static std::string describe(const FeedEvent& event);
+    // Description: Formats an event as one line of text.
+
+    //----------------------------------------------------------
+    static int tailFeed(long long fromSequence, const FeedFilter& filter);
+    // Description: Prints the events from fromSequence on and keeps printing new ones
+    //              as they are appended, until the process is interrupted.
+    // Returns: int - The process exit status.
+};
+
+#endif // CHANGEFEED_H
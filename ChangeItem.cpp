@@ -2,6 +2,31 @@
  * ChangeItem Implementation File
  * Revision History:
  * - 2024-07-30: Initial version created.
+ * - 2026-10-19: Added non-interactive listing and accessors for the daemon.
+ * - 2026-10-19: Added version stamps with compare-and-swap updates and locked ID assignment.
+ * - 2026-10-19: Change IDs come from the block-reserving IdAllocator.
+ * - 2026-10-19: Change items are stored in per-product segments when the data is partitioned.
+ * - 2026-10-19: Listings and counts read through snapshots, and updates keep old records for them.
+ * - 2026-10-19: New items and state and priority changes are published to the change feed.
+ * - 2026-10-19: The ID mark file name comes from StorageLayout.h.
+ * - 2026-10-19: Creates and state or priority changes are recorded in the item history.
+ * - 2026-10-19: Listings go through record views and per-query arenas; added findChangeItem.
+ * - 2026-10-19: Key scans read the change ID field in place.
+ * - 2026-10-19: Change ID lookups check a persisted Bloom filter before scanning.
+ * - 2026-10-19: Added batched lookups that find many change IDs in one pass.
+ * - 2026-10-19: Added bulk state and priority updates by selection.
+ * - 2026-10-19: initChangeItem checks the release index.
+ * - 2026-10-19: Records are written with checksums and verified when read.
+ * - 2026-10-19: Writes upgrade segments in an older record version first; lookups and scans read any record version.
+ * - 2026-10-19: Lookups, listings and updates fall through to the archives of closed items; records found before they are locked are checked again.
+ * - 2026-10-19: Archives are block files: the largest archived change ID is read from the last block.
+ * - 2026-10-19: Operations timed for the metrics endpoint.
+ * - 2026-10-19: queryChangeItem and the append lock wait are traced as spans.
+ * - 2026-10-19: Removed the interactive queryChangeItem and displayChangeItems; the UI selects items through TrackerService.
+ * - 2026-10-19: getChangeItems looks up a moved item after releasing the record's lock.
+ * - 2026-10-19: bulkSetPriority rejects a priority outside 1 to 5.
+ * - 2026-10-19: The shared item stream is guarded by a mutex of this module rather than by its callers.
+ * - 2026-10-19: createChangeItem returns false when no ID is assigned or the record is not written.
  *--------------------------------
  * Purpose: 
  * This module implements the ChangeItem class, providing functionality for creating,
@@ -9,17 +34,51 @@
  * to store and retrieve change item data, ensuring data integrity and proper handling 
  * of change item.
  **********************************************/
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <cstring>
+#include <ctime>
 #include <vector>
+#include <filesystem>
+#include <map>
+#include <atomic>
+#include <deque>
+#include <optional>
 
 #include "ChangeItem.h"
+#include "BlockFile.h"
+#include "BloomFilter.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "IdAllocator.h"
+#include "ItemArchive.h"
+#include "ItemHistory.h"
+#include "Metrics.h"
 #include "ObjectNotFoundException.h"
+#include "RecordView.h"
+#include "ReleaseIndex.h"
+#include "StorageLayout.h"
+#include "Trace.h"
+#include "Snapshot.h"
+#include "ChangeFeed.h"
+#include "RecordChecksum.h"
 
 static std::fstream file;
+static std::mutex fileMutex;   // Serializes every use of file, from any caller
 
-int ChangeItem::currentChangeIdCount = 0;
+static IdAllocator itemIds(ITEM_FILE, ITEM_MARK_FILE);
+
+// Passes the change ID of a packed ChangeItem record to visit.
+static void itemKeys(const char* record, const BloomFilter::KeyVisitor& visit) {
+    int changeId = Schema<ChangeItem>::read<ChangeItem::FIELD_CHANGE_ID>(record);
+    visit(integerKey(changeId));
+}
+
+// Every writer of change items holds the snapshot commit lock shared, so the filter rebuilds under it.
+// Archived items keep their keys, so the filter covers the archives too.
+static BloomFilter itemFilter(ITEM_FILTER_FILE, ITEM_FILE, COMMIT_LOCK_OFFSET, Schema<ChangeItem>::SIZE, StorageLayout::itemFiles, itemKeys);
 
 // Default Constructor: Will create an instance of a ChangeItem.
 ChangeItem::ChangeItem() {}
@@ -27,16 +86,17 @@ ChangeItem::ChangeItem() {}
 /**********************************************
  * Constructor: ChangeItem
  * Description:
- * The constructor for creating a new ChangeItem object and writing it to the file.
- * The details are copied into the private variables and written to the file.
+ * The constructor for creating a new ChangeItem object. The details are copied into
+ * the private variables; the change ID is assigned when it is written by createChangeItem.
  * Parameters: 
  * - n: The name of the requester
  * - num: The phone number of the requester
  * - mail: The email of the requester
  * - dept: The department of the requester
  **********************************************/
-ChangeItem::ChangeItem(Product product, const char* n, State theState, int newPriority, const char* reportedDate, ProductRelease changeRelease) {
-    changeId = currentChangeIdCount++;
+ChangeItem::ChangeItem(const Product& product, const char* n, State theState, int newPriority, const char* reportedDate, const ProductRelease& changeRelease) {
+    changeId = -1; // Assigned by createChangeItem
+    version = 0;
     priority = newPriority;
     productName = product;
     anticipatedRelease = changeRelease;
@@ -44,7 +104,7 @@ ChangeItem::ChangeItem(Product product, const char* n, State theState, int newPr
     description[149] = '\0';
     changeItemState = theState;
     strncpy(date, reportedDate, 10);
-    date[11] = '\0';
+    date[10] = '\0';
 }
 
 
@@ -77,76 +137,145 @@ void ChangeItem::printState() {
  * Returns: bool: True if the file was opened successfully, otherwise false.
  **********************************************/
 bool ChangeItem::initChangeItem() {
-    file.open("ChangeItem.txt", std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-        return false;
-    }
-
-    // Find the last changeId from the file
-    std::ifstream infile("ChangeItem.txt", std::ios::binary | std::ios::ate);
-    if (!infile.is_open()) {
-        std::cerr << "Failed to open file for reading." << std::endl;
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        file.open(ITEM_FILE, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return false;
+        }
+        file.close();
     }
 
-    std::streampos fileSize = infile.tellg();
-    if (fileSize < sizeof(ChangeItem)) {
-        currentChangeIdCount = 0; // No items in file
-    } else {
-        infile.seekg(-sizeof(ChangeItem), std::ios::end);
-        ChangeItem lastChangeItem;
-        infile.read(reinterpret_cast<char*>(&lastChangeItem), sizeof(ChangeItem));
-        currentChangeIdCount = lastChangeItem.changeId + 1;
-    }
+    ItemArchive::recover();
+    for (const std::string& segment : StorageLayout::itemSegments()) // Archives check their blocks themselves
+        RecordChecksum::init(segment, FileFormat::layout(segment).size);
+    itemFilter.init();
+    if (!ReleaseIndex::init())
+        std::cerr << "Failed to build the release index." << std::endl;
+    return itemIds.init(scanMaxChangeId);
+}
 
-    infile.close();
-    file.close();
-    return true;
+/**********************************************
+ * Function: scanMaxChangeId
+ * Description:
+ * Reads every segment and archive for the largest change ID, in parallel when the
+ * data is partitioned. Only needed when the ID allocator has lost its high-water
+ * mark, since IDs handed out by concurrent processes are not stored in increasing
+ * order.
+ * Parameters: None
+ * Returns: int - The largest change ID, or -1 if no segment holds records.
+ **********************************************/
+int ChangeItem::scanMaxChangeId() {
+    std::atomic<int> maxChangeId(-1);
+    ItemArchive::ReadScope archiveScope; // No item moves between the files meanwhile
+    StorageLayout::forEachSegment(StorageLayout::itemFiles(), [&](const std::string& path) {
+        int segmentMax = -1;
+        if (StorageLayout::isArchive(path)) {
+            // Sorted by change ID, so the largest is the last record of the last block
+            BlockReader reader(path);
+            std::vector<char> records;
+            if (reader.blocks() > 0 && reader.readBlock(reader.blocks() - 1, records))
+                segmentMax = Schema<ChangeItem>::read<FIELD_CHANGE_ID>(records.data() + records.size() - Schema<ChangeItem>::SIZE);
+        } else {
+            VersionedReader reader(path);
+            std::ifstream infile(path, std::ios::binary);
+            char record[Schema<ChangeItem>::SIZE];
+            while (reader.usable() && reader.read(infile, record, 1) == 1) {
+                int changeId = Schema<ChangeItem>::read<FIELD_CHANGE_ID>(record);
+                if (changeId > segmentMax)
+                    segmentMax = changeId;
+            }
+        }
+        int seen = maxChangeId.load();
+        while (segmentMax > seen && !maxChangeId.compare_exchange_weak(seen, segmentMax)) {}
+    });
+    return maxChangeId;
 }
 
 /**********************************************
  * Function: createChangeItem
  * Description:
- * Writes a new ChangeItem object to the file.
+ * Assigns the next free change ID to a ChangeItem and appends it to the file
+ * (segment) of its product. The ID comes from the allocator without any file I/O
+ * in the common case. The append sentinel of the file is locked while writing, so
+ * a partial record left by a crashed writer can be cut off before appending and
+ * every later record stays aligned. The change ID goes into the lookup filter
+ * before the record is written. A file in an older record version is upgraded first.
  * Parameters:
- * - changeItem: The ChangeItem object to be written to the file
+ * - changeItem: The ChangeItem object to be written to the file; receives its change ID
+ * Returns: bool - False if no ID could be assigned or the record could not be written
  **********************************************/
- void ChangeItem::createChangeItem(const ChangeItem& changeItem) {
-    file.open("ChangeItem.txt", std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
+bool ChangeItem::createChangeItem(ChangeItem& changeItem) {
+    Metrics::Timer timer(Metrics::ITEM_CREATE);
+    itemFilter.growIfFull(); // Before any lock is held, since a rebuild waits for every writer
+    changeItem.changeId = itemIds.nextId();
+    if (changeItem.changeId < 0) {
+        std::cerr << "Failed to assign a change ID." << std::endl;
+        return false;
     }
 
-    file.write(reinterpret_cast<const char*>(&changeItem), sizeof(ChangeItem));
-    closeChangeItem();
+    std::string product = changeItem.productName.getProductName();
+    if (!FileFormat::ensureCurrent(StorageLayout::itemPath(product))) { // Before any lock, since an upgrade waits for them
+        std::cerr << "Failed to write the ChangeItem." << std::endl;
+        return false;
+    }
+    std::string path;
+    std::optional<RecordLock> appendLock;
+    {
+        Trace::Span span("append_lock.wait", "lock");
+        do {
+            path = StorageLayout::itemPath(product);
+            appendLock.emplace(path.c_str(), APPEND_LOCK_OFFSET, 1, true);
+        } while (path != StorageLayout::itemPath(product)); // Migrated while waiting for the lock
+    }
+    Snapshot::WriteScope writeScope;
+    itemFilter.add(integerKey(changeItem.changeId)); // The scope also holds off filter rebuilds
+
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    if (!error && size % sizeof(ChangeItem) != 0)
+        std::filesystem::resize_file(path, size - size % sizeof(ChangeItem), error);
+    long long offset = error ? 0 : static_cast<long long>(size - size % sizeof(ChangeItem));
+
+    // Recorded first, so no update of the new item can reach the history before its creation
+    ItemHistory::record(changeItem.changeId, product, Transition::CREATED, changeItem.changeItemState,
+                        changeItem.priority, static_cast<long long>(std::time(nullptr)));
+    RecordChecksum::store(path, sizeof(ChangeItem), offset, &changeItem, 1); // Before the record, so a torn append fails
+    bool written;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+        }
+        file.write(reinterpret_cast<const char*>(&changeItem), sizeof(ChangeItem));
+        file.close(); // Flushes the record before the append lock is released
+        written = !file.fail();
+        file.clear();
+    }
+    if (!written)
+        return false;
+    ChangeFeed::publish(FeedEvent::CHANGE_ITEM, FeedEvent::CREATED, changeItem.changeId, product,
+                        changeItem.anticipatedRelease.releaseIdToString(), changeItem.changeItemState, changeItem.priority, -1);
+    return true;
 }
 
 /**********************************************
  * Function: getChangeItem
  * Description:
- * Retrieves a ChangeItem object from the file based on the change ID.
+ * Retrieves a ChangeItem object from the file based on the change ID. The
+ * product is not known, so every segment is searched, in parallel when the data
+ * is partitioned. Once found, the record is read again under a shared lock on its
+ * bytes, which only waits for an update of that record already in progress, so a
+ * half-written record is never returned. Long scans use a Snapshot instead.
  * Parameters:
  * - findChangeId: The change ID of the ChangeItem to retrieve
  * Returns: ChangeItem object if found, otherwise throws an exception
  **********************************************/
 ChangeItem ChangeItem::getChangeItem(int findChangeId) {
-    file.open("ChangeItem.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-    }
-
-    file.seekg(0, std::ios::beg); // Reset file pointer to beginning
     ChangeItem changeItem;
-    bool found = false;
-    while (!found && file.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem))) {
-        if (changeItem.changeId == findChangeId) {
-            found = true;
-        }
-    }
-
-    closeChangeItem();
-    if (found)
+    if (findChangeItem(findChangeId, changeItem))
         return changeItem;
     else throw ObjectNotFoundException("Object with this changeID was not found in file");
 
@@ -154,150 +283,255 @@ ChangeItem ChangeItem::getChangeItem(int findChangeId) {
 }
 
 /**********************************************
- * Function: queryChangeItem
+ * Function: findChangeItem
  * Description:
- * Interacts with the user to create a new ChangeItem or select an existing one based on the product name.
+ * Does the work of getChangeItem, reading the record straight into the caller's
+ * storage. Used where a missing ID is an ordinary answer, so no exception is built.
+ * An ID the lookup filter has never seen is answered without reading any segment.
+ * An ID the segments lack is looked up in the archives, and the segments are
+ * searched once more while the archives are held, since the item may have been
+ * moved between them during the first search. A record that is no longer where it
+ * was found once locked has been moved, and is looked up again.
  * Parameters:
- * - product: The name of the product for which to query change items
- * Returns: ChangeItem object created or selected by the user
+ * - findChangeId: The change ID of the ChangeItem to retrieve
+ * - changeItem: Receives the record
+ * Returns: bool - True if the ChangeItem was found
  **********************************************/
-ChangeItem ChangeItem::queryChangeItem(std::string product){
-    std::string input;
-    int intInput;
-    std::cout << std::endl;
-
-    file.open("ChangeItem.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-    }
-    file.seekg(0, std::ios::beg); // Reset file pointer to beginning
-
-
-    int multiple = 1;
-    int counter = 1;
-    int currentEntry;
-    ChangeItem changeItem;
-    std::vector<ChangeItem> changeItems;
-    std::cout << "Please select a ChangeItem" << std::endl;
-    while (!file.eof()){
-        while (file.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem)) && counter < 21) {
-            if (product == changeItem.productName.getProductName()){
-                currentEntry = multiple * counter;
-                changeItems.push_back(changeItem);
-                std::cout << currentEntry << ") " << changeItem.description << std::endl;
-                counter++;
+bool ChangeItem::findChangeItem(int findChangeId, ChangeItem& changeItem) {
+    Metrics::Timer timer(Metrics::ITEM_GET);
+    if (!itemFilter.mayContain(integerKey(findChangeId)))
+        return false;
+    auto matches = [findChangeId](const char* candidate) {
+        return Schema<ChangeItem>::read<FIELD_CHANGE_ID>(candidate) == findChangeId;
+    };
+    for (;;) {
+        std::string segment;
+        long long offset;
+        if (!StorageLayout::findRecord(StorageLayout::itemSegments(), matches, changeItem, segment, offset)) {
+            ItemArchive::ReadScope archiveScope;
+            std::string archive;
+            if (ItemArchive::find(findChangeId, changeItem, archive))
+                return true;
+            if (!StorageLayout::findRecord(StorageLayout::itemSegments(), matches, changeItem, segment, offset)) {
+                itemFilter.falsePositive();
+                return false;
             }
         }
-        if (file.eof())
-            std::cout << currentEntry + 1 << ") Add new ChangeItem\n";
-        std::cout << "To load next 20 descriptions enter 'N': ";
-        std::cin >> input;
-        if (input == "N"){
-            if (file.eof()){
-                while (input == "N"){
-                    std::cout << "End of list must choose an option";
-                    std::cin >> input;
-                }
-            }
-            else {
-                multiple++;
+        RecordLock recordLock(segment.c_str(), offset, sizeof(ChangeItem), false);
+        std::ifstream infile(segment, std::ios::binary);
+        infile.seekg(offset);
+        if (infile.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem)) && changeItem.changeId == findChangeId)
+            return true;
+    }
+}
+
+/**********************************************
+ * Function: getChangeItems
+ * Description:
+ * Looks up many change IDs at once. The IDs are sorted and the ones the lookup
+ * filter rules out are dropped; the rest are found in a single parallel pass over
+ * the segments, which stops once all of them have turned up. The IDs still
+ * missing are looked up in the archives and, as findChangeItem does, in the
+ * segments again. The records found in the segments are then read again, in file
+ * order, under a shared lock on their bytes, so no half-written record is
+ * returned; one that has moved meanwhile is looked up on its own.
+ * Parameters:
+ * - changeIds: The change IDs to retrieve
+ * Returns: One optional ChangeItem per change ID, in the order given
+ **********************************************/
+std::vector<std::optional<ChangeItem>> ChangeItem::getChangeItems(std::span<const int> changeIds) {
+    Metrics::Timer timer(Metrics::ITEM_GET_MANY);
+    std::vector<int> keys(changeIds.begin(), changeIds.end());
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    keys.erase(std::remove_if(keys.begin(), keys.end(), [](int changeId) {
+        return !itemFilter.mayContain(integerKey(changeId));
+    }), keys.end());
+
+    struct Location {
+        std::string segment;
+        long long offset;
+        size_t index;
+    };
+    auto keyOf = [](const char* candidate) {
+        return Schema<ChangeItem>::read<FIELD_CHANGE_ID>(candidate);
+    };
+    std::vector<Location> locations;
+    std::vector<char> seen(keys.size(), 0);
+    size_t found = StorageLayout::findRecords<ChangeItem>(StorageLayout::itemSegments(), keyOf, keys,
+                                                          [&](size_t index, const char*, const std::string& segment, long long offset) {
+        locations.push_back({segment, offset, index});
+        seen[index] = 1;
+    });
+
+    std::vector<std::optional<ChangeItem>> byKey(keys.size());
+    if (found < keys.size()) {
+        ItemArchive::ReadScope archiveScope;
+        std::vector<int> missing;
+        std::vector<size_t> missingIndex;
+        for (size_t i = 0; i < keys.size(); i++) {
+            ChangeItem changeItem;
+            std::string archive;
+            if (seen[i])
                 continue;
-            }   
-        }
-        else{
-            while (std::stoi(input) < 1 || std::stoi(input) > currentEntry + 1){
-                std::cout << "Not a valid option. Try again";
-                std::cin >> input;
+            if (ItemArchive::find(keys[i], changeItem, archive)) {
+                byKey[i] = changeItem;
+            } else {
+                missing.push_back(keys[i]);
+                missingIndex.push_back(i);
             }
-        break;
         }
+        size_t late = StorageLayout::findRecords<ChangeItem>(StorageLayout::itemSegments(), keyOf, missing,
+                                                             [&](size_t index, const char*, const std::string& segment, long long offset) {
+            locations.push_back({segment, offset, missingIndex[index]});
+        });
+        for (size_t i = late; i < missing.size(); i++)
+            itemFilter.falsePositive();
     }
-    closeChangeItem();
-    if (std::stoi(input) != currentEntry + 1)
-        return changeItems[std::stoi(input) - 1];
-    
-    else if (std::stoi(input) == currentEntry + 1){
-        std::string itemDescription;
-        int itemPriority;
-        std::cout << "Enter a description of the ChangeItem (max 40 char): ";
-        std::cin >>  itemDescription;
-        if (itemDescription.length() > 40)
-            itemDescription.substr(0, 40);
-        std::cout << "Enter a priority (number between 1-5): ";
-        std::cin >> itemPriority;
-        while (itemPriority < 1 || itemPriority > 5){
-            std::cout << "Not a valid priority. Try again: ";
-            std::cin >> itemPriority;
+
+    std::sort(locations.begin(), locations.end(), [](const Location& a, const Location& b) {
+        return a.segment != b.segment ? a.segment < b.segment : a.offset < b.offset;
+    });
+    std::ifstream infile;
+    std::string openSegment;
+    for (const Location& location : locations) {
+        if (location.segment != openSegment) {
+            infile.close();
+            infile.clear();
+            infile.open(location.segment, std::ios::binary);
+            openSegment = location.segment;
         }
-        std::cout << "Enter a status of the ChangeItem: " << std::endl;
-        std::cout << "1) Assessed " << std::endl;
-        std::cout << "2) In-Progress " << std::endl;
-        std::cout << "3) Done " << std::endl;
-        std::cout << "4) Cancelled " << std::endl;
-        std::cout << "Enter selection: ";
-        std::cin >> intInput;
-        while (intInput < 0 || intInput > 4){
-            std::cout << "Not a valid option. Try again: " << std::endl;
-            std::cout << "1) Assessed " << std::endl;
-            std::cout << "2) In-Progress " << std::endl;
-            std::cout << "3) Done " << std::endl;
-            std::cout << "4) Cancelled ";
-            std::cin >> intInput;
+        ChangeItem changeItem;
+        bool read;
+        {
+            RecordLock recordLock(location.segment.c_str(), location.offset, sizeof(ChangeItem), false);
+            infile.seekg(location.offset);
+            read = infile.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem)) && changeItem.changeId == keys[location.index];
         }
-        State itemState;
-        if (intInput == 1)
-            itemState = ChangeItem::ASSESSED;       
-        if (intInput == 2)
-            itemState = ChangeItem::INPROGRESS;
-        if (intInput == 3)
-            itemState = ChangeItem::DONE;
-        if (intInput == 4)
-            itemState = ChangeItem::CANCELLED;
-        std::cout << "Enter the release ID (Format: X.X.X.X): ";
-        std::string id;
-        std::cin >> id;
-        bool badId = true;
-        while (badId == true){
-            badId = false;
-            if (id.length() > 7)
-                badId = true;
-            if (!std::isdigit(id[0]) || !std::isdigit(id[2]) || !std::isdigit(id[4]) || !std::isdigit(id[6]))
-                badId = true;
-            if (id[1] != '.' || id[3] != '.' || id[5] != '.')
-                badId = true;
-            if (badId == true){
-                std::cout << "Not a valid release ID. Try again (Format: X.X.X.X): ";
-            std::cin >> id;
+        if (read)
+            byKey[location.index] = changeItem;
+        else if (findChangeItem(keys[location.index], changeItem)) // Outside the lock, as it may wait for others
+            byKey[location.index] = changeItem; // Moved since it was found
+        infile.clear();
+    }
+
+    std::vector<std::optional<ChangeItem>> results;
+    results.reserve(changeIds.size());
+    for (int changeId : changeIds) {
+        auto key = std::lower_bound(keys.begin(), keys.end(), changeId);
+        if (key != keys.end() && *key == changeId)
+            results.push_back(byKey[static_cast<size_t>(key - keys.begin())]);
+        else
+            results.emplace_back();
+    }
+    return results;
+}
+
+/**********************************************
+ * Function: updateRecord
+ * Description:
+ * Finds the record with the change ID in whichever segment holds it, then locks
+ * only that record's bytes and re-reads it so the change is applied to the latest
+ * copy. If expectedVersion is
+ * not ANY_VERSION and the record has been changed since the caller read it, the
+ * record is left alone. Otherwise the old record is kept for open snapshots, the
+ * change is applied, the version is bumped and the record is written back before
+ * the lock is released. A segment in an older record version is upgraded first
+ * and the record looked up again, and so is a record moved before it was locked.
+ * An archived item is moved back into its segment first, since archives are
+ * never written in place.
+ * Parameters:
+ * - theChangeId: The change ID of the ChangeItem to update
+ * - expectedVersion: The version the caller last saw, or ANY_VERSION
+ * - apply: Applies the change to the record
+ * - value: Passed to apply
+ * Returns: UpdateResult - The outcome of the update
+ **********************************************/
+ChangeItem::UpdateResult ChangeItem::updateRecord(int theChangeId, int expectedVersion, void (*apply)(ChangeItem&, int), int value) {
+    Metrics::Timer timer(Metrics::ITEM_UPDATE);
+    if (!itemFilter.mayContain(integerKey(theChangeId)))
+        return UPDATE_NOT_FOUND;
+
+    // The record is located without holding any lock, and checked once locked, since archiving moves records
+    auto matches = [theChangeId](const char* candidate) {
+        return Schema<ChangeItem>::read<FIELD_CHANGE_ID>(candidate) == theChangeId;
+    };
+    ChangeItem changeItem;
+    std::string segment;
+    long long pos;
+    std::fstream record;
+    std::optional<RecordLock> recordLock;
+    for (;;) {
+        recordLock.reset();
+        bool partitioned = StorageLayout::isPartitioned();
+        bool found = StorageLayout::findRecord(StorageLayout::itemSegments(), matches, changeItem, segment, pos);
+        if (!found) {
+            std::string archive;
+            {
+                ItemArchive::ReadScope archiveScope;
+                if (!ItemArchive::find(theChangeId, changeItem, archive))
+                    found = StorageLayout::findRecord(StorageLayout::itemSegments(), matches, changeItem, segment, pos);
             }
-        }
-        std::string idDate;
-        std::cout << "Enter the date (Format: YYYY-MM-DD): ";
-        std::cin >> idDate;
-        bool badDate = true;
-        while (badDate == true){
-            badDate = false;
-            if (idDate.length() > 10)
-                badDate = true;
-            if (!std::isdigit(idDate[0]) || !std::isdigit(idDate[1]) || !std::isdigit(idDate[2]) || !std::isdigit(idDate[3]) || !std::isdigit(idDate[5]) || !std::isdigit(idDate[6]) || !std::isdigit(idDate[8]) || !std::isdigit(idDate[9]))
-                badDate = true;
-            if (idDate[4] != '-' || idDate[7] != '-')
-                badDate = true;
-            if (badDate == true) {
-                std::cout << "Not a valid date, Try Again (YYYY-MM-DD): ";
-                std::cin >> idDate;
+            if (!archive.empty()) {
+                if (ItemArchive::restore(archive, {theChangeId}) < 0)
+                    return UPDATE_NOT_FOUND;
+                continue;
+            }
+            if (!found) {
+                itemFilter.falsePositive();
+                return UPDATE_NOT_FOUND;
             }
         }
-
-        Product changeItemProduct = Product();
-        changeItemProduct.updateName(product.c_str());
-        //Product changeItemProduct = Product(product.c_str());
-        ProductRelease newRelease = ProductRelease (changeItemProduct, id.c_str(), idDate.c_str());
-        ProductRelease::createProductRelease(newRelease);
-        ChangeItem newChangeItem = ChangeItem(changeItemProduct, itemDescription.c_str(), itemState, itemPriority, idDate.c_str(), newRelease);
-        createChangeItem(newChangeItem);
-        std::cout << "ChangeItem Created!\n";
-        return newChangeItem;
+        // A segment in an older record version is upgraded before it is written, which moves its records
+        if (!FileFormat::layout(segment).current) {
+            if (!FileFormat::ensureCurrent(segment))
+                return UPDATE_NOT_FOUND;
+            continue;
+        }
+        recordLock.emplace(segment.c_str(), pos, sizeof(ChangeItem), true);
+        if (partitioned != StorageLayout::isPartitioned())
+            continue; // Migrated while waiting for the lock
+
+        record.close();
+        record.clear();
+        record.open(segment, std::ios::in | std::ios::out | std::ios::binary);
+        if (!record.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return UPDATE_NOT_FOUND;
+        }
+        record.seekg(pos);
+        if (record.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem)) && changeItem.changeId == theChangeId)
+            break;
+    }
+    if (!RecordChecksum::verify(segment, sizeof(ChangeItem), pos, &changeItem))
+        return UPDATE_NOT_FOUND;
+    if (expectedVersion != ANY_VERSION && changeItem.version != static_cast<uint16_t>(expectedVersion))
+        return UPDATE_CONFLICT;
+
+    Snapshot::WriteScope writeScope;
+    Snapshot::preserve(changeItem);
+    ChangeItem before = changeItem;
+    apply(changeItem, value);
+    changeItem.version++;
+    record.seekp(pos);
+    record.write(reinterpret_cast<const char*>(&changeItem), sizeof(ChangeItem));
+    record.close(); // Flushes the record before the record lock is released
+    RecordChecksum::store(segment, sizeof(ChangeItem), pos, &changeItem, 1);
+
+    // Published under the record lock, so the feed and the history order changes of one item correctly
+    std::string product = changeItem.productName.getProductName();
+    long long now = static_cast<long long>(std::time(nullptr));
+    if (changeItem.changeItemState != before.changeItemState) {
+        ChangeFeed::publish(FeedEvent::CHANGE_ITEM, FeedEvent::STATE_CHANGED, theChangeId, product, "",
+                            changeItem.changeItemState, changeItem.priority, before.changeItemState);
+        ItemHistory::record(theChangeId, product, Transition::STATE, changeItem.changeItemState, changeItem.priority, now);
+    }
+    if (changeItem.priority != before.priority) {
+        ChangeFeed::publish(FeedEvent::CHANGE_ITEM, FeedEvent::PRIORITY_CHANGED, theChangeId, product, "",
+                            changeItem.changeItemState, changeItem.priority, before.priority);
+        ItemHistory::record(theChangeId, product, Transition::PRIORITY, changeItem.changeItemState, changeItem.priority, now);
     }
+    return UPDATE_OK;
 }
 
 /**********************************************
@@ -307,37 +541,26 @@ ChangeItem ChangeItem::queryChangeItem(std::string product){
  * Parameters:
  * - newState: The new state to set
  * - theChangeId: The change ID of the ChangeItem to update
+ * Returns: bool - True if the ChangeItem was found and updated, false otherwise
  **********************************************/
-void ChangeItem::updateStatus(State newState, int theChangeId){
-    file.open("ChangeItem.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-        return;
-    }
-
-    ChangeItem changeItem;
-    bool found = false;
-    std::streampos pos;
-
-    while (!found && file.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem))) {
-        if (changeItem.changeId == theChangeId) {
-            found = true;
-            pos = file.tellg(); // Get current position
-            pos -= sizeof(ChangeItem); // Adjust position to the start of the current ChangeItem
-        }
-    }
-
-    if (found) {
-        changeItem.changeItemState = newState; // Update the state
-
-        file.seekp(pos); // Move write pointer to the correct position
-        file.write(reinterpret_cast<const char*>(&changeItem), sizeof(ChangeItem)); // Write the updated ChangeItem
-        std::cout << "ChangeItem with ID " << theChangeId << " has been updated." << std::endl;
-    } else {
-        std::cerr << "ChangeItem with ID " << theChangeId << " not found." << std::endl;
-    }
+bool ChangeItem::updateStatus(State newState, int theChangeId){
+    return compareAndSetStatus(newState, theChangeId, ANY_VERSION) == UPDATE_OK;
+}
 
-    closeChangeItem();
+/**********************************************
+ * Function: compareAndSetStatus
+ * Description:
+ * Updates the status of a ChangeItem only if its version still matches.
+ * Parameters:
+ * - newState: The new state to set
+ * - theChangeId: The change ID of the ChangeItem to update
+ * - expectedVersion: The version read together with the item, or ANY_VERSION
+ * Returns: UpdateResult - The outcome of the update
+ **********************************************/
+ChangeItem::UpdateResult ChangeItem::compareAndSetStatus(State newState, int theChangeId, int expectedVersion) {
+    return updateRecord(theChangeId, expectedVersion, [](ChangeItem& changeItem, int value) {
+        changeItem.changeItemState = static_cast<State>(value);
+    }, newState);
 }
 
 /**********************************************
@@ -347,101 +570,284 @@ void ChangeItem::updateStatus(State newState, int theChangeId){
  * Parameters:
  * - newPriority: The new priority to set
  * - theChangeId: The change ID of the ChangeItem to update
+ * Returns: bool - True if the ChangeItem was found and updated, false otherwise
  **********************************************/
-void ChangeItem::updatePriority(int newPriority, int theChangeId){ 
-        file.open("ChangeItem.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-        return;
-    }
+bool ChangeItem::updatePriority(int newPriority, int theChangeId){ 
+    return compareAndSetPriority(newPriority, theChangeId, ANY_VERSION) == UPDATE_OK;
+}
 
-    ChangeItem changeItem;
-    bool found = false;
-    std::streampos pos;
-
-    while (!found && file.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem))) {
-        if (changeItem.changeId == theChangeId) {
-            found = true;
-            pos = file.tellg(); // Get current position
-            pos -= sizeof(ChangeItem); // Adjust position to the start of the current ChangeItem
-        }
-    }
+/**********************************************
+ * Function: compareAndSetPriority
+ * Description:
+ * Updates the priority of a ChangeItem only if its version still matches.
+ * Parameters:
+ * - newPriority: The new priority to set
+ * - theChangeId: The change ID of the ChangeItem to update
+ * - expectedVersion: The version read together with the item, or ANY_VERSION
+ * Returns: UpdateResult - The outcome of the update
+ **********************************************/
+ChangeItem::UpdateResult ChangeItem::compareAndSetPriority(int newPriority, int theChangeId, int expectedVersion) {
+    return updateRecord(theChangeId, expectedVersion, [](ChangeItem& changeItem, int value) {
+        changeItem.priority = value;
+    }, newPriority);
+}
 
-    if (found) {
-        changeItem.priority = newPriority; // Update the state
+/**********************************************
+ * Function: Selection::matches
+ * Description: Checks a change item against every field of the selection that is set.
+ * Parameters:
+ * - changeItem: The change item to check
+ * Returns: bool - True if the change item is selected
+ **********************************************/
+bool ChangeItem::Selection::matches(const ChangeItem& changeItem) const {
+    return (product.empty() || changeItem.productName.getProductNameView() == product) &&
+           (releaseId.empty() || changeItem.anticipatedRelease.releaseIdView() == releaseId) &&
+           (state < 0 || changeItem.changeItemState == state) &&
+           changeItem.priority >= minPriority && changeItem.priority <= maxPriority;
+}
 
-        file.seekp(pos); // Move write pointer to the correct position
-        file.write(reinterpret_cast<const char*>(&changeItem), sizeof(ChangeItem)); // Write the updated ChangeItem
-        std::cout << "ChangeItem with ID " << theChangeId << " has been updated." << std::endl;
-    } else {
-        std::cerr << "ChangeItem with ID " << theChangeId << " not found." << std::endl;
-    }
+/**********************************************
+ * Function: bulkSetStatus
+ * Description: Sets the state of every selected ChangeItem in one pass.
+ * Parameters:
+ * - selection: The change items to update
+ * - newState: The new state to set
+ * Returns: int - The number of ChangeItems changed
+ **********************************************/
+int ChangeItem::bulkSetStatus(const Selection& selection, State newState) {
+    return bulkUpdate(selection, [](ChangeItem& changeItem, int value) {
+        changeItem.changeItemState = static_cast<State>(value);
+    }, newState);
+}
 
-    closeChangeItem();
+/**********************************************
+ * Function: bulkSetPriority
+ * Description: Sets the priority of every selected ChangeItem in one pass.
+ * Parameters:
+ * - selection: The change items to update
+ * - newPriority: The new priority to set, 1 to 5
+ * Returns: int - The number of ChangeItems changed, or -1 if the priority is out of range
+ **********************************************/
+int ChangeItem::bulkSetPriority(const Selection& selection, int newPriority) {
+    if (newPriority < 1 || newPriority > 5)
+        return -1;
+    return bulkUpdate(selection, [](ChangeItem& changeItem, int value) {
+        changeItem.priority = value;
+    }, newPriority);
 }
 
 /**********************************************
- * Function: displayChangeItems
+ * Function: bulkUpdate
  * Description:
- * Displays a list of ChangeItems for a given product and allows the user to select one.
+ * Applies a change to every selected ChangeItem in one pass. Every record of the
+ * segments involved (only the product's own segment if the selection names a
+ * product, upgraded first if it is in an older record version) is locked up
+ * front, segment by segment in name order, so concurrent
+ * single updates wait rather than interleave; records appended meanwhile are
+ * not part of the update. Then, under one WriteScope, each chunk is read, the
+ * change is applied to the matching records, their old versions are kept for
+ * open snapshots in a single log write, and the run of records from the first
+ * to the last change in the chunk is written back with one write. Since no
+ * snapshot can start while the scope is held, a snapshot sees either none or all
+ * of the changes. The feed and the history get one event per changed record
+ * before the locks are released. Archived items the change applies to are moved
+ * back into their segments first; a selection of open items skips the archives,
+ * which only hold closed ones.
  * Parameters:
- * - product: The name of the product for which to query change items
- * Returns: The selected ChangeItem object
+ * - selection: The change items to update
+ * - apply: Applies the change to a record
+ * - value: Passed to apply
+ * Returns: int - The number of ChangeItems changed
  **********************************************/
-ChangeItem ChangeItem::displayChangeItems(std::string product){
-    file.open("ChangeItem.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
+int ChangeItem::bulkUpdate(const Selection& selection, void (*apply)(ChangeItem&, int), int value) {
+    Metrics::Timer timer(Metrics::ITEM_BULK_UPDATE);
+    if (selection.state < 0 || selection.state == DONE || selection.state == CANCELLED) {
+        std::vector<std::string> archives = selection.product.empty()
+            ? StorageLayout::archiveSegments() : std::vector<std::string>{StorageLayout::archivePath(StorageLayout::itemPath(selection.product))};
+        ItemArchive::restoreMatching(archives, [&](const ChangeItem& changeItem) {
+            ChangeItem changed = changeItem;
+            apply(changed, value);
+            return selection.matches(changeItem) &&
+                   (changed.changeItemState != changeItem.changeItemState || changed.priority != changeItem.priority);
+        });
     }
-    file.seekg(0, std::ios::beg); // Reset file pointer to beginning
 
-    int multiple = 1;
-    int currentEntry;
-    std::string input;
-    ChangeItem changeItem;
-    std::vector<ChangeItem> changeItems;
-    bool done = false;
-    std::cout << "Please select a ChangeItem" << std::endl;
-    while (!done && !file.eof()){
-        int counter = 1;
-        while (file.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem)) && counter < 21) {
-            if (product == changeItem.productName.getProductName()){
-                currentEntry = multiple * counter;
-                changeItems.push_back(changeItem);
-                std::cout << currentEntry << ") " << changeItem.description << std::endl;
-                counter++;
-            }
+    std::vector<std::string> segments;
+    std::vector<long long> lengths;
+    std::deque<RecordLock> recordLocks;
+    bool partitioned;
+    do {
+        segments.clear();
+        lengths.clear();
+        recordLocks.clear();
+        partitioned = StorageLayout::isPartitioned();
+        std::vector<std::string> candidates = selection.product.empty() ? StorageLayout::itemSegments()
+                                                                        : std::vector<std::string>{StorageLayout::itemPath(selection.product)};
+        std::sort(candidates.begin(), candidates.end());
+        // Upgraded before any record is locked, since an upgrade waits for every lock on the file
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const std::string& segment) {
+            return !FileFormat::ensureCurrent(segment);
+        }), candidates.end());
+        for (const std::string& segment : candidates) {
+            std::error_code error;
+            uintmax_t size = std::filesystem::file_size(segment, error);
+            long long length = error ? 0 : static_cast<long long>(size - size % sizeof(ChangeItem));
+            if (length == 0)
+                continue;
+            recordLocks.emplace_back(segment.c_str(), 0, length, true);
+            segments.push_back(segment);
+            lengths.push_back(length);
+        }
+    } while (partitioned != StorageLayout::isPartitioned()); // Migrated while waiting for the locks
+
+    Snapshot::WriteScope writeScope;
+    std::vector<std::pair<ChangeItem, ChangeItem>> changes;   // Before and after
+    std::vector<ChangeItem> records(SCAN_CHUNK_RECORDS);
+    std::vector<ChangeItem> before;
+    std::vector<char> damaged(SCAN_CHUNK_RECORDS);
+    for (size_t s = 0; s < segments.size(); s++) {
+        std::fstream segment(segments[s], std::ios::in | std::ios::out | std::ios::binary);
+        if (!segment.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            continue;
         }
-        std::cout << "To load next 20 descriptions enter 'N': ";
-        std::cin >> input;
-        if (input == "N"){
-            if (file.eof()){
-                while (std::stoi(input) < 1 || std::stoi(input) > currentEntry){
-                    std::cout << "End of list must choose an option" << std::endl;
-                    std::cin >> input;
+        ChecksumReader checksums(segments[s], sizeof(ChangeItem));
+        for (long long offset = 0; offset < lengths[s];) {
+            size_t count = static_cast<size_t>(std::min<long long>((lengths[s] - offset) / sizeof(ChangeItem), SCAN_CHUNK_RECORDS));
+            segment.seekg(offset);
+            if (!segment.read(reinterpret_cast<char*>(records.data()), count * sizeof(ChangeItem)))
+                break;
+
+            before.clear();
+            size_t first = count, last = 0;
+            for (size_t i = 0; i < count; i++) {
+                ChangeItem& changeItem = records[i];
+                // Every record is verified, since any of them may be written back with a changed one
+                damaged[i] = !checksums.check(offset + static_cast<long long>(i * sizeof(ChangeItem)), &changeItem);
+                if (damaged[i] || !selection.matches(changeItem))
+                    continue;
+                ChangeItem old = changeItem;
+                apply(changeItem, value);
+                if (changeItem.changeItemState == old.changeItemState && changeItem.priority == old.priority)
+                    continue;
+                changeItem.version++;
+                before.push_back(old);
+                changes.emplace_back(old, changeItem);
+                first = std::min(first, i);
+                last = i;
+            }
+            if (!before.empty()) {
+                Snapshot::preserve(before);
+                segment.seekp(offset + static_cast<long long>(first * sizeof(ChangeItem)));
+                segment.write(reinterpret_cast<const char*>(&records[first]), (last - first + 1) * sizeof(ChangeItem));
+                segment.flush(); // Written before the checksums, as an update of one record is
+                // Damaged records in the run are written back unchanged and keep the checksum they fail
+                for (size_t from = first; from <= last;) {
+                    size_t to = from;
+                    while (to <= last && !damaged[to])
+                        to++;
+                    if (to > from)
+                        RecordChecksum::store(segments[s], sizeof(ChangeItem), offset + static_cast<long long>(from * sizeof(ChangeItem)),
+                                              &records[from], to - from);
+                    from = to + 1;
                 }
-                done = true;
             }
-            else {
-                multiple++;
-                continue;
-            }   
+            offset += static_cast<long long>(count * sizeof(ChangeItem));
+        }
+        segment.close(); // Flushes the records before the record locks are released
+    }
+
+    long long now = static_cast<long long>(std::time(nullptr));
+    for (const auto& [old, changeItem] : changes) {
+        std::string product = changeItem.productName.getProductName();
+        if (changeItem.changeItemState != old.changeItemState) {
+            ChangeFeed::publish(FeedEvent::CHANGE_ITEM, FeedEvent::STATE_CHANGED, changeItem.changeId, product, "",
+                                changeItem.changeItemState, changeItem.priority, old.changeItemState);
+            ItemHistory::record(changeItem.changeId, product, Transition::STATE, changeItem.changeItemState, changeItem.priority, now);
         }
-        while (std::stoi(input) < 1 || std::stoi(input) > currentEntry){
-            std::cout << "Not a valid option. Try again" << std::endl;
-            std::cin >> input;
+        if (changeItem.priority != old.priority) {
+            ChangeFeed::publish(FeedEvent::CHANGE_ITEM, FeedEvent::PRIORITY_CHANGED, changeItem.changeId, product, "",
+                                changeItem.changeItemState, changeItem.priority, old.priority);
+            ItemHistory::record(changeItem.changeId, product, Transition::PRIORITY, changeItem.changeItemState, changeItem.priority, now);
         }
-        break;
     }
-    std::cout << "Name: " << changeItems[currentEntry - 1].productName.getProductName() << std::endl;
-    std::cout << "Description: " << changeItems[currentEntry - 1].description << std::endl;
-    std::cout << "ChangeID: " << changeItems[currentEntry - 1].changeId << std::endl;
-    std::cout << "First Reported: " << changeItems[currentEntry - 1].date << std::endl;
-    std::cout << "Priority: " << changeItems[currentEntry - 1].priority << std::endl;
-    std::cout << "State: ";
-    changeItem.printState();
-    std::cout << "Anticipated Release: " << changeItems[currentEntry - 1].anticipatedRelease.releaseIdToString() << std::endl;
-    closeChangeItem();
+    return static_cast<int>(changes.size());
+}
+
+/**********************************************
+ * Function: listChangeItems
+ * Description:
+ * Reads every ChangeItem of a product without prompting the user. Only the
+ * product's own segment and its archive are read when the data is partitioned.
+ * The items are read through a snapshot, so the list is consistent even while
+ * updates go on; archived items follow the others.
+ * The result set is built in the caller's arena, so it takes no heap allocation
+ * per item and is freed with the arena.
+ * Parameters:
+ * - product: The name of the product whose change items are listed
+ * - arena: Holds the result set
+ * Returns: The matching ChangeItems in file order
+ **********************************************/
+ArenaVector<ChangeItem> ChangeItem::listChangeItems(const std::string& product, QueryArena& arena) {
+    Metrics::Timer timer(Metrics::ITEM_LIST);
+    ArenaVector<ChangeItem> changeItems = arena.vector<ChangeItem>();
+    Snapshot snapshot;
+    std::string segment = StorageLayout::itemPath(product);
+    for (const std::string& path : {segment, StorageLayout::archivePath(segment)}) {
+        snapshot.scan(path, [&](const ChangeItem& changeItem) {
+            if (product == changeItem.productName.getProductNameView())
+                changeItems.push_back(changeItem);
+        });
+    }
+    return changeItems;
+}
+
+/**********************************************
+ * Function: visitChangeItems
+ * Description:
+ * Reads the ChangeItems of a product through a snapshot like listChangeItems, but
+ * hands each one to visit as a view into the chunk the scan has just read instead
+ * of copying it. Callers that stream the items out, such as the daemon, need no
+ * result set at all.
+ * Parameters:
+ * - product: The name of the product whose change items are visited
+ * - visit: Called with a view of each matching ChangeItem, in file order
+ **********************************************/
+void ChangeItem::visitChangeItems(const std::string& product, const std::function<void(const ChangeItemView&)>& visit) {
+    Metrics::Timer timer(Metrics::ITEM_LIST);
+    Snapshot snapshot;
+    std::string segment = StorageLayout::itemPath(product);
+    for (const std::string& path : {segment, StorageLayout::archivePath(segment)}) {
+        snapshot.scan(path, [&](const ChangeItem& changeItem) {
+            if (product == changeItem.productName.getProductNameView())
+                visit(ChangeItemView(changeItem));
+        });
+    }
+}
+
+/**********************************************
+ * Function: countByState
+ * Description:
+ * Counts the ChangeItems of a product in each State in a single pass of the file
+ * and its archive, reading through a snapshot so the counts add up even while
+ * updates go on.
+ * Parameters:
+ * - product: The name of the product to report on
+ * - counts: Filled with the number of items per State, indexed by State
+ **********************************************/
+void ChangeItem::countByState(const std::string& product, int counts[4]) {
+    Metrics::Timer timer(Metrics::ITEM_REPORT);
+    for (int i = 0; i < 4; i++)
+        counts[i] = 0;
+
+    Snapshot snapshot;
+    std::string segment = StorageLayout::itemPath(product);
+    for (const std::string& path : {segment, StorageLayout::archivePath(segment)}) {
+        snapshot.scan(path, [&](const ChangeItem& changeItem) {
+            if (product == changeItem.productName.getProductNameView() && changeItem.changeItemState >= ASSESSED && changeItem.changeItemState <= CANCELLED)
+                counts[changeItem.changeItemState]++;
+        });
+    }
 }
 
 /**********************************************
@@ -450,7 +856,70 @@ ChangeItem ChangeItem::displayChangeItems(std::string product){
  * Closes the file if it is open.
  **********************************************/
 void ChangeItem::closeChangeItem() {
+    std::lock_guard<std::mutex> lock(fileMutex);
     if (file.is_open()) {
         file.close();
     }
 }
+
+/**********************************************
+ * Function: releaseChangeItemIds
+ * Description:
+ * Gives unused reserved change IDs back at shutdown so the next session continues
+ * without a gap. Only takes effect if no other process reserved IDs meanwhile.
+ **********************************************/
+void ChangeItem::releaseChangeItemIds() {
+    itemIds.release();
+}
+
+/**********************************************
+ * Function: partitionChangeItems
+ * Description:
+ * Copies every ChangeItem of the single file into the segment of its product
+ * inside directory, keeping the file order within each product.
+ * Parameters:
+ * - directory: The directory that receives the segments
+ * Returns: int - The number of ChangeItems copied, or -1 if a segment could not be written.
+ **********************************************/
+int ChangeItem::partitionChangeItems(const std::string& directory) {
+    std::ifstream infile(ITEM_FILE, std::ios::binary);
+    std::map<std::string, std::ofstream> segments;
+    ChecksumReader checksums(ITEM_FILE, sizeof(ChangeItem));
+    ChangeItem changeItem;
+    int copied = 0;
+    while (infile.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem))) {
+        if (!checksums.check(static_cast<long long>(copied) * sizeof(ChangeItem), &changeItem))
+            return -1; // A damaged record is not spread into a segment
+        std::string product = changeItem.productName.getProductName();
+        auto segment = segments.find(product);
+        if (segment == segments.end()) {
+            std::string path = StorageLayout::segmentPath(directory, ITEM_SEGMENT_PREFIX, product);
+            segment = segments.emplace(product, std::ofstream(path, std::ios::binary)).first;
+        }
+        if (!segment->second.write(reinterpret_cast<const char*>(&changeItem), sizeof(ChangeItem)))
+            return -1;
+        copied++;
+    }
+
+    for (auto& segment : segments) {
+        segment.second.close();
+        std::string path = StorageLayout::segmentPath(directory, ITEM_SEGMENT_PREFIX, segment.first);
+        if (segment.second.fail() || !RecordChecksum::init(path, sizeof(ChangeItem)) ||
+            !FileFormat::stamp(path, FileFormat::currentLayout(RecordKind::CHANGE_ITEM).version))
+            return -1;
+    }
+    return copied;
+}
+
+
+//================================
+// Accessor Implementations
+//================================
+int ChangeItem::getChangeId() const { return changeId; }
+std::string ChangeItem::getDescription() const { return std::string(description); }
+std::string ChangeItem::getProductName() const { return productName.getProductName(); }
+std::string ChangeItem::getDate() const { return std::string(date); }
+std::string ChangeItem::getReleaseId() const { return anticipatedRelease.releaseIdToString(); }
+int ChangeItem::getPriority() const { return priority; }
+ChangeItem::State ChangeItem::getState() const { return changeItemState; }
+int ChangeItem::getVersion() const { return version; }
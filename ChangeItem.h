@@ -2,6 +2,19 @@
  * ChangeItem Header File
  * Revision History:
  * - 2024-07-30: Initial version created.
+ * - 2026-10-19: Added non-interactive listing and accessors for the daemon.
+ * - 2026-10-19: Added version stamps with compare-and-swap updates and locked ID assignment.
+ * - 2026-10-19: Change IDs come from the block-reserving IdAllocator.
+ * - 2026-10-19: Added partitionChangeItems for the partition migration.
+ * - 2026-10-19: Added record views, arena-backed listings and findChangeItem; the constructor takes its product and release by reference.
+ * - 2026-10-19: Added the record schema.
+ * - 2026-10-19: Added getChangeItems for batched lookups.
+ * - 2026-10-19: Added Selection and the bulk state and priority updates.
+ * - 2026-10-19: partitionChangeItems takes the file to split, so archives are split too.
+ * - 2026-10-19: partitionChangeItems splits only ChangeItem.txt again; ItemArchive splits the archive.
+ * - 2026-10-19: Dropped the prompting queryChangeItem and displayChangeItems.
+ * - 2026-10-19: Documented that bulkSetPriority refuses an out-of-range priority.
+ * - 2026-10-19: createChangeItem reports whether the item was written.
  *--------------------------------
  * Purpose: 
  * This module provides a cohesive interface for managing change items, including initialization, 
@@ -16,9 +29,18 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <tuple>
 #include <vector>
 #include "Product.h"
 #include "ProductRelease.h"
+#include "QueryArena.h"
+#include "RecordSchema.h"
+
+class ChangeItemView;
 
 //=============================
 // Class Declaration
@@ -36,6 +58,26 @@ public:
         CANCELLED
     };
 
+    enum UpdateResult {
+        UPDATE_OK,          // The record was changed
+        UPDATE_NOT_FOUND,   // No record has the change ID
+        UPDATE_CONFLICT     // The record's version no longer matches the expected version
+    };
+
+    static const int ANY_VERSION = -1; // Expected version that makes an update unconditional
+
+    // Which change items a bulk update applies to. Every field left at its default
+    // matches everything; the fields that are set must all match.
+    struct Selection {
+        std::string product;        // Only this product's items; also limits the update to its segment
+        std::string releaseId;      // Only items anticipated for this release
+        int state = -1;             // Only items in this State
+        int minPriority = 1;        // Only items with a priority in [minPriority, maxPriority]
+        int maxPriority = 5;
+
+        bool matches(const ChangeItem& changeItem) const;
+    };
+
     //=============================
     // Constructor Declarations
     //=============================
@@ -44,14 +86,15 @@ public:
     // Description: Default constructor for the ChangeItem class.
 
     //----------------------------------------------------------
-    ChangeItem(Product product, const char* n, State theState, int priority, const char* reportedDate, ProductRelease changeRelease);
+    ChangeItem(const Product& product, const char* n, State theState, int priority, const char* reportedDate, const ProductRelease& changeRelease);
     // Description: Parameterized constructor for creating a new ChangeItem object.
     // Parameters: 
-    // - Product product: The product associated with the change item.
+    // - const Product& product: The product associated with the change item.
     // - const char* n: The description of the change item.
     // - State theState: The state of the change item.
     // - int priority: The priority of the change item.
     // - const char* reportedDate: The date the change was reported.
+    // - const ProductRelease& changeRelease: The release the change is anticipated in.
 
     //=============================
     // Function Declarations
@@ -69,10 +112,13 @@ public:
     // Returns: bool - True if the file is successfully opened and initialized, false otherwise.
 
     //----------------------------------------------------------
-    static void createChangeItem(const ChangeItem& product);
-    // Description: Writes a new ChangeItem object to the file.
+    static bool createChangeItem(ChangeItem& changeItem);
+    // Description: Assigns the next free change ID to a ChangeItem and appends it to the file.
+    //              IDs come from a block-reserving allocator and never collide across threads,
+    //              processes or crashes.
     // Parameters: 
-    // - const ChangeItem& product: The ChangeItem object to be written to the file.
+    // - ChangeItem& changeItem: The ChangeItem object to be written to the file; receives its change ID.
+    // Returns: bool - False if no ID could be assigned or the record could not be written.
 
     //----------------------------------------------------------
     static ChangeItem getChangeItem(int findChangeId);
@@ -82,48 +128,178 @@ public:
     // Returns: ChangeItem object if found, otherwise throws an exception.
 
     //----------------------------------------------------------
-    static ChangeItem queryChangeItem(std::string product);
-    // Description: Interacts with the user to create a new ChangeItem or select an existing one based on the product name.
+    static bool findChangeItem(int findChangeId, ChangeItem& changeItem);
+    // Description: Reads a ChangeItem into storage the caller provides, e.g. on its stack.
+    //              Unlike getChangeItem, a missing ID is not an exception. Archived items
+    //              are found too.
     // Parameters: 
-    // - std::string product: The name of the product for which to query change items.
-    // Returns: ChangeItem object created or selected by the user.
+    // - int findChangeId: The change ID of the ChangeItem to retrieve.
+    // - ChangeItem& changeItem: Receives the record.
+    // Returns: bool - True if the ChangeItem was found.
+
+    //----------------------------------------------------------
+    static std::vector<std::optional<ChangeItem>> getChangeItems(std::span<const int> changeIds);
+    // Description: Looks up many ChangeItems in one pass over the segments instead of one scan each.
+    // Parameters: 
+    // - std::span<const int> changeIds: The change IDs to retrieve, in any order, repeats allowed.
+    // Returns: One entry per change ID, in the same order; empty where the ID does not exist.
 
     //----------------------------------------------------------
-    static void updateStatus(State newState, int theChangeId);
+    static bool updateStatus(State newState, int theChangeId);
     // Description: Updates the status of a ChangeItem in the file based on the change ID.
     // Parameters: 
     // - State newState: The new state to set.
     // - int theChangeId: The change ID of the ChangeItem to update.
+    // Returns: bool - True if the ChangeItem was found and updated, false otherwise.
 
     //----------------------------------------------------------
-    static void updatePriority(int newPriority, int theChangeId);
+    static UpdateResult compareAndSetStatus(State newState, int theChangeId, int expectedVersion);
+    // Description: Updates the status only if the record still carries expectedVersion.
+    //              Only the bytes of this one record are locked while it is rewritten.
+    // Parameters: 
+    // - State newState: The new state to set.
+    // - int theChangeId: The change ID of the ChangeItem to update.
+    // - int expectedVersion: The version read together with the item, or ANY_VERSION.
+    // Returns: UpdateResult - UPDATE_CONFLICT if another writer changed the record first.
+
+    //----------------------------------------------------------
+    static bool updatePriority(int newPriority, int theChangeId);
     // Description: Updates the priority of a ChangeItem in the file based on the change ID.
     // Parameters: 
     // - int newPriority: The new priority to set.
     // - int theChangeId: The change ID of the ChangeItem to update.
+    // Returns: bool - True if the ChangeItem was found and updated, false otherwise.
+
+    //----------------------------------------------------------
+    static UpdateResult compareAndSetPriority(int newPriority, int theChangeId, int expectedVersion);
+    // Description: Updates the priority only if the record still carries expectedVersion.
+    // Parameters: 
+    // - int newPriority: The new priority to set.
+    // - int theChangeId: The change ID of the ChangeItem to update.
+    // - int expectedVersion: The version read together with the item, or ANY_VERSION.
+    // Returns: UpdateResult - UPDATE_CONFLICT if another writer changed the record first.
+
+    //----------------------------------------------------------
+    static int bulkSetStatus(const Selection& selection, State newState);
+    static int bulkSetPriority(const Selection& selection, int newPriority);
+    // Description: Sets the state (priority) of every ChangeItem matching selection in one pass,
+    //              as a single commit: an open snapshot sees either none or all of the changes.
+    //              Archived items that change are moved back into their segments first.
+    // Parameters: 
+    // - const Selection& selection: The change items to update.
+    // - newState / newPriority: The value to set.
+    // Returns: int - The number of ChangeItems changed; items that already had the value are not counted.
+    //          bulkSetPriority returns -1, changing nothing, for a priority outside 1 to 5.
 
     //----------------------------------------------------------
-    static ChangeItem displayChangeItems(std::string product);
-    // Description: Displays a list of ChangeItems for a given product and allows the user to select one.
+    static ArenaVector<ChangeItem> listChangeItems(const std::string& product, QueryArena& arena);
+    // Description: Reads every ChangeItem of a product without prompting the user, archived ones included.
     // Parameters: 
-    // - std::string product: The name of the product for which to query change items.
-    // Returns: The selected ChangeItem object.
+    // - const std::string& product: The name of the product whose change items are listed.
+    // - QueryArena& arena: Holds the result set; it is freed together with the arena.
+    // Returns: ArenaVector<ChangeItem> - The matching change items in file order.
+
+    //----------------------------------------------------------
+    static void visitChangeItems(const std::string& product, const std::function<void(const ChangeItemView&)>& visit);
+    // Description: Calls visit with a view of every ChangeItem of a product, in file order,
+    //              without copying the records. The view is only valid during the call.
+    // Parameters: 
+    // - const std::string& product: The name of the product whose change items are visited.
+    // - visit: Called once per matching change item.
+
+    //----------------------------------------------------------
+    static void countByState(const std::string& product, int counts[4]);
+    // Description: Counts the ChangeItems of a product in each State.
+    // Parameters: 
+    // - const std::string& product: The name of the product to report on.
+    // - int counts[4]: Filled with the number of items per State, indexed by State.
 
     //----------------------------------------------------------
     static void closeChangeItem();
     // Description: Closes the file if it is open.
 
+    //----------------------------------------------------------
+    static void releaseChangeItemIds();
+    // Description: Gives unused reserved change IDs back at shutdown so the next session
+    //              continues without a gap.
+
+    //----------------------------------------------------------
+    static int partitionChangeItems(const std::string& directory);
+    // Description: Copies every ChangeItem of the single file into the segment of its
+    //              product inside directory. Used when migrating to the partitioned layout;
+    //              the archive is split by ItemArchive::partition.
+    // Returns: int - The number of ChangeItems copied, or -1 if a segment could not be written.
+
+    //=============================
+    // Accessor Declarations
+    //=============================
+    int getChangeId() const;
+    std::string getDescription() const;
+    std::string getProductName() const;
+    std::string getDate() const;
+    std::string getReleaseId() const;
+    int getPriority() const;
+    State getState() const;
+    int getVersion() const;
+
+    //=============================
+    // Schema Declarations
+    //=============================
+    enum Field : size_t {   // Stored fields, in file order
+        FIELD_CHANGE_ID,
+        FIELD_DESCRIPTION,
+        FIELD_PRODUCT,
+        FIELD_DATE,
+        FIELD_RELEASE,
+        FIELD_VERSION,
+        FIELD_PRIORITY,
+        FIELD_STATE,
+        FIELD_COUNT
+    };
+
 private:
-    static int currentChangeIdCount;
+    friend class ChangeItemView;
+    friend class Schema<ChangeItem>;
+    static constexpr auto schemaFields() {
+        return std::make_tuple(SchemaField<&ChangeItem::changeId>{"changeId"},
+                               SchemaField<&ChangeItem::description>{"description"},
+                               SchemaField<&ChangeItem::productName>{"product"},
+                               SchemaField<&ChangeItem::date>{"date"},
+                               SchemaField<&ChangeItem::anticipatedRelease>{"release"},
+                               SchemaField<&ChangeItem::version>{"version"},
+                               SchemaField<&ChangeItem::priority>{"priority"},
+                               SchemaField<&ChangeItem::changeItemState>{"state"});
+    }
+
+    //----------------------------------------------------------
+    static int scanMaxChangeId();
+    // Description: Returns the largest change ID in the file, or -1. Used to recover the ID allocator.
+
+    //----------------------------------------------------------
+    static UpdateResult updateRecord(int theChangeId, int expectedVersion, void (*apply)(ChangeItem&, int), int value);
+    // Description: Locks one record, checks its version, applies the change and bumps the version.
+
+    //----------------------------------------------------------
+    static int bulkUpdate(const Selection& selection, void (*apply)(ChangeItem&, int), int value);
+    // Description: Locks every record of the selected segments, applies the change to the matching
+    //              ones and writes each run of changed records back with one write.
+
     int changeId;
     char description[150];
     Product productName;
     char date[11];
     ProductRelease anticipatedRelease;
+    uint16_t version;   // Bumped by every update; occupies what used to be padding, so the record size is unchanged
     int priority;
 
     State changeItemState;
 
 
 };
+
+// Change items are read and written in place by updates, snapshots, the version log
+// and the replica, so the struct itself must be the packed record.
+static_assert(Schema<ChangeItem>::COUNT == ChangeItem::FIELD_COUNT, "ChangeItem fields and schema disagree");
+static_assert(Schema<ChangeItem>::SIZE == 216, "ChangeItem records are 216 bytes in ChangeItem.txt");
+static_assert(Schema<ChangeItem>::PACKED_IN_MEMORY, "ChangeItem members must not be padded");
 #endif // CHANGE_ITEM_H
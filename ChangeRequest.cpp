@@ -2,6 +2,22 @@
  * ChangeRequest Implementation File
  * Revision History:
  * - 2024-07-30: Initial version created.
+ * - 2026-10-19: Added accessors for the daemon.
+ * - 2026-10-19: Change IDs are assigned under the append lock.
+ * - 2026-10-19: Change IDs come from the block-reserving IdAllocator.
+ * - 2026-10-19: Change requests are stored in per-product segments when the data is partitioned.
+ * - 2026-10-19: New change requests are published to the change feed.
+ * - 2026-10-19: The ID mark file name comes from StorageLayout.h.
+ * - 2026-10-19: Added findChangeRequest; the constructor takes the product by reference.
+ * - 2026-10-19: Records are stored packed through the record schema; added unpadChangeRequests.
+ * - 2026-10-19: Change ID lookups check a persisted Bloom filter before scanning.
+ * - 2026-10-19: Added batched lookups that find many change IDs in one pass.
+ * - 2026-10-19: New change requests publish the change item they are about; RequestLinks is initialized with them.
+ * - 2026-10-19: Records are written with checksums and verified when read.
+ * - 2026-10-19: Replaced unpadChangeRequests with the upgradeFormat1 converter; writes upgrade old files first, scans read any record version.
+ * - 2026-10-19: Operations timed for the metrics endpoint.
+ * - 2026-10-19: The append lock wait is traced as a span.
+ * - 2026-10-19: createChangeRequest, initChangeRequest and closeChangeRequest lock the shared stream themselves.
  *--------------------------------
  * Purpose: 
  * This module implements the ChangeRequest class, providing functionality for creating,
@@ -9,17 +25,42 @@
  * to store and retrieve change request data, ensuring data integrity and proper handling 
  * of change requests.
  **********************************************/
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <cstring>
 #include <vector>
+#include <filesystem>
+#include <map>
+#include <atomic>
+#include <optional>
 
 #include "ChangeRequest.h"
+#include "BloomFilter.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "IdAllocator.h"
+#include "Metrics.h"
 #include "ObjectNotFoundException.h"
+#include "StorageLayout.h"
+#include "Trace.h"
+#include "ChangeFeed.h"
+#include "RequestLinks.h"
+#include "RecordChecksum.h"
 
 static std::fstream file;
+static std::mutex fileMutex;   // Serializes every use of file, from any caller
 
-int ChangeRequest::currentChangeIdCount = 0;
+static IdAllocator requestIds(REQUEST_FILE, REQUEST_MARK_FILE);
+
+// Passes the change ID of a packed ChangeRequest record to visit.
+static void requestKeys(const char* record, const BloomFilter::KeyVisitor& visit) {
+    int changeId = Schema<ChangeRequest>::read<ChangeRequest::FIELD_CHANGE_ID>(record);
+    visit(integerKey(changeId));
+}
+
+static BloomFilter requestFilter(REQUEST_FILTER_FILE, REQUEST_FILE, FILTER_LOCK_OFFSET, ChangeRequest::RECORD_SIZE, StorageLayout::requestSegments, requestKeys);
 
 /**********************************************
  * Constructor: ChangeRequest
@@ -30,20 +71,19 @@ ChangeRequest::ChangeRequest() {}
 /**********************************************
  * Constructor: ChangeRequest
  * Description: Parameterized constructor for creating a new ChangeRequest object.
+ *              The change ID is assigned when it is written by createChangeRequest.
  * Parameters: 
  * - const char* requester: The name of the requester.
- * - Product product: The product associated with the change request.
+ * - const Product& product: The product associated with the change request.
  * - const char* theDate: The date the change request was submitted.
  **********************************************/
-ChangeRequest::ChangeRequest(const char* requester, Product product, const char * theDate){
-    changeId = currentChangeIdCount++;
+ChangeRequest::ChangeRequest(const char* requester, const Product& product, const char * theDate){
+    changeId = -1; // Assigned by createChangeRequest
     productName = product;
     strncpy(requestedBy, requester, 29);
     strncpy(date, theDate, 10);
     date[10] = '\0';
     requestedBy[29] = '\0';
-
-    cout << "Change request submitted!" << endl;
 }
 
 /**********************************************
@@ -62,86 +102,273 @@ void ChangeRequest::printId() {
  * Returns: bool - True if the file is successfully opened and initialized, false otherwise.
  **********************************************/
 bool ChangeRequest::initChangeRequest() {
-    file.open("ChangeRequest.txt", std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        file.open(REQUEST_FILE, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return false;
+        }
+        file.close();
     }
 
-    // Find the last changeId from the file
-    std::ifstream infile("ChangeRequest.txt", std::ios::binary | std::ios::ate);
-    if (!infile.is_open()) {
-        std::cerr << "Failed to open file for reading." << std::endl;
+    if (!StorageLayout::upgradeRecordFormat())
+        return false;
+    for (const std::string& segment : StorageLayout::requestSegments())
+        RecordChecksum::init(segment, FileFormat::layout(segment).size);
+    requestFilter.init();
+    if (!RequestLinks::init()) {
+        std::cerr << "Failed to update the request links." << std::endl;
         return false;
     }
+    return requestIds.init(scanMaxChangeId);
+}
 
-    std::streampos fileSize = infile.tellg();
-    if (fileSize < sizeof(ChangeRequest)) {
-        currentChangeIdCount = 0; // No items in file
-    } else {
-        infile.seekg(-sizeof(ChangeRequest), std::ios::end);
-        ChangeRequest lastChangeRequest;
-        infile.read(reinterpret_cast<char*>(&lastChangeRequest), sizeof(ChangeRequest));
-        currentChangeIdCount = lastChangeRequest.changeId + 1;
-    }
-
-    infile.close();
-    file.close();
-    return true;
+/**********************************************
+ * Function: scanMaxChangeId
+ * Description: Reads every segment for the largest change ID, in parallel when the data is
+ *              partitioned. Only needed when the ID allocator has lost its high-water mark,
+ *              since IDs handed out by concurrent processes are not stored in increasing order.
+ * Returns: int - The largest change ID, or -1 if no segment holds records.
+ **********************************************/
+int ChangeRequest::scanMaxChangeId() {
+    std::atomic<int> maxChangeId(-1);
+    StorageLayout::forEachSegment(StorageLayout::requestSegments(), [&](const std::string& path) {
+        VersionedReader reader(path);
+        std::ifstream infile(path, std::ios::binary);
+        char record[RECORD_SIZE];
+        int segmentMax = -1;
+        while (reader.usable() && reader.read(infile, record, 1) == 1) {
+            int changeId = Schema<ChangeRequest>::read<FIELD_CHANGE_ID>(record);
+            if (changeId > segmentMax)
+                segmentMax = changeId;
+        }
+        int seen = maxChangeId.load();
+        while (segmentMax > seen && !maxChangeId.compare_exchange_weak(seen, segmentMax)) {}
+    });
+    return maxChangeId;
 }
 
 /**********************************************
  * Function: createChangeRequest
- * Description: Writes a new ChangeRequest object to the file.
+ * Description: Assigns the next free change ID to a ChangeRequest and appends it to the file
+ *              (segment) of its product. The ID comes from the allocator without any file I/O in the common case. The
+ *              append sentinel of the file is locked while writing, so a partial record left
+ *              by a crashed writer can be cut off before appending. The change ID goes into
+ *              the lookup filter before the record is written.
+ *              The change item the request is about is published with it and linked by RequestLinks.
+ *              A file in an older record version is upgraded first.
  * Parameters: 
- * - const ChangeRequest& changeRequest: The ChangeRequest object to be written to the file.
+ * - ChangeRequest& changeRequest: The ChangeRequest object to be written to the file; receives its change ID.
+ * - int changeItemId: The change item the request is about, or -1 if it has none.
  **********************************************/
- void ChangeRequest::createChangeRequest(const ChangeRequest& changeRequest) {
-    file.open("ChangeRequest.txt", std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
+void ChangeRequest::createChangeRequest(ChangeRequest& changeRequest, int changeItemId) {
+    Metrics::Timer timer(Metrics::REQUEST_CREATE);
+    requestFilter.growIfFull(); // Before any lock is held, since a rebuild waits for every writer
+    changeRequest.changeId = requestIds.nextId();
+    if (changeRequest.changeId < 0) {
+        std::cerr << "Failed to assign a change ID." << std::endl;
+        return;
+    }
+
+    std::string product = changeRequest.productName.getProductName();
+    if (!FileFormat::ensureCurrent(StorageLayout::requestPath(product))) { // Before any lock, since an upgrade waits for them
+        std::cerr << "Failed to write the ChangeRequest." << std::endl;
+        return;
+    }
+    std::string path;
+    BloomFilter::WriteScope filterScope(requestFilter);
+    requestFilter.add(integerKey(changeRequest.changeId));
+    std::optional<RecordLock> appendLock;
+    {
+        Trace::Span span("append_lock.wait", "lock");
+        do {
+            path = StorageLayout::requestPath(product);
+            appendLock.emplace(path.c_str(), APPEND_LOCK_OFFSET, 1, true);
+        } while (path != StorageLayout::requestPath(product)); // Migrated while waiting for the lock
     }
 
-    file.write(reinterpret_cast<const char*>(&changeRequest), sizeof(ChangeRequest));
-    closeChangeRequest();
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    if (!error && size % RECORD_SIZE != 0)
+        std::filesystem::resize_file(path, size - size % RECORD_SIZE, error);
+    long long offset = error ? 0 : static_cast<long long>(size - size % RECORD_SIZE);
+
+    char record[RECORD_SIZE];
+    Schema<ChangeRequest>::encode(changeRequest, record);
+    RecordChecksum::store(path, RECORD_SIZE, offset, record, 1); // Before the record, so a torn append fails
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+        }
+        file.write(record, sizeof(record));
+        file.close(); // Flushes the record before the append lock is released
+    }
+    ChangeFeed::publish(FeedEvent::CHANGE_REQUEST, FeedEvent::CREATED, changeRequest.changeId, product,
+                        changeRequest.requestedBy, -1, -1, -1, changeItemId);
 }
 
 /**********************************************
  * Function: getChangeRequest
  * Description: Retrieves a ChangeRequest object from the file based on the change ID.
+ *              Every segment is searched, in parallel when the data is partitioned, each
+ *              with its own stream so lookups stay reentrant.
  * Parameters: 
  * - int findChangeId: The change ID of the ChangeRequest to retrieve.
  * Returns: ChangeRequest object if found, otherwise throws an exception.
  **********************************************/
 ChangeRequest ChangeRequest::getChangeRequest(int findChangeId) {
-    file.open("ChangeRequest.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-    }
-
-    file.seekg(0, std::ios::beg); // Reset file pointer to beginning
     ChangeRequest changeRequest;
-    bool found = false;
-    while (!found && file.read(reinterpret_cast<char*>(&changeRequest), sizeof(ChangeRequest))) {
-        if (changeRequest.changeId == findChangeId) {
-            found = true;
-        }
-    }
-
-    closeChangeRequest();
-    if (found)
+    if (findChangeRequest(findChangeId, changeRequest))
         return changeRequest;
     else throw ObjectNotFoundException("Object with this changeID was not found in file");
 
     return changeRequest;
 }
 
+/**********************************************
+ * Function: findChangeRequest
+ * Description: Does the work of getChangeRequest, reading the record straight into the
+ *              caller's storage. A missing ID is reported by the return value, and an ID
+ *              the lookup filter has never seen is answered without reading any segment.
+ * Parameters: 
+ * - int findChangeId: The change ID of the ChangeRequest to retrieve.
+ * - ChangeRequest& changeRequest: Receives the record.
+ * Returns: bool - True if the ChangeRequest was found.
+ **********************************************/
+bool ChangeRequest::findChangeRequest(int findChangeId, ChangeRequest& changeRequest) {
+    Metrics::Timer timer(Metrics::REQUEST_GET);
+    if (!requestFilter.mayContain(integerKey(findChangeId)))
+        return false;
+    std::string segment;
+    long long offset;
+    bool found = StorageLayout::findRecord(StorageLayout::requestSegments(), [findChangeId](const char* candidate) {
+        return Schema<ChangeRequest>::read<FIELD_CHANGE_ID>(candidate) == findChangeId;
+    }, changeRequest, segment, offset);
+    if (!found)
+        requestFilter.falsePositive();
+    return found;
+}
+
+/**********************************************
+ * Function: getChangeRequests
+ * Description: Looks up many change IDs at once. The IDs are sorted and the ones the lookup
+ *              filter rules out are dropped; the rest are found in a single parallel pass
+ *              over the segments, which stops once all of them have turned up.
+ * Parameters: 
+ * - std::span<const int> changeIds: The change IDs to retrieve.
+ * Returns: One optional ChangeRequest per change ID, in the order given.
+ **********************************************/
+std::vector<std::optional<ChangeRequest>> ChangeRequest::getChangeRequests(std::span<const int> changeIds) {
+    Metrics::Timer timer(Metrics::REQUEST_GET_MANY);
+    std::vector<int> keys(changeIds.begin(), changeIds.end());
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    keys.erase(std::remove_if(keys.begin(), keys.end(), [](int changeId) {
+        return !requestFilter.mayContain(integerKey(changeId));
+    }), keys.end());
+
+    std::vector<std::optional<ChangeRequest>> byKey(keys.size());
+    size_t found = StorageLayout::findRecords<ChangeRequest>(StorageLayout::requestSegments(), [](const char* candidate) {
+        return Schema<ChangeRequest>::read<FIELD_CHANGE_ID>(candidate);
+    }, keys, [&](size_t index, const char* record, const std::string&, long long) {
+        Schema<ChangeRequest>::decode(record, byKey[index].emplace());
+    });
+    for (size_t missing = found; missing < keys.size(); missing++)
+        requestFilter.falsePositive();
+
+    std::vector<std::optional<ChangeRequest>> results;
+    results.reserve(changeIds.size());
+    for (int changeId : changeIds) {
+        auto key = std::lower_bound(keys.begin(), keys.end(), changeId);
+        if (key != keys.end() && *key == changeId)
+            results.push_back(byKey[static_cast<size_t>(key - keys.begin())]);
+        else
+            results.emplace_back();
+    }
+    return results;
+}
+
 /**********************************************
  * Function: closeChangeRequest
  * Description: Closes the file if it is open.
  **********************************************/
 void ChangeRequest::closeChangeRequest() {
+    std::lock_guard<std::mutex> lock(fileMutex);
     if (file.is_open()) {
         file.close();
     }
 }
+
+/**********************************************
+ * Function: releaseChangeRequestIds
+ * Description:
+ * Gives unused reserved change IDs back at shutdown so the next session continues
+ * without a gap. Only takes effect if no other process reserved IDs meanwhile.
+ **********************************************/
+void ChangeRequest::releaseChangeRequestIds() {
+    requestIds.release();
+}
+
+/**********************************************
+ * Function: partitionChangeRequests
+ * Description: Copies every ChangeRequest of the single file into the segment of its
+ *              product inside directory, keeping the file order within each product.
+ * Parameters:
+ * - const std::string& directory: The directory that receives the segments.
+ * Returns: int - The number of ChangeRequests copied, or -1 if a segment could not be written.
+ **********************************************/
+int ChangeRequest::partitionChangeRequests(const std::string& directory) {
+    std::ifstream infile(REQUEST_FILE, std::ios::binary);
+    std::map<std::string, std::ofstream> segments;
+    ChecksumReader checksums(REQUEST_FILE, RECORD_SIZE);
+    char record[RECORD_SIZE];
+    int copied = 0;
+    while (infile.read(record, sizeof(record))) {
+        if (!checksums.check(static_cast<long long>(copied) * RECORD_SIZE, record))
+            return -1; // A damaged record is not spread into a segment
+        std::string product = Schema<ChangeRequest>::read<FIELD_PRODUCT>(record).getProductName();
+        auto segment = segments.find(product);
+        if (segment == segments.end()) {
+            std::string path = StorageLayout::segmentPath(directory, REQUEST_SEGMENT_PREFIX, product);
+            segment = segments.emplace(product, std::ofstream(path, std::ios::binary)).first;
+        }
+        if (!segment->second.write(record, sizeof(record)))
+            return -1;
+        copied++;
+    }
+
+    for (auto& segment : segments) {
+        segment.second.close();
+        std::string path = StorageLayout::segmentPath(directory, REQUEST_SEGMENT_PREFIX, segment.first);
+        if (segment.second.fail() || !RecordChecksum::init(path, RECORD_SIZE) ||
+            !FileFormat::stamp(path, FileFormat::currentLayout(RecordKind::CHANGE_REQUEST).version))
+            return -1;
+    }
+    return copied;
+}
+
+
+/**********************************************
+ * Function: upgradeFormat1
+ * Description: Converts a record of record version 1, the raw struct with its tail
+ *              padding, into a packed record.
+ * Parameters:
+ * - const char* format1: The record of version 1.
+ * - char* record: Receives the packed record.
+ **********************************************/
+void ChangeRequest::upgradeFormat1(const char* format1, char* record) {
+    ChangeRequest changeRequest;
+    std::memcpy(static_cast<void*>(&changeRequest), format1, FORMAT1_RECORD_SIZE);
+    Schema<ChangeRequest>::encode(changeRequest, record);
+}
+
+//================================
+// Accessor Implementations
+//================================
+int ChangeRequest::getChangeId() const { return changeId; }
+std::string ChangeRequest::getRequestedBy() const { return std::string(requestedBy); }
+std::string ChangeRequest::getProductName() const { return productName.getProductName(); }
+std::string ChangeRequest::getDate() const { return std::string(date); }
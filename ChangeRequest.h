@@ -2,6 +2,15 @@
  * ChangeRequest Header File
  * Revision History:
  * - 2024-07-30: Initial version created.
+ * - 2026-10-19: Added accessors for the daemon.
+ * - 2026-10-19: Change IDs are assigned under the append lock.
+ * - 2026-10-19: Change IDs come from the block-reserving IdAllocator.
+ * - 2026-10-19: Added partitionChangeRequests for the partition migration.
+ * - 2026-10-19: Added findChangeRequest and ChangeRequestView access; the constructor takes the product by reference.
+ * - 2026-10-19: Added the record schema and unpadChangeRequests; records are stored packed.
+ * - 2026-10-19: Added getChangeRequests for batched lookups.
+ * - 2026-10-19: createChangeRequest takes the change item the request is about.
+ * - 2026-10-19: Replaced unpadChangeRequests with upgradeFormat1 and FORMAT1_RECORD_SIZE.
  *--------------------------------
  * Purpose: 
  * This module provides a cohesive interface for managing change requests, including initialization, 
@@ -15,8 +24,12 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <optional>
+#include <span>
+#include <tuple>
 #include <vector>
 #include "Product.h"
+#include "RecordSchema.h"
 #include "Requester.h"
 #include "ProductRelease.h"
 
@@ -35,11 +48,11 @@ public:
     // Description: Default constructor for the ChangeRequest class.
 
     //----------------------------------------------------------
-    ChangeRequest(const char* requester, Product product, const char* theDate);
+    ChangeRequest(const char* requester, const Product& product, const char* theDate);
     // Description: Parameterized constructor for creating a new ChangeRequest object.
     // Parameters: 
     // - const char* requester: The name of the requester.
-    // - Product product: The product associated with the change request.
+    // - const Product& product: The product associated with the change request.
     // - const char* theDate: The date the change request was submitted.
 
     //=============================
@@ -58,10 +71,13 @@ public:
     // Returns: bool - True if the file is successfully opened and initialized, false otherwise.
 
     //----------------------------------------------------------
-    static void createChangeRequest(const ChangeRequest& product);
-    // Description: Writes a new ChangeRequest object to the file.
+    static void createChangeRequest(ChangeRequest& changeRequest, int changeItemId = -1);
+    // Description: Assigns the next free change ID to a ChangeRequest and appends it to the file.
+    //              IDs come from a block-reserving allocator and never collide across threads,
+    //              processes or crashes. The change item is published with the request for RequestLinks.
     // Parameters: 
-    // - const ChangeRequest& product: The ChangeRequest object to be written to the file.
+    // - ChangeRequest& changeRequest: The ChangeRequest object to be written to the file; receives its change ID.
+    // - int changeItemId: The change item the request is about, or -1 if it has none.
 
     //----------------------------------------------------------
     static ChangeRequest getChangeRequest(int findChangeId);
@@ -70,16 +86,84 @@ public:
     // - int findChangeId: The change ID of the ChangeRequest to retrieve.
     // Returns: ChangeRequest object if found, otherwise throws an exception.
 
+    //----------------------------------------------------------
+    static bool findChangeRequest(int findChangeId, ChangeRequest& changeRequest);
+    // Description: Reads a ChangeRequest into storage the caller provides, e.g. on its stack.
+    //              Unlike getChangeRequest, a missing ID is not an exception.
+    // Parameters: 
+    // - int findChangeId: The change ID of the ChangeRequest to retrieve.
+    // - ChangeRequest& changeRequest: Receives the record.
+    // Returns: bool - True if the ChangeRequest was found.
+
+    //----------------------------------------------------------
+    static std::vector<std::optional<ChangeRequest>> getChangeRequests(std::span<const int> changeIds);
+    // Description: Looks up many ChangeRequests in one pass over the segments instead of one scan each.
+    // Parameters: 
+    // - std::span<const int> changeIds: The change IDs to retrieve, in any order, repeats allowed.
+    // Returns: One entry per change ID, in the same order; empty where the ID does not exist.
+
     //----------------------------------------------------------
     static void closeChangeRequest();
     // Description: Closes the file if it is open.
 
+    //----------------------------------------------------------
+    static void releaseChangeRequestIds();
+    // Description: Gives unused reserved change IDs back at shutdown so the next session
+    //              continues without a gap.
+
+    //----------------------------------------------------------
+    static int partitionChangeRequests(const std::string& directory);
+    // Description: Copies every ChangeRequest of the single file into the segment of its
+    //              product inside directory. Used when migrating to the partitioned layout.
+    // Returns: int - The number of ChangeRequests copied, or -1 if a segment could not be written.
+
+    //----------------------------------------------------------
+    static void upgradeFormat1(const char* format1, char* record);
+    // Description: Converts a record of record version 1, which kept the struct padding, into
+    //              the packed record of the current version. Registered with FileFormat.
+
+    //=============================
+    // Accessor Declarations
+    //=============================
+    int getChangeId() const;
+    std::string getRequestedBy() const;
+    std::string getProductName() const;
+    std::string getDate() const;
+
+    //=============================
+    // Schema Declarations
+    //=============================
+    enum Field : size_t {            // Stored fields, in file order
+        FIELD_CHANGE_ID,
+        FIELD_REQUESTED_BY,
+        FIELD_PRODUCT,
+        FIELD_RELEASE,
+        FIELD_DATE,
+        FIELD_COUNT
+    };
+
+    static const size_t RECORD_SIZE = 86; // Bytes per record in the file, checked against the schema below
+    static const size_t FORMAT1_RECORD_SIZE = 88; // Bytes per record of record version 1: the struct with its padding
+
 private:
+    friend class ChangeRequestView;
+    friend class Schema<ChangeRequest>;
+    static constexpr auto schemaFields() {
+        return std::make_tuple(SchemaField<&ChangeRequest::changeId>{"changeId"},
+                               SchemaField<&ChangeRequest::requestedBy>{"requestedBy"},
+                               SchemaField<&ChangeRequest::productName>{"product"},
+                               SchemaField<&ChangeRequest::release>{"release"},
+                               SchemaField<&ChangeRequest::date>{"date"});
+    }
+
+    //----------------------------------------------------------
+    static int scanMaxChangeId();
+    // Description: Returns the largest change ID in the file, or -1. Used to recover the ID allocator.
+
     //=============================
     // Private Member Variables
     //=============================
 
-    static int currentChangeIdCount; // Holds the current change request ID count
     int changeId;                    // The change request ID
     char requestedBy[30];            // The name of the requester
     Product productName;             // The product associated with the change request
@@ -87,4 +171,11 @@ private:
     char date[11];                   // The date the change request was submitted
 };
 
+// The struct has two bytes of tail padding, which the file does not store: records
+// always go through Schema<ChangeRequest>::encode and decode. Record version 1
+// stored the struct as it is in memory, padding included.
+static_assert(Schema<ChangeRequest>::COUNT == ChangeRequest::FIELD_COUNT, "ChangeRequest fields and schema disagree");
+static_assert(Schema<ChangeRequest>::SIZE == ChangeRequest::RECORD_SIZE, "ChangeRequest records are 86 bytes in ChangeRequest.txt");
+static_assert(sizeof(ChangeRequest) == ChangeRequest::FORMAT1_RECORD_SIZE, "Record version 1 is the struct as laid out in memory");
+
 #endif // CHANGEREQUEST_H
@@ -0,0 +1,276 @@
+/**********************************************
+ * DaemonProtocol Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added OP_READ_FEED and 64-bit fields.
+ * - 2026-10-19: Added OP_REPLICA_STATUS, OP_PROMOTE and STATUS_READ_ONLY.
+ * - 2026-10-19: WireWriter takes string views and can patch a count.
+ * - 2026-10-19: Added OP_GET_ITEMS.
+ * - 2026-10-19: Added OP_TAKE_WORK, OP_RENEW_LEASE and OP_FINISH_LEASE.
+ * - 2026-10-19: OP_CREATE_ITEM and OP_CREATE_REQUEST answer STATUS_NOT_FOUND for an unknown product, release or requester.
+ * - 2026-10-19: Documented the OP_CREATE_RELEASE statuses and the date form of the create operations.
+ *--------------------------------
+ * Purpose:
+ * This module defines the binary protocol spoken between the tracker daemon and
+ * its clients. Every message is a frame made of a 4-byte little-endian body length
+ * followed by the body. A request body starts with a one-byte opcode and a response
+ * body with a one-byte status. Integers are little-endian and strings are a one-byte
+ * length followed by the characters, which is enough for every fixed-width field
+ * the entity files store.
+ *
+ * Opcode             Request fields                                   Response payload
+ * OP_PING            -                                                -
+ * OP_CREATE_ITEM     product, description, state, priority, date,     changeId
+ *                    releaseId
+ * OP_GET_ITEM        changeId                                         item
+ * OP_UPDATE_STATE    changeId, state                                  -
+ * OP_UPDATE_PRIORITY changeId, priority                               -
+ * OP_LIST_ITEMS      product                                          count, items
+ * OP_REPORT          product                                          four per-state counts
+ * OP_CREATE_REQUEST  requester, product, date                         changeId
+ * OP_GET_REQUEST     changeId                                         requester, product, date
+ * OP_CREATE_RELEASE  product, releaseId, date                         -
+ * OP_GET_RELEASE     releaseId                                        product, releaseId, date
+ * OP_READ_FEED       fromSequence, entity, product, state, maxEvents  nextSequence, count, events
+ * OP_REPLICA_STATUS  -                                                role, applied, primaryEnd, lagMs
+ * OP_PROMOTE         -                                                -
+ * OP_GET_ITEMS       count, changeIds                                 count, (found, [item]) per ID
+ * OP_TAKE_WORK       product, holder, seconds                         version, expires, item
+ * OP_RENEW_LEASE     changeId, version, seconds                       expires
+ * OP_FINISH_LEASE    changeId, version, state                         -
+ *
+ * In OP_READ_FEED a filter field of 255 (or an empty product) matches everything,
+ * and sequence numbers are 64-bit. A follower answers every write with
+ * STATUS_READ_ONLY until it is promoted; OP_PROMOTE on a primary is a bad request.
+ * OP_GET_ITEMS answers in the order of the request, with found 0 and no item for a
+ * change ID that does not exist; at most MAX_BATCH_IDS IDs are accepted.
+ * OP_TAKE_WORK leases the best ASSESSED item of the product (any product if empty)
+ * and answers STATUS_NOT_FOUND if none is waiting; version identifies the lease in
+ * the two lease operations, which answer STATUS_CONFLICT once the lease is lost.
+ * OP_CREATE_ITEM answers STATUS_NOT_FOUND if the product, or the product's release
+ * when one is given, does not exist, OP_CREATE_REQUEST if the requester or the
+ * product does not, and OP_CREATE_RELEASE if the product does not; a release that
+ * exists already is STATUS_CONFLICT. The three create operations take dates as
+ * YYYY-MM-DD and answer STATUS_BAD_REQUEST for any other form.
+ **********************************************/
+#ifndef DAEMONPROTOCOL_H
+#define DAEMONPROTOCOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+//=============================
+// Constants
+//=============================
+const uint32_t MAX_FRAME_LENGTH = 16 * 1024 * 1024; // Larger frames are treated as a protocol error
+const uint32_t MAX_BATCH_IDS = 4096;                // Change IDs one OP_GET_ITEMS may ask for
+
+enum Opcode : uint8_t {
+    OP_PING,
+    OP_CREATE_ITEM,
+    OP_GET_ITEM,
+    OP_UPDATE_STATE,
+    OP_UPDATE_PRIORITY,
+    OP_LIST_ITEMS,
+    OP_REPORT,
+    OP_CREATE_REQUEST,
+    OP_GET_REQUEST,
+    OP_CREATE_RELEASE,
+    OP_GET_RELEASE,
+    OP_READ_FEED,
+    OP_REPLICA_STATUS,
+    OP_PROMOTE,
+    OP_GET_ITEMS,
+    OP_TAKE_WORK,
+    OP_RENEW_LEASE,
+    OP_FINISH_LEASE
+};
+
+enum Status : uint8_t {
+    STATUS_OK,
+    STATUS_NOT_FOUND,
+    STATUS_CONFLICT,
+    STATUS_BAD_REQUEST,
+    STATUS_ERROR,
+    STATUS_READ_ONLY
+};
+
+enum ReplicaRole : uint8_t {
+    REPLICA_ROLE_PRIMARY,
+    REPLICA_ROLE_FOLLOWER
+};
+
+//=============================
+// Record Types
+//=============================
+
+// A ChangeItem as it travels over the wire.
+struct ItemRecord {
+    int32_t changeId = 0;
+    std::string product;
+    std::string description;
+    std::string date;
+    std::string releaseId;
+    uint8_t priority = 0;
+    uint8_t state = 0;
+};
+
+// A change feed event as it travels over the wire. Unset values are 255.
+struct FeedRecord {
+    uint64_t sequence = 0;
+    uint64_t timestamp = 0;
+    int32_t changeId = -1;
+    uint8_t entity = 0;
+    uint8_t kind = 0;
+    uint8_t state = 255;
+    uint8_t priority = 255;
+    uint8_t previous = 255;
+    std::string product;
+    std::string key;
+};
+
+const uint8_t ANY_FILTER = 255; // Filter value that matches every event
+
+//=============================
+// Encoding Helpers
+//=============================
+
+// Appends protocol fields to a buffer.
+struct WireWriter {
+    std::string buffer;
+
+    void u8(uint8_t value) { buffer.push_back(static_cast<char>(value)); }
+
+    void u32(uint32_t value) {
+        for (int i = 0; i < 4; i++)
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+
+    void u64(uint64_t value) {
+        u32(static_cast<uint32_t>(value));
+        u32(static_cast<uint32_t>(value >> 32));
+    }
+
+    // Overwrites a u32 written earlier, e.g. a count only known once the items are written.
+    void u32At(size_t position, uint32_t value) {
+        for (int i = 0; i < 4; i++)
+            buffer[position + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+
+    void str(std::string_view value) {
+        size_t length = value.size() > 255 ? 255 : value.size();
+        u8(static_cast<uint8_t>(length));
+        buffer.append(value.data(), length);
+    }
+
+    void item(const ItemRecord& record) {
+        i32(record.changeId);
+        str(record.product);
+        str(record.description);
+        str(record.date);
+        str(record.releaseId);
+        u8(record.priority);
+        u8(record.state);
+    }
+
+    void feedEvent(const FeedRecord& record) {
+        u64(record.sequence);
+        u64(record.timestamp);
+        i32(record.changeId);
+        u8(record.entity);
+        u8(record.kind);
+        u8(record.state);
+        u8(record.priority);
+        u8(record.previous);
+        str(record.product);
+        str(record.key);
+    }
+
+    // Prefixes the buffer with its length, turning it into a complete frame.
+    std::string frame() const {
+        WireWriter header;
+        header.u32(static_cast<uint32_t>(buffer.size()));
+        return header.buffer + buffer;
+    }
+};
+
+// Reads protocol fields from a frame body. Reading past the end clears ok
+// and yields zero values, so callers check ok once after decoding.
+struct WireReader {
+    const char* position;
+    const char* end;
+    bool ok;
+
+    WireReader(const char* data, size_t length) : position(data), end(data + length), ok(true) {}
+
+    uint8_t u8() {
+        if (end - position < 1) {
+            ok = false;
+            return 0;
+        }
+        return static_cast<uint8_t>(*position++);
+    }
+
+    uint32_t u32() {
+        if (end - position < 4) {
+            ok = false;
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(position[i])) << (8 * i);
+        position += 4;
+        return value;
+    }
+
+    int32_t i32() { return static_cast<int32_t>(u32()); }
+
+    uint64_t u64() {
+        uint64_t low = u32();
+        return low | static_cast<uint64_t>(u32()) << 32;
+    }
+
+    std::string str() {
+        uint8_t length = u8();
+        if (end - position < length) {
+            ok = false;
+            return std::string();
+        }
+        std::string value(position, length);
+        position += length;
+        return value;
+    }
+
+    ItemRecord item() {
+        ItemRecord record;
+        record.changeId = i32();
+        record.product = str();
+        record.description = str();
+        record.date = str();
+        record.releaseId = str();
+        record.priority = u8();
+        record.state = u8();
+        return record;
+    }
+
+    FeedRecord feedEvent() {
+        FeedRecord record;
+        record.sequence = u64();
+        record.timestamp = u64();
+        record.changeId = i32();
+        record.entity = u8();
+        record.kind = u8();
+        record.state = u8();
+        record.priority = u8();
+        record.previous = u8();
+        record.product = str();
+        record.key = str();
+        return record;
+    }
+};
+
+#endif // DAEMONPROTOCOL_H
@@ -0,0 +1,675 @@
+/**********************************************
+ * FileFormat Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Headers carry a rewrite generation; archives are dated by the directory above them.
+ * - 2026-10-19: upgrade leaves archives, which are block files, to ItemArchive.
+ * - 2026-10-19: <unistd.h> is included only off Windows, which takes getpid from <process.h>.
+ *--------------------------------
+ * Purpose:
+ * This module implements the file headers, the registry of record versions and
+ * the upgrade of data files. The registry lists every version of every kind of
+ * record with its size, the Records.format version it was first written under
+ * (which dates a file without a header), and the converter from the version
+ * before it; a record several versions behind goes through each converter in
+ * turn. Adding a record version means adding one entry and one converter.
+ *
+ * Readers of a file older than the current version hold a shared lock on its
+ * format sentinel, and an upgrade takes it exclusively for the copy back, so a
+ * reader sees the file entirely in one version or the other. An upgrade takes
+ * the lock of every record and the append sentinel first, like any writer of
+ * the whole file, and only then the format sentinel.
+ **********************************************/
+#include "FileFormat.h"
+#include "ChangeItem.h"
+#include "ChangeRequest.h"
+#include "ProductRelease.h"
+#include "RecordChecksum.h"
+#include "StorageLayout.h"
+#include "product.h"
+#include "requester.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+//================================
+// Constants
+//================================
+static const char HEADER_MAGIC[4] = {'I', 'T', 'R', 'K'};
+static const uint16_t HEADER_VERSION = 1;                 // Layout of the header itself
+static const char* UPGRADE_SUFFIX = ".upgrade";           // The converted copy of a data file, complete once it has this name
+static const size_t UPGRADE_CHUNK_RECORDS = 4096;         // Records converted or copied back per step
+
+// A data file header, as stored.
+struct FileHeader {
+    char magic[4];
+    uint16_t headerVersion;
+    uint16_t kind;
+    uint16_t recordVersion;
+    uint16_t generation;        // Bumped whenever records are rewritten other than by appending or updating in place
+    uint32_t recordSize;
+};
+static_assert(sizeof(FileHeader) == 16, "File headers are 16 bytes");
+
+// One version of one kind of record.
+struct RecordVersion {
+    RecordKind kind;
+    int version;
+    size_t size;                                          // Bytes per stored record
+    int sinceFormat;                                      // The Records.format version it was first written under
+    void (*fromPrevious)(const char* previous, char* record);  // Converts a record of the version before; none for the first
+};
+
+// Every record version ever written, oldest first within each kind. The last
+// version of a kind is the one written.
+static constexpr RecordVersion VERSIONS[] = {
+    {RecordKind::CHANGE_ITEM, 1, Schema<ChangeItem>::SIZE, 0, nullptr},
+    {RecordKind::CHANGE_REQUEST, 1, ChangeRequest::FORMAT1_RECORD_SIZE, 0, nullptr},
+    {RecordKind::CHANGE_REQUEST, 2, Schema<ChangeRequest>::SIZE, 2, ChangeRequest::upgradeFormat1},
+    {RecordKind::PRODUCT, 1, Schema<Product>::SIZE, 0, nullptr},
+    {RecordKind::PRODUCT_RELEASE, 1, Schema<ProductRelease>::SIZE, 0, nullptr},
+    {RecordKind::REQUESTER, 1, Schema<Requester>::SIZE, 0, nullptr},
+};
+static_assert([] {
+    for (const RecordVersion& version : VERSIONS)
+        if (version.size > MAX_RECORD_SIZE)
+            return false;
+    return true;
+}(), "MAX_RECORD_SIZE is smaller than a record");
+
+static std::mutex currentMutex;
+static std::unordered_set<std::string> currentFiles;      // Data files known to be in the current version
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: findVersion
+ * Description: Looks up one version of a kind of record in the registry.
+ * Returns: const RecordVersion* - The version, or nullptr if there is none.
+ **********************************************/
+static const RecordVersion* findVersion(RecordKind kind, int version) {
+    for (const RecordVersion& entry : VERSIONS) {
+        if (entry.kind == kind && entry.version == version)
+            return &entry;
+    }
+    return nullptr;
+}
+
+/**********************************************
+ * Function: latestVersion
+ * Description: Finds the newest version of a kind of record written under a
+ *              Records.format version.
+ * Parameters:
+ * - kind: The kind of record
+ * - format: The Records.format version, or INT_MAX for the version written now
+ * Returns: const RecordVersion* - The version, or nullptr for an unknown kind.
+ **********************************************/
+static const RecordVersion* latestVersion(RecordKind kind, int format) {
+    const RecordVersion* latest = nullptr;
+    for (const RecordVersion& entry : VERSIONS) {
+        if (entry.kind == kind && entry.sinceFormat <= format)
+            latest = &entry;
+    }
+    return latest;
+}
+
+/**********************************************
+ * Function: describe
+ * Description: Builds the layout of a file stored in a version.
+ **********************************************/
+static RecordLayout describe(const RecordVersion& version, bool stamped) {
+    RecordLayout layout;
+    layout.kind = version.kind;
+    layout.version = version.version;
+    layout.size = version.size;
+    layout.current = &version == latestVersion(version.kind, INT_MAX);
+    layout.stamped = stamped;
+    return layout;
+}
+
+/**********************************************
+ * Function: isKnownCurrent / rememberCurrent
+ * Description: Look up and add a data file in the set of files known to be current.
+ **********************************************/
+static bool isKnownCurrent(const std::string& dataPath) {
+    std::lock_guard<std::mutex> lock(currentMutex);
+    return currentFiles.count(dataPath) > 0;
+}
+
+static void rememberCurrent(const std::string& dataPath) {
+    std::lock_guard<std::mutex> lock(currentMutex);
+    currentFiles.insert(dataPath);
+}
+
+/**********************************************
+ * Function: directoryFormat
+ * Description: Reads the Records.format version of the data directory holding a
+ *              data file; segments and archives are one level further down, and
+ *              the archives of segments two.
+ * Returns: int - The version, or 0 if Records.format is missing.
+ **********************************************/
+static int directoryFormat(const std::string& dataPath) {
+    std::filesystem::path directory = std::filesystem::path(dataPath).parent_path();
+    if (directory.filename() == ARCHIVE_DIRECTORY)
+        directory = directory.parent_path();
+    if (directory.filename() == PARTITION_DIRECTORY)
+        directory = directory.parent_path();
+    std::ifstream format(directory / FORMAT_FILE);
+    int version = 0;
+    if (format >> version)
+        return version;
+    return 0;
+}
+
+/**********************************************
+ * Function: readLayout
+ * Description: Reads the layout of a data file from its header, or dates a file
+ *              without one: an empty file is current, and any other is in the
+ *              newest version written under the directory's Records.format.
+ * Returns: RecordLayout - The layout; version 0 for a header it cannot read.
+ **********************************************/
+static RecordLayout readLayout(const std::string& dataPath) {
+    RecordLayout unknown;
+    unknown.kind = FileFormat::kindOf(dataPath);
+    if (unknown.kind == RecordKind::UNKNOWN)
+        return unknown;
+
+    std::ifstream headerFile(FileFormat::headerPath(dataPath), std::ios::binary);
+    if (headerFile.is_open()) {
+        FileHeader header;
+        unknown.stamped = true;
+        if (!headerFile.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0 || header.headerVersion != HEADER_VERSION ||
+            header.kind != static_cast<uint16_t>(unknown.kind))
+            return unknown;
+        const RecordVersion* version = findVersion(unknown.kind, header.recordVersion);
+        if (version == nullptr || version->size != header.recordSize)
+            return unknown; // Written by a newer program
+        return describe(*version, true);
+    }
+
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(dataPath, error);
+    int format = error || size == 0 ? INT_MAX : directoryFormat(dataPath);
+    return describe(*latestVersion(unknown.kind, format), false);
+}
+
+/**********************************************
+ * Function: convertFile
+ * Description: Writes every whole record of an old data file, in the current
+ *              version, to a new file. Needs no record lock, since an old file is
+ *              never written. Paced to a rate if one is given.
+ * Parameters:
+ * - dataPath: The data file
+ * - from: Its layout
+ * - size: Its size in bytes
+ * - target: The file to write
+ * - megabytesPerSecond: The rate limit, or 0
+ * Returns: long long - The number of records written, or -1 on failure.
+ **********************************************/
+static long long convertFile(const std::string& dataPath, const RecordLayout& from, long long size, const std::string& target,
+                             double megabytesPerSecond) {
+    std::ifstream infile(dataPath, std::ios::binary);
+    std::ofstream outfile(target, std::ios::binary | std::ios::trunc);
+    if (!infile.is_open() || !outfile.is_open())
+        return -1;
+
+    size_t currentSize = FileFormat::currentLayout(from.kind).size;
+    ChecksumReader checksums(dataPath, from.size);
+    std::vector<char> stored(UPGRADE_CHUNK_RECORDS * from.size);
+    std::vector<char> converted(UPGRADE_CHUNK_RECORDS * currentSize);
+    char buffer[MAX_RECORD_SIZE];
+    long long records = size / static_cast<long long>(from.size);
+    auto start = std::chrono::steady_clock::now();
+    for (long long done = 0; done < records;) {
+        size_t count = static_cast<size_t>(std::min<long long>(records - done, UPGRADE_CHUNK_RECORDS));
+        if (!infile.read(stored.data(), static_cast<std::streamsize>(count * from.size)))
+            return -1;
+        for (size_t i = 0; i < count; i++) {
+            char* record = stored.data() + i * from.size;
+            if (!checksums.check((done + static_cast<long long>(i)) * static_cast<long long>(from.size), record))
+                return -1; // A damaged record is not carried into the new version
+            std::memcpy(converted.data() + i * currentSize, FileFormat::convert(from, record, buffer), currentSize);
+        }
+        if (!outfile.write(converted.data(), static_cast<std::streamsize>(count * currentSize)))
+            return -1;
+        done += static_cast<long long>(count);
+        if (megabytesPerSecond > 0) // Paced so the bytes read so far never run ahead of the rate
+            std::this_thread::sleep_until(start + std::chrono::duration<double>(static_cast<double>(done * static_cast<long long>(from.size)) /
+                                                                                (megabytesPerSecond * 1048576.0)));
+    }
+    outfile.close();
+    return outfile.fail() ? -1 : records;
+}
+
+/**********************************************
+ * Function: copyBack
+ * Description:
+ * Replaces the contents of a data file with its converted copy, in place, so the
+ * record locks held on the file stay on it, and records the checksums of the
+ * converted records as they go in. The header is written last; until then the
+ * copy is kept, and an upgrade cut short is finished from it. Called with every
+ * record, the append sentinel and the format sentinel of the file locked.
+ * Parameters:
+ * - dataPath: The data file
+ * - converted: Its complete converted copy
+ * Returns: long long - The number of records copied back, or -1 on failure.
+ **********************************************/
+static long long copyBack(const std::string& dataPath, const std::string& converted) {
+    RecordLayout current = FileFormat::currentLayout(FileFormat::kindOf(dataPath));
+    std::ifstream infile(converted, std::ios::binary);
+    if (!infile.is_open())
+        return -1;
+    RecordChecksum::truncate(dataPath, current.size, 0); // The checksums of the old records
+    std::ofstream outfile(dataPath, std::ios::binary | std::ios::trunc);
+    std::vector<char> chunk(UPGRADE_CHUNK_RECORDS * current.size);
+    long long offset = 0;
+    while (infile.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || infile.gcount() > 0) {
+        size_t count = static_cast<size_t>(infile.gcount()) / current.size;
+        if (count == 0 || !outfile.write(chunk.data(), static_cast<std::streamsize>(count * current.size)))
+            break;
+        RecordChecksum::store(dataPath, current.size, offset, chunk.data(), count);
+        offset += static_cast<long long>(count * current.size);
+    }
+    outfile.close();
+    if (outfile.fail() || !FileFormat::stamp(dataPath, current.version)) {
+        std::cerr << "Failed to upgrade " << dataPath << "; it is finished from " << converted << " when next needed." << std::endl;
+        return -1;
+    }
+    std::error_code error;
+    std::filesystem::remove(converted, error);
+    return offset / static_cast<long long>(current.size);
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: kindOf
+ * Description: Tells the kind of record from the name of a data file: the five
+ *              single files and the segments of both partitioned entities.
+ * Parameters:
+ * - dataPath: The data file
+ * Returns: RecordKind - UNKNOWN for a file that is not a data file.
+ **********************************************/
+RecordKind FileFormat::kindOf(const std::string& dataPath) {
+    std::string name = std::filesystem::path(dataPath).filename().string();
+    std::string itemPrefix = std::string(ITEM_SEGMENT_PREFIX) + "-";
+    std::string requestPrefix = std::string(REQUEST_SEGMENT_PREFIX) + "-";
+    if (name == ITEM_FILE || name.compare(0, itemPrefix.size(), itemPrefix) == 0)
+        return RecordKind::CHANGE_ITEM;
+    if (name == REQUEST_FILE || name.compare(0, requestPrefix.size(), requestPrefix) == 0)
+        return RecordKind::CHANGE_REQUEST;
+    if (name == "Product.txt")
+        return RecordKind::PRODUCT;
+    if (name == "ProductRelease.txt")
+        return RecordKind::PRODUCT_RELEASE;
+    if (name == "req.txt")
+        return RecordKind::REQUESTER;
+    return RecordKind::UNKNOWN;
+}
+
+/**********************************************
+ * Function: headerPath
+ * Description: Names the header file of a data file: the data file with its
+ *              extension replaced, e.g. "partitions/ChangeItem-^alpha.hdr".
+ **********************************************/
+std::string FileFormat::headerPath(const std::string& dataPath) {
+    return std::filesystem::path(dataPath).replace_extension(HEADER_EXTENSION).string();
+}
+
+/**********************************************
+ * Function: currentLayout
+ * Description: Returns the layout records of a kind are written in.
+ **********************************************/
+RecordLayout FileFormat::currentLayout(RecordKind kind) {
+    const RecordVersion* latest = latestVersion(kind, INT_MAX);
+    return latest != nullptr ? describe(*latest, true) : RecordLayout();
+}
+
+/**********************************************
+ * Function: layout
+ * Description: Returns the layout of a data file. A file once found current stays
+ *              current, since only this version is written from then on, so it
+ *              is answered from memory afterwards.
+ * Parameters:
+ * - dataPath: The data file
+ **********************************************/
+RecordLayout FileFormat::layout(const std::string& dataPath) {
+    if (isKnownCurrent(dataPath))
+        return currentLayout(kindOf(dataPath));
+    RecordLayout found = readLayout(dataPath);
+    if (found.current && found.stamped)
+        rememberCurrent(dataPath);
+    return found;
+}
+
+/**********************************************
+ * Function: convert
+ * Description: Runs a stored record through the converters of every version
+ *              after its own.
+ * Parameters:
+ * - from: The layout the record is stored in
+ * - stored: The stored record
+ * - buffer: Receives the converted record
+ * Returns: const char* - The record in the current version
+ **********************************************/
+const char* FileFormat::convert(const RecordLayout& from, const char* stored, char* buffer) {
+    if (from.current)
+        return stored;
+    char steps[2][MAX_RECORD_SIZE];
+    const char* record = stored;
+    int step = 0;
+    for (const RecordVersion* next = findVersion(from.kind, from.version + 1); next != nullptr;
+         next = findVersion(from.kind, next->version + 1)) {
+        next->fromPrevious(record, steps[step]);
+        record = steps[step];
+        step ^= 1;
+    }
+    std::memcpy(buffer, record, currentLayout(from.kind).size);
+    return buffer;
+}
+
+/**********************************************
+ * Function: stamp
+ * Description: Writes the header of a data file in one rename, so it is never
+ *              seen half written.
+ * Parameters:
+ * - dataPath: The data file
+ * - version: The record version of its records
+ * - generation: The rewrite generation of its records
+ * Returns: bool - False if the header could not be written
+ **********************************************/
+bool FileFormat::stamp(const std::string& dataPath, int version, int generation) {
+    RecordKind kind = kindOf(dataPath);
+    const RecordVersion* entry = findVersion(kind, version);
+    if (entry == nullptr)
+        return false;
+
+    FileHeader header{};
+    std::memcpy(header.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+    header.headerVersion = HEADER_VERSION;
+    header.kind = static_cast<uint16_t>(kind);
+    header.recordVersion = static_cast<uint16_t>(version);
+    header.generation = static_cast<uint16_t>(generation);
+    header.recordSize = static_cast<uint32_t>(entry->size);
+
+    std::string target = headerPath(dataPath);
+    std::string temporary = target + "." + std::to_string(::getpid()) + ".tmp"; // Processes stamping one file at once each write their own
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        if (file.fail())
+            return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, target, error);
+    if (error)
+        return false;
+    std::lock_guard<std::mutex> lock(currentMutex);
+    if (describe(*entry, true).current)
+        currentFiles.insert(dataPath);
+    else
+        currentFiles.erase(dataPath); // A replica restarting a copy in the primary's version
+    return true;
+}
+
+/**********************************************
+ * Function: generation
+ * Description: Reads the rewrite generation from the header of a data file. Always
+ *              reads the header, since the generation changes while a file stays current.
+ * Parameters:
+ * - dataPath: The data file
+ * Returns: int - The generation, or 0 for a file without a readable header
+ **********************************************/
+int FileFormat::generation(const std::string& dataPath) {
+    std::ifstream headerFile(headerPath(dataPath), std::ios::binary);
+    FileHeader header;
+    if (!headerFile.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0 || header.headerVersion != HEADER_VERSION)
+        return 0;
+    return header.generation;
+}
+
+/**********************************************
+ * Function: ensureCurrent
+ * Description: Gives a data file a header if it has none, and upgrades it if it is
+ *              in an older version. Answered from memory once the file is known
+ *              to be current.
+ * Parameters:
+ * - dataPath: The data file about to be written
+ * Returns: bool - False if the file cannot be written by this program
+ **********************************************/
+bool FileFormat::ensureCurrent(const std::string& dataPath) {
+    if (isKnownCurrent(dataPath))
+        return true;
+    RecordLayout found = readLayout(dataPath);
+    if (found.current) {
+        if (!found.stamped && !stamp(dataPath, found.version))
+            std::cerr << "Failed to write the header of " << dataPath << "." << std::endl;
+        rememberCurrent(dataPath);
+        return true;
+    }
+    if (!found.known()) {
+        std::cerr << dataPath << " was written by a newer version of the tracker and is left alone." << std::endl;
+        return false;
+    }
+    return upgrade(dataPath, 0) >= 0;
+}
+
+/**********************************************
+ * Function: upgrade
+ * Description:
+ * Converts an old data file into a private copy, holding only the format sentinel
+ * shared like a reader, since old files never change. Then locks the file like a
+ * writer of every record, and
+ * its format sentinel, which waits for the readers of the old version to finish.
+ * If the file is still as it was, the copy is renamed to "<file>.upgrade", which
+ * marks it complete, and copied back. A complete copy found at the start is from
+ * an upgrade cut short during the copy back, which is finished first. Archives
+ * are block files, which ItemArchive rewrites whole at startup instead.
+ * Parameters:
+ * - dataPath: The data file
+ * - megabytesPerSecond: The rate limit for reading the old records, or 0
+ * Returns: long long - The records rewritten, 0 if the file was current, -1 on failure
+ **********************************************/
+long long FileFormat::upgrade(const std::string& dataPath, double megabytesPerSecond) {
+    if (StorageLayout::isArchive(dataPath)) {
+        std::cerr << dataPath << " is a block file; ItemArchive rewrites it in the current version at the next start." << std::endl;
+        return -1;
+    }
+    std::string finished = dataPath + UPGRADE_SUFFIX;
+    for (;;) {
+        std::error_code error;
+        if (std::filesystem::exists(finished, error)) {
+            RecordLock fileLock(dataPath.c_str(), 0, APPEND_LOCK_OFFSET + 1, true);
+            RecordLock formatLock(dataPath.c_str(), FORMAT_LOCK_OFFSET, 1, true);
+            if (!std::filesystem::exists(finished, error))
+                continue; // Finished by another process while this one waited
+            if (readLayout(dataPath).current) {
+                std::filesystem::remove(finished, error); // Left over after the header was written
+                continue;
+            }
+            return copyBack(dataPath, finished);
+        }
+
+        RecordLayout from = readLayout(dataPath);
+        if (!from.known())
+            return -1;
+        if (from.current) {
+            if (!from.stamped && !stamp(dataPath, from.version))
+                return -1;
+            rememberCurrent(dataPath);
+            return 0;
+        }
+
+        std::string converted = finished + "." + std::to_string(::getpid()) + ".tmp";
+        uintmax_t size;
+        long long records;
+        {
+            // Read like any reader of the old version, so another upgrade cannot copy back meanwhile
+            RecordLock pin(dataPath.c_str(), FORMAT_LOCK_OFFSET, 1, false);
+            if (readLayout(dataPath).version != from.version)
+                continue;
+            size = std::filesystem::file_size(dataPath, error);
+            if (error)
+                return -1;
+            records = convertFile(dataPath, from, static_cast<long long>(size), converted, megabytesPerSecond);
+        }
+        if (records < 0) {
+            std::cerr << "Failed to convert " << dataPath << "; it stays in record version " << from.version << "." << std::endl;
+            std::filesystem::remove(converted, error);
+            return -1;
+        }
+
+        RecordLock fileLock(dataPath.c_str(), 0, APPEND_LOCK_OFFSET + 1, true);
+        RecordLock formatLock(dataPath.c_str(), FORMAT_LOCK_OFFSET, 1, true);
+        uintmax_t sizeNow = std::filesystem::file_size(dataPath, error);
+        if (readLayout(dataPath).version != from.version || sizeNow != size || std::filesystem::exists(finished, error)) {
+            std::filesystem::remove(converted, error); // Upgraded by another process meanwhile
+            continue;
+        }
+        std::filesystem::rename(converted, finished, error);
+        if (error) {
+            std::filesystem::remove(converted, error);
+            return -1;
+        }
+        return copyBack(dataPath, finished) < 0 ? -1 : records;
+    }
+}
+
+/**********************************************
+ * Function: rewrite
+ * Description: Upgrades the data files that are not current, one at a time, each at
+ *              the given rate, and prints a line per file upgraded.
+ * Parameters:
+ * - dataPaths: The data files
+ * - megabytesPerSecond: The rate limit, or 0
+ * - out: Where the progress is printed
+ * Returns: int - 0 if every file is current afterwards, 1 otherwise
+ **********************************************/
+int FileFormat::rewrite(const std::vector<std::string>& dataPaths, double megabytesPerSecond, std::ostream& out) {
+    int upgraded = 0, current = 0, failed = 0;
+    for (const std::string& path : dataPaths) {
+        RecordLayout from = layout(path);
+        if (!from.known()) {
+            out << path << ": written by a newer version of the tracker; left alone" << '\n';
+            failed++;
+            continue;
+        }
+        if (from.current) {
+            if (!from.stamped)
+                stamp(path, from.version);
+            current++;
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        long long records = upgrade(path, megabytesPerSecond);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (records < 0) {
+            out << path << ": could not be upgraded; left in record version " << from.version << '\n';
+            failed++;
+        } else if (records == 0) {
+            current++;      // Upgraded meanwhile by a writer, or empty
+        } else {
+            out << path << ": " << records << " records from record version " << from.version << " to "
+                << currentLayout(from.kind).version << " in " << std::fixed << std::setprecision(2) << seconds << " s"
+                << std::defaultfloat << '\n';
+            upgraded++;
+        }
+    }
+    out << "Upgraded " << upgraded << (upgraded == 1 ? " file; " : " files; ") << current << " already current";
+    if (failed > 0)
+        out << ", " << failed << " left as they were";
+    out << "." << std::endl;
+    return failed > 0 ? 1 : 0;
+}
+
+/**********************************************
+ * Constructor: VersionedReader
+ * Description: Finds the layout of a data file. If it is older than the current
+ *              version, finishes an upgrade of it cut short, then holds off new
+ *              upgrades and reads the layout again, since one may have finished
+ *              while this reader waited.
+ * Parameters:
+ * - dataPath: The data file
+ **********************************************/
+VersionedReader::VersionedReader(const std::string& dataPath) : recordLayout(FileFormat::layout(dataPath)) {
+    if (recordLayout.current || !recordLayout.known())
+        return;
+    std::error_code error;
+    if (std::filesystem::exists(dataPath + UPGRADE_SUFFIX, error))
+        FileFormat::upgrade(dataPath, 0); // The file may be half copied back
+    pin.emplace(dataPath.c_str(), FORMAT_LOCK_OFFSET, 1, false);
+    recordLayout = FileFormat::layout(dataPath);
+    if (recordLayout.current)
+        pin.reset();
+}
+
+/**********************************************
+ * Function: layout / usable / storedSize
+ * Description: Describe the file being read.
+ **********************************************/
+const RecordLayout& VersionedReader::layout() const {
+    return recordLayout;
+}
+
+bool VersionedReader::usable() const {
+    return recordLayout.known();
+}
+
+size_t VersionedReader::storedSize() const {
+    return recordLayout.size;
+}
+
+/**********************************************
+ * Function: current
+ * Description: Brings one stored record of the file up to the current version.
+ **********************************************/
+const char* VersionedReader::current(const char* stored, char* buffer) const {
+    return FileFormat::convert(recordLayout, stored, buffer);
+}
+
+/**********************************************
+ * Function: read
+ * Description: Reads up to count records; records of a current file are read
+ *              straight into records, others are converted one by one.
+ * Parameters:
+ * - in: The file, positioned at a record
+ * - records: Receives count records of the current size
+ * - count: The number of records wanted
+ * Returns: size_t - The number of whole records read
+ **********************************************/
+size_t VersionedReader::read(std::istream& in, char* records, size_t count) {
+    if (recordLayout.current) {
+        in.read(records, static_cast<std::streamsize>(count * recordLayout.size));
+        return static_cast<size_t>(in.gcount()) / recordLayout.size;
+    }
+    size_t currentSize = FileFormat::currentLayout(recordLayout.kind).size;
+    stored.resize(count * recordLayout.size);
+    in.read(stored.data(), static_cast<std::streamsize>(stored.size()));
+    size_t read = static_cast<size_t>(in.gcount()) / recordLayout.size;
+    char buffer[MAX_RECORD_SIZE];
+    for (size_t i = 0; i < read; i++)
+        std::memcpy(records + i * currentSize, current(stored.data() + i * recordLayout.size, buffer), currentSize);
+    return read;
+}
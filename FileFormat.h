@@ -0,0 +1,204 @@
+/**********************************************
+ * FileFormat Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Headers carry a rewrite generation; added generation.
+ *--------------------------------
+ * Purpose:
+ * This module versions the record format of every data file, so a field can be
+ * added or resized without rewriting a data directory before the tracker starts.
+ * Each data file has a 16-byte header file next to it ("ChangeRequest.txt" has
+ * "ChangeRequest.hdr") holding a magic number, the kind of record and the record
+ * version the file is written in, and a generation bumped whenever records are
+ * moved within it. The header is kept apart because every reader
+ * finds record n at n times the record size; a header inside the file would move
+ * every record. A file without a header is one written before headers were kept,
+ * and its version is told from the data directory's Records.format.
+ *
+ * Every record version this program has ever written stays readable: each version
+ * after the first comes with a converter from the one before it, and readers go
+ * through a VersionedReader, which hands them records in the current format
+ * whatever version the file holds. Files are brought up to date lazily. A file
+ * older than the current version is never written in place: the first write to
+ * it rewrites the whole file in the current version (upgrade-on-write), and the
+ * rewriter brings all remaining files up to date in the background at a limited
+ * rate. Records cannot be upgraded one at a time, since records of different
+ * sizes cannot share a fixed-size slot, so a file (one product's segment, once
+ * partitioned) is the unit of an upgrade. Since old files never change, reading
+ * them needs no record locks.
+ *
+ * An upgrade converts the file into a copy without locking any record, then, with
+ * writers and readers of the old version shut out, copies the converted records
+ * back into the same file and records the new version in the header last. The
+ * data file itself is never replaced, because the record locks of every process
+ * are held on it. An upgrade cut short is finished from the copy by the next
+ * process that needs the file.
+ **********************************************/
+#ifndef FILEFORMAT_H
+#define FILEFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <istream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "FileLock.h"
+
+//=============================
+// Constants
+//=============================
+const char* const HEADER_EXTENSION = ".hdr";                // Replaces ".txt" in the name of the data file
+const long long FORMAT_LOCK_OFFSET = 0x7FFFFFFF00000005LL;  // Data file sentinel: shared while reading an old version, exclusive while upgrading
+const size_t MAX_RECORD_SIZE = 256;                          // Bytes of the largest record of any version
+
+//=============================
+// Record Types
+//=============================
+
+// The kind of record a data file holds, as stored in its header.
+enum class RecordKind : uint16_t {
+    UNKNOWN = 0,
+    CHANGE_ITEM = 1,
+    CHANGE_REQUEST = 2,
+    PRODUCT = 3,
+    PRODUCT_RELEASE = 4,
+    REQUESTER = 5
+};
+
+// How the records of one data file are stored.
+struct RecordLayout {
+    RecordKind kind = RecordKind::UNKNOWN;
+    int version = 0;        // 0 if the file is not a data file or was written by a newer program
+    size_t size = 0;        // Bytes per stored record
+    bool current = false;   // Stored in the version this program writes
+    bool stamped = false;   // The file has a header
+
+    bool known() const { return version > 0; }
+};
+
+//=============================
+// Class Declarations
+//=============================
+
+class FileFormat {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static RecordKind kindOf(const std::string& dataPath);
+    // Description: Returns the kind of record a data file holds, from its name.
+
+    //----------------------------------------------------------
+    static std::string headerPath(const std::string& dataPath);
+    // Description: Returns the header file of a data file.
+
+    //----------------------------------------------------------
+    static RecordLayout currentLayout(RecordKind kind);
+    // Description: Returns the layout this program writes records of a kind in.
+
+    //----------------------------------------------------------
+    static RecordLayout layout(const std::string& dataPath);
+    // Description: Returns the layout of a data file, from its header, or for a file without
+    //              one from the data directory's record format. Files known to be current are
+    //              remembered, so the common case reads nothing.
+
+    //----------------------------------------------------------
+    static const char* convert(const RecordLayout& from, const char* stored, char* buffer);
+    // Description: Brings one stored record up to the current version.
+    // Parameters:
+    // - from: The layout the record is stored in.
+    // - stored: The stored record.
+    // - buffer: Receives the converted record; MAX_RECORD_SIZE bytes.
+    // Returns: const char* - The record in the current version: stored itself if it already is.
+
+    //----------------------------------------------------------
+    static bool stamp(const std::string& dataPath, int version, int generation = 0);
+    // Description: Writes the header of a data file, recording the version its records are in
+    //              and the generation of the file. A writer that rewrites records other than by
+    //              appending or updating them in place stamps the next generation (modulo 65536),
+    //              which tells a replica copying the file to start over.
+    // Returns: bool - False if the header could not be written.
+
+    //----------------------------------------------------------
+    static int generation(const std::string& dataPath);
+    // Description: Returns the generation recorded in the header of a data file, or 0.
+
+    //----------------------------------------------------------
+    static bool ensureCurrent(const std::string& dataPath);
+    // Description: Makes sure a data file is in the current version before it is written,
+    //              upgrading it if it is not. Called by every writer before it takes any lock
+    //              on the file, since an upgrade waits for every lock on it.
+    // Returns: bool - False if the file is in a version this program cannot write.
+
+    //----------------------------------------------------------
+    static long long upgrade(const std::string& dataPath, double megabytesPerSecond);
+    // Description: Rewrites a data file in the current version, or finishes an upgrade that
+    //              was cut short. A record that fails its checksum stops the upgrade, which
+    //              leaves the file as it was.
+    // Parameters:
+    // - dataPath: The data file.
+    // - megabytesPerSecond: The rate the old records are read at, or 0 for no limit.
+    // Returns: long long - The number of records rewritten, 0 if the file was current, or -1
+    //          if it could not be upgraded.
+
+    //----------------------------------------------------------
+    static int rewrite(const std::vector<std::string>& dataPaths, double megabytesPerSecond, std::ostream& out);
+    // Description: The background rewriter: upgrades every data file that is not current, one
+    //              at a time, and prints what it did. Can run while the tracker is in use.
+    // Returns: int - The process exit status: 1 if a file could not be upgraded.
+};
+
+// Reads the records of one data file in the current version, whatever version the
+// file is stored in. While the file is older than the current version, it holds
+// off upgrades of the file, so it must not be kept open across a write to the file
+// by the same thread. Used by one thread at a time.
+class VersionedReader {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    explicit VersionedReader(const std::string& dataPath);
+    // Description: Finds the layout of the data file; opens nothing if it is current.
+
+    VersionedReader(const VersionedReader&) = delete;
+    VersionedReader& operator=(const VersionedReader&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    const RecordLayout& layout() const;
+    // Description: Returns the layout of the file.
+
+    //----------------------------------------------------------
+    bool usable() const;
+    // Description: Returns false for a file written by a newer program, which must be skipped.
+
+    //----------------------------------------------------------
+    size_t storedSize() const;
+    // Description: Returns the bytes per record in the file: the stride of record offsets.
+
+    //----------------------------------------------------------
+    const char* current(const char* stored, char* buffer) const;
+    // Description: Brings one stored record up to the current version, as FileFormat::convert does.
+
+    //----------------------------------------------------------
+    size_t read(std::istream& in, char* records, size_t count);
+    // Description: Reads up to count records from the file's current position, which must be
+    //              at a record, and stores them in the current version in records.
+    // Returns: size_t - The number of records read.
+
+private:
+    RecordLayout recordLayout;
+    std::optional<RecordLock> pin;      // Held while the file is older than the current version
+    std::vector<char> stored;           // Records as read from an old file
+};
+
+#endif // FILEFORMAT_H
@@ -0,0 +1,170 @@
+/**********************************************
+ * FileLock Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added firstLockedByte.
+ * - 2026-10-19: Each thread keeps the ranges it holds, for heldByThread.
+ *--------------------------------
+ * Purpose:
+ * This module implements RecordLock with fcntl byte-range locks. Linux open file
+ * description locks (F_OFD_SETLKW) are used where available: they belong to the
+ * descriptor rather than the process, so they also exclude other threads and are
+ * not dropped when an unrelated descriptor for the same file is closed. Other
+ * POSIX systems fall back to classic process-owned locks.
+ **********************************************/
+#include "FileLock.h"
+
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+#ifdef F_OFD_SETLKW
+#define RANGE_LOCK_COMMAND F_OFD_SETLKW
+#define RANGE_TEST_COMMAND F_OFD_GETLK
+#else
+#define RANGE_LOCK_COMMAND F_SETLKW
+#define RANGE_TEST_COMMAND F_GETLK
+#endif
+
+// A range locked by a RecordLock of this thread.
+struct HeldRange {
+    const RecordLock* owner;
+    std::string path;
+    long long offset;
+    long long length;
+};
+
+static thread_local std::vector<HeldRange> heldRanges;
+
+/**********************************************
+ * Constructor: RecordLock
+ * Description:
+ * Opens a descriptor of its own on the file and blocks until the byte range is
+ * locked. The range may lie beyond the end of the file.
+ * Parameters:
+ * - path: The data file to lock
+ * - offset: The first byte of the range
+ * - length: The number of bytes in the range
+ * - exclusive: True for a write lock, false for a shared read lock
+ **********************************************/
+RecordLock::RecordLock(const char* path, long long offset, long long length, bool exclusive) : fd(-1), locked(false) {
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open " << path << " for locking." << std::endl;
+        return;
+    }
+
+    struct flock range{};
+    range.l_type = exclusive ? F_WRLCK : F_RDLCK;
+    range.l_whence = SEEK_SET;
+    range.l_start = offset;
+    range.l_len = length;
+    range.l_pid = 0;
+    while (fcntl(fd, RANGE_LOCK_COMMAND, &range) < 0) {
+        if (errno != EINTR) {
+            std::cerr << "Failed to lock " << path << "." << std::endl;
+            return;
+        }
+    }
+    locked = true;
+    heldRanges.push_back({this, path, offset, length});
+}
+
+/**********************************************
+ * Destructor: ~RecordLock
+ * Description: Releases the lock by closing the descriptor that holds it.
+ **********************************************/
+RecordLock::~RecordLock() {
+    if (locked)
+        heldRanges.erase(std::find_if(heldRanges.begin(), heldRanges.end(), [this](const HeldRange& held) { return held.owner == this; }));
+    if (fd >= 0)
+        close(fd);
+}
+
+/**********************************************
+ * Function: firstLockedByte
+ * Description:
+ * Asks the kernel for a lock conflicting with a write lock on the range. The kernel
+ * reports any one holder, so the search range is cut back to just below the
+ * reported lock and asked again until nothing lower is held.
+ * Parameters:
+ * - path: The data file
+ * - offset: The first byte of the range
+ * - length: The number of bytes in the range
+ * Returns: long long - The lowest locked byte, or -1 if the range is unlocked.
+ **********************************************/
+long long RecordLock::firstLockedByte(const char* path, long long offset, long long length) {
+    int testFd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (testFd < 0)
+        return -1;
+
+    long long lowest = -1;
+    long long end = offset + length;
+    while (end > offset) {
+        struct flock range{};
+        range.l_type = F_WRLCK;
+        range.l_whence = SEEK_SET;
+        range.l_start = offset;
+        range.l_len = end - offset;
+        range.l_pid = 0;
+        if (fcntl(testFd, RANGE_TEST_COMMAND, &range) < 0 || range.l_type == F_UNLCK)
+            break;
+        lowest = std::max(static_cast<long long>(range.l_start), offset);
+        end = lowest;
+    }
+    close(testFd);
+    return lowest;
+}
+
+/**********************************************
+ * Function: heldByThread
+ * Description:
+ * Looks through the ranges this thread has locked for one overlapping the given
+ * range of the same file. Paths are compared in absolute form, since callers name
+ * the same file relative to the working directory or not.
+ * Parameters:
+ * - path: The data file
+ * - offset: The first byte of the range
+ * - length: The number of bytes in the range
+ * Returns: bool - True if the thread holds a lock overlapping the range
+ **********************************************/
+bool RecordLock::heldByThread(const char* path, long long offset, long long length) {
+    if (heldRanges.empty())
+        return false;
+    std::error_code error;
+    std::filesystem::path wanted = std::filesystem::absolute(path, error).lexically_normal();
+    for (const HeldRange& held : heldRanges) {
+        if (held.offset >= offset + length || offset >= held.offset + held.length)
+            continue;
+        if (held.path == path || std::filesystem::absolute(held.path, error).lexically_normal() == wanted)
+            return true;
+    }
+    return false;
+}
+
+#else
+
+//================================
+// Unsupported platform
+//================================
+RecordLock::RecordLock(const char* path, long long offset, long long length, bool exclusive) : fd(-1), locked(false) {}
+RecordLock::~RecordLock() {}
+long long RecordLock::firstLockedByte(const char* path, long long offset, long long length) { return -1; }
+bool RecordLock::heldByThread(const char* path, long long offset, long long length) { return false; }
+
+#endif
+
+/**********************************************
+ * Function: isLocked
+ * Description: Returns true if the range was locked.
+ **********************************************/
+bool RecordLock::isLocked() const {
+    return locked;
+}
@@ -0,0 +1,75 @@
+/**********************************************
+ * FileLock Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added firstLockedByte.
+ * - 2026-10-19: Added heldByThread.
+ *--------------------------------
+ * Purpose:
+ * This module provides advisory byte-range locks on the data files so that several
+ * processes can share them safely. A RecordLock covers exactly the bytes of one
+ * record, so processes updating different records never wait for each other, and
+ * appends serialize on a sentinel range far beyond any real record. Locks are
+ * held on an open file description of their own and are released when the
+ * RecordLock goes out of scope.
+ **********************************************/
+#ifndef FILELOCK_H
+#define FILELOCK_H
+
+//=============================
+// Constants
+//=============================
+const long long APPEND_LOCK_OFFSET = 0x7FFFFFFF00000000LL; // Sentinel byte locked while appending and assigning IDs
+
+//=============================
+// Class Declaration
+//=============================
+
+class RecordLock {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    RecordLock(const char* path, long long offset, long long length, bool exclusive);
+    // Description: Blocks until the byte range of the file is locked.
+    // Parameters:
+    // - const char* path: The data file to lock.
+    // - long long offset: The first byte of the range.
+    // - long long length: The number of bytes in the range.
+    // - bool exclusive: True for a write lock, false for a shared read lock.
+
+    //----------------------------------------------------------
+    ~RecordLock();
+    // Description: Releases the lock.
+
+    RecordLock(const RecordLock&) = delete;
+    RecordLock& operator=(const RecordLock&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    bool isLocked() const;
+    // Description: Returns true if the range was locked. False means the file could
+    //              not be opened or the platform has no byte-range locks.
+
+    //----------------------------------------------------------
+    static long long firstLockedByte(const char* path, long long offset, long long length);
+    // Description: Finds the lowest byte of the range that any RecordLock, in this or
+    //              another process, currently holds. Does not wait.
+    // Returns: long long - The offset of that byte, or -1 if the range is unlocked.
+
+    //----------------------------------------------------------
+    static bool heldByThread(const char* path, long long offset, long long length);
+    // Description: Returns true if a RecordLock the calling thread holds overlaps the range.
+    //              A thread must not wait for such a range again: the new lock is taken on a
+    //              descriptor of its own, so it would wait for the thread's own lock.
+
+private:
+    int fd;
+    bool locked;
+};
+
+#endif // FILELOCK_H
@@ -0,0 +1,217 @@
+/**********************************************
+ * IdAllocator Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module implements the block-reserving ID allocator. The high-water mark is
+ * a decimal number in a small text file. It is replaced by writing a temporary file,
+ * flushing it to disk and renaming it over the old one, so a crash leaves either
+ * the old or the new mark but never a torn one. Reservations from different
+ * processes serialize on a sentinel byte lock of the data file.
+ **********************************************/
+#include "IdAllocator.h"
+#include "FileLock.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//================================
+// Constants
+//================================
+const long long MIN_BLOCK_SIZE = 16;        // Block reserved by an idle process
+const long long MAX_BLOCK_SIZE = 65536;     // Largest block reserved under sustained load
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Constructor: IdAllocator
+ * Description: Creates an allocator for the records of one data file.
+ * Parameters:
+ * - dataFile: The data file whose sentinel byte serializes reservations
+ * - markFile: The file that stores the durable high-water mark
+ **********************************************/
+IdAllocator::IdAllocator(const char* dataFile, const char* markFile)
+    : dataPath(dataFile), markPath(markFile), scanMax(nullptr), current(nullptr), blockSize(MIN_BLOCK_SIZE) {}
+
+/**********************************************
+ * Function: init
+ * Description:
+ * Remembers how to recover the mark and makes sure a valid mark file exists. The
+ * data file is only scanned when the mark is missing, e.g. the first time the
+ * allocator runs against files written by an older version.
+ * Parameters:
+ * - scanMaxId: Returns the largest ID in the data file, or -1 if it is empty
+ * Returns: bool - True if the allocator is ready.
+ **********************************************/
+bool IdAllocator::init(int (*scanMaxId)()) {
+    scanMax = scanMaxId;
+    RecordLock lock(dataPath.c_str(), ID_LOCK_OFFSET, 1, true);
+    bool valid;
+    readMark(valid);
+    if (!valid)
+        return writeMark(static_cast<long long>(scanMax()) + 1);
+    return true;
+}
+
+/**********************************************
+ * Function: nextId
+ * Description:
+ * Takes the next ID of the current block with one atomic increment. Only when the
+ * block is used up does a thread take the refill mutex and reserve a new block;
+ * increments that overshoot a used-up block are simply discarded.
+ * Returns: int - The ID, or -1 if no block could be reserved.
+ **********************************************/
+int IdAllocator::nextId() {
+    Block* block = current.load(std::memory_order_acquire);
+    if (block != nullptr) {
+        long long id = block->next.fetch_add(1, std::memory_order_relaxed);
+        if (id < block->limit)
+            return static_cast<int>(id);
+    }
+
+    std::lock_guard<std::mutex> lock(refillMutex);
+    for (;;) {
+        block = current.load(std::memory_order_acquire);
+        if (block != nullptr) {
+            long long id = block->next.fetch_add(1, std::memory_order_relaxed);
+            if (id < block->limit)
+                return static_cast<int>(id);
+        }
+        Block* fresh;
+        if (!reserve(fresh))
+            return -1;
+        current.store(fresh, std::memory_order_release);
+    }
+}
+
+/**********************************************
+ * Function: release
+ * Description:
+ * Gives back the unused tail of the current block. The tail is claimed atomically
+ * first so no thread can still take an ID from it, and the mark is only lowered if
+ * it still ends at this block, i.e. no other process has reserved since.
+ **********************************************/
+void IdAllocator::release() {
+    std::lock_guard<std::mutex> lock(refillMutex);
+    Block* block = current.load(std::memory_order_acquire);
+    if (block == nullptr)
+        return;
+    current.store(nullptr, std::memory_order_release);
+
+    long long unused = block->next.exchange(block->limit);
+    if (unused >= block->limit)
+        return;
+
+    RecordLock fileLock(dataPath.c_str(), ID_LOCK_OFFSET, 1, true);
+    bool valid;
+    long long mark = readMark(valid);
+    if (valid && mark == block->limit)
+        writeMark(unused);
+}
+
+/**********************************************
+ * Function: reserve
+ * Description:
+ * Raises the durable mark by one block under the cross-process lock and returns the
+ * reserved range. The block doubles while refills come less than a second apart
+ * and drops back to the minimum after a quiet period.
+ * Parameters:
+ * - reserved: Receives the new block
+ * Returns: bool - True if the mark was raised.
+ **********************************************/
+bool IdAllocator::reserve(Block*& reserved) {
+    auto now = std::chrono::steady_clock::now();
+    if (!blocks.empty() && now - lastRefill < std::chrono::seconds(1))
+        blockSize = std::min(blockSize * 2, MAX_BLOCK_SIZE);
+    else if (blocks.empty() || now - lastRefill > std::chrono::seconds(10))
+        blockSize = MIN_BLOCK_SIZE;
+    lastRefill = now;
+
+    RecordLock lock(dataPath.c_str(), ID_LOCK_OFFSET, 1, true);
+    bool valid;
+    long long first = readMark(valid);
+    if (!valid)
+        first = static_cast<long long>(scanMax != nullptr ? scanMax() : -1) + 1;
+    if (first > INT_MAX) {
+        std::cerr << "Change IDs are exhausted for " << dataPath << "." << std::endl;
+        return false;
+    }
+    long long limit = std::min(first + blockSize, static_cast<long long>(INT_MAX) + 1);
+    if (!writeMark(limit)) {
+        std::cerr << "Failed to reserve change IDs for " << dataPath << "." << std::endl;
+        return false;
+    }
+
+    blocks.push_back(std::make_unique<Block>(first, limit));
+    reserved = blocks.back().get();
+    return true;
+}
+
+/**********************************************
+ * Function: readMark
+ * Description: Reads the high-water mark.
+ * Parameters:
+ * - valid: Set to false if the mark file is missing or unreadable
+ * Returns: long long - The first ID that has never been reserved.
+ **********************************************/
+long long IdAllocator::readMark(bool& valid) const {
+    std::ifstream infile(markPath);
+    long long mark = -1;
+    valid = static_cast<bool>(infile >> mark) && mark >= 0;
+    return mark;
+}
+
+/**********************************************
+ * Function: writeMark
+ * Description:
+ * Replaces the high-water mark durably: the new value is written to a temporary
+ * file and flushed to disk, the file is renamed over the old mark, and on POSIX
+ * systems the directory is flushed so the rename itself survives a crash.
+ * Parameters:
+ * - mark: The first ID that has never been reserved
+ * Returns: bool - True if the mark is on disk.
+ **********************************************/
+bool IdAllocator::writeMark(long long mark) const {
+    std::string temporary = markPath + ".tmp";
+    FILE* out = std::fopen(temporary.c_str(), "w");
+    if (out == nullptr)
+        return false;
+    bool written = std::fprintf(out, "%lld\n", mark) > 0 && std::fflush(out) == 0;
+#ifdef _WIN32
+    written = written && _commit(_fileno(out)) == 0;
+#else
+    written = written && fsync(fileno(out)) == 0;
+#endif
+    written = std::fclose(out) == 0 && written;
+    if (!written)
+        return false;
+
+    std::error_code error;
+    std::filesystem::rename(temporary, markPath, error);
+    if (error)
+        return false;
+
+#ifndef _WIN32
+    std::filesystem::path directory = std::filesystem::absolute(markPath, error).parent_path();
+    int directoryFd = open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (directoryFd >= 0) {
+        fsync(directoryFd);
+        close(directoryFd);
+    }
+#endif
+    return true;
+}
@@ -0,0 +1,94 @@
+/**********************************************
+ * IdAllocator Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module hands out change IDs that never collide, across threads, across
+ * processes and across crashes. Each process reserves a block of IDs by raising a
+ * durable high-water mark stored next to the data file; the mark is on disk before
+ * any ID of the block is used, so a process that restarts after a crash always
+ * starts past everything that was handed out. Within a process, IDs are taken
+ * from the current block with a single atomic increment. Blocks grow while IDs are
+ * being requested quickly, and the unused tail of a block is given back at
+ * shutdown when no other process has reserved after it, so interactive sessions
+ * see consecutive IDs.
+ **********************************************/
+#ifndef IDALLOCATOR_H
+#define IDALLOCATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const long long ID_LOCK_OFFSET = 0x7FFFFFFF00000001LL; // Sentinel byte of the data file locked while the mark is raised
+
+//=============================
+// Class Declaration
+//=============================
+
+class IdAllocator {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    IdAllocator(const char* dataFile, const char* markFile);
+    // Description: Creates an allocator for the records of one data file.
+    // Parameters:
+    // - const char* dataFile: The data file whose sentinel byte serializes reservations.
+    // - const char* markFile: The file that stores the durable high-water mark.
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    bool init(int (*scanMaxId)());
+    // Description: Prepares the allocator. scanMaxId is only called when the mark file
+    //              is missing or unreadable, to recover the mark from the data itself.
+    // Parameters:
+    // - int (*scanMaxId)(): Returns the largest ID in the data file, or -1 if it is empty.
+    // Returns: bool - True if the allocator is ready.
+
+    //----------------------------------------------------------
+    int nextId();
+    // Description: Returns an ID that no thread or process has received before.
+    //              Costs one atomic increment unless a new block must be reserved.
+    // Returns: int - The ID, or -1 if no block could be reserved.
+
+    //----------------------------------------------------------
+    void release();
+    // Description: Gives back the unused tail of the current block if no other process
+    //              has reserved a block since. Called when the entity module is closed.
+
+private:
+    // A reserved range of IDs [first, limit). Blocks are never freed while the
+    // allocator is alive because threads may still be reading a retired one.
+    struct Block {
+        std::atomic<long long> next;
+        long long limit;
+        Block(long long first, long long end) : next(first), limit(end) {}
+    };
+
+    bool reserve(Block*& reserved);
+    long long readMark(bool& valid) const;
+    bool writeMark(long long mark) const;
+
+    std::string dataPath;
+    std::string markPath;
+    int (*scanMax)();
+    std::atomic<Block*> current;
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::mutex refillMutex;
+    long long blockSize;
+    std::chrono::steady_clock::time_point lastRefill;
+};
+
+#endif // IDALLOCATOR_H
@@ -0,0 +1,709 @@
+/**********************************************
+ * ItemArchive Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Archives are written and read as compressed block files; older archives are converted at startup.
+ *--------------------------------
+ * Purpose:
+ * This module implements the archives of closed change items: the move of closed
+ * items out of each item file, the binary search of the archives, and the move of
+ * archived items back into their item file.
+ *
+ * A move rewrites one item file and its archive while holding the record bytes
+ * and the append sentinel of the item file, the archive sentinel and the snapshot
+ * commit lock, always in that order, the same order the snapshots and the
+ * lookups take the locks they need. The new archive goes to "<archive>.pending"
+ * by way of a temporary file, so a pending copy is always complete; the archive's
+ * generation is bumped in its header and the pending copy renamed over it. The
+ * item file is compacted last and its generation bumped too, which tells a
+ * replica to copy both again.
+ *
+ * Archives are block files (see BlockFile): a lookup reads the block index and
+ * the one block its change ID can be in, and a full read decompresses blocks on
+ * several threads. Archives written before they were block files, as arrays of
+ * records with a checksum file, are rewritten as block files at startup.
+ **********************************************/
+#include "ItemArchive.h"
+#include "BlockFile.h"
+#include "FileFormat.h"
+#include "ItemHistory.h"
+#include "RecordChecksum.h"
+#include "Snapshot.h"
+#include "StorageLayout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+//================================
+// Constants
+//================================
+static const char* PENDING_SUFFIX = ".pending";           // The complete new archive, until it is renamed into place
+static const char* TEMPORARY_SUFFIX = ".pending.tmp";     // The new archive being written
+static const size_t ARCHIVE_CHUNK_RECORDS = 4096;         // Records of an item file read or written per step
+static const long long SECONDS_PER_DAY = 86400;
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: hotPath
+ * Description: Returns the item file an archive belongs to: the file of the same
+ *              name one directory up.
+ **********************************************/
+static std::string hotPath(const std::string& archive) {
+    std::filesystem::path path(archive);
+    return (path.parent_path().parent_path() / path.filename()).string();
+}
+
+/**********************************************
+ * Function: fileRecords
+ * Description: Returns the number of whole change item records in a file, or 0 if it is missing.
+ **********************************************/
+static long long fileRecords(const std::string& path) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    return error ? 0 : static_cast<long long>(size / sizeof(ChangeItem));
+}
+
+/**********************************************
+ * Function: isClosed
+ * Description: Returns true for the states an item is archived in.
+ **********************************************/
+static bool isClosed(int state) {
+    return state == ChangeItem::DONE || state == ChangeItem::CANCELLED;
+}
+
+/**********************************************
+ * Function: closedSince
+ * Description:
+ * Finds when a closed change item entered its current state, from its history.
+ * An item without a history (written before history was kept) is dated by the
+ * date it was reported.
+ * Parameters:
+ * - changeItem: The closed change item
+ * Returns: long long - Seconds since the epoch, or -1 if the date is unknown
+ **********************************************/
+static long long closedSince(const ChangeItem& changeItem) {
+    std::vector<Transition> history;
+    if (ItemHistory::transitions(changeItem.getChangeId(), history)) {
+        long long since = -1;
+        int state = -1;
+        for (const Transition& transition : history) {
+            if (transition.kind != Transition::PRIORITY && transition.state != state) {
+                state = transition.state;
+                since = transition.timestamp;
+            }
+        }
+        if (state == changeItem.getState())
+            return since;
+    }
+
+    std::tm reported{};
+    std::string date = changeItem.getDate();
+    if (std::sscanf(date.c_str(), "%d-%d-%d", &reported.tm_year, &reported.tm_mon, &reported.tm_mday) != 3)
+        return -1;
+    reported.tm_year -= 1900;
+    reported.tm_mon -= 1;
+    reported.tm_isdst = -1;
+    return static_cast<long long>(std::mktime(&reported));
+}
+
+/**********************************************
+ * Function: nextGeneration
+ * Description: Returns the generation a rewritten file is stamped with.
+ **********************************************/
+static int nextGeneration(const std::string& path) {
+    return (FileFormat::generation(path) + 1) & 0xFFFF;
+}
+
+/**********************************************
+ * Function: describe
+ * Description: Prints the sizes of a block file: its bytes against the bytes of
+ *              its records, and the ratio between them.
+ **********************************************/
+static void describe(std::ostream& out, const BlockStats& stats) {
+    out << std::fixed << std::setprecision(1) << static_cast<double>(stats.storedBytes) / 1024.0 << " KiB for "
+        << static_cast<double>(stats.rawBytes) / 1024.0 << " KiB of records, ratio " << stats.ratio() << std::defaultfloat;
+}
+
+/**********************************************
+ * Function: search
+ * Description: Finds a change ID in one archive: the block index names the only
+ *              block it can be in, which is searched by binary search.
+ * Parameters:
+ * - archive: The archive, sorted by change ID
+ * - changeId: The change ID to find
+ * - changeItem: Receives the record
+ * Returns: bool - True if found in a block that passes its checksum
+ **********************************************/
+static bool search(const std::string& archive, int changeId, ChangeItem& changeItem) {
+    BlockReader reader(archive);
+    size_t block = reader.findBlock(changeId);
+    if (block >= reader.blocks() || reader.recordSize() != sizeof(ChangeItem))
+        return false;
+    std::vector<char> records;
+    if (!reader.readBlock(block, records)) {
+        std::cerr << archive << ": block " << block << " fails its checksum; run --scrub to check every block." << std::endl;
+        return false;
+    }
+    const ChangeItem* first = reinterpret_cast<const ChangeItem*>(records.data());
+    const ChangeItem* last = first + reader.blockRecords(block);
+    const ChangeItem* found = std::lower_bound(first, last, changeId,
+                                               [](const ChangeItem& record, int wanted) { return record.getChangeId() < wanted; });
+    if (found == last || found->getChangeId() != changeId)
+        return false;
+    changeItem = *found;
+    return true;
+}
+
+/**********************************************
+ * Function: commitPending
+ * Description: Renames a fully written new archive to its pending name, which
+ *              marks it complete.
+ * Returns: bool - False if it could not be written
+ **********************************************/
+static bool commitPending(const std::string& archive, BlockWriter& temporary) {
+    std::error_code error;
+    if (!temporary.close()) {
+        std::filesystem::remove(archive + TEMPORARY_SUFFIX, error);
+        return false;
+    }
+    std::filesystem::rename(archive + TEMPORARY_SUFFIX, archive + PENDING_SUFFIX, error);
+    return !error;
+}
+
+/**********************************************
+ * Function: install
+ * Description:
+ * Puts a complete pending archive in place of the archive: stamps the next
+ * generation, then renames the pending copy over the archive. A crash in between
+ * leaves the pending copy, and installing it again bumps the generation again.
+ * Readers that opened the old archive keep reading it. A checksum file left by an
+ * archive from before block files is removed. Called with the archive sentinel
+ * held exclusive.
+ * Parameters:
+ * - archive: The archive
+ * Returns: bool - False if the archive could not be written; the pending copy is kept
+ **********************************************/
+static bool install(const std::string& archive) {
+    std::error_code error;
+    bool stamped = FileFormat::stamp(archive, FileFormat::currentLayout(RecordKind::CHANGE_ITEM).version, nextGeneration(archive));
+    if (stamped)
+        std::filesystem::rename(archive + PENDING_SUFFIX, archive, error);
+    if (!stamped || error) {
+        std::cerr << "Failed to write " << archive << "; it is finished from " << archive << PENDING_SUFFIX << " at the next start." << std::endl;
+        return false;
+    }
+    std::filesystem::remove(RecordChecksum::checksumPath(archive), error);
+    return true;
+}
+
+/**********************************************
+ * Function: finishPending
+ * Description: Installs the pending copy of an archive left by a move cut short.
+ *              Called with the archive sentinel held exclusive.
+ * Returns: bool - False if a pending copy is left
+ **********************************************/
+static bool finishPending(const std::string& archive) {
+    std::error_code error;
+    std::filesystem::remove(archive + TEMPORARY_SUFFIX, error); // Never complete
+    if (!std::filesystem::exists(archive + PENDING_SUFFIX, error))
+        return true;
+    return install(archive);
+}
+
+/**********************************************
+ * Function: readArchive
+ * Description: Reads every record of an archive, blocks decompressed in parallel.
+ * Parameters:
+ * - archive: The archive; a missing one holds no records
+ * - visit: Called with each record, in change ID order
+ * Returns: bool - False if the archive or a block of it is damaged
+ **********************************************/
+template <typename Visit>
+static bool readArchive(const std::string& archive, Visit visit) {
+    std::error_code error;
+    if (!std::filesystem::exists(archive, error))
+        return true;
+    BlockReader reader(archive);
+    if (!reader.valid() || reader.recordSize() != sizeof(ChangeItem))
+        return false;
+    return reader.scan([&](const char* records, size_t count) {
+        const ChangeItem* changeItems = reinterpret_cast<const ChangeItem*>(records);
+        for (size_t i = 0; i < count; i++)
+            visit(changeItems[i]);
+    });
+}
+
+/**********************************************
+ * Function: convertArchive
+ * Description:
+ * Rewrites an archive that is not a block file in the current record version: an
+ * array of records from before archives were block files, in any record version,
+ * or a block file of an older record version. Every record is verified and
+ * brought up to the current version on the way. Called with the archive sentinel
+ * held exclusive.
+ * Parameters:
+ * - archive: The archive
+ * Returns: bool - False if it could not be converted; it is left as it was
+ **********************************************/
+static bool convertArchive(const std::string& archive) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(archive, error);
+    RecordLayout layout = FileFormat::layout(archive);
+    if (!error && size == 0) {
+        std::filesystem::remove(archive, error); // Emptied, which leaves no archive
+        std::filesystem::remove(RecordChecksum::checksumPath(archive), error);
+        return true;
+    }
+    BlockReader blocks(archive);
+    if (error || !layout.known() || (blocks.valid() && layout.current))
+        return true;
+
+    BlockWriter temporary(archive + TEMPORARY_SUFFIX, sizeof(ChangeItem));
+    char converted[MAX_RECORD_SIZE];
+    bool intact = true;
+    if (blocks.valid()) {
+        intact = blocks.recordSize() == layout.size && blocks.scan([&](const char* records, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                const char* record = FileFormat::convert(layout, records + i * layout.size, converted);
+                temporary.append(record, Schema<ChangeItem>::read<ChangeItem::FIELD_CHANGE_ID>(record));
+            }
+        });
+    } else {
+        VersionedReader reader(archive);
+        std::ifstream infile(archive, std::ios::binary);
+        ChecksumReader checksums(archive, reader.storedSize());
+        std::vector<char> stored(reader.storedSize());
+        for (long long offset = 0; reader.usable() && infile.read(stored.data(), static_cast<std::streamsize>(stored.size()));
+             offset += static_cast<long long>(stored.size())) {
+            if (!checksums.check(offset, stored.data())) {
+                intact = false;
+                break;
+            }
+            const char* record = reader.current(stored.data(), converted);
+            temporary.append(record, Schema<ChangeItem>::read<ChangeItem::FIELD_CHANGE_ID>(record));
+        }
+    }
+    if (!intact) {
+        std::cerr << archive << " has a damaged record and is left as it was." << std::endl;
+        temporary.close();
+        std::filesystem::remove(archive + TEMPORARY_SUFFIX, error);
+        return false;
+    }
+    return commitPending(archive, temporary) && install(archive);
+}
+
+/**********************************************
+ * Function: compact
+ * Description:
+ * Rewrites an item file in place with only the records marked to keep, front to
+ * back. A record is only ever written at or before the place it was read from,
+ * so a compaction cut short loses nothing: it leaves some records twice. Chunks
+ * whose records all stay where they are are not written.
+ * Parameters:
+ * - segment: The item file, with every record and its append sentinel locked
+ * - keep: One flag per record
+ * Returns: bool - False if the file could not be rewritten
+ **********************************************/
+static bool compact(const std::string& segment, const std::vector<char>& keep) {
+    std::ifstream infile(segment, std::ios::binary);
+    std::fstream outfile(segment, std::ios::in | std::ios::out | std::ios::binary);
+    if (!infile.is_open() || !outfile.is_open())
+        return false;
+    std::vector<ChangeItem> records(ARCHIVE_CHUNK_RECORDS);
+    long long written = 0;
+    for (size_t first = 0; first < keep.size(); first += ARCHIVE_CHUNK_RECORDS) {
+        size_t count = std::min(keep.size() - first, ARCHIVE_CHUNK_RECORDS);
+        if (!infile.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(count * sizeof(ChangeItem))))
+            return false;
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (keep[first + i])
+                records[kept++] = records[i];
+        }
+        if (kept > 0 && (kept < count || written != static_cast<long long>(first * sizeof(ChangeItem)))) {
+            outfile.seekp(written);
+            outfile.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(kept * sizeof(ChangeItem)));
+            outfile.flush(); // Written before their checksums, as an update is
+            RecordChecksum::store(segment, sizeof(ChangeItem), written, records.data(), kept);
+        }
+        written += static_cast<long long>(kept * sizeof(ChangeItem));
+    }
+    outfile.close();
+    if (outfile.fail())
+        return false;
+    std::error_code error;
+    std::filesystem::resize_file(segment, static_cast<uintmax_t>(written), error);
+    RecordChecksum::truncate(segment, sizeof(ChangeItem), written);
+    return !error && FileFormat::stamp(segment, FileFormat::currentLayout(RecordKind::CHANGE_ITEM).version, nextGeneration(segment));
+}
+
+/**********************************************
+ * Function: archiveSegment
+ * Description:
+ * Moves the closed items of one item file that closed before the cutoff into its
+ * archive. The items are chosen without any lock, since looking up their history
+ * is the slow part; under the locks, an item only moves if it still has the version
+ * it was chosen at. An item found twice, left by a move cut short, keeps its first
+ * copy in the item file, and its archived copy is dropped.
+ * Parameters:
+ * - segment: The item file
+ * - cutoff: Items closed before this time, in seconds since the epoch, are moved
+ * - out: Receives a line about the file if anything moved
+ * Returns: long long - The number of items moved, or -1 if the files could not be rewritten
+ **********************************************/
+static long long archiveSegment(const std::string& segment, long long cutoff, std::ostream& out) {
+    std::string archive = StorageLayout::archivePath(segment);
+    std::error_code error;
+    if (!FileFormat::ensureCurrent(segment))
+        return -1;
+
+    std::unordered_map<int, int> eligible;  // Change ID to the version it was chosen at
+    {
+        std::ifstream infile(segment, std::ios::binary);
+        std::vector<ChangeItem> records(ARCHIVE_CHUNK_RECORDS);
+        while (infile.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(ChangeItem))) ||
+               infile.gcount() > 0) {
+            size_t count = static_cast<size_t>(infile.gcount()) / sizeof(ChangeItem);
+            if (count == 0)
+                break;
+            for (size_t i = 0; i < count; i++) {
+                if (!isClosed(records[i].getState()))
+                    continue;
+                long long since = closedSince(records[i]);
+                if (since >= 0 && since < cutoff)
+                    eligible[records[i].getChangeId()] = records[i].getVersion();
+            }
+        }
+    }
+
+    RecordLock fileLock(segment.c_str(), 0, APPEND_LOCK_OFFSET + 1, true);
+    RecordLock archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+    Snapshot::WriteScope writeScope; // Holds off lookup filter rebuilds, which read the archives
+    if (!finishPending(archive) || !convertArchive(archive))
+        return -1;
+
+    long long records = fileRecords(segment);
+    std::filesystem::resize_file(segment, static_cast<uintmax_t>(records) * sizeof(ChangeItem), error); // A torn append
+    std::vector<char> keep(static_cast<size_t>(records), 0);
+    std::vector<ChangeItem> moved;
+    std::unordered_set<int> kept;
+    std::unordered_set<int> movedIds;
+    size_t duplicates = 0;
+    {
+        std::ifstream infile(segment, std::ios::binary);
+        ChecksumReader checksums(segment, sizeof(ChangeItem));
+        ChangeItem changeItem;
+        for (long long i = 0; i < records && infile.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem)); i++) {
+            if (!checksums.check(i * static_cast<long long>(sizeof(ChangeItem)), &changeItem)) {
+                std::cerr << segment << " has a damaged record; its items are not archived." << std::endl;
+                return -1;
+            }
+            int changeId = changeItem.getChangeId();
+            auto chosen = eligible.find(changeId);
+            if (kept.count(changeId) > 0 || movedIds.count(changeId) > 0) {
+                duplicates++;
+            } else if (chosen != eligible.end() && chosen->second == changeItem.getVersion() && isClosed(changeItem.getState())) {
+                moved.push_back(changeItem);
+                movedIds.insert(changeId);
+            } else {
+                keep[static_cast<size_t>(i)] = 1;
+                kept.insert(changeId);
+            }
+        }
+    }
+    std::sort(moved.begin(), moved.end(), [](const ChangeItem& a, const ChangeItem& b) { return a.getChangeId() < b.getChangeId(); });
+
+    // The new archive: the old one and the moved items merged in change ID order
+    std::filesystem::create_directories(std::filesystem::path(archive).parent_path(), error);
+    BlockWriter temporary(archive + TEMPORARY_SUFFIX, sizeof(ChangeItem));
+    size_t next = 0;
+    size_t dropped = 0;
+    bool readable = readArchive(archive, [&](const ChangeItem& changeItem) {
+        for (; next < moved.size() && moved[next].getChangeId() < changeItem.getChangeId(); next++)
+            temporary.append(&moved[next], moved[next].getChangeId());
+        if (kept.count(changeItem.getChangeId()) > 0 || movedIds.count(changeItem.getChangeId()) > 0)
+            dropped++; // The copy in the item file wins
+        else
+            temporary.append(&changeItem, changeItem.getChangeId());
+    });
+    for (; next < moved.size(); next++)
+        temporary.append(&moved[next], moved[next].getChangeId());
+    if (!readable) {
+        std::cerr << archive << " is damaged; no items are archived into it." << std::endl;
+        temporary.close();
+        std::filesystem::remove(archive + TEMPORARY_SUFFIX, error);
+        return -1;
+    }
+    if (moved.empty() && duplicates == 0 && dropped == 0) {
+        temporary.close();
+        std::filesystem::remove(archive + TEMPORARY_SUFFIX, error);
+        return 0;
+    }
+
+    // Archived before they leave the item file, so a crash in between leaves them twice, never nowhere
+    if (!commitPending(archive, temporary) || !install(archive) || !compact(segment, keep)) {
+        std::cerr << "Failed to archive the closed items of " << segment << "." << std::endl;
+        return -1;
+    }
+    out << segment << ": moved " << moved.size() << " closed items to " << archive << "; " << kept.size()
+        << " items remain. The archive holds " << temporary.stats().records << " items in ";
+    describe(out, temporary.stats());
+    out << "." << std::endl;
+    return static_cast<long long>(moved.size());
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Constructor: ReadScope
+ * Description: Holds the archive sentinel shared for the lifetime of the read.
+ **********************************************/
+ItemArchive::ReadScope::ReadScope() : archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, false) {}
+
+/**********************************************
+ * Function: find
+ * Description: Searches every archive of the current layout for a change ID.
+ * Parameters:
+ * - changeId: The change ID to find
+ * - changeItem: Receives the record
+ * - archive: Receives the archive holding it
+ * Returns: bool - True if the change item is archived
+ **********************************************/
+bool ItemArchive::find(int changeId, ChangeItem& changeItem, std::string& archive) {
+    for (const std::string& path : StorageLayout::archiveSegments()) {
+        if (search(path, changeId, changeItem)) {
+            archive = path;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**********************************************
+ * Function: restore
+ * Description:
+ * Moves archived change items back to the end of their item file. The archive is
+ * rewritten without them, by way of a pending copy, after they have been appended,
+ * so a crash in between leaves them twice and the item file's copy wins.
+ * Parameters:
+ * - archive: The archive holding the change items
+ * - changeIds: The change items to move back
+ * Returns: int - The number moved, or -1 on failure
+ **********************************************/
+int ItemArchive::restore(const std::string& archive, const std::vector<int>& changeIds) {
+    std::string segment = hotPath(archive);
+    std::error_code error;
+    if (!FileFormat::ensureCurrent(segment))
+        return -1;
+    std::unordered_set<int> wanted(changeIds.begin(), changeIds.end());
+
+    RecordLock appendLock(segment.c_str(), APPEND_LOCK_OFFSET, 1, true);
+    RecordLock archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+    Snapshot::WriteScope writeScope;
+    if (!finishPending(archive) || !convertArchive(archive))
+        return -1;
+    if (!std::filesystem::exists(archive, error))
+        return 0; // Moved by a migration meanwhile
+
+    std::vector<ChangeItem> restored;
+    BlockWriter temporary(archive + TEMPORARY_SUFFIX, sizeof(ChangeItem));
+    bool readable = readArchive(archive, [&](const ChangeItem& changeItem) {
+        if (wanted.count(changeItem.getChangeId()) > 0)
+            restored.push_back(changeItem);
+        else
+            temporary.append(&changeItem, changeItem.getChangeId());
+    });
+    if (!readable || restored.empty()) {
+        temporary.close();
+        std::filesystem::remove(archive + TEMPORARY_SUFFIX, error);
+        return readable ? 0 : -1;
+    }
+    if (!commitPending(archive, temporary))
+        return -1;
+
+    long long offset = fileRecords(segment) * static_cast<long long>(sizeof(ChangeItem));
+    std::filesystem::resize_file(segment, static_cast<uintmax_t>(offset), error); // A torn append
+    RecordChecksum::store(segment, sizeof(ChangeItem), offset, restored.data(), restored.size()); // Before the records, as an append does
+    std::ofstream outfile(segment, std::ios::binary | std::ios::app);
+    outfile.write(reinterpret_cast<const char*>(restored.data()), static_cast<std::streamsize>(restored.size() * sizeof(ChangeItem)));
+    outfile.close();
+    if (outfile.fail() || !install(archive)) {
+        std::cerr << "Failed to move archived items back into " << segment << "." << std::endl;
+        return -1;
+    }
+    return static_cast<int>(restored.size());
+}
+
+/**********************************************
+ * Function: restoreMatching
+ * Description: Finds the archived change items wanted in each archive under a
+ *              ReadScope, then restores them archive by archive.
+ * Parameters:
+ * - archives: The archives to search
+ * - wanted: Returns true for a change item to restore
+ * Returns: int - The number restored, or -1 on failure
+ **********************************************/
+int ItemArchive::restoreMatching(const std::vector<std::string>& archives, const std::function<bool(const ChangeItem&)>& wanted) {
+    int restored = 0;
+    for (const std::string& archive : archives) {
+        std::vector<int> changeIds;
+        {
+            ReadScope scope;
+            std::error_code error;
+            if (!std::filesystem::exists(archive, error))
+                continue;
+            if (!readArchive(archive, [&](const ChangeItem& changeItem) {
+                    if (wanted(changeItem))
+                        changeIds.push_back(changeItem.getChangeId());
+                }))
+                return -1;
+        }
+        if (changeIds.empty())
+            continue;
+        int count = restore(archive, changeIds);
+        if (count < 0)
+            return -1;
+        restored += count;
+    }
+    return restored;
+}
+
+/**********************************************
+ * Function: archiveClosed
+ * Description: Archives the items closed for at least ageDays, item file by item file.
+ * Parameters:
+ * - ageDays: The number of days an item must have been closed
+ * - out: Receives a line per item file and a summary
+ * Returns: long long - The number of items moved, or -1 if a file failed
+ **********************************************/
+long long ItemArchive::archiveClosed(int ageDays, std::ostream& out) {
+    recover();
+    long long cutoff = static_cast<long long>(std::time(nullptr)) - static_cast<long long>(ageDays) * SECONDS_PER_DAY;
+    long long total = 0;
+    bool failed = false;
+    for (const std::string& segment : StorageLayout::itemSegments()) {
+        long long moved = archiveSegment(segment, cutoff, out);
+        if (moved < 0)
+            failed = true;
+        else
+            total += moved;
+    }
+    out << "Archived " << total << " change items closed for at least " << ageDays << " days." << std::endl;
+    return failed ? -1 : total;
+}
+
+/**********************************************
+ * Function: recover
+ * Description: Installs every pending archive copy left by a move cut short, in
+ *              both layouts' archive directories, then rewrites the archives of
+ *              the current layout that are not yet current block files.
+ **********************************************/
+void ItemArchive::recover() {
+    for (std::filesystem::path directory : {std::filesystem::path(ARCHIVE_DIRECTORY), std::filesystem::path(PARTITION_DIRECTORY) / ARCHIVE_DIRECTORY}) {
+        std::vector<std::string> archives;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            std::string name = entry.path().string();
+            if (name.size() > std::strlen(PENDING_SUFFIX) &&
+                name.compare(name.size() - std::strlen(PENDING_SUFFIX), std::string::npos, PENDING_SUFFIX) == 0)
+                archives.push_back(name.substr(0, name.size() - std::strlen(PENDING_SUFFIX)));
+        }
+        for (const std::string& archive : archives) {
+            RecordLock archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+            Snapshot::WriteScope writeScope;
+            finishPending(archive);
+        }
+    }
+    for (const std::string& archive : StorageLayout::archiveSegments()) {
+        BlockReader reader(archive);
+        if (reader.valid() && FileFormat::layout(archive).current)
+            continue;
+        RecordLock archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+        Snapshot::WriteScope writeScope;
+        convertArchive(archive);
+    }
+}
+
+/**********************************************
+ * Function: partition
+ * Description:
+ * Splits an archive into one archive per product inside directory. Each keeps
+ * the change ID order of the archive. Called by the migration with the archive
+ * sentinel held exclusive.
+ * Parameters:
+ * - archive: The archive of the single file
+ * - directory: The archive directory of the new segments
+ * Returns: int - The number of change items copied, or -1 if an archive could not be read or written
+ **********************************************/
+int ItemArchive::partition(const std::string& archive, const std::string& directory) {
+    if (!convertArchive(archive))
+        return -1;
+    std::map<std::string, std::unique_ptr<BlockWriter>> segments;
+    int copied = 0;
+    if (!readArchive(archive, [&](const ChangeItem& changeItem) {
+            std::string product = changeItem.getProductName();
+            std::unique_ptr<BlockWriter>& writer = segments[product];
+            if (!writer)
+                writer = std::make_unique<BlockWriter>(StorageLayout::segmentPath(directory, ITEM_SEGMENT_PREFIX, product), sizeof(ChangeItem));
+            writer->append(&changeItem, changeItem.getChangeId());
+            copied++;
+        }))
+        return -1;
+    for (auto& segment : segments) {
+        if (!segment.second->close() ||
+            !FileFormat::stamp(StorageLayout::segmentPath(directory, ITEM_SEGMENT_PREFIX, segment.first),
+                               FileFormat::currentLayout(RecordKind::CHANGE_ITEM).version))
+            return -1;
+    }
+    return copied;
+}
+
+/**********************************************
+ * Function: printStats
+ * Description: Prints each archive's blocks, its size against the size of its
+ *              records, and how fast a full read decompresses it.
+ * Parameters:
+ * - out: Where the statistics are printed
+ **********************************************/
+void ItemArchive::printStats(std::ostream& out) {
+    ReadScope scope;
+    BlockStats total;
+    for (const std::string& archive : StorageLayout::archiveSegments()) {
+        BlockReader reader(archive);
+        if (!reader.valid()) {
+            out << archive << ": not a block file; it is rewritten as one at the next start" << '\n';
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        bool intact = reader.scan([](const char*, size_t) {});
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        BlockStats stats = reader.stats();
+        out << archive << ": " << stats.records << " items in " << stats.blocks << (stats.blocks == 1 ? " block, " : " blocks, ");
+        describe(out, stats);
+        double mebibytes = static_cast<double>(stats.rawBytes) / 1048576.0;
+        out << "; read in " << std::fixed << std::setprecision(2) << seconds * 1000.0 << " ms (" << std::setprecision(1)
+            << (seconds > 0 ? mebibytes / seconds : 0.0) << " MiB/s)" << std::defaultfloat << (intact ? "" : "; damaged blocks skipped") << '\n';
+        total.records += stats.records;
+        total.rawBytes += stats.rawBytes;
+        total.storedBytes += stats.storedBytes;
+        total.blocks += stats.blocks;
+    }
+    out << "Archived " << total.records << " change items in " << total.blocks << (total.blocks == 1 ? " block, " : " blocks, ");
+    describe(out, total);
+    out << "." << std::endl;
+}
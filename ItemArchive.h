@@ -0,0 +1,112 @@
+/**********************************************
+ * ItemArchive Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Archives are compressed block files; added partition and printStats.
+ *--------------------------------
+ * Purpose:
+ * This module keeps closed change items out of the files that scans and updates
+ * read. Items that have been DONE or CANCELLED for longer than a configurable age
+ * are moved out of their item file into its archive, a file of the same name in
+ * the archive directory next to it ("ChangeItem.txt" has "archive/ChangeItem.txt",
+ * a segment "partitions/archive/ChangeItem-<product>.txt"). The item file then
+ * holds little more than the open items, so every scan of it, and every lookup
+ * that scans it, costs time proportional to the open items.
+ *
+ * An archive holds current-version records sorted by change ID, in compressed
+ * blocks of a block file (see BlockFile) with a header like any data file, and is
+ * never written in place: a lookup that misses the item files finds an archived
+ * item through the block index, and an archived item about to be updated is first
+ * moved back into its item file (restored), since reopened items belong with the
+ * open ones. Closed items are rarely read and compress well, so the archives take
+ * a fraction of the space their records would.
+ *
+ * Moving items rewrites both files, so it shuts out the writers of the item file
+ * and takes the archive sentinel exclusive, which waits for every open snapshot
+ * and every archive reader. The new archive is written to a complete copy first
+ * and renamed into place, then the item file is compacted in place, front to back,
+ * which never overwrites a record before it has been copied. A move cut short
+ * leaves the copy, which is finished by the next process that starts, or an item
+ * both archived and still in the item file, where the item file's copy wins until
+ * the next move drops the other.
+ **********************************************/
+#ifndef ITEMARCHIVE_H
+#define ITEMARCHIVE_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ChangeItem.h"
+#include "FileLock.h"
+
+//=============================
+// Constants
+//=============================
+const long long ARCHIVE_LOCK_OFFSET = 0x7FFFFFFF00000006LL;  // ChangeItem.txt sentinel: shared while reading archives, exclusive while moving items
+const int DEFAULT_ARCHIVE_AGE_DAYS = 90;                      // Days an item stays closed before it is archived
+
+//=============================
+// Class Declaration
+//=============================
+
+class ItemArchive {
+public:
+    // Held while reading the archives, or while scanning item files and archives
+    // together, so no item moves between them meanwhile. Every Snapshot holds one.
+    class ReadScope {
+    public:
+        ReadScope();
+    private:
+        RecordLock archiveLock;
+    };
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool find(int changeId, ChangeItem& changeItem, std::string& archive);
+    // Description: Looks a change ID up in every archive by binary search. The caller holds a ReadScope.
+    // Parameters:
+    // - changeId: The change ID to find.
+    // - changeItem: Receives the archived record.
+    // - archive: Receives the archive holding it.
+    // Returns: bool - True if the change item is archived; a record failing its checksum is not returned.
+
+    //----------------------------------------------------------
+    static int restore(const std::string& archive, const std::vector<int>& changeIds);
+    // Description: Moves archived change items back to the end of the item file of their archive,
+    //              e.g. before they are updated. Called without any lock held.
+    // Returns: int - The number of change items moved, 0 if none of them is archived there any
+    //          more, or -1 if the archive could not be rewritten.
+
+    //----------------------------------------------------------
+    static int restoreMatching(const std::vector<std::string>& archives, const std::function<bool(const ChangeItem&)>& wanted);
+    // Description: Restores every archived change item of the archives that wanted accepts.
+    // Returns: int - The number of change items moved, or -1 on failure.
+
+    //----------------------------------------------------------
+    static long long archiveClosed(int ageDays, std::ostream& out);
+    // Description: Moves the change items closed for at least ageDays out of every item file into
+    //              its archive, and prints what it did. Can run while the tracker is in use.
+    // Returns: long long - The number of change items moved, or -1 if a file could not be rewritten.
+
+    //----------------------------------------------------------
+    static void recover();
+    // Description: Finishes the archives whose move was cut short, and rewrites archives from before
+    //              archives were block files as block files. Runs at startup.
+
+    //----------------------------------------------------------
+    static int partition(const std::string& archive, const std::string& directory);
+    // Description: Splits the archive of the single file into the archive of each product's segment
+    //              inside directory. Used when migrating to the partitioned layout.
+    // Returns: int - The number of change items copied, or -1 if an archive could not be read or written.
+
+    //----------------------------------------------------------
+    static void printStats(std::ostream& out);
+    // Description: Prints the blocks, stored size, compression ratio and read speed of every archive.
+};
+
+#endif // ITEMARCHIVE_H
@@ -0,0 +1,725 @@
+/**********************************************
+ * ItemHistory Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: record is traced as a span.
+ * - 2026-10-19: printCycleTimes is timed for the metrics endpoint.
+ *--------------------------------
+ * Purpose:
+ * This module implements the transition history. An entry is three varints and a
+ * byte: the change ID, the distance in bytes back to the item's previous entry (0
+ * for its first), the time (absolute for the first entry, otherwise the zigzag
+ * encoded difference to the previous one), and the kind with its value. The index
+ * starts with the history length it covers, followed by one slot per change ID
+ * holding the offset and time of the item's latest entry.
+ *
+ * An item's first entry also stores the item's product, so the history alone is
+ * enough to rebuild everything else.
+ *
+ * Appends serialize on the append sentinel lock of the history file. An append
+ * writes the entry, then the slot, then the covered length, so after a crash the
+ * next writer finds the uncovered entries and replays them into the index; a slot
+ * that already points at a replayed entry is left alone. The sketch file records
+ * how much of the history it has folded in, and a reader folds the rest under the
+ * same lock before answering.
+ **********************************************/
+#include "ItemHistory.h"
+#include "ChangeItem.h"
+#include "FileLock.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+//================================
+// Constants
+//================================
+static const int MAX_ENTRY_BYTES = 48;                      // Three varints, the kind byte and a product name
+static const long long FOLD_CHUNK_BYTES = 1 << 20;          // History read per step while folding
+static const long long INDEX_HEADER_SIZE = sizeof(long long);
+static const double SKETCH_ACCURACY = 0.02;                 // Relative error of a percentile
+static const double SKETCH_GAMMA = (1 + SKETCH_ACCURACY) / (1 - SKETCH_ACCURACY);
+
+static const char* STATE_NAMES[] = {"ASSESSED", "INPROGRESS", "DONE", "CANCELLED"};
+static const char* METRIC_NAMES[] = {"lead time", "cycle time", "time assessed", "time in progress"};
+
+// One decoded history entry, with the time still relative unless back is 0.
+// An item's first entry also carries the item's product.
+struct HistoryEntry {
+    uint64_t changeId;
+    uint64_t back;
+    int64_t time;
+    uint8_t kindValue;
+    std::string product;
+};
+
+// The latest entry of one change ID
+struct IndexSlot {
+    long long offsetPlusOne;   // 0 if the item has no history
+    long long timestamp;
+};
+
+// The sketch of one metric of one product
+struct SketchRecord {
+    char product[11];
+    uint8_t metric;
+    uint32_t reserved;
+    uint64_t count;
+    uint32_t buckets[SKETCH_BUCKETS];
+};
+
+//================================
+// Encoding Helpers
+//================================
+
+static size_t putVarint(uint64_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+static size_t getVarint(const uint8_t* in, size_t available, uint64_t& value) {
+    value = 0;
+    for (size_t i = 0; i < available && i < 10; i++) {
+        value |= static_cast<uint64_t>(in[i] & 0x7F) << (7 * i);
+        if ((in[i] & 0x80) == 0)
+            return i + 1;
+    }
+    return 0;
+}
+
+static uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**********************************************
+ * Function: encodeEntry / decodeEntry
+ * Description: Converts an entry to and from its bytes. decodeEntry returns 0 if
+ *              the bytes end before the entry does.
+ **********************************************/
+static size_t encodeEntry(const HistoryEntry& entry, uint8_t* out) {
+    size_t length = putVarint(entry.changeId, out);
+    length += putVarint(entry.back, out + length);
+    length += putVarint(zigzag(entry.time), out + length);
+    out[length++] = entry.kindValue;
+    if (entry.back == 0) {
+        size_t nameLength = std::min<size_t>(entry.product.size(), 10);
+        out[length++] = static_cast<uint8_t>(nameLength);
+        memcpy(out + length, entry.product.data(), nameLength);
+        length += nameLength;
+    }
+    return length;
+}
+
+static size_t decodeEntry(const uint8_t* in, size_t available, HistoryEntry& entry) {
+    uint64_t time;
+    size_t length = getVarint(in, available, entry.changeId);
+    size_t used = length ? getVarint(in + length, available - length, entry.back) : 0;
+    length = used ? length + used : 0;
+    used = length ? getVarint(in + length, available - length, time) : 0;
+    length = used ? length + used : 0;
+    if (length == 0 || length >= available)
+        return 0;
+    entry.time = unzigzag(time);
+    entry.kindValue = in[length++];
+    entry.product.clear();
+    if (entry.back == 0) {
+        if (length >= available || length + 1 + in[length] > available)
+            return 0;
+        entry.product.assign(reinterpret_cast<const char*>(in + length + 1), in[length]);
+        length += 1 + in[length];
+    }
+    return length;
+}
+
+//================================
+// Index Helpers
+//================================
+
+static std::fstream openIndex() {
+    std::fstream index(HISTORY_INDEX_FILE, std::ios::in | std::ios::out | std::ios::binary);
+    if (index.is_open())
+        return index;
+    std::ofstream(HISTORY_INDEX_FILE, std::ios::binary | std::ios::app).close();
+    return std::fstream(HISTORY_INDEX_FILE, std::ios::in | std::ios::out | std::ios::binary);
+}
+
+static long long readCovered(std::fstream& index) {
+    long long covered = 0;
+    index.seekg(0);
+    if (!index.read(reinterpret_cast<char*>(&covered), INDEX_HEADER_SIZE)) {
+        index.clear();
+        return 0;
+    }
+    return covered;
+}
+
+static void writeCovered(std::fstream& index, long long covered) {
+    index.seekp(0);
+    index.write(reinterpret_cast<const char*>(&covered), INDEX_HEADER_SIZE);
+}
+
+template <typename Stream>
+static IndexSlot readSlot(Stream& index, uint64_t changeId) {
+    IndexSlot slot{0, 0};
+    index.seekg(INDEX_HEADER_SIZE + static_cast<long long>(changeId * sizeof(IndexSlot)));
+    if (!index.read(reinterpret_cast<char*>(&slot), sizeof(IndexSlot))) {
+        index.clear();
+        slot = {0, 0};
+    }
+    return slot;
+}
+
+static void writeSlot(std::fstream& index, uint64_t changeId, const IndexSlot& slot) {
+    index.seekp(INDEX_HEADER_SIZE + static_cast<long long>(changeId * sizeof(IndexSlot)));
+    index.write(reinterpret_cast<const char*>(&slot), sizeof(IndexSlot));
+}
+
+/**********************************************
+ * Function: replayTail
+ * Description:
+ * Brings the index up to date with entries a crashed writer appended but did not
+ * finish indexing, and cuts off a partial entry at the end of the history.
+ * Called with the history lock held.
+ * Parameters:
+ * - index: The open index
+ * Returns: long long - The length of the history.
+ **********************************************/
+static long long replayTail(std::fstream& index) {
+    long long covered = readCovered(index);
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(HISTORY_FILE, error);
+    long long end = error ? 0 : static_cast<long long>(size);
+    if (covered >= end) {
+        if (covered > end)
+            writeCovered(index, end);
+        return end;
+    }
+
+    std::ifstream history(HISTORY_FILE, std::ios::binary);
+    history.seekg(covered);
+    std::vector<uint8_t> tail(static_cast<size_t>(end - covered));
+    history.read(reinterpret_cast<char*>(tail.data()), static_cast<std::streamsize>(tail.size()));
+
+    size_t position = 0;
+    HistoryEntry entry;
+    while (size_t used = decodeEntry(tail.data() + position, tail.size() - position, entry)) {
+        long long offset = covered + static_cast<long long>(position);
+        IndexSlot slot = readSlot(index, entry.changeId);
+        if (slot.offsetPlusOne != offset + 1)
+            writeSlot(index, entry.changeId, {offset + 1, entry.back == 0 ? entry.time : slot.timestamp + entry.time});
+        position += used;
+    }
+    end = covered + static_cast<long long>(position);
+    if (position < tail.size())
+        std::filesystem::resize_file(HISTORY_FILE, static_cast<uintmax_t>(end), error);
+    writeCovered(index, end);
+    return end;
+}
+
+/**********************************************
+ * Function: readChain
+ * Description:
+ * Walks an item's entries from the given one back to its first, then returns them
+ * oldest first with absolute times and the state and priority in force after each.
+ * Parameters:
+ * - history: The open history file
+ * - offset: The entry to start from, normally the item's latest
+ * - chain: Receives the transitions
+ * - product: Receives the product stored in the item's first entry
+ * Returns: bool - False if an entry could not be read.
+ **********************************************/
+static bool readChain(std::ifstream& history, long long offset, std::vector<Transition>& chain, std::string& product) {
+    chain.clear();
+    std::vector<HistoryEntry> entries;
+    uint8_t bytes[MAX_ENTRY_BYTES];
+    for (;;) {
+        history.seekg(offset);
+        history.read(reinterpret_cast<char*>(bytes), MAX_ENTRY_BYTES);
+        size_t available = static_cast<size_t>(history.gcount());
+        history.clear();
+        HistoryEntry entry;
+        if (decodeEntry(bytes, available, entry) == 0)
+            return false;
+        entries.push_back(entry);
+        if (entry.back == 0)
+            break;
+        if (entry.back > static_cast<uint64_t>(offset))
+            return false;
+        offset -= static_cast<long long>(entry.back);
+    }
+    product = entries.back().product;
+
+    // Times are summed up from the first entry, and the value byte is decoded into
+    // state and priority, carrying the other one forward
+    long long time = 0;
+    int state = -1;
+    int priority = -1;
+    for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+        time = entry->back == 0 ? entry->time : time + entry->time;
+        uint8_t kind = entry->kindValue >> 6;
+        int value = entry->kindValue & 0x3F;
+        if (kind == Transition::CREATED) {
+            state = value & 0x3;
+            priority = value >> 2;
+        } else if (kind == Transition::STATE) {
+            state = value;
+        } else {
+            priority = value;
+        }
+        chain.push_back({time, kind, state, priority});
+    }
+    return true;
+}
+
+//================================
+// Sketch Helpers
+//================================
+
+/**********************************************
+ * Function: bucketOf / bucketValue
+ * Description:
+ * Maps a duration to its logarithmic bucket and a bucket back to the value it
+ * stands for. Bucket 0 holds durations under a second; bucket k > 0 holds
+ * (gamma^(k-2), gamma^(k-1)], represented by its midpoint in relative terms.
+ **********************************************/
+static int bucketOf(long long seconds) {
+    if (seconds < 1)
+        return 0;
+    int bucket = 1 + static_cast<int>(std::ceil(std::log(static_cast<double>(seconds)) / std::log(SKETCH_GAMMA)));
+    return std::min(bucket, SKETCH_BUCKETS - 1);
+}
+
+static long long bucketValue(int bucket) {
+    if (bucket == 0)
+        return 0;
+    return std::llround(2 * std::pow(SKETCH_GAMMA, bucket - 1) / (SKETCH_GAMMA + 1));
+}
+
+/**********************************************
+ * Function: loadSketches / saveSketches
+ * Description:
+ * Read and replace the sketch file: the history length folded into the sketches,
+ * followed by one SketchRecord per product and metric. The file is replaced by a
+ * rename, so readers without the lock see either the old or the new sketches.
+ **********************************************/
+static std::vector<SketchRecord> loadSketches(long long& folded) {
+    std::vector<SketchRecord> sketches;
+    folded = 0;
+    std::ifstream in(SKETCH_FILE, std::ios::binary);
+    if (!in.read(reinterpret_cast<char*>(&folded), sizeof(folded)))
+        return sketches;
+    SketchRecord sketch;
+    while (in.read(reinterpret_cast<char*>(&sketch), sizeof(SketchRecord)))
+        sketches.push_back(sketch);
+    return sketches;
+}
+
+static void saveSketches(long long folded, const std::vector<SketchRecord>& sketches) {
+    std::string temporary = std::string(SKETCH_FILE) + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&folded), sizeof(folded));
+    out.write(reinterpret_cast<const char*>(sketches.data()), static_cast<std::streamsize>(sketches.size() * sizeof(SketchRecord)));
+    out.close();
+    std::error_code error;
+    if (!out.fail())
+        std::filesystem::rename(temporary, SKETCH_FILE, error);
+}
+
+/**********************************************
+ * Function: findSketch
+ * Description: Finds a product's sketch for a metric, optionally creating it.
+ * Returns: SketchRecord* - The sketch, or nullptr if there is none.
+ **********************************************/
+static SketchRecord* findSketch(std::vector<SketchRecord>& sketches, const std::string& product, int metric, bool create) {
+    for (SketchRecord& sketch : sketches)
+        if (sketch.metric == metric && strncmp(sketch.product, product.c_str(), sizeof(sketch.product)) == 0)
+            return &sketch;
+    if (!create)
+        return nullptr;
+    SketchRecord created{};
+    strncpy(created.product, product.c_str(), sizeof(created.product) - 1);
+    created.metric = static_cast<uint8_t>(metric);
+    sketches.push_back(created);
+    return &sketches.back();
+}
+
+/**********************************************
+ * Function: addSamples
+ * Description:
+ * Feeds the sketches with the durations a state change completes: the stay in the
+ * state being left, and lead and cycle time when the item becomes DONE.
+ * Parameters:
+ * - sketches: The sketches to update
+ * - product: The item's product
+ * - chain: The item's transitions, ending with the state change
+ **********************************************/
+static void addSamples(std::vector<SketchRecord>& sketches, const std::string& product, const std::vector<Transition>& chain) {
+    const Transition& change = chain.back();
+    int previous = -1;
+    long long since = -1;
+    long long created = -1;
+    long long started = -1;
+    for (size_t i = 0; i + 1 < chain.size(); i++) {
+        const Transition& transition = chain[i];
+        if (transition.kind == Transition::PRIORITY)
+            continue;
+        if (transition.kind == Transition::CREATED)
+            created = transition.timestamp;
+        if (transition.state == ChangeItem::INPROGRESS && started < 0)
+            started = transition.timestamp;
+        previous = transition.state;
+        since = transition.timestamp;
+    }
+    if (previous == change.state)
+        return;
+
+    auto add = [&](CycleMetric metric, long long from) {
+        SketchRecord* sketch = findSketch(sketches, product, metric, true);
+        sketch->buckets[bucketOf(std::max(0LL, change.timestamp - from))]++;
+        sketch->count++;
+    };
+    if (previous == ChangeItem::ASSESSED)
+        add(TIME_IN_ASSESSED, since);
+    else if (previous == ChangeItem::INPROGRESS)
+        add(TIME_IN_INPROGRESS, since);
+    if (change.state == ChangeItem::DONE) {
+        if (created >= 0)
+            add(LEAD_TIME, created);
+        if (started >= 0)
+            add(CYCLE_TIME, started);
+    }
+}
+
+/**********************************************
+ * Function: foldSketches
+ * Description:
+ * Adds the state changes appended to the history since the last fold to the
+ * sketches. Each change only needs its own item's chain, so the work is
+ * proportional to what is new, never to the whole history.
+ **********************************************/
+static void foldSketches() {
+    RecordLock historyLock(HISTORY_FILE, APPEND_LOCK_OFFSET, 1, true);
+    std::fstream index = openIndex();
+    long long end = replayTail(index);
+    long long folded;
+    std::vector<SketchRecord> sketches = loadSketches(folded);
+    if (folded >= end)
+        return;
+
+    std::ifstream history(HISTORY_FILE, std::ios::binary);
+    std::ifstream chainReader(HISTORY_FILE, std::ios::binary);
+    std::vector<uint8_t> chunk;
+    std::vector<Transition> chain;
+    std::string product;
+    long long position = folded;
+    while (position < end) {
+        chunk.resize(static_cast<size_t>(std::min<long long>(end - position, FOLD_CHUNK_BYTES)));
+        history.seekg(position);
+        if (!history.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size())))
+            break;
+        size_t used = 0;
+        HistoryEntry entry;
+        while (size_t length = decodeEntry(chunk.data() + used, chunk.size() - used, entry)) {
+            if (entry.kindValue >> 6 == Transition::STATE && readChain(chainReader, position + static_cast<long long>(used), chain, product))
+                addSamples(sketches, product, chain);
+            used += length;
+        }
+        if (used == 0)
+            break;
+        position += static_cast<long long>(used);
+    }
+    saveSketches(position, sketches);
+}
+
+/**********************************************
+ * Function: estimate
+ * Description: Walks a sketch to the bucket holding the requested rank.
+ **********************************************/
+static long long estimate(const SketchRecord& sketch, double quantile) {
+    uint64_t rank = static_cast<uint64_t>(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(sketch.count - 1));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < SKETCH_BUCKETS; bucket++) {
+        seen += sketch.buckets[bucket];
+        if (seen > rank)
+            return bucketValue(bucket);
+    }
+    return bucketValue(SKETCH_BUCKETS - 1);
+}
+
+//================================
+// Formatting Helpers
+//================================
+
+static std::string formatTime(long long timestamp) {
+    char text[32];
+    std::time_t time = static_cast<std::time_t>(timestamp);
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", std::localtime(&time));
+    return text;
+}
+
+static std::string formatDuration(long long seconds) {
+    std::ostringstream text;
+    if (seconds >= 86400)
+        text << seconds / 86400 << "d " << seconds % 86400 / 3600 << "h";
+    else if (seconds >= 3600)
+        text << seconds / 3600 << "h " << seconds % 3600 / 60 << "m";
+    else if (seconds >= 60)
+        text << seconds / 60 << "m " << seconds % 60 << "s";
+    else
+        text << seconds << "s";
+    return text.str();
+}
+
+/**********************************************
+ * Function: parseTime
+ * Description: Parses "YYYY-MM-DDTHH:MM:SS", or "YYYY-MM-DD" meaning the end of that
+ *              day, as local time.
+ * Returns: long long - Seconds since the epoch, or -1 if the text is not a time.
+ **********************************************/
+static long long parseTime(const std::string& text) {
+    std::tm parts{};
+    bool dayOnly = text.find('T') == std::string::npos;
+    std::istringstream input(text);
+    input >> std::get_time(&parts, dayOnly ? "%Y-%m-%d" : "%Y-%m-%dT%H:%M:%S");
+    if (input.fail())
+        return -1;
+    if (dayOnly) {
+        parts.tm_hour = 23;
+        parts.tm_min = 59;
+        parts.tm_sec = 59;
+    }
+    parts.tm_isdst = -1;
+    return static_cast<long long>(std::mktime(&parts));
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: record
+ * Description:
+ * Appends one transition under the history lock: repairs the index if a writer
+ * crashed, links the entry to the item's previous one and updates the item's slot.
+ * The sketches are left to the next reader, which folds the new entries in.
+ * Parameters:
+ * - changeId, product: The change item
+ * - kind, state, priority: The transition
+ * - timestamp: When it happened
+ * - skipIfRecorded: Skip a transition the item already has at this time
+ **********************************************/
+void ItemHistory::record(int changeId, const std::string& product, Transition::Kind kind, int state, int priority,
+                         long long timestamp, bool skipIfRecorded) {
+    Trace::Span span("item_history.record", "history");
+    if (changeId < 0)
+        return;
+
+    RecordLock historyLock(HISTORY_FILE, APPEND_LOCK_OFFSET, 1, true);
+    std::fstream index = openIndex();
+    long long end = replayTail(index);
+    IndexSlot slot = readSlot(index, static_cast<uint64_t>(changeId));
+    std::vector<Transition> chain;
+    std::string recordedProduct;
+    if (skipIfRecorded && slot.offsetPlusOne != 0) {
+        std::ifstream history(HISTORY_FILE, std::ios::binary);
+        readChain(history, slot.offsetPlusOne - 1, chain, recordedProduct);
+        for (auto transition = chain.rbegin(); transition != chain.rend() && transition->timestamp >= timestamp; ++transition) {
+            if (transition->timestamp == timestamp && transition->kind == kind &&
+                (kind == Transition::PRIORITY || transition->state == state) &&
+                (kind == Transition::STATE || transition->priority == priority))
+                return;
+        }
+    }
+
+    HistoryEntry entry;
+    entry.changeId = static_cast<uint64_t>(changeId);
+    entry.back = slot.offsetPlusOne == 0 ? 0 : static_cast<uint64_t>(end - (slot.offsetPlusOne - 1));
+    entry.time = slot.offsetPlusOne == 0 ? timestamp : timestamp - slot.timestamp;
+    int value = kind == Transition::CREATED ? (state | priority << 2) : kind == Transition::STATE ? state : priority;
+    entry.kindValue = static_cast<uint8_t>(kind << 6 | (value & 0x3F));
+    entry.product = product;
+
+    uint8_t bytes[MAX_ENTRY_BYTES];
+    size_t length = encodeEntry(entry, bytes);
+    std::ofstream history(HISTORY_FILE, std::ios::binary | std::ios::app);
+    if (!history.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(length))) {
+        std::cerr << "Failed to record the history of ChangeItem " << changeId << "." << std::endl;
+        return;
+    }
+    history.close();
+
+    writeSlot(index, entry.changeId, {end + 1, timestamp});
+    writeCovered(index, end + static_cast<long long>(length));
+}
+
+/**********************************************
+ * Function: transitions
+ * Description: Returns the item's transitions, oldest first.
+ * Parameters:
+ * - changeId: The change item
+ * - history: Receives the transitions
+ * Returns: bool - False if no history is kept for the item.
+ **********************************************/
+bool ItemHistory::transitions(int changeId, std::vector<Transition>& history) {
+    if (changeId < 0)
+        return false;
+    std::ifstream index(HISTORY_INDEX_FILE, std::ios::binary);
+    IndexSlot slot = readSlot(index, static_cast<uint64_t>(changeId));
+    if (slot.offsetPlusOne == 0)
+        return false;
+    std::ifstream file(HISTORY_FILE, std::ios::binary);
+    std::string product;
+    return readChain(file, slot.offsetPlusOne - 1, history, product);
+}
+
+/**********************************************
+ * Function: asOf
+ * Description: Finds the last transition at or before the given time.
+ * Parameters:
+ * - changeId: The change item
+ * - timestamp: The time, in seconds since the epoch
+ * - state, priority: Receive the values in force at that time
+ * Returns: bool - False if the item did not exist then, or has no history.
+ **********************************************/
+bool ItemHistory::asOf(int changeId, long long timestamp, int& state, int& priority) {
+    std::vector<Transition> history;
+    if (!transitions(changeId, history))
+        return false;
+    auto after = std::upper_bound(history.begin(), history.end(), timestamp,
+                                  [](long long time, const Transition& transition) { return time < transition.timestamp; });
+    if (after == history.begin() || (after - 1)->state < 0)
+        return false;
+    state = (after - 1)->state;
+    priority = (after - 1)->priority;
+    return true;
+}
+
+/**********************************************
+ * Function: percentile
+ * Description: Folds new history into the sketches and estimates from the product's one.
+ * Parameters:
+ * - product: The product
+ * - metric: The duration
+ * - quantile: Between 0 and 1, e.g. 0.9 for p90
+ * - seconds: Receives the estimate
+ * - count: Receives the number of durations measured
+ * Returns: bool - False if nothing was measured for the product yet.
+ **********************************************/
+bool ItemHistory::percentile(const std::string& product, CycleMetric metric, double quantile, long long& seconds, long long& count) {
+    foldSketches();
+    long long folded;
+    std::vector<SketchRecord> sketches = loadSketches(folded);
+    SketchRecord* sketch = findSketch(sketches, product, metric, false);
+    if (sketch == nullptr || sketch->count == 0)
+        return false;
+    count = static_cast<long long>(sketch->count);
+    seconds = estimate(*sketch, quantile);
+    return true;
+}
+
+/**********************************************
+ * Function: sketchedProducts
+ * Description: Returns the products that have sketches, in file order.
+ **********************************************/
+std::vector<std::string> ItemHistory::sketchedProducts() {
+    foldSketches();
+    long long folded;
+    std::vector<std::string> products;
+    for (const SketchRecord& sketch : loadSketches(folded)) {
+        std::string product(sketch.product, strnlen(sketch.product, sizeof(sketch.product)));
+        if (std::find(products.begin(), products.end(), product) == products.end())
+            products.push_back(product);
+    }
+    return products;
+}
+
+/**********************************************
+ * Function: printHistory
+ * Description: Prints an item's transitions and its values at the given time.
+ * Parameters:
+ * - changeId: The change item
+ * - when: The time to report, or null for now
+ * Returns: int - The process exit status.
+ **********************************************/
+int ItemHistory::printHistory(int changeId, const char* when) {
+    long long timestamp = when != nullptr ? parseTime(when) : static_cast<long long>(std::time(nullptr));
+    if (timestamp < 0) {
+        std::cerr << "Expected a time like 2026-10-19 or 2026-10-19T14:30:00." << std::endl;
+        return 1;
+    }
+    std::vector<Transition> history;
+    if (!transitions(changeId, history)) {
+        std::cout << "No history is kept for ChangeItem " << changeId << "." << std::endl;
+        return 1;
+    }
+
+    auto stateName = [](int state) { return state >= 0 && state < 4 ? STATE_NAMES[state] : "?"; };
+    std::cout << "ChangeItem " << changeId << std::endl;
+    for (const Transition& transition : history) {
+        std::cout << "  " << formatTime(transition.timestamp) << " ";
+        if (transition.kind == Transition::CREATED)
+            std::cout << "created " << stateName(transition.state) << " priority " << transition.priority << std::endl;
+        else if (transition.kind == Transition::STATE)
+            std::cout << "state " << stateName(transition.state) << std::endl;
+        else
+            std::cout << "priority " << transition.priority << std::endl;
+    }
+
+    int state, priority;
+    std::cout << "As of " << formatTime(timestamp) << ": ";
+    if (asOf(changeId, timestamp, state, priority))
+        std::cout << stateName(state) << ", priority " << priority << std::endl;
+    else
+        std::cout << "not created yet" << std::endl;
+    return 0;
+}
+
+/**********************************************
+ * Function: printCycleTimes
+ * Description: Prints p50, p90 and p99 of every metric from the sketches.
+ * Parameters:
+ * - product: The product, or "" for every sketched product
+ * Returns: int - The process exit status.
+ **********************************************/
+int ItemHistory::printCycleTimes(const std::string& product) {
+    Metrics::Timer timer(Metrics::REPORT_CYCLE_TIMES);
+    std::vector<std::string> products = product.empty() ? sketchedProducts() : std::vector<std::string>{product};
+    long long folded;
+    std::vector<SketchRecord> sketches = loadSketches(folded);
+    if (products.empty()) {
+        std::cout << "No durations have been measured yet." << std::endl;
+        return 0;
+    }
+
+    std::cout << std::left << std::setw(12) << "Product" << std::setw(18) << "Metric" << std::setw(8) << "Count"
+              << std::setw(10) << "p50" << std::setw(10) << "p90" << "p99" << std::endl;
+    for (const std::string& name : products) {
+        for (int metric = 0; metric < CYCLE_METRIC_COUNT; metric++) {
+            const SketchRecord* sketch = findSketch(sketches, name, metric, false);
+            if (sketch == nullptr || sketch->count == 0)
+                continue;
+            std::cout << std::setw(12) << name << std::setw(18) << METRIC_NAMES[metric] << std::setw(8) << sketch->count
+                      << std::setw(10) << formatDuration(estimate(*sketch, 0.5)) << std::setw(10)
+                      << formatDuration(estimate(*sketch, 0.9)) << formatDuration(estimate(*sketch, 0.99)) << std::endl;
+        }
+    }
+    return 0;
+}
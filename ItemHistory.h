@@ -0,0 +1,122 @@
+/**********************************************
+ * ItemHistory Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module keeps the history of every change item: when it was created, and
+ * every later change of its state or priority, with the time it happened. The
+ * records themselves only hold the current values, so this is what answers "what
+ * state was item X in on date D" and what lead and cycle times are computed from.
+ *
+ * The history is an append-only file of small delta-encoded entries. Each entry
+ * points back to the previous entry of the same item and stores its time as the
+ * difference to that entry, so a typical entry takes six to ten bytes. An index
+ * holds the latest entry of every change ID, which makes one item's history a walk
+ * along its own chain, never a scan of the file.
+ *
+ * Durations are kept in quantile sketches per product: lead time (created to
+ * done), cycle time (first in progress to done) and time spent assessed or in
+ * progress. A sketch is a fixed array of logarithmic buckets that answers any
+ * percentile to within two percent. Writers only append to the history; a reader
+ * asking for percentiles first folds in the state changes appended since the last
+ * fold, so neither side ever rescans the whole history.
+ **********************************************/
+#ifndef ITEMHISTORY_H
+#define ITEMHISTORY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const char* const HISTORY_FILE = "ChangeItem.history";       // The delta-encoded entries
+const char* const HISTORY_INDEX_FILE = "ChangeItem.hidx";    // Latest entry per change ID
+const char* const SKETCH_FILE = "ChangeItem.sketch";         // Quantile sketches per product and metric
+const int SKETCH_BUCKETS = 512;                              // Covers one second to beyond ten years
+
+//=============================
+// Record Types
+//=============================
+
+// One step of an item's history, with the values in force after it.
+struct Transition {
+    enum Kind : uint8_t {
+        CREATED,
+        STATE,
+        PRIORITY
+    };
+
+    long long timestamp;    // Seconds since the epoch
+    uint8_t kind;
+    int state;
+    int priority;
+};
+
+// The durations the sketches track.
+enum CycleMetric {
+    LEAD_TIME,              // Created to DONE
+    CYCLE_TIME,             // First INPROGRESS to DONE
+    TIME_IN_ASSESSED,       // Each stay in ASSESSED
+    TIME_IN_INPROGRESS,     // Each stay in INPROGRESS
+    CYCLE_METRIC_COUNT
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class ItemHistory {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static void record(int changeId, const std::string& product, Transition::Kind kind, int state, int priority,
+                       long long timestamp, bool skipIfRecorded = false);
+    // Description: Appends a transition to the item's history. Called under the item's
+    //              record lock, so one item's transitions are recorded in order.
+    // Parameters:
+    // - changeId, product: The change item
+    // - kind: What changed; state is used by CREATED and STATE, priority by CREATED and PRIORITY
+    // - timestamp: When it happened, in seconds since the epoch
+    // - skipIfRecorded: Do nothing if the item already has this transition at this time,
+    //                   for callers that may replay transitions
+
+    //----------------------------------------------------------
+    static bool transitions(int changeId, std::vector<Transition>& history);
+    // Description: Returns the item's transitions, oldest first.
+    // Returns: bool - False if no history is kept for the item.
+
+    //----------------------------------------------------------
+    static bool asOf(int changeId, long long timestamp, int& state, int& priority);
+    // Description: Finds the item's state and priority at the given time.
+    // Returns: bool - False if the item did not exist then, or has no history.
+
+    //----------------------------------------------------------
+    static bool percentile(const std::string& product, CycleMetric metric, double quantile, long long& seconds, long long& count);
+    // Description: Folds new state changes into the sketches, then estimates a percentile
+    //              (0 to 1) of a metric from the product's sketch.
+    // Returns: bool - False if nothing was measured for the product yet.
+
+    //----------------------------------------------------------
+    static std::vector<std::string> sketchedProducts();
+    // Description: Returns the products that have sketches, in file order.
+
+    //----------------------------------------------------------
+    static int printHistory(int changeId, const char* when);
+    // Description: Prints an item's history and its state and priority at "YYYY-MM-DD" or
+    //              "YYYY-MM-DDTHH:MM:SS" local time, or now if when is null.
+    // Returns: int - The process exit status.
+
+    //----------------------------------------------------------
+    static int printCycleTimes(const std::string& product);
+    // Description: Prints p50, p90 and p99 of every metric for one product, or for all
+    //              sketched products if product is empty.
+    // Returns: int - The process exit status.
+};
+
+#endif // ITEMHISTORY_H
@@ -0,0 +1,233 @@
+/**********************************************
+ * Lz4Block Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module implements the LZ4 block format. A sequence starts with a token
+ * byte: the high four bits are the number of literals, the low four the match
+ * length less 4, and 15 in either means more length bytes follow, each adding up
+ * to 255, until one is less than 255. The literals come next, then the match
+ * offset as two little-endian bytes, then the match length bytes. As the format
+ * requires, the last 5 bytes of a block are always literals and no match starts
+ * in its last 12 bytes.
+ **********************************************/
+#include "Lz4Block.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+//================================
+// Constants
+//================================
+static const size_t MIN_MATCH = 4;               // Shortest match the format can express
+static const size_t LAST_LITERALS = 5;           // The last bytes of a block are always literals
+static const size_t MATCH_START_LIMIT = 12;      // No match starts in the last bytes of a block
+static const size_t MAX_OFFSET = 65535;          // Farthest a match can reach back
+static const size_t RUN_MASK = 15;               // Token field value that means more length bytes follow
+static const int HASH_LOG = 12;                  // 4096 hash table entries
+static const unsigned SKIP_TRIGGER = 6;          // Each 64 misses in a row lengthen the search step by one
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: read32 / hashOf
+ * Description: Read 4 bytes at any alignment, and hash them into the match table.
+ **********************************************/
+static uint32_t read32(const char* at) {
+    uint32_t value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+static uint32_t hashOf(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+/**********************************************
+ * Function: lengthBytes
+ * Description: Returns the number of extra length bytes a length field needs.
+ **********************************************/
+static size_t lengthBytes(size_t length) {
+    return length >= RUN_MASK ? (length - RUN_MASK) / 255 + 1 : 0;
+}
+
+/**********************************************
+ * Function: putLength
+ * Description: Writes the extra length bytes of a field whose token value is 15.
+ **********************************************/
+static char* putLength(char* op, size_t length) {
+    for (length -= RUN_MASK; length >= 255; length -= 255)
+        *op++ = static_cast<char>(255);
+    *op++ = static_cast<char>(length);
+    return op;
+}
+
+/**********************************************
+ * Function: readLength
+ * Description: Adds the extra length bytes of a field whose token value is 15.
+ * Returns: bool - False if the block ends inside the length
+ **********************************************/
+static bool readLength(const unsigned char*& ip, const unsigned char* end, size_t& length) {
+    unsigned char byte;
+    do {
+        if (ip >= end)
+            return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/**********************************************
+ * Function: putSequence
+ * Description: Writes one sequence: literals followed by a match, or by nothing
+ *              for the last sequence (matchLength 0).
+ * Returns: bool - False if it does not fit before end
+ **********************************************/
+static bool putSequence(char*& op, const char* end, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    size_t matchField = matchLength > 0 ? matchLength - MIN_MATCH : 0;
+    size_t needed = 1 + lengthBytes(literalLength) + literalLength + (matchLength > 0 ? 2 + lengthBytes(matchField) : 0);
+    if (needed > static_cast<size_t>(end - op))
+        return false;
+    *op++ = static_cast<char>((std::min(literalLength, RUN_MASK) << 4) | std::min(matchField, RUN_MASK));
+    if (literalLength >= RUN_MASK)
+        op = putLength(op, literalLength);
+    std::memcpy(op, literals, literalLength);
+    op += literalLength;
+    if (matchLength == 0)
+        return true;
+    *op++ = static_cast<char>(offset & 0xFF);
+    *op++ = static_cast<char>(offset >> 8);
+    if (matchField >= RUN_MASK)
+        op = putLength(op, matchField);
+    return true;
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: bound
+ * Description: Returns the worst case size: incompressible input costs one
+ *              length byte per 255 literals, plus the token and slack.
+ **********************************************/
+size_t Lz4Block::bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+/**********************************************
+ * Function: compress
+ * Description:
+ * Greedy single-pass compression. Each position's first 4 bytes are hashed into
+ * a table of the last position seen with that hash; a hit that really matches
+ * and is within reach is extended backwards over pending literals and forwards as
+ * far as it goes, and written as a sequence. Runs of misses make the search step
+ * grow, so incompressible data passes quickly.
+ * Parameters:
+ * - source, size: The bytes to compress
+ * - destination, capacity: The output buffer
+ * Returns: size_t - The compressed size, or 0 if it does not fit
+ **********************************************/
+size_t Lz4Block::compress(const char* source, size_t size, char* destination, size_t capacity) {
+    const char* anchor = source;        // Start of the literals not written yet
+    const char* end = source + size;
+    char* op = destination;
+    const char* outputEnd = destination + capacity;
+
+    if (size > MATCH_START_LIMIT) {
+        uint32_t table[1 << HASH_LOG] = {};
+        const char* matchLimit = end - LAST_LITERALS;
+        const char* startLimit = end - MATCH_START_LIMIT;
+        table[hashOf(read32(source))] = 0;
+        unsigned misses = 0;
+        for (const char* ip = source + 1; ip < startLimit;) {
+            uint32_t sequence = read32(ip);
+            uint32_t& entry = table[hashOf(sequence)];
+            const char* match = source + entry;
+            entry = static_cast<uint32_t>(ip - source);
+            if (match >= ip || static_cast<size_t>(ip - match) > MAX_OFFSET || read32(match) != sequence) {
+                ip += 1 + (misses++ >> SKIP_TRIGGER);
+                continue;
+            }
+            misses = 0;
+            while (ip > anchor && match > source && ip[-1] == match[-1]) {
+                ip--;
+                match--;
+            }
+            const char* matchEnd = ip + MIN_MATCH;
+            for (const char* from = match + MIN_MATCH; matchEnd < matchLimit && *matchEnd == *from; from++)
+                matchEnd++;
+            if (!putSequence(op, outputEnd, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - match),
+                             static_cast<size_t>(matchEnd - ip)))
+                return 0;
+            ip = matchEnd;
+            anchor = ip;
+            if (ip < startLimit) // Keeps the table filled across the match, for the next one
+                table[hashOf(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - source);
+        }
+    }
+    if (!putSequence(op, outputEnd, anchor, static_cast<size_t>(end - anchor), 0, 0))
+        return 0;
+    return static_cast<size_t>(op - destination);
+}
+
+/**********************************************
+ * Function: decompress
+ * Description:
+ * Replays the sequences of a block. Every literal run, offset and match length is
+ * checked against what is left of the input and the output, and the block must
+ * fill the output exactly. A match that overlaps its own output (a repeated
+ * pattern shorter than the match) is copied one pattern length at a time.
+ * Parameters:
+ * - source, size: The compressed block
+ * - destination, expected: The output buffer and the size the block decompresses to
+ * Returns: bool - False if the block is damaged
+ **********************************************/
+bool Lz4Block::decompress(const char* source, size_t size, char* destination, size_t expected) {
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(source);
+    const unsigned char* end = ip + size;
+    char* op = destination;
+    char* outputEnd = destination + expected;
+    for (;;) {
+        if (ip >= end)
+            return false;
+        unsigned token = *ip++;
+        size_t literalLength = token >> 4;
+        if (literalLength == RUN_MASK && !readLength(ip, end, literalLength))
+            return false;
+        if (literalLength > static_cast<size_t>(end - ip) || literalLength > static_cast<size_t>(outputEnd - op))
+            return false;
+        std::memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+        if (ip == end)
+            break; // The last sequence has no match
+
+        if (end - ip < 2)
+            return false;
+        size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+        ip += 2;
+        size_t matchLength = token & RUN_MASK;
+        if (matchLength == RUN_MASK && !readLength(ip, end, matchLength))
+            return false;
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - destination) || matchLength > static_cast<size_t>(outputEnd - op))
+            return false;
+        if (offset == 1) {
+            std::memset(op, op[-1], matchLength);
+        } else {
+            for (size_t copied = 0; copied < matchLength;) {
+                size_t step = std::min(offset, matchLength - copied);
+                std::memcpy(op + copied, op + copied - offset, step);
+                copied += step;
+            }
+        }
+        op += matchLength;
+    }
+    return op == outputEnd;
+}
@@ -0,0 +1,49 @@
+/**********************************************
+ * Lz4Block Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module compresses and decompresses single blocks in the LZ4 block format,
+ * written from the published format description with no library behind it. A
+ * block is a series of sequences, each a run of literal bytes followed by a copy
+ * of earlier output (at most 65535 bytes back), and the last sequence is literals
+ * only. The compressor finds matches through a small hash table of 4-byte prefixes
+ * and never looks back, which is what makes the format fast to write; the
+ * decompressor is little more than memcpy. Blocks stand alone: no dictionary is
+ * shared between them, so any block can be decompressed by itself.
+ *
+ * The decompressor checks every length and offset against both buffers, so a
+ * damaged block is rejected instead of read or written out of bounds.
+ **********************************************/
+#ifndef LZ4BLOCK_H
+#define LZ4BLOCK_H
+
+#include <cstddef>
+
+//=============================
+// Class Declaration
+//=============================
+
+class Lz4Block {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static size_t bound(size_t size);
+    // Description: Returns the largest compressed size of size bytes: the capacity that always suffices.
+
+    //----------------------------------------------------------
+    static size_t compress(const char* source, size_t size, char* destination, size_t capacity);
+    // Description: Compresses size bytes of source into destination.
+    // Returns: size_t - The compressed size, or 0 if it does not fit in capacity.
+
+    //----------------------------------------------------------
+    static bool decompress(const char* source, size_t size, char* destination, size_t expected);
+    // Description: Decompresses a block of size bytes into destination, which holds expected bytes.
+    // Returns: bool - False if the block is damaged or does not decompress to exactly expected bytes.
+};
+
+#endif // LZ4BLOCK_H
@@ -0,0 +1,638 @@
+/**********************************************
+ * Metrics Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added spanName.
+ * - 2026-10-19: Added the hardware counter totals and their summary.
+ *--------------------------------
+ * Purpose:
+ * This module implements the operation histograms and the metrics endpoint.
+ * Each operation has a fixed array of bucket counters, each counting only its
+ * own bucket, plus a count and a sum in nanoseconds; a scrape adds the buckets
+ * up into the cumulative "le" series Prometheus expects. The listener polls its
+ * socket and a wake pipe, so stopServer() returns as soon as the response in
+ * progress, if any, has been written.
+ **********************************************/
+#include "Metrics.h"
+#include "BlockFile.h"
+#include "BloomFilter.h"
+#include "ChangeFeed.h"
+#include "FileFormat.h"
+#include "PerfCounters.h"
+#include "Replica.h"
+#include "Snapshot.h"
+#include "StorageLayout.h"
+#include "TrackerDaemon.h"
+#include "WorkQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+//================================
+// Constants
+//================================
+
+// Upper bounds of the latency buckets in microseconds; the last bucket is +Inf.
+static const long long BUCKET_BOUNDS_US[] = {50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000,
+                                             100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000};
+static const size_t BUCKETS = sizeof(BUCKET_BOUNDS_US) / sizeof(BUCKET_BOUNDS_US[0]) + 1;
+static const size_t MAX_REQUEST_BYTES = 8192;   // Longest request head read before answering
+static const int REQUEST_TIMEOUT_MS = 2000;     // A client silent for this long is dropped
+
+// The names of the hardware counters, in Counter order, as events of tracker_operation_cpu_events_total.
+static const char* const COUNTER_NAMES[CounterReading::COUNTER_COUNT] = {"cycles", "instructions", "cache_misses",
+                                                                        "branch_misses"};
+
+// The labels and the span name of each Operation, in enum order.
+static const struct {
+    const char* entity;
+    const char* operation;
+    const char* span;
+} OPERATION_LABELS[Metrics::OPERATION_COUNT] = {
+    {"change_item", "create", "change_item.create"},
+    {"change_item", "get", "change_item.get"},
+    {"change_item", "get_many", "change_item.get_many"},
+    {"change_item", "update", "change_item.update"},
+    {"change_item", "bulk_update", "change_item.bulk_update"},
+    {"change_item", "list", "change_item.list"},
+    {"change_item", "report", "change_item.report"},
+    {"change_request", "create", "change_request.create"},
+    {"change_request", "get", "change_request.get"},
+    {"change_request", "get_many", "change_request.get_many"},
+    {"product_release", "create", "product_release.create"},
+    {"product_release", "get", "product_release.get"},
+    {"product_release", "get_many", "product_release.get_many"},
+    {"product", "create", "product.create"},
+    {"product", "get", "product.get"},
+    {"requester", "create", "requester.create"},
+    {"requester", "get", "requester.get"},
+    {"query", "run", "query.run"},
+    {"report", "release_status", "report.release_status"},
+    {"report", "cycle_times", "report.cycle_times"},
+    {"report", "most_requested", "report.most_requested"},
+    {"work_queue", "take", "work_queue.take"},
+    {"work_queue", "finish", "work_queue.finish"},
+};
+
+//================================
+// Record Types
+//================================
+
+// The latency histogram of one operation.
+struct OperationHistogram {
+    std::atomic<uint64_t> buckets[BUCKETS] = {};    // Operations per bucket, not cumulative
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sumNanos{0};
+};
+
+// The hardware counter totals of one operation.
+struct OperationCounters {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> events[CounterReading::COUNTER_COUNT] = {};
+};
+
+//================================
+// Static Variables
+//================================
+static OperationHistogram histograms[Metrics::OPERATION_COUNT];
+static OperationCounters operationCounters[Metrics::OPERATION_COUNT];
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: label
+ * Description: Quotes a label value, escaping what the text format requires.
+ **********************************************/
+static std::string label(const std::string& value) {
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"')
+            quoted += '\\';
+        if (c == '\n')
+            quoted += "\\n";
+        else
+            quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/**********************************************
+ * Function: header
+ * Description: Writes the HELP and TYPE lines of a metric.
+ **********************************************/
+static void header(std::ostream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+}
+
+/**********************************************
+ * Function: renderOperations
+ * Description: Writes the latency histogram of every operation that has run.
+ **********************************************/
+static void renderOperations(std::ostream& out) {
+    header(out, "tracker_operation_duration_seconds", "histogram", "Latency of entity operations.");
+    for (size_t i = 0; i < Metrics::OPERATION_COUNT; i++) {
+        const OperationHistogram& histogram = histograms[i];
+        uint64_t count = histogram.count.load(std::memory_order_relaxed);
+        if (count == 0)
+            continue;
+        std::string labels = "entity=" + label(OPERATION_LABELS[i].entity) + ",operation=" + label(OPERATION_LABELS[i].operation);
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < BUCKETS; b++) {
+            cumulative += histogram.buckets[b].load(std::memory_order_relaxed);
+            out << "tracker_operation_duration_seconds_bucket{" << labels << ",le=\"";
+            if (b + 1 < BUCKETS)
+                out << static_cast<double>(BUCKET_BOUNDS_US[b]) / 1e6;
+            else
+                out << "+Inf";
+            out << "\"} " << cumulative << '\n';
+        }
+        out << "tracker_operation_duration_seconds_sum{" << labels << "} "
+            << static_cast<double>(histogram.sumNanos.load(std::memory_order_relaxed)) / 1e9 << '\n';
+        out << "tracker_operation_duration_seconds_count{" << labels << "} " << cumulative << '\n';
+    }
+}
+
+/**********************************************
+ * Function: renderCounters
+ * Description: Writes the hardware counter totals of every operation, if the
+ *              counters are on.
+ **********************************************/
+static void renderCounters(std::ostream& out) {
+    if (!PerfCounters::active())
+        return;
+    header(out, "tracker_operation_cpu_events_total", "counter", "Hardware counter events in user space during entity operations.");
+    for (size_t i = 0; i < Metrics::OPERATION_COUNT; i++) {
+        if (operationCounters[i].count.load(std::memory_order_relaxed) == 0)
+            continue;
+        std::string labels = "entity=" + label(OPERATION_LABELS[i].entity) + ",operation=" + label(OPERATION_LABELS[i].operation);
+        for (int c = 0; c < CounterReading::COUNTER_COUNT; c++)
+            if (PerfCounters::counted(static_cast<CounterReading::Counter>(c)))
+                out << "tracker_operation_cpu_events_total{" << labels << ",event=\"" << COUNTER_NAMES[c] << "\"} "
+                    << operationCounters[i].events[c].load(std::memory_order_relaxed) << '\n';
+    }
+}
+
+/**********************************************
+ * Function: renderFiles
+ * Description: Writes the size and record count of every data file. Archives
+ *              count the records their block index holds.
+ **********************************************/
+static void renderFiles(std::ostream& out) {
+    std::ostringstream records;
+    header(out, "tracker_data_file_bytes", "gauge", "Size of each data file.");
+    for (const std::string& path : StorageLayout::dataFiles(".")) {
+        std::error_code error;
+        uintmax_t bytes = std::filesystem::file_size(path, error);
+        if (error)
+            continue;
+        long long count = 0;
+        if (StorageLayout::isArchive(path)) {
+            count = BlockReader(path).records();
+        } else {
+            RecordLayout layout = FileFormat::layout(path);
+            if (layout.size > 0)
+                count = static_cast<long long>(bytes / layout.size);
+        }
+        out << "tracker_data_file_bytes{file=" << label(path) << "} " << bytes << '\n';
+        records << "tracker_data_file_records{file=" << label(path) << "} " << count << '\n';
+    }
+    header(out, "tracker_data_file_records", "gauge", "Records in each data file.");
+    out << records.str();
+}
+
+/**********************************************
+ * Function: renderFilters
+ * Description: Writes the lookup filters' counters. A definite miss is a lookup
+ *              answered without reading the data file: the filter's hit.
+ **********************************************/
+static void renderFilters(std::ostream& out) {
+    std::vector<FilterStats> filters = BloomFilter::allStats();
+    header(out, "tracker_filter_lookups_total", "counter", "Lookups asked of each lookup filter.");
+    for (const FilterStats& filter : filters)
+        out << "tracker_filter_lookups_total{filter=" << label(filter.file) << "} " << filter.lookups << '\n';
+    header(out, "tracker_filter_definite_misses_total", "counter", "Lookups answered without reading the data file.");
+    for (const FilterStats& filter : filters)
+        out << "tracker_filter_definite_misses_total{filter=" << label(filter.file) << "} " << filter.definiteMisses << '\n';
+    header(out, "tracker_filter_false_positives_total", "counter", "Lookups the filter let through that found nothing.");
+    for (const FilterStats& filter : filters)
+        out << "tracker_filter_false_positives_total{filter=" << label(filter.file) << "} " << filter.falsePositives << '\n';
+    header(out, "tracker_filter_hit_ratio", "gauge", "Share of lookups answered without reading the data file.");
+    for (const FilterStats& filter : filters)
+        out << "tracker_filter_hit_ratio{filter=" << label(filter.file) << "} "
+            << (filter.lookups > 0 ? static_cast<double>(filter.definiteMisses) / static_cast<double>(filter.lookups) : 0.0) << '\n';
+    header(out, "tracker_filter_false_positive_ratio", "gauge", "Observed false positive rate of each lookup filter.");
+    for (const FilterStats& filter : filters)
+        out << "tracker_filter_false_positive_ratio{filter=" << label(filter.file) << "} " << filter.observedRate << '\n';
+    header(out, "tracker_filter_keys", "gauge", "Keys added to each lookup filter.");
+    for (const FilterStats& filter : filters)
+        out << "tracker_filter_keys{filter=" << label(filter.file) << "} " << filter.keys << '\n';
+}
+
+/**********************************************
+ * Function: renderQueues
+ * Description: Writes the depths of the queues and logs the tracker keeps.
+ **********************************************/
+static void renderQueues(std::ostream& out) {
+    DaemonStats daemon = TrackerDaemon::stats();
+    if (daemon.running) {
+        header(out, "tracker_daemon_connections", "gauge", "Clients connected to the daemon.");
+        out << "tracker_daemon_connections " << daemon.connections << '\n';
+        header(out, "tracker_daemon_requests_total", "counter", "Requests the daemon has answered.");
+        out << "tracker_daemon_requests_total " << daemon.requests << '\n';
+        header(out, "tracker_daemon_run_queue_depth", "gauge", "Coroutines waiting for a daemon worker thread.");
+        out << "tracker_daemon_run_queue_depth " << daemon.queued << '\n';
+        header(out, "tracker_daemon_threads", "gauge", "Daemon worker threads.");
+        out << "tracker_daemon_threads " << daemon.threads << '\n';
+    }
+
+    header(out, "tracker_work_queue_waiting", "gauge", "Assessed change items waiting to be taken.");
+    out << "tracker_work_queue_waiting " << WorkQueue::waiting("") << '\n';
+    header(out, "tracker_work_queue_leases", "gauge", "Change items leased to a taker.");
+    out << "tracker_work_queue_leases " << WorkQueue::leases().size() << '\n';
+    header(out, "tracker_change_feed_events", "gauge", "Events in the change feed.");
+    out << "tracker_change_feed_events " << ChangeFeed::endSequence() << '\n';
+    header(out, "tracker_snapshot_version_log_entries", "gauge", "Old record versions kept for open snapshots.");
+    out << "tracker_snapshot_version_log_entries " << Snapshot::versionLogEntries() << '\n';
+
+    ReplicaStatus replica = Replica::status();
+    if (replica.follower) {
+        header(out, "tracker_replica_lag_seconds", "gauge", "Time since the follower last had every primary event.");
+        out << "tracker_replica_lag_seconds " << static_cast<double>(replica.lagMs) / 1000 << '\n';
+        header(out, "tracker_replica_behind_events", "gauge", "Primary feed events not yet applied.");
+        out << "tracker_replica_behind_events " << std::max(0LL, replica.primaryEnd - replica.applied) << '\n';
+    }
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: spanName
+ * Description: Returns the name an operation's trace span is given.
+ **********************************************/
+const char* Metrics::spanName(Operation operation) {
+    return OPERATION_LABELS[operation].span;
+}
+
+/**********************************************
+ * Function: record
+ * Description: Adds one operation to its histogram. The bucket is found by a
+ *              linear search of the 17 bounds, cheaper than the clock reads around it.
+ * Parameters:
+ * - operation: The operation that ran
+ * - elapsed: How long it took
+ **********************************************/
+void Metrics::record(Operation operation, std::chrono::steady_clock::duration elapsed) {
+    long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    if (nanos < 0)
+        nanos = 0;
+    size_t bucket = 0;
+    while (bucket + 1 < BUCKETS && nanos > BUCKET_BOUNDS_US[bucket] * 1000)
+        bucket++;
+    OperationHistogram& histogram = histograms[operation];
+    histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram.sumNanos.fetch_add(static_cast<uint64_t>(nanos), std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**********************************************
+ * Function: recordCounters
+ * Description: Reads the calling thread's counters again and adds what they
+ *              counted since before to the operation's totals.
+ * Parameters:
+ * - operation: The operation that ran
+ * - before: The counters read when it began, on this thread
+ **********************************************/
+void Metrics::recordCounters(Operation operation, const CounterReading& before) {
+    CounterReading after;
+    if (!PerfCounters::read(after))
+        return;
+    uint64_t delta[CounterReading::COUNTER_COUNT];
+    PerfCounters::difference(before, after, delta);
+    OperationCounters& totals = operationCounters[operation];
+    for (int c = 0; c < CounterReading::COUNTER_COUNT; c++)
+        totals.events[c].fetch_add(delta[c], std::memory_order_relaxed);
+    totals.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**********************************************
+ * Function: startCounters
+ * Description: Turns the hardware counters on and has the summary printed to
+ *              standard error at exit.
+ * Returns: bool - False if the counters are not available
+ **********************************************/
+bool Metrics::startCounters() {
+    if (!PerfCounters::start())
+        return false;
+    std::atexit([] { printCounters(std::cerr); });
+    return true;
+}
+
+/**********************************************
+ * Function: printCounters
+ * Description: Prints a row per operation that was counted: events per
+ *              operation, instructions per cycle, and cache and branch misses
+ *              per thousand instructions. Counters the processor lacks print "-".
+ * Parameters:
+ * - out: The stream to print to
+ **********************************************/
+void Metrics::printCounters(std::ostream& out) {
+    if (!PerfCounters::active())
+        return;
+    auto counted = [](CounterReading::Counter c) { return PerfCounters::counted(c); };
+    auto cell = [&out](bool known, double value, int precision) {
+        out << std::setw(12);
+        if (known)
+            out << std::fixed << std::setprecision(precision) << value;
+        else
+            out << "-";
+    };
+    out << std::endl << "Hardware counters per operation (user space; an operation includes those it calls):" << std::endl;
+    out << std::left << std::setw(30) << "operation" << std::right << std::setw(10) << "count" << std::setw(12) << "cycles/op"
+        << std::setw(12) << "instr/op" << std::setw(12) << "IPC" << std::setw(12) << "LLC miss/op" << std::setw(12)
+        << "LLC MPKI" << std::setw(12) << "br miss/op" << std::setw(12) << "br MPKI" << std::endl;
+    for (size_t i = 0; i < OPERATION_COUNT; i++) {
+        const OperationCounters& totals = operationCounters[i];
+        uint64_t count = totals.count.load(std::memory_order_relaxed);
+        if (count == 0)
+            continue;
+        double events[CounterReading::COUNTER_COUNT];
+        for (int c = 0; c < CounterReading::COUNTER_COUNT; c++)
+            events[c] = static_cast<double>(totals.events[c].load(std::memory_order_relaxed));
+        double instructions = events[CounterReading::INSTRUCTIONS];
+        bool perInstruction = counted(CounterReading::INSTRUCTIONS) && instructions > 0;
+        out << std::left << std::setw(30) << OPERATION_LABELS[i].span << std::right << std::setw(10) << count;
+        cell(counted(CounterReading::CYCLES), events[CounterReading::CYCLES] / count, 0);
+        cell(counted(CounterReading::INSTRUCTIONS), instructions / count, 0);
+        cell(perInstruction && counted(CounterReading::CYCLES) && events[CounterReading::CYCLES] > 0,
+             instructions / events[CounterReading::CYCLES], 2);
+        cell(counted(CounterReading::CACHE_MISSES), events[CounterReading::CACHE_MISSES] / count, 1);
+        cell(perInstruction && counted(CounterReading::CACHE_MISSES), 1000 * events[CounterReading::CACHE_MISSES] / instructions, 2);
+        cell(counted(CounterReading::BRANCH_MISSES), events[CounterReading::BRANCH_MISSES] / count, 1);
+        cell(perInstruction && counted(CounterReading::BRANCH_MISSES), 1000 * events[CounterReading::BRANCH_MISSES] / instructions, 2);
+        out << std::endl;
+    }
+}
+
+/**********************************************
+ * Function: render
+ * Description: Writes the whole exposition: operations, files, filters, queues.
+ * Parameters:
+ * - out: The stream to write to
+ **********************************************/
+void Metrics::render(std::ostream& out) {
+    renderOperations(out);
+    renderCounters(out);
+    renderFiles(out);
+    renderFilters(out);
+    renderQueues(out);
+}
+
+#ifdef __linux__
+
+//================================
+// Endpoint
+//================================
+static std::mutex serverLock;           // Guards starting and stopping
+static std::thread serverThread;
+static int serverFd = -1;
+static int serverWake[2] = {-1, -1};
+static std::string serverPath;          // The Unix-domain socket to remove, if any
+
+/**********************************************
+ * Function: readRequestHead
+ * Description: Reads from a client until the blank line that ends the request
+ *              head, giving up after REQUEST_TIMEOUT_MS of silence.
+ * Returns: bool - False if the client hung up, was too slow or sent too much.
+ **********************************************/
+static bool readRequestHead(int fd, std::string& head) {
+    char chunk[1024];
+    while (head.find("\r\n\r\n") == std::string::npos && head.find("\n\n") == std::string::npos) {
+        if (head.size() > MAX_REQUEST_BYTES)
+            return false;
+        pollfd ready{fd, POLLIN, 0};
+        if (poll(&ready, 1, REQUEST_TIMEOUT_MS) <= 0)
+            return false;
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0)
+            return false;
+        head.append(chunk, static_cast<size_t>(received));
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: answer
+ * Description: Answers one HTTP request: the metrics for GET (or HEAD) /metrics,
+ *              404 for other paths and 405 for other methods.
+ **********************************************/
+static void answer(int fd) {
+    std::string head;
+    if (!readRequestHead(fd, head))
+        return;
+    std::istringstream line(head.substr(0, head.find('\n')));
+    std::string method, target;
+    line >> method >> target;
+
+    std::string status = "200 OK";
+    std::ostringstream body;
+    if (method != "GET" && method != "HEAD")
+        status = "405 Method Not Allowed";
+    else if (target != "/metrics" && target.rfind("/metrics?", 0) != 0)
+        status = "404 Not Found";
+    else
+        Metrics::render(body);
+    if (status[0] != '2')
+        body << status << '\n';
+
+    std::string content = body.str();
+    std::ostringstream response;
+    response << "HTTP/1.0 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << content.size() << "\r\n"
+             << "Connection: close\r\n\r\n";
+    if (method != "HEAD")
+        response << content;
+    std::string bytes = response.str();
+    for (size_t sent = 0; sent < bytes.size();) {
+        ssize_t written = send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return;
+        sent += static_cast<size_t>(written);
+    }
+}
+
+/**********************************************
+ * Function: serve
+ * Description: The listener thread: answers one client at a time until the wake
+ *              pipe is written to.
+ **********************************************/
+static void serve(int listenFd, int wakeFd) {
+    for (;;) {
+        pollfd ready[2] = {{listenFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+        if (poll(ready, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (ready[1].revents != 0)
+            break;
+        int client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0)
+            continue;
+        answer(client);
+        close(client);
+    }
+}
+
+/**********************************************
+ * Function: bindAddress
+ * Description: Creates the listening socket for a "unix:" path or a port on 127.0.0.1.
+ * Returns: int - The socket, or -1 with the reason printed.
+ **********************************************/
+static int bindAddress(const std::string& address) {
+    if (address.rfind("unix:", 0) == 0) {
+        std::string path = address.substr(5);
+        sockaddr_un local{};
+        local.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(local.sun_path)) {
+            std::cerr << "Bad metrics socket path " << path << "." << std::endl;
+            return -1;
+        }
+        std::strcpy(local.sun_path, path.c_str());
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        unlink(path.c_str());
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0 || listen(fd, SOMAXCONN) < 0) {
+            std::cerr << "Failed to bind the metrics socket " << path << "." << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return -1;
+        }
+        serverPath = path;
+        return fd;
+    }
+
+    std::string port = address;
+    size_t colon = address.rfind(':');
+    if (colon != std::string::npos) {
+        std::string host = address.substr(0, colon);
+        if (host != "127.0.0.1" && host != "localhost") {
+            std::cerr << "The metrics endpoint only listens on 127.0.0.1 or a Unix-domain socket." << std::endl;
+            return -1;
+        }
+        port = address.substr(colon + 1);
+    }
+    char* end = nullptr;
+    long number = std::strtol(port.c_str(), &end, 10);
+    if (port.empty() || *end != '\0' || number <= 0 || number > 65535) {
+        std::cerr << "Bad metrics port " << port << "." << std::endl;
+        return -1;
+    }
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(static_cast<uint16_t>(number));
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    if (fd >= 0)
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        std::cerr << "Failed to listen for metrics on 127.0.0.1:" << number << "." << std::endl;
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**********************************************
+ * Function: startServer
+ * Description: Binds the address and starts the listener thread. The listener is
+ *              also stopped at exit, so every way out of main joins its thread.
+ * Parameters:
+ * - address: A port on 127.0.0.1, or "unix:" and a socket path
+ * Returns: bool - False if the address is not local or could not be bound
+ **********************************************/
+bool Metrics::startServer(const std::string& address) {
+    std::lock_guard<std::mutex> lock(serverLock);
+    if (serverFd >= 0) {
+        std::cerr << "The metrics endpoint is already running." << std::endl;
+        return false;
+    }
+    int fd = bindAddress(address);
+    if (fd < 0)
+        return false;
+    if (pipe2(serverWake, O_CLOEXEC) < 0) {
+        close(fd);
+        return false;
+    }
+    serverFd = fd;
+    serverThread = std::thread(serve, serverFd, serverWake[0]);
+    static bool registered = false;
+    if (!registered) {
+        std::atexit(stopServer);
+        registered = true;
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: stopServer
+ * Description: Wakes the listener, joins its thread and closes its sockets.
+ **********************************************/
+void Metrics::stopServer() {
+    std::lock_guard<std::mutex> lock(serverLock);
+    if (serverFd < 0)
+        return;
+    char byte = 1;
+    if (write(serverWake[1], &byte, 1) < 0) {
+        // Cannot fail on an empty pipe
+    }
+    serverThread.join();
+    close(serverFd);
+    close(serverWake[0]);
+    close(serverWake[1]);
+    serverFd = -1;
+    serverWake[0] = serverWake[1] = -1;
+    if (!serverPath.empty())
+        unlink(serverPath.c_str());
+    serverPath.clear();
+}
+
+#else
+
+//================================
+// Unsupported platform
+//================================
+bool Metrics::startServer(const std::string& address) {
+    std::cerr << "The metrics endpoint is only supported on Linux." << std::endl;
+    return false;
+}
+void Metrics::stopServer() {}
+
+#endif
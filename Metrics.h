@@ -0,0 +1,153 @@
+/**********************************************
+ * Metrics Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Timers also trace their operation as a span.
+ * - 2026-10-19: Timers count hardware counter events when they are on.
+ *--------------------------------
+ * Purpose:
+ * This module counts and times the operations of the entity modules and serves
+ * the numbers in the Prometheus text format, so the tracker can be scraped and
+ * alerted on like any other service. Every operation adds its latency to a
+ * histogram of its own with a few relaxed atomic additions; nothing is locked
+ * and nothing is allocated on the way.
+ *
+ * A scrape also reports what is read when the page is built: the size and record
+ * count of every data file, the lookup filters' counters (how often a lookup was
+ * answered without reading the data), the depth of the daemon's run queue and of
+ * the work queue, the change feed's length and the replica's lag.
+ *
+ * With --perf the timers also read the thread's hardware counters, and the
+ * events of each operation type are totalled and summed up at exit. Work an
+ * operation hands to other threads, like a parallel segment search, is not
+ * counted against it.
+ *
+ * The endpoint is a minimal HTTP/1.0 listener on a thread of its own, bound to
+ * 127.0.0.1 or to a Unix-domain socket only. It answers GET /metrics and nothing
+ * else, and closes each connection after the response. Counters belong to the
+ * process that serves them: a daemon and an interactive session each have theirs.
+ **********************************************/
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include "PerfCounters.h"
+#include "Trace.h"
+
+//=============================
+// Constants
+//=============================
+const char* const DEFAULT_METRICS_ADDRESS = "9464";    // 127.0.0.1:9464, the port Prometheus reserves for exporters
+
+//=============================
+// Class Declaration
+//=============================
+
+class Metrics {
+public:
+    //=============================
+    // Enum Declarations
+    //=============================
+    enum Operation {
+        ITEM_CREATE,
+        ITEM_GET,
+        ITEM_GET_MANY,
+        ITEM_UPDATE,
+        ITEM_BULK_UPDATE,
+        ITEM_LIST,
+        ITEM_REPORT,
+        REQUEST_CREATE,
+        REQUEST_GET,
+        REQUEST_GET_MANY,
+        RELEASE_CREATE,
+        RELEASE_GET,
+        RELEASE_GET_MANY,
+        PRODUCT_CREATE,
+        PRODUCT_GET,
+        REQUESTER_CREATE,
+        REQUESTER_GET,
+        QUERY_RUN,
+        REPORT_RELEASE_STATUS,
+        REPORT_CYCLE_TIMES,
+        REPORT_MOST_REQUESTED,
+        WORK_TAKE,
+        WORK_FINISH,
+        OPERATION_COUNT
+    };
+
+    //=============================
+    // Nested Types
+    //=============================
+
+    // Times one operation from construction to destruction, traces it as a span and, if the
+    // hardware counters are on, counts its events.
+    class Timer {
+    public:
+        explicit Timer(Operation operation)
+            : span(spanName(operation), "entity"), operation(operation), start(std::chrono::steady_clock::now()) {
+            counting = PerfCounters::active() && PerfCounters::read(counters);
+        }
+        ~Timer() {
+            if (counting)
+                recordCounters(operation, counters);
+            record(operation, std::chrono::steady_clock::now() - start);
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        Trace::Span span;
+        Operation operation;
+        std::chrono::steady_clock::time_point start;
+        CounterReading counters;
+        bool counting = false;
+    };
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static void record(Operation operation, std::chrono::steady_clock::duration elapsed);
+    // Description: Counts one operation and adds its latency to the operation's histogram.
+    //              Safe to call from any thread.
+
+    //----------------------------------------------------------
+    static const char* spanName(Operation operation);
+    // Description: Returns the name of the operation's trace span, e.g. "change_item.create".
+
+    //----------------------------------------------------------
+    static void recordCounters(Operation operation, const CounterReading& before);
+    // Description: Adds the hardware counter events since before, read on the calling thread, to the
+    //              operation's totals.
+
+    //----------------------------------------------------------
+    static bool startCounters();
+    // Description: Turns the hardware counters on for every operation; a summary is printed at exit.
+    // Returns: bool - False if hardware counters are not available.
+
+    //----------------------------------------------------------
+    static void printCounters(std::ostream& out);
+    // Description: Prints cycles, instructions, IPC, cache and branch misses per operation type.
+
+    //----------------------------------------------------------
+    static void render(std::ostream& out);
+    // Description: Writes every metric in the Prometheus text exposition format.
+
+    //----------------------------------------------------------
+    static bool startServer(const std::string& address);
+    // Description: Starts serving GET /metrics on its own thread.
+    // Parameters:
+    // - address: A port on 127.0.0.1 ("9464" or "127.0.0.1:9464", "localhost:9464"), or
+    //            "unix:" followed by the path of a Unix-domain socket.
+    // Returns: bool - False if the address is not local or could not be bound.
+
+    //----------------------------------------------------------
+    static void stopServer();
+    // Description: Stops the listener and waits for its thread. Does nothing if none runs.
+};
+
+#endif // METRICS_H
@@ -0,0 +1,221 @@
+/**********************************************
+ * PerfCounters Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module implements the per-thread counter groups. The first counter that
+ * opens leads the group and the others join it; a counter the processor lacks
+ * is left out and reads 0. The group counts user-space events only, which an
+ * unprivileged process may do, and is read with one read() of the leader.
+ **********************************************/
+#include "PerfCounters.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+//================================
+// Constants
+//================================
+
+// The perf event of each counter, in Counter order.
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} COUNTER_EVENTS[CounterReading::COUNTER_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+//================================
+// Record Types
+//================================
+
+// The counter group of one thread, closed when the thread exits.
+struct CounterGroup {
+    int leader = -1;
+    int members[CounterReading::COUNTER_COUNT];     // File descriptors, -1 if not counted
+    int position[CounterReading::COUNTER_COUNT];    // Place of each counter in a group read, -1 if not counted
+    int opened = 0;
+    bool tried = false;
+
+    CounterGroup() {
+        for (int i = 0; i < CounterReading::COUNTER_COUNT; i++)
+            members[i] = position[i] = -1;
+    }
+    ~CounterGroup() {
+        for (int fd : members)
+            if (fd >= 0)
+                close(fd);
+    }
+};
+
+//================================
+// Static Variables
+//================================
+static bool countedCounters[CounterReading::COUNTER_COUNT] = {};    // Set by start(), read-only afterwards
+static thread_local CounterGroup group;
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: openCounter
+ * Description: Opens one counter of the calling thread, in user space only.
+ * Parameters:
+ * - counter: The counter to open
+ * - leader: The group to join, or -1 to lead a new one
+ * Returns: int - The file descriptor, or -1 with errno set
+ **********************************************/
+static int openCounter(int counter, int leader) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = COUNTER_EVENTS[counter].type;
+    attributes.config = COUNTER_EVENTS[counter].config;
+    attributes.disabled = leader < 0 ? 1 : 0;  // The group starts when its members have joined
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, leader, PERF_FLAG_FD_CLOEXEC));
+}
+
+/**********************************************
+ * Function: openGroup
+ * Description: Opens the calling thread's counters once. Only the counters
+ *              start() found are opened, so every thread counts the same ones.
+ * Parameters:
+ * - all: Whether to try every counter, as start() does
+ * Returns: bool - True if at least one counter is open
+ **********************************************/
+static bool openGroup(bool all) {
+    if (group.tried)
+        return group.leader >= 0;
+    group.tried = true;
+    for (int counter = 0; counter < CounterReading::COUNTER_COUNT; counter++) {
+        if (!all && !countedCounters[counter])
+            continue;
+        int fd = openCounter(counter, group.leader);
+        if (fd < 0)
+            continue;
+        group.members[counter] = fd;
+        group.position[counter] = group.opened++;
+        if (group.leader < 0)
+            group.leader = fd;
+    }
+    if (group.leader < 0)
+        return false;
+    ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+}
+
+//================================
+// Function implementations
+//================================
+
+/**********************************************
+ * Function: start
+ * Description: Opens the counters of the calling thread, which settles which
+ *              counters every thread opens, and turns counting on.
+ * Returns: bool - False if no hardware counter could be opened
+ **********************************************/
+bool PerfCounters::start() {
+    if (active())
+        return true;
+    if (!openGroup(true)) {
+        int error = errno;
+        std::cerr << "Hardware counters are not available: " << std::strerror(error) << "." << std::endl;
+        if (error == EACCES || error == EPERM)
+            std::cerr << "Set /proc/sys/kernel/perf_event_paranoid to 2 or lower to count user-space events." << std::endl;
+        else if (error == ENOENT || error == EOPNOTSUPP)
+            std::cerr << "The processor, or the virtual machine, has no performance monitoring unit." << std::endl;
+        return false;
+    }
+    for (int counter = 0; counter < CounterReading::COUNTER_COUNT; counter++)
+        countedCounters[counter] = group.members[counter] >= 0;
+    enabled.store(true);
+    return true;
+}
+
+/**********************************************
+ * Function: counted
+ * Description: Returns whether a counter was opened by start().
+ **********************************************/
+bool PerfCounters::counted(CounterReading::Counter counter) {
+    return countedCounters[counter];
+}
+
+/**********************************************
+ * Function: read
+ * Description: Reads the whole group with one read() of its leader.
+ * Parameters:
+ * - reading: Receives the counter values and the group's times
+ * Returns: bool - False if the group could not be opened or read
+ **********************************************/
+bool PerfCounters::read(CounterReading& reading) {
+    if (!openGroup(false))
+        return false;
+    uint64_t buffer[3 + CounterReading::COUNTER_COUNT];     // Count, time enabled, time running, values
+    ssize_t length = ::read(group.leader, buffer, sizeof(buffer));
+    if (length < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != static_cast<uint64_t>(group.opened))
+        return false;
+    reading.enabled = buffer[1];
+    reading.running = buffer[2];
+    for (int counter = 0; counter < CounterReading::COUNTER_COUNT; counter++)
+        reading.values[counter] = group.position[counter] >= 0 ? buffer[3 + group.position[counter]] : 0;
+    return true;
+}
+
+#else
+
+//================================
+// Unsupported platform
+//================================
+bool PerfCounters::start() {
+    std::cerr << "Hardware counters are only supported on Linux." << std::endl;
+    return false;
+}
+
+bool PerfCounters::counted(CounterReading::Counter counter) {
+    return false;
+}
+
+bool PerfCounters::read(CounterReading& reading) {
+    return false;
+}
+
+#endif
+
+/**********************************************
+ * Function: difference
+ * Description: Subtracts two readings and, if the group was switched out for
+ *              part of the time between them, scales the differences up to the
+ *              whole time, as perf stat does.
+ * Parameters:
+ * - before, after: Two readings of the same thread, in that order
+ * - delta: Receives the events of each counter
+ **********************************************/
+void PerfCounters::difference(const CounterReading& before, const CounterReading& after,
+                              uint64_t delta[CounterReading::COUNTER_COUNT]) {
+    uint64_t enabled = after.enabled - before.enabled;
+    uint64_t running = after.running - before.running;
+    for (int counter = 0; counter < CounterReading::COUNTER_COUNT; counter++) {
+        uint64_t events = after.values[counter] - before.values[counter];
+        if (running > 0 && running < enabled)
+            events = static_cast<uint64_t>(static_cast<double>(events) * enabled / running);
+        delta[counter] = events;
+    }
+}
@@ -0,0 +1,84 @@
+/**********************************************
+ * PerfCounters Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module reads the processor's hardware counters for the calling thread:
+ * cycles, instructions, last-level cache misses and branch mispredictions. It
+ * uses perf_event_open, so it works on Linux only, and only where the kernel
+ * lets an unprivileged process count its own user-space events
+ * (perf_event_paranoid 2 or lower) and a performance monitoring unit is there;
+ * most virtual machines have none.
+ *
+ * Each thread opens its counters as one group the first time it reads them,
+ * so they are started and read together, and keeps them until it exits. When
+ * the kernel has more events to count than the processor has counters, it
+ * takes turns and reports how long the group was counted; differences of two
+ * readings are scaled up by that share.
+ **********************************************/
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+//=============================
+// Record Types
+//=============================
+
+// The counters of the calling thread at one moment.
+struct CounterReading {
+    enum Counter {
+        CYCLES,
+        INSTRUCTIONS,
+        CACHE_MISSES,       // Last-level cache misses, as the processor reports them
+        BRANCH_MISSES,
+        COUNTER_COUNT
+    };
+
+    uint64_t values[COUNTER_COUNT] = {};
+    uint64_t enabled = 0;       // Nanoseconds the group was enabled
+    uint64_t running = 0;       // Nanoseconds the group was actually counted
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class PerfCounters {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool start();
+    // Description: Opens the counters of the calling thread and turns counting on for every thread.
+    //              Prints why if no counter could be opened.
+    // Returns: bool - False if hardware counters are not available.
+
+    //----------------------------------------------------------
+    static bool active() { return enabled.load(std::memory_order_relaxed); }
+    // Description: Returns whether start() succeeded.
+
+    //----------------------------------------------------------
+    static bool counted(CounterReading::Counter counter);
+    // Description: Returns whether the processor counts counter; the others always read 0.
+
+    //----------------------------------------------------------
+    static bool read(CounterReading& reading);
+    // Description: Reads the calling thread's counters, opening them on the thread's first read.
+    // Returns: bool - False if they could not be opened or read.
+
+    //----------------------------------------------------------
+    static void difference(const CounterReading& before, const CounterReading& after,
+                           uint64_t delta[CounterReading::COUNTER_COUNT]);
+    // Description: Computes the events counted between two readings of one thread, scaled up for the
+    //              time the kernel had the group switched out.
+
+private:
+    static inline std::atomic<bool> enabled{false};
+};
+
+#endif // PERFCOUNTERS_H
@@ -5,6 +5,18 @@
  * - 2024-07-15: Initial version created
  * - 2024-07-31: Version 2 created
  *      - Created releaseIdToString
+ * - 2026-10-19: New releases are published to the change feed.
+ * - 2026-10-19: Added releaseIdView; the constructor takes the product by reference.
+ * - 2026-10-19: Release lookups and the duplicate check consult a persisted Bloom filter first.
+ * - 2026-10-19: Added findProductRelease and the batched getProductReleases; getProductRelease wraps findProductRelease.
+ * - 2026-10-19: Releases are written with checksums and verified when read.
+ * - 2026-10-19: The data file is brought up to the current record version when it is opened.
+ * - 2026-10-19: Operations timed for the metrics endpoint.
+ * - 2026-10-19: The release uniqueness scan is traced as a span.
+ * - 2026-10-19: The release stream has its own mutex, held across the duplicate check and the append.
+ * - 2026-10-19: Added exists, which checks that a product has a release.
+ * - 2026-10-19: exists is built on the new findProductRelease by product and release ID.
+ * - 2026-10-19: createProductRelease checks for a duplicate and appends under the append lock, so other processes are excluded too.
  * -------------------------------------------------------------------------
  * Purpose:
  * This file contains the implementation of the Release module, showing the 
@@ -14,18 +26,67 @@
  **********************************************/
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <cstring>
 #include <vector>
+#include <algorithm>
+#include <filesystem>
 
 #include "ProductRelease.h"
 #include "Product.h"
+#include "BloomFilter.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "Metrics.h"
+#include "StorageLayout.h"
+#include "Trace.h"
 #include "KeyUniquenessException.h"
 #include "ObjectNotFoundException.h"
+#include "ChangeFeed.h"
+#include "RecordChecksum.h"
 
 //================================
 // Static Variables
 //================================
 static std::fstream file;
+static std::mutex fileMutex;   // Serializes every use of file, from any caller
+
+//================================
+// Lookup Filter
+//================================
+
+// Builds a filter key in buffer: a tag byte, then the parts separated by a terminator.
+static std::string_view releaseFilterKey(char* buffer, char tag, std::string_view product, std::string_view releaseId) {
+    size_t length = 0;
+    buffer[length++] = tag;
+    if (tag == 'P') {
+        memcpy(buffer + length, product.data(), product.size());
+        length += product.size();
+        buffer[length++] = '\0';
+    }
+    memcpy(buffer + length, releaseId.data(), releaseId.size());
+    return std::string_view(buffer, length + releaseId.size());
+}
+
+// The longest key releaseFilterKey builds.
+static const size_t RELEASE_KEY_SIZE = 2 + Schema<Product>::SIZE + Schema<ProductRelease>::size<ProductRelease::FIELD_RELEASE_ID>();
+
+// Passes the keys of a packed ProductRelease record to visit: the release ID alone, for
+// getProductRelease, and the product with the release ID, for the duplicate check.
+static void releaseKeys(const char* record, const BloomFilter::KeyVisitor& visit) {
+    const char* product = record + Schema<ProductRelease>::offset<ProductRelease::FIELD_PRODUCT>();
+    std::string_view productName(product, strnlen(product, Schema<Product>::SIZE));
+    std::string_view releaseId = Schema<ProductRelease>::text<ProductRelease::FIELD_RELEASE_ID>(record);
+    char buffer[RELEASE_KEY_SIZE];
+    visit(releaseFilterKey(buffer, 'R', productName, releaseId));
+    visit(releaseFilterKey(buffer, 'P', productName, releaseId));
+}
+
+static std::vector<std::string> releaseFiles() {
+    return {"ProductRelease.txt"};
+}
+
+static BloomFilter releaseFilter(RELEASE_FILTER_FILE, "ProductRelease.txt", FILTER_LOCK_OFFSET, Schema<ProductRelease>::SIZE, releaseFiles, releaseKeys);
 
 //================================
 // Function Implementations
@@ -49,7 +110,7 @@ ProductRelease::ProductRelease() {
  * Parameters: const char* n - The name of the product.
  **********************************************/
 //--------------------------------------------------------------------
-ProductRelease::ProductRelease(Product theProduct, const char* theReleaseId, const char* theDate) {
+ProductRelease::ProductRelease(const Product& theProduct, const char* theReleaseId, const char* theDate) {
     productName = theProduct;
     strcpy(releaseId, theReleaseId);
     strcpy(date, theDate);
@@ -67,12 +128,19 @@ ProductRelease::ProductRelease(Product theProduct, const char* theReleaseId, con
  **********************************************/
 //--------------------------------------------------------------------
 bool ProductRelease::initProductRelease() {
-    file.open("ProductRelease.txt", std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
+    if (!FileFormat::ensureCurrent("ProductRelease.txt")) // A small file, upgraded whole when first opened
         return false;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        file.open("ProductRelease.txt", std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return false;
+        }
+        file.close();
     }
-    file.close();
+    RecordChecksum::init("ProductRelease.txt", sizeof(ProductRelease));
+    releaseFilter.init();
     return true;
 }
 
@@ -80,32 +148,58 @@ bool ProductRelease::initProductRelease() {
  * Function: createProductRelease
  * Description:
  * Creates a product and stores it in the file holding all the ProductReleases.
+ * The file is only searched for a duplicate if the lookup filter has seen the
+ * product and release ID together before.
  * Parameters: A ProductRelease to store
  **********************************************/
 //--------------------------------------------------------------------
 void ProductRelease::createProductRelease(const ProductRelease& productRelease) {
-    file.open("ProductRelease.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-    }
+    Metrics::Timer timer(Metrics::RELEASE_CREATE);
+    std::lock_guard<std::mutex> lock(fileMutex);
+    releaseFilter.growIfFull(); // Before the filter is locked below
+    // Keeps the check for a duplicate and the append together, across processes as well
+    RecordLock appendLock("ProductRelease.txt", APPEND_LOCK_OFFSET, 1, true);
+    BloomFilter::WriteScope filterScope(releaseFilter);
+    std::string_view productName = productRelease.productName.getProductNameView();
+    std::string_view releaseId = productRelease.releaseIdView();
+    char buffer[RELEASE_KEY_SIZE];
+    if (releaseFilter.mayContain(releaseFilterKey(buffer, 'P', productName, releaseId))) {
+        Trace::Span span("product_release.uniqueness_scan", "scan");
+        file.open("ProductRelease.txt", std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+        }
 
-    file.seekg(0, std::ios::beg); // Reset file pointer to beginning
-    ProductRelease tempProductRelease;
-    while (file.read(reinterpret_cast<char*>(&tempProductRelease), sizeof(ProductRelease))) {
-        if (tempProductRelease.productName == productRelease.productName &&  strcmp(tempProductRelease.releaseId, productRelease.releaseId) == 0)
-            throw KeyUniquenessException("Product: " + tempProductRelease.productName.getProductName() + " with the ProductRelease: " + std::string(productRelease.releaseId) + " already exists");
+        file.seekg(0, std::ios::beg); // Reset file pointer to beginning
+        ProductRelease tempProductRelease;
+        ChecksumReader checksums("ProductRelease.txt", sizeof(ProductRelease));
+        for (long long position = 0; file.read(reinterpret_cast<char*>(&tempProductRelease), sizeof(ProductRelease)); position += sizeof(ProductRelease)) {
+            if (tempProductRelease.productName == productRelease.productName &&  strcmp(tempProductRelease.releaseId, productRelease.releaseId) == 0 &&
+                checksums.check(position, &tempProductRelease)) {
+                file.close();
+                throw KeyUniquenessException("Product: " + tempProductRelease.productName.getProductName() + " with the ProductRelease: " + std::string(productRelease.releaseId) + " already exists");
+            }
 
+        }
+        file.close();
+        releaseFilter.falsePositive();
     }
-    closeProductRelease();
-    
+    releaseFilter.add(releaseFilterKey(buffer, 'R', productName, releaseId));
+    releaseFilter.add(releaseFilterKey(buffer, 'P', productName, releaseId));
+
     file.open("ProductRelease.txt", std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
     if (!file.is_open()) {
         std::cerr << "Failed to open file." << std::endl;
     }
 
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size("ProductRelease.txt", error);
+    long long offset = error ? 0 : static_cast<long long>(size - size % sizeof(ProductRelease));
+    RecordChecksum::store("ProductRelease.txt", sizeof(ProductRelease), offset, &productRelease, 1); // Before the record, so a torn append fails
     file.write(reinterpret_cast<const char*>(&productRelease), sizeof(ProductRelease));
-    cout << "Product Release created!" << std::endl;
-    closeProductRelease();
+    file.close(); // Flushes the record before the append lock is released
+    ChangeFeed::publish(FeedEvent::PRODUCT_RELEASE, FeedEvent::CREATED, -1, productRelease.productName.getProductName(),
+                        productRelease.releaseIdToString(), -1, -1, -1);
 }
 
 /**********************************************
@@ -117,26 +211,127 @@ void ProductRelease::createProductRelease(const ProductRelease& productRelease)
  **********************************************/
 //--------------------------------------------------------------------
 ProductRelease ProductRelease::getProductRelease(const char* findReleaseId) {
-    file.open("ProductRelease.txt", std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
+    ProductRelease productRelease;
+    if (findProductRelease(findReleaseId, productRelease))
+        return productRelease;
+    throw ObjectNotFoundException("Object with this changeID was not found in file");
+}
+
+/**********************************************
+ * Function: findProductRelease
+ * Description:
+ * Does the work of getProductRelease without throwing. A release ID the lookup
+ * filter has never seen is reported missing without opening the file.
+ * Parameters: A ProductReleaseID to find, and the ProductRelease receiving it
+ * Returns: True if the ProductRelease was found
+ **********************************************/
+//--------------------------------------------------------------------
+bool ProductRelease::findProductRelease(const char* findReleaseId, ProductRelease& productRelease) {
+    Metrics::Timer timer(Metrics::RELEASE_GET);
+    std::string_view releaseId(findReleaseId);
+    if (releaseId.size() >= sizeof(ProductRelease::releaseId))
+        return false; // Longer than any stored release ID
+    char buffer[RELEASE_KEY_SIZE];
+    if (!releaseFilter.mayContain(releaseFilterKey(buffer, 'R', "", releaseId)))
+        return false;
+
+    // A local stream keeps lookups reentrant so concurrent readers never share a file position
+    std::ifstream infile("ProductRelease.txt", std::ios::binary);
+    if (!infile.is_open()) {
         std::cerr << "Failed to open file." << std::endl;
     }
 
-    file.seekg(0, std::ios::beg); // Reset file pointer to beginning
+    ChecksumReader checksums("ProductRelease.txt", sizeof(ProductRelease));
+    for (long long position = 0; infile.read(reinterpret_cast<char*>(&productRelease), sizeof(productRelease)); position += sizeof(productRelease)) {
+        if (strcmp(productRelease.releaseId, findReleaseId) == 0 && checksums.check(position, &productRelease))
+            return true;
+    }
+    releaseFilter.falsePositive();
+    return false;
+}
+
+/**********************************************
+ * Function: exists
+ * Description: Returns true if the product has the release.
+ **********************************************/
+//--------------------------------------------------------------------
+bool ProductRelease::exists(const std::string& productName, const std::string& releaseId) {
     ProductRelease productRelease;
-    bool found = false;
-    while (!found && file.read(reinterpret_cast<char*>(&productRelease), sizeof(productRelease))) {
-        if (strcmp(productRelease.releaseId, findReleaseId) == 0) {
-            found = true;
-        }
+    return findProductRelease(productName, releaseId, productRelease);
+}
+
+/**********************************************
+ * Function: findProductRelease
+ * Description:
+ * Looks for the release of one product, as the duplicate check of
+ * createProductRelease does, but through a local stream so lookups stay
+ * reentrant.
+ * Parameters: The product's name, the release ID, and the ProductRelease receiving it
+ * Returns: True if an intact record has both
+ **********************************************/
+//--------------------------------------------------------------------
+bool ProductRelease::findProductRelease(const std::string& productName, const std::string& releaseId, ProductRelease& productRelease) {
+    if (releaseId.size() >= sizeof(ProductRelease::releaseId))
+        return false; // Longer than any stored release ID
+    char buffer[RELEASE_KEY_SIZE];
+    if (!releaseFilter.mayContain(releaseFilterKey(buffer, 'P', productName, releaseId)))
+        return false;
+
+    std::ifstream infile("ProductRelease.txt", std::ios::binary);
+    ChecksumReader checksums("ProductRelease.txt", sizeof(ProductRelease));
+    for (long long position = 0; infile.read(reinterpret_cast<char*>(&productRelease), sizeof(productRelease)); position += sizeof(productRelease)) {
+        if (productRelease.productName.getProductNameView() == productName && productRelease.releaseIdView() == releaseId &&
+            checksums.check(position, &productRelease))
+            return true;
     }
+    releaseFilter.falsePositive();
+    return false;
+}
 
-    closeProductRelease();
-    if (found)
-        return productRelease;
-    else throw ObjectNotFoundException("Object with this changeID was not found in file");
+/**********************************************
+ * Function: getProductReleases
+ * Description:
+ * Looks up many release IDs in one pass over the file. IDs the lookup filter
+ * rules out are answered without reading, and the pass stops once every other
+ * ID has been found. Each ID gets the first matching release in the file, as
+ * with getProductRelease.
+ * Parameters: The release IDs to find
+ * Returns: One optional ProductRelease per release ID, in the order given
+ **********************************************/
+//--------------------------------------------------------------------
+std::vector<std::optional<ProductRelease>> ProductRelease::getProductReleases(std::span<const std::string> releaseIds) {
+    Metrics::Timer timer(Metrics::RELEASE_GET_MANY);
+    std::vector<std::string_view> keys;
+    char buffer[RELEASE_KEY_SIZE];
+    for (const std::string& releaseId : releaseIds) {
+        if (releaseId.size() < sizeof(ProductRelease::releaseId) && releaseId.find('\0') == std::string::npos)
+            keys.push_back(releaseId);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    keys.erase(std::remove_if(keys.begin(), keys.end(), [&buffer](std::string_view releaseId) {
+        return !releaseFilter.mayContain(releaseFilterKey(buffer, 'R', "", releaseId));
+    }), keys.end());
+
+    std::vector<std::optional<ProductRelease>> byKey(keys.size());
+    size_t found = StorageLayout::findRecords<ProductRelease>(releaseFiles(), [](const char* candidate) {
+        return Schema<ProductRelease>::text<FIELD_RELEASE_ID>(candidate);
+    }, keys, [&](size_t index, const char* record, const std::string&, long long) {
+        Schema<ProductRelease>::decode(record, byKey[index].emplace());
+    });
+    for (size_t missing = found; missing < keys.size(); missing++)
+        releaseFilter.falsePositive();
 
-    return productRelease;
+    std::vector<std::optional<ProductRelease>> results;
+    results.reserve(releaseIds.size());
+    for (const std::string& releaseId : releaseIds) {
+        auto key = std::lower_bound(keys.begin(), keys.end(), std::string_view(releaseId));
+        if (key != keys.end() && *key == releaseId)
+            results.push_back(byKey[static_cast<size_t>(key - keys.begin())]);
+        else
+            results.emplace_back();
+    }
+    return results;
 }
 
 /**********************************************
@@ -147,10 +342,43 @@ ProductRelease ProductRelease::getProductRelease(const char* findReleaseId) {
  * Returns: A string
  **********************************************/
 //--------------------------------------------------------------------
-std::string ProductRelease::releaseIdToString(){
+std::string ProductRelease::releaseIdToString() const {
     return std::string(releaseId);
 }
 
+/**********************************************
+ * Function: releaseIdView
+ * Description:
+ * Returns the release ID without copying it.
+ * Returns: A view of the release ID field
+ **********************************************/
+//--------------------------------------------------------------------
+std::string_view ProductRelease::releaseIdView() const {
+    return std::string_view(releaseId, strnlen(releaseId, sizeof(releaseId)));
+}
+
+/**********************************************
+ * Function: getProductName
+ * Description:
+ * Retrieves the name of the product the release belongs to.
+ * Returns: A string
+ **********************************************/
+//--------------------------------------------------------------------
+std::string ProductRelease::getProductName() const {
+    return productName.getProductName();
+}
+
+/**********************************************
+ * Function: getDate
+ * Description:
+ * Retrieves the release date.
+ * Returns: A string
+ **********************************************/
+//--------------------------------------------------------------------
+std::string ProductRelease::getDate() const {
+    return std::string(date);
+}
+
 /**********************************************
  * Function: closeProductRelease
  * Description:
@@ -158,6 +386,7 @@ std::string ProductRelease::releaseIdToString(){
  **********************************************/
 //--------------------------------------------------------------------
 void ProductRelease::closeProductRelease() {
+    std::lock_guard<std::mutex> lock(fileMutex);
     if (file.is_open()) {
         file.close();
     }
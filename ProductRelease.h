@@ -2,6 +2,11 @@
  * ProductRelease Header File
  * Revision History:
  * - 2024-07-30: Initial version created.
+ * - 2026-10-19: Added releaseIdView; the constructor takes the product by reference.
+ * - 2026-10-19: Added the record schema.
+ * - 2026-10-19: Added findProductRelease and getProductReleases.
+ * - 2026-10-19: Added exists, a lookup by product and release ID.
+ * - 2026-10-19: Added findProductRelease by product and release ID.
  *--------------------------------
  * Purpose: 
  * This module provides a cohesive interface for managing product releases, including initialization, 
@@ -15,8 +20,14 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
+#include <tuple>
 #include "Product.h"
+#include "RecordSchema.h"
 
 //=============================
 // Class Declaration
@@ -33,10 +44,10 @@ public:
     // Description: Default constructor for the ProductRelease class.
 
     //----------------------------------------------------------
-    ProductRelease(Product theProduct, const char* theReleaseId, const char* theDate);
+    ProductRelease(const Product& theProduct, const char* theReleaseId, const char* theDate);
     // Description: Parameterized constructor for creating a new ProductRelease object.
     // Parameters: 
-    // - Product theProduct: The product associated with the release.
+    // - const Product& theProduct: The product associated with the release.
     // - const char* theReleaseId: The release ID.
     // - const char* theDate: The release date.
 
@@ -60,6 +71,7 @@ public:
     // Description: Writes a new ProductRelease object to the file.
     // Parameters: 
     // - const ProductRelease& product: The ProductRelease object to be written to the file.
+    // Exceptions: KeyUniquenessException - Thrown if the product already has a release with this ID.
 
     //----------------------------------------------------------
     static ProductRelease getProductRelease(const char* findChangeId);
@@ -69,15 +81,66 @@ public:
     // Returns: ProductRelease object if found, otherwise throws an exception.
 
     //----------------------------------------------------------
-    std::string releaseIdToString();
+    static bool findProductRelease(const char* findReleaseId, ProductRelease& productRelease);
+    // Description: Does the work of getProductRelease; a missing release ID is not an exception.
+    // Parameters: 
+    // - const char* findReleaseId: The release ID of the ProductRelease to retrieve.
+    // - ProductRelease& productRelease: Receives the record.
+    // Returns: bool - True if the ProductRelease was found.
+
+    //----------------------------------------------------------
+    static bool exists(const std::string& productName, const std::string& releaseId);
+    static bool findProductRelease(const std::string& productName, const std::string& releaseId, ProductRelease& productRelease);
+    // Description: Looks up the release of one product, reading the file only if the lookup filter has
+    //              seen the two together. Reads through its own stream, so it may be called from any thread.
+    // Returns: bool - True if the product has the release; findProductRelease then copies its record.
+
+    //----------------------------------------------------------
+    static std::vector<std::optional<ProductRelease>> getProductReleases(std::span<const std::string> releaseIds);
+    // Description: Looks up many ProductReleases in one pass over the file.
+    // Parameters: 
+    // - std::span<const std::string> releaseIds: The release IDs to retrieve, in any order.
+    // Returns: One entry per release ID, in the same order; empty where the ID does not exist.
+
+    //----------------------------------------------------------
+    std::string releaseIdToString() const;
     // Description: Converts the release ID to a string.
     // Returns: std::string - The release ID as a string.
 
+    //----------------------------------------------------------
+    std::string_view releaseIdView() const;
+    // Description: Returns the release ID without copying it; valid while the release is.
+
+    //----------------------------------------------------------
+    std::string getProductName() const;
+    // Description: Retrieves the name of the product the release belongs to.
+
+    //----------------------------------------------------------
+    std::string getDate() const;
+    // Description: Retrieves the release date.
+
     //----------------------------------------------------------
     static void closeProductRelease();
     // Description: Closes the file if it is open.
 
+    //=============================
+    // Schema Declarations
+    //=============================
+    enum Field : size_t {        // Stored fields, in file order
+        FIELD_PRODUCT,
+        FIELD_RELEASE_ID,
+        FIELD_DATE,
+        FIELD_COUNT
+    };
+
 private:
+    friend class Schema<ProductRelease>;
+    static constexpr auto schemaFields() {
+        return std::make_tuple(SchemaField<&ProductRelease::productName>{"product"},
+                               SchemaField<&ProductRelease::releaseId>{"releaseId"},
+                               SchemaField<&ProductRelease::date>{"date"});
+    }
+
     //=============================
     // Private Member Variables
     //=============================
@@ -87,4 +150,8 @@ private:
     char date[11];               // The release date
 };
 
+static_assert(Schema<ProductRelease>::COUNT == ProductRelease::FIELD_COUNT, "ProductRelease fields and schema disagree");
+static_assert(Schema<ProductRelease>::SIZE == 30, "ProductRelease records are 30 bytes in ProductRelease.txt");
+static_assert(Schema<ProductRelease>::PACKED_IN_MEMORY, "Releases are written and embedded as they are in memory");
+
 #endif // PRODUCTRELEASE_H
@@ -0,0 +1,1470 @@
+/**********************************************
+ * Query Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Scans skip records that fail their checksums.
+ * - 2026-10-19: Scans read files in any record version.
+ * - 2026-10-19: Item scans read the archives too, unless the statement selects only open states.
+ * - 2026-10-19: Archives are costed at the size of their records, not their compressed size.
+ * - 2026-10-19: Operations timed for the metrics endpoint.
+ *--------------------------------
+ * Purpose:
+ * This module implements the query language. A statement is parsed into a source,
+ * a conjunction of conditions, an optional group by column and the columns to
+ * show. Every source describes its columns once, and extract reads one column of
+ * a stored record, so the filter, grouping and output work the same over every
+ * source and every access path.
+ *
+ * The planner lists the access paths that can answer the query and estimates the
+ * bytes each reads: the segment files for scans, and the directory entries,
+ * posting blocks or links for the indexes. A parallel scan reads the same bytes
+ * as a full scan but is charged for one segment's share, as the segments are read
+ * at the same time. The estimated number of matching rows comes from the current
+ * row count (from the file sizes) times the selectivity of each condition, taken
+ * from the statistics of the last analyze or from fixed guesses without them.
+ * The cheapest path wins; an index wins a tie.
+ *
+ * Statistics are a tab-separated text file: a "source" line with the row count and
+ * the time of the analyze, then a "column" line per column with its distinct
+ * count, its smallest and largest number and its most common values with their
+ * counts. An analyze writes a new file and renames it over the old one.
+ **********************************************/
+#include "Query.h"
+#include "BlockFile.h"
+#include "ChangeItem.h"
+#include "ChangeRequest.h"
+#include "FileFormat.h"
+#include "ItemArchive.h"
+#include "Metrics.h"
+#include "ProductRelease.h"
+#include "RecordChecksum.h"
+#include "RecordView.h"
+#include "ReleaseIndex.h"
+#include "RequestLinks.h"
+#include "Snapshot.h"
+#include "StorageLayout.h"
+#include "requester.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//================================
+// Constants
+//================================
+static const long long PARALLEL_SCAN_MIN_BYTES = 1 << 20;   // Smaller sources are not worth the threads
+static const size_t QUERY_CHUNK_RECORDS = 4096;             // Records read per step of a file scan
+static const size_t COMMON_VALUES = 8;                      // Most common values kept per column
+static const double DEFAULT_EQUAL_SELECTIVITY = 0.1;        // Guesses without statistics
+static const double DEFAULT_RANGE_SELECTIVITY = 0.33;
+
+static const char* STATE_NAMES[] = {"ASSESSED", "INPROGRESS", "DONE", "CANCELLED"};
+
+//================================
+// Sources and Columns
+//================================
+
+enum SourceKind { SOURCE_ITEMS, SOURCE_REQUESTS, SOURCE_RELEASES, SOURCE_REQUESTERS, SOURCE_COUNT };
+
+enum ItemColumn { COL_ITEM_ID, COL_ITEM_DESCRIPTION, COL_ITEM_PRODUCT, COL_ITEM_DATE, COL_ITEM_RELEASE,
+                  COL_ITEM_PRIORITY, COL_ITEM_STATE, COL_ITEM_VERSION };
+enum RequestColumn { COL_REQUEST_ID, COL_REQUEST_REQUESTER, COL_REQUEST_PRODUCT, COL_REQUEST_RELEASE,
+                     COL_REQUEST_DATE, COL_REQUEST_ITEM };
+enum ReleaseColumn { COL_RELEASE_PRODUCT, COL_RELEASE_ID, COL_RELEASE_DATE };
+enum RequesterColumn { COL_REQUESTER_NAME, COL_REQUESTER_PHONE, COL_REQUESTER_EMAIL, COL_REQUESTER_DEPARTMENT };
+
+struct Column {
+    const char* name;
+    bool isText;
+    const char* const* names;   // Names of the numbers, e.g. the states; null for plain numbers
+    int nameCount;
+};
+
+struct Source {
+    const char* name;
+    std::vector<Column> columns;
+    size_t recordSize;           // Bytes per record in the source's files
+};
+
+static const Source SOURCES[SOURCE_COUNT] = {
+    {"items", {{"id", false, nullptr, 0}, {"description", true, nullptr, 0}, {"product", true, nullptr, 0},
+               {"date", true, nullptr, 0}, {"release", true, nullptr, 0}, {"priority", false, nullptr, 0},
+               {"state", false, STATE_NAMES, 4}, {"version", false, nullptr, 0}},
+     sizeof(ChangeItem)},
+    {"requests", {{"id", false, nullptr, 0}, {"requester", true, nullptr, 0}, {"product", true, nullptr, 0},
+                  {"release", true, nullptr, 0}, {"date", true, nullptr, 0}, {"item", false, nullptr, 0}},
+     ChangeRequest::RECORD_SIZE},
+    {"releases", {{"product", true, nullptr, 0}, {"release", true, nullptr, 0}, {"date", true, nullptr, 0}},
+     Schema<ProductRelease>::SIZE},
+    {"requesters", {{"name", true, nullptr, 0}, {"phone", true, nullptr, 0}, {"email", true, nullptr, 0},
+                    {"department", true, nullptr, 0}},
+     Schema<Requester>::SIZE}};
+
+//================================
+// Values
+//================================
+
+struct Value {
+    bool isText = false;
+    long long number = 0;
+    std::string text;
+};
+
+/**********************************************
+ * Function: compareValues
+ * Description: Orders two values of one column: numbers by value, text by bytes.
+ * Returns: int - Negative, zero or positive as a is less than, equal to or greater than b.
+ **********************************************/
+static int compareValues(const Value& a, const Value& b) {
+    if (!a.isText && !b.isText)
+        return a.number < b.number ? -1 : (a.number > b.number ? 1 : 0);
+    if (a.isText != b.isText)
+        return a.isText ? 1 : -1;
+    return a.text.compare(b.text);
+}
+
+struct ValueLess {
+    bool operator()(const Value& a, const Value& b) const { return compareValues(a, b) < 0; }
+};
+
+/**********************************************
+ * Function: valueKey
+ * Description: Returns the text a value is counted under in the statistics.
+ **********************************************/
+static std::string valueKey(const Value& value) {
+    return value.isText ? value.text : std::to_string(value.number);
+}
+
+/**********************************************
+ * Function: formatValue
+ * Description: Returns a value as the output shows it: states by name, and a
+ *              request's missing change item as "-".
+ **********************************************/
+static std::string formatValue(const Column& column, const Value& value) {
+    if (value.isText)
+        return value.text;
+    if (column.names != nullptr && value.number >= 0 && value.number < column.nameCount)
+        return column.names[value.number];
+    if (std::string(column.name) == "item" && value.number < 0)
+        return "-";
+    return std::to_string(value.number);
+}
+
+/**********************************************
+ * Function: setText
+ * Description: Stores a fixed-width field as a text value, without the padding
+ *              and without tabs or line breaks, which the statistics file uses.
+ **********************************************/
+static void setText(Value& value, std::string_view text) {
+    size_t end = text.find('\0');
+    if (end != std::string_view::npos)
+        text = text.substr(0, end);
+    value.isText = true;
+    value.text.assign(text.data(), text.size());
+    for (char& c : value.text)
+        if (c == '\t' || c == '\n' || c == '\r')
+            c = ' ';
+}
+
+/**********************************************
+ * Function: setNumber
+ * Description: Stores a number value.
+ **********************************************/
+static void setNumber(Value& value, long long number) {
+    value.isText = false;
+    value.number = number;
+}
+
+/**********************************************
+ * Function: extract
+ * Description: Reads one column of a stored record.
+ * Parameters:
+ * - source: The source the record belongs to
+ * - record: The record as stored; for items, a ChangeItem
+ * - linkedItem: For requests, the change item the request is about, or -1
+ * - column: The column to read
+ * - value: Receives the column's value
+ **********************************************/
+static void extract(int source, const char* record, int linkedItem, int column, Value& value) {
+    switch (source) {
+    case SOURCE_ITEMS: {
+        const ChangeItemView view(*reinterpret_cast<const ChangeItem*>(record));
+        switch (column) {
+        case COL_ITEM_ID: setNumber(value, view.changeId()); break;
+        case COL_ITEM_DESCRIPTION: setText(value, view.description()); break;
+        case COL_ITEM_PRODUCT: setText(value, view.productName()); break;
+        case COL_ITEM_DATE: setText(value, view.date()); break;
+        case COL_ITEM_RELEASE: setText(value, view.releaseId()); break;
+        case COL_ITEM_PRIORITY: setNumber(value, view.priority()); break;
+        case COL_ITEM_STATE: setNumber(value, static_cast<int>(view.state())); break;
+        default: setNumber(value, view.version()); break;
+        }
+        break;
+    }
+    case SOURCE_REQUESTS: {
+        using Fields = Schema<ChangeRequest>;
+        switch (column) {
+        case COL_REQUEST_ID: setNumber(value, Fields::read<ChangeRequest::FIELD_CHANGE_ID>(record)); break;
+        case COL_REQUEST_REQUESTER: setText(value, Fields::text<ChangeRequest::FIELD_REQUESTED_BY>(record)); break;
+        case COL_REQUEST_PRODUCT: setText(value, Fields::read<ChangeRequest::FIELD_PRODUCT>(record).getProductName()); break;
+        case COL_REQUEST_RELEASE: setText(value, Fields::read<ChangeRequest::FIELD_RELEASE>(record).releaseIdView()); break;
+        case COL_REQUEST_DATE: setText(value, Fields::text<ChangeRequest::FIELD_DATE>(record)); break;
+        default: setNumber(value, linkedItem); break;
+        }
+        break;
+    }
+    case SOURCE_RELEASES: {
+        using Fields = Schema<ProductRelease>;
+        switch (column) {
+        case COL_RELEASE_PRODUCT: setText(value, Fields::read<ProductRelease::FIELD_PRODUCT>(record).getProductName()); break;
+        case COL_RELEASE_ID: setText(value, Fields::text<ProductRelease::FIELD_RELEASE_ID>(record)); break;
+        default: setText(value, Fields::text<ProductRelease::FIELD_DATE>(record)); break;
+        }
+        break;
+    }
+    default: {
+        using Fields = Schema<Requester>;
+        switch (column) {
+        case COL_REQUESTER_NAME: setText(value, Fields::text<Requester::FIELD_NAME>(record)); break;
+        case COL_REQUESTER_PHONE: setText(value, Fields::text<Requester::FIELD_PHONE_NUMBER>(record)); break;
+        case COL_REQUESTER_EMAIL: setText(value, Fields::text<Requester::FIELD_EMAIL>(record)); break;
+        default: setText(value, Fields::text<Requester::FIELD_DEPARTMENT>(record)); break;
+        }
+        break;
+    }
+    }
+}
+
+/**********************************************
+ * Function: sourceFiles
+ * Description: Returns the files a scan of a source reads.
+ **********************************************/
+static std::vector<std::string> sourceFiles(int source) {
+    switch (source) {
+    case SOURCE_ITEMS: return StorageLayout::itemFiles();
+    case SOURCE_REQUESTS: return StorageLayout::requestSegments();
+    case SOURCE_RELEASES: return {"ProductRelease.txt"};
+    default: return {"req.txt"};
+    }
+}
+
+/**********************************************
+ * Function: fileBytes
+ * Description: Returns the size of a file, or 0 if it does not exist. An archive's
+ *              size is that of its records once decompressed.
+ **********************************************/
+static long long fileBytes(const std::string& path) {
+    if (StorageLayout::isArchive(path))
+        return BlockReader(path).stats().rawBytes;
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    return error ? 0 : static_cast<long long>(size);
+}
+
+//================================
+// Statements
+//================================
+
+enum Operator { OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE, OP_IN };
+static const char* OPERATOR_NAMES[] = {"=", "!=", "<", "<=", ">", ">=", "in"};
+
+struct Condition {
+    int column;
+    Operator op;
+    std::vector<Value> values;  // One value, or the list of in
+};
+
+struct Statement {
+    bool explain = false;
+    bool analyze = false;
+    int source = -1;            // -1 for analyze of every source
+    std::vector<Condition> conditions;
+    int groupBy = -1;
+    std::vector<int> show;      // Empty for every column
+    long long limit = -1;
+};
+
+struct Token {
+    enum Kind { WORD, TEXT, SYMBOL, END } kind;
+    std::string text;
+};
+
+/**********************************************
+ * Function: tokenize
+ * Description: Splits a statement into words, quoted text and the symbols
+ *              = != < <= > >= ( ) and ,.
+ * Returns: bool - False, with a message in error, for an unknown character or an unterminated quote.
+ **********************************************/
+static bool tokenize(const std::string& text, std::vector<Token>& tokens, std::string& error) {
+    size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (c == '\'' || c == '"') {
+            size_t end = text.find(c, i + 1);
+            if (end == std::string::npos) {
+                error = "unterminated quoted text";
+                return false;
+            }
+            tokens.push_back({Token::TEXT, text.substr(i + 1, end - i - 1)});
+            i = end + 1;
+        } else if (c == '!' || c == '<' || c == '>') {
+            if (i + 1 < text.size() && text[i + 1] == '=') {
+                tokens.push_back({Token::SYMBOL, text.substr(i, 2)});
+                i += 2;
+            } else if (c == '!') {
+                error = "expected != after !";
+                return false;
+            } else {
+                tokens.push_back({Token::SYMBOL, std::string(1, c)});
+                ++i;
+            }
+        } else if (c == '=' || c == '(' || c == ')' || c == ',') {
+            tokens.push_back({Token::SYMBOL, std::string(1, c)});
+            ++i;
+        } else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '.' || c == '/' || c == ':') {
+            size_t start = i;
+            while (i < text.size() && (std::isalnum(static_cast<unsigned char>(text[i])) || text[i] == '_' || text[i] == '-' ||
+                                       text[i] == '.' || text[i] == '/' || text[i] == ':'))
+                ++i;
+            tokens.push_back({Token::WORD, text.substr(start, i - start)});
+        } else {
+            error = std::string("unexpected character '") + c + "'";
+            return false;
+        }
+    }
+    tokens.push_back({Token::END, ""});
+    return true;
+}
+
+/**********************************************
+ * Function: lowered
+ * Description: Returns text in lower case, for keywords and names.
+ **********************************************/
+static std::string lowered(std::string text) {
+    for (char& c : text)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+/**********************************************
+ * Function: isNumber
+ * Description: Returns true if text is a whole number with an optional minus sign.
+ **********************************************/
+static bool isNumber(const std::string& text) {
+    size_t start = (!text.empty() && text[0] == '-') ? 1 : 0;
+    if (start == text.size() || text.size() - start > 18)
+        return false;
+    return std::all_of(text.begin() + static_cast<long>(start), text.end(),
+                       [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+}
+
+// Reads a statement from its tokens, one clause at a time.
+class Parser {
+public:
+    Parser(const std::vector<Token>& tokens, std::string& error) : tokens(tokens), error(error) {}
+    bool parse(Statement& statement);
+
+private:
+    const Token& peek() const { return tokens[position]; }
+    bool keyword(const char* word);
+    bool symbol(const char* text);
+    bool fail(const std::string& message);
+    bool column(const Statement& statement, int& found);
+    bool value(const Column& target, Value& found);
+    bool condition(Statement& statement);
+
+    const std::vector<Token>& tokens;
+    std::string& error;
+    size_t position = 0;
+};
+
+bool Parser::keyword(const char* word) {
+    if (peek().kind != Token::WORD || lowered(peek().text) != word)
+        return false;
+    ++position;
+    return true;
+}
+
+bool Parser::symbol(const char* text) {
+    if (peek().kind != Token::SYMBOL || peek().text != text)
+        return false;
+    ++position;
+    return true;
+}
+
+bool Parser::fail(const std::string& message) {
+    error = message;
+    if (peek().kind != Token::END)
+        error += " at '" + peek().text + "'";
+    return false;
+}
+
+bool Parser::column(const Statement& statement, int& found) {
+    if (peek().kind != Token::WORD)
+        return fail("expected a column");
+    const Source& source = SOURCES[statement.source];
+    std::string name = lowered(peek().text);
+    for (size_t i = 0; i < source.columns.size(); ++i) {
+        if (name == source.columns[i].name) {
+            found = static_cast<int>(i);
+            ++position;
+            return true;
+        }
+    }
+    std::string known;
+    for (const Column& each : source.columns)
+        known += std::string(known.empty() ? "" : ", ") + each.name;
+    return fail(std::string(source.name) + " has no column '" + peek().text + "' (columns: " + known + ")");
+}
+
+bool Parser::value(const Column& target, Value& found) {
+    if (peek().kind != Token::WORD && peek().kind != Token::TEXT)
+        return fail("expected a value");
+    const std::string& text = peek().text;
+    if (target.isText) {
+        found.isText = true;
+        found.text = text;
+    } else if (peek().kind == Token::WORD && isNumber(text)) {
+        setNumber(found, std::stoll(text));
+    } else {
+        int named = -1;
+        for (int i = 0; target.names != nullptr && i < target.nameCount; ++i)
+            if (lowered(text) == lowered(target.names[i]))
+                named = i;
+        if (named < 0)
+            return fail(std::string("'") + text + "' is not a value of " + target.name);
+        setNumber(found, named);
+    }
+    ++position;
+    return true;
+}
+
+bool Parser::condition(Statement& statement) {
+    Condition condition;
+    if (!column(statement, condition.column))
+        return false;
+    const Column& target = SOURCES[statement.source].columns[condition.column];
+    if (keyword("in")) {
+        condition.op = OP_IN;
+        if (!symbol("("))
+            return fail("expected ( after in");
+        do {
+            Value item;
+            if (!value(target, item))
+                return false;
+            condition.values.push_back(item);
+        } while (symbol(","));
+        if (!symbol(")"))
+            return fail("expected ) to close the list");
+    } else {
+        static const Operator OPERATORS[] = {OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE};
+        bool matched = false;
+        for (Operator op : OPERATORS) {
+            if (symbol(OPERATOR_NAMES[op])) {
+                condition.op = op;
+                matched = true;
+                break;
+            }
+        }
+        if (!matched)
+            return fail("expected an operator");
+        Value single;
+        if (!value(target, single))
+            return false;
+        condition.values.push_back(single);
+    }
+    statement.conditions.push_back(condition);
+    return true;
+}
+
+bool Parser::parse(Statement& statement) {
+    statement.explain = keyword("explain");
+    statement.analyze = !statement.explain && keyword("analyze");
+    if (peek().kind == Token::END && statement.analyze)
+        return true;
+    if (peek().kind != Token::WORD)
+        return fail("expected a source: items, requests, releases or requesters");
+    std::string name = lowered(peek().text);
+    for (int i = 0; i < SOURCE_COUNT; ++i)
+        if (name == SOURCES[i].name)
+            statement.source = i;
+    if (statement.source < 0)
+        return fail("expected a source: items, requests, releases or requesters");
+    ++position;
+    if (statement.analyze)
+        return peek().kind == Token::END || fail("analyze takes only a source");
+
+    if (keyword("where")) {
+        do {
+            if (!condition(statement))
+                return false;
+        } while (keyword("and"));
+    }
+    if (keyword("group")) {
+        if (!keyword("by"))
+            return fail("expected by after group");
+        if (!column(statement, statement.groupBy))
+            return false;
+    }
+    if (keyword("show")) {
+        if (statement.groupBy >= 0)
+            return fail("show does not apply to group by");
+        do {
+            int shown;
+            if (!column(statement, shown))
+                return false;
+            statement.show.push_back(shown);
+        } while (symbol(","));
+    }
+    if (keyword("limit")) {
+        if (peek().kind != Token::WORD || !isNumber(peek().text) || std::stoll(peek().text) < 0)
+            return fail("expected a row count after limit");
+        statement.limit = std::stoll(peek().text);
+        ++position;
+    }
+    return peek().kind == Token::END || fail("unexpected text");
+}
+
+/**********************************************
+ * Function: matches
+ * Description: Evaluates every condition on a row whose condition columns are set.
+ **********************************************/
+static bool matches(const Statement& statement, const std::vector<Value>& row) {
+    for (const Condition& condition : statement.conditions) {
+        const Value& value = row[condition.column];
+        bool holds = false;
+        if (condition.op == OP_IN) {
+            for (const Value& item : condition.values)
+                holds = holds || compareValues(value, item) == 0;
+        } else {
+            int order = compareValues(value, condition.values[0]);
+            switch (condition.op) {
+            case OP_EQ: holds = order == 0; break;
+            case OP_NE: holds = order != 0; break;
+            case OP_LT: holds = order < 0; break;
+            case OP_LE: holds = order <= 0; break;
+            case OP_GT: holds = order > 0; break;
+            default: holds = order >= 0; break;
+            }
+        }
+        if (!holds)
+            return false;
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: outputColumns
+ * Description: Returns the columns a statement prints: the group by column, the
+ *              shown columns, or every column.
+ **********************************************/
+static std::vector<int> outputColumns(const Statement& statement) {
+    if (statement.groupBy >= 0)
+        return {statement.groupBy};
+    if (!statement.show.empty())
+        return statement.show;
+    std::vector<int> all(SOURCES[statement.source].columns.size());
+    for (size_t i = 0; i < all.size(); ++i)
+        all[i] = static_cast<int>(i);
+    return all;
+}
+
+/**********************************************
+ * Function: usedColumns
+ * Description: Returns every column a statement reads, to decide which indexes cover it.
+ **********************************************/
+static std::set<int> usedColumns(const Statement& statement) {
+    std::vector<int> output = outputColumns(statement);
+    std::set<int> used(output.begin(), output.end());
+    for (const Condition& condition : statement.conditions)
+        used.insert(condition.column);
+    return used;
+}
+
+/**********************************************
+ * Function: keysOf
+ * Description: Finds the values an = or in condition on a column allows.
+ * Returns: bool - True if such a condition exists; keys then holds its distinct values.
+ **********************************************/
+static bool keysOf(const Statement& statement, int column, std::vector<Value>& keys) {
+    for (const Condition& condition : statement.conditions) {
+        if (condition.column == column && (condition.op == OP_EQ || condition.op == OP_IN)) {
+            keys.clear();
+            for (const Value& value : condition.values)
+                if (std::none_of(keys.begin(), keys.end(), [&](const Value& key) { return compareValues(key, value) == 0; }))
+                    keys.push_back(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+//================================
+// Statistics
+//================================
+
+struct ColumnStats {
+    long long distinct = 0;
+    long long minimum = 0;      // Smallest and largest number, for number columns
+    long long maximum = 0;
+    std::vector<std::pair<std::string, long long>> common;   // Most common values, most common first
+};
+
+struct SourceStats {
+    bool present = false;
+    long long rows = 0;
+    long long analyzedAt = 0;
+    std::vector<ColumnStats> columns;
+};
+
+/**********************************************
+ * Function: loadStats
+ * Description: Reads the statistics file; sources it does not mention stay absent.
+ **********************************************/
+static std::vector<SourceStats> loadStats() {
+    std::vector<SourceStats> stats(SOURCE_COUNT);
+    std::ifstream file(QUERY_STATS_FILE);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::stringstream split(line);
+        std::string field;
+        while (std::getline(split, field, '\t'))
+            fields.push_back(field);
+        if (fields.size() < 4)
+            continue;
+        int source = -1;
+        for (int i = 0; i < SOURCE_COUNT; ++i)
+            if (fields[1] == SOURCES[i].name)
+                source = i;
+        if (source < 0)
+            continue;
+        SourceStats& entry = stats[source];
+        try {
+            if (fields[0] == "source") {
+                entry.present = true;
+                entry.rows = std::stoll(fields[2]);
+                entry.analyzedAt = std::stoll(fields[3]);
+                entry.columns.assign(SOURCES[source].columns.size(), ColumnStats());
+            } else if (fields[0] == "column" && entry.present && fields.size() >= 6) {
+                for (size_t i = 0; i < SOURCES[source].columns.size(); ++i) {
+                    if (fields[2] != SOURCES[source].columns[i].name)
+                        continue;
+                    ColumnStats& column = entry.columns[i];
+                    column.distinct = std::stoll(fields[3]);
+                    column.minimum = std::stoll(fields[4]);
+                    column.maximum = std::stoll(fields[5]);
+                    for (size_t j = 6; j + 1 < fields.size(); j += 2)
+                        column.common.emplace_back(fields[j], std::stoll(fields[j + 1]));
+                }
+            }
+        } catch (const std::exception&) {
+            entry = SourceStats();  // A damaged line leaves the source without statistics
+        }
+    }
+    return stats;
+}
+
+/**********************************************
+ * Function: saveStats
+ * Description: Writes the statistics file in full and renames it into place.
+ * Returns: bool - False if the file could not be written.
+ **********************************************/
+static bool saveStats(const std::vector<SourceStats>& stats) {
+    std::string temporary = std::string(QUERY_STATS_FILE) + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        for (int source = 0; source < SOURCE_COUNT; ++source) {
+            const SourceStats& entry = stats[source];
+            if (!entry.present)
+                continue;
+            file << "source\t" << SOURCES[source].name << '\t' << entry.rows << '\t' << entry.analyzedAt << '\n';
+            for (size_t i = 0; i < entry.columns.size(); ++i) {
+                const ColumnStats& column = entry.columns[i];
+                file << "column\t" << SOURCES[source].name << '\t' << SOURCES[source].columns[i].name << '\t'
+                     << column.distinct << '\t' << column.minimum << '\t' << column.maximum;
+                for (const auto& common : column.common)
+                    file << '\t' << common.first << '\t' << common.second;
+                file << '\n';
+            }
+        }
+        if (!file.flush())
+            return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, QUERY_STATS_FILE, error);
+    return !error;
+}
+
+/**********************************************
+ * Function: equalSelectivity
+ * Description: Estimates the fraction of rows whose column equals a value: the
+ *              value's own frequency if it is a common value, otherwise an even
+ *              share of the rows the common values leave.
+ **********************************************/
+static double equalSelectivity(const SourceStats& stats, int column, const Value& value) {
+    if (!stats.present || stats.rows == 0)
+        return DEFAULT_EQUAL_SELECTIVITY;
+    const ColumnStats& entry = stats.columns[column];
+    std::string key = valueKey(value);
+    long long commonRows = 0;
+    for (const auto& common : entry.common) {
+        if (common.first == key)
+            return static_cast<double>(common.second) / static_cast<double>(stats.rows);
+        commonRows += common.second;
+    }
+    long long others = entry.distinct - static_cast<long long>(entry.common.size());
+    if (others <= 0)
+        return 0.0;
+    return static_cast<double>(stats.rows - commonRows) / static_cast<double>(others) / static_cast<double>(stats.rows);
+}
+
+/**********************************************
+ * Function: selectivity
+ * Description: Estimates the fraction of rows a condition keeps. Ranges over a
+ *              number column assume the values are spread evenly between the
+ *              smallest and largest.
+ **********************************************/
+static double selectivity(const Statement& statement, const SourceStats& stats, const Condition& condition) {
+    const Column& column = SOURCES[statement.source].columns[condition.column];
+    switch (condition.op) {
+    case OP_EQ:
+        return equalSelectivity(stats, condition.column, condition.values[0]);
+    case OP_NE:
+        return 1.0 - equalSelectivity(stats, condition.column, condition.values[0]);
+    case OP_IN: {
+        double sum = 0.0;
+        for (const Value& value : condition.values)
+            sum += equalSelectivity(stats, condition.column, value);
+        return std::min(1.0, sum);
+    }
+    default:
+        break;
+    }
+    if (column.isText || !stats.present || stats.rows == 0)
+        return DEFAULT_RANGE_SELECTIVITY;
+    const ColumnStats& entry = stats.columns[condition.column];
+    double span = static_cast<double>(entry.maximum - entry.minimum + 1);
+    double bound = static_cast<double>(condition.values[0].number);
+    double below;   // Values less than the bound
+    switch (condition.op) {
+    case OP_LT: below = bound - static_cast<double>(entry.minimum); break;
+    case OP_LE: below = bound - static_cast<double>(entry.minimum) + 1; break;
+    case OP_GT: below = bound - static_cast<double>(entry.minimum) + 1; break;
+    default: below = bound - static_cast<double>(entry.minimum); break;
+    }
+    double fraction = std::clamp(below / span, 0.0, 1.0);
+    return (condition.op == OP_LT || condition.op == OP_LE) ? fraction : 1.0 - fraction;
+}
+
+//================================
+// Plans
+//================================
+
+enum Access { FULL_SCAN, PARALLEL_SCAN, SEGMENT_SCAN, RELEASE_INDEX, RELEASE_POSTINGS, LINK_CHAIN, LINK_SCAN };
+static const char* ACCESS_NAMES[] = {"full scan", "parallel scan", "segment scan", "release index",
+                                     "release postings", "link chain", "link scan"};
+
+struct Plan {
+    Access access = FULL_SCAN;
+    std::vector<std::string> segments;  // The files a scan reads
+    bool joinLinks = false;             // A scan of requests also reads the links, for the item column
+    int keyColumn = -1;                 // LINK_CHAIN: the column whose chains are walked
+    std::vector<Value> keys;            // LINK_CHAIN and RELEASE_POSTINGS: the products or chains to read
+    std::vector<Value> releases;        // RELEASE_POSTINGS: the releases to read
+    double estimatedRows = -1;          // -1 until the plan knows better than the statistics
+    long long estimatedBytes = 0;
+    double cost = 0;                    // Estimated bytes, divided among the threads for parallel scans
+    std::string detail;                 // For explain
+};
+
+/**********************************************
+ * Function: parallelism
+ * Description: Returns the number of segments a scan reads at the same time.
+ **********************************************/
+static size_t parallelism(size_t segments) {
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(cores, segments));
+}
+
+/**********************************************
+ * Function: scanPlan
+ * Description: Builds a scan of some segments of a source.
+ **********************************************/
+static Plan scanPlan(Access access, const std::vector<std::string>& segments, long long extraBytes) {
+    Plan plan;
+    plan.access = access;
+    plan.segments = segments;
+    for (const std::string& segment : segments)
+        plan.estimatedBytes += fileBytes(segment);
+    plan.estimatedBytes += extraBytes;
+    plan.cost = static_cast<double>(plan.estimatedBytes);
+    if (access != FULL_SCAN)
+        plan.cost /= static_cast<double>(parallelism(segments.size()));
+    plan.detail = std::to_string(segments.size()) + (segments.size() == 1 ? " segment" : " segments");
+    if (access != FULL_SCAN && parallelism(segments.size()) > 1)
+        plan.detail += " on " + std::to_string(parallelism(segments.size())) + " threads";
+    return plan;
+}
+
+/**********************************************
+ * Function: plans
+ * Description: Lists every plan that can answer a statement, cheapest first.
+ * Parameters:
+ * - statement: The parsed statement
+ * - stats: The statistics of its source
+ * - rows: Receives the estimated number of matching rows
+ **********************************************/
+static std::vector<Plan> plans(const Statement& statement, const SourceStats& stats, double& rows) {
+    std::vector<std::string> files = sourceFiles(statement.source);
+    long long totalBytes = 0;
+    for (const std::string& file : files)
+        totalBytes += fileBytes(file);
+    double currentRows = static_cast<double>(totalBytes / static_cast<long long>(SOURCES[statement.source].recordSize));
+    rows = currentRows;
+    for (const Condition& condition : statement.conditions)
+        rows *= selectivity(statement, stats, condition);
+
+    // The archives hold only closed items, so a statement on open ones leaves them out
+    std::vector<Value> states;
+    if (statement.source == SOURCE_ITEMS && keysOf(statement, COL_ITEM_STATE, states) &&
+        std::none_of(states.begin(), states.end(), [](const Value& state) {
+            return !state.isText && (state.number == ChangeItem::DONE || state.number == ChangeItem::CANCELLED);
+        })) {
+        std::vector<std::string> archives = StorageLayout::archiveSegments();
+        std::erase_if(files, [&](const std::string& file) {
+            return std::find(archives.begin(), archives.end(), file) != archives.end();
+        });
+    }
+
+    std::set<int> used = usedColumns(statement);
+    std::vector<Plan> candidates;   // Indexes first, so that they win ties
+    long long linkBytes = fileBytes(REQUEST_LINK_FILE);
+
+    if (statement.source == SOURCE_ITEMS) {
+        const std::set<int> countable = {COL_ITEM_PRODUCT, COL_ITEM_RELEASE, COL_ITEM_STATE};
+        const std::set<int> postable = {COL_ITEM_ID, COL_ITEM_PRODUCT, COL_ITEM_RELEASE, COL_ITEM_STATE};
+        std::vector<Value> products, releaseIds;
+        if (statement.groupBy >= 0 && std::includes(countable.begin(), countable.end(), used.begin(), used.end())) {
+            Plan plan;
+            plan.access = RELEASE_INDEX;
+            long long entries = fileBytes(RELEASE_INDEX_FILE) / RELEASE_ENTRY_SIZE;
+            plan.estimatedBytes = entries * RELEASE_ENTRY_SIZE;
+            plan.cost = static_cast<double>(plan.estimatedBytes);
+            plan.detail = "state counts of " + std::to_string(entries) + " releases";
+            candidates.push_back(plan);
+        }
+        if (std::includes(postable.begin(), postable.end(), used.begin(), used.end()) &&
+            keysOf(statement, COL_ITEM_PRODUCT, products) && keysOf(statement, COL_ITEM_RELEASE, releaseIds)) {
+            Plan plan;
+            plan.access = RELEASE_POSTINGS;
+            plan.keys = products;
+            plan.releases = releaseIds;
+            double posted = currentRows;
+            for (const Condition& condition : statement.conditions)
+                if (condition.column == COL_ITEM_PRODUCT || condition.column == COL_ITEM_RELEASE)
+                    posted *= selectivity(statement, stats, condition);
+            long long lists = static_cast<long long>(products.size() * releaseIds.size());
+            long long blocks = static_cast<long long>(std::ceil(posted / POSTINGS_PER_BLOCK)) + lists;
+            plan.estimatedBytes = blocks * RELEASE_BLOCK_SIZE;
+            plan.cost = static_cast<double>(plan.estimatedBytes);
+            plan.detail = std::to_string(lists) + (lists == 1 ? " release" : " releases");
+            candidates.push_back(plan);
+        }
+    }
+
+    if (statement.source == SOURCE_REQUESTS) {
+        const std::set<int> linked = {COL_REQUEST_ID, COL_REQUEST_REQUESTER, COL_REQUEST_PRODUCT, COL_REQUEST_ITEM};
+        if (std::includes(linked.begin(), linked.end(), used.begin(), used.end())) {
+            std::vector<Value> keys;
+            if (keysOf(statement, COL_REQUEST_ITEM, keys)) {
+                Plan plan;
+                plan.access = LINK_CHAIN;
+                plan.keyColumn = COL_REQUEST_ITEM;
+                plan.keys = keys;
+                long long chained = 0;  // The per-item counts are exact and cheap to read
+                for (const Value& key : keys)
+                    chained += key.number >= 0 ? RequestLinks::requestCount(static_cast<int>(key.number)) : 0;
+                plan.estimatedBytes = chained * REQUEST_LINK_SIZE;
+                plan.estimatedRows = std::min(rows, static_cast<double>(chained));
+                plan.cost = static_cast<double>(plan.estimatedBytes);
+                plan.detail = "by item, " + std::to_string(keys.size()) + (keys.size() == 1 ? " chain" : " chains");
+                candidates.push_back(plan);
+            }
+            if (keysOf(statement, COL_REQUEST_REQUESTER, keys)) {
+                Plan plan;
+                plan.access = LINK_CHAIN;
+                plan.keyColumn = COL_REQUEST_REQUESTER;
+                plan.keys = keys;
+                double chained = 0;
+                for (const Value& key : keys)
+                    chained += currentRows * equalSelectivity(stats, COL_REQUEST_REQUESTER, key);
+                plan.estimatedBytes = static_cast<long long>(std::ceil(chained)) * REQUEST_LINK_SIZE;
+                plan.cost = static_cast<double>(plan.estimatedBytes);
+                plan.detail = "by requester, " + std::to_string(keys.size()) + (keys.size() == 1 ? " chain" : " chains");
+                candidates.push_back(plan);
+            }
+            Plan plan;
+            plan.access = LINK_SCAN;
+            plan.estimatedBytes = linkBytes;
+            plan.cost = static_cast<double>(plan.estimatedBytes);
+            plan.detail = "every link";
+            candidates.push_back(plan);
+        }
+    }
+
+    bool join = statement.source == SOURCE_REQUESTS && used.count(COL_REQUEST_ITEM) > 0;
+    long long extraBytes = join ? linkBytes : 0;
+    std::vector<Value> products;
+    int productColumn = statement.source == SOURCE_ITEMS ? static_cast<int>(COL_ITEM_PRODUCT) : static_cast<int>(COL_REQUEST_PRODUCT);
+    if ((statement.source == SOURCE_ITEMS || statement.source == SOURCE_REQUESTS) && StorageLayout::isPartitioned() &&
+        keysOf(statement, productColumn, products)) {
+        std::vector<std::string> segments;
+        for (const Value& product : products) {
+            std::string path = statement.source == SOURCE_ITEMS ? StorageLayout::itemPath(product.text)
+                                                                : StorageLayout::requestPath(product.text);
+            if (std::find(files.begin(), files.end(), path) != files.end())
+                segments.push_back(path);
+            std::string archive = StorageLayout::archivePath(path);
+            if (statement.source == SOURCE_ITEMS && std::find(files.begin(), files.end(), archive) != files.end())
+                segments.push_back(archive);
+        }
+        candidates.push_back(scanPlan(SEGMENT_SCAN, segments, extraBytes));
+    }
+    if (parallelism(files.size()) > 1 && totalBytes >= PARALLEL_SCAN_MIN_BYTES)
+        candidates.push_back(scanPlan(PARALLEL_SCAN, files, extraBytes));
+    candidates.push_back(scanPlan(FULL_SCAN, files, extraBytes));
+
+    for (Plan& plan : candidates) {
+        plan.joinLinks = join && plan.access <= SEGMENT_SCAN;
+        if (plan.estimatedRows < 0)
+            plan.estimatedRows = rows;
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Plan& a, const Plan& b) { return a.cost < b.cost; });
+    return candidates;
+}
+
+//================================
+// Execution
+//================================
+
+struct Counters {
+    std::atomic<long long> records{0};  // Records, index entries or links read
+    std::atomic<long long> bytes{0};
+};
+
+// The rows a statement produces: the listed rows, or the count per group.
+class Result {
+public:
+    explicit Result(const Statement& statement) : statement(statement) {}
+
+    void add(const std::vector<Value>& row, long long weight) {
+        matched += weight;
+        if (statement.groupBy >= 0)
+            groups[row[statement.groupBy]] += weight;
+        else if (statement.limit < 0 || static_cast<long long>(rows.size()) < statement.limit)
+            rows.push_back(row);
+    }
+
+    void merge(const Result& other) {
+        matched += other.matched;
+        for (const auto& group : other.groups)
+            groups[group.first] += group.second;
+        for (const auto& row : other.rows)
+            if (statement.limit < 0 || static_cast<long long>(rows.size()) < statement.limit)
+                rows.push_back(row);
+    }
+
+    const Statement& statement;
+    long long matched = 0;
+    std::map<Value, long long, ValueLess> groups;
+    std::vector<std::vector<Value>> rows;
+};
+
+// Reads the columns of one record a statement needs, the condition columns first.
+class RowReader {
+public:
+    explicit RowReader(const Statement& statement) : statement(statement), row(SOURCES[statement.source].columns.size()) {
+        for (const Condition& condition : statement.conditions)
+            if (std::find(filter.begin(), filter.end(), condition.column) == filter.end())
+                filter.push_back(condition.column);
+        for (int column : outputColumns(statement))
+            if (std::find(filter.begin(), filter.end(), column) == filter.end())
+                output.push_back(column);
+    }
+
+    void visit(const char* record, int linkedItem, Result& result) {
+        for (int column : filter)
+            extract(statement.source, record, linkedItem, column, row[column]);
+        if (!matches(statement, row))
+            return;
+        for (int column : output)
+            extract(statement.source, record, linkedItem, column, row[column]);
+        result.add(row, 1);
+    }
+
+private:
+    const Statement& statement;
+    std::vector<Value> row;
+    std::vector<int> filter;
+    std::vector<int> output;
+};
+
+/**********************************************
+ * Function: scanFile
+ * Description: Reads a file of packed records in chunks and visits each record that
+ *              passes its checksum, in the current record version whatever version
+ *              the file is stored in.
+ **********************************************/
+static void scanFile(const std::string& path, Counters& counters, const std::function<void(const char*)>& visit) {
+    VersionedReader reader(path);
+    if (!reader.usable())
+        return;
+    std::ifstream file(path, std::ios::binary);
+    ChecksumReader checksums(path, reader.storedSize());
+    size_t recordSize = reader.storedSize();
+    std::vector<char> chunk(recordSize * QUERY_CHUNK_RECORDS);
+    char converted[MAX_RECORD_SIZE];
+    long long position = 0;
+    while (file) {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        size_t records = static_cast<size_t>(file.gcount()) / recordSize;
+        counters.records += static_cast<long long>(records);
+        counters.bytes += static_cast<long long>(records * recordSize);
+        for (size_t i = 0; i < records; ++i, position += static_cast<long long>(recordSize)) {
+            if (checksums.check(position, chunk.data() + i * recordSize))
+                visit(reader.current(chunk.data() + i * recordSize, converted));
+        }
+    }
+}
+
+/**********************************************
+ * Function: scanSegment
+ * Description: Scans one file of a source into a result. Change items are read
+ *              through a snapshot, so that a scan sees each item once, as it was
+ *              when the snapshot started.
+ * Parameters:
+ * - snapshot: The snapshot change items are read through; unused for other sources
+ **********************************************/
+static void scanSegment(const Statement& statement, const std::string& segment, const std::unordered_map<int, int>& links,
+                        std::optional<Snapshot>& snapshot, Counters& counters, Result& result) {
+    RowReader reader(statement);
+    if (statement.source == SOURCE_ITEMS) {
+        if (!snapshot)
+            snapshot.emplace();
+        long long records = 0;
+        snapshot->scan(segment, [&](const ChangeItem& item) {
+            ++records;
+            reader.visit(reinterpret_cast<const char*>(&item), -1, result);
+        });
+        counters.records += records;
+        counters.bytes += records * static_cast<long long>(sizeof(ChangeItem));
+    } else if (statement.source == SOURCE_REQUESTS) {
+        scanFile(segment, counters, [&](const char* record) {
+            auto link = links.find(Schema<ChangeRequest>::read<ChangeRequest::FIELD_CHANGE_ID>(record));
+            reader.visit(record, link == links.end() ? -1 : link->second, result);
+        });
+    } else {
+        scanFile(segment, counters,
+                 [&](const char* record) { reader.visit(record, -1, result); });
+    }
+}
+
+/**********************************************
+ * Function: addLinked
+ * Description: Adds requests read from the links to a result, as rows of the
+ *              columns the links hold.
+ **********************************************/
+static void addLinked(const Statement& statement, const std::vector<LinkedRequest>& requests, Counters& counters, Result& result) {
+    counters.records += static_cast<long long>(requests.size());
+    counters.bytes += static_cast<long long>(requests.size()) * REQUEST_LINK_SIZE;
+    std::vector<Value> row(SOURCES[SOURCE_REQUESTS].columns.size());
+    for (const LinkedRequest& request : requests) {
+        setNumber(row[COL_REQUEST_ID], request.requestId);
+        setText(row[COL_REQUEST_REQUESTER], request.requester);
+        setText(row[COL_REQUEST_PRODUCT], request.product);
+        setNumber(row[COL_REQUEST_ITEM], request.changeItemId);
+        if (matches(statement, row))
+            result.add(row, 1);
+    }
+}
+
+/**********************************************
+ * Function: execute
+ * Description: Runs a plan, counting the records and bytes it reads.
+ **********************************************/
+static void execute(const Statement& statement, const Plan& plan, Counters& counters, Result& result) {
+    switch (plan.access) {
+    case RELEASE_INDEX: {
+        std::vector<ReleaseSummary> summaries = ReleaseIndex::releases("");
+        counters.records += static_cast<long long>(summaries.size());
+        counters.bytes += static_cast<long long>(summaries.size()) * RELEASE_ENTRY_SIZE;
+        std::vector<Value> row(SOURCES[SOURCE_ITEMS].columns.size());
+        for (const ReleaseSummary& summary : summaries) {
+            setText(row[COL_ITEM_PRODUCT], summary.product);
+            setText(row[COL_ITEM_RELEASE], summary.releaseId);
+            for (int state = 0; state < 4; ++state) {
+                setNumber(row[COL_ITEM_STATE], state);
+                if (summary.counts[state] > 0 && matches(statement, row))
+                    result.add(row, summary.counts[state]);
+            }
+        }
+        return;
+    }
+    case RELEASE_POSTINGS: {
+        std::vector<Value> row(SOURCES[SOURCE_ITEMS].columns.size());
+        std::vector<ReleasePosting> postings;
+        for (const Value& product : plan.keys) {
+            for (const Value& release : plan.releases) {
+                if (!ReleaseIndex::postings(product.text, release.text, postings))
+                    continue;
+                long long blocks = (static_cast<long long>(postings.size()) + POSTINGS_PER_BLOCK - 1) / POSTINGS_PER_BLOCK;
+                counters.records += static_cast<long long>(postings.size());
+                counters.bytes += blocks * RELEASE_BLOCK_SIZE;
+                setText(row[COL_ITEM_PRODUCT], product.text);
+                setText(row[COL_ITEM_RELEASE], release.text);
+                for (const ReleasePosting& posting : postings) {
+                    setNumber(row[COL_ITEM_ID], posting.changeId);
+                    setNumber(row[COL_ITEM_STATE], posting.state);
+                    if (matches(statement, row))
+                        result.add(row, 1);
+                }
+            }
+        }
+        return;
+    }
+    case LINK_CHAIN:
+        for (const Value& key : plan.keys) {
+            if (plan.keyColumn == COL_REQUEST_ITEM)
+                addLinked(statement, RequestLinks::requestsForItem(static_cast<int>(key.number)), counters, result);
+            else
+                addLinked(statement, RequestLinks::requestsByRequester(key.text), counters, result);
+        }
+        return;
+    case LINK_SCAN:
+        addLinked(statement, RequestLinks::allRequests(), counters, result);
+        return;
+    default:
+        break;
+    }
+
+    std::unordered_map<int, int> links;
+    if (plan.joinLinks) {
+        std::vector<LinkedRequest> requests = RequestLinks::allRequests();
+        counters.records += static_cast<long long>(requests.size());
+        counters.bytes += static_cast<long long>(requests.size()) * REQUEST_LINK_SIZE;
+        for (const LinkedRequest& request : requests)
+            links[request.requestId] = request.changeItemId;
+    }
+    if (plan.access == FULL_SCAN || plan.segments.size() < 2) {
+        std::optional<Snapshot> snapshot;
+        for (const std::string& segment : plan.segments)
+            scanSegment(statement, segment, links, snapshot, counters, result);
+        return;
+    }
+    // Each segment fills its own result through its own snapshot; merging them in
+    // segment order keeps the output the same as a full scan's. No item moves to or
+    // from an archive between those snapshots; the files are brought up to date
+    // first, since an upgrade waits for the archive readers.
+    std::optional<ItemArchive::ReadScope> archiveScope;
+    if (statement.source == SOURCE_ITEMS) {
+        for (const std::string& segment : StorageLayout::itemFiles())
+            FileFormat::ensureCurrent(segment);
+        archiveScope.emplace();
+    }
+    std::vector<Result> partial(plan.segments.size(), Result(statement));
+    std::map<std::string, size_t> position;
+    for (size_t i = 0; i < plan.segments.size(); ++i)
+        position[plan.segments[i]] = i;
+    StorageLayout::forEachSegment(plan.segments, [&](const std::string& segment) {
+        std::optional<Snapshot> snapshot;
+        scanSegment(statement, segment, links, snapshot, counters, partial[position.at(segment)]);
+    });
+    for (const Result& each : partial)
+        result.merge(each);
+}
+
+//================================
+// Output
+//================================
+
+/**********************************************
+ * Function: printResult
+ * Description: Prints the rows of a listing with aligned columns, or the count of every group.
+ **********************************************/
+static void printResult(const Statement& statement, const Result& result, std::ostream& out) {
+    const Source& source = SOURCES[statement.source];
+    if (result.matched == 0) {
+        out << "No " << source.name << " matched." << std::endl;
+        return;
+    }
+    std::vector<int> columns = outputColumns(statement);
+    std::vector<std::vector<std::string>> lines;
+    if (statement.groupBy >= 0) {
+        lines.push_back({source.columns[statement.groupBy].name, "count"});
+        for (const auto& group : result.groups) {
+            if (statement.limit >= 0 && static_cast<long long>(lines.size()) > statement.limit)
+                break;
+            lines.push_back({formatValue(source.columns[statement.groupBy], group.first), std::to_string(group.second)});
+        }
+    } else {
+        lines.emplace_back();
+        for (int column : columns)
+            lines.back().push_back(source.columns[column].name);
+        for (const auto& row : result.rows) {
+            lines.emplace_back();
+            for (int column : columns)
+                lines.back().push_back(formatValue(source.columns[column], row[column]));
+        }
+    }
+    std::vector<size_t> widths(lines[0].size(), 0);
+    for (const auto& line : lines)
+        for (size_t i = 0; i < line.size(); ++i)
+            widths[i] = std::max(widths[i], line[i].size());
+    for (const auto& line : lines) {
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (i + 1 < line.size())
+                out << std::left << std::setw(static_cast<int>(widths[i] + 2)) << line[i];
+            else
+                out << line[i];
+        }
+        out << '\n';
+    }
+    out << std::right;
+    if (statement.groupBy >= 0)
+        out << (lines.size() - 1 < result.groups.size() ? std::to_string(lines.size() - 1) + " of " : "")
+            << result.groups.size() << " groups, " << result.matched << " " << source.name << "." << std::endl;
+    else if (static_cast<long long>(result.rows.size()) < result.matched)
+        out << result.rows.size() << " of " << result.matched << " " << source.name << "." << std::endl;
+    else
+        out << result.matched << " " << source.name << "." << std::endl;
+}
+
+/**********************************************
+ * Function: describeFilter
+ * Description: Returns the filter of a statement as explain prints it.
+ **********************************************/
+static std::string describeFilter(const Statement& statement) {
+    const Source& source = SOURCES[statement.source];
+    std::string text;
+    for (const Condition& condition : statement.conditions) {
+        const Column& column = source.columns[condition.column];
+        text += text.empty() ? "" : " and ";
+        text += std::string(column.name) + " " + OPERATOR_NAMES[condition.op] + " ";
+        if (condition.op == OP_IN)
+            text += "(";
+        for (size_t i = 0; i < condition.values.size(); ++i)
+            text += (i ? ", " : "") + formatValue(column, condition.values[i]);
+        if (condition.op == OP_IN)
+            text += ")";
+    }
+    return text.empty() ? "none" : text;
+}
+
+/**********************************************
+ * Function: printExplain
+ * Description: Prints the chosen plan with its estimate, the plans it was chosen
+ *              over, and what running it read and produced.
+ **********************************************/
+static void printExplain(const Statement& statement, const std::vector<Plan>& candidates, const SourceStats& stats,
+                         const Counters& counters, const Result& result, double milliseconds, std::ostream& out) {
+    const Plan& plan = candidates.front();
+    out << "Source:      " << SOURCES[statement.source].name << '\n';
+    out << "Access:      " << ACCESS_NAMES[plan.access] << " (" << plan.detail << ")"
+        << (plan.joinLinks ? ", joined with the request links" : "") << '\n';
+    for (const std::string& segment : plan.segments)
+        out << "             " << segment << '\n';
+    out << "Filter:      " << describeFilter(statement) << '\n';
+    if (statement.groupBy >= 0)
+        out << "Group by:    " << SOURCES[statement.source].columns[statement.groupBy].name << '\n';
+    out << "Statistics:  ";
+    if (stats.present)
+        out << stats.rows << " rows when analyzed" << '\n';
+    else
+        out << "none, default selectivities (run analyze " << SOURCES[statement.source].name << ")" << '\n';
+    out << "Estimate:    " << std::llround(plan.estimatedRows) << " rows, " << plan.estimatedBytes << " bytes" << '\n';
+    for (size_t i = 1; i < candidates.size(); ++i)
+        out << "Considered:  " << ACCESS_NAMES[candidates[i].access] << " (" << candidates[i].detail << "), "
+            << candidates[i].estimatedBytes << " bytes" << '\n';
+    out << "Touched:     " << counters.records.load() << " records, " << counters.bytes.load() << " bytes read" << '\n';
+    out << "Rows out:    " << result.matched;
+    if (statement.groupBy >= 0)
+        out << " in " << result.groups.size() << " groups";
+    out << '\n';
+    out << "Time:        " << std::fixed << std::setprecision(3) << milliseconds << " ms" << std::defaultfloat << std::endl;
+}
+
+//================================
+// Analyze
+//================================
+
+/**********************************************
+ * Function: analyzeSource
+ * Description: Reads every record of a source and collects its statistics.
+ **********************************************/
+static SourceStats analyzeSource(int source, Counters& counters) {
+    Statement statement;
+    statement.source = source;
+    const size_t columnCount = SOURCES[source].columns.size();
+    std::vector<std::unordered_map<std::string, long long>> counts(columnCount);
+    SourceStats stats;
+    stats.present = true;
+    stats.analyzedAt = static_cast<long long>(std::time(nullptr));
+    stats.columns.assign(columnCount, ColumnStats());
+    std::vector<bool> seen(columnCount, false);
+
+    std::unordered_map<int, int> links;
+    if (source == SOURCE_REQUESTS)
+        for (const LinkedRequest& request : RequestLinks::allRequests())
+            links[request.requestId] = request.changeItemId;
+    Value value;
+    auto collect = [&](const char* record, int linkedItem) {
+        ++stats.rows;
+        for (size_t i = 0; i < columnCount; ++i) {
+            extract(source, record, linkedItem, static_cast<int>(i), value);
+            ++counts[i][valueKey(value)];
+            if (!value.isText) {
+                ColumnStats& column = stats.columns[i];
+                column.minimum = seen[i] ? std::min(column.minimum, value.number) : value.number;
+                column.maximum = seen[i] ? std::max(column.maximum, value.number) : value.number;
+                seen[i] = true;
+            }
+        }
+    };
+    std::optional<Snapshot> snapshot;
+    if (source == SOURCE_ITEMS)
+        snapshot.emplace();
+    for (const std::string& segment : sourceFiles(source)) {
+        if (source == SOURCE_ITEMS) {
+            snapshot->scan(segment, [&](const ChangeItem& item) {
+                ++counters.records;
+                counters.bytes += static_cast<long long>(sizeof(ChangeItem));
+                collect(reinterpret_cast<const char*>(&item), -1);
+            });
+        } else {
+            scanFile(segment, counters, [&](const char* record) {
+                int linkedItem = -1;
+                if (source == SOURCE_REQUESTS) {
+                    auto link = links.find(Schema<ChangeRequest>::read<ChangeRequest::FIELD_CHANGE_ID>(record));
+                    linkedItem = link == links.end() ? -1 : link->second;
+                }
+                collect(record, linkedItem);
+            });
+        }
+    }
+    for (size_t i = 0; i < columnCount; ++i) {
+        ColumnStats& column = stats.columns[i];
+        column.distinct = static_cast<long long>(counts[i].size());
+        std::vector<std::pair<std::string, long long>> values(counts[i].begin(), counts[i].end());
+        size_t kept = std::min(COMMON_VALUES, values.size());
+        std::partial_sort(values.begin(), values.begin() + static_cast<long>(kept), values.end(), [](const auto& a, const auto& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+        values.resize(kept);
+        column.common = values;
+    }
+    return stats;
+}
+
+/**********************************************
+ * Function: analyze
+ * Description: Collects the statistics of one source, or of every source, and
+ *              saves them with those of the other sources.
+ **********************************************/
+static int analyze(const Statement& statement, std::ostream& out) {
+    std::vector<SourceStats> stats = loadStats();
+    for (int source = 0; source < SOURCE_COUNT; ++source) {
+        if (statement.source >= 0 && source != statement.source)
+            continue;
+        Counters counters;
+        stats[source] = analyzeSource(source, counters);
+        out << "Analyzed " << SOURCES[source].name << ": " << stats[source].rows << " rows, "
+            << counters.bytes.load() << " bytes read." << '\n';
+        for (size_t i = 0; i < stats[source].columns.size(); ++i)
+            out << "  " << std::left << std::setw(12) << SOURCES[source].columns[i].name << std::right
+                << stats[source].columns[i].distinct << " distinct" << '\n';
+    }
+    if (!saveStats(stats)) {
+        std::cerr << "Could not write " << QUERY_STATS_FILE << "." << std::endl;
+        return 1;
+    }
+    out << std::flush;
+    return 0;
+}
+
+//================================
+// Public Functions
+//================================
+
+/**********************************************
+ * Function: Query::run
+ * Description: Parses, plans and runs one statement.
+ * Parameters:
+ * - text: The statement
+ * - out: Where the result or the plan is printed
+ * Returns: int - 0 on success, 1 if nothing matched, 2 for a statement that could not be parsed.
+ **********************************************/
+int Query::run(const std::string& text, std::ostream& out) {
+    Metrics::Timer timer(Metrics::QUERY_RUN);
+    std::vector<Token> tokens;
+    std::string error;
+    Statement statement;
+    if (!tokenize(text, tokens, error) || !Parser(tokens, error).parse(statement)) {
+        std::cerr << "Query error: " << error << std::endl;
+        return 2;
+    }
+    if (statement.analyze)
+        return analyze(statement, out);
+
+    SourceStats stats = loadStats()[statement.source];
+    double rows = 0;
+    std::vector<Plan> candidates = plans(statement, stats, rows);
+    Counters counters;
+    Result result(statement);
+    auto start = std::chrono::steady_clock::now();
+    execute(statement, candidates.front(), counters, result);
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (statement.explain)
+        printExplain(statement, candidates, stats, counters, result, milliseconds, out);
+    else
+        printResult(statement, result, out);
+    return result.matched > 0 ? 0 : 1;
+}
+
+/**********************************************
+ * Function: Query::runLines
+ * Description: Runs one statement per line.
+ * Parameters:
+ * - in: The statements
+ * - out: Where the results are printed
+ * Returns: int - The status of the last statement that failed, or 0.
+ **********************************************/
+int Query::runLines(std::istream& in, std::ostream& out) {
+    int status = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        int result = run(line, out);
+        if (result != 0)
+            status = result;
+    }
+    return status;
+}
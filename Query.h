@@ -0,0 +1,63 @@
+/**********************************************
+ * Query Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module answers ad hoc questions about the tracker's data with a small
+ * filter and aggregate language, instead of a menu flow per question:
+ *
+ *     [explain] <source> [where <condition> {and <condition>}]
+ *               [group by <column>] [show <column> {, <column>}] [limit <n>]
+ *     analyze [<source>]
+ *
+ * The sources are items, requests, releases and requesters. A condition is
+ * "<column> <op> <value>" with op one of = != < <= > >=, or
+ * "<column> in (<value>, ...)". Values are numbers, words or quoted text; states
+ * are given by name. Without group by the matching rows are listed, otherwise
+ * the number of matching rows per value of the column.
+ *
+ * A planner picks how to read the source: a full scan, a parallel scan over the
+ * segments, a scan of only the segments of the products asked for, or an index
+ * that holds every column the query uses (the release index for items, the
+ * request links for requests). It compares the bytes each would read, estimated
+ * from the file sizes and from cardinality statistics (row counts, distinct
+ * values and the most common values of each column) that "analyze" collects into
+ * QUERY_STATS_FILE. "explain" runs the query and prints the chosen plan with its
+ * estimate, the plans it was chosen over, and the records touched and bytes read.
+ **********************************************/
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <iostream>
+#include <string>
+
+//=============================
+// Constants
+//=============================
+const char* const QUERY_STATS_FILE = "Query.stats";   // Cardinality statistics written by analyze
+
+//=============================
+// Class Declaration
+//=============================
+
+class Query {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static int run(const std::string& text, std::ostream& out);
+    // Description: Parses, plans and runs one query or analyze statement and prints its result,
+    //              or the plan and execution counters for explain. Errors go to std::cerr.
+    // Returns: int - The process exit status: 0 on success, 1 for a query that matched nothing,
+    //          2 for a query that could not be parsed.
+
+    //----------------------------------------------------------
+    static int runLines(std::istream& in, std::ostream& out);
+    // Description: Runs one query per line until the end of the input, skipping blank lines.
+    // Returns: int - The status of the last query that failed, or 0.
+};
+
+#endif // QUERY_H
@@ -0,0 +1,35 @@
+/**********************************************
+ * QueryArena Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module implements the per-query arena on std::pmr::monotonic_buffer_resource,
+ * which already allocates by bumping a pointer and releases all of its blocks in
+ * one call. The inline buffer is handed to it as the first block.
+ **********************************************/
+#include "QueryArena.h"
+
+/**********************************************
+ * Constructor: QueryArena
+ * Description: Starts allocating from the inline buffer, then from the heap.
+ **********************************************/
+QueryArena::QueryArena() : memory(inlineBuffer, sizeof(inlineBuffer), std::pmr::new_delete_resource()) {}
+
+/**********************************************
+ * Function: resource
+ * Description: Returns the allocator that containers of the query are built on.
+ **********************************************/
+std::pmr::memory_resource* QueryArena::resource() {
+    return &memory;
+}
+
+/**********************************************
+ * Function: reset
+ * Description:
+ * Gives back the heap blocks in one pass over the block list and starts
+ * allocating from the inline buffer again. No destructors are run.
+ **********************************************/
+void QueryArena::reset() {
+    memory.release();
+}
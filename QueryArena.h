@@ -0,0 +1,86 @@
+/**********************************************
+ * QueryArena Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module gives one query a private region of memory for its result set.
+ * Allocations only move a pointer forward, starting in a buffer inside the arena
+ * object itself, so a query that fits there never touches the heap. Larger
+ * results take more blocks from the heap, each twice the size of the last, so the
+ * number of heap allocations grows with the logarithm of the result size, not with
+ * the number of records. Nothing is freed one by one: everything goes at once when
+ * the arena is reset or destroyed at the end of the query.
+ *
+ * Result sets are std::pmr containers that draw from the arena, e.g.
+ *     QueryArena arena;
+ *     ArenaVector<ChangeItem> changeItems = ChangeItem::listChangeItems(product, arena);
+ * Anything allocated from an arena must not outlive it.
+ **********************************************/
+#ifndef QUERYARENA_H
+#define QUERYARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const size_t QUERY_ARENA_INLINE_BYTES = 16 * 1024;   // Held in the arena object, e.g. 75 change items
+
+//=============================
+// Type Declarations
+//=============================
+template <typename T>
+using ArenaVector = std::pmr::vector<T>;
+// Description: A vector whose storage comes from a QueryArena.
+
+//=============================
+// Class Declaration
+//=============================
+
+class QueryArena {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    QueryArena();
+    // Description: Creates an empty arena. Meant to live on the stack for one query.
+
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    std::pmr::memory_resource* resource();
+    // Description: Returns the allocator that containers of the query are built on.
+
+    //----------------------------------------------------------
+    template <typename T>
+    ArenaVector<T> vector();
+    // Description: Returns an empty vector allocating from the arena.
+
+    //----------------------------------------------------------
+    void reset();
+    // Description: Frees everything allocated from the arena at once, so it can serve the
+    //              next query. Containers built on it must be gone or never used again.
+
+private:
+    alignas(std::max_align_t) std::byte inlineBuffer[QUERY_ARENA_INLINE_BYTES];
+    std::pmr::monotonic_buffer_resource memory;
+};
+
+//=============================
+// Template Implementations
+//=============================
+template <typename T>
+ArenaVector<T> QueryArena::vector() {
+    return ArenaVector<T>(resource());
+}
+
+#endif // QUERYARENA_H
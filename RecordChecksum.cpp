@@ -0,0 +1,757 @@
+/**********************************************
+ * RecordChecksum Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: The scrubber checks each data file at the record size of the version it is stored in.
+ * - 2026-10-19: The scrubber checks archives block by block against the checksums in their block index.
+ * - 2026-10-19: recheck rereads a failing record once under the record and append locks.
+ * - 2026-10-19: The POSIX headers and calls are guarded for Windows, with seek-and-read fallbacks.
+ *--------------------------------
+ * Purpose:
+ * This module implements the record checksums. CRC32C is computed with the SSE4.2
+ * or ARMv8 CRC instructions when the processor has them, and otherwise with
+ * slicing-by-8 tables, which give the same values. Checksum files are read and
+ * written with positional I/O, so threads sharing one never move each other's
+ * file position; on Windows, which has none, each descriptor is used by a single
+ * thread and seeked instead.
+ *
+ * The scrubber cuts every data file into chunks of whole records and has each
+ * thread take the next chunk until none are left. A record that fails is checked
+ * once more under a shared lock on its bytes and the append sentinel of its file,
+ * which waits out an update or append in progress, before it is counted as bad.
+ * An archive is a block file, whose chunks are its blocks: each is read through
+ * BlockReader, which checks it against its CRC32C in the block index.
+ **********************************************/
+#include "RecordChecksum.h"
+#include "BlockFile.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "StorageLayout.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#define O_CLOEXEC _O_BINARY // No descriptors are inherited; checksums must not pass through text mode
+#define NEW_FILE_MODE (_S_IREAD | _S_IWRITE)
+#else
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#define NEW_FILE_MODE 0644
+#endif
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+//================================
+// Constants
+//================================
+static const uint32_t CASTAGNOLI = 0x82F63B78;            // The CRC32C polynomial, bit-reversed
+static const uint32_t ZERO_CRC_STORED = 0xFFFFFFFF;        // Stored for a CRC of 0, since 0 means none
+static const size_t WINDOW_RECORDS = 4096;                 // Checksums a reader loads at a time
+static const long long SCRUB_CHUNK_BYTES = 4 << 20;        // Bytes per scrubber step at full speed
+static const long long THROTTLED_CHUNK_BYTES = 256 << 10;  // Bytes per scrubber step when the rate is limited
+static const size_t REPORTED_BAD_RECORDS = 10;             // Bad records listed per file by the scrubber
+
+//================================
+// CRC32C
+//================================
+
+// The slicing-by-8 tables: TABLES[0] is the bytewise table, TABLES[k] advances a
+// byte k further through the register.
+static const std::array<std::array<uint32_t, 256>, 8> TABLES = [] {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? (crc >> 1) ^ CASTAGNOLI : crc >> 1;
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++)
+        for (size_t k = 1; k < 8; k++)
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+    return tables;
+}();
+
+/**********************************************
+ * Function: crc32cSoftware
+ * Description: Advances a CRC32C register over the bytes, eight at a time.
+ **********************************************/
+static uint32_t crc32cSoftware(const unsigned char* bytes, size_t length, uint32_t crc) {
+    while (length >= 8) {
+        uint32_t low, high;
+        std::memcpy(&low, bytes, 4);
+        std::memcpy(&high, bytes + 4, 4);
+        low ^= crc;
+        crc = TABLES[7][low & 0xFF] ^ TABLES[6][(low >> 8) & 0xFF] ^ TABLES[5][(low >> 16) & 0xFF] ^ TABLES[4][low >> 24] ^
+              TABLES[3][high & 0xFF] ^ TABLES[2][(high >> 8) & 0xFF] ^ TABLES[1][(high >> 16) & 0xFF] ^ TABLES[0][high >> 24];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0)
+        crc = (crc >> 8) ^ TABLES[0][(crc ^ *bytes++) & 0xFF];
+    return crc;
+}
+
+#if defined(__x86_64__)
+/**********************************************
+ * Function: crc32cHardware
+ * Description: Advances a CRC32C register with the SSE4.2 crc32 instruction.
+ **********************************************/
+__attribute__((target("sse4.2")))
+static uint32_t crc32cHardware(const unsigned char* bytes, size_t length, uint32_t crc) {
+    uint64_t wide = crc;
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        wide = _mm_crc32_u64(wide, word);
+        bytes += 8;
+        length -= 8;
+    }
+    crc = static_cast<uint32_t>(wide);
+    while (length-- > 0)
+        crc = _mm_crc32_u8(crc, *bytes++);
+    return crc;
+}
+
+static const bool HARDWARE_CRC = __builtin_cpu_supports("sse4.2");
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+static uint32_t crc32cHardware(const unsigned char* bytes, size_t length, uint32_t crc) {
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        crc = __crc32cd(crc, word);
+        bytes += 8;
+        length -= 8;
+    }
+    while (length-- > 0)
+        crc = __crc32cb(crc, *bytes++);
+    return crc;
+}
+
+static const bool HARDWARE_CRC = true;
+#else
+static uint32_t crc32cHardware(const unsigned char* bytes, size_t length, uint32_t crc) {
+    return crc32cSoftware(bytes, length, crc);
+}
+
+static const bool HARDWARE_CRC = false;
+#endif
+
+/**********************************************
+ * Function: storedForm
+ * Description: Returns the value a checksum file holds for a record's CRC.
+ **********************************************/
+static uint32_t storedForm(uint32_t crc) {
+    return crc == 0 ? ZERO_CRC_STORED : crc;
+}
+
+/**********************************************
+ * Function: recordSum
+ * Description: Returns the stored form of one record's checksum.
+ **********************************************/
+static uint32_t recordSum(const void* record, size_t recordSize) {
+    return storedForm(RecordChecksum::crc32c(record, recordSize));
+}
+
+//================================
+// File Helpers
+//================================
+
+/**********************************************
+ * Function: readAt
+ * Description: Reads up to length bytes at offset, retrying short reads.
+ * Returns: long long - The bytes read, which is less than length only at the end of the file.
+ **********************************************/
+static long long readAt(int fd, void* buffer, size_t length, long long offset) {
+    size_t done = 0;
+#ifdef _WIN32
+    // No positional reads: every descriptor here belongs to one thread, so seeking is safe
+    if (_lseeki64(fd, offset, SEEK_SET) < 0)
+        return 0;
+    while (done < length) {
+        int count = _read(fd, static_cast<char*>(buffer) + done, static_cast<unsigned int>(std::min<size_t>(length - done, 1 << 30)));
+        if (count <= 0)
+            break;
+        done += static_cast<size_t>(count);
+    }
+#else
+    while (done < length) {
+        ssize_t count = ::pread(fd, static_cast<char*>(buffer) + done, length - done, static_cast<off_t>(offset + done));
+        if (count <= 0)
+            break;
+        done += static_cast<size_t>(count);
+    }
+#endif
+    return static_cast<long long>(done);
+}
+
+/**********************************************
+ * Function: writeAt
+ * Description: Writes all length bytes at offset.
+ * Returns: bool - False on a write error.
+ **********************************************/
+static bool writeAt(int fd, const void* buffer, size_t length, long long offset) {
+    size_t done = 0;
+#ifdef _WIN32
+    if (_lseeki64(fd, offset, SEEK_SET) < 0)
+        return false;
+    while (done < length) {
+        int count = _write(fd, static_cast<const char*>(buffer) + done, static_cast<unsigned int>(std::min<size_t>(length - done, 1 << 30)));
+        if (count <= 0)
+            return false;
+        done += static_cast<size_t>(count);
+    }
+#else
+    while (done < length) {
+        ssize_t count = ::pwrite(fd, static_cast<const char*>(buffer) + done, length - done, static_cast<off_t>(offset + done));
+        if (count <= 0)
+            return false;
+        done += static_cast<size_t>(count);
+    }
+#endif
+    return true;
+}
+
+/**********************************************
+ * Function: readSums
+ * Description: Reads count stored checksums from record first on; those past the
+ *              end of the checksum file, or without one, read as 0.
+ **********************************************/
+static void readSums(int fd, long long first, size_t count, std::vector<uint32_t>& sums) {
+    sums.assign(count, 0);
+    if (fd >= 0)
+        readAt(fd, sums.data(), count * CHECKSUM_SIZE, first * CHECKSUM_SIZE);
+}
+
+/**********************************************
+ * Function: fileSize
+ * Description: Returns the size of a file, or 0 if it does not exist.
+ **********************************************/
+static long long fileSize(const std::string& path) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    return error ? 0 : static_cast<long long>(size);
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: crc32c
+ * Description: Computes the CRC32C of the bytes.
+ * Parameters:
+ * - data: The bytes
+ * - length: The number of bytes
+ * Returns: uint32_t - The CRC
+ **********************************************/
+uint32_t RecordChecksum::crc32c(const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t crc = HARDWARE_CRC ? crc32cHardware(bytes, length, 0xFFFFFFFF) : crc32cSoftware(bytes, length, 0xFFFFFFFF);
+    return ~crc;
+}
+
+/**********************************************
+ * Function: hardwareAccelerated
+ * Description: Reports whether crc32c uses the CRC instruction.
+ * Returns: bool - True if it does
+ **********************************************/
+bool RecordChecksum::hardwareAccelerated() {
+    return HARDWARE_CRC;
+}
+
+/**********************************************
+ * Function: checksumPath
+ * Description: Names the checksum file of a data file: the data file with its
+ *              extension replaced, e.g. "partitions/ChangeItem-^alpha.crc".
+ * Parameters:
+ * - dataPath: The data file
+ * Returns: std::string - The checksum file
+ **********************************************/
+std::string RecordChecksum::checksumPath(const std::string& dataPath) {
+    return std::filesystem::path(dataPath).replace_extension(CHECKSUM_EXTENSION).string();
+}
+
+/**********************************************
+ * Function: store
+ * Description: Computes and writes the checksums of records written at offset.
+ * Parameters:
+ * - dataPath: The data file the records are written to
+ * - recordSize: Bytes per record
+ * - offset: The offset of the first record in the data file
+ * - records: The records, back to back
+ * - count: The number of records
+ * Returns: bool - False if the checksum file could not be written
+ **********************************************/
+bool RecordChecksum::store(const std::string& dataPath, size_t recordSize, long long offset, const void* records, size_t count) {
+    std::vector<uint32_t> sums(count);
+    for (size_t i = 0; i < count; i++)
+        sums[i] = recordSum(static_cast<const char*>(records) + i * recordSize, recordSize);
+    int fd = ::open(checksumPath(dataPath).c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, NEW_FILE_MODE);
+    if (fd < 0)
+        return false;
+    bool written = writeAt(fd, sums.data(), count * CHECKSUM_SIZE, offset / static_cast<long long>(recordSize) * CHECKSUM_SIZE);
+    ::close(fd);
+    return written;
+}
+
+/**********************************************
+ * Function: copy
+ * Description: Copies stored checksums between checksum files. Records the source
+ *              has no checksum for lose theirs in the target too.
+ * Parameters:
+ * - fromDataPath: The data file the records were copied from
+ * - toDataPath: The data file they were copied to, at the same offset
+ * - recordSize: Bytes per record
+ * - offset: The offset of the first record
+ * - length: The bytes of records copied
+ * Returns: bool - False if the target checksum file could not be written
+ **********************************************/
+bool RecordChecksum::copy(const std::string& fromDataPath, const std::string& toDataPath, size_t recordSize, long long offset, long long length) {
+    long long first = offset / static_cast<long long>(recordSize);
+    size_t count = static_cast<size_t>(length / static_cast<long long>(recordSize));
+    if (count == 0)
+        return true;
+    int from = ::open(checksumPath(fromDataPath).c_str(), O_RDONLY | O_CLOEXEC);
+    std::vector<uint32_t> sums;
+    readSums(from, first, count, sums);
+    if (from >= 0)
+        ::close(from);
+    int to = ::open(checksumPath(toDataPath).c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, NEW_FILE_MODE);
+    if (to < 0)
+        return false;
+    bool written = writeAt(to, sums.data(), count * CHECKSUM_SIZE, first * CHECKSUM_SIZE);
+    ::close(to);
+    return written;
+}
+
+/**********************************************
+ * Function: truncate
+ * Description: Drops the checksums of records beyond a data file's new size.
+ * Parameters:
+ * - dataPath: The data file
+ * - recordSize: Bytes per record
+ * - size: The data file's size
+ **********************************************/
+void RecordChecksum::truncate(const std::string& dataPath, size_t recordSize, long long size) {
+    std::string path = checksumPath(dataPath);
+    long long keep = size / static_cast<long long>(recordSize) * CHECKSUM_SIZE;
+    std::error_code error;
+    if (std::filesystem::exists(path, error) && fileSize(path) > keep)
+        std::filesystem::resize_file(path, static_cast<uintmax_t>(keep), error);
+}
+
+/**********************************************
+ * Function: init
+ * Description: Fills in the checksums a data file's records lack. Checks the two
+ *              file sizes first, so a covered file costs no reading; otherwise the
+ *              whole data file is locked while its records are read.
+ * Parameters:
+ * - dataPath: The data file
+ * - recordSize: Bytes per record
+ * Returns: bool - False if the checksum file could not be written
+ **********************************************/
+bool RecordChecksum::init(const std::string& dataPath, size_t recordSize) {
+    std::string path = checksumPath(dataPath);
+    if (fileSize(dataPath) / static_cast<long long>(recordSize) <= fileSize(path) / CHECKSUM_SIZE)
+        return true;
+
+    RecordLock fileLock(dataPath.c_str(), 0, APPEND_LOCK_OFFSET + 1, true);
+    long long records = fileSize(dataPath) / static_cast<long long>(recordSize);
+    int data = ::open(dataPath.c_str(), O_RDONLY | O_CLOEXEC);
+    int sumsFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, NEW_FILE_MODE);
+    bool written = data >= 0 && sumsFd >= 0;
+    std::vector<char> chunk(WINDOW_RECORDS * recordSize);
+    std::vector<uint32_t> sums;
+    for (long long first = 0; written && first < records; first += static_cast<long long>(WINDOW_RECORDS)) {
+        size_t count = static_cast<size_t>(std::min<long long>(records - first, static_cast<long long>(WINDOW_RECORDS)));
+        readSums(sumsFd, first, count, sums);
+        if (std::find(sums.begin(), sums.end(), 0u) == sums.end())
+            continue;
+        size_t whole = static_cast<size_t>(readAt(data, chunk.data(), count * recordSize, first * static_cast<long long>(recordSize))) / recordSize;
+        for (size_t i = 0; i < whole; i++) {
+            if (sums[i] == 0)
+                sums[i] = recordSum(chunk.data() + i * recordSize, recordSize);
+        }
+        written = writeAt(sumsFd, sums.data(), whole * CHECKSUM_SIZE, first * CHECKSUM_SIZE);
+    }
+    if (data >= 0)
+        ::close(data);
+    if (sumsFd >= 0)
+        ::close(sumsFd);
+    if (!written)
+        std::cerr << "Failed to record the checksums of " << dataPath << "." << std::endl;
+    return written;
+}
+
+/**********************************************
+ * Function: verify
+ * Description: Verifies one record with a reader of its own.
+ * Parameters:
+ * - dataPath: The data file the record was read from
+ * - recordSize: Bytes per record
+ * - offset: The record's offset
+ * - record: The record as read; replaced if a reread matches
+ * Returns: bool - False if the record fails its checksum
+ **********************************************/
+bool RecordChecksum::verify(const std::string& dataPath, size_t recordSize, long long offset, void* record) {
+    ChecksumReader reader(dataPath, recordSize);
+    return reader.check(offset, record);
+}
+
+/**********************************************
+ * Function: report
+ * Description: Warns about a bad record on std::cerr the first time this process
+ *              finds it.
+ * Parameters:
+ * - dataPath: The data file
+ * - recordSize: Bytes per record
+ * - offset: The record's offset
+ **********************************************/
+void RecordChecksum::report(const std::string& dataPath, size_t recordSize, long long offset) {
+    static std::mutex reportedMutex;
+    static std::set<std::pair<std::string, long long>> reported;
+    std::lock_guard<std::mutex> lock(reportedMutex);
+    if (!reported.emplace(dataPath, offset).second)
+        return;
+    std::cerr << "Record " << offset / static_cast<long long>(recordSize) << " of " << dataPath
+              << " fails its checksum and is skipped; run --scrub to check every record." << std::endl;
+}
+
+//================================
+// Checksum Reader
+//================================
+
+ChecksumReader::ChecksumReader(const std::string& dataPath, size_t recordSize) : dataPath(dataPath), recordSize(recordSize) {}
+
+ChecksumReader::~ChecksumReader() {
+    if (checksumFd >= 0)
+        ::close(checksumFd);
+    if (dataFd >= 0)
+        ::close(dataFd);
+}
+
+/**********************************************
+ * Function: ChecksumReader::load
+ * Description: Loads the stored checksums of WINDOW_RECORDS records from index on.
+ *              The checksum file is opened on the first load; without one the
+ *              window stays empty and every record passes unchecked.
+ * Returns: bool - False if the data file has no checksum file
+ **********************************************/
+bool ChecksumReader::load(long long index) {
+    if (checksumFd < 0)
+        checksumFd = ::open(RecordChecksum::checksumPath(dataPath).c_str(), O_RDONLY | O_CLOEXEC);
+    first = index;
+    if (checksumFd < 0) {
+        first = -1; // Marks the missing file, so it is not looked for again
+        return false;
+    }
+    readSums(checksumFd, index, WINDOW_RECORDS, window);
+    return true;
+}
+
+/**********************************************
+ * Function: ChecksumReader::check
+ * Description: Verifies a record against the stored checksum.
+ * Parameters:
+ * - offset: The record's offset in the data file
+ * - record: The record as read; replaced if a reread matches
+ * Returns: bool - False if the record fails its checksum
+ **********************************************/
+bool ChecksumReader::check(long long offset, void* record) {
+    long long index = offset / static_cast<long long>(recordSize);
+    if (first < 0)
+        return true;
+    if (window.empty() || index < first || index >= first + static_cast<long long>(window.size())) {
+        if (!load(index))
+            return true;
+    }
+    uint32_t stored = window[static_cast<size_t>(index - first)];
+    if (stored == 0 || stored == recordSum(record, recordSize))
+        return true;
+    return recheck(offset, record);
+}
+
+/**********************************************
+ * Function: ChecksumReader::recheck
+ * Description: Reads a failing record and its checksum again once writes to it
+ *              are finished, as confirmBad does: under a shared lock on its bytes,
+ *              which waits for an update, and the append sentinel, which waits for
+ *              an append. A lock the calling thread holds already is not taken
+ *              again, since the thread would wait for itself.
+ * Returns: bool - True if the reread matched; the record then holds it
+ **********************************************/
+bool ChecksumReader::recheck(long long offset, void* record) {
+    long long index = offset / static_cast<long long>(recordSize);
+    long long length = static_cast<long long>(recordSize);
+    if (dataFd < 0)
+        dataFd = ::open(dataPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dataFd >= 0) { // Not locked otherwise, since locking creates a missing file
+        std::optional<RecordLock> recordLock;
+        std::optional<RecordLock> appendLock;
+        if (!RecordLock::heldByThread(dataPath.c_str(), offset, length))
+            recordLock.emplace(dataPath.c_str(), offset, length, false);
+        if (!RecordLock::heldByThread(dataPath.c_str(), APPEND_LOCK_OFFSET, 1))
+            appendLock.emplace(dataPath.c_str(), APPEND_LOCK_OFFSET, 1, true);
+        std::vector<char> fresh(recordSize);
+        uint32_t stored = 0;
+        if (readAt(checksumFd, &stored, sizeof(stored), index * CHECKSUM_SIZE) != CHECKSUM_SIZE)
+            stored = 0;
+        if (readAt(dataFd, fresh.data(), recordSize, offset) == length) {
+            window[static_cast<size_t>(index - first)] = stored;
+            if (stored == 0 || stored == recordSum(fresh.data(), recordSize)) {
+                std::memcpy(record, fresh.data(), recordSize);
+                return true;
+            }
+        }
+    }
+    RecordChecksum::report(dataPath, recordSize, offset);
+    return false;
+}
+
+//================================
+// Scrubber
+//================================
+
+// A data file as the scrubber sees it.
+struct ScrubFile {
+    std::string name;           // Relative to the directory, as printed
+    std::string path;
+    size_t recordSize;
+    long long records;
+    std::atomic<long long> unchecked{0};
+    std::atomic<long long> bad{0};
+    std::mutex badMutex;
+    std::vector<long long> badRecords;         // Or bad blocks, for a block file
+    std::unique_ptr<BlockReader> blocks;       // Set for a block file, which is checked block by block
+    bool damagedIndex = false;
+};
+
+// A run of whole records of one file, or one block of a block file, read in one step.
+struct ScrubChunk {
+    size_t file;
+    long long first;
+    long long count;
+};
+
+/**********************************************
+ * Function: scrubFiles
+ * Description: Lists the data files of a directory with their stored record sizes:
+ *              the five single files and the segments of a partitioned directory.
+ *              A file written by a newer program is left out.
+ **********************************************/
+static void scrubFiles(const std::string& directory, std::deque<ScrubFile>& files) {
+    for (const std::string& name : StorageLayout::dataFiles(directory)) {
+        std::string path = (std::filesystem::path(directory) / name).string();
+        RecordLayout layout = FileFormat::layout(path);
+        if (!layout.known())
+            continue;
+        ScrubFile& file = files.emplace_back();
+        file.name = name;
+        file.path = path;
+        file.recordSize = layout.size;
+        if (StorageLayout::isArchive(path)) {
+            file.blocks = std::make_unique<BlockReader>(path);
+            file.records = file.blocks->records();
+            if (!file.blocks->valid() && fileSize(path) > 0) {
+                file.damagedIndex = true;
+                file.bad = 1;
+            }
+        } else {
+            file.records = fileSize(path) / static_cast<long long>(layout.size);
+        }
+    }
+}
+
+/**********************************************
+ * Function: confirmBad
+ * Description: Reads a failing record and its checksum again once writes to it
+ *              are finished: under a shared lock on its bytes, which waits for an
+ *              update, and the append sentinel, which waits for an append.
+ * Returns: bool - True if the record still fails
+ **********************************************/
+static bool confirmBad(const ScrubFile& file, long long index) {
+    long long offset = index * static_cast<long long>(file.recordSize);
+    RecordLock recordLock(file.path.c_str(), offset, static_cast<long long>(file.recordSize), false);
+    RecordLock appendLock(file.path.c_str(), APPEND_LOCK_OFFSET, 1, true);
+    int data = ::open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    int sums = ::open(RecordChecksum::checksumPath(file.path).c_str(), O_RDONLY | O_CLOEXEC);
+    std::vector<char> record(file.recordSize);
+    uint32_t stored = 0;
+    bool bad = data >= 0 && sums >= 0 &&
+               readAt(data, record.data(), file.recordSize, offset) == static_cast<long long>(file.recordSize) &&
+               readAt(sums, &stored, sizeof(stored), index * CHECKSUM_SIZE) == CHECKSUM_SIZE &&
+               stored != 0 && stored != recordSum(record.data(), file.recordSize);
+    if (data >= 0)
+        ::close(data);
+    if (sums >= 0)
+        ::close(sums);
+    return bad;
+}
+
+/**********************************************
+ * Function: lowerPriority
+ * Description: Moves the calling thread to the lowest CPU priority and, on Linux,
+ *              to the idle I/O class, so interactive work is served first. Does
+ *              nothing on Windows, where only the rate limit applies.
+ **********************************************/
+static void lowerPriority() {
+#if defined(__linux__)
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 19);
+    const int IOPRIO_WHO_PROCESS = 1;
+    const int IOPRIO_CLASS_IDLE = 3;
+    const int IOPRIO_CLASS_SHIFT = 13;
+    ::syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+#elif !defined(_WIN32)
+    ::setpriority(PRIO_PROCESS, 0, 19);
+#endif
+}
+
+/**********************************************
+ * Function: scrubChunk
+ * Description: Verifies one chunk of records, or one block of a block file.
+ * Returns: long long - The bytes read, or the bytes of the block's records
+ **********************************************/
+static long long scrubChunk(ScrubFile& file, const ScrubChunk& chunk, std::vector<char>& buffer, std::vector<uint32_t>& sums) {
+    if (file.blocks) {
+        // Never written in place, so a failure needs no second look
+        size_t records = file.blocks->blockRecords(static_cast<size_t>(chunk.first));
+        if (!file.blocks->readBlock(static_cast<size_t>(chunk.first), buffer)) {
+            file.bad += static_cast<long long>(records);
+            std::lock_guard<std::mutex> lock(file.badMutex);
+            file.badRecords.push_back(chunk.first);
+        }
+        return static_cast<long long>(records * file.recordSize);
+    }
+    int data = ::open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (data < 0)
+        return 0;
+    int sumsFd = ::open(RecordChecksum::checksumPath(file.path).c_str(), O_RDONLY | O_CLOEXEC);
+    long long offset = chunk.first * static_cast<long long>(file.recordSize);
+    size_t bytes = static_cast<size_t>(chunk.count) * file.recordSize;
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(data, static_cast<off_t>(offset), static_cast<off_t>(bytes), POSIX_FADV_SEQUENTIAL);
+#endif
+    buffer.resize(bytes);
+    long long read = readAt(data, buffer.data(), bytes, offset);
+    readSums(sumsFd, chunk.first, static_cast<size_t>(chunk.count), sums);
+    ::close(data);
+    if (sumsFd >= 0)
+        ::close(sumsFd);
+
+    long long whole = read / static_cast<long long>(file.recordSize);
+    for (long long i = 0; i < whole; i++) {
+        uint32_t stored = sums[static_cast<size_t>(i)];
+        if (stored == 0) {
+            file.unchecked++;
+        } else if (stored != recordSum(buffer.data() + i * static_cast<long long>(file.recordSize), file.recordSize) &&
+                   confirmBad(file, chunk.first + i)) {
+            file.bad++;
+            std::lock_guard<std::mutex> lock(file.badMutex);
+            file.badRecords.push_back(chunk.first + i);
+        }
+    }
+    return read;
+}
+
+/**********************************************
+ * Function: scrub
+ * Description: Verifies every record of a data directory.
+ * Parameters:
+ * - directory: The data directory
+ * - megabytesPerSecond: The rate limit in MiB/s, or 0 for full speed
+ * - out: Where the findings are printed
+ * Returns: int - 0 if every record passed, 1 otherwise
+ **********************************************/
+int RecordChecksum::scrub(const std::string& directory, double megabytesPerSecond, std::ostream& out) {
+    std::deque<ScrubFile> files;
+    scrubFiles(directory, files);
+    bool throttled = megabytesPerSecond > 0;
+    long long chunkBytes = throttled ? THROTTLED_CHUNK_BYTES : SCRUB_CHUNK_BYTES;
+    std::vector<ScrubChunk> chunks;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (files[i].blocks) {
+            for (size_t block = 0; block < files[i].blocks->blocks(); block++)
+                chunks.push_back({i, static_cast<long long>(block), 1});
+            continue;
+        }
+        long long perChunk = std::max<long long>(1, chunkBytes / static_cast<long long>(files[i].recordSize));
+        for (long long first = 0; first < files[i].records; first += perChunk)
+            chunks.push_back({i, first, std::min(perChunk, files[i].records - first)});
+    }
+
+    size_t threadCount = throttled ? 1 : std::max<size_t>(1, std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), chunks.size()));
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<long long> bytesRead(0);
+    auto start = std::chrono::steady_clock::now();
+    auto work = [&]() {
+        if (throttled)
+            lowerPriority();
+        std::vector<char> buffer;
+        std::vector<uint32_t> sums;
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+            long long total = bytesRead += scrubChunk(files[chunks[i].file], chunks[i], buffer, sums);
+            if (throttled) // Paced so the bytes read so far never run ahead of the rate
+                std::this_thread::sleep_until(start + std::chrono::duration<double>(total / (megabytesPerSecond * 1048576.0)));
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; i++)
+        threads.emplace_back(work);
+    work();
+    for (std::thread& thread : threads)
+        thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long bad = 0;
+    for (ScrubFile& file : files) {
+        out << file.name << ": " << file.records << " records, " << file.unchecked.load() << " without a checksum, "
+            << file.bad.load() << " bad" << '\n';
+        std::sort(file.badRecords.begin(), file.badRecords.end());
+        if (file.damagedIndex)
+            out << "  the block index is missing or damaged, so no block can be read" << '\n';
+        for (size_t i = 0; i < file.badRecords.size() && i < REPORTED_BAD_RECORDS; i++) {
+            if (file.blocks)
+                out << "  block " << file.badRecords[i] << " of " << file.blocks->blockRecords(static_cast<size_t>(file.badRecords[i]))
+                    << " records fails its checksum" << '\n';
+            else
+                out << "  record " << file.badRecords[i] << " at offset " << file.badRecords[i] * static_cast<long long>(file.recordSize)
+                    << " fails its checksum" << '\n';
+        }
+        if (file.badRecords.size() > REPORTED_BAD_RECORDS)
+            out << "  and " << file.badRecords.size() - REPORTED_BAD_RECORDS << " more" << '\n';
+        bad += file.bad;
+    }
+    double mebibytes = static_cast<double>(bytesRead.load()) / 1048576.0;
+    out << "Scrubbed " << files.size() << " files, " << std::fixed << std::setprecision(1) << mebibytes << " MiB in "
+        << std::setprecision(2) << seconds << " s (" << std::setprecision(1) << (seconds > 0 ? mebibytes / seconds : 0.0)
+        << " MiB/s) on " << threadCount << (threadCount == 1 ? " thread" : " threads") << ", CRC32C in "
+        << (HARDWARE_CRC ? "hardware" : "software") << "." << std::defaultfloat << '\n';
+    if (bad > 0)
+        out << bad << " records fail their checksums." << std::endl;
+    else
+        out << "Every checksum matches." << std::endl;
+    return bad > 0 ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+/**********************************************
+ * RecordChecksum Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: A failing record is reread under its lock instead of after short waits.
+ *--------------------------------
+ * Purpose:
+ * This module detects torn and bit-rotted records in the five data files. Every
+ * record has a CRC32C, computed with the processor's CRC instruction where there
+ * is one, kept in a checksum file next to its data file: "ChangeItem.txt" has
+ * "ChangeItem.crc", holding one 4-byte checksum per record at the record's
+ * position. The record files keep their format, so nothing that reads them by
+ * offset changes, and a record and its checksum are written under the same lock.
+ *
+ * Appends write the checksum before the record, so a record cut short by a crash
+ * never passes. Records are verified as they are read; a reader that catches a
+ * record or checksum between the two writes of an update reads both again, once
+ * the writer's lock is released, before giving up on it. A record that stays wrong is reported once and then treated as
+ * missing rather than shown. A stored 0 means no checksum was recorded (records
+ * written before checksums were kept), so a CRC of 0 is stored as 0xFFFFFFFF.
+ *
+ * The scrubber verifies whole data directories: every record of every data file,
+ * in parallel at full speed, or online at a limited rate on one low-priority thread.
+ **********************************************/
+#ifndef RECORDCHECKSUM_H
+#define RECORDCHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const char* const CHECKSUM_EXTENSION = ".crc";   // Replaces ".txt" in the name of the data file
+const int CHECKSUM_SIZE = 4;                     // Bytes per record in a checksum file
+
+//=============================
+// Class Declarations
+//=============================
+
+class RecordChecksum {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static uint32_t crc32c(const void* data, size_t length);
+    // Description: Returns the CRC32C (Castagnoli) of the bytes.
+
+    //----------------------------------------------------------
+    static bool hardwareAccelerated();
+    // Description: Returns true if crc32c uses the processor's CRC instruction.
+
+    //----------------------------------------------------------
+    static std::string checksumPath(const std::string& dataPath);
+    // Description: Returns the checksum file of a data file.
+
+    //----------------------------------------------------------
+    static bool store(const std::string& dataPath, size_t recordSize, long long offset, const void* records, size_t count);
+    // Description: Records the checksums of count consecutive records that are written at offset.
+    //              Called under the lock the records are written under.
+    // Returns: bool - False if the checksum file could not be written.
+
+    //----------------------------------------------------------
+    static bool copy(const std::string& fromDataPath, const std::string& toDataPath, size_t recordSize, long long offset, long long length);
+    // Description: Copies the checksums of a range of records from one data file's checksum file
+    //              to another's, for records copied byte for byte. Used by the replica.
+
+    //----------------------------------------------------------
+    static void truncate(const std::string& dataPath, size_t recordSize, long long size);
+    // Description: Cuts the checksum file down to the records of a data file of size bytes.
+
+    //----------------------------------------------------------
+    static bool init(const std::string& dataPath, size_t recordSize);
+    // Description: Records the missing checksums of a data file's records, e.g. those written before
+    //              checksums were kept. Does nothing if every record already has one.
+    // Returns: bool - False if the checksum file could not be written.
+
+    //----------------------------------------------------------
+    static bool verify(const std::string& dataPath, size_t recordSize, long long offset, void* record);
+    // Description: Verifies one record read from offset, as ChecksumReader::check does.
+
+    //----------------------------------------------------------
+    static void report(const std::string& dataPath, size_t recordSize, long long offset);
+    // Description: Prints a warning for a record that fails its checksum, once per record.
+
+    //----------------------------------------------------------
+    static int scrub(const std::string& directory, double megabytesPerSecond, std::ostream& out);
+    // Description: Verifies every record of every data file in directory and prints what it found.
+    //              With megabytesPerSecond 0 the files are read in parallel as fast as the disks allow;
+    //              otherwise one low-priority thread reads at that rate, for use while the tracker runs.
+    // Returns: int - The process exit status: 1 if a record failed its checksum.
+};
+
+// Verifies the records of one data file as they are read, with the checksums of
+// nearby records read in one go. Used by one thread at a time.
+class ChecksumReader {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    ChecksumReader(const std::string& dataPath, size_t recordSize);
+    // Description: Prepares to verify records of the data file; opens nothing yet.
+
+    //----------------------------------------------------------
+    ~ChecksumReader();
+    // Description: Closes the files it opened.
+
+    ChecksumReader(const ChecksumReader&) = delete;
+    ChecksumReader& operator=(const ChecksumReader&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    bool check(long long offset, void* record);
+    // Description: Verifies a record read from offset. If it does not match, the record and its
+    //              checksum are read again under the record's lock and the append lock, which wait
+    //              out a write in progress; a record that then matches is copied into record. A
+    //              record without a checksum passes.
+    // Returns: bool - False, after reporting it, if the record fails its checksum.
+
+private:
+    bool load(long long index);
+    bool recheck(long long offset, void* record);
+
+    std::string dataPath;
+    size_t recordSize;
+    int checksumFd = -1;
+    int dataFd = -1;
+    long long first = 0;                // The record number of window[0]
+    std::vector<uint32_t> window;       // Stored checksums of the records from first on
+};
+
+#endif // RECORDCHECKSUM_H
@@ -0,0 +1,163 @@
+/**********************************************
+ * RecordSchema Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module describes the on-disk layout of every entity record at compile
+ * time. An entity lists its fields once, in file order, as pointers to its data
+ * members; Schema<Record> derives from that list the byte offset and size of
+ * every field and the size of the whole record, all as constants. Records are
+ * stored packed: fields follow each other with no gaps, whatever padding the
+ * compiler puts between or after the members in memory, so the format does not
+ * depend on the compiler's alignment rules.
+ *
+ * The same list generates the serializers. encode and decode copy field by field
+ * between a record and its packed bytes, and read extracts one field of a packed
+ * record in place, which lets scans compare a key without copying the record.
+ * Each entity header checks its record size with static_asserts, so a change to
+ * a member that would change the file format fails to compile.
+ *
+ * An entity opts in by declaring, usually privately with Schema as a friend:
+ *     static constexpr auto schemaFields() {
+ *         return std::make_tuple(SchemaField<&Record::first>{"first"}, ...);
+ *     }
+ **********************************************/
+#ifndef RECORDSCHEMA_H
+#define RECORDSCHEMA_H
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//=============================
+// Field Descriptors
+//=============================
+
+// Splits a pointer to a data member into its class and member type.
+template <auto Member>
+struct MemberTraits;
+
+template <typename Record, typename Type, Type Record::*Member>
+struct MemberTraits<Member> {
+    using RecordType = Record;
+    using FieldType = Type;
+};
+
+// One stored field: a data member and the name it is reported under.
+template <auto Member>
+struct SchemaField {
+    using FieldType = typename MemberTraits<Member>::FieldType;
+    static_assert(std::is_trivially_copyable_v<FieldType>, "Stored fields are copied byte for byte");
+
+    static constexpr size_t SIZE = sizeof(FieldType);
+    const char* name;
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+template <typename Record>
+class Schema {
+    using Fields = decltype(Record::schemaFields());
+
+public:
+    static constexpr size_t COUNT = std::tuple_size_v<Fields>;
+    // Description: The number of stored fields.
+
+    template <size_t Index>
+    using FieldType = typename std::tuple_element_t<Index, Fields>::FieldType;
+    // Description: The member type of a field.
+
+    //----------------------------------------------------------
+    template <size_t Index>
+    static constexpr size_t offset() {
+        if constexpr (Index == 0)
+            return 0;
+        else
+            return offset<Index - 1>() + std::tuple_element_t<Index - 1, Fields>::SIZE;
+    }
+    // Description: Returns the byte offset of a field in the packed record. offset<COUNT>()
+    //              is the record size.
+
+    //----------------------------------------------------------
+    template <size_t Index>
+    static constexpr size_t size() {
+        return std::tuple_element_t<Index, Fields>::SIZE;
+    }
+    // Description: Returns the number of bytes a field takes in the packed record.
+
+    static constexpr size_t SIZE = offset<COUNT>();
+    // Description: The size of a packed record in the file.
+
+    static constexpr bool PACKED_IN_MEMORY = SIZE == sizeof(Record);
+    // Description: True if the members have no padding between or after them, so the record
+    //              in memory is byte for byte its packed form.
+
+    //----------------------------------------------------------
+    static const char* name(size_t index) {
+        const char* names[COUNT];
+        size_t next = 0;
+        std::apply([&](const auto&... field) { ((names[next++] = field.name), ...); }, Record::schemaFields());
+        return index < COUNT ? names[index] : "?";
+    }
+    // Description: Returns the name a field is reported under.
+
+    //----------------------------------------------------------
+    static void encode(const Record& record, char* out) {
+        encodeFields(record, out, std::make_index_sequence<COUNT>());
+    }
+    // Description: Writes the record's fields packed into SIZE bytes at out.
+
+    //----------------------------------------------------------
+    static void decode(const char* in, Record& record) {
+        decodeFields(in, record, std::make_index_sequence<COUNT>());
+    }
+    // Description: Reads the record's fields from SIZE packed bytes at in. Padding in the
+    //              record, if any, is left as it was.
+
+    //----------------------------------------------------------
+    template <size_t Index>
+    static FieldType<Index> read(const char* record) {
+        FieldType<Index> value;
+        std::memcpy(&value, record + offset<Index>(), sizeof(value));
+        return value;
+    }
+    // Description: Reads one field of a packed record without decoding the rest.
+
+    //----------------------------------------------------------
+    template <size_t Index>
+    static std::string_view text(const char* record) {
+        static_assert(std::is_array_v<FieldType<Index>>, "Only character fields are text");
+        const char* field = record + offset<Index>();
+        return std::string_view(field, strnlen(field, sizeof(FieldType<Index>)));
+    }
+    // Description: Views a character field of a packed record up to its terminator.
+
+private:
+    template <size_t... Index>
+    static void encodeFields(const Record& record, char* out, std::index_sequence<Index...>) {
+        (std::memcpy(out + offset<Index>(), &(record.*memberOf<Index>()), std::tuple_element_t<Index, Fields>::SIZE), ...);
+    }
+
+    template <size_t... Index>
+    static void decodeFields(const char* in, Record& record, std::index_sequence<Index...>) {
+        (std::memcpy(&(record.*memberOf<Index>()), in + offset<Index>(), std::tuple_element_t<Index, Fields>::SIZE), ...);
+    }
+
+    template <size_t Index>
+    static constexpr auto memberOf() {
+        return memberPointer(std::tuple_element_t<Index, Fields>{});
+    }
+
+    template <auto Member>
+    static constexpr auto memberPointer(SchemaField<Member>) {
+        return Member;
+    }
+};
+
+#endif // RECORDSCHEMA_H
@@ -0,0 +1,76 @@
+/**********************************************
+ * RecordView Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module provides read-only views of stored records. A view is a single
+ * pointer to a record that already sits in memory, such as the chunk a snapshot
+ * scan has just read, and its accessors return std::string_view into the record's
+ * fixed-width fields. Reading a record through a view therefore copies nothing
+ * and allocates nothing, unlike the std::string accessors of the records
+ * themselves. A view is only valid while the memory it points to is; callers
+ * that need to keep a record copy it with record().
+ **********************************************/
+#ifndef RECORDVIEW_H
+#define RECORDVIEW_H
+
+#include <cstring>
+#include <string_view>
+
+#include "ChangeItem.h"
+#include "ChangeRequest.h"
+
+//=============================
+// Helper Functions
+//=============================
+
+// Views a fixed-width character field up to its terminator.
+template <size_t N>
+inline std::string_view fieldView(const char (&field)[N]) {
+    return std::string_view(field, strnlen(field, N));
+}
+
+//=============================
+// Class Declarations
+//=============================
+
+// A read-only view of a ChangeItem record.
+class ChangeItemView {
+public:
+    explicit ChangeItemView(const ChangeItem& changeItem) : item(&changeItem) {}
+
+    int changeId() const { return item->changeId; }
+    std::string_view description() const { return fieldView(item->description); }
+    std::string_view productName() const { return item->productName.getProductNameView(); }
+    std::string_view date() const { return fieldView(item->date); }
+    std::string_view releaseId() const { return item->anticipatedRelease.releaseIdView(); }
+    int priority() const { return item->priority; }
+    ChangeItem::State state() const { return item->changeItemState; }
+    int version() const { return item->version; }
+
+    const ChangeItem& record() const { return *item; }
+    // Description: Returns the viewed record, e.g. to copy it into a result set.
+
+private:
+    const ChangeItem* item;
+};
+
+// A read-only view of a ChangeRequest record.
+class ChangeRequestView {
+public:
+    explicit ChangeRequestView(const ChangeRequest& changeRequest) : request(&changeRequest) {}
+
+    int changeId() const { return request->changeId; }
+    std::string_view requestedBy() const { return fieldView(request->requestedBy); }
+    std::string_view productName() const { return request->productName.getProductNameView(); }
+    std::string_view date() const { return fieldView(request->date); }
+
+    const ChangeRequest& record() const { return *request; }
+    // Description: Returns the viewed record.
+
+private:
+    const ChangeRequest* request;
+};
+
+#endif // RECORDVIEW_H
@@ -0,0 +1,719 @@
+/**********************************************
+ * ReleaseIndex Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: The block and directory entry sizes are checked against ReleaseIndex.h.
+ * - 2026-10-19: Builds read change item files in any record version.
+ * - 2026-10-19: The index covers archived change items too.
+ * - 2026-10-19: Archives are counted from their block index and read block by block.
+ * - 2026-10-19: printRelease is timed for the metrics endpoint.
+ * - 2026-10-19: printRelease split into detail, which reads, and printReport, which formats.
+ *--------------------------------
+ * Purpose:
+ * This module implements the release index. The index file starts with a header
+ * (magic, feed sequence folded up to, items posted, blocks and releases in use),
+ * followed by one directory entry per release. The postings file is an array of
+ * 256-byte blocks; each block belongs to one release, links to the release's next
+ * block and holds up to POSTINGS_PER_BLOCK postings. The slots file holds, per
+ * change ID, the number of the item's posting plus one, or 0 if it has none.
+ *
+ * Folds and rebuilds run under the append sentinel lock of the index file, and
+ * readers hold it while they read, so the counts they see always match the
+ * postings. A fold changes the blocks, slots and directory in memory and writes
+ * them out in runs at the end: first the header marked unfinished, then the
+ * changed blocks, slots and directory, and the finished header last. An index
+ * left unfinished by a crash is rebuilt by the next reader.
+ *
+ * Applying an event twice changes nothing: a creation is skipped if the item
+ * already has a posting, and a state change sets the new state rather than
+ * counting a difference. This lets a rebuild note the feed position before it
+ * reads the records and fold everything after it, even events whose effect the
+ * records already showed.
+ **********************************************/
+#include "ReleaseIndex.h"
+#include "BlockFile.h"
+#include "ChangeFeed.h"
+#include "ChangeItem.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "ItemArchive.h"
+#include "Metrics.h"
+#include "StorageLayout.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <utility>
+
+//================================
+// Constants
+//================================
+static const char INDEX_MAGIC[8] = {'T', 'R', 'K', 'R', 'I', 'D', 'X', '1'};
+static const size_t FOLD_CHUNK_EVENTS = 4096;    // Feed events read per step while folding
+static const int BUILD_CHUNK_RECORDS = 4096;     // Change items read per step while rebuilding
+
+static const char* STATE_NAMES[] = {"ASSESSED", "INPROGRESS", "DONE", "CANCELLED"};
+
+//================================
+// File Records
+//================================
+
+struct IndexHeader {
+    char magic[8];
+    long long folded;       // The feed sequence to fold from next; -1 while changes are being written
+    long long postings;     // Change items posted
+    int32_t blocks;         // Posting blocks in use
+    int32_t releases;       // Directory entries in use
+};
+
+struct ReleaseRecord {
+    char product[11];
+    char releaseId[9];
+    int32_t counts[4];      // Items per ChangeItem::State
+    int32_t firstBlock;
+    int32_t lastBlock;
+};
+
+struct PostingBlock {
+    int32_t release;        // The directory entry the block belongs to
+    int32_t next;           // The release's next block, or -1
+    int32_t used;
+    int32_t reserved;
+    ReleasePosting postings[POSTINGS_PER_BLOCK];
+};
+
+static_assert(sizeof(PostingBlock) == RELEASE_BLOCK_SIZE, "Posting blocks are 256 bytes in ChangeItem.rpost");
+static_assert(sizeof(ReleaseRecord) == RELEASE_ENTRY_SIZE, "Directory entries are 44 bytes in ChangeItem.ridx");
+
+//================================
+// Helpers
+//================================
+
+static long long releaseOffset(int release) {
+    return static_cast<long long>(sizeof(IndexHeader)) + static_cast<long long>(release) * static_cast<long long>(sizeof(ReleaseRecord));
+}
+
+static bool validState(int state) {
+    return state >= ChangeItem::ASSESSED && state <= ChangeItem::CANCELLED;
+}
+
+static std::fstream openFile(const char* path, bool truncate) {
+    if (truncate)
+        std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (file.is_open())
+        return file;
+    std::ofstream(path, std::ios::binary | std::ios::app).close();
+    return std::fstream(path, std::ios::in | std::ios::out | std::ios::binary);
+}
+
+static ReleaseSummary toSummary(const ReleaseRecord& record) {
+    ReleaseSummary summary;
+    summary.product.assign(record.product, strnlen(record.product, sizeof(record.product)));
+    summary.releaseId.assign(record.releaseId, strnlen(record.releaseId, sizeof(record.releaseId)));
+    for (int state = 0; state < 4; state++) {
+        summary.counts[state] = record.counts[state];
+        summary.total += record.counts[state];
+    }
+    return summary;
+}
+
+/**********************************************
+ * Function: countRecords
+ * Description: Adds up the change item records of every segment from the file sizes,
+ *              and of every archive from its block index.
+ **********************************************/
+static long long countRecords() {
+    long long records = 0;
+    for (const std::string& segment : StorageLayout::itemFiles()) {
+        if (StorageLayout::isArchive(segment)) {
+            records += BlockReader(segment).records();
+            continue;
+        }
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(segment, error);
+        size_t recordSize = FileFormat::layout(segment).size;
+        if (!error && recordSize > 0)
+            records += static_cast<long long>(size / recordSize);
+    }
+    return records;
+}
+
+/**********************************************
+ * Function: writeRuns
+ * Description: Writes the changed entries of a cache, one write per run of
+ *              consecutive entries.
+ * Parameters:
+ * - file: The open file
+ * - cache: The entries by number
+ * - dirty: The numbers of the changed entries
+ **********************************************/
+template <typename T>
+static void writeRuns(std::fstream& file, const std::map<int, T>& cache, const std::set<int>& dirty) {
+    std::vector<T> run;
+    for (auto number = dirty.begin(); number != dirty.end();) {
+        int first = *number;
+        run.clear();
+        for (int expected = first; number != dirty.end() && *number == expected; ++number, ++expected)
+            run.push_back(cache.at(*number));
+        file.seekp(static_cast<long long>(first) * static_cast<long long>(sizeof(T)));
+        file.write(reinterpret_cast<const char*>(run.data()), static_cast<std::streamsize>(run.size() * sizeof(T)));
+    }
+}
+
+//================================
+// Open Index
+//================================
+
+// The index as one fold or rebuild sees it: the header and directory in memory,
+// and the blocks and slots it has read or changed.
+class OpenIndex {
+public:
+    IndexHeader header{};
+    std::vector<ReleaseRecord> directory;
+
+    bool load();
+    bool fold();
+    void build();
+    bool save();
+    int findRelease(const std::string& product, const std::string& releaseId) const;
+    std::vector<ReleasePosting> postingsOf(int release);
+
+private:
+    void clear();
+    void post(int changeId, const std::string& product, const std::string& releaseId, int state);
+    void setState(int changeId, int state);
+    PostingBlock* block(int number);
+    int32_t& slot(int changeId);
+
+    std::fstream postingFile;
+    std::fstream slotFile;
+    std::map<std::pair<std::string, std::string>, int> releaseNumbers;
+    std::map<int, PostingBlock> blocks;
+    std::map<int, int32_t> slots;
+    std::set<int> dirtyBlocks;
+    std::set<int> dirtySlots;
+    bool changed = false;
+};
+
+/**********************************************
+ * Function: OpenIndex::load
+ * Description: Reads the header and the directory.
+ * Returns: bool - False if the index is missing, unfinished or damaged.
+ **********************************************/
+bool OpenIndex::load() {
+    postingFile = openFile(RELEASE_POSTINGS_FILE, false);
+    slotFile = openFile(RELEASE_SLOTS_FILE, false);
+    std::ifstream index(RELEASE_INDEX_FILE, std::ios::binary);
+    if (!index.read(reinterpret_cast<char*>(&header), sizeof(IndexHeader)) ||
+        memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.folded < 0 || header.releases < 0)
+        return false;
+    directory.resize(static_cast<size_t>(header.releases));
+    if (!index.read(reinterpret_cast<char*>(directory.data()), static_cast<std::streamsize>(directory.size() * sizeof(ReleaseRecord))))
+        return false;
+
+    std::error_code error;
+    uintmax_t postingBytes = std::filesystem::file_size(RELEASE_POSTINGS_FILE, error);
+    if (error || postingBytes < static_cast<uintmax_t>(header.blocks) * sizeof(PostingBlock))
+        return false;
+    uintmax_t slotBytes = std::filesystem::file_size(RELEASE_SLOTS_FILE, error);
+    if (header.postings > 0 && (error || slotBytes == 0))
+        return false;
+    for (size_t release = 0; release < directory.size(); release++) {
+        ReleaseSummary summary = toSummary(directory[release]);
+        releaseNumbers[{summary.product, summary.releaseId}] = static_cast<int>(release);
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: OpenIndex::clear
+ * Description: Empties the index files and the memory, for a rebuild.
+ **********************************************/
+void OpenIndex::clear() {
+    postingFile = openFile(RELEASE_POSTINGS_FILE, true);
+    slotFile = openFile(RELEASE_SLOTS_FILE, true);
+    header = IndexHeader{};
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    directory.clear();
+    releaseNumbers.clear();
+    blocks.clear();
+    slots.clear();
+    dirtyBlocks.clear();
+    dirtySlots.clear();
+    changed = true;
+}
+
+/**********************************************
+ * Function: OpenIndex::block
+ * Description: Returns a posting block, reading it on first use.
+ * Returns: PostingBlock* - The block, or nullptr if it cannot be read.
+ **********************************************/
+PostingBlock* OpenIndex::block(int number) {
+    auto cached = blocks.find(number);
+    if (cached != blocks.end())
+        return &cached->second;
+    if (number < 0 || number >= header.blocks)
+        return nullptr;
+    PostingBlock loaded;
+    postingFile.seekg(static_cast<long long>(number) * static_cast<long long>(sizeof(PostingBlock)));
+    if (!postingFile.read(reinterpret_cast<char*>(&loaded), sizeof(PostingBlock))) {
+        postingFile.clear();
+        return nullptr;
+    }
+    return &blocks.emplace(number, loaded).first->second;
+}
+
+/**********************************************
+ * Function: OpenIndex::slot
+ * Description: Returns the slot of a change ID, reading it on first use; slots
+ *              beyond the end of the file are 0.
+ **********************************************/
+int32_t& OpenIndex::slot(int changeId) {
+    auto cached = slots.find(changeId);
+    if (cached != slots.end())
+        return cached->second;
+    int32_t value = 0;
+    slotFile.seekg(static_cast<long long>(changeId) * static_cast<long long>(sizeof(int32_t)));
+    if (!slotFile.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+        slotFile.clear();
+        value = 0;
+    }
+    return slots.emplace(changeId, value).first->second;
+}
+
+/**********************************************
+ * Function: OpenIndex::post
+ * Description:
+ * Appends an item's posting to the last block of its release, starting a new
+ * block when that one is full and a directory entry for a release targeted for
+ * the first time. An item that already has a posting is left alone.
+ **********************************************/
+void OpenIndex::post(int changeId, const std::string& product, const std::string& releaseId, int state) {
+    if (changeId < 0 || !validState(state) || slot(changeId) != 0)
+        return;
+
+    auto [entry, added] = releaseNumbers.emplace(std::make_pair(product, releaseId), header.releases);
+    int release = entry->second;
+    if (added) {
+        ReleaseRecord record{};
+        strncpy(record.product, product.c_str(), sizeof(record.product) - 1);
+        strncpy(record.releaseId, releaseId.c_str(), sizeof(record.releaseId) - 1);
+        record.firstBlock = -1;
+        record.lastBlock = -1;
+        directory.push_back(record);
+        header.releases++;
+    }
+    ReleaseRecord& record = directory[static_cast<size_t>(release)];
+
+    PostingBlock* last = record.lastBlock >= 0 ? block(record.lastBlock) : nullptr;
+    if (last == nullptr || last->used >= POSTINGS_PER_BLOCK) {
+        int fresh = header.blocks++;
+        PostingBlock created{};
+        created.release = release;
+        created.next = -1;
+        if (last != nullptr) {
+            last->next = fresh;
+            dirtyBlocks.insert(record.lastBlock);
+        } else {
+            record.firstBlock = fresh;
+        }
+        record.lastBlock = fresh;
+        last = &blocks.emplace(fresh, created).first->second;
+    }
+
+    last->postings[last->used] = {changeId, state};
+    slot(changeId) = record.lastBlock * POSTINGS_PER_BLOCK + last->used + 1;
+    last->used++;
+    dirtyBlocks.insert(record.lastBlock);
+    dirtySlots.insert(changeId);
+    record.counts[state]++;
+    header.postings++;
+    changed = true;
+}
+
+/**********************************************
+ * Function: OpenIndex::setState
+ * Description: Moves a posted item to a new state and between the counts of its
+ *              release. Items without a posting are skipped.
+ **********************************************/
+void OpenIndex::setState(int changeId, int state) {
+    if (changeId < 0 || !validState(state))
+        return;
+    int32_t position = slot(changeId);
+    int number = (position - 1) / POSTINGS_PER_BLOCK;
+    PostingBlock* holder = position > 0 ? block(number) : nullptr;
+    if (holder == nullptr || holder->release < 0 || holder->release >= header.releases)
+        return;
+    ReleasePosting& posting = holder->postings[(position - 1) % POSTINGS_PER_BLOCK];
+    if (posting.changeId != changeId || posting.state == state)
+        return;
+
+    ReleaseRecord& record = directory[static_cast<size_t>(holder->release)];
+    if (validState(posting.state))
+        record.counts[posting.state]--;
+    record.counts[state]++;
+    posting.state = state;
+    dirtyBlocks.insert(number);
+    changed = true;
+}
+
+/**********************************************
+ * Function: OpenIndex::fold
+ * Description: Applies the change item events appended to the feed since the
+ *              last fold.
+ * Returns: bool - False if the index is ahead of the feed, e.g. because the feed
+ *          was replaced, and must be rebuilt.
+ **********************************************/
+bool OpenIndex::fold() {
+    long long end = ChangeFeed::endSequence();
+    if (header.folded > end)
+        return false;
+
+    FeedFilter filter;
+    filter.entity = FeedEvent::CHANGE_ITEM;
+    std::vector<FeedEvent> events;
+    long long next = header.folded;
+    while (next < end) {
+        events.clear();
+        long long after = ChangeFeed::read(next, filter, FOLD_CHUNK_EVENTS, events);
+        for (const FeedEvent& event : events) {
+            if (event.sequence >= end)
+                break;
+            if (event.kind == FeedEvent::CREATED)
+                post(event.changeId, std::string(event.product, strnlen(event.product, sizeof(event.product))),
+                     std::string(event.key, strnlen(event.key, sizeof(event.key))), event.state);
+            else if (event.kind == FeedEvent::STATE_CHANGED)
+                setState(event.changeId, event.state);
+        }
+        if (after <= next)
+            break;
+        next = std::min(after, end);
+    }
+    if (next != header.folded) {
+        header.folded = next;
+        changed = true;
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: OpenIndex::build
+ * Description:
+ * Replaces the index with the postings of every change item record, archived
+ * ones included; no item moves between the files meanwhile. The feed position is
+ * noted before the records are read, so the next fold repeats, at worst, events
+ * the records already showed.
+ **********************************************/
+void OpenIndex::build() {
+    clear();
+    long long from = ChangeFeed::endSequence();
+    std::vector<ChangeItem> chunk(BUILD_CHUNK_RECORDS);
+    ItemArchive::ReadScope archiveScope;
+    for (const std::string& segment : StorageLayout::itemFiles()) {
+        if (StorageLayout::isArchive(segment)) {
+            BlockReader(segment).scan([&](const char* records, size_t count) {
+                const ChangeItem* changeItems = reinterpret_cast<const ChangeItem*>(records);
+                for (size_t i = 0; i < count; i++)
+                    post(changeItems[i].getChangeId(), changeItems[i].getProductName(), changeItems[i].getReleaseId(), changeItems[i].getState());
+            });
+            continue;
+        }
+        VersionedReader reader(segment);
+        std::ifstream infile(segment, std::ios::binary);
+        while (reader.usable()) {
+            size_t count = reader.read(infile, reinterpret_cast<char*>(chunk.data()), chunk.size());
+            for (size_t i = 0; i < count; i++)
+                post(chunk[i].getChangeId(), chunk[i].getProductName(), chunk[i].getReleaseId(), chunk[i].getState());
+            if (!infile)
+                break;
+        }
+    }
+    header.folded = from;
+}
+
+/**********************************************
+ * Function: OpenIndex::save
+ * Description: Writes what the fold or rebuild changed, the header last.
+ * Returns: bool - False if a file could not be written.
+ **********************************************/
+bool OpenIndex::save() {
+    if (!changed)
+        return true;
+    std::fstream index = openFile(RELEASE_INDEX_FILE, false);
+    IndexHeader unfinished = header;
+    unfinished.folded = -1;
+    index.seekp(0);
+    index.write(reinterpret_cast<const char*>(&unfinished), sizeof(IndexHeader));
+    index.flush();
+
+    writeRuns(postingFile, blocks, dirtyBlocks);
+    writeRuns(slotFile, slots, dirtySlots);
+    postingFile.flush();
+    slotFile.flush();
+    index.seekp(releaseOffset(0));
+    index.write(reinterpret_cast<const char*>(directory.data()), static_cast<std::streamsize>(directory.size() * sizeof(ReleaseRecord)));
+    index.flush();
+    if (postingFile.fail() || slotFile.fail() || index.fail()) {
+        std::cerr << "Failed to write the release index." << std::endl;
+        return false;
+    }
+    index.seekp(0);
+    index.write(reinterpret_cast<const char*>(&header), sizeof(IndexHeader));
+    index.close();
+    dirtyBlocks.clear();
+    dirtySlots.clear();
+    changed = false;
+    return !index.fail();
+}
+
+/**********************************************
+ * Function: OpenIndex::findRelease
+ * Returns: int - The directory entry of a release, or -1 if it has none.
+ **********************************************/
+int OpenIndex::findRelease(const std::string& product, const std::string& releaseId) const {
+    auto entry = releaseNumbers.find({product, releaseId});
+    return entry == releaseNumbers.end() ? -1 : entry->second;
+}
+
+/**********************************************
+ * Function: OpenIndex::postingsOf
+ * Description: Walks the chain of posting blocks of one release.
+ **********************************************/
+std::vector<ReleasePosting> OpenIndex::postingsOf(int release) {
+    std::vector<ReleasePosting> items;
+    int number = directory[static_cast<size_t>(release)].firstBlock;
+    for (int visited = 0; number >= 0 && visited < header.blocks; visited++) {
+        const PostingBlock* current = block(number);
+        if (current == nullptr)
+            break;
+        items.insert(items.end(), current->postings, current->postings + std::clamp(current->used, 0, POSTINGS_PER_BLOCK));
+        number = current->next;
+    }
+    return items;
+}
+
+/**********************************************
+ * Function: withIndex
+ * Description:
+ * Locks the index, brings it up to date with the feed, rebuilding it if it is
+ * missing, unfinished or ahead of the feed, and hands it to the caller while the
+ * lock is still held.
+ * Parameters:
+ * - use: Called with the up-to-date index
+ * Returns: bool - False if the index could not be written.
+ **********************************************/
+static bool withIndex(const std::function<void(OpenIndex&)>& use) {
+    RecordLock indexLock(RELEASE_INDEX_FILE, APPEND_LOCK_OFFSET, 1, true);
+    OpenIndex index;
+    if (!index.load() || !index.fold())
+        index.build();
+    bool saved = index.save();
+    use(index);
+    return saved;
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: init
+ * Description:
+ * Brings the index up to date, then compares the number of items it has posted
+ * with the number of change item records. They differ if a feed event was lost
+ * or items were written without one, e.g. before the feed existed; the index is
+ * then rebuilt from the records.
+ * Parameters: None
+ * Returns: bool - False if the index could not be written.
+ **********************************************/
+bool ReleaseIndex::init() {
+    bool saved = true;
+    bool written = withIndex([&](OpenIndex& index) {
+        if (index.header.postings != countRecords()) {
+            index.build();
+            saved = index.save();
+        }
+    });
+    return written && saved;
+}
+
+/**********************************************
+ * Function: summary
+ * Description: Reads the state counts of one release.
+ * Parameters:
+ * - product, releaseId: The release
+ * - release: Receives the counts
+ * Returns: bool - False if no change item targets the release.
+ **********************************************/
+bool ReleaseIndex::summary(const std::string& product, const std::string& releaseId, ReleaseSummary& release) {
+    bool found = false;
+    withIndex([&](OpenIndex& index) {
+        int number = index.findRelease(product, releaseId);
+        if (number >= 0) {
+            release = toSummary(index.directory[static_cast<size_t>(number)]);
+            found = true;
+        }
+    });
+    return found;
+}
+
+/**********************************************
+ * Function: releases
+ * Description: Reads the whole directory, keeping the releases of one product.
+ * Parameters:
+ * - product: The product, or "" for every product
+ * Returns: std::vector<ReleaseSummary> - The releases, in the order they were first targeted.
+ **********************************************/
+std::vector<ReleaseSummary> ReleaseIndex::releases(const std::string& product) {
+    std::vector<ReleaseSummary> summaries;
+    withIndex([&](OpenIndex& index) {
+        for (const ReleaseRecord& record : index.directory)
+            if (product.empty() || strncmp(record.product, product.c_str(), sizeof(record.product)) == 0)
+                summaries.push_back(toSummary(record));
+    });
+    return summaries;
+}
+
+/**********************************************
+ * Function: postings
+ * Description: Lists the change items of one release from its posting blocks.
+ * Parameters:
+ * - product, releaseId: The release
+ * - items: Receives the postings, in creation order
+ * Returns: bool - False if no change item targets the release.
+ **********************************************/
+bool ReleaseIndex::postings(const std::string& product, const std::string& releaseId, std::vector<ReleasePosting>& items) {
+    bool found = false;
+    items.clear();
+    withIndex([&](OpenIndex& index) {
+        int number = index.findRelease(product, releaseId);
+        if (number >= 0) {
+            items = index.postingsOf(number);
+            found = true;
+        }
+    });
+    return found;
+}
+
+/**********************************************
+ * Function: rebuild
+ * Description: Builds the index from the change item records under the index lock.
+ * Parameters: None
+ * Returns: bool - False if the index files could not be written.
+ **********************************************/
+bool ReleaseIndex::rebuild() {
+    RecordLock indexLock(RELEASE_INDEX_FILE, APPEND_LOCK_OFFSET, 1, true);
+    OpenIndex index;
+    index.build();
+    return index.save();
+}
+
+/**********************************************
+ * Function: detail
+ * Description: Reads the counts and the postings of one release in one fold, so they agree.
+ * Parameters:
+ * - product, releaseId: The release
+ * - release: Receives the counts
+ * - items: Receives the postings, in creation order
+ * Returns: bool - False if no change item targets the release.
+ **********************************************/
+bool ReleaseIndex::detail(const std::string& product, const std::string& releaseId, ReleaseSummary& release,
+                          std::vector<ReleasePosting>& items) {
+    bool found = false;
+    items.clear();
+    withIndex([&](OpenIndex& index) {
+        int number = index.findRelease(product, releaseId);
+        if (number >= 0) {
+            release = toSummary(index.directory[static_cast<size_t>(number)]);
+            items = index.postingsOf(number);
+            found = true;
+        }
+    });
+    return found;
+}
+
+/**********************************************
+ * Function: printReport
+ * Description:
+ * Prints release readiness: the items per state of each release and the share
+ * already closed (done or cancelled). For a single release, the heading names
+ * it and the change IDs still open are listed below the counts.
+ * Parameters:
+ * - out: The stream receiving the report
+ * - product: The product
+ * - releaseId: The release, or "" if releases holds every release of the product
+ * - releases: The counts to print
+ * - items: The postings of the release; ignored without a release ID
+ **********************************************/
+void ReleaseIndex::printReport(std::ostream& out, const std::string& product, const std::string& releaseId,
+                               const std::vector<ReleaseSummary>& releases, const std::vector<ReleasePosting>& items) {
+    if (!releaseId.empty())
+        out << product << " " << releaseId << std::endl;
+    out << std::left << std::setw(10) << "Release" << std::right << std::setw(8) << "Items";
+    for (const char* name : STATE_NAMES)
+        out << std::setw(12) << name;
+    out << std::setw(8) << "Closed" << std::left << std::endl;
+    for (const ReleaseSummary& release : releases) {
+        int closed = release.counts[ChangeItem::DONE] + release.counts[ChangeItem::CANCELLED];
+        out << std::left << std::setw(10) << release.releaseId << std::right << std::setw(8) << release.total;
+        for (int count : release.counts)
+            out << std::setw(12) << count;
+        out << std::setw(7) << (release.total == 0 ? 100 : closed * 100 / release.total) << "%" << std::left << std::endl;
+    }
+    if (releaseId.empty() || releases.empty())
+        return;
+
+    for (int state : {ChangeItem::ASSESSED, ChangeItem::INPROGRESS}) {
+        if (releases.front().counts[state] == 0)
+            continue;
+        out << "Open, " << STATE_NAMES[state] << ":";
+        int column = 0;
+        for (const ReleasePosting& item : items) {
+            if (item.state != state)
+                continue;
+            out << (column++ % 10 == 0 ? "\n  " : " ") << std::right << std::setw(8) << item.changeId << std::left;
+        }
+        out << std::endl;
+    }
+}
+
+/**********************************************
+ * Function: printRelease
+ * Description:
+ * Prints a release's readiness: its items per state, the share already closed
+ * (done or cancelled) and the change IDs still open. Without a release ID, prints
+ * the counts of every release of the product.
+ * Parameters:
+ * - product: The product
+ * - releaseId: The release, or "" for every release of the product
+ * Returns: int - The process exit status.
+ **********************************************/
+int ReleaseIndex::printRelease(const std::string& product, const std::string& releaseId) {
+    Metrics::Timer timer(Metrics::REPORT_RELEASE_STATUS);
+    if (releaseId.empty()) {
+        std::vector<ReleaseSummary> summaries = releases(product);
+        if (summaries.empty()) {
+            std::cout << "No change items of " << product << " target a release." << std::endl;
+            return 1;
+        }
+        printReport(std::cout, product, releaseId, summaries, {});
+        return 0;
+    }
+
+    ReleaseSummary release;
+    std::vector<ReleasePosting> items;
+    if (!detail(product, releaseId, release, items)) {
+        std::cout << "No change items of " << product << " target release " << releaseId << "." << std::endl;
+        return 1;
+    }
+    printReport(std::cout, product, releaseId, {release}, items);
+    return 0;
+}
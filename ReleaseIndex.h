@@ -0,0 +1,116 @@
+/**********************************************
+ * ReleaseIndex Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added RELEASE_BLOCK_SIZE and RELEASE_ENTRY_SIZE for the query planner.
+ * - 2026-10-19: Added detail and printReport so callers other than printRelease can fetch and print a report.
+ *--------------------------------
+ * Purpose:
+ * This module indexes the change items by their anticipated release, so that
+ * "what is targeted at a release and what is still open" is answered from the
+ * release's own postings instead of a scan of every change item.
+ *
+ * Every (product, release ID) pair has a directory entry holding the number of
+ * its items in each state and a chain of posting blocks listing its change IDs
+ * with their current state. A slot per change ID points at the item's posting,
+ * so a state change updates the posting and the counts in place.
+ *
+ * The index is maintained from the change feed, which already carries every
+ * creation with its release and every state change: writers pay nothing extra,
+ * and a reader first folds in the events appended since the last fold, the same
+ * way the cycle time sketches are kept. The index is built from the records
+ * when it is missing or damaged, or when it has posted a different number of
+ * items than there are records, e.g. because a crash lost a feed event.
+ **********************************************/
+#ifndef RELEASEINDEX_H
+#define RELEASEINDEX_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const char* const RELEASE_INDEX_FILE = "ChangeItem.ridx";       // Releases with their state counts
+const char* const RELEASE_POSTINGS_FILE = "ChangeItem.rpost";   // Blocks of change IDs per release
+const char* const RELEASE_SLOTS_FILE = "ChangeItem.rslot";      // The posting of every change ID
+const int POSTINGS_PER_BLOCK = 30;                              // Fills a 256-byte block
+const int RELEASE_BLOCK_SIZE = 256;                             // Bytes per block of postings
+const int RELEASE_ENTRY_SIZE = 44;                              // Bytes per release in the directory
+
+//=============================
+// Record Types
+//=============================
+
+// One change item of a release, with its current state.
+struct ReleasePosting {
+    int changeId;
+    int state;
+};
+
+// The state counts of one release.
+struct ReleaseSummary {
+    std::string product;
+    std::string releaseId;
+    int counts[4] = {0, 0, 0, 0};   // Items per ChangeItem::State
+    int total = 0;
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class ReleaseIndex {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool init();
+    // Description: Folds in new feed events, then checks the index against the change item
+    //              records and rebuilds it if they disagree.
+    // Returns: bool - False if the index could not be rebuilt.
+
+    //----------------------------------------------------------
+    static bool summary(const std::string& product, const std::string& releaseId, ReleaseSummary& release);
+    // Description: Reads the state counts of one release.
+    // Returns: bool - False if no change item targets the release.
+
+    //----------------------------------------------------------
+    static std::vector<ReleaseSummary> releases(const std::string& product);
+    // Description: Returns the state counts of every release of a product, or of every
+    //              release if product is empty, in the order they were first targeted.
+
+    //----------------------------------------------------------
+    static bool postings(const std::string& product, const std::string& releaseId, std::vector<ReleasePosting>& items);
+    // Description: Lists the change items of one release with their states, in creation order.
+    //              Reads only the release's own posting blocks.
+    // Returns: bool - False if no change item targets the release.
+
+    //----------------------------------------------------------
+    static bool detail(const std::string& product, const std::string& releaseId, ReleaseSummary& release,
+                       std::vector<ReleasePosting>& items);
+    // Description: Reads the state counts and the postings of one release together, from one fold.
+    // Returns: bool - False if no change item targets the release.
+
+    //----------------------------------------------------------
+    static bool rebuild();
+    // Description: Replaces the index with one built from the change item records.
+    // Returns: bool - False if the index files could not be written.
+
+    //----------------------------------------------------------
+    static int printRelease(const std::string& product, const std::string& releaseId);
+    // Description: Prints the state counts of a release and lists its open change items, or
+    //              the counts of every release of the product if releaseId is empty.
+    // Returns: int - The process exit status.
+
+    //----------------------------------------------------------
+    static void printReport(std::ostream& out, const std::string& product, const std::string& releaseId,
+                            const std::vector<ReleaseSummary>& releases, const std::vector<ReleasePosting>& items);
+    // Description: Prints the counts of releases as a table. With a release ID, releases holds that one
+    //              release and its open change IDs are listed from items after the table.
+};
+
+#endif // RELEASEINDEX_H
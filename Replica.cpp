@@ -0,0 +1,720 @@
+/**********************************************
+ * Replica Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: The follower rebuilds the item history from applied events.
+ * - 2026-10-19: Mirrored record sizes come from the record schemas.
+ * - 2026-10-19: Copied records are added to the lookup filters before they are appended.
+ * - 2026-10-19: Record checksums are copied with the records.
+ * - 2026-10-19: Copies keep the record version of the primary's files and start over when the primary upgrades one.
+ * - 2026-10-19: Archives are mirrored; a file the primary rewrites is copied again.
+ * - 2026-10-19: Archives are block files, copied whole when the primary replaces one.
+ *--------------------------------
+ * Purpose:
+ * This module implements the follower. A round reads the end of the primary's
+ * feed first and only then copies data, so every change an event up to that end
+ * reports is already in the primary's files when they are copied. Appended
+ * records are copied in file order, which keeps every record at the same offset
+ * in both copies; an updated change item is found through an index of those
+ * offsets and overwritten in place like any other update, so snapshot readers of
+ * the follower keep their consistent view. Everything a round does is idempotent,
+ * so a follower that crashes part way simply repeats the round. The follower keeps
+ * an item history of its own, rebuilt from the events it applies.
+ **********************************************/
+#include "Replica.h"
+#include "BlockFile.h"
+#include "BloomFilter.h"
+#include "ChangeFeed.h"
+#include "ChangeItem.h"
+#include "ChangeRequest.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "ItemArchive.h"
+#include "ItemHistory.h"
+#include "ProductRelease.h"
+#include "RecordChecksum.h"
+#include "Requester.h"
+#include "Snapshot.h"
+#include "StorageLayout.h"
+#include "TrackerClient.h"
+#include "TrackerDaemon.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//================================
+// Constants
+//================================
+static const char* MIRROR_DIRECTORY = "partitions.replica";   // Built here, then renamed into place
+static const size_t COPY_CHUNK_BYTES = 1 << 20;
+
+// A data file the follower keeps a copy of.
+struct MirroredFile {
+    std::string path;          // Relative to both data directories; records are sized by the primary's header
+    bool items;                // Holds change items, which are indexed and snapshot-protected
+    bool archive = false;      // An archive of change items: a block file the primary replaces whole, copied whole
+};
+
+// Where a change item lives in the local copy.
+struct ItemLocation {
+    std::string segment;
+    long long offset;
+};
+
+//================================
+// Static Variables
+//================================
+static std::filesystem::path primaryRoot;
+static std::thread followerThread;
+static std::mutex controlMutex;                  // Serializes start, stop and promote
+static std::mutex stopMutex;
+static std::condition_variable stopSignal;
+static bool stopRequested = false;
+static std::atomic<bool> following(false);
+static std::atomic<long long> appliedSequence(0);
+static std::atomic<long long> primarySequence(0);
+static std::atomic<long long> caughtUpAtMs(0);
+
+// Only touched by the thread running catchUp
+static std::unordered_map<int, ItemLocation> itemLocations;
+static bool indexed = false;
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: nowMs
+ * Description: Returns a monotonic time in milliseconds.
+ **********************************************/
+static long long nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**********************************************
+ * Function: wholeSize
+ * Description: Returns the size of a file rounded down to whole records, or 0 if it is missing.
+ **********************************************/
+static long long wholeSize(const std::filesystem::path& path, long long recordSize) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    if (error)
+        return 0;
+    return static_cast<long long>(size - size % static_cast<uintmax_t>(recordSize));
+}
+
+/**********************************************
+ * Function: primaryPartitioned
+ * Description: Returns true if the primary uses per-product segments.
+ **********************************************/
+static bool primaryPartitioned() {
+    std::error_code error;
+    return std::filesystem::is_directory(primaryRoot / PARTITION_DIRECTORY, error);
+}
+
+/**********************************************
+ * Function: mirroredFiles
+ * Description: Lists the primary's data files in the primary's current layout,
+ *              archives of change items included, after the item files they
+ *              belong to.
+ **********************************************/
+static std::vector<MirroredFile> mirroredFiles() {
+    std::vector<MirroredFile> files = {
+        {"ProductRelease.txt", false},
+        {"Product.txt", false},
+        {"req.txt", false},
+    };
+    std::error_code error;
+    if (!primaryPartitioned()) {
+        files.push_back({ITEM_FILE, true});
+        files.push_back({REQUEST_FILE, false});
+        std::string archive = StorageLayout::archivePath(ITEM_FILE);
+        if (std::filesystem::exists(primaryRoot / archive, error))
+            files.push_back({archive, true, true});
+        return files;
+    }
+
+    std::string itemPrefix = std::string(ITEM_SEGMENT_PREFIX) + "-";
+    std::string requestPrefix = std::string(REQUEST_SEGMENT_PREFIX) + "-";
+    for (const auto& entry : std::filesystem::directory_iterator(primaryRoot / PARTITION_DIRECTORY, error)) {
+        std::string name = entry.path().filename().string();
+        std::string path = (std::filesystem::path(PARTITION_DIRECTORY) / name).string();
+        if (entry.path().extension() != ".txt")
+            continue; // A backup or a file being written
+        if (name.compare(0, itemPrefix.size(), itemPrefix) == 0)
+            files.push_back({path, true});
+        else if (name.compare(0, requestPrefix.size(), requestPrefix) == 0)
+            files.push_back({path, false});
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(primaryRoot / PARTITION_DIRECTORY / ARCHIVE_DIRECTORY, error)) {
+        std::string name = entry.path().filename().string();
+        if (entry.path().extension() == ".txt" && name.compare(0, itemPrefix.size(), itemPrefix) == 0)
+            files.push_back({(std::filesystem::path(PARTITION_DIRECTORY) / ARCHIVE_DIRECTORY / name).string(), true, true});
+    }
+    return files;
+}
+
+/**********************************************
+ * Function: indexItems
+ * Description: Adds the change items of a local segment from offset on to the location index.
+ **********************************************/
+static void indexItems(const std::string& segment, long long from) {
+    VersionedReader reader(segment);
+    std::ifstream infile(segment, std::ios::binary);
+    infile.seekg(from);
+    ChangeItem changeItem;
+    for (long long offset = from; reader.usable() && reader.read(infile, reinterpret_cast<char*>(&changeItem), 1) == 1;
+         offset += static_cast<long long>(reader.storedSize()))
+        itemLocations[changeItem.getChangeId()] = {segment, offset};
+}
+
+/**********************************************
+ * Function: copyArchive
+ * Description:
+ * Brings the local copy of an archive up to date. The primary only ever replaces
+ * an archive whole, so once the generation or size of its archive differs from
+ * the local copy's, the file is copied to a temporary file and checked, its keys
+ * go into the lookup filter of its item file, and it is renamed over the local
+ * copy while the local archives are held still. The caller holds the primary's
+ * archives still.
+ * Parameters:
+ * - file: The archive
+ * Returns: bool - False if the archive could not be copied
+ **********************************************/
+static bool copyArchive(const MirroredFile& file) {
+    std::filesystem::path primaryPath = primaryRoot / file.path;
+    int primaryGeneration = FileFormat::generation(primaryPath.string());
+    std::error_code error;
+    uintmax_t primarySize = std::filesystem::file_size(primaryPath, error);
+    if (error)
+        return true; // Gone with a migration of the primary
+    uintmax_t localSize = std::filesystem::file_size(file.path, error);
+    if (!error && localSize == primarySize && FileFormat::generation(file.path) == primaryGeneration)
+        return true;
+
+    std::filesystem::create_directories(std::filesystem::path(file.path).parent_path(), error);
+    std::string temporary = file.path + ".tmp";
+    std::filesystem::copy_file(primaryPath, temporary, std::filesystem::copy_options::overwrite_existing, error);
+    if (error || !BlockReader(temporary).valid()) {
+        std::cerr << "Replica: failed to copy " << file.path << "." << std::endl;
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    std::filesystem::path path(file.path);
+    BloomFilter* filter = BloomFilter::forDataFile((path.parent_path().parent_path() / path.filename()).string());
+    if (filter != nullptr)
+        filter->growIfFull();
+
+    RecordLock archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+    std::optional<BloomFilter::WriteScope> filterScope;
+    if (filter != nullptr) {
+        filterScope.emplace(*filter);
+        filter->addBlockFile(temporary);
+    }
+    // Stamped first: a crash before the rename leaves the sizes differing, so the copy is made again
+    if (!FileFormat::stamp(file.path, FileFormat::layout(primaryPath.string()).version, primaryGeneration))
+        return false;
+    std::filesystem::rename(temporary, file.path, error);
+    std::filesystem::remove(RecordChecksum::checksumPath(file.path), error); // Left by an archive from before block files
+    return true;
+}
+
+/**********************************************
+ * Function: copyTail
+ * Description:
+ * Appends the whole records the primary's file has beyond the local copy. A partial
+ * record at the end of the local copy, left by a crash, is cut off first. Their keys
+ * go into the lookup filter of the file before the records are copied, as they do
+ * when the entity modules write, and so do their checksums. The copy keeps the
+ * record version and the generation of the primary's file, so offsets match on
+ * both sides; once the primary upgrades the file or moves records within it, the
+ * copy is emptied and copied again. Change item files start over while the local
+ * archives are held still, so local readers never see a file half copied.
+ * The caller holds the primary's archives still.
+ * Parameters:
+ * - file: The file to bring up to date
+ * Returns: bool - False if the local copy is longer than the primary's file.
+ **********************************************/
+static bool copyTail(const MirroredFile& file) {
+    if (file.archive)
+        return copyArchive(file);
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(file.path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, error);
+    std::ofstream(file.path, std::ios::binary | std::ios::app).close(); // A new segment must exist to be covered
+    RecordLayout primaryLayout = FileFormat::layout((primaryRoot / file.path).string());
+    if (!primaryLayout.known()) {
+        std::cerr << "Replica: " << file.path << " is in a record version this program cannot read." << std::endl;
+        return false;
+    }
+    int primaryGeneration = FileFormat::generation((primaryRoot / file.path).string());
+    std::optional<RecordLock> fileLock;
+    std::optional<RecordLock> archiveLock;
+    if (FileFormat::layout(file.path).version != primaryLayout.version || FileFormat::generation(file.path) != primaryGeneration) {
+        // Upgraded or rewritten on the primary, or not copied yet: the copy starts over in the primary's version
+        fileLock.emplace(file.path.c_str(), 0, APPEND_LOCK_OFFSET + 1, true);
+        if (file.items)
+            archiveLock.emplace(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+        RecordLock formatLock(file.path.c_str(), FORMAT_LOCK_OFFSET, 1, true);
+        std::filesystem::resize_file(file.path, 0, error);
+        RecordChecksum::truncate(file.path, primaryLayout.size, 0);
+        if (error || !FileFormat::stamp(file.path, primaryLayout.version, primaryGeneration))
+            return false;
+        std::erase_if(itemLocations, [&](const auto& entry) { return entry.second.segment == file.path; });
+    }
+    long long recordSize = static_cast<long long>(primaryLayout.size);
+
+    BloomFilter* filter = BloomFilter::forDataFile(file.path);
+    if (filter != nullptr)
+        filter->growIfFull(); // Catches up with the keys the previous pass added
+    long long primarySize = wholeSize(primaryRoot / file.path, recordSize);
+    uintmax_t size = std::filesystem::file_size(file.path, error);
+    long long localSize = error ? 0 : static_cast<long long>(size);
+    if (localSize % recordSize != 0) {
+        localSize -= localSize % recordSize;
+        std::filesystem::resize_file(file.path, static_cast<uintmax_t>(localSize), error);
+    }
+    if (primarySize < localSize) {
+        std::cerr << "Replica: " << file.path << " is longer than on the primary." << std::endl;
+        return false;
+    }
+    if (primarySize == localSize)
+        return true;
+
+    std::optional<BloomFilter::WriteScope> filterScope;
+    if (filter != nullptr) {
+        filterScope.emplace(*filter);
+        filter->addRecords((primaryRoot / file.path).string(), localSize, primarySize);
+    }
+    if (!RecordChecksum::copy((primaryRoot / file.path).string(), file.path, static_cast<size_t>(recordSize), localSize, primarySize - localSize))
+        return false;
+
+    std::ifstream in(primaryRoot / file.path, std::ios::binary);
+    in.seekg(localSize);
+    std::optional<Snapshot::WriteScope> scope;
+    if (file.items)
+        scope.emplace();
+    std::ofstream out(file.path, std::ios::binary | std::ios::app);
+    std::vector<char> chunk(COPY_CHUNK_BYTES);
+    for (long long remaining = primarySize - localSize; remaining > 0;) {
+        size_t count = static_cast<size_t>(std::min<long long>(remaining, COPY_CHUNK_BYTES));
+        if (!in.read(chunk.data(), count) || !out.write(chunk.data(), count))
+            return false;
+        remaining -= count;
+    }
+    out.close();
+    if (out.fail())
+        return false;
+    if (file.items)
+        indexItems(file.path, localSize);
+    return true;
+}
+
+/**********************************************
+ * Function: mirrorPartitions
+ * Description:
+ * Follows a migration of the primary: copies its segments into a temporary
+ * directory, renames it into place and empties the local single files, the same
+ * steps the migration itself takes. The keys of the copied records are added to
+ * the lookup filters; the archives are left to copyTail.
+ * Returns: bool - True if the local copy is partitioned afterwards.
+ **********************************************/
+static bool mirrorPartitions() {
+    RecordLock itemLock(ITEM_FILE, 0, APPEND_LOCK_OFFSET + 1, true);
+    RecordLock requestLock(REQUEST_FILE, 0, APPEND_LOCK_OFFSET + 1, true);
+
+    std::error_code error;
+    std::filesystem::remove_all(MIRROR_DIRECTORY, error);
+    std::filesystem::create_directory(MIRROR_DIRECTORY, error);
+    for (const auto& entry : std::filesystem::directory_iterator(primaryRoot / PARTITION_DIRECTORY, error)) {
+        if (entry.path().extension() == ".tmp" || entry.path().extension() == ".upgrade" || entry.is_directory())
+            continue; // Being written on the primary, or the archives, which are copied like any other file
+        if (!std::filesystem::copy_file(entry.path(), std::filesystem::path(MIRROR_DIRECTORY) / entry.path().filename(), error))
+            break;
+    }
+    if (!error)
+        std::filesystem::rename(MIRROR_DIRECTORY, PARTITION_DIRECTORY, error);
+    if (error) {
+        std::cerr << "Replica: failed to copy the primary's segments: " << error.message() << std::endl;
+        std::filesystem::remove_all(MIRROR_DIRECTORY, error);
+        return false;
+    }
+
+    std::filesystem::resize_file(ITEM_FILE, 0, error);
+    std::filesystem::resize_file(REQUEST_FILE, 0, error);
+    std::string archive = StorageLayout::archivePath(ITEM_FILE);
+    if (std::filesystem::exists(archive, error)) {
+        RecordLock archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+        std::filesystem::remove(archive, error);
+        std::filesystem::remove(RecordChecksum::checksumPath(archive), error);
+    }
+    RecordChecksum::truncate(ITEM_FILE, sizeof(ChangeItem), 0);
+    RecordChecksum::truncate(REQUEST_FILE, Schema<ChangeRequest>::SIZE, 0);
+    // The copied records' keys go into the lookup filters, as copyTail adds the records it appends
+    for (const auto& entry : std::filesystem::directory_iterator(PARTITION_DIRECTORY, error)) {
+        std::string segment = entry.path().string();
+        BloomFilter* filter = BloomFilter::forDataFile(segment);
+        if (filter == nullptr)
+            continue;
+        BloomFilter::WriteScope filterScope(*filter);
+        filter->addRecords(segment, 0, wholeSize(segment, static_cast<long long>(FileFormat::layout(segment).size)));
+    }
+    FileFormat::stamp(ITEM_FILE, FileFormat::currentLayout(RecordKind::CHANGE_ITEM).version);
+    FileFormat::stamp(REQUEST_FILE, FileFormat::currentLayout(RecordKind::CHANGE_REQUEST).version);
+    itemLocations.clear();
+    indexed = false;
+    return true;
+}
+
+/**********************************************
+ * Function: recopyItem
+ * Description:
+ * Overwrites the local copy of a change item with the primary's current record.
+ * Items not copied yet are skipped: copying the tail brings their current record.
+ * A primary record that fails its checksum is not copied.
+ * Parameters:
+ * - changeId: The updated change item
+ **********************************************/
+static void recopyItem(int changeId) {
+    auto location = itemLocations.find(changeId);
+    if (location == itemLocations.end())
+        return;
+    const std::string& segment = location->second.segment;
+    long long offset = location->second.offset;
+
+    ChangeItem current;
+    {
+        std::string source = (primaryRoot / segment).string();
+        RecordLock primaryLock(source.c_str(), offset, sizeof(ChangeItem), false);
+        std::ifstream in(source, std::ios::binary);
+        in.seekg(offset);
+        if (!in.read(reinterpret_cast<char*>(&current), sizeof(ChangeItem)) ||
+            !RecordChecksum::verify(source, sizeof(ChangeItem), offset, &current))
+            return;
+    }
+
+    RecordLock recordLock(segment.c_str(), offset, sizeof(ChangeItem), true);
+    std::fstream local(segment, std::ios::in | std::ios::out | std::ios::binary);
+    ChangeItem before;
+    local.seekg(offset);
+    if (!local.read(reinterpret_cast<char*>(&before), sizeof(ChangeItem)) ||
+        std::memcmp(&before, &current, sizeof(ChangeItem)) == 0)
+        return;
+
+    Snapshot::WriteScope scope;
+    Snapshot::preserve(before);
+    local.seekp(offset);
+    local.write(reinterpret_cast<const char*>(&current), sizeof(ChangeItem));
+    local.close(); // Written before its checksum, as the primary writes an update
+    RecordChecksum::store(segment, sizeof(ChangeItem), offset, &current, 1);
+}
+
+/**********************************************
+ * Function: mirrorMark
+ * Description:
+ * Raises the local change ID high-water mark to the primary's, so a promoted
+ * follower never hands out an ID the primary may already have used.
+ * Parameters:
+ * - markFile: The mark file name
+ **********************************************/
+static void mirrorMark(const char* markFile) {
+    long long primaryMark = -1;
+    long long localMark = -1;
+    std::ifstream(primaryRoot / markFile) >> primaryMark;
+    std::ifstream(markFile) >> localMark;
+    if (primaryMark <= localMark)
+        return;
+
+    std::string temporary = std::string(markFile) + ".tmp";
+    {
+        std::ofstream out(temporary);
+        out << primaryMark << "\n";
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, markFile, error);
+}
+
+/**********************************************
+ * Function: recordHistory
+ * Description:
+ * Rebuilds the item history from applied events, at the times the primary
+ * recorded them. A round repeated after a crash finds its transitions already
+ * there and skips them.
+ **********************************************/
+static void recordHistory(const std::vector<FeedEvent>& events) {
+    static const Transition::Kind KINDS[] = {Transition::CREATED, Transition::STATE, Transition::PRIORITY};
+    for (const FeedEvent& event : events) {
+        if (event.entity != FeedEvent::CHANGE_ITEM || event.kind > FeedEvent::PRIORITY_CHANGED)
+            continue;
+        std::string product(event.product, strnlen(event.product, sizeof(event.product)));
+        ItemHistory::record(event.changeId, product, KINDS[event.kind], event.state, event.priority, event.timestamp, true);
+    }
+}
+
+/**********************************************
+ * Function: appendEvents
+ * Description: Appends applied events to the local feed under its append lock.
+ **********************************************/
+static bool appendEvents(const std::vector<FeedEvent>& events) {
+    RecordLock appendLock(FEED_FILE, APPEND_LOCK_OFFSET, 1, true);
+    std::ofstream feed(FEED_FILE, std::ios::binary | std::ios::app);
+    feed.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(FeedEvent)));
+    feed.close();
+    return !feed.fail();
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: catchUp
+ * Description:
+ * Runs one replication round: copies everything appended to the primary's files,
+ * then applies the primary's new feed events in batches.
+ * Returns: bool - False if the primary could not be read or has diverged.
+ **********************************************/
+bool Replica::catchUp() {
+    std::filesystem::path primaryFeed = primaryRoot / FEED_FILE;
+    long long primaryEnd = wholeSize(primaryFeed, sizeof(FeedEvent)) / static_cast<long long>(sizeof(FeedEvent));
+    long long applied = wholeSize(FEED_FILE, sizeof(FeedEvent)) / static_cast<long long>(sizeof(FeedEvent));
+    std::error_code error;
+    if (std::filesystem::exists(FEED_FILE, error))
+        std::filesystem::resize_file(FEED_FILE, static_cast<uintmax_t>(applied) * sizeof(FeedEvent), error);
+    if (applied > primaryEnd) {
+        std::cerr << "Replica: the local feed is ahead of the primary's." << std::endl;
+        return false;
+    }
+
+    if (primaryPartitioned() && !StorageLayout::isPartitioned() && !mirrorPartitions())
+        return false;
+    if (!indexed) {
+        for (const std::string& segment : StorageLayout::itemSegments())
+            indexItems(segment, 0);
+        indexed = true;
+    }
+    {
+        // The primary moves no item between its item files and archives while they are copied
+        RecordLock primaryArchiveLock((primaryRoot / ITEM_FILE).string().c_str(), ARCHIVE_LOCK_OFFSET, 1, false);
+        for (const MirroredFile& file : mirroredFiles())
+            if (!copyTail(file))
+                return false;
+    }
+    mirrorMark(ITEM_MARK_FILE);
+    mirrorMark(REQUEST_MARK_FILE);
+
+    std::ifstream feed(primaryFeed, std::ios::binary);
+    feed.seekg(applied * static_cast<long long>(sizeof(FeedEvent)));
+    std::vector<FeedEvent> events;
+    while (applied < primaryEnd) {
+        events.resize(static_cast<size_t>(std::min(primaryEnd - applied, REPLICA_BATCH_EVENTS)));
+        if (!feed.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(FeedEvent))))
+            return false;
+
+        std::unordered_set<int> updated;
+        for (const FeedEvent& event : events)
+            if (event.entity == FeedEvent::CHANGE_ITEM && event.kind != FeedEvent::CREATED)
+                updated.insert(event.changeId);
+        for (int changeId : updated)
+            recopyItem(changeId);
+        recordHistory(events);
+        if (!appendEvents(events))
+            return false;
+
+        applied += static_cast<long long>(events.size());
+        appliedSequence = applied;
+    }
+    primarySequence = primaryEnd;
+    appliedSequence = applied;
+    caughtUpAtMs = nowMs();
+    return true;
+}
+
+/**********************************************
+ * Function: startFollowing
+ * Description:
+ * Checks the primary directory, catches up once so the first clients already see
+ * recent data, and starts the background thread, which repeats a round every
+ * REPLICA_POLL_MS and reports lag beyond REPLICA_LAG_WARNING_MS.
+ * Parameters:
+ * - primaryDirectory: The primary's data directory
+ * Returns: bool - False if the directory is not usable as a primary.
+ **********************************************/
+bool Replica::startFollowing(const std::string& primaryDirectory) {
+    std::lock_guard<std::mutex> control(controlMutex);
+    if (following) {
+        std::cerr << "Already following " << primaryRoot << "." << std::endl;
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::path root = std::filesystem::canonical(primaryDirectory, error);
+    if (error || !std::filesystem::is_directory(root, error)) {
+        std::cerr << "The primary directory " << primaryDirectory << " does not exist." << std::endl;
+        return false;
+    }
+    if (root == std::filesystem::canonical(std::filesystem::current_path(), error)) {
+        std::cerr << "A follower needs a data directory of its own." << std::endl;
+        return false;
+    }
+
+    primaryRoot = root;
+    following = true;
+    caughtUpAtMs = nowMs();
+    if (!catchUp())
+        std::cerr << "Replica: the first round failed; retrying in the background." << std::endl;
+
+    stopRequested = false;
+    followerThread = std::thread([]() {
+        bool failing = false;
+        bool warned = false;
+        std::unique_lock<std::mutex> lock(stopMutex);
+        while (!stopRequested) {
+            lock.unlock();
+            bool ok = catchUp();
+            if (!ok && !failing)
+                std::cerr << "Replica: cannot apply the primary's changes; retrying." << std::endl;
+            failing = !ok;
+            long long lag = status().lagMs;
+            if (lag > REPLICA_LAG_WARNING_MS && !warned)
+                std::cerr << "Replica: " << lag << " ms behind the primary." << std::endl;
+            warned = lag > REPLICA_LAG_WARNING_MS;
+            lock.lock();
+            stopSignal.wait_for(lock, std::chrono::milliseconds(REPLICA_POLL_MS), []() { return stopRequested; });
+        }
+    });
+    std::cout << "Following " << root.string() << " at sequence " << appliedSequence.load() << "." << std::endl;
+    return true;
+}
+
+/**********************************************
+ * Function: stopFollowing
+ * Description: Stops the background thread and waits for its round to finish.
+ **********************************************/
+void Replica::stopFollowing() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopRequested = true;
+    }
+    stopSignal.notify_all();
+    if (followerThread.joinable())
+        followerThread.join();
+}
+
+/**********************************************
+ * Function: promote
+ * Description:
+ * Stops following, applies whatever the primary's feed still holds, and lets
+ * writes in. A primary that can no longer be read is not an error: failover is
+ * exactly the case where it is gone.
+ * Returns: bool - False if the process was not following.
+ **********************************************/
+bool Replica::promote() {
+    std::lock_guard<std::mutex> control(controlMutex);
+    if (!following)
+        return false;
+    stopFollowing();
+    if (!catchUp())
+        std::cerr << "Replica: the primary could not be read; promoting with the changes applied so far." << std::endl;
+    following = false;
+    std::cout << "Promoted at sequence " << appliedSequence.load() << "; writes are accepted." << std::endl;
+    return true;
+}
+
+/**********************************************
+ * Function: isFollower
+ * Description: Returns true while writes must be refused.
+ **********************************************/
+bool Replica::isFollower() {
+    return following;
+}
+
+/**********************************************
+ * Function: status
+ * Description:
+ * Reports the replication position. The lag is the time since a round last
+ * finished with every primary event applied, so it is an upper bound on how old
+ * the local copy can be.
+ **********************************************/
+ReplicaStatus Replica::status() {
+    ReplicaStatus current;
+    current.follower = following;
+    if (!current.follower) {
+        current.applied = current.primaryEnd = ChangeFeed::endSequence();
+        return current;
+    }
+    current.applied = appliedSequence;
+    current.primaryEnd = std::max(primarySequence.load(), current.applied);
+    current.lagMs = std::max(0LL, nowMs() - caughtUpAtMs.load());
+    return current;
+}
+
+/**********************************************
+ * Function: runFollower
+ * Description: Follows the primary and serves read-only daemon clients until stopped.
+ * Parameters:
+ * - primaryDirectory: The primary's data directory
+ * - socketPath: The socket of the follower's own daemon
+ * - threadCount: The number of daemon worker threads; 0 uses the hardware concurrency
+ * Returns: int - The process exit status.
+ **********************************************/
+int Replica::runFollower(const std::string& primaryDirectory, const char* socketPath, int threadCount) {
+    if (!startFollowing(primaryDirectory))
+        return 1;
+    bool served = TrackerDaemon::runDaemon(socketPath, threadCount);
+    stopFollowing();
+    return served ? 0 : 1;
+}
+
+/**********************************************
+ * Function: printStatus
+ * Description: Prints the replication status of the daemon on socketPath.
+ **********************************************/
+int Replica::printStatus(const char* socketPath) {
+    TrackerClient client;
+    uint8_t role;
+    uint64_t applied, primaryEnd, lagMs;
+    if (!client.connectTo(socketPath) || client.replicaStatus(role, applied, primaryEnd, lagMs) != STATUS_OK) {
+        std::cerr << "No daemon answered on " << socketPath << "." << std::endl;
+        return 1;
+    }
+    if (role == REPLICA_ROLE_PRIMARY) {
+        std::cout << "primary at sequence " << applied << std::endl;
+        return 0;
+    }
+    std::cout << "follower applied " << applied << " of " << primaryEnd << " events, lag "
+              << (primaryEnd - applied) << " events, " << lagMs << " ms" << std::endl;
+    return 0;
+}
+
+/**********************************************
+ * Function: requestPromotion
+ * Description: Asks the follower daemon on socketPath to promote itself.
+ **********************************************/
+int Replica::requestPromotion(const char* socketPath) {
+    TrackerClient client;
+    if (!client.connectTo(socketPath)) {
+        std::cerr << "No daemon answered on " << socketPath << "." << std::endl;
+        return 1;
+    }
+    int status = client.promote();
+    if (status != STATUS_OK) {
+        std::cerr << "The daemon on " << socketPath << " is not a follower." << std::endl;
+        return 1;
+    }
+    std::cout << "Promoted; the daemon on " << socketPath << " now accepts writes." << std::endl;
+    return 0;
+}
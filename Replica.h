@@ -0,0 +1,99 @@
+/**********************************************
+ * Replica Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module turns a tracker process into a read-only follower of another data
+ * directory, the primary. The change feed is the replication log: every committed
+ * change on the primary ends with an event in its ChangeFeed.txt, and the follower
+ * keeps its own copy of the feed as far as it has applied it. Each round the
+ * follower copies the records appended to the primary's data files since the last
+ * round, re-copies the change items that the new events report as updated, and
+ * then appends those events to its own feed. The length of the follower's feed is
+ * therefore its replication position, which survives restarts without any extra
+ * state.
+ *
+ * The follower reads the primary's files through a shared directory and never
+ * writes to them. While following, the daemon serves lookups, listings, reports
+ * and the feed from the follower's copy and refuses writes. Promoting the follower
+ * applies what is left of the primary's feed, stops following and lets writes in;
+ * the primary must be stopped first, or the two copies diverge.
+ **********************************************/
+#ifndef REPLICA_H
+#define REPLICA_H
+
+#include <string>
+
+//=============================
+// Constants
+//=============================
+const int REPLICA_POLL_MS = 20;                  // Pause between rounds once the follower has caught up
+const long long REPLICA_LAG_WARNING_MS = 5000;   // Lag beyond this is reported on the console
+const long long REPLICA_BATCH_EVENTS = 4096;     // Feed events applied per step of a round
+
+//=============================
+// Record Types
+//=============================
+
+// Replication progress, as reported by OP_REPLICA_STATUS.
+struct ReplicaStatus {
+    bool follower = false;        // False once promoted, or if the process never followed
+    long long applied = 0;        // Feed events applied to the local copy
+    long long primaryEnd = 0;     // Feed events on the primary when it was last read
+    long long lagMs = 0;          // Time since the follower last had every primary event, 0 if it has
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class Replica {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool startFollowing(const std::string& primaryDirectory);
+    // Description: Catches up with the primary once, then keeps applying its changes on
+    //              a background thread. The entity modules must already be initialized.
+    // Parameters:
+    // - const std::string& primaryDirectory: The primary's data directory.
+    // Returns: bool - False if the directory is not usable as a primary.
+
+    //----------------------------------------------------------
+    static void stopFollowing();
+    // Description: Stops the background thread. The process stays read-only.
+
+    //----------------------------------------------------------
+    static bool promote();
+    // Description: Applies the primary's remaining changes if it is still readable,
+    //              stops following and makes the local copy writable.
+    // Returns: bool - False if the process was not following.
+
+    //----------------------------------------------------------
+    static bool isFollower();
+    // Description: Returns true while writes must be refused.
+
+    //----------------------------------------------------------
+    static ReplicaStatus status();
+    // Description: Returns the current replication position and lag.
+
+    //----------------------------------------------------------
+    static int runFollower(const std::string& primaryDirectory, const char* socketPath, int threadCount);
+    // Description: Follows the primary and serves read-only daemon clients until stopped.
+    // Returns: int - The process exit status.
+
+    //----------------------------------------------------------
+    static int printStatus(const char* socketPath);
+    static int requestPromotion(const char* socketPath);
+    // Description: Ask the daemon on socketPath for its replication status, or to promote
+    //              itself, and print the answer.
+    // Returns: int - The process exit status.
+
+private:
+    static bool catchUp();
+};
+
+#endif // REPLICA_H
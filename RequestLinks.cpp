@@ -0,0 +1,631 @@
+/**********************************************
+ * RequestLinks Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added allRequests.
+ * - 2026-10-19: init reads change request files in any record version.
+ * - 2026-10-19: printMostRequested is timed for the metrics endpoint.
+ * - 2026-10-19: Split the printing out of printMostRequested(count).
+ *--------------------------------
+ * Purpose:
+ * This module implements the request links. The link file is an array of fixed
+ * size links; each holds the request and change item IDs, the requester and
+ * product, and the offsets (plus one, 0 for none) of the previous link of the
+ * same change item and of the same requester. The request index starts with a
+ * header (the feed sequence folded up to and the link file length indexed),
+ * followed by the offset plus one of every request's link. The item index holds
+ * the latest link and the request count of every change ID, and the requester
+ * index one entry per requester name.
+ *
+ * Folds run under the append sentinel lock of the link file, and readers hold it
+ * while they read. A fold first indexes links past the indexed length, then
+ * appends a link for each request creation in the feed past the folded sequence
+ * and indexes it. Indexing a link writes its back pointers, then the request,
+ * item and requester entries; the header is written last, so a fold cut short by
+ * a crash is repeated by the next reader. Links are indexed in file order, so an
+ * entry that already points at a link or a later one has seen it, and a request
+ * that already has a link is not linked again.
+ **********************************************/
+#include "RequestLinks.h"
+#include "ChangeFeed.h"
+#include "ChangeRequest.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "Metrics.h"
+#include "StorageLayout.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+//================================
+// Constants
+//================================
+static const size_t FOLD_CHUNK_EVENTS = 4096;   // Feed events read per step while folding
+static const int SCAN_CHUNK_RECORDS = 4096;     // Change requests or links read per step
+static const int ITEM_CHUNK_ENTRIES = 4096;     // Item entries read per step while ranking
+
+//================================
+// File Records
+//================================
+
+struct LinksHeader {
+    long long folded;               // The feed sequence to fold from next
+    long long indexed;              // The link file length the indexes cover
+};
+
+struct LinkRecord {
+    int32_t requestId;
+    int32_t changeItemId;           // -1 if the request is not linked to a change item
+    int64_t previousForItem;        // Offset plus one of the item's previous link, or 0
+    int64_t previousForRequester;   // Offset plus one of the requester's previous link, or 0
+    char requester[30];
+    char product[11];
+    char reserved[7];
+};
+
+struct ItemEntry {
+    int64_t latestPlusOne;          // 0 if the item has no requests
+    int32_t requests;
+    int32_t reserved;
+};
+
+struct RequesterEntry {
+    char requester[30];
+    char reserved[2];
+    int32_t requests;
+    int32_t reserved2;
+    int64_t latestPlusOne;
+};
+
+static_assert(sizeof(LinkRecord) == REQUEST_LINK_SIZE, "Links are 72 bytes in ChangeRequest.links");
+static_assert(sizeof(ItemEntry) == 16, "Item entries are 16 bytes in ChangeRequest.items");
+static_assert(sizeof(RequesterEntry) == 48, "Requester entries are 48 bytes in ChangeRequest.requesters");
+
+//================================
+// Helpers
+//================================
+
+static std::fstream openFile(const char* path) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (file.is_open())
+        return file;
+    std::ofstream(path, std::ios::binary | std::ios::app).close();
+    return std::fstream(path, std::ios::in | std::ios::out | std::ios::binary);
+}
+
+template <typename T>
+static bool readAt(std::fstream& file, long long offset, T& value) {
+    file.seekg(offset);
+    if (file.read(reinterpret_cast<char*>(&value), sizeof(T)))
+        return true;
+    file.clear();
+    return false;
+}
+
+template <typename T>
+static void writeAt(std::fstream& file, long long offset, const T& value) {
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static long long requestOffset(int requestId) {
+    return static_cast<long long>(sizeof(LinksHeader)) + static_cast<long long>(requestId) * static_cast<long long>(sizeof(int64_t));
+}
+
+static long long itemOffset(int changeItemId) {
+    return static_cast<long long>(changeItemId) * static_cast<long long>(sizeof(ItemEntry));
+}
+
+static LinkRecord makeLink(int requestId, int changeItemId, const std::string& requester, const std::string& product) {
+    LinkRecord link{};
+    link.requestId = requestId;
+    link.changeItemId = changeItemId < 0 ? -1 : changeItemId;
+    strncpy(link.requester, requester.c_str(), sizeof(link.requester) - 1);
+    strncpy(link.product, product.c_str(), sizeof(link.product) - 1);
+    return link;
+}
+
+static LinkedRequest toLinkedRequest(const LinkRecord& link) {
+    LinkedRequest request;
+    request.requestId = link.requestId;
+    request.changeItemId = link.changeItemId;
+    request.requester.assign(link.requester, strnlen(link.requester, sizeof(link.requester)));
+    request.product.assign(link.product, strnlen(link.product, sizeof(link.product)));
+    return request;
+}
+
+/**********************************************
+ * Function: appendLinks
+ * Description:
+ * Appends links to the link file without indexing them, after cutting off a
+ * partial link left by a crash. Called with the link lock held.
+ * Parameters:
+ * - links: The links to append
+ * Returns: bool - False if the links could not be written.
+ **********************************************/
+static bool appendLinks(const std::vector<LinkRecord>& links) {
+    if (links.empty())
+        return true;
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(REQUEST_LINK_FILE, error);
+    if (!error && size % sizeof(LinkRecord) != 0)
+        std::filesystem::resize_file(REQUEST_LINK_FILE, size - size % sizeof(LinkRecord), error);
+
+    std::ofstream file(REQUEST_LINK_FILE, std::ios::binary | std::ios::app);
+    file.write(reinterpret_cast<const char*>(links.data()), static_cast<std::streamsize>(links.size() * sizeof(LinkRecord)));
+    file.close(); // On disk before the header says it was folded
+    return !file.fail();
+}
+
+//================================
+// Open Links
+//================================
+
+// The link files as one locked operation sees them. The requester index is small
+// and read whole; the other files are read and written in place.
+class OpenLinks {
+public:
+    OpenLinks();
+    bool isOpen() const;
+    long long fold();
+    bool hasLink(int requestId);
+    bool readLink(long long offsetPlusOne, LinkRecord& link);
+    std::vector<LinkedRequest> chain(long long offsetPlusOne, bool byItem);
+    int findRequester(const char* requester) const;
+
+    std::fstream links;
+    std::fstream byRequest;
+    std::fstream byItem;
+    std::fstream byRequester;
+    std::vector<RequesterEntry> requesters;
+
+private:
+    RecordLock lock;
+    LinksHeader header{0, 0};
+    long long indexTail();
+    void index(long long offset, LinkRecord& link);
+    void writeHeader();
+};
+
+OpenLinks::OpenLinks() : lock(REQUEST_LINK_FILE, APPEND_LOCK_OFFSET, 1, true) {
+    links = openFile(REQUEST_LINK_FILE);
+    byRequest = openFile(LINKS_BY_REQUEST_FILE);
+    byItem = openFile(LINKS_BY_ITEM_FILE);
+    byRequester = openFile(LINKS_BY_REQUESTER_FILE);
+    if (!readAt(byRequest, 0, header))
+        header = {0, 0};
+    RequesterEntry entry;
+    while (byRequester.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+        requesters.push_back(entry);
+    byRequester.clear();
+}
+
+bool OpenLinks::isOpen() const {
+    return links.is_open() && byRequest.is_open() && byItem.is_open() && byRequester.is_open();
+}
+
+int OpenLinks::findRequester(const char* requester) const {
+    for (size_t number = 0; number < requesters.size(); number++)
+        if (strncmp(requesters[number].requester, requester, sizeof(requesters[number].requester)) == 0)
+            return static_cast<int>(number);
+    return -1;
+}
+
+bool OpenLinks::hasLink(int requestId) {
+    int64_t linkPlusOne = 0;
+    return requestId >= 0 && readAt(byRequest, requestOffset(requestId), linkPlusOne) && linkPlusOne != 0;
+}
+
+bool OpenLinks::readLink(long long offsetPlusOne, LinkRecord& link) {
+    return offsetPlusOne > 0 && readAt(links, offsetPlusOne - 1, link);
+}
+
+void OpenLinks::writeHeader() {
+    byItem.flush();
+    byRequester.flush();
+    writeAt(byRequest, 0, header);
+    byRequest.flush();
+}
+
+/**********************************************
+ * Function: OpenLinks::index
+ * Description:
+ * Chains a link to the previous links of its change item and requester, then
+ * points the request, item and requester entries at it. An entry that already
+ * points at this link or a later one has seen it, so a link indexed again after
+ * a crash is neither rechained nor counted twice.
+ * Parameters:
+ * - offset: The offset of the link
+ * - link: The link; receives its back pointers
+ **********************************************/
+void OpenLinks::index(long long offset, LinkRecord& link) {
+    int64_t linkPlusOne = offset + 1;
+    ItemEntry item{0, 0, 0};
+    bool itemSeen = true;
+    if (link.changeItemId >= 0) {
+        readAt(byItem, itemOffset(link.changeItemId), item);
+        itemSeen = item.latestPlusOne >= linkPlusOne;
+    }
+    int number = findRequester(link.requester);
+    if (number < 0) {
+        RequesterEntry entry{};
+        memcpy(entry.requester, link.requester, sizeof(entry.requester));
+        requesters.push_back(entry);
+        number = static_cast<int>(requesters.size()) - 1;
+    }
+    RequesterEntry& requester = requesters[static_cast<size_t>(number)];
+    bool requesterSeen = requester.latestPlusOne >= linkPlusOne;
+
+    // The back pointers go to disk before any entry points at the link
+    int64_t previousForItem = itemSeen ? link.previousForItem : item.latestPlusOne;
+    int64_t previousForRequester = requesterSeen ? link.previousForRequester : requester.latestPlusOne;
+    if (previousForItem != link.previousForItem || previousForRequester != link.previousForRequester) {
+        link.previousForItem = previousForItem;
+        link.previousForRequester = previousForRequester;
+        writeAt(links, offset, link);
+        links.flush();
+    }
+
+    int64_t current = 0;
+    if (link.requestId >= 0 && (!readAt(byRequest, requestOffset(link.requestId), current) || current != linkPlusOne))
+        writeAt(byRequest, requestOffset(link.requestId), linkPlusOne);
+    if (!itemSeen) {
+        item.latestPlusOne = linkPlusOne;
+        item.requests++;
+        writeAt(byItem, itemOffset(link.changeItemId), item);
+    }
+    if (!requesterSeen) {
+        requester.latestPlusOne = linkPlusOne;
+        requester.requests++;
+        writeAt(byRequester, static_cast<long long>(number) * static_cast<long long>(sizeof(RequesterEntry)), requester);
+    }
+}
+
+/**********************************************
+ * Function: OpenLinks::indexTail
+ * Description:
+ * Indexes the links past the indexed length, which a fold cut short by a crash or
+ * the search for missing links appended, and cuts off a partial link at the end.
+ * Returns: long long - The length of the link file.
+ **********************************************/
+long long OpenLinks::indexTail() {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(REQUEST_LINK_FILE, error);
+    long long end = error ? 0 : static_cast<long long>(size - size % sizeof(LinkRecord));
+    if (!error && size % sizeof(LinkRecord) != 0)
+        std::filesystem::resize_file(REQUEST_LINK_FILE, static_cast<uintmax_t>(end), error);
+    if (header.indexed > end)
+        header.indexed = end;
+
+    LinkRecord link;
+    for (long long offset = header.indexed; offset < end; offset += static_cast<long long>(sizeof(LinkRecord)))
+        if (readAt(links, offset, link))
+            index(offset, link);
+    header.indexed = end;
+    return end;
+}
+
+/**********************************************
+ * Function: OpenLinks::fold
+ * Description:
+ * Brings the link file and its indexes up to date: indexes unindexed links, then
+ * links every request created in the feed since the last fold.
+ * Returns: long long - The number of links.
+ **********************************************/
+long long OpenLinks::fold() {
+    long long end = indexTail();
+    long long feedEnd = ChangeFeed::endSequence();
+    if (header.folded > feedEnd)
+        header.folded = feedEnd; // The feed was replaced; what is linked stays linked
+
+    FeedFilter filter;
+    filter.entity = FeedEvent::CHANGE_REQUEST;
+    std::vector<FeedEvent> events;
+    std::vector<LinkRecord> created;
+    while (header.folded < feedEnd) {
+        events.clear();
+        created.clear();
+        long long next = ChangeFeed::read(header.folded, filter, FOLD_CHUNK_EVENTS, events);
+        if (next <= header.folded)
+            break;
+        for (const FeedEvent& event : events) {
+            if (event.kind != FeedEvent::CREATED || hasLink(event.changeId))
+                continue;
+            created.push_back(makeLink(event.changeId, event.linkedId - 1, std::string(event.key, strnlen(event.key, sizeof(event.key))),
+                                       std::string(event.product, strnlen(event.product, sizeof(event.product)))));
+        }
+        if (!appendLinks(created))
+            break;
+        for (LinkRecord& link : created) {
+            index(end, link);
+            end += static_cast<long long>(sizeof(LinkRecord));
+        }
+        header.indexed = end;
+        header.folded = next;
+        writeHeader();
+    }
+    writeHeader();
+    return end / static_cast<long long>(sizeof(LinkRecord));
+}
+
+/**********************************************
+ * Function: OpenLinks::chain
+ * Description: Walks a chain of links from the given one back to its first.
+ * Parameters:
+ * - offsetPlusOne: The latest link of the chain
+ * - byItem: True to follow the item's back pointers, false for the requester's
+ * Returns: std::vector<LinkedRequest> - The requests, oldest first.
+ **********************************************/
+std::vector<LinkedRequest> OpenLinks::chain(long long offsetPlusOne, bool byItem) {
+    std::vector<LinkedRequest> requests;
+    LinkRecord link;
+    while (readLink(offsetPlusOne, link)) {
+        requests.push_back(toLinkedRequest(link));
+        long long previous = byItem ? link.previousForItem : link.previousForRequester;
+        if (previous >= offsetPlusOne)
+            break; // Back pointers always point backwards; anything else is damage
+        offsetPlusOne = previous;
+    }
+    std::reverse(requests.begin(), requests.end());
+    return requests;
+}
+
+//================================
+// Function implementations
+//================================
+
+/**********************************************
+ * Function: init
+ * Description:
+ * Folds in new feed events, then compares the number of links with the number of
+ * change request records. If requests are missing links, because they were
+ * written before links were kept or a crash lost their feed event, every append
+ * lock of the change requests is taken so no request is written meanwhile, the
+ * feed is folded again, and each request still without a link gets an unlinked one.
+ * Returns: bool - False if the link files could not be written.
+ **********************************************/
+bool RequestLinks::init() {
+    long long records = 0;
+    for (const std::string& segment : StorageLayout::requestSegments()) {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(segment, error);
+        size_t recordSize = FileFormat::layout(segment).size;
+        if (!error && recordSize > 0)
+            records += static_cast<long long>(size / recordSize);
+    }
+    {
+        OpenLinks open;
+        if (!open.isOpen())
+            return false;
+        if (open.fold() >= records)
+            return true;
+    }
+
+    // Same order as createChangeRequest: the request append locks, then the link lock
+    std::set<std::string> segments;
+    for (const std::string& segment : StorageLayout::requestSegments())
+        segments.insert(segment);
+    std::deque<RecordLock> appendLocks;
+    for (const std::string& segment : segments)
+        appendLocks.emplace_back(segment.c_str(), APPEND_LOCK_OFFSET, 1, true);
+
+    OpenLinks open;
+    open.fold();
+    std::vector<LinkRecord> missing;
+    std::vector<char> chunk(static_cast<size_t>(SCAN_CHUNK_RECORDS) * ChangeRequest::RECORD_SIZE);
+    for (const std::string& segment : segments) {
+        VersionedReader reader(segment);
+        std::ifstream infile(segment, std::ios::binary);
+        while (reader.usable()) {
+            size_t count = reader.read(infile, chunk.data(), SCAN_CHUNK_RECORDS);
+            for (size_t position = 0; position < count; position++) {
+                ChangeRequest changeRequest;
+                Schema<ChangeRequest>::decode(chunk.data() + position * ChangeRequest::RECORD_SIZE, changeRequest);
+                if (!open.hasLink(changeRequest.getChangeId()))
+                    missing.push_back(makeLink(changeRequest.getChangeId(), -1, changeRequest.getRequestedBy(), changeRequest.getProductName()));
+            }
+            if (count * ChangeRequest::RECORD_SIZE < chunk.size())
+                break;
+        }
+    }
+    if (!appendLinks(missing))
+        return false;
+    open.fold();
+    return open.byRequest.good() && open.byItem.good() && open.byRequester.good();
+}
+
+/**********************************************
+ * Function: changeItemOf
+ * Description: Reads the link of one request.
+ * Parameters:
+ * - requestId: The change ID of the request
+ * Returns: int - The change item the request is about, or -1 if it has none.
+ **********************************************/
+int RequestLinks::changeItemOf(int requestId) {
+    if (requestId < 0)
+        return -1;
+    OpenLinks open;
+    open.fold();
+    int64_t linkPlusOne = 0;
+    LinkRecord link;
+    if (!readAt(open.byRequest, requestOffset(requestId), linkPlusOne) || !open.readLink(linkPlusOne, link))
+        return -1;
+    return link.changeItemId;
+}
+
+/**********************************************
+ * Function: requestsForItem
+ * Description: Walks the chain of a change item's links.
+ * Parameters:
+ * - changeItemId: The change ID of the item
+ * Returns: std::vector<LinkedRequest> - The requests about the item, oldest first.
+ **********************************************/
+std::vector<LinkedRequest> RequestLinks::requestsForItem(int changeItemId) {
+    if (changeItemId < 0)
+        return {};
+    OpenLinks open;
+    open.fold();
+    ItemEntry item{0, 0, 0};
+    readAt(open.byItem, itemOffset(changeItemId), item);
+    return open.chain(item.latestPlusOne, true);
+}
+
+/**********************************************
+ * Function: requestsByRequester
+ * Description: Walks the chain of a requester's links.
+ * Parameters:
+ * - requester: The name of the requester
+ * Returns: std::vector<LinkedRequest> - The requests the requester made, oldest first.
+ **********************************************/
+std::vector<LinkedRequest> RequestLinks::requestsByRequester(const std::string& requester) {
+    char name[30] = {};
+    strncpy(name, requester.c_str(), sizeof(name) - 1);
+    OpenLinks open;
+    open.fold();
+    int number = open.findRequester(name);
+    if (number < 0)
+        return {};
+    return open.chain(open.requesters[static_cast<size_t>(number)].latestPlusOne, false);
+}
+
+/**********************************************
+ * Function: allRequests
+ * Description: Reads the whole link file in chunks.
+ * Returns: std::vector<LinkedRequest> - Every linked request, in link file order.
+ **********************************************/
+std::vector<LinkedRequest> RequestLinks::allRequests() {
+    std::vector<LinkedRequest> requests;
+    OpenLinks open;
+    long long count = open.fold();
+    requests.reserve(static_cast<size_t>(count));
+    open.links.seekg(0);
+    std::vector<LinkRecord> chunk(static_cast<size_t>(SCAN_CHUNK_RECORDS));
+    while (open.links.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size() * sizeof(LinkRecord))) ||
+           open.links.gcount() > 0) {
+        size_t read = static_cast<size_t>(open.links.gcount()) / sizeof(LinkRecord);
+        for (size_t position = 0; position < read && static_cast<long long>(requests.size()) < count; position++)
+            requests.push_back(toLinkedRequest(chunk[position]));
+        if (read < chunk.size())
+            break;
+    }
+    open.links.clear();
+    return requests;
+}
+
+/**********************************************
+ * Function: requestCount
+ * Description: Reads the request count of a change item from the item index.
+ * Parameters:
+ * - changeItemId: The change ID of the item
+ * Returns: int - The number of requests about the item.
+ **********************************************/
+int RequestLinks::requestCount(int changeItemId) {
+    if (changeItemId < 0)
+        return 0;
+    OpenLinks open;
+    open.fold();
+    ItemEntry item{0, 0, 0};
+    readAt(open.byItem, itemOffset(changeItemId), item);
+    return item.requests;
+}
+
+/**********************************************
+ * Function: mostRequested
+ * Description:
+ * Reads the item index in one pass and keeps the change items with the most
+ * requests. Ties go to the lower change ID.
+ * Parameters:
+ * - count: The number of change items to return
+ * Returns: std::vector<std::pair<int, int>> - (change ID, requests), most requested first.
+ **********************************************/
+std::vector<std::pair<int, int>> RequestLinks::mostRequested(size_t count) {
+    std::vector<std::pair<int, int>> items;
+    {
+        OpenLinks open;
+        open.fold();
+        open.byItem.seekg(0);
+        std::vector<ItemEntry> entries(ITEM_CHUNK_ENTRIES);
+        int changeId = 0;
+        while (open.byItem.read(reinterpret_cast<char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ItemEntry))) ||
+               open.byItem.gcount() > 0) {
+            size_t read = static_cast<size_t>(open.byItem.gcount()) / sizeof(ItemEntry);
+            for (size_t position = 0; position < read; position++, changeId++)
+                if (entries[position].requests > 0)
+                    items.emplace_back(changeId, entries[position].requests);
+            if (read < entries.size())
+                break;
+        }
+    }
+
+    auto moreRequested = [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    count = std::min(count, items.size());
+    std::partial_sort(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(count), items.end(), moreRequested);
+    items.resize(count);
+    return items;
+}
+
+/**********************************************
+ * Function: printRequests
+ * Description: Prints the request ID, product, requester and change item of each request.
+ * Parameters:
+ * - requests: The requests to print
+ * Returns: int - The process exit status.
+ **********************************************/
+int RequestLinks::printRequests(const std::vector<LinkedRequest>& requests) {
+    if (requests.empty()) {
+        std::cout << "No change requests found." << std::endl;
+        return 1;
+    }
+    std::cout << std::left << std::setw(10) << "Request" << std::setw(12) << "Product" << std::setw(31) << "Requester"
+              << "ChangeItem" << std::endl;
+    for (const LinkedRequest& request : requests) {
+        std::cout << std::left << std::setw(10) << request.requestId << std::setw(12) << request.product
+                  << std::setw(31) << request.requester;
+        if (request.changeItemId >= 0)
+            std::cout << request.changeItemId;
+        else
+            std::cout << "-";
+        std::cout << std::endl;
+    }
+    std::cout << requests.size() << " change request(s)." << std::endl;
+    return 0;
+}
+
+/**********************************************
+ * Function: printMostRequested
+ * Description: Prints the most requested change items with their request counts.
+ * Parameters:
+ * - count: The number of change items to print
+ * Returns: int - The process exit status.
+ **********************************************/
+int RequestLinks::printMostRequested(size_t count) {
+    Metrics::Timer timer(Metrics::REPORT_MOST_REQUESTED);
+    return printMostRequested(mostRequested(count));
+}
+
+/**********************************************
+ * Function: printMostRequested
+ * Description: Prints change items already read by mostRequested with their request counts.
+ * Parameters:
+ * - items: (change ID, requests) pairs, most requested first
+ * Returns: int - The process exit status.
+ **********************************************/
+int RequestLinks::printMostRequested(const std::vector<std::pair<int, int>>& items) {
+    if (items.empty()) {
+        std::cout << "No change requests are linked to change items." << std::endl;
+        return 1;
+    }
+    std::cout << std::left << std::setw(12) << "ChangeItem" << "Requests" << std::endl;
+    for (const auto& [changeId, requests] : items)
+        std::cout << std::left << std::setw(12) << changeId << requests << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**********************************************
+ * RequestLinks Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added allRequests and REQUEST_LINK_SIZE.
+ * - 2026-10-19: printMostRequested also prints items already read.
+ *--------------------------------
+ * Purpose:
+ * This module records which ChangeItem each ChangeRequest is about, and indexes
+ * the requests by change item and by requester, so that "all requests for item
+ * X", "all requests by Y" and the number of requests per item are answered
+ * without a scan of the change request files.
+ *
+ * The change item a request is about travels in the request's creation event on
+ * the change feed, so the ChangeRequest record format is unchanged and writers pay
+ * nothing extra. A reader first folds the new creations into an append-only link
+ * file, one fixed-size link per request, the same way the release index is kept.
+ * Each link points back to the previous link of the same item and of the same
+ * requester, and small indexes hold the latest link and the request count of
+ * every change item and every requester, plus the link of every request. A
+ * drill-down walks one chain, so it costs time proportional to the number of
+ * requests it returns.
+ *
+ * Requests written before links were kept, or whose feed event was lost in a
+ * crash, are added unlinked (with no change item) when the change requests are
+ * initialized, so the requester index still covers every request.
+ **********************************************/
+#ifndef REQUESTLINKS_H
+#define REQUESTLINKS_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+//=============================
+// Constants
+//=============================
+const char* const REQUEST_LINK_FILE = "ChangeRequest.links";                // One link per request
+const char* const LINKS_BY_REQUEST_FILE = "ChangeRequest.lidx";             // Link of every request ID
+const char* const LINKS_BY_ITEM_FILE = "ChangeRequest.items";               // Latest link and count per change item
+const char* const LINKS_BY_REQUESTER_FILE = "ChangeRequest.requesters";     // Latest link and count per requester
+const int REQUEST_LINK_SIZE = 72;                                           // Bytes per link in REQUEST_LINK_FILE
+
+//=============================
+// Record Types
+//=============================
+
+// One request as the link file holds it.
+struct LinkedRequest {
+    int requestId;
+    int changeItemId;       // -1 if the request is not linked to a change item
+    std::string requester;
+    std::string product;
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class RequestLinks {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool init();
+    // Description: Folds in new feed events and adds unlinked entries for requests that have
+    //              no link yet. Called when the change requests are initialized.
+    // Returns: bool - False if the link files could not be written.
+
+    //----------------------------------------------------------
+    static int changeItemOf(int requestId);
+    // Description: Returns the change item a request is about, or -1 if it has none.
+
+    //----------------------------------------------------------
+    static std::vector<LinkedRequest> requestsForItem(int changeItemId);
+    // Description: Returns the requests about a change item, oldest first.
+
+    //----------------------------------------------------------
+    static std::vector<LinkedRequest> requestsByRequester(const std::string& requester);
+    // Description: Returns the requests a requester made, oldest first.
+
+    //----------------------------------------------------------
+    static std::vector<LinkedRequest> allRequests();
+    // Description: Returns every request in the order they were linked, from one sequential read
+    //              of the link file.
+
+    //----------------------------------------------------------
+    static int requestCount(int changeItemId);
+    // Description: Returns the number of requests about a change item without reading them.
+
+    //----------------------------------------------------------
+    static std::vector<std::pair<int, int>> mostRequested(size_t count);
+    // Description: Returns up to count change items with the most requests, as (change ID,
+    //              requests), most requested first. Reads only the per-item counts.
+
+    //----------------------------------------------------------
+    static int printRequests(const std::vector<LinkedRequest>& requests);
+    // Description: Prints one line per request.
+    // Returns: int - The process exit status.
+
+    //----------------------------------------------------------
+    static int printMostRequested(size_t count);
+    static int printMostRequested(const std::vector<std::pair<int, int>>& items);
+    // Description: Prints the most requested change items (items, as returned by mostRequested)
+    //              with their request counts.
+    // Returns: int - The process exit status.
+};
+
+#endif // REQUESTLINKS_H
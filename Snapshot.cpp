@@ -0,0 +1,270 @@
+/**********************************************
+ * Snapshot Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: preserve also takes a batch of records, written to the log at once.
+ * - 2026-10-19: Snapshots bring item segments in an older record version up to date first.
+ * - 2026-10-19: Snapshots record the archive lengths too, under an archive read scope.
+ *--------------------------------
+ * Purpose:
+ * This module implements snapshot reads of change items over the version log.
+ * The log starts with the sequence number of its first entry, followed by fixed
+ * size entries of a sequence number and the record as it was before an update.
+ * A snapshot started at sequence s needs exactly the entries from s on: the first
+ * of them for a change ID is that record's state at the start of the snapshot.
+ *
+ * Three sentinel locks on ChangeItem.txt tie it together. Writers hold the commit
+ * lock shared while they write, and a snapshot takes it exclusively for the moment
+ * it records its starting point. Each open snapshot holds a shared lock on the pin
+ * byte of its starting sequence, which lets writers skip the log when no snapshot
+ * is open and lets the reclaimer find the oldest entry still needed.
+ **********************************************/
+#include "Snapshot.h"
+#include "FileFormat.h"
+#include "StorageLayout.h"
+
+#include <filesystem>
+#include <iostream>
+
+//================================
+// Constants
+//================================
+static const char* UNDO_FILE = "ChangeItem.undo";
+static const long long PIN_LOCK_LENGTH = APPEND_LOCK_OFFSET - PIN_LOCK_OFFSET;
+static const long long RECLAIM_MIN_ENTRIES = 1024;   // Smallest unneeded prefix worth rewriting the log for
+
+// One old record in the version log
+struct UndoEntry {
+    long long sequence;
+    ChangeItem before;
+};
+
+static const long long HEADER_SIZE = sizeof(long long);
+static const long long ENTRY_SIZE = sizeof(UndoEntry);
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: readLog
+ * Description: Reads the first and the next free sequence number of the version log.
+ * Parameters:
+ * - base: Receives the sequence number of the first entry
+ * - end: Receives the sequence number the next entry will get
+ **********************************************/
+static void readLog(long long& base, long long& end) {
+    base = 0;
+    end = 0;
+    std::ifstream log(UNDO_FILE, std::ios::binary);
+    if (!log.read(reinterpret_cast<char*>(&base), HEADER_SIZE)) {
+        base = 0;
+        return;
+    }
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(UNDO_FILE, error);
+    end = base + (error ? 0 : static_cast<long long>((size - HEADER_SIZE) / ENTRY_SIZE));
+}
+
+/**********************************************
+ * Function: writeHeader
+ * Description: Replaces the version log with an empty one starting at base.
+ * Parameters:
+ * - path: The file to write
+ * - base: The sequence number of the first entry
+ * Returns: std::ofstream - The open log, positioned after the header
+ **********************************************/
+static std::ofstream writeHeader(const char* path, long long base) {
+    std::ofstream log(path, std::ios::binary | std::ios::trunc);
+    log.write(reinterpret_cast<const char*>(&base), HEADER_SIZE);
+    return log;
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Constructor: Snapshot
+ * Description:
+ * Brings item files in an older record version up to date, holds the archives
+ * still, records the version log position and the file lengths while no write is
+ * in progress, then pins the starting sequence so the entries it needs are kept.
+ * A file that cannot be upgraded is left out.
+ **********************************************/
+Snapshot::Snapshot() : sequence(0), loadedThrough(0) {
+    // Before any lock: the version log holds current records, so the files are read in that version
+    for (const std::string& segment : StorageLayout::itemFiles())
+        FileFormat::ensureCurrent(segment);
+    // Listed again once no item can move, since archiving may have created an archive meanwhile
+    archiveScope.emplace();
+    std::vector<std::string> readable;
+    for (const std::string& segment : StorageLayout::itemFiles()) {
+        if (FileFormat::layout(segment).current)
+            readable.push_back(segment);
+    }
+
+    RecordLock commitLock(ITEM_FILE, COMMIT_LOCK_OFFSET, 1, true);
+    long long base;
+    readLog(base, sequence);
+    loadedThrough = sequence;
+    for (const std::string& segment : readable) {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(segment, error);
+        if (!error)
+            lengths[segment] = static_cast<long long>(size - size % sizeof(ChangeItem));
+    }
+    pin.emplace(ITEM_FILE, PIN_LOCK_OFFSET + sequence, 1, false);
+}
+
+/**********************************************
+ * Destructor: ~Snapshot
+ * Description: Unpins the snapshot and reclaims entries no open snapshot needs.
+ **********************************************/
+Snapshot::~Snapshot() {
+    pin.reset();
+    reclaim();
+}
+
+/**********************************************
+ * Function: apply
+ * Description: Replaces records updated since the start with their old versions.
+ * Parameters:
+ * - records: The records just read
+ * - count: The number of valid records
+ **********************************************/
+void Snapshot::apply(std::vector<ChangeItem>& records, size_t count) {
+    refresh();
+    if (preImages.empty())
+        return;
+    for (size_t i = 0; i < count; i++) {
+        auto preImage = preImages.find(records[i].getChangeId());
+        if (preImage != preImages.end())
+            records[i] = preImage->second;
+    }
+}
+
+/**********************************************
+ * Function: refresh
+ * Description:
+ * Reads the version log entries appended since the last refresh. Only the first
+ * entry for a change ID is kept, since later ones describe versions that were
+ * themselves written after the snapshot started.
+ **********************************************/
+void Snapshot::refresh() {
+    std::ifstream log(UNDO_FILE, std::ios::binary);
+    long long base;
+    if (!log.read(reinterpret_cast<char*>(&base), HEADER_SIZE))
+        return;
+
+    long long start = std::max(loadedThrough, base);
+    log.seekg(HEADER_SIZE + (start - base) * ENTRY_SIZE);
+    UndoEntry entry;
+    while (log.read(reinterpret_cast<char*>(&entry), ENTRY_SIZE)) {
+        if (entry.sequence >= sequence)
+            preImages.emplace(entry.before.getChangeId(), entry.before);
+        loadedThrough = entry.sequence + 1;
+    }
+}
+
+/**********************************************
+ * Function: preserve
+ * Description: Keeps one record about to be overwritten for open snapshots.
+ * Parameters:
+ * - before: The record as it is on disk before the write
+ **********************************************/
+void Snapshot::preserve(const ChangeItem& before) {
+    preserve(std::span<const ChangeItem>(&before, 1));
+}
+
+/**********************************************
+ * Function: preserve
+ * Description:
+ * Appends the records about to be overwritten to the version log in one write,
+ * unless no snapshot is open. The caller holds a WriteScope, so no snapshot can
+ * start until the overwrite is finished.
+ * Parameters:
+ * - before: The records as they are on disk before the write
+ **********************************************/
+void Snapshot::preserve(std::span<const ChangeItem> before) {
+    if (before.empty() || RecordLock::firstLockedByte(ITEM_FILE, PIN_LOCK_OFFSET, PIN_LOCK_LENGTH) < 0)
+        return;
+
+    RecordLock undoLock(ITEM_FILE, UNDO_LOCK_OFFSET, 1, true);
+    long long base, end;
+    readLog(base, end);
+
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(UNDO_FILE, error);
+    if (error || size < static_cast<uintmax_t>(HEADER_SIZE)) {
+        writeHeader(UNDO_FILE, base).close();
+    } else if ((size - HEADER_SIZE) % ENTRY_SIZE != 0) {
+        std::filesystem::resize_file(UNDO_FILE, HEADER_SIZE + (end - base) * ENTRY_SIZE, error);
+    }
+
+    std::vector<UndoEntry> entries(before.size());
+    for (size_t i = 0; i < before.size(); i++) {
+        entries[i].sequence = end + static_cast<long long>(i);
+        entries[i].before = before[i];
+    }
+    std::ofstream log(UNDO_FILE, std::ios::binary | std::ios::app);
+    if (!log.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * ENTRY_SIZE)))
+        std::cerr << "Failed to keep the old version of ChangeItem " << before.front().getChangeId() << "." << std::endl;
+    log.close(); // On disk before the records are overwritten
+}
+
+/**********************************************
+ * Function: reclaim
+ * Description:
+ * Drops version log entries older than every open snapshot. If no snapshot is open
+ * the log is simply emptied; otherwise the needed tail is copied to a new log,
+ * which is only worth it once a large prefix has become unneeded. Runs with the
+ * commit lock held, so no writer appends and no snapshot starts meanwhile.
+ **********************************************/
+void Snapshot::reclaim() {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(UNDO_FILE, error);
+    if (error || size <= static_cast<uintmax_t>(HEADER_SIZE))
+        return;
+
+    RecordLock commitLock(ITEM_FILE, COMMIT_LOCK_OFFSET, 1, true);
+    long long base, end;
+    readLog(base, end);
+    long long oldestPin = RecordLock::firstLockedByte(ITEM_FILE, PIN_LOCK_OFFSET, PIN_LOCK_LENGTH);
+    if (oldestPin < 0) {
+        writeHeader(UNDO_FILE, end).close();
+        return;
+    }
+
+    long long oldest = oldestPin - PIN_LOCK_OFFSET;
+    if (oldest - base < RECLAIM_MIN_ENTRIES)
+        return;
+
+    std::string temporary = std::string(UNDO_FILE) + ".tmp";
+    std::ifstream log(UNDO_FILE, std::ios::binary);
+    log.seekg(HEADER_SIZE + (oldest - base) * ENTRY_SIZE);
+    std::ofstream kept = writeHeader(temporary.c_str(), oldest);
+    kept << log.rdbuf();
+    kept.close();
+    if (kept.fail()) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+    std::filesystem::rename(temporary, UNDO_FILE, error);
+}
+
+/**********************************************
+ * Function: versionLogEntries
+ * Description: Returns the number of old records kept in the version log.
+ **********************************************/
+long long Snapshot::versionLogEntries() {
+    long long base, end;
+    readLog(base, end);
+    return end - base;
+}
+
+/**********************************************
+ * Constructor: WriteScope
+ * Description: Holds the commit lock shared for the lifetime of the write.
+ **********************************************/
+Snapshot::WriteScope::WriteScope() : commitLock(ITEM_FILE, COMMIT_LOCK_OFFSET, 1, false) {}
@@ -0,0 +1,163 @@
+/**********************************************
+ * Snapshot Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: preserve also takes a batch of records.
+ * - 2026-10-19: Scans skip records that fail their checksums.
+ * - 2026-10-19: Snapshots cover the archives and hold them still.
+ * - 2026-10-19: Archives are scanned block by block.
+ *--------------------------------
+ * Purpose:
+ * This module gives readers of change items a consistent view of the data while
+ * writers keep updating records in place. A Snapshot remembers the length of
+ * every segment and the position of the version log when it starts. A writer that
+ * is about to overwrite a record while any snapshot is open first appends the old
+ * record to the version log, ChangeItem.undo; readers put those old records back
+ * in place of anything changed after their start. Readers never lock records, so
+ * writers never wait for a scan, and old records are dropped from the log once no
+ * open snapshot can need them.
+ *
+ * Open snapshots are tracked with byte-range locks on ChangeItem.txt, so they are
+ * seen by every process. Platforms without byte-range locks get plain reads.
+ * A snapshot covers the archives too, and no item is archived or restored while
+ * one is open, so an archive is read straight from its blocks.
+ **********************************************/
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BlockFile.h"
+#include "ChangeItem.h"
+#include "FileLock.h"
+#include "ItemArchive.h"
+#include "RecordChecksum.h"
+#include "StorageLayout.h"
+
+//=============================
+// Constants
+//=============================
+const long long COMMIT_LOCK_OFFSET = 0x7FFFFFFF00000002LL;   // Shared by writers, exclusive while a snapshot starts
+const long long UNDO_LOCK_OFFSET = 0x7FFFFFFF00000003LL;     // Serializes appends to the version log
+const long long PIN_LOCK_OFFSET = 0x4000000000000000LL;      // Snapshot starting at sequence s holds this byte + s
+const int SCAN_CHUNK_RECORDS = 1024;                         // Records read between version log refreshes
+
+//=============================
+// Class Declaration
+//=============================
+
+class Snapshot {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    Snapshot();
+    // Description: Opens a snapshot of the change items as they are now, archived ones
+    //              included. Waits only for writes already in progress and for a move of
+    //              items into or out of the archives, never for other readers.
+
+    //----------------------------------------------------------
+    ~Snapshot();
+    // Description: Closes the snapshot and reclaims old records no open snapshot needs.
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    template <typename Visit>
+    void scan(const std::string& segment, Visit visit);
+    // Description: Calls visit with every ChangeItem of the segment as it was when the
+    //              snapshot started, in file order. Records added later are skipped.
+    //              A Snapshot is used by one thread at a time.
+
+    //----------------------------------------------------------
+    static void preserve(const ChangeItem& before);
+    static void preserve(std::span<const ChangeItem> before);
+    // Description: Called by a writer holding a WriteScope, right before it overwrites a
+    //              record (or several): keeps the old records for open snapshots. Does
+    //              nothing if no snapshot is open.
+
+    //----------------------------------------------------------
+    static long long versionLogEntries();
+    // Description: Returns the number of old records currently kept in the version log.
+
+    // Held by a writer while it appends or overwrites a change item, so that a
+    // snapshot never starts in the middle of a write.
+    class WriteScope {
+    public:
+        WriteScope();
+    private:
+        RecordLock commitLock;
+    };
+
+private:
+    void refresh();
+    void apply(std::vector<ChangeItem>& records, size_t count);
+    static void reclaim();
+
+    long long sequence;                                  // Version log position when the snapshot started
+    long long loadedThrough;                             // Version log entries before this have been read
+    std::map<std::string, long long> lengths;            // Segment lengths when the snapshot started
+    std::unordered_map<int, ChangeItem> preImages;       // Records as they were at the start, by change ID
+    std::optional<ItemArchive::ReadScope> archiveScope; // Taken before the commit lock, as writers do
+    std::optional<RecordLock> pin;
+};
+
+//=============================
+// Template Implementations
+//=============================
+template <typename Visit>
+void Snapshot::scan(const std::string& segment, Visit visit) {
+    auto length = lengths.find(segment);
+    if (length == lengths.end())
+        return;
+    if (StorageLayout::isArchive(segment)) {
+        // Held still by the archive scope, so there is nothing to put back
+        BlockReader reader(segment);
+        if (reader.recordSize() == sizeof(ChangeItem)) {
+            reader.scan([&](const char* records, size_t count) {
+                const ChangeItem* changeItems = reinterpret_cast<const ChangeItem*>(records);
+                for (size_t i = 0; i < count; i++)
+                    visit(changeItems[i]);
+            });
+        }
+        return;
+    }
+
+    std::ifstream infile(segment, std::ios::binary);
+    ChecksumReader checksums(segment, sizeof(ChangeItem));
+    std::vector<ChangeItem> records(SCAN_CHUNK_RECORDS);
+    std::vector<char> damaged(SCAN_CHUNK_RECORDS);
+    long long position = 0;
+    long long remaining = length->second / static_cast<long long>(sizeof(ChangeItem));
+    while (remaining > 0) {
+        size_t count = static_cast<size_t>(std::min<long long>(remaining, SCAN_CHUNK_RECORDS));
+        if (!infile.read(reinterpret_cast<char*>(records.data()), count * sizeof(ChangeItem)))
+            break;
+        remaining -= count;
+        // Verified before old records are put back, since those come from the version log
+        for (size_t i = 0; i < count; i++, position += sizeof(ChangeItem))
+            damaged[i] = !checksums.check(position, &records[i]);
+        // Old records are looked up only after the chunk is read, so any record a writer
+        // touched while it was being read is already in the version log
+        apply(records, count);
+        for (size_t i = 0; i < count; i++) {
+            if (!damaged[i])
+                visit(records[i]);
+        }
+    }
+}
+
+#endif // SNAPSHOT_H
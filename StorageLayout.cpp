@@ -0,0 +1,435 @@
+/**********************************************
+ * StorageLayout Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added upgradeRecordFormat, which drops the padding of ChangeRequest records.
+ * - 2026-10-19: Migration backs up the checksum files with the single files.
+ * - 2026-10-19: upgradeRecordFormat stamps file headers instead of rewriting; added dataFiles.
+ * - 2026-10-19: Added the archives of the item files; migration splits the archive with the single file.
+ * - 2026-10-19: Migration splits the archive through ItemArchive::partition.
+ *--------------------------------
+ * Purpose:
+ * This module implements the routing of products to segment files, the parallel
+ * segment scan, and the migration from the single-file layout. The layout is
+ * looked up on every call instead of being cached, so a process notices a
+ * migration without restarting.
+ **********************************************/
+#include "StorageLayout.h"
+#include "ChangeItem.h"
+#include "ChangeRequest.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "ItemArchive.h"
+#include "RecordChecksum.h"
+
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+//================================
+// Constants
+//================================
+static const char* MIGRATION_DIRECTORY = "partitions.tmp";   // Built here, then renamed into place
+static const char* BACKUP_SUFFIX = ".premigration";
+static const char* FORMAT_BACKUP_SUFFIX = ".format1";          // Left by a format 2 rewrite cut short
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: listSegments
+ * Description: Returns the segments of one entity in a directory.
+ * Parameters:
+ * - directory: The partition directory, or an archive directory
+ * - entity: The file name prefix of the entity
+ * Returns: The segment paths in name order
+ **********************************************/
+static std::vector<std::string> listSegments(const std::string& directory, const char* entity) {
+    std::vector<std::string> segments;
+    std::string prefix = std::string(entity) + "-";
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        bool segment = name.size() > prefix.size() + 4 && name.compare(0, prefix.size(), prefix) == 0 &&
+                       name.compare(name.size() - 4, 4, ".txt") == 0; // Not a backup or a file being written
+        if (entry.is_regular_file(error) && segment)
+            segments.push_back(entry.path().string());
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+/**********************************************
+ * Function: backUp
+ * Description: Moves a migrated single file aside, together with its checksums.
+ * Parameters:
+ * - path: The single file
+ * Returns: bool - True on success
+ **********************************************/
+static bool backUp(const std::string& path) {
+    std::error_code error;
+    if (std::filesystem::exists(path, error))
+        std::filesystem::rename(path, path + BACKUP_SUFFIX, error);
+    if (error)
+        return false;
+    std::string checksums = RecordChecksum::checksumPath(path);
+    if (std::filesystem::exists(checksums, error))
+        std::filesystem::rename(checksums, checksums + BACKUP_SUFFIX, error); // Kept with the backup it describes
+    return true;
+}
+
+/**********************************************
+ * Function: backUpAndEmpty
+ * Description: Moves a migrated single file aside and leaves an empty file in its
+ *              place, which keeps serving as the lock anchor.
+ * Parameters:
+ * - path: The single file
+ * Returns: bool - True on success
+ **********************************************/
+static bool backUpAndEmpty(const char* path) {
+    if (!backUp(path))
+        return false;
+    std::ofstream anchor(path, std::ios::binary | std::ios::app);
+    return anchor.is_open();
+}
+
+/**********************************************
+ * Function: readFormatVersion
+ * Description: Reads the record format version of the data directory.
+ * Returns: int - The version, or 0 if Records.format is missing.
+ **********************************************/
+static int readFormatVersion() {
+    std::ifstream format(FORMAT_FILE);
+    int version = 0;
+    if (format >> version)
+        return version;
+    return 0;
+}
+
+/**********************************************
+ * Function: writeFormatVersion
+ * Description: Replaces Records.format with the current version in one rename.
+ * Returns: bool - True on success
+ **********************************************/
+static bool writeFormatVersion() {
+    std::string temporary = std::string(FORMAT_FILE) + ".tmp";
+    {
+        std::ofstream format(temporary, std::ios::trunc);
+        format << RECORD_FORMAT_VERSION << std::endl;
+        format.close();
+        if (format.fail())
+            return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, FORMAT_FILE, error);
+    return !error;
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: isPartitioned
+ * Description: Checks for the partition directory.
+ * Returns: bool - True if the data directory uses per-product segments.
+ **********************************************/
+bool StorageLayout::isPartitioned() {
+    std::error_code error;
+    return std::filesystem::is_directory(PARTITION_DIRECTORY, error);
+}
+
+/**********************************************
+ * Function: itemPath / requestPath
+ * Description: Returns the file holding the change items (requests) of one product.
+ * Parameters:
+ * - product: The product name
+ **********************************************/
+std::string StorageLayout::itemPath(const std::string& product) {
+    return isPartitioned() ? segmentPath(PARTITION_DIRECTORY, ITEM_SEGMENT_PREFIX, product) : ITEM_FILE;
+}
+
+std::string StorageLayout::requestPath(const std::string& product) {
+    return isPartitioned() ? segmentPath(PARTITION_DIRECTORY, REQUEST_SEGMENT_PREFIX, product) : REQUEST_FILE;
+}
+
+/**********************************************
+ * Function: itemSegments / requestSegments
+ * Description: Returns every file holding change items (requests).
+ **********************************************/
+std::vector<std::string> StorageLayout::itemSegments() {
+    return isPartitioned() ? listSegments(PARTITION_DIRECTORY, ITEM_SEGMENT_PREFIX) : std::vector<std::string>{ITEM_FILE};
+}
+
+std::vector<std::string> StorageLayout::requestSegments() {
+    return isPartitioned() ? listSegments(PARTITION_DIRECTORY, REQUEST_SEGMENT_PREFIX) : std::vector<std::string>{REQUEST_FILE};
+}
+
+/**********************************************
+ * Function: archivePath
+ * Description: Returns the archive of an item file, in the archive directory next to it.
+ * Parameters:
+ * - segment: The item file
+ **********************************************/
+std::string StorageLayout::archivePath(const std::string& segment) {
+    std::filesystem::path path(segment);
+    return (path.parent_path() / ARCHIVE_DIRECTORY / path.filename()).string();
+}
+
+/**********************************************
+ * Function: archiveSegments
+ * Description: Returns the archives that exist in the current layout.
+ **********************************************/
+std::vector<std::string> StorageLayout::archiveSegments() {
+    if (isPartitioned())
+        return listSegments((std::filesystem::path(PARTITION_DIRECTORY) / ARCHIVE_DIRECTORY).string(), ITEM_SEGMENT_PREFIX);
+    std::string archive = archivePath(ITEM_FILE);
+    std::error_code error;
+    if (std::filesystem::is_regular_file(archive, error))
+        return {archive};
+    return {};
+}
+
+/**********************************************
+ * Function: isArchive
+ * Description: Returns true if the file is in an archive directory.
+ * Parameters:
+ * - path: A data file
+ **********************************************/
+bool StorageLayout::isArchive(const std::string& path) {
+    return std::filesystem::path(path).parent_path().filename() == ARCHIVE_DIRECTORY;
+}
+
+/**********************************************
+ * Function: itemFiles
+ * Description: Returns the item segments followed by the archives.
+ **********************************************/
+std::vector<std::string> StorageLayout::itemFiles() {
+    std::vector<std::string> files = itemSegments();
+    std::vector<std::string> archives = archiveSegments();
+    files.insert(files.end(), archives.begin(), archives.end());
+    return files;
+}
+
+/**********************************************
+ * Function: dataFiles
+ * Description: Lists the data files of a directory: the five single files, the
+ *              segments of a partitioned directory and the archives of either
+ *              layout, leaving out backups and files being written.
+ * Parameters:
+ * - directory: The data directory
+ * Returns: The data files that exist, relative to directory
+ **********************************************/
+std::vector<std::string> StorageLayout::dataFiles(const std::string& directory) {
+    std::vector<std::string> names = {ITEM_FILE, REQUEST_FILE, "Product.txt", "ProductRelease.txt", "req.txt"};
+    std::error_code error;
+    for (std::filesystem::path subdirectory : {std::filesystem::path(ARCHIVE_DIRECTORY), std::filesystem::path(PARTITION_DIRECTORY),
+                                               std::filesystem::path(PARTITION_DIRECTORY) / ARCHIVE_DIRECTORY}) {
+        std::vector<std::string> segments;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::path(directory) / subdirectory, error)) {
+            std::string name = entry.path().filename().string();
+            if (entry.path().extension() == ".txt" && FileFormat::kindOf(name) != RecordKind::UNKNOWN)
+                segments.push_back((subdirectory / name).string());
+        }
+        std::sort(segments.begin(), segments.end());
+        names.insert(names.end(), segments.begin(), segments.end());
+    }
+
+    std::vector<std::string> files;
+    for (const std::string& name : names) {
+        if (std::filesystem::is_regular_file(std::filesystem::path(directory) / name, error))
+            files.push_back(name);
+    }
+    return files;
+}
+
+/**********************************************
+ * Function: segmentPath
+ * Description:
+ * Builds "<directory>/<entity>-<product>.txt". Letters other than lower case, digits,
+ * '-' and '_' are written as "%XX", and upper case letters as '^' followed by the lower
+ * case letter, so every product gets a distinct and portable file name.
+ * Parameters:
+ * - directory: The partition directory
+ * - entity: The file name prefix of the entity
+ * - product: The product name
+ * Returns: The segment path
+ **********************************************/
+std::string StorageLayout::segmentPath(const std::string& directory, const char* entity, const std::string& product) {
+    std::string name = std::string(entity) + "-";
+    for (unsigned char c : product) {
+        if (std::islower(c) || std::isdigit(c) || c == '-' || c == '_') {
+            name += static_cast<char>(c);
+        } else if (std::isupper(c)) {
+            name += '^';
+            name += static_cast<char>(std::tolower(c));
+        } else {
+            char escaped[4];
+            std::snprintf(escaped, sizeof(escaped), "%%%02X", c);
+            name += escaped;
+        }
+    }
+    return (std::filesystem::path(directory) / (name + ".txt")).string();
+}
+
+/**********************************************
+ * Function: forEachSegment
+ * Description:
+ * Spreads the segments over up to one thread per core; each thread takes the next
+ * unvisited segment until none are left. A single segment is visited on the
+ * calling thread.
+ * Parameters:
+ * - segments: The files to visit
+ * - visit: Called once per segment
+ **********************************************/
+void StorageLayout::forEachSegment(const std::vector<std::string>& segments, const std::function<void(const std::string&)>& visit) {
+    if (segments.size() <= 1) {
+        for (const std::string& segment : segments)
+            visit(segment);
+        return;
+    }
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    size_t threadCount = std::min<size_t>(cores, segments.size());
+    std::atomic<size_t> nextSegment(0);
+    auto work = [&]() {
+        for (size_t i = nextSegment++; i < segments.size(); i = nextSegment++)
+            visit(segments[i]);
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; i++)
+        threads.emplace_back(work);
+    work();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+/**********************************************
+ * Function: migrateToPartitions
+ * Description:
+ * Splits both single files into segments inside a temporary directory, then renames
+ * the directory into place, which switches every process to the partitioned layout
+ * at once. Writers are shut out by locking all record bytes and the append sentinel
+ * of both files, and archiving by the archive sentinel. The archive of the single
+ * file is split into the archive directory inside the segments' directory, so it
+ * moves into place with them. Afterwards the single files are moved to
+ * *.premigration backups and replaced by empty lock anchors.
+ * Returns: bool - True if the data directory is partitioned afterwards.
+ **********************************************/
+bool StorageLayout::migrateToPartitions() {
+    if (isPartitioned()) {
+        std::cout << "The data directory is already partitioned." << std::endl;
+        return true;
+    }
+
+    // Segments are written in the current version, so the single files are brought up to it first
+    if (!FileFormat::ensureCurrent(ITEM_FILE) || !FileFormat::ensureCurrent(REQUEST_FILE)) {
+        std::cerr << "Migration failed; the single-file layout is unchanged." << std::endl;
+        return false;
+    }
+    std::string archive = archivePath(ITEM_FILE);
+    std::error_code error;
+    bool archived = std::filesystem::exists(archive, error);
+    if (archived && !FileFormat::ensureCurrent(archive)) {
+        std::cerr << "Migration failed; the single-file layout is unchanged." << std::endl;
+        return false;
+    }
+    RecordLock itemLock(ITEM_FILE, 0, APPEND_LOCK_OFFSET + 1, true);
+    RecordLock requestLock(REQUEST_FILE, 0, APPEND_LOCK_OFFSET + 1, true);
+    RecordLock archiveLock(ITEM_FILE, ARCHIVE_LOCK_OFFSET, 1, true);
+
+    std::filesystem::remove_all(MIGRATION_DIRECTORY, error);
+    if (!std::filesystem::create_directory(MIGRATION_DIRECTORY, error)) {
+        std::cerr << "Failed to create " << MIGRATION_DIRECTORY << "." << std::endl;
+        return false;
+    }
+
+    int items = ChangeItem::partitionChangeItems(MIGRATION_DIRECTORY);
+    int requests = ChangeRequest::partitionChangeRequests(MIGRATION_DIRECTORY);
+    if (archived && items >= 0) {
+        std::string archiveDirectory = (std::filesystem::path(MIGRATION_DIRECTORY) / ARCHIVE_DIRECTORY).string();
+        std::filesystem::create_directory(archiveDirectory, error);
+        int archivedItems = ItemArchive::partition(archive, archiveDirectory);
+        items = archivedItems < 0 ? -1 : items + archivedItems;
+    }
+    if (items < 0 || requests < 0) {
+        std::cerr << "Migration failed; the single-file layout is unchanged." << std::endl;
+        std::filesystem::remove_all(MIGRATION_DIRECTORY, error);
+        return false;
+    }
+
+    std::filesystem::rename(MIGRATION_DIRECTORY, PARTITION_DIRECTORY, error);
+    if (error) {
+        std::cerr << "Failed to move the segments into place: " << error.message() << std::endl;
+        return false;
+    }
+    if (!backUpAndEmpty(ITEM_FILE) || !backUpAndEmpty(REQUEST_FILE) || (archived && !backUp(archive)))
+        std::cerr << "Could not move the old files aside; they are no longer read." << std::endl;
+
+    std::cout << "Migrated " << items << " change items into " << listSegments(PARTITION_DIRECTORY, ITEM_SEGMENT_PREFIX).size()
+              << " segments and " << requests << " change requests into "
+              << listSegments(PARTITION_DIRECTORY, REQUEST_SEGMENT_PREFIX).size() << " segments." << std::endl;
+    return true;
+}
+
+/**********************************************
+ * Function: upgradeRecordFormat
+ * Description:
+ * Brings a data directory written by an older record format up to format 3, in
+ * which every data file has a header. Format 1 stored each ChangeRequest with the
+ * two bytes of padding the compiler puts after its members, and format 2 stored the
+ * packed record of its schema; neither kept headers. Every data file without a
+ * header gets one naming the record version the directory's format wrote it in,
+ * and nothing is rewritten: FileFormat reads old files as they are and upgrades
+ * each one when it is first written. The new format is recorded last, since a file
+ * without a header is dated by it. A format 2 rewrite cut short left the format 1
+ * records in a backup; they are put back first, in place.
+ * Returns: bool - False if a header or Records.format could not be written.
+ **********************************************/
+bool StorageLayout::upgradeRecordFormat() {
+    if (readFormatVersion() >= RECORD_FORMAT_VERSION)
+        return true;
+
+    RecordLock requestLock(REQUEST_FILE, 0, APPEND_LOCK_OFFSET + 1, true);
+    if (readFormatVersion() >= RECORD_FORMAT_VERSION)
+        return true; // Upgraded by another process while this one waited
+
+    for (const std::string& path : requestSegments()) {
+        std::string backup = path + FORMAT_BACKUP_SUFFIX;
+        std::error_code error;
+        if (!std::filesystem::exists(backup, error))
+            continue;
+        std::filesystem::copy_file(backup, path, std::filesystem::copy_options::overwrite_existing, error);
+        if (error) {
+            std::cerr << "Failed to restore " << path << " from " << backup << ": " << error.message() << std::endl;
+            return false;
+        }
+        RecordChecksum::truncate(path, ChangeRequest::FORMAT1_RECORD_SIZE, 0); // Recorded again by init
+        std::filesystem::remove(backup, error);
+    }
+
+    int old = 0;
+    for (const std::string& path : dataFiles(".")) {
+        RecordLayout layout = FileFormat::layout(path);
+        if (!layout.known() || layout.stamped)
+            continue;
+        if (!FileFormat::stamp(path, layout.version)) {
+            std::cerr << "Failed to write the header of " << path << "." << std::endl;
+            return false;
+        }
+        if (!layout.current)
+            old++;
+    }
+
+    if (!writeFormatVersion()) {
+        std::cerr << "Failed to record the record format version." << std::endl;
+        return false;
+    }
+    if (old > 0)
+        std::cout << old << " data files are in an older record version. They are read as they are and upgraded when "
+                  << "first written, or by --upgrade-files." << std::endl;
+    return true;
+}
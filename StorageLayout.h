@@ -0,0 +1,232 @@
+/**********************************************
+ * StorageLayout Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added the ID mark file names.
+ * - 2026-10-19: findRecord matches on packed record bytes; added upgradeRecordFormat.
+ * - 2026-10-19: Added findRecords for multi-key lookups in one pass.
+ * - 2026-10-19: findRecord and findRecords skip matches that fail their checksums.
+ * - 2026-10-19: Added dataFiles; findRecord and findRecords read older record versions; format 3 adds file headers.
+ * - 2026-10-19: Added the archive directory, archivePath, archiveSegments and itemFiles.
+ * - 2026-10-19: Added isArchive.
+ *--------------------------------
+ * Purpose:
+ * This module decides which file a change item or change request lives in. In the
+ * default single-file layout every product shares ChangeItem.txt and
+ * ChangeRequest.txt. In the partitioned layout, enabled by migrating the data
+ * directory, each product has its own segment under partitions/, so product-scoped
+ * operations only touch that product's records. Operations that only know a
+ * change ID search all segments in parallel. The single files stay in place in
+ * both layouts because their sentinel bytes anchor the append and ID locks.
+ * Closed change items moved out of a file by ItemArchive live in a file of the
+ * same name in the archive directory next to it, so the partition migration
+ * carries them along.
+ **********************************************/
+#ifndef STORAGELAYOUT_H
+#define STORAGELAYOUT_H
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileFormat.h"
+#include "RecordChecksum.h"
+#include "RecordSchema.h"
+
+//=============================
+// Constants
+//=============================
+const char* const ITEM_FILE = "ChangeItem.txt";           // Single-file layout, and the lock anchor of every layout
+const char* const REQUEST_FILE = "ChangeRequest.txt";     // Single-file layout, and the lock anchor of every layout
+const char* const PARTITION_DIRECTORY = "partitions";     // Holds one segment per product once migrated
+const char* const ARCHIVE_DIRECTORY = "archive";          // Next to each item file; holds its archived closed items under the same name
+const char* const ITEM_SEGMENT_PREFIX = "ChangeItem";     // Segment names are "<prefix>-<product>.txt"
+const char* const REQUEST_SEGMENT_PREFIX = "ChangeRequest";
+const char* const ITEM_MARK_FILE = "ChangeItem.id";       // Change ID high-water marks of the IdAllocator
+const char* const REQUEST_MARK_FILE = "ChangeRequest.id";
+const char* const FORMAT_FILE = "Records.format";          // Record format version of the data directory
+const int RECORD_FORMAT_VERSION = 3;                        // 3 gave every data file a header; 1 wrote ChangeRequests with their struct padding
+
+//=============================
+// Class Declaration
+//=============================
+
+class StorageLayout {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool isPartitioned();
+    // Description: Returns true if the data directory has been migrated to per-product segments.
+
+    //----------------------------------------------------------
+    static std::string itemPath(const std::string& product);
+    static std::string requestPath(const std::string& product);
+    // Description: Returns the file holding the change items (requests) of one product.
+
+    //----------------------------------------------------------
+    static std::vector<std::string> itemSegments();
+    static std::vector<std::string> requestSegments();
+    // Description: Returns every file holding change items (requests), for global scans.
+    //              Archived change items are not in these files.
+
+    //----------------------------------------------------------
+    static std::string archivePath(const std::string& segment);
+    // Description: Returns the archive of an item file: the file of the same name in the
+    //              archive directory next to it, e.g. "partitions/archive/ChangeItem-^alpha.txt".
+
+    //----------------------------------------------------------
+    static std::vector<std::string> archiveSegments();
+    // Description: Returns the archives of the current layout that exist.
+
+    //----------------------------------------------------------
+    static bool isArchive(const std::string& path);
+    // Description: Returns true if path is an archive of either layout. Archives are block files
+    //              (see BlockFile), not arrays of records, and are read through BlockReader.
+
+    //----------------------------------------------------------
+    static std::vector<std::string> itemFiles();
+    // Description: Returns the item segments followed by the archives, for scans that must see
+    //              every change item, such as index rebuilds.
+
+    //----------------------------------------------------------
+    static std::vector<std::string> dataFiles(const std::string& directory);
+    // Description: Returns the data files in directory that exist: the five single files, the
+    //              segments of a partitioned directory and the archives, as paths relative to directory.
+
+    //----------------------------------------------------------
+    static std::string segmentPath(const std::string& directory, const char* entity, const std::string& product);
+    // Description: Builds the segment file name of a product inside directory. Characters
+    //              that are not safe in file names are escaped, and upper case letters are
+    //              marked so products differing only in case stay apart on Windows.
+
+    //----------------------------------------------------------
+    static void forEachSegment(const std::vector<std::string>& segments, const std::function<void(const std::string&)>& visit);
+    // Description: Calls visit once per segment, spreading the segments over up to one
+    //              thread per core. visit must be safe to call concurrently.
+
+    //----------------------------------------------------------
+    template <typename Record, typename Match>
+    static bool findRecord(const std::vector<std::string>& segments, Match match, Record& found, std::string& segment, long long& offset);
+    // Description: Searches the segments in parallel for the first record accepted by match.
+    //              The other searches stop as soon as one of them succeeds.
+    //              A record that matches but fails its checksum is skipped.
+    //              Segments in an older record version are read through a VersionedReader.
+    // Parameters:
+    // - segments: The files to search.
+    // - match: Returns true for the wanted record, given its packed bytes in the current
+    //          version; reads the key with Schema<Record>::read, so no record is decoded
+    //          until one matches.
+    // - found, segment, offset: Receive the record, its file and its byte offset in the file
+    //                           as stored. A segment in an older version is never written,
+    //                           so a record found in one is final.
+    // Returns: bool - True if a record was found.
+
+    //----------------------------------------------------------
+    template <typename Record, typename Key, typename KeyOf, typename Hit>
+    static size_t findRecords(const std::vector<std::string>& segments, KeyOf keyOf, const std::vector<Key>& keys, Hit hit);
+    // Description: Searches the segments in parallel for the records of many keys in one pass.
+    //              The searches stop as soon as every key has been found.
+    //              A record that fails its checksum is skipped.
+    // Parameters:
+    // - segments: The files to search.
+    // - keyOf: Returns the key of a record, given its packed bytes in the current version.
+    // - keys: The wanted keys, sorted and without repeats.
+    // - hit: Called as hit(index, bytes, segment, offset) for the first record found for
+    //        keys[index], with the bytes in the current version and the offset as stored;
+    //        calls are serialized.
+    // Returns: size_t - The number of keys found.
+
+    //----------------------------------------------------------
+    static bool upgradeRecordFormat();
+    // Description: Gives every data file written before headers were kept a header with the
+    //              record version it is in, once per data directory, and records the current
+    //              format in Records.format. Rewrites nothing: old files are read as they are
+    //              and upgraded by FileFormat when first written. Runs at startup.
+    // Returns: bool - False if a header or Records.format could not be written.
+
+    //----------------------------------------------------------
+    static bool migrateToPartitions();
+    // Description: Splits ChangeItem.txt and ChangeRequest.txt into per-product segments.
+    //              The old files are kept as *.premigration backups. Should be run while
+    //              no other tracker process is working on the data directory.
+    // Returns: bool - True if the data directory is partitioned afterwards.
+};
+
+//=============================
+// Template Implementations
+//=============================
+template <typename Record, typename Match>
+bool StorageLayout::findRecord(const std::vector<std::string>& segments, Match match, Record& found, std::string& segment, long long& offset) {
+    std::atomic<bool> done(false);
+    std::mutex resultMutex;
+    forEachSegment(segments, [&](const std::string& path) {
+        VersionedReader reader(path);
+        if (!reader.usable())
+            return;
+        std::ifstream infile(path, std::ios::binary);
+        char stored[MAX_RECORD_SIZE];
+        char converted[MAX_RECORD_SIZE];
+        std::streamsize storedSize = static_cast<std::streamsize>(reader.storedSize());
+        long long position = 0;
+        while (!done && infile.read(stored, storedSize)) {
+            // Only a match is verified, so the scan itself costs no checksum reads
+            if (match(reader.current(stored, converted)) &&
+                RecordChecksum::verify(path, reader.storedSize(), position, stored)) {
+                std::lock_guard<std::mutex> lock(resultMutex);
+                if (!done) {
+                    Schema<Record>::decode(reader.current(stored, converted), found); // verify may have read it again
+                    segment = path;
+                    offset = position;
+                    done = true;
+                }
+                return;
+            }
+            position += storedSize;
+        }
+    });
+    return done;
+}
+
+template <typename Record, typename Key, typename KeyOf, typename Hit>
+size_t StorageLayout::findRecords(const std::vector<std::string>& segments, KeyOf keyOf, const std::vector<Key>& keys, Hit hit) {
+    if (keys.empty())
+        return 0;
+    std::vector<char> seen(keys.size(), 0);
+    std::atomic<size_t> found(0);
+    std::mutex resultMutex;
+    forEachSegment(segments, [&](const std::string& path) {
+        VersionedReader reader(path);
+        if (!reader.usable())
+            return;
+        std::ifstream infile(path, std::ios::binary);
+        char stored[MAX_RECORD_SIZE];
+        char converted[MAX_RECORD_SIZE];
+        std::streamsize storedSize = static_cast<std::streamsize>(reader.storedSize());
+        long long position = 0;
+        while (found < keys.size() && infile.read(stored, storedSize)) {
+            Key recordKey = keyOf(reader.current(stored, converted));
+            auto key = std::lower_bound(keys.begin(), keys.end(), recordKey);
+            if (key != keys.end() && *key == recordKey && RecordChecksum::verify(path, reader.storedSize(), position, stored)) {
+                size_t index = static_cast<size_t>(key - keys.begin());
+                std::lock_guard<std::mutex> lock(resultMutex);
+                if (!seen[index]) {
+                    seen[index] = 1;
+                    hit(index, reader.current(stored, converted), path, position);
+                    found++;
+                }
+            }
+            position += storedSize;
+        }
+    });
+    return found;
+}
+
+#endif // STORAGELAYOUT_H
@@ -0,0 +1,225 @@
+/**********************************************
+ * TaskExecutor Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added queueDepth.
+ *--------------------------------
+ * Purpose:
+ * This module implements the coroutine executor. Worker threads pop suspended
+ * coroutines off a shared queue and resume them. The reactor thread waits in
+ * epoll_wait and queues the coroutine that registered interest in a descriptor
+ * once it becomes ready. Registrations are one-shot, so a coroutine is resumed
+ * exactly once per co_await.
+ **********************************************/
+#include "TaskExecutor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+
+/**********************************************
+ * Constructor: TaskExecutor
+ * Description: Creates the epoll instance and starts the reactor and worker threads.
+ * Parameters:
+ * - threadCount: The number of worker threads; 0 uses the hardware concurrency.
+ **********************************************/
+TaskExecutor::TaskExecutor(int threadCount) : running(false), stopping(false) {
+    if (threadCount <= 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        std::cerr << "Failed to create the executor reactor." << std::endl;
+        return;
+    }
+
+    // The wake descriptor is the only registration with a null data pointer
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    running = true;
+    reactor = std::thread(&TaskExecutor::reactorLoop, this);
+    for (int i = 0; i < threadCount; i++)
+        workers.emplace_back(&TaskExecutor::workerLoop, this);
+}
+
+/**********************************************
+ * Destructor: ~TaskExecutor
+ * Description: Stops the executor and releases the reactor descriptors.
+ **********************************************/
+TaskExecutor::~TaskExecutor() {
+    stop();
+    if (epollFd >= 0)
+        close(epollFd);
+    if (wakeFd >= 0)
+        close(wakeFd);
+}
+
+/**********************************************
+ * Function: queueDepth
+ * Description: Returns the number of coroutines queued and not yet resumed.
+ **********************************************/
+size_t TaskExecutor::queueDepth() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return readyQueue.size();
+}
+
+/**********************************************
+ * Function: post
+ * Description: Queues a suspended coroutine to be resumed by a worker thread.
+ * Parameters:
+ * - handle: The coroutine to resume
+ **********************************************/
+void TaskExecutor::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        readyQueue.push_back(handle);
+    }
+    queueReady.notify_one();
+}
+
+/**********************************************
+ * Function: watch
+ * Description:
+ * Arms a one-shot readiness notification for fd. The coroutine may be resumed on
+ * another thread before this function returns, so the frame is not touched after
+ * the registration.
+ * Parameters:
+ * - fd: The descriptor to watch
+ * - forWrite: True to wait for writability, false for readability
+ * - handle: The coroutine to resume
+ **********************************************/
+void TaskExecutor::watch(int fd, bool forWrite, std::coroutine_handle<> handle) {
+    epoll_event event{};
+    event.events = (forWrite ? EPOLLOUT : EPOLLIN) | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.ptr = handle.address();
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) < 0) {
+        if (errno != ENOENT || epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            // Resume anyway; the next read or write reports the error to the coroutine
+            post(handle);
+        }
+    }
+}
+
+/**********************************************
+ * Function: detach
+ * Description: Removes fd from the reactor. Must be called before the descriptor is closed.
+ * Parameters:
+ * - fd: The descriptor to remove
+ **********************************************/
+void TaskExecutor::detach(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+/**********************************************
+ * Function: isRunning
+ * Description: Returns true if the reactor and workers were started successfully.
+ **********************************************/
+bool TaskExecutor::isRunning() const {
+    return running;
+}
+
+/**********************************************
+ * Function: getThreadCount
+ * Description: Returns the number of worker threads.
+ **********************************************/
+int TaskExecutor::getThreadCount() const {
+    return static_cast<int>(workers.size());
+}
+
+/**********************************************
+ * Function: stop
+ * Description:
+ * Wakes the reactor and the workers and joins them. Coroutines still suspended on
+ * a descriptor are abandoned; the daemon only stops when the process is exiting.
+ **********************************************/
+void TaskExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping || !running)
+            return;
+        stopping = true;
+    }
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0)
+        std::cerr << "Failed to wake the executor reactor." << std::endl;
+    queueReady.notify_all();
+
+    if (reactor.joinable())
+        reactor.join();
+    for (std::thread& worker : workers)
+        worker.join();
+    workers.clear();
+    running = false;
+}
+
+/**********************************************
+ * Function: workerLoop
+ * Description: Resumes queued coroutines until the executor is stopped.
+ **********************************************/
+void TaskExecutor::workerLoop() {
+    for (;;) {
+        std::coroutine_handle<> handle;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !readyQueue.empty(); });
+            if (stopping)
+                return;
+            handle = readyQueue.front();
+            readyQueue.pop_front();
+        }
+        handle.resume();
+    }
+}
+
+/**********************************************
+ * Function: reactorLoop
+ * Description: Hands coroutines whose descriptor became ready to the workers.
+ **********************************************/
+void TaskExecutor::reactorLoop() {
+    epoll_event events[64];
+    for (;;) {
+        int count = epoll_wait(epollFd, events, 64, -1);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Executor reactor failed." << std::endl;
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.ptr == nullptr)
+                return;
+            post(std::coroutine_handle<>::from_address(events[i].data.ptr));
+        }
+    }
+}
+
+#else
+
+//================================
+// Unsupported platform
+//================================
+TaskExecutor::TaskExecutor(int threadCount) : epollFd(-1), wakeFd(-1), running(false), stopping(false) {
+    std::cerr << "The task executor is only supported on Linux." << std::endl;
+}
+TaskExecutor::~TaskExecutor() {}
+void TaskExecutor::post(std::coroutine_handle<> handle) {}
+void TaskExecutor::watch(int fd, bool forWrite, std::coroutine_handle<> handle) {}
+void TaskExecutor::detach(int fd) {}
+bool TaskExecutor::isRunning() const { return false; }
+int TaskExecutor::getThreadCount() const { return 0; }
+size_t TaskExecutor::queueDepth() { return 0; }
+void TaskExecutor::stop() {}
+void TaskExecutor::workerLoop() {}
+void TaskExecutor::reactorLoop() {}
+
+#endif
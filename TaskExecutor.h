@@ -0,0 +1,133 @@
+/**********************************************
+ * TaskExecutor Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added queueDepth.
+ *--------------------------------
+ * Purpose:
+ * This module provides a coroutine executor made of a fixed pool of worker threads
+ * and an epoll reactor. A coroutine waiting on a socket suspends instead of blocking
+ * a worker, so a small pool can serve many concurrent clients. Only available on
+ * Linux; other platforms get an executor that refuses to start.
+ **********************************************/
+#ifndef TASKEXECUTOR_H
+#define TASKEXECUTOR_H
+
+#include <coroutine>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//=============================
+// Class Declaration
+//=============================
+
+class TaskExecutor {
+public:
+    //=============================
+    // Coroutine Types
+    //=============================
+
+    // A fire-and-forget coroutine. It starts running immediately and its frame is
+    // destroyed when it runs to completion.
+    struct Task {
+        struct promise_type {
+            Task get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    // Awaitable that moves the awaiting coroutine onto one of the worker threads.
+    struct ScheduleAwaiter {
+        TaskExecutor* executor;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { executor->post(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // Awaitable that resumes the awaiting coroutine on a worker once the descriptor is ready.
+    struct IoAwaiter {
+        TaskExecutor* executor;
+        int fd;
+        bool forWrite;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { executor->watch(fd, forWrite, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    TaskExecutor(int threadCount);
+    // Description: Starts the reactor thread and threadCount worker threads.
+    // Parameters:
+    // - int threadCount: The number of worker threads; 0 uses the hardware concurrency.
+
+    //----------------------------------------------------------
+    ~TaskExecutor();
+    // Description: Stops and joins every thread.
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    ScheduleAwaiter schedule() { return ScheduleAwaiter{this}; }
+    // Description: co_await to continue on a worker thread.
+
+    //----------------------------------------------------------
+    IoAwaiter readable(int fd) { return IoAwaiter{this, fd, false}; }
+    // Description: co_await to continue once fd has data to read (or was closed by the peer).
+
+    //----------------------------------------------------------
+    IoAwaiter writable(int fd) { return IoAwaiter{this, fd, true}; }
+    // Description: co_await to continue once fd can accept more data.
+
+    //----------------------------------------------------------
+    void post(std::coroutine_handle<> handle);
+    // Description: Queues a suspended coroutine to be resumed by a worker thread.
+
+    //----------------------------------------------------------
+    void detach(int fd);
+    // Description: Removes fd from the reactor. Must be called before the descriptor is closed.
+
+    //----------------------------------------------------------
+    bool isRunning() const;
+    // Description: Returns true if the reactor and workers were started successfully.
+
+    //----------------------------------------------------------
+    int getThreadCount() const;
+    // Description: Returns the number of worker threads.
+
+    //----------------------------------------------------------
+    size_t queueDepth();
+    // Description: Returns the number of coroutines waiting for a worker thread.
+
+    //----------------------------------------------------------
+    void stop();
+    // Description: Stops the reactor and the workers. Coroutines still suspended are abandoned.
+
+private:
+    void watch(int fd, bool forWrite, std::coroutine_handle<> handle);
+    void workerLoop();
+    void reactorLoop();
+
+    int epollFd;
+    int wakeFd;
+    bool running;
+    bool stopping;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<std::coroutine_handle<>> readyQueue;
+    std::vector<std::thread> workers;
+    std::thread reactor;
+};
+
+#endif // TASKEXECUTOR_H
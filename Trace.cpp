@@ -0,0 +1,289 @@
+/**********************************************
+ * Trace Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module implements the spans and the ring buffer they are kept in. A
+ * finished span takes the next slot with one atomic addition and is written
+ * there under the slot's sequence number, odd while it is written and even
+ * once it is complete, so write() can copy the buffer while spans are still
+ * being recorded and skips the slots it caught half-written. The buffer is
+ * allocated once by start() and lives until the process exits.
+ **********************************************/
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+//================================
+// Record Types
+//================================
+
+// One finished span.
+struct TraceSlot {
+    std::atomic<uint64_t> sequence{0};      // 2 * index + 1 while written, 2 * index + 2 once complete
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<long long> start{0};        // Nanoseconds since the trace started
+    std::atomic<long long> duration{0};
+    std::atomic<int> thread{0};
+};
+
+// A span copied out of the buffer.
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    long long start;
+    long long duration;
+    int thread;
+};
+
+// The tracing state of one thread.
+struct TraceThread {
+    int depth = 0;              // Spans open on the thread
+    bool sampled = false;       // Whether the outermost open span is kept
+    int id = 0;
+    uint64_t random = 0;
+};
+
+//================================
+// Static Variables
+//================================
+static TraceSlot* ring = nullptr;
+static size_t ringCapacity = 0;
+static std::atomic<uint64_t> nextSlot{0};
+static std::atomic<int> nextThread{0};
+static uint64_t sampleThreshold = 0;            // A span is kept if its random number is at most this
+static double traceRate = 0;
+static std::string tracePath;
+static std::chrono::steady_clock::time_point traceStart;
+static std::mutex dumpLock;
+static thread_local TraceThread current;
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: sinceStart
+ * Description: Returns the nanoseconds since the trace started.
+ **********************************************/
+static long long sinceStart() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceStart).count();
+}
+
+/**********************************************
+ * Function: sample
+ * Description: Decides whether an outermost span is kept, with a xorshift
+ *              generator of the thread's own, seeded on its first use.
+ **********************************************/
+static bool sample() {
+    if (current.random == 0) {
+        current.id = nextThread.fetch_add(1, std::memory_order_relaxed) + 1;
+        current.random = 0x9E3779B97F4A7C15ull * static_cast<uint64_t>(current.id) ^ static_cast<uint64_t>(sinceStart());
+        if (current.random == 0)
+            current.random = 1;
+    }
+    current.random ^= current.random << 13;
+    current.random ^= current.random >> 7;
+    current.random ^= current.random << 17;
+    return current.random <= sampleThreshold;
+}
+
+/**********************************************
+ * Function: jsonString
+ * Description: Writes a string as a JSON string literal.
+ **********************************************/
+static void jsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            out << '\\' << *c;
+        else if (static_cast<unsigned char>(*c) < 0x20)
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*c) << std::dec
+                << std::setfill(' ');
+        else
+            out << *c;
+    }
+    out << '"';
+}
+
+/**********************************************
+ * Function: microseconds
+ * Description: Writes nanoseconds as the microseconds the trace format counts in.
+ **********************************************/
+static void microseconds(std::ostream& out, long long nanos) {
+    out << nanos / 1000 << '.' << std::setw(3) << std::setfill('0') << nanos % 1000 << std::setfill(' ');
+}
+
+//================================
+// Function implementations
+//================================
+
+/**********************************************
+ * Function: Span::begin
+ * Description: Enters the span, deciding whether it is kept if it is the
+ *              outermost one on its thread.
+ **********************************************/
+void Trace::Span::begin(const char* spanName, const char* spanCategory) {
+    entered = true;
+    if (current.depth++ == 0)
+        current.sampled = sample();
+    if (!current.sampled)
+        return;
+    name = spanName;
+    category = spanCategory;
+    start = sinceStart();
+}
+
+/**********************************************
+ * Function: Span::end
+ * Description: Leaves the span and, if it is kept, writes it into the next
+ *              slot of the ring buffer.
+ **********************************************/
+void Trace::Span::end() {
+    current.depth--;
+    if (start < 0)
+        return;
+    long long duration = sinceStart() - start;
+    uint64_t index = nextSlot.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot& slot = ring[index % ringCapacity];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+    slot.thread.store(current.id, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+/**********************************************
+ * Function: start
+ * Description: Allocates the ring buffer, sets the sample rate and arranges for
+ *              the trace to be written at exit. Spans still open on other threads
+ *              when tracing stops finish into the buffer, which is never freed.
+ * Parameters:
+ * - path: The file receiving the trace
+ * - sampleRate: The share of outermost spans kept, from 0 to 1
+ * - capacity: The number of spans kept
+ * Returns: bool - False if tracing was started before or an argument is out of range
+ **********************************************/
+bool Trace::start(const std::string& path, double sampleRate, size_t capacity) {
+    if (ring != nullptr) {
+        std::cerr << "Tracing was started before." << std::endl;
+        return false;
+    }
+    if (path.empty() || capacity == 0 || !(sampleRate >= 0 && sampleRate <= 1)) {
+        std::cerr << "Bad trace arguments: the sample rate must be between 0 and 1." << std::endl;
+        return false;
+    }
+    {
+        std::ofstream probe(path, std::ios::trunc);
+        if (!probe) {
+            std::cerr << "Failed to open the trace file " << path << "." << std::endl;
+            return false;
+        }
+    }
+    ring = new TraceSlot[capacity];
+    ringCapacity = capacity;
+    tracePath = path;
+    traceRate = sampleRate;
+    sampleThreshold = sampleRate >= 1 ? UINT64_MAX : static_cast<uint64_t>(sampleRate * 18446744073709551616.0);
+    traceStart = std::chrono::steady_clock::now();
+    std::atexit([] { dump(); });
+    enabled.store(true);
+    return true;
+}
+
+/**********************************************
+ * Function: dump
+ * Description: Writes the ring buffer to the trace file, replacing what an
+ *              earlier dump wrote there.
+ * Returns: bool - False if tracing is off or the file could not be written
+ **********************************************/
+bool Trace::dump() {
+    if (!enabled.load())
+        return false;
+    std::lock_guard<std::mutex> lock(dumpLock);
+    std::ofstream out(tracePath, std::ios::trunc);
+    write(out);
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write the trace file " << tracePath << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: stop
+ * Description: Writes the trace and turns tracing off, so the dump at exit does nothing.
+ **********************************************/
+void Trace::stop() {
+    dump();
+    enabled.store(false);
+}
+
+/**********************************************
+ * Function: write
+ * Description: Copies the complete slots out of the ring buffer and writes them
+ *              as complete ("X") events, oldest first, after a metadata event
+ *              naming the process. Spans still open are not included.
+ * Parameters:
+ * - out: The stream receiving the JSON object
+ **********************************************/
+void Trace::write(std::ostream& out) {
+    std::vector<TraceEvent> events;
+    uint64_t recorded = enabled.load() ? nextSlot.load(std::memory_order_acquire) : 0;
+    uint64_t first = recorded > ringCapacity ? recorded - ringCapacity : 0;
+    events.reserve(static_cast<size_t>(recorded - first));
+    for (uint64_t index = first; index < recorded; index++) {
+        TraceSlot& slot = ring[index % ringCapacity];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2)
+            continue; // Still being written, or overwritten by a later span
+        TraceEvent event{slot.name.load(std::memory_order_relaxed), slot.category.load(std::memory_order_relaxed),
+                         slot.start.load(std::memory_order_relaxed), slot.duration.load(std::memory_order_relaxed),
+                         slot.thread.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+            events.push_back(event);
+    }
+    // Outer spans finish after the spans nested in them; viewers want them first
+    std::sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.start != b.start ? a.start < b.start : a.duration > b.duration;
+    });
+
+    long long pid = static_cast<long long>(getpid());
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":0,\"args\":{\"name\":\"tracker\"}}";
+    for (const TraceEvent& event : events) {
+        out << ",\n{\"name\":";
+        jsonString(out, event.name);
+        out << ",\"cat\":";
+        jsonString(out, event.category);
+        out << ",\"ph\":\"X\",\"ts\":";
+        microseconds(out, event.start);
+        out << ",\"dur\":";
+        microseconds(out, event.duration);
+        out << ",\"pid\":" << pid << ",\"tid\":" << event.thread << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"sampleRate\":" << traceRate << ",\"spansRecorded\":"
+        << recorded << ",\"spansWritten\":" << events.size() << "}}\n";
+}
@@ -0,0 +1,624 @@
+/**********************************************
+ * TrackerClient Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added readFeed.
+ * - 2026-10-19: Added replicaStatus and promote.
+ * - 2026-10-19: Added getItems.
+ * - 2026-10-19: Added takeWork, renewLease and finishLease.
+ * - 2026-10-19: The daemon benchmark creates its products and their release before seeding items.
+ *--------------------------------
+ * Purpose:
+ * This module implements the blocking daemon client and the daemon benchmark.
+ * The benchmark runs against a scratch data directory so it never touches the
+ * operator's files.
+ **********************************************/
+#include "TrackerClient.h"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+
+#include "TrackerDaemon.h"
+#include "ChangeItem.h"
+#include "ChangeRequest.h"
+#include "ProductRelease.h"
+#include "Product.h"
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Constructor: TrackerClient
+ * Description: Creates a client that is not connected yet.
+ **********************************************/
+TrackerClient::TrackerClient() : fd(-1) {}
+
+/**********************************************
+ * Destructor: ~TrackerClient
+ * Description: Closes the connection if it is open.
+ **********************************************/
+TrackerClient::~TrackerClient() {
+    disconnect();
+}
+
+/**********************************************
+ * Function: connectTo
+ * Description: Connects to the daemon listening on socketPath.
+ * Parameters:
+ * - socketPath: The filesystem path of the daemon socket
+ * Returns: bool - True if the connection was established.
+ **********************************************/
+bool TrackerClient::connectTo(const char* socketPath) {
+    disconnect();
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, socketPath);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+/**********************************************
+ * Function: disconnect
+ * Description: Closes the connection.
+ **********************************************/
+void TrackerClient::disconnect() {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+/**********************************************
+ * Function: call
+ * Description: Sends one request frame and reads the matching response body.
+ * Parameters:
+ * - request: The request body
+ * - response: Receives the response body after the status byte
+ * Returns: int - The Status of the response.
+ **********************************************/
+int TrackerClient::call(const WireWriter& request, std::string& response) {
+    if (fd < 0)
+        return STATUS_ERROR;
+
+    std::string frame = request.frame();
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = send(fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return STATUS_ERROR;
+        sent += static_cast<size_t>(n);
+    }
+
+    char header[4];
+    size_t received = 0;
+    while (received < 4) {
+        ssize_t n = recv(fd, header + received, 4 - received, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return STATUS_ERROR;
+        received += static_cast<size_t>(n);
+    }
+    WireReader lengthReader(header, 4);
+    uint32_t length = lengthReader.u32();
+    if (length == 0 || length > MAX_FRAME_LENGTH)
+        return STATUS_ERROR;
+
+    response.resize(length);
+    received = 0;
+    while (received < length) {
+        ssize_t n = recv(fd, &response[received], length - received, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return STATUS_ERROR;
+        received += static_cast<size_t>(n);
+    }
+    int status = static_cast<uint8_t>(response[0]);
+    response.erase(0, 1);
+    return status;
+}
+
+/**********************************************
+ * Function: ping
+ * Description: Round-trips an empty request.
+ **********************************************/
+int TrackerClient::ping() {
+    WireWriter request;
+    request.u8(OP_PING);
+    std::string response;
+    return call(request, response);
+}
+
+/**********************************************
+ * Function: createItem
+ * Description: Creates a ChangeItem; the changeId field of item is ignored.
+ * Parameters:
+ * - item: The item to create
+ * - changeId: Receives the ID the daemon assigned
+ **********************************************/
+int TrackerClient::createItem(const ItemRecord& item, int32_t& changeId) {
+    WireWriter request;
+    request.u8(OP_CREATE_ITEM);
+    request.str(item.product);
+    request.str(item.description);
+    request.u8(item.state);
+    request.u8(item.priority);
+    request.str(item.date);
+    request.str(item.releaseId);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        changeId = reader.i32();
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: getItem
+ * Description: Retrieves a ChangeItem by its change ID.
+ **********************************************/
+int TrackerClient::getItem(int32_t changeId, ItemRecord& item) {
+    WireWriter request;
+    request.u8(OP_GET_ITEM);
+    request.i32(changeId);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        item = reader.item();
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: getItems
+ * Description: Retrieves many ChangeItems in one round trip; items[i] is empty if
+ *              changeIds[i] does not exist.
+ **********************************************/
+int TrackerClient::getItems(const std::vector<int32_t>& changeIds, std::vector<std::optional<ItemRecord>>& items) {
+    WireWriter request;
+    request.u8(OP_GET_ITEMS);
+    request.u32(static_cast<uint32_t>(changeIds.size()));
+    for (int32_t changeId : changeIds)
+        request.i32(changeId);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        uint32_t count = reader.u32();
+        items.clear();
+        for (uint32_t i = 0; i < count && reader.ok; i++) {
+            if (reader.u8() != 0)
+                items.push_back(reader.item());
+            else
+                items.emplace_back();
+        }
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: updateState
+ * Description: Changes the state of a ChangeItem.
+ **********************************************/
+int TrackerClient::updateState(int32_t changeId, uint8_t state) {
+    WireWriter request;
+    request.u8(OP_UPDATE_STATE);
+    request.i32(changeId);
+    request.u8(state);
+    std::string response;
+    return call(request, response);
+}
+
+/**********************************************
+ * Function: updatePriority
+ * Description: Changes the priority of a ChangeItem.
+ **********************************************/
+int TrackerClient::updatePriority(int32_t changeId, uint8_t priority) {
+    WireWriter request;
+    request.u8(OP_UPDATE_PRIORITY);
+    request.i32(changeId);
+    request.u8(priority);
+    std::string response;
+    return call(request, response);
+}
+
+/**********************************************
+ * Function: listItems
+ * Description: Retrieves every ChangeItem of a product.
+ **********************************************/
+int TrackerClient::listItems(const std::string& product, std::vector<ItemRecord>& items) {
+    WireWriter request;
+    request.u8(OP_LIST_ITEMS);
+    request.str(product);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        uint32_t count = reader.u32();
+        items.clear();
+        for (uint32_t i = 0; i < count && reader.ok; i++)
+            items.push_back(reader.item());
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: report
+ * Description: Retrieves the number of ChangeItems of a product in each state.
+ **********************************************/
+int TrackerClient::report(const std::string& product, uint32_t counts[4]) {
+    WireWriter request;
+    request.u8(OP_REPORT);
+    request.str(product);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        for (int i = 0; i < 4; i++)
+            counts[i] = reader.u32();
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: createRequest
+ * Description: Creates a ChangeRequest.
+ **********************************************/
+int TrackerClient::createRequest(const std::string& requester, const std::string& product, const std::string& date, int32_t& changeId) {
+    WireWriter request;
+    request.u8(OP_CREATE_REQUEST);
+    request.str(requester);
+    request.str(product);
+    request.str(date);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        changeId = reader.i32();
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: createRelease
+ * Description: Creates a ProductRelease.
+ **********************************************/
+int TrackerClient::createRelease(const std::string& product, const std::string& releaseId, const std::string& date) {
+    WireWriter request;
+    request.u8(OP_CREATE_RELEASE);
+    request.str(product);
+    request.str(releaseId);
+    request.str(date);
+    std::string response;
+    return call(request, response);
+}
+
+/**********************************************
+ * Function: readFeed
+ * Description: Retrieves change feed events from fromSequence on that match the
+ *              filter; the daemon applies the filter before sending anything.
+ **********************************************/
+int TrackerClient::readFeed(uint64_t fromSequence, uint8_t entity, const std::string& product, uint8_t state, uint32_t maxEvents,
+                            std::vector<FeedRecord>& events, uint64_t& nextSequence) {
+    WireWriter request;
+    request.u8(OP_READ_FEED);
+    request.u64(fromSequence);
+    request.u8(entity);
+    request.str(product);
+    request.u8(state);
+    request.u32(maxEvents);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        nextSequence = reader.u64();
+        uint32_t count = reader.u32();
+        events.clear();
+        for (uint32_t i = 0; i < count && reader.ok; i++)
+            events.push_back(reader.feedEvent());
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: replicaStatus
+ * Description: Retrieves the daemon's replication role, position and lag.
+ **********************************************/
+int TrackerClient::replicaStatus(uint8_t& role, uint64_t& applied, uint64_t& primaryEnd, uint64_t& lagMs) {
+    WireWriter request;
+    request.u8(OP_REPLICA_STATUS);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        role = reader.u8();
+        applied = reader.u64();
+        primaryEnd = reader.u64();
+        lagMs = reader.u64();
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: promote
+ * Description: Asks a follower daemon to stop following and accept writes.
+ **********************************************/
+int TrackerClient::promote() {
+    WireWriter request;
+    request.u8(OP_PROMOTE);
+    std::string response;
+    return call(request, response);
+}
+
+/**********************************************
+ * Function: takeWork
+ * Description: Leases the best waiting ChangeItem of a product, or of any product
+ *              if product is empty; STATUS_NOT_FOUND if none is waiting.
+ **********************************************/
+int TrackerClient::takeWork(const std::string& product, const std::string& holder, uint32_t seconds, uint32_t& version,
+                            uint64_t& expires, ItemRecord& item) {
+    WireWriter request;
+    request.u8(OP_TAKE_WORK);
+    request.str(product);
+    request.str(holder);
+    request.u32(seconds);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        version = reader.u32();
+        expires = reader.u64();
+        item = reader.item();
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: renewLease
+ * Description: Makes a lease last another seconds; STATUS_CONFLICT if it was lost.
+ **********************************************/
+int TrackerClient::renewLease(int32_t changeId, uint32_t version, uint32_t seconds, uint64_t& expires) {
+    WireWriter request;
+    request.u8(OP_RENEW_LEASE);
+    request.i32(changeId);
+    request.u32(version);
+    request.u32(seconds);
+    std::string response;
+    int status = call(request, response);
+    if (status == STATUS_OK) {
+        WireReader reader(response.data(), response.size());
+        expires = reader.u64();
+    }
+    return status;
+}
+
+/**********************************************
+ * Function: finishLease
+ * Description: Ends a lease and sets the ChangeItem's state.
+ **********************************************/
+int TrackerClient::finishLease(int32_t changeId, uint32_t version, uint8_t state) {
+    WireWriter request;
+    request.u8(OP_FINISH_LEASE);
+    request.i32(changeId);
+    request.u32(version);
+    request.u8(state);
+    std::string response;
+    return call(request, response);
+}
+
+//================================
+// Benchmark
+//================================
+
+const int BENCH_PRODUCTS = 5;         // Products the seeded items are spread over
+const int BENCH_SEED_ITEMS = 500;     // Items created before the first measurement
+const int BENCH_SECONDS = 2;          // Measurement time per client count
+
+/**********************************************
+ * Function: runClient
+ * Description:
+ * Issues a mixed workload until the deadline: 60% lookups, 20% state updates,
+ * 5% priority updates, 10% reports and 5% creates. Latencies are appended in
+ * nanoseconds.
+ **********************************************/
+static void runClient(const std::string& socketPath, int seed, std::atomic<int>& knownItems,
+                      std::chrono::steady_clock::time_point deadline, std::vector<long long>& latencies, long long& failures) {
+    TrackerClient client;
+    if (!client.connectTo(socketPath.c_str())) {
+        failures++;
+        return;
+    }
+    std::mt19937 random(seed);
+    ItemRecord item;
+    item.description = "Benchmark item";
+    item.date = "2026-10-19";
+    item.releaseId = "1.0.0.0";
+    item.priority = 3;
+
+    while (std::chrono::steady_clock::now() < deadline) {
+        int roll = static_cast<int>(random() % 100);
+        int32_t changeId = static_cast<int32_t>(random() % static_cast<unsigned>(knownItems.load()));
+        std::string product = "Prod" + std::to_string(random() % BENCH_PRODUCTS);
+        int status;
+
+        auto start = std::chrono::steady_clock::now();
+        if (roll < 60) {
+            ItemRecord found;
+            status = client.getItem(changeId, found);
+        } else if (roll < 80) {
+            status = client.updateState(changeId, static_cast<uint8_t>(random() % 4));
+        } else if (roll < 85) {
+            status = client.updatePriority(changeId, static_cast<uint8_t>(1 + random() % 5));
+        } else if (roll < 95) {
+            uint32_t counts[4];
+            status = client.report(product, counts);
+        } else {
+            item.product = product;
+            int32_t newId;
+            status = client.createItem(item, newId);
+            if (status == STATUS_OK)
+                knownItems++;
+        }
+        auto finish = std::chrono::steady_clock::now();
+
+        if (status == STATUS_OK)
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+        else
+            failures++;
+    }
+}
+
+/**********************************************
+ * Function: benchmarkDaemon
+ * Description:
+ * Starts a daemon on a scratch data directory, seeds it with items and measures
+ * throughput and p50/p99 latency of the mixed workload at 1, 2, 4, ... maxClients
+ * concurrent clients, each with its own connection.
+ * Parameters:
+ * - maxClients: The largest number of concurrent clients to measure
+ * Returns: int - The process exit status.
+ **********************************************/
+int TrackerClient::benchmarkDaemon(int maxClients) {
+    char directory[] = "/tmp/tracker-bench-XXXXXX";
+    if (mkdtemp(directory) == nullptr || chdir(directory) < 0) {
+        std::cerr << "Failed to create the benchmark directory." << std::endl;
+        return 1;
+    }
+    std::string socketPath = std::string(directory) + "/" + DEFAULT_SOCKET_PATH;
+
+    ChangeItem::initChangeItem();
+    ChangeRequest::initChangeRequest();
+    ProductRelease::initProductRelease();
+    Product::initProduct();
+    for (int i = 0; i < BENCH_PRODUCTS; i++)
+        Product product(("Prod" + std::to_string(i)).c_str()); // The daemon only creates items of existing products
+    if (!TrackerDaemon::startDaemon(socketPath.c_str(), 0))
+        return 1;
+
+    TrackerClient seeder;
+    if (!seeder.connectTo(socketPath.c_str())) {
+        std::cerr << "Failed to connect to the benchmark daemon." << std::endl;
+        TrackerDaemon::stopDaemon();
+        TrackerDaemon::waitDaemon();
+        return 1;
+    }
+    ItemRecord item;
+    item.description = "Seeded item";
+    item.date = "2026-10-19";
+    item.releaseId = "1.0.0.0";
+    item.priority = 3;
+    for (int i = 0; i < BENCH_PRODUCTS; i++)
+        seeder.createRelease("Prod" + std::to_string(i), item.releaseId, item.date);
+    for (int i = 0; i < BENCH_SEED_ITEMS; i++) {
+        int32_t changeId;
+        item.product = "Prod" + std::to_string(i % BENCH_PRODUCTS);
+        seeder.createItem(item, changeId);
+    }
+    seeder.disconnect();
+
+    std::atomic<int> knownItems(BENCH_SEED_ITEMS);
+    std::cout << std::endl << std::setw(8) << "clients" << std::setw(14) << "ops/s"
+              << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(10) << "errors" << std::endl;
+
+    for (int clients = 1; clients <= maxClients; clients *= 2) {
+        std::vector<std::vector<long long>> latencies(clients);
+        std::vector<long long> failures(clients, 0);
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::seconds(BENCH_SECONDS);
+        for (int i = 0; i < clients; i++)
+            threads.emplace_back(runClient, socketPath, i + 1, std::ref(knownItems), deadline, std::ref(latencies[i]), std::ref(failures[i]));
+        for (std::thread& thread : threads)
+            thread.join();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<long long> all;
+        long long errors = 0;
+        for (int i = 0; i < clients; i++) {
+            all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+            errors += failures[i];
+        }
+        std::sort(all.begin(), all.end());
+        double p50 = all.empty() ? 0 : all[all.size() / 2] / 1000.0;
+        double p99 = all.empty() ? 0 : all[std::min(all.size() - 1, all.size() * 99 / 100)] / 1000.0;
+        std::cout << std::setw(8) << clients << std::setw(14) << std::fixed << std::setprecision(0) << all.size() / elapsed
+                  << std::setw(12) << std::setprecision(1) << p50 << std::setw(12) << p99 << std::setw(10) << errors << std::endl;
+    }
+
+    TrackerDaemon::stopDaemon();
+    TrackerDaemon::waitDaemon();
+    ChangeItem::closeChangeItem();
+    ChangeRequest::closeChangeRequest();
+    ProductRelease::closeProductRelease();
+    Product::closeProduct();
+    std::remove("ChangeItem.txt");
+    std::remove("ChangeRequest.txt");
+    std::remove("ProductRelease.txt");
+    std::remove("Product.txt");
+    if (chdir("/") == 0)
+        rmdir(directory);
+    return 0;
+}
+
+#else
+
+//================================
+// Unsupported platform
+//================================
+TrackerClient::TrackerClient() : fd(-1) {}
+TrackerClient::~TrackerClient() {}
+bool TrackerClient::connectTo(const char* socketPath) { return false; }
+void TrackerClient::disconnect() {}
+int TrackerClient::call(const WireWriter& request, std::string& response) { return STATUS_ERROR; }
+int TrackerClient::ping() { return STATUS_ERROR; }
+int TrackerClient::createItem(const ItemRecord& item, int32_t& changeId) { return STATUS_ERROR; }
+int TrackerClient::getItem(int32_t changeId, ItemRecord& item) { return STATUS_ERROR; }
+int TrackerClient::getItems(const std::vector<int32_t>& changeIds, std::vector<std::optional<ItemRecord>>& items) { return STATUS_ERROR; }
+int TrackerClient::updateState(int32_t changeId, uint8_t state) { return STATUS_ERROR; }
+int TrackerClient::updatePriority(int32_t changeId, uint8_t priority) { return STATUS_ERROR; }
+int TrackerClient::listItems(const std::string& product, std::vector<ItemRecord>& items) { return STATUS_ERROR; }
+int TrackerClient::report(const std::string& product, uint32_t counts[4]) { return STATUS_ERROR; }
+int TrackerClient::createRequest(const std::string& requester, const std::string& product, const std::string& date, int32_t& changeId) { return STATUS_ERROR; }
+int TrackerClient::createRelease(const std::string& product, const std::string& releaseId, const std::string& date) { return STATUS_ERROR; }
+int TrackerClient::readFeed(uint64_t fromSequence, uint8_t entity, const std::string& product, uint8_t state, uint32_t maxEvents,
+                            std::vector<FeedRecord>& events, uint64_t& nextSequence) { return STATUS_ERROR; }
+int TrackerClient::replicaStatus(uint8_t& role, uint64_t& applied, uint64_t& primaryEnd, uint64_t& lagMs) { return STATUS_ERROR; }
+int TrackerClient::promote() { return STATUS_ERROR; }
+int TrackerClient::takeWork(const std::string& product, const std::string& holder, uint32_t seconds, uint32_t& version,
+                            uint64_t& expires, ItemRecord& item) { return STATUS_ERROR; }
+int TrackerClient::renewLease(int32_t changeId, uint32_t version, uint32_t seconds, uint64_t& expires) { return STATUS_ERROR; }
+int TrackerClient::finishLease(int32_t changeId, uint32_t version, uint8_t state) { return STATUS_ERROR; }
+int TrackerClient::benchmarkDaemon(int maxClients) {
+    std::cerr << "The daemon benchmark is only supported on Linux." << std::endl;
+    return 1;
+}
+
+#endif
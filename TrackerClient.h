@@ -0,0 +1,89 @@
+/**********************************************
+ * TrackerClient Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added readFeed.
+ * - 2026-10-19: Added replicaStatus and promote.
+ * - 2026-10-19: Added getItems.
+ * - 2026-10-19: Added takeWork, renewLease and finishLease.
+ *--------------------------------
+ * Purpose:
+ * This module provides a blocking client for the tracker daemon and the daemon
+ * benchmark. Every call sends one request frame and waits for its response, and
+ * returns the Status byte from DaemonProtocol.h (or STATUS_ERROR if the
+ * connection failed).
+ **********************************************/
+#ifndef TRACKERCLIENT_H
+#define TRACKERCLIENT_H
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "DaemonProtocol.h"
+
+//=============================
+// Class Declaration
+//=============================
+
+class TrackerClient {
+public:
+    //=============================
+    // Constructor Declarations
+    //=============================
+    //----------------------------------------------------------
+    TrackerClient();
+    // Description: Creates a client that is not connected yet.
+
+    //----------------------------------------------------------
+    ~TrackerClient();
+    // Description: Closes the connection if it is open.
+
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    bool connectTo(const char* socketPath);
+    // Description: Connects to the daemon listening on socketPath.
+    // Returns: bool - True if the connection was established.
+
+    //----------------------------------------------------------
+    void disconnect();
+    // Description: Closes the connection.
+
+    //----------------------------------------------------------
+    int ping();
+    int createItem(const ItemRecord& item, int32_t& changeId);
+    int getItem(int32_t changeId, ItemRecord& item);
+    int getItems(const std::vector<int32_t>& changeIds, std::vector<std::optional<ItemRecord>>& items);
+    int updateState(int32_t changeId, uint8_t state);
+    int updatePriority(int32_t changeId, uint8_t priority);
+    int listItems(const std::string& product, std::vector<ItemRecord>& items);
+    int report(const std::string& product, uint32_t counts[4]);
+    int createRequest(const std::string& requester, const std::string& product, const std::string& date, int32_t& changeId);
+    int createRelease(const std::string& product, const std::string& releaseId, const std::string& date);
+    int readFeed(uint64_t fromSequence, uint8_t entity, const std::string& product, uint8_t state, uint32_t maxEvents,
+                 std::vector<FeedRecord>& events, uint64_t& nextSequence);
+    int replicaStatus(uint8_t& role, uint64_t& applied, uint64_t& primaryEnd, uint64_t& lagMs);
+    int promote();
+    int takeWork(const std::string& product, const std::string& holder, uint32_t seconds, uint32_t& version,
+                 uint64_t& expires, ItemRecord& item);
+    int renewLease(int32_t changeId, uint32_t version, uint32_t seconds, uint64_t& expires);
+    int finishLease(int32_t changeId, uint32_t version, uint8_t state);
+    // Description: One call per protocol operation; see DaemonProtocol.h for the fields.
+    // Returns: int - The Status of the response.
+
+    //----------------------------------------------------------
+    static int benchmarkDaemon(int maxClients);
+    // Description: Starts a daemon on a scratch data directory and measures throughput
+    //              and p50/p99 latency of a mixed workload at 1, 2, 4, ... maxClients
+    //              concurrent clients.
+    // Returns: int - The process exit status.
+
+private:
+    int call(const WireWriter& request, std::string& response);
+
+    int fd;
+};
+
+#endif // TRACKERCLIENT_H
@@ -0,0 +1,747 @@
+/**********************************************
+ * TrackerDaemon Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Change item reads use snapshots and no longer take the item lock.
+ * - 2026-10-19: Added OP_READ_FEED.
+ * - 2026-10-19: Followers refuse writes; added OP_REPLICA_STATUS and OP_PROMOTE.
+ * - 2026-10-19: Lookups and listings encode records through views, without per-item copies.
+ * - 2026-10-19: Added OP_GET_ITEMS; missing releases are reported without an exception.
+ * - 2026-10-19: Added OP_TAKE_WORK, OP_RENEW_LEASE and OP_FINISH_LEASE.
+ * - 2026-10-19: Counts connections and requests; added stats.
+ * - 2026-10-19: Each request is traced as a span.
+ * - 2026-10-19: Removed the item, request and release locks; the entity modules serialize their streams.
+ * - 2026-10-19: Items and requests are only created for a product, release and requester that exist.
+ * - 2026-10-19: OP_CREATE_ITEM answers STATUS_ERROR when the item is not written.
+ * - 2026-10-19: OP_CREATE_RELEASE refuses an unknown product; the create operations require YYYY-MM-DD dates.
+ *--------------------------------
+ * Purpose:
+ * This module implements the tracker daemon. One coroutine accepts connections on
+ * the listening socket and starts a coroutine per client. A client coroutine reads
+ * request frames, runs each one against the entity modules, which serialize their
+ * own use of a shared file stream, and writes the response frame back. Sockets are non-blocking;
+ * whenever a read or write would block the coroutine suspends on the executor.
+ **********************************************/
+#include "TrackerDaemon.h"
+
+#include <iostream>
+#include <string>
+
+#ifdef __linux__
+#include <atomic>
+#include <cctype>
+#include <csignal>
+#include <cerrno>
+#include <mutex>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "DaemonProtocol.h"
+#include "TaskExecutor.h"
+#include "ChangeItem.h"
+#include "RecordView.h"
+#include "ChangeFeed.h"
+#include "ChangeRequest.h"
+#include "ProductRelease.h"
+#include "Product.h"
+#include "Requester.h"
+#include "Replica.h"
+#include "WorkQueue.h"
+#include "Trace.h"
+#include "ObjectNotFoundException.h"
+#include "KeyUniquenessException.h"
+
+//================================
+// Constants
+//================================
+const uint32_t MAX_FEED_EVENTS = 4096;  // Most change feed events returned by one OP_READ_FEED
+
+//================================
+// Static Variables
+//================================
+static TaskExecutor* executor = nullptr;
+static std::mutex executorLock;         // Held while executor is replaced, so stats() never sees it deleted
+static std::atomic<long long> openConnections(0);
+static std::atomic<long long> requestsAnswered(0);
+static int listenFd = -1;
+static int wakePipe[2] = {-1, -1};      // Written to by stopDaemon() and the signal handler
+static std::string boundPath;
+static std::atomic<bool> stopRequested(false);
+
+//================================
+// Request Handling
+//================================
+
+/**********************************************
+ * Function: writeItem
+ * Description: Encodes a ChangeItem in the layout of WireWriter::item, straight
+ *              from the record's fields without building an ItemRecord.
+ **********************************************/
+static void writeItem(WireWriter& payload, const ChangeItemView& changeItem) {
+    payload.i32(changeItem.changeId());
+    payload.str(changeItem.productName());
+    payload.str(changeItem.description());
+    payload.str(changeItem.date());
+    payload.str(changeItem.releaseId());
+    payload.u8(static_cast<uint8_t>(changeItem.priority()));
+    payload.u8(static_cast<uint8_t>(changeItem.state()));
+}
+
+/**********************************************
+ * Function: toRecord
+ * Description: Converts a change feed event into its wire representation.
+ **********************************************/
+static FeedRecord toRecord(const FeedEvent& event) {
+    auto unset = [](int8_t value) { return value < 0 ? ANY_FILTER : static_cast<uint8_t>(value); };
+    FeedRecord record;
+    record.sequence = static_cast<uint64_t>(event.sequence);
+    record.timestamp = static_cast<uint64_t>(event.timestamp);
+    record.changeId = event.changeId;
+    record.entity = event.entity;
+    record.kind = event.kind;
+    record.state = unset(event.state);
+    record.priority = unset(event.priority);
+    record.previous = unset(event.previous);
+    record.product = std::string(event.product, strnlen(event.product, sizeof(event.product)));
+    record.key = std::string(event.key, strnlen(event.key, sizeof(event.key)));
+    return record;
+}
+
+/**********************************************
+ * Function: makeProduct
+ * Description: Builds a Product holding the given name without touching Product.txt.
+ **********************************************/
+static Product makeProduct(const std::string& name) {
+    Product product;
+    product.updateName(name.c_str());
+    return product;
+}
+
+/**********************************************
+ * Function: validState
+ * Description: Returns true if value is one of the ChangeItem states.
+ **********************************************/
+static bool validState(uint8_t value) {
+    return value <= ChangeItem::CANCELLED;
+}
+
+/**********************************************
+ * Function: validDate
+ * Description: Returns true if text is a date of the form YYYY-MM-DD.
+ **********************************************/
+static bool validDate(const std::string& text) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-')
+        return false;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9})
+        if (!std::isdigit(static_cast<unsigned char>(text[i])))
+            return false;
+    return true;
+}
+
+/**********************************************
+ * Function: writesData
+ * Description: Returns true for the opcodes a follower must refuse.
+ **********************************************/
+static bool writesData(uint8_t opcode) {
+    return opcode == OP_CREATE_ITEM || opcode == OP_UPDATE_STATE || opcode == OP_UPDATE_PRIORITY ||
+           opcode == OP_CREATE_REQUEST || opcode == OP_CREATE_RELEASE || opcode == OP_TAKE_WORK ||
+           opcode == OP_RENEW_LEASE || opcode == OP_FINISH_LEASE;
+}
+
+/**********************************************
+ * Function: handleRequest
+ * Description:
+ * Decodes one request body, runs it and encodes the response body. Field lengths
+ * are checked against the fixed-width record fields before anything is written.
+ * Parameters:
+ * - in: The request body
+ * - out: Receives the response body
+ **********************************************/
+static void handleRequest(WireReader& in, WireWriter& out) {
+    Trace::Span span("daemon.request", "daemon"); // Not around a co_await: a span must end on the thread it began on
+    uint8_t opcode = in.u8();
+    WireWriter payload;
+    uint8_t status = STATUS_OK;
+    if (writesData(opcode) && Replica::isFollower()) {
+        out.u8(STATUS_READ_ONLY);
+        return;
+    }
+
+    try {
+        switch (opcode) {
+            case OP_PING:
+                break;
+
+            case OP_CREATE_ITEM: {
+                std::string product = in.str();
+                std::string description = in.str();
+                uint8_t state = in.u8();
+                uint8_t priority = in.u8();
+                std::string date = in.str();
+                std::string releaseId = in.str();
+                if (!in.ok || product.empty() || product.size() > 10 || description.size() > 149 || !validDate(date) ||
+                    releaseId.size() > 7 || !validState(state) || priority < 1 || priority > 5) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                if (!Product::exists(product) || (!releaseId.empty() && !ProductRelease::exists(product, releaseId))) {
+                    status = STATUS_NOT_FOUND;
+                    break;
+                }
+                Product itemProduct = makeProduct(product);
+                ProductRelease release(itemProduct, releaseId.c_str(), date.c_str());
+                ChangeItem changeItem(itemProduct, description.c_str(), static_cast<ChangeItem::State>(state), priority, date.c_str(), release);
+                if (!ChangeItem::createChangeItem(changeItem)) {
+                    status = STATUS_ERROR;
+                    break;
+                }
+                payload.i32(changeItem.getChangeId());
+                break;
+            }
+
+            case OP_GET_ITEM: {
+                int32_t changeId = in.i32();
+                if (!in.ok) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                ChangeItem changeItem;
+                if (!ChangeItem::findChangeItem(changeId, changeItem)) {
+                    status = STATUS_NOT_FOUND;
+                    break;
+                }
+                writeItem(payload, ChangeItemView(changeItem));
+                break;
+            }
+
+            case OP_GET_ITEMS: {
+                uint32_t count = in.u32();
+                if (!in.ok || count > MAX_BATCH_IDS) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                std::vector<int> changeIds(count);
+                for (int& changeId : changeIds)
+                    changeId = in.i32();
+                if (!in.ok) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                std::vector<std::optional<ChangeItem>> changeItems = ChangeItem::getChangeItems(changeIds);
+                payload.u32(count);
+                for (const std::optional<ChangeItem>& changeItem : changeItems) {
+                    payload.u8(changeItem ? 1 : 0);
+                    if (changeItem)
+                        writeItem(payload, ChangeItemView(*changeItem));
+                }
+                break;
+            }
+
+            case OP_UPDATE_STATE: {
+                int32_t changeId = in.i32();
+                uint8_t state = in.u8();
+                if (!in.ok || !validState(state)) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                if (!ChangeItem::updateStatus(static_cast<ChangeItem::State>(state), changeId))
+                    status = STATUS_NOT_FOUND;
+                break;
+            }
+
+            case OP_UPDATE_PRIORITY: {
+                int32_t changeId = in.i32();
+                uint8_t priority = in.u8();
+                if (!in.ok || priority < 1 || priority > 5) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                if (!ChangeItem::updatePriority(priority, changeId))
+                    status = STATUS_NOT_FOUND;
+                break;
+            }
+
+            case OP_TAKE_WORK: {
+                std::string product = in.str();
+                std::string holder = in.str();
+                uint32_t seconds = in.u32();
+                if (!in.ok || product.size() > 10 || holder.empty() || seconds == 0) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                WorkLease lease;
+                ChangeItem changeItem;
+                if (!WorkQueue::takeNext(product, holder, static_cast<int>(std::min<uint32_t>(seconds, MAX_LEASE_SECONDS)), lease, changeItem)) {
+                    status = STATUS_NOT_FOUND;
+                    break;
+                }
+                payload.u32(static_cast<uint32_t>(lease.version));
+                payload.u64(static_cast<uint64_t>(lease.expires));
+                writeItem(payload, ChangeItemView(changeItem));
+                break;
+            }
+
+            case OP_RENEW_LEASE: {
+                WorkLease lease;
+                lease.changeId = in.i32();
+                lease.version = static_cast<int>(in.u32());
+                uint32_t seconds = in.u32();
+                if (!in.ok || seconds == 0) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                if (!WorkQueue::renew(lease, static_cast<int>(std::min<uint32_t>(seconds, MAX_LEASE_SECONDS)))) {
+                    status = STATUS_CONFLICT;
+                    break;
+                }
+                payload.u64(static_cast<uint64_t>(lease.expires));
+                break;
+            }
+
+            case OP_FINISH_LEASE: {
+                WorkLease lease;
+                lease.changeId = in.i32();
+                lease.version = static_cast<int>(in.u32());
+                uint8_t state = in.u8();
+                if (!in.ok || !validState(state)) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                ChangeItem::UpdateResult result = WorkQueue::finish(lease, static_cast<ChangeItem::State>(state));
+                if (result == ChangeItem::UPDATE_CONFLICT)
+                    status = STATUS_CONFLICT;
+                else if (result == ChangeItem::UPDATE_NOT_FOUND)
+                    status = STATUS_NOT_FOUND;
+                break;
+            }
+
+            case OP_LIST_ITEMS: {
+                std::string product = in.str();
+                if (!in.ok) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                // Items are encoded as the scan reads them; the count is filled in afterwards
+                size_t countPosition = payload.buffer.size();
+                uint32_t count = 0;
+                payload.u32(0);
+                ChangeItem::visitChangeItems(product, [&](const ChangeItemView& changeItem) {
+                    writeItem(payload, changeItem);
+                    count++;
+                });
+                payload.u32At(countPosition, count);
+                break;
+            }
+
+            case OP_REPORT: {
+                std::string product = in.str();
+                if (!in.ok) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                int counts[4];
+                ChangeItem::countByState(product, counts);
+                for (int count : counts)
+                    payload.u32(static_cast<uint32_t>(count));
+                break;
+            }
+
+            case OP_CREATE_REQUEST: {
+                std::string requester = in.str();
+                std::string product = in.str();
+                std::string date = in.str();
+                if (!in.ok || requester.empty() || requester.size() > 29 || product.empty() || product.size() > 10 || !validDate(date)) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                if (!Requester::hasName(requester) || !Product::exists(product)) {
+                    status = STATUS_NOT_FOUND;
+                    break;
+                }
+                ChangeRequest changeRequest(requester.c_str(), makeProduct(product), date.c_str());
+                ChangeRequest::createChangeRequest(changeRequest);
+                payload.i32(changeRequest.getChangeId());
+                break;
+            }
+
+            case OP_GET_REQUEST: {
+                int32_t changeId = in.i32();
+                if (!in.ok) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                ChangeRequest changeRequest;
+                if (!ChangeRequest::findChangeRequest(changeId, changeRequest)) {
+                    status = STATUS_NOT_FOUND;
+                    break;
+                }
+                ChangeRequestView view(changeRequest);
+                payload.str(view.requestedBy());
+                payload.str(view.productName());
+                payload.str(view.date());
+                break;
+            }
+
+            case OP_CREATE_RELEASE: {
+                std::string product = in.str();
+                std::string releaseId = in.str();
+                std::string date = in.str();
+                if (!in.ok || product.empty() || product.size() > 10 || releaseId.empty() || releaseId.size() > 7 || !validDate(date)) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                if (!Product::exists(product)) {
+                    status = STATUS_NOT_FOUND;
+                    break;
+                }
+                ProductRelease release(makeProduct(product), releaseId.c_str(), date.c_str());
+                ProductRelease::createProductRelease(release);
+                break;
+            }
+
+            case OP_GET_RELEASE: {
+                std::string releaseId = in.str();
+                if (!in.ok) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                ProductRelease release;
+                if (!ProductRelease::findProductRelease(releaseId.c_str(), release)) {
+                    status = STATUS_NOT_FOUND;
+                    break;
+                }
+                payload.str(release.getProductName());
+                payload.str(release.releaseIdToString());
+                payload.str(release.getDate());
+                break;
+            }
+
+            case OP_READ_FEED: {
+                uint64_t fromSequence = in.u64();
+                uint8_t entity = in.u8();
+                std::string product = in.str();
+                uint8_t state = in.u8();
+                uint32_t maxEvents = in.u32();
+                if (!in.ok || fromSequence > static_cast<uint64_t>(INT64_MAX)) {
+                    status = STATUS_BAD_REQUEST;
+                    break;
+                }
+                FeedFilter filter;
+                filter.entity = entity == ANY_FILTER ? -1 : entity;
+                filter.product = product;
+                filter.state = state == ANY_FILTER ? -1 : state;
+                std::vector<FeedEvent> events;
+                long long next = ChangeFeed::read(static_cast<long long>(fromSequence), filter,
+                                                  std::min<uint32_t>(maxEvents, MAX_FEED_EVENTS), events);
+                payload.u64(static_cast<uint64_t>(next));
+                payload.u32(static_cast<uint32_t>(events.size()));
+                for (const FeedEvent& event : events)
+                    payload.feedEvent(toRecord(event));
+                break;
+            }
+
+            case OP_REPLICA_STATUS: {
+                ReplicaStatus replica = Replica::status();
+                payload.u8(replica.follower ? REPLICA_ROLE_FOLLOWER : REPLICA_ROLE_PRIMARY);
+                payload.u64(static_cast<uint64_t>(replica.applied));
+                payload.u64(static_cast<uint64_t>(replica.primaryEnd));
+                payload.u64(static_cast<uint64_t>(replica.lagMs));
+                break;
+            }
+
+            case OP_PROMOTE:
+                if (!Replica::promote())
+                    status = STATUS_BAD_REQUEST;
+                break;
+
+            default:
+                status = STATUS_BAD_REQUEST;
+        }
+    } catch (const ObjectNotFoundException&) {
+        status = STATUS_NOT_FOUND;
+    } catch (const KeyUniquenessException&) {
+        status = STATUS_CONFLICT;
+    } catch (const std::exception& error) {
+        std::cerr << "Daemon request failed: " << error.what() << std::endl;
+        status = STATUS_ERROR;
+    }
+
+    out.u8(status);
+    if (status == STATUS_OK)
+        out.buffer += payload.buffer;
+}
+
+//================================
+// Coroutines
+//================================
+
+/**********************************************
+ * Function: serveConnection
+ * Description:
+ * Serves one client until it disconnects. Complete frames are answered in the
+ * order they arrive, so clients may pipeline several requests.
+ * Parameters:
+ * - executor: The executor the coroutine runs on
+ * - fd: The connected, non-blocking client socket
+ **********************************************/
+static TaskExecutor::Task serveConnection(TaskExecutor& executor, int fd) {
+    co_await executor.schedule();
+    openConnections++;
+
+    std::string input;
+    std::string output;
+    char chunk[8192];
+    bool open = true;
+
+    while (open) {
+        // Answer every complete frame that has been received
+        size_t consumed = 0;
+        while (input.size() - consumed >= 4) {
+            WireReader header(input.data() + consumed, 4);
+            uint32_t length = header.u32();
+            if (length > MAX_FRAME_LENGTH) {
+                open = false;
+                break;
+            }
+            if (input.size() - consumed - 4 < length)
+                break;
+            WireReader body(input.data() + consumed + 4, length);
+            WireWriter response;
+            handleRequest(body, response);
+            requestsAnswered.fetch_add(1, std::memory_order_relaxed);
+            output += response.frame();
+            consumed += 4 + length;
+        }
+        input.erase(0, consumed);
+
+        // Flush the responses before reading more, which keeps the buffers bounded
+        while (open && !output.empty()) {
+            ssize_t sent = send(fd, output.data(), output.size(), MSG_NOSIGNAL);
+            if (sent > 0)
+                output.erase(0, static_cast<size_t>(sent));
+            else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                co_await executor.writable(fd);
+            else if (sent < 0 && errno == EINTR)
+                continue;
+            else
+                open = false;
+        }
+
+        if (!open)
+            break;
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received > 0)
+            input.append(chunk, static_cast<size_t>(received));
+        else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            co_await executor.readable(fd);
+        else if (received < 0 && errno == EINTR)
+            continue;
+        else
+            open = false;
+    }
+
+    executor.detach(fd);
+    close(fd);
+    openConnections--;
+}
+
+/**********************************************
+ * Function: acceptConnections
+ * Description: Accepts clients and starts a serveConnection coroutine for each one.
+ * Parameters:
+ * - executor: The executor the coroutines run on
+ * - fd: The listening, non-blocking socket
+ **********************************************/
+static TaskExecutor::Task acceptConnections(TaskExecutor& executor, int fd) {
+    co_await executor.schedule();
+
+    while (!stopRequested) {
+        int client = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client >= 0)
+            serveConnection(executor, client);
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            co_await executor.readable(fd);
+        else if (errno != EINTR && errno != ECONNABORTED && errno != EMFILE && errno != ENFILE) {
+            std::cerr << "Daemon stopped accepting connections." << std::endl;
+            break;
+        }
+    }
+}
+
+//================================
+// Signal Handling
+//================================
+
+/**********************************************
+ * Function: onStopSignal
+ * Description: Wakes waitDaemon() when SIGINT or SIGTERM is received.
+ **********************************************/
+static void onStopSignal(int) {
+    char byte = 1;
+    if (write(wakePipe[1], &byte, 1) < 0) {
+        // Nothing more can be done inside a signal handler
+    }
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: startDaemon
+ * Description:
+ * Binds the Unix-domain socket, starts the executor and begins accepting clients.
+ * A stale socket file left by a previous daemon is replaced.
+ * Parameters:
+ * - socketPath: The filesystem path of the socket
+ * - threadCount: The number of worker threads; 0 uses the hardware concurrency
+ * Returns: bool - True if the daemon is listening, false otherwise.
+ **********************************************/
+bool TrackerDaemon::startDaemon(const char* socketPath, int threadCount) {
+    if (executor != nullptr) {
+        std::cerr << "The daemon is already running." << std::endl;
+        return false;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path is too long." << std::endl;
+        return false;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        std::cerr << "Failed to create the daemon socket." << std::endl;
+        return false;
+    }
+    unlink(socketPath);
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        std::cerr << "Failed to bind the daemon socket " << socketPath << "." << std::endl;
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    if (pipe(wakePipe) < 0) {
+        std::cerr << "Failed to create the daemon wake pipe." << std::endl;
+        close(listenFd);
+        listenFd = -1;
+        unlink(socketPath);
+        return false;
+    }
+
+    boundPath = socketPath;
+    stopRequested = false;
+    TaskExecutor* started = new TaskExecutor(threadCount);
+    if (!started->isRunning()) {
+        delete started;
+        close(listenFd);
+        listenFd = -1;
+        unlink(socketPath);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(executorLock);
+        executor = started;
+    }
+    acceptConnections(*executor, listenFd);
+    std::cout << "Daemon listening on " << socketPath << " with " << executor->getThreadCount() << " worker threads." << std::endl;
+    return true;
+}
+
+/**********************************************
+ * Function: waitDaemon
+ * Description:
+ * Blocks until stopDaemon() is called or SIGINT/SIGTERM is received, then stops
+ * the executor, closes the socket and removes the socket file.
+ **********************************************/
+void TrackerDaemon::waitDaemon() {
+    if (executor == nullptr)
+        return;
+
+    struct sigaction action{};
+    action.sa_handler = onStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    char byte;
+    while (read(wakePipe[0], &byte, 1) < 0 && errno == EINTR) {
+    }
+
+    stopRequested = true;
+    executor->stop();
+    {
+        std::lock_guard<std::mutex> lock(executorLock);
+        delete executor;
+        executor = nullptr;
+    }
+    close(listenFd);
+    listenFd = -1;
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+    wakePipe[0] = wakePipe[1] = -1;
+    unlink(boundPath.c_str());
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    std::cout << "Daemon stopped." << std::endl;
+}
+
+/**********************************************
+ * Function: stopDaemon
+ * Description: Asks a running daemon to shut down. Safe to call from any thread.
+ **********************************************/
+void TrackerDaemon::stopDaemon() {
+    onStopSignal(0);
+}
+
+/**********************************************
+ * Function: stats
+ * Description: Reports the connections, requests and run queue of the daemon.
+ *              Safe to call from any thread.
+ **********************************************/
+DaemonStats TrackerDaemon::stats() {
+    DaemonStats daemon;
+    std::lock_guard<std::mutex> lock(executorLock);
+    if (executor == nullptr)
+        return daemon;
+    daemon.running = true;
+    daemon.threads = executor->getThreadCount();
+    daemon.connections = openConnections.load();
+    daemon.requests = requestsAnswered.load();
+    daemon.queued = executor->queueDepth();
+    return daemon;
+}
+
+#else
+
+//================================
+// Unsupported platform
+//================================
+bool TrackerDaemon::startDaemon(const char* socketPath, int threadCount) {
+    std::cerr << "Daemon mode is only supported on Linux." << std::endl;
+    return false;
+}
+void TrackerDaemon::waitDaemon() {}
+void TrackerDaemon::stopDaemon() {}
+DaemonStats TrackerDaemon::stats() { return DaemonStats(); }
+
+#endif
+
+/**********************************************
+ * Function: runDaemon
+ * Description: Starts the daemon and serves clients until it is stopped.
+ * Parameters:
+ * - socketPath: The filesystem path of the socket
+ * - threadCount: The number of worker threads; 0 uses the hardware concurrency
+ * Returns: bool - False if the daemon could not be started.
+ **********************************************/
+bool TrackerDaemon::runDaemon(const char* socketPath, int threadCount) {
+    if (!startDaemon(socketPath, threadCount))
+        return false;
+    waitDaemon();
+    return true;
+}
@@ -0,0 +1,77 @@
+/**********************************************
+ * TrackerDaemon Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added stats.
+ *--------------------------------
+ * Purpose:
+ * This module runs the tracker as a local daemon. The daemon owns the data files
+ * and serves the operations described in DaemonProtocol.h to many concurrent
+ * clients over a Unix-domain socket. Each connection is a coroutine on the
+ * TaskExecutor pool, and each entity file is guarded by its own reader-writer
+ * lock so lookups, listings and reports run in parallel while creates and
+ * updates get exclusive access to the one file they change.
+ **********************************************/
+#ifndef TRACKERDAEMON_H
+#define TRACKERDAEMON_H
+
+#include <cstddef>
+
+//=============================
+// Constants
+//=============================
+#define DEFAULT_SOCKET_PATH "tracker.sock" // Created in the data directory unless a path is given
+
+//=============================
+// Record Types
+//=============================
+
+// What the daemon of this process is doing, for the metrics endpoint.
+struct DaemonStats {
+    bool running = false;
+    int threads = 0;
+    long long connections = 0;      // Clients connected now
+    long long requests = 0;         // Requests answered since the daemon started
+    size_t queued = 0;              // Coroutines waiting for a worker thread
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class TrackerDaemon {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool startDaemon(const char* socketPath, int threadCount);
+    // Description: Binds the socket and starts serving clients in the background.
+    //              The entity modules must already be initialized.
+    // Parameters:
+    // - const char* socketPath: The filesystem path of the Unix-domain socket.
+    // - int threadCount: The number of worker threads; 0 uses the hardware concurrency.
+    // Returns: bool - True if the daemon is listening, false otherwise.
+
+    //----------------------------------------------------------
+    static void waitDaemon();
+    // Description: Blocks until stopDaemon() is called or SIGINT/SIGTERM is received,
+    //              then shuts the daemon down and removes the socket file.
+
+    //----------------------------------------------------------
+    static void stopDaemon();
+    // Description: Asks a running daemon to shut down. Safe to call from any thread.
+
+    //----------------------------------------------------------
+    static bool runDaemon(const char* socketPath, int threadCount);
+    // Description: Starts the daemon and serves clients until it is stopped.
+    // Returns: bool - False if the daemon could not be started.
+
+    //----------------------------------------------------------
+    static DaemonStats stats();
+    // Description: Returns the daemon's connections, requests and run queue; running is false
+    //              if no daemon runs in this process. Safe to call from any thread.
+};
+
+#endif // TRACKERDAEMON_H
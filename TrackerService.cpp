@@ -0,0 +1,556 @@
+/**********************************************
+ * TrackerService Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Dropped the item, request and release locks, which the entity modules now take.
+ * - 2026-10-19: createRequest refuses a requester that does not exist.
+ * - 2026-10-19: createRequest stops when its change item is not written and uses a stored release as it is.
+ * - 2026-10-19: listItems returns the arena-backed records from listChangeItems.
+ * - 2026-10-19: Release IDs are checked against the X.X.X.X format again.
+ * - 2026-10-19: Implemented bulkUpdateState/Priority, takeItem, renewLease, finishLease, listRequests and mostRequested.
+ *--------------------------------
+ * Purpose:
+ * This module implements the service operations on top of the entity modules.
+ * Products and requesters are written through streams their modules share
+ * between callers, so each of those files has a lock here that is held for the
+ * check and the write together; a uniqueness check and the append it guards are
+ * then never interleaved with another caller's. Releases, change items and change
+ * requests are appended under a lock inside their own modules, which the daemon's
+ * appends take as well. Item lookups, listings and compare-and-swap updates open
+ * their own streams and lock only the record they change, and the release index,
+ * the work queue and the request links lock themselves, so those take no lock of
+ * the service's.
+ **********************************************/
+#include "TrackerService.h"
+#include "ChangeRequest.h"
+#include "KeyUniquenessException.h"
+#include "Metrics.h"
+#include "Product.h"
+#include "ProductRelease.h"
+#include "RecordView.h"
+#include "RequestLinks.h"
+#include "Requester.h"
+#include "Trace.h"
+#include "WorkQueue.h"
+
+#include <cctype>
+#include <mutex>
+
+//================================
+// Static Variables
+//================================
+static std::mutex productLock;          // Guards Product.txt
+static std::mutex requesterLock;        // Guards req.txt
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: fail
+ * Description: Fills in the status and message of a failed response.
+ * Returns: The response, for returning it at once
+ **********************************************/
+template <typename Response>
+static Response fail(Response response, ServiceStatus status, const std::string& message) {
+    response.status = status;
+    response.message = message;
+    return response;
+}
+
+/**********************************************
+ * Function: validDate
+ * Description: Returns true if text is a date written YYYY-MM-DD.
+ **********************************************/
+static bool validDate(const std::string& text) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-')
+        return false;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9})
+        if (!std::isdigit(static_cast<unsigned char>(text[i])))
+            return false;
+    return true;
+}
+
+/**********************************************
+ * Function: validReleaseId
+ * Description: Returns true if text is a release ID of the form X.X.X.X, one digit each.
+ **********************************************/
+static bool validReleaseId(const std::string& text) {
+    if (text.size() != 7 || text[1] != '.' || text[3] != '.' || text[5] != '.')
+        return false;
+    for (size_t i : {0, 2, 4, 6})
+        if (!std::isdigit(static_cast<unsigned char>(text[i])))
+            return false;
+    return true;
+}
+
+/**********************************************
+ * Function: validProduct
+ * Description: Returns true if text fits a product name.
+ **********************************************/
+static bool validProduct(const std::string& text) {
+    return !text.empty() && text.size() <= 10;
+}
+
+/**********************************************
+ * Function: validSelection
+ * Description: Returns true if every field of a bulk update selection is in range.
+ **********************************************/
+static bool validSelection(const ChangeItem::Selection& selection) {
+    return selection.product.size() <= 10 &&
+           (selection.releaseId.empty() || validReleaseId(selection.releaseId)) &&
+           selection.state >= -1 && selection.state <= ChangeItem::CANCELLED &&
+           selection.minPriority >= 1 && selection.maxPriority <= 5 && selection.minPriority <= selection.maxPriority;
+}
+
+/**********************************************
+ * Function: bulkUpdated
+ * Description: Builds the response of a bulk update that changed count items.
+ **********************************************/
+static BulkUpdateResponse bulkUpdated(int count) {
+    BulkUpdateResponse response;
+    response.updated = count;
+    response.message = std::to_string(count) + " change items updated.";
+    return response;
+}
+
+/**********************************************
+ * Function: productExists
+ * Description: Looks a product up under the product file's lock.
+ **********************************************/
+static bool productExists(const std::string& name) {
+    std::lock_guard<std::mutex> lock(productLock);
+    return Product::exists(name);
+}
+
+/**********************************************
+ * Function: makeProduct
+ * Description: Builds a Product holding the given name without touching Product.txt.
+ **********************************************/
+static Product makeProduct(const std::string& name) {
+    Product product;
+    product.updateName(name.c_str());
+    return product;
+}
+
+/**********************************************
+ * Function: toDetails
+ * Description: Copies a change item's fields out of its record.
+ **********************************************/
+static ItemDetails toDetails(const ChangeItemView& changeItem) {
+    ItemDetails details;
+    details.changeId = changeItem.changeId();
+    details.product = std::string(changeItem.productName());
+    details.description = std::string(changeItem.description());
+    details.date = std::string(changeItem.date());
+    details.releaseId = std::string(changeItem.releaseId());
+    details.priority = changeItem.priority();
+    details.state = changeItem.state();
+    details.version = changeItem.version();
+    return details;
+}
+
+/**********************************************
+ * Function: updated
+ * Description: Turns the outcome of a compare-and-swap update into a response.
+ **********************************************/
+static ServiceResponse updated(ChangeItem::UpdateResult result, int changeId) {
+    ServiceResponse response;
+    std::string item = "ChangeItem with ID " + std::to_string(changeId);
+    if (result == ChangeItem::UPDATE_CONFLICT)
+        return fail(response, SERVICE_CONFLICT, item + " was changed by another user while you were editing it. "
+                                                       "Nothing was written; please review it and try again.");
+    if (result != ChangeItem::UPDATE_OK)
+        return fail(response, SERVICE_NOT_FOUND, item + " not found.");
+    response.message = item + " has been updated.";
+    return response;
+}
+
+//================================
+// Function implementations
+//================================
+
+/**********************************************
+ * Function: createProduct
+ * Description: Adds a product unless one has the name already.
+ * Parameters:
+ * - request: The product's name
+ * Returns: ServiceResponse - SERVICE_INVALID or SERVICE_DUPLICATE if nothing was written
+ **********************************************/
+ServiceResponse TrackerService::createProduct(const CreateProductRequest& request) {
+    Trace::Span span("service.create_product", "service");
+    ServiceResponse response;
+    if (!validProduct(request.name))
+        return fail(response, SERVICE_INVALID, "Enter a product name of 1 to 10 characters.");
+    std::lock_guard<std::mutex> lock(productLock);
+    if (Product::exists(request.name))
+        return fail(response, SERVICE_DUPLICATE, "The product " + request.name + " already exists.");
+    Product product(request.name.c_str());
+    response.message = "Product created!";
+    return response;
+}
+
+/**********************************************
+ * Function: createRequester
+ * Description: Adds a requester unless one has the email already.
+ * Parameters:
+ * - request: The requester's details
+ * Returns: ServiceResponse - SERVICE_INVALID or SERVICE_DUPLICATE if nothing was written
+ **********************************************/
+ServiceResponse TrackerService::createRequester(const CreateRequesterRequest& request) {
+    Trace::Span span("service.create_requester", "service");
+    ServiceResponse response;
+    if (request.email.empty() || request.email.size() > 24)
+        return fail(response, SERVICE_INVALID, "Enter an email of 1 to 24 characters.");
+    if (request.name.empty() || request.name.size() > 29)
+        return fail(response, SERVICE_INVALID, "Enter a name of 1 to 29 characters.");
+    if (request.phoneNumber.size() > 11)
+        return fail(response, SERVICE_INVALID, "Enter a phone number of 11 digits or less.");
+    if (request.department.size() > 12)
+        return fail(response, SERVICE_INVALID, "Enter a department name of 12 characters or less.");
+    std::lock_guard<std::mutex> lock(requesterLock);
+    if (Requester::exists(request.email))
+        return fail(response, SERVICE_DUPLICATE, "A requester with the email " + request.email + " already exists.");
+    Requester requester(request.name.c_str(), request.phoneNumber.c_str(), request.email.c_str(), request.department.c_str());
+    response.message = "Requester added!";
+    return response;
+}
+
+/**********************************************
+ * Function: createRelease
+ * Description: Adds a release of an existing product.
+ * Parameters:
+ * - request: The product, release ID and release date
+ * Returns: ServiceResponse - SERVICE_DUPLICATE if the product has the release already
+ **********************************************/
+ServiceResponse TrackerService::createRelease(const CreateReleaseRequest& request) {
+    Trace::Span span("service.create_release", "service");
+    ServiceResponse response;
+    if (!validProduct(request.product))
+        return fail(response, SERVICE_INVALID, "Enter a product name of 1 to 10 characters.");
+    if (!validReleaseId(request.releaseId))
+        return fail(response, SERVICE_INVALID, "Enter a release ID of the form X.X.X.X.");
+    if (!validDate(request.date))
+        return fail(response, SERVICE_INVALID, "Enter the release date as YYYY-MM-DD.");
+    if (!productExists(request.product))
+        return fail(response, SERVICE_NOT_FOUND, "The product " + request.product + " does not exist.");
+    ProductRelease release(makeProduct(request.product), request.releaseId.c_str(), request.date.c_str());
+    try {
+        ProductRelease::createProductRelease(release);
+    } catch (const KeyUniquenessException& error) {
+        return fail(response, SERVICE_DUPLICATE, error.what());
+    }
+    response.message = "Product Release created!";
+    return response;
+}
+
+/**********************************************
+ * Function: createRequest
+ * Description:
+ * Records a change request. A request about a new change item creates the
+ * item first, and the item's release if the product does not have it yet; a
+ * request about an existing item must name the item's product.
+ * Parameters:
+ * - request: The request and, for a new item, the item's details
+ * Returns: CreateRequestResponse - The IDs of the request and its change item
+ **********************************************/
+CreateRequestResponse TrackerService::createRequest(const CreateRequestRequest& request) {
+    Trace::Span span("service.create_request", "service");
+    CreateRequestResponse response;
+    if (request.requester.empty() || request.requester.size() > 29)
+        return fail(response, SERVICE_INVALID, "Enter a requester name of 1 to 29 characters.");
+    if (!validProduct(request.product))
+        return fail(response, SERVICE_INVALID, "Enter a product name of 1 to 10 characters.");
+    if (!validDate(request.date))
+        return fail(response, SERVICE_INVALID, "Enter the request date as YYYY-MM-DD.");
+    if (request.changeId < 0) {
+        if (request.description.empty() || request.description.size() > 149)
+            return fail(response, SERVICE_INVALID, "Enter a description of 1 to 149 characters.");
+        if (request.priority < 1 || request.priority > 5)
+            return fail(response, SERVICE_INVALID, "Enter a priority between 1 and 5.");
+        if (request.state < ChangeItem::ASSESSED || request.state > ChangeItem::CANCELLED)
+            return fail(response, SERVICE_INVALID, "Not a valid state.");
+        if (!validReleaseId(request.releaseId))
+            return fail(response, SERVICE_INVALID, "Enter a release ID of the form X.X.X.X.");
+        if (!validDate(request.releaseDate))
+            return fail(response, SERVICE_INVALID, "Enter the release date as YYYY-MM-DD.");
+    }
+    if (!productExists(request.product))
+        return fail(response, SERVICE_NOT_FOUND, "The product " + request.product + " does not exist.");
+    if (!Requester::hasName(request.requester)) // Reads through its own stream
+        return fail(response, SERVICE_NOT_FOUND, "The requester " + request.requester + " does not exist.");
+
+    Product product = makeProduct(request.product);
+    if (request.changeId >= 0) {
+        ChangeItem changeItem;
+        if (!ChangeItem::findChangeItem(request.changeId, changeItem))
+            return fail(response, SERVICE_NOT_FOUND, "ChangeItem with ID " + std::to_string(request.changeId) + " not found.");
+        if (changeItem.getProductName() != request.product)
+            return fail(response, SERVICE_INVALID, "ChangeItem " + std::to_string(request.changeId) + " belongs to " +
+                                                       changeItem.getProductName() + ", not " + request.product + ".");
+        response.changeId = request.changeId;
+    } else {
+        ProductRelease release(product, request.releaseId.c_str(), request.releaseDate.c_str());
+        try {
+            ProductRelease::createProductRelease(release);
+            response.releaseCreated = true;
+        } catch (const KeyUniquenessException&) {
+            // The product has the release already; the item targets it as stored, with its own date
+            if (!ProductRelease::findProductRelease(request.product, request.releaseId, release))
+                return fail(response, SERVICE_NOT_FOUND, "The release " + request.releaseId + " of " + request.product + " could not be read.");
+        }
+        ChangeItem changeItem(product, request.description.c_str(), request.state, request.priority, request.date.c_str(), release);
+        if (!ChangeItem::createChangeItem(changeItem))
+            return fail(response, SERVICE_ERROR, "The change item could not be saved; no change request was recorded.");
+        response.changeId = changeItem.getChangeId();
+        response.itemCreated = true;
+    }
+
+    ChangeRequest changeRequest(request.requester.c_str(), product, request.date.c_str());
+    ChangeRequest::createChangeRequest(changeRequest, response.changeId);
+    response.requestId = changeRequest.getChangeId();
+    response.message = "Change request submitted!";
+    return response;
+}
+
+/**********************************************
+ * Function: viewItem
+ * Description: Reads one change item by its change ID.
+ * Parameters:
+ * - request: The change ID
+ * Returns: ViewItemResponse - The item, or SERVICE_NOT_FOUND
+ **********************************************/
+ViewItemResponse TrackerService::viewItem(const ViewItemRequest& request) {
+    Trace::Span span("service.view_item", "service");
+    ViewItemResponse response;
+    ChangeItem changeItem;
+    if (!ChangeItem::findChangeItem(request.changeId, changeItem))
+        return fail(response, SERVICE_NOT_FOUND, "ChangeItem with ID " + std::to_string(request.changeId) + " not found.");
+    response.item = toDetails(ChangeItemView(changeItem));
+    return response;
+}
+
+/**********************************************
+ * Function: listItems
+ * Description: Reads every change item of a product into the caller's arena, the
+ *              records themselves rather than copies of their fields.
+ * Parameters:
+ * - request: The product
+ * - arena: Holds the items; both vectors share its resource, so the move is free
+ * Returns: ListItemsResponse - The items in file order; none if the product has none
+ **********************************************/
+ListItemsResponse TrackerService::listItems(const ListItemsRequest& request, QueryArena& arena) {
+    Trace::Span span("service.list_items", "service");
+    ListItemsResponse response(arena);
+    if (!validProduct(request.product))
+        return fail(response, SERVICE_INVALID, "Enter a product name of 1 to 10 characters.");
+    response.items = ChangeItem::listChangeItems(request.product, arena);
+    return response;
+}
+
+/**********************************************
+ * Function: updateState
+ * Description: Sets the state of a change item with a compare-and-swap on its version.
+ * Parameters:
+ * - request: The change ID, the new state and the version last seen
+ * Returns: ServiceResponse - SERVICE_CONFLICT if the item was changed meanwhile
+ **********************************************/
+ServiceResponse TrackerService::updateState(const UpdateStateRequest& request) {
+    Trace::Span span("service.update_state", "service");
+    if (request.state < ChangeItem::ASSESSED || request.state > ChangeItem::CANCELLED)
+        return fail(ServiceResponse(), SERVICE_INVALID, "Not a valid state.");
+    return updated(ChangeItem::compareAndSetStatus(request.state, request.changeId, request.expectedVersion), request.changeId);
+}
+
+/**********************************************
+ * Function: updatePriority
+ * Description: Sets the priority of a change item with a compare-and-swap on its version.
+ * Parameters:
+ * - request: The change ID, the new priority and the version last seen
+ * Returns: ServiceResponse - SERVICE_CONFLICT if the item was changed meanwhile
+ **********************************************/
+ServiceResponse TrackerService::updatePriority(const UpdatePriorityRequest& request) {
+    Trace::Span span("service.update_priority", "service");
+    if (request.priority < 1 || request.priority > 5)
+        return fail(ServiceResponse(), SERVICE_INVALID, "Enter a priority between 1 and 5.");
+    return updated(ChangeItem::compareAndSetPriority(request.priority, request.changeId, request.expectedVersion), request.changeId);
+}
+
+/**********************************************
+ * Function: bulkUpdateState
+ * Description: Sets the state of every change item the selection matches, in one commit.
+ * Parameters:
+ * - request: The selection and the new state
+ * Returns: BulkUpdateResponse - The number of items changed
+ **********************************************/
+BulkUpdateResponse TrackerService::bulkUpdateState(const BulkStateRequest& request) {
+    Trace::Span span("service.bulk_update_state", "service");
+    if (!validSelection(request.selection))
+        return fail(BulkUpdateResponse(), SERVICE_INVALID, "Not a valid selection of change items.");
+    if (request.state < ChangeItem::ASSESSED || request.state > ChangeItem::CANCELLED)
+        return fail(BulkUpdateResponse(), SERVICE_INVALID, "Not a valid state.");
+    return bulkUpdated(ChangeItem::bulkSetStatus(request.selection, request.state));
+}
+
+/**********************************************
+ * Function: bulkUpdatePriority
+ * Description: Sets the priority of every change item the selection matches, in one commit.
+ * Parameters:
+ * - request: The selection and the new priority
+ * Returns: BulkUpdateResponse - The number of items changed
+ **********************************************/
+BulkUpdateResponse TrackerService::bulkUpdatePriority(const BulkPriorityRequest& request) {
+    Trace::Span span("service.bulk_update_priority", "service");
+    if (!validSelection(request.selection))
+        return fail(BulkUpdateResponse(), SERVICE_INVALID, "Not a valid selection of change items.");
+    if (request.priority < 1 || request.priority > 5)
+        return fail(BulkUpdateResponse(), SERVICE_INVALID, "Enter a priority between 1 and 5.");
+    return bulkUpdated(ChangeItem::bulkSetPriority(request.selection, request.priority));
+}
+
+/**********************************************
+ * Function: takeItem
+ * Description: Leases the best waiting change item to the holder and moves it to In-Progress.
+ * Parameters:
+ * - request: The product, or none for any, the holder and the lease length
+ * Returns: TakeItemResponse - The lease and the item; SERVICE_NOT_FOUND if nothing is waiting
+ **********************************************/
+TakeItemResponse TrackerService::takeItem(const TakeItemRequest& request) {
+    Trace::Span span("service.take_item", "service");
+    TakeItemResponse response;
+    if (request.product.size() > 10)
+        return fail(response, SERVICE_INVALID, "Enter a product name of 10 characters or less.");
+    if (request.holder.empty() || request.holder.size() > 31)
+        return fail(response, SERVICE_INVALID, "Enter a name of 1 to 31 characters.");
+    if (request.seconds <= 0)
+        return fail(response, SERVICE_INVALID, "A lease must last at least one second.");
+    ChangeItem changeItem;
+    if (!WorkQueue::takeNext(request.product, request.holder, request.seconds, response.lease, changeItem))
+        return fail(response, SERVICE_NOT_FOUND, "No assessed change item is waiting.");
+    response.item = toDetails(ChangeItemView(changeItem));
+    response.message = "You have ChangeItem " + std::to_string(response.item.changeId) + ".";
+    return response;
+}
+
+/**********************************************
+ * Function: renewLease
+ * Description: Extends a lease from now, if it was not reclaimed.
+ * Parameters:
+ * - request: The lease and how long it should last from now
+ * Returns: RenewLeaseResponse - The lease with its new expiry; SERVICE_CONFLICT if it was reclaimed
+ **********************************************/
+RenewLeaseResponse TrackerService::renewLease(const RenewLeaseRequest& request) {
+    Trace::Span span("service.renew_lease", "service");
+    RenewLeaseResponse response;
+    response.lease = request.lease;
+    if (request.seconds <= 0)
+        return fail(response, SERVICE_INVALID, "A lease must last at least one second.");
+    if (!WorkQueue::renew(response.lease, request.seconds))
+        return fail(response, SERVICE_CONFLICT, "Your lease on ChangeItem " + std::to_string(request.lease.changeId) +
+                                                " has run out and was reclaimed.");
+    response.message = "Your lease on ChangeItem " + std::to_string(request.lease.changeId) + " was renewed.";
+    return response;
+}
+
+/**********************************************
+ * Function: finishLease
+ * Description: Ends a lease and sets the state of its change item.
+ * Parameters:
+ * - request: The lease and the item's new state
+ * Returns: ServiceResponse - SERVICE_CONFLICT if the lease was lost or the item was changed meanwhile
+ **********************************************/
+ServiceResponse TrackerService::finishLease(const FinishLeaseRequest& request) {
+    Trace::Span span("service.finish_lease", "service");
+    if (request.state < ChangeItem::ASSESSED || request.state > ChangeItem::CANCELLED)
+        return fail(ServiceResponse(), SERVICE_INVALID, "Not a valid state.");
+    return updated(WorkQueue::finish(request.lease, request.state), request.lease.changeId);
+}
+
+/**********************************************
+ * Function: listRequests
+ * Description: Reads the change requests about a change item, or those of a requester, from the request links.
+ * Parameters:
+ * - request: The change ID, or -1 and the requester's name
+ * Returns: ListRequestsResponse - The requests, oldest first; SERVICE_NOT_FOUND if there are none
+ **********************************************/
+ListRequestsResponse TrackerService::listRequests(const ListRequestsRequest& request) {
+    Trace::Span span("service.list_requests", "service");
+    ListRequestsResponse response;
+    if (request.changeId >= 0) {
+        response.requests = RequestLinks::requestsForItem(request.changeId);
+    } else {
+        if (request.requester.empty() || request.requester.size() > 29)
+            return fail(response, SERVICE_INVALID, "Enter a requester name of 1 to 29 characters.");
+        response.requests = RequestLinks::requestsByRequester(request.requester);
+    }
+    if (response.requests.empty())
+        return fail(response, SERVICE_NOT_FOUND, "No change requests found.");
+    return response;
+}
+
+/**********************************************
+ * Function: mostRequested
+ * Description: Reads the change items with the most requests.
+ * Parameters:
+ * - request: How many change items to return
+ * Returns: MostRequestedResponse - SERVICE_NOT_FOUND if no request is linked to a change item
+ **********************************************/
+MostRequestedResponse TrackerService::mostRequested(const MostRequestedRequest& request) {
+    Trace::Span span("service.most_requested", "service");
+    Metrics::Timer timer(Metrics::REPORT_MOST_REQUESTED);
+    MostRequestedResponse response;
+    if (request.count == 0)
+        return fail(response, SERVICE_INVALID, "Ask for at least one change item.");
+    response.items = RequestLinks::mostRequested(request.count);
+    if (response.items.empty())
+        return fail(response, SERVICE_NOT_FOUND, "No change requests are linked to change items.");
+    return response;
+}
+
+/**********************************************
+ * Function: report
+ * Description:
+ * Reads release readiness from the release index: the counts and postings of
+ * one release, from one fold so they agree, or the counts of every release of
+ * the product.
+ * Parameters:
+ * - request: The product and, optionally, the release
+ * Returns: ReportResponse - SERVICE_NOT_FOUND if no change item targets the release(s)
+ **********************************************/
+ReportResponse TrackerService::report(const ReportRequest& request) {
+    Trace::Span span("service.report", "service");
+    Metrics::Timer timer(Metrics::REPORT_RELEASE_STATUS);
+    ReportResponse response;
+    if (!validProduct(request.product))
+        return fail(response, SERVICE_INVALID, "Enter a product name of 1 to 10 characters.");
+    if (request.releaseId.empty()) {
+        response.releases = ReleaseIndex::releases(request.product);
+        if (response.releases.empty())
+            return fail(response, SERVICE_NOT_FOUND, "No change items of " + request.product + " target a release.");
+        return response;
+    }
+    ReleaseSummary release;
+    if (!ReleaseIndex::detail(request.product, request.releaseId, release, response.items))
+        return fail(response, SERVICE_NOT_FOUND,
+                    "No change items of " + request.product + " target release " + request.releaseId + ".");
+    response.releases.push_back(release);
+    return response;
+}
+
+/**********************************************
+ * Function: products
+ * Description: Lists the product names under the product file's lock.
+ **********************************************/
+std::vector<std::string> TrackerService::products() {
+    std::lock_guard<std::mutex> lock(productLock);
+    return Product::listProducts();
+}
+
+/**********************************************
+ * Function: requesters
+ * Description: Lists the requester names under the requester file's lock.
+ **********************************************/
+std::vector<std::string> TrackerService::requesters() {
+    std::lock_guard<std::mutex> lock(requesterLock);
+    return Requester::listRequesters();
+}
@@ -0,0 +1,298 @@
+/**********************************************
+ * TrackerService Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Described where the item, request and release appends are serialized.
+ * - 2026-10-19: SERVICE_NOT_FOUND also covers an unknown requester.
+ * - 2026-10-19: Added SERVICE_ERROR.
+ * - 2026-10-19: listItems fills an arena the caller holds instead of copying each item's fields.
+ * - 2026-10-19: Release ID fields note the X.X.X.X format.
+ * - 2026-10-19: Added bulk updates, work leases and change request listings.
+ *--------------------------------
+ * Purpose:
+ * This module is the tracker's operations without a console: creating products,
+ * requesters, releases and change requests, viewing and listing change items,
+ * changing the state or priority of one item or of a selection, leasing work
+ * items, listing change requests, and reporting on releases. Each takes a
+ * request struct and returns a response struct carrying a status and a message
+ * fit to show a user, and never reads std::cin or writes std::cout, so the same
+ * operations serve the interactive menus, scripts and benchmarks.
+ *
+ * Requests are checked against the fixed-width record fields before anything is
+ * written. Products and requesters are read through one stream per file shared
+ * between callers, so the operations that use them are serialized per file; change
+ * items, change requests and releases are appended under a lock of their own
+ * module. Lookups, listings, updates and reports read through their own streams
+ * and run concurrently.
+ **********************************************/
+#ifndef TRACKERSERVICE_H
+#define TRACKERSERVICE_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ChangeItem.h"
+#include "ReleaseIndex.h"
+#include "RequestLinks.h"
+#include "WorkQueue.h"
+
+//=============================
+// Record Types
+//=============================
+
+// How a request turned out.
+enum ServiceStatus {
+    SERVICE_OK,
+    SERVICE_INVALID,        // A field is missing, too long or out of range
+    SERVICE_NOT_FOUND,      // The product, requester, change item or release does not exist
+    SERVICE_DUPLICATE,      // The product, requester or release exists already
+    SERVICE_CONFLICT,       // The change item was changed since the caller read it
+    SERVICE_ERROR           // A record could not be written
+};
+
+// The part every response shares.
+struct ServiceResponse {
+    ServiceStatus status = SERVICE_OK;
+    std::string message;    // Why the request failed, or what was done
+
+    bool ok() const { return status == SERVICE_OK; }
+};
+
+// A change item as the service returns it.
+struct ItemDetails {
+    int changeId = -1;
+    std::string product;
+    std::string description;
+    std::string date;           // First reported, YYYY-MM-DD
+    std::string releaseId;      // Anticipated release
+    int priority = 0;
+    ChangeItem::State state = ChangeItem::ASSESSED;
+    int version = 0;            // Pass back as expectedVersion to update only this copy
+};
+
+struct CreateProductRequest {
+    std::string name;           // At most 10 characters
+};
+
+struct CreateRequesterRequest {
+    std::string name;           // At most 29 characters, so it fits a change request
+    std::string phoneNumber;    // At most 11 digits
+    std::string email;          // At most 24 characters, unique
+    std::string department;     // At most 12 characters, may be empty
+};
+
+struct CreateReleaseRequest {
+    std::string product;
+    std::string releaseId;      // X.X.X.X, one digit each
+    std::string date;           // YYYY-MM-DD
+};
+
+// A change request about an existing change item, or about a new one described by the item fields.
+struct CreateRequestRequest {
+    std::string requester;      // The requester's name, at most 29 characters
+    std::string product;
+    std::string date;           // YYYY-MM-DD
+    int changeId = -1;          // The change item the request is about, or -1 to create one
+
+    // The new change item, used when changeId is -1
+    std::string description;    // At most 149 characters
+    int priority = 3;           // 1 to 5
+    ChangeItem::State state = ChangeItem::ASSESSED;
+    std::string releaseId;      // X.X.X.X; created for the product if it does not exist
+    std::string releaseDate;    // YYYY-MM-DD, used if the release is created
+};
+
+struct CreateRequestResponse : ServiceResponse {
+    int requestId = -1;
+    int changeId = -1;          // The change item the request was linked to
+    bool itemCreated = false;
+    bool releaseCreated = false;
+};
+
+struct ViewItemRequest {
+    int changeId = -1;
+};
+
+struct ViewItemResponse : ServiceResponse {
+    ItemDetails item;
+};
+
+struct ListItemsRequest {
+    std::string product;
+};
+
+struct ListItemsResponse : ServiceResponse {
+    explicit ListItemsResponse(QueryArena& arena) : items(arena.vector<ChangeItem>()) {}
+    ArenaVector<ChangeItem> items;      // In file order, archived items included; read through ChangeItemView
+};
+
+struct UpdateStateRequest {
+    int changeId = -1;
+    ChangeItem::State state = ChangeItem::ASSESSED;
+    int expectedVersion = ChangeItem::ANY_VERSION;
+};
+
+struct UpdatePriorityRequest {
+    int changeId = -1;
+    int priority = 0;
+    int expectedVersion = ChangeItem::ANY_VERSION;
+};
+
+struct ReportRequest {
+    std::string product;
+    std::string releaseId;      // Empty for every release of the product
+};
+
+struct ReportResponse : ServiceResponse {
+    std::vector<ReleaseSummary> releases;   // The release asked for, or every release of the product
+    std::vector<ReleasePosting> items;      // The change items of the release; empty without a release ID
+};
+
+struct BulkStateRequest {
+    ChangeItem::Selection selection;    // The fields left at their defaults match any item
+    ChangeItem::State state = ChangeItem::ASSESSED;
+};
+
+struct BulkPriorityRequest {
+    ChangeItem::Selection selection;    // The fields left at their defaults match any item
+    int priority = 0;
+};
+
+struct BulkUpdateResponse : ServiceResponse {
+    int updated = 0;                    // The change items changed
+};
+
+struct TakeItemRequest {
+    std::string product;                // Empty to take from any product
+    std::string holder;                 // Who takes the item, at most 31 characters
+    int seconds = DEFAULT_LEASE_SECONDS;
+};
+
+struct TakeItemResponse : ServiceResponse {
+    WorkLease lease;                    // Pass back to renewLease and finishLease
+    ItemDetails item;                   // As it is after it was taken
+};
+
+struct RenewLeaseRequest {
+    WorkLease lease;
+    int seconds = DEFAULT_LEASE_SECONDS;
+};
+
+struct RenewLeaseResponse : ServiceResponse {
+    WorkLease lease;                    // With its new expiry
+};
+
+struct FinishLeaseRequest {
+    WorkLease lease;
+    ChangeItem::State state = ChangeItem::DONE;     // ASSESSED hands the item back
+};
+
+// The requests about one change item, or those of one requester.
+struct ListRequestsRequest {
+    int changeId = -1;                  // Used if it is not -1
+    std::string requester;              // Used otherwise, at most 29 characters
+};
+
+struct ListRequestsResponse : ServiceResponse {
+    std::vector<LinkedRequest> requests;    // Oldest first
+};
+
+struct MostRequestedRequest {
+    size_t count = 10;
+};
+
+struct MostRequestedResponse : ServiceResponse {
+    std::vector<std::pair<int, int>> items; // (change ID, requests), most requested first
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class TrackerService {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static ServiceResponse createProduct(const CreateProductRequest& request);
+    // Description: Adds a product.
+    // Returns: ServiceResponse - SERVICE_DUPLICATE if a product has the name.
+
+    //----------------------------------------------------------
+    static ServiceResponse createRequester(const CreateRequesterRequest& request);
+    // Description: Adds a requester.
+    // Returns: ServiceResponse - SERVICE_DUPLICATE if a requester has the email.
+
+    //----------------------------------------------------------
+    static ServiceResponse createRelease(const CreateReleaseRequest& request);
+    // Description: Adds a release of an existing product.
+    // Returns: ServiceResponse - SERVICE_DUPLICATE if the product has the release already.
+
+    //----------------------------------------------------------
+    static CreateRequestResponse createRequest(const CreateRequestRequest& request);
+    // Description: Records a change request, first creating its change item and the item's release
+    //              if the request is about a new item.
+    // Returns: CreateRequestResponse - The IDs of the request and of its change item; SERVICE_NOT_FOUND
+    //          if no requester has the name.
+
+    //----------------------------------------------------------
+    static ViewItemResponse viewItem(const ViewItemRequest& request);
+    // Description: Reads one change item, archived or not.
+
+    //----------------------------------------------------------
+    static ListItemsResponse listItems(const ListItemsRequest& request, QueryArena& arena);
+    // Description: Reads every change item of a product into the caller's arena, so the
+    //              items live until the arena is reset or destroyed.
+
+    //----------------------------------------------------------
+    static ServiceResponse updateState(const UpdateStateRequest& request);
+    static ServiceResponse updatePriority(const UpdatePriorityRequest& request);
+    // Description: Sets the state (priority) of a change item, unless it no longer carries expectedVersion.
+    // Returns: ServiceResponse - SERVICE_CONFLICT if another writer changed the item first.
+
+    //----------------------------------------------------------
+    static BulkUpdateResponse bulkUpdateState(const BulkStateRequest& request);
+    static BulkUpdateResponse bulkUpdatePriority(const BulkPriorityRequest& request);
+    // Description: Sets the state (priority) of every change item the selection matches, as one commit.
+    // Returns: BulkUpdateResponse - The number of items changed, which may be none.
+
+    //----------------------------------------------------------
+    static TakeItemResponse takeItem(const TakeItemRequest& request);
+    // Description: Leases the best ASSESSED change item, of one product or of any, and moves it to In-Progress.
+    // Returns: TakeItemResponse - SERVICE_NOT_FOUND if no item is waiting.
+
+    //----------------------------------------------------------
+    static RenewLeaseResponse renewLease(const RenewLeaseRequest& request);
+    // Description: Makes a lease last another request.seconds from now.
+    // Returns: RenewLeaseResponse - SERVICE_CONFLICT if the lease ran out and was reclaimed.
+
+    //----------------------------------------------------------
+    static ServiceResponse finishLease(const FinishLeaseRequest& request);
+    // Description: Ends a lease and sets the item's state.
+    // Returns: ServiceResponse - SERVICE_CONFLICT if the lease was lost or the item changed meanwhile.
+
+    //----------------------------------------------------------
+    static ListRequestsResponse listRequests(const ListRequestsRequest& request);
+    // Description: Reads the change requests about a change item, or those a requester made, through their links.
+    // Returns: ListRequestsResponse - SERVICE_NOT_FOUND if there are none.
+
+    //----------------------------------------------------------
+    static MostRequestedResponse mostRequested(const MostRequestedRequest& request);
+    // Description: Reads the change items with the most requests from the per-item counts.
+    // Returns: MostRequestedResponse - SERVICE_NOT_FOUND if no request is linked to a change item.
+
+    //----------------------------------------------------------
+    static ReportResponse report(const ReportRequest& request);
+    // Description: Reads the readiness of a release, or of every release of a product, from the release index.
+    // Returns: ReportResponse - SERVICE_NOT_FOUND if no change item targets the release.
+
+    //----------------------------------------------------------
+    static std::vector<std::string> products();
+    static std::vector<std::string> requesters();
+    // Description: Return the names of the products (requesters) in the order they were added.
+};
+
+#endif // TRACKERSERVICE_H
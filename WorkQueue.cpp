@@ -0,0 +1,650 @@
+/**********************************************
+ * WorkQueue Implementation File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Operations timed for the metrics endpoint.
+ *--------------------------------
+ * Purpose:
+ * This module implements the work queue. The waiting items of each product are an
+ * ordered set of (priority, change ID) guarded by a mutex of that product alone;
+ * the set's first key is also kept in an atomic, so a taker of any product picks
+ * the product to lock by comparing those keys without locking anything. Only the
+ * pop happens under the product's lock: reading the record, writing the lease
+ * slot and the compare-and-swap all happen after it is released.
+ *
+ * ChangeItem.lease, both header and slots:
+ *
+ *     Header (64 bytes): magic "ITRKLEAS", earliest expiry of any lease (0: none)
+ *     Slot (64 bytes):   change ID, item version, expiry (0: free), holder, product
+ *
+ * The header's bytes are the lease table's lock. The earliest expiry may be
+ * earlier than any lease still held (after a renewal or a finish) but never later,
+ * so a taker reads it without the lock and only locks the table and looks for
+ * leases to reclaim once it has passed.
+ **********************************************/
+#include "WorkQueue.h"
+#include "ChangeFeed.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "Metrics.h"
+#include "StorageLayout.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+//================================
+// Constants
+//================================
+static const char LEASE_MAGIC[8] = {'I', 'T', 'R', 'K', 'L', 'E', 'A', 'S'};
+static const size_t FOLD_CHUNK_EVENTS = 4096;      // Feed events read per step while folding
+static const size_t BUILD_CHUNK_RECORDS = 4096;    // Records read per step while building the sets
+static const uint64_t NO_KEY = UINT64_MAX;         // The best key of a product with nothing waiting
+
+//================================
+// Record Types
+//================================
+
+// The first 64 bytes of ChangeItem.lease.
+struct LeaseHeader {
+    char magic[8];
+    int64_t earliest;       // No lease expires before this; 0 if none is held
+    char unused[48];
+};
+static_assert(sizeof(LeaseHeader) == 64, "The lease header is 64 bytes");
+
+// One lease, as stored.
+struct LeaseSlot {
+    int32_t changeId;
+    int32_t version;        // The item's version after it was taken
+    int64_t expires;        // Seconds since the epoch; 0 marks a free slot
+    char holder[32];
+    char product[16];
+};
+static_assert(sizeof(LeaseSlot) == 64, "Lease slots are 64 bytes");
+
+// The waiting items of one product.
+struct ProductQueue {
+    std::mutex lock;
+    std::set<std::pair<int, int>> waiting;          // (priority, change ID), best first
+    std::unordered_map<int, int> priorities;        // The priority each waiting change ID is filed under
+    std::atomic<uint64_t> best{NO_KEY};             // Key of the first waiting item, read without the lock
+
+    // Called with the lock held after every change to waiting.
+    void publish() {
+        best.store(waiting.empty() ? NO_KEY
+                                   : static_cast<uint64_t>(waiting.begin()->first) << 32 | static_cast<uint32_t>(waiting.begin()->second),
+                   std::memory_order_release);
+    }
+};
+
+//================================
+// Static Variables
+//================================
+static std::shared_mutex queuesLock;                                // Guards the map; queues are never removed
+static std::map<std::string, std::unique_ptr<ProductQueue>> queues;
+static std::mutex foldLock;                                         // One thread builds or folds at a time
+static std::atomic<long long> folded(-1);                           // The feed sequence to fold from next; -1 before the build
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: now
+ * Description: Returns the current time in seconds since the epoch.
+ **********************************************/
+static long long now() {
+    return static_cast<long long>(std::time(nullptr));
+}
+
+/**********************************************
+ * Function: fixedText
+ * Description: Returns the text of a fixed-width field that may not be terminated.
+ **********************************************/
+static std::string fixedText(const char* field, size_t size) {
+    return std::string(field, strnlen(field, size));
+}
+
+/**********************************************
+ * Function: queueOf
+ * Description: Returns the queue of a product, creating it if create is set.
+ * Returns: ProductQueue* - nullptr if the product has no queue and create is not set.
+ **********************************************/
+static ProductQueue* queueOf(const std::string& product, bool create) {
+    {
+        std::shared_lock<std::shared_mutex> guard(queuesLock);
+        auto found = queues.find(product);
+        if (found != queues.end())
+            return found->second.get();
+    }
+    if (!create)
+        return nullptr;
+    std::unique_lock<std::shared_mutex> guard(queuesLock);
+    std::unique_ptr<ProductQueue>& queue = queues[product];
+    if (!queue)
+        queue = std::make_unique<ProductQueue>();
+    return queue.get();
+}
+
+/**********************************************
+ * Function: fileItem
+ * Description: Files a waiting item under its priority, moving it if it was
+ *              filed under another one.
+ **********************************************/
+static void fileItem(const std::string& product, int changeId, int priority) {
+    ProductQueue* queue = queueOf(product, true);
+    std::lock_guard<std::mutex> guard(queue->lock);
+    auto filed = queue->priorities.find(changeId);
+    if (filed != queue->priorities.end()) {
+        if (filed->second == priority)
+            return;
+        queue->waiting.erase({filed->second, changeId});
+    }
+    queue->priorities[changeId] = priority;
+    queue->waiting.insert({priority, changeId});
+    queue->publish();
+}
+
+/**********************************************
+ * Function: unfileItem
+ * Description: Removes an item that is no longer waiting.
+ **********************************************/
+static void unfileItem(const std::string& product, int changeId) {
+    ProductQueue* queue = queueOf(product, false);
+    if (queue == nullptr)
+        return;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    auto filed = queue->priorities.find(changeId);
+    if (filed == queue->priorities.end())
+        return;
+    queue->waiting.erase({filed->second, changeId});
+    queue->priorities.erase(filed);
+    queue->publish();
+}
+
+/**********************************************
+ * Function: popBest
+ * Description: Removes the first waiting item of a queue.
+ * Returns: bool - False if nothing was waiting.
+ **********************************************/
+static bool popBest(ProductQueue& queue, int& changeId, int& priority) {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.waiting.empty())
+        return false;
+    priority = queue.waiting.begin()->first;
+    changeId = queue.waiting.begin()->second;
+    queue.waiting.erase(queue.waiting.begin());
+    queue.priorities.erase(changeId);
+    queue.publish();
+    return true;
+}
+
+/**********************************************
+ * Function: popNext
+ * Description:
+ * Removes the best waiting item of a product, or of all products. For all, the
+ * queue with the best published key is locked; if another taker emptied it
+ * meanwhile, the keys are compared again.
+ * Returns: bool - False if nothing is waiting.
+ **********************************************/
+static bool popNext(const std::string& product, int& changeId, int& priority) {
+    if (!product.empty()) {
+        ProductQueue* queue = queueOf(product, false);
+        return queue != nullptr && popBest(*queue, changeId, priority);
+    }
+    for (;;) {
+        ProductQueue* bestQueue = nullptr;
+        uint64_t bestKey = NO_KEY;
+        {
+            std::shared_lock<std::shared_mutex> guard(queuesLock);
+            for (const auto& [name, queue] : queues) {
+                uint64_t key = queue->best.load(std::memory_order_acquire);
+                if (key < bestKey) {
+                    bestKey = key;
+                    bestQueue = queue.get();
+                }
+            }
+        }
+        if (bestQueue == nullptr)
+            return false;
+        if (popBest(*bestQueue, changeId, priority))
+            return true;
+    }
+}
+
+/**********************************************
+ * Function: applyEvent
+ * Description: Files or unfiles a change item according to its state after a feed event.
+ **********************************************/
+static void applyEvent(const FeedEvent& event) {
+    std::string product = fixedText(event.product, sizeof(event.product));
+    if (event.state == ChangeItem::ASSESSED)
+        fileItem(product, event.changeId, event.priority);
+    else
+        unfileItem(product, event.changeId);
+}
+
+/**********************************************
+ * Function: build
+ * Description:
+ * Files every ASSESSED item of the segments; archives hold only closed items.
+ * Called with foldLock held. The feed position is noted before the records are
+ * read, so the next fold repeats, at worst, events the records already showed.
+ **********************************************/
+static void build() {
+    {
+        std::shared_lock<std::shared_mutex> guard(queuesLock);
+        for (const auto& [name, queue] : queues) {
+            std::lock_guard<std::mutex> queueGuard(queue->lock);
+            queue->waiting.clear();
+            queue->priorities.clear();
+            queue->publish();
+        }
+    }
+    long long from = ChangeFeed::endSequence();
+    std::vector<ChangeItem> chunk(BUILD_CHUNK_RECORDS);
+    for (const std::string& segment : StorageLayout::itemSegments()) {
+        VersionedReader reader(segment);
+        std::ifstream infile(segment, std::ios::binary);
+        while (reader.usable()) {
+            size_t count = reader.read(infile, reinterpret_cast<char*>(chunk.data()), chunk.size());
+            for (size_t i = 0; i < count; i++) {
+                if (chunk[i].getState() == ChangeItem::ASSESSED)
+                    fileItem(chunk[i].getProductName(), chunk[i].getChangeId(), chunk[i].getPriority());
+            }
+            if (!infile)
+                break;
+        }
+    }
+    folded.store(from);
+}
+
+/**********************************************
+ * Function: fold
+ * Description: Applies the change item events appended to the feed since the last
+ *              fold, or builds the sets if there was none or the feed was replaced.
+ *              Called with foldLock held.
+ **********************************************/
+static void fold() {
+    long long end = ChangeFeed::endSequence();
+    long long next = folded.load();
+    if (next < 0 || next > end) {
+        build();
+        return;
+    }
+
+    FeedFilter filter;
+    filter.entity = FeedEvent::CHANGE_ITEM;
+    std::vector<FeedEvent> events;
+    while (next < end) {
+        events.clear();
+        long long after = ChangeFeed::read(next, filter, FOLD_CHUNK_EVENTS, events);
+        for (const FeedEvent& event : events) {
+            if (event.sequence >= end)
+                break;
+            applyEvent(event);
+        }
+        if (after <= next)
+            break;
+        next = std::min(after, end);
+    }
+    folded.store(next);
+}
+
+/**********************************************
+ * Function: refresh
+ * Description:
+ * Brings the sets up to the feed. A taker that finds another thread folding does
+ * not wait for it unless wait is set: the record is checked before every swap
+ * anyway, and a taker that finds nothing folds again with wait set.
+ **********************************************/
+static void refresh(bool wait) {
+    if (folded.load() >= 0 && ChangeFeed::endSequence() <= folded.load())
+        return;
+    std::unique_lock<std::mutex> guard(foldLock, std::defer_lock);
+    if (wait || folded.load() < 0)
+        guard.lock();
+    else if (!guard.try_lock())
+        return;
+    fold();
+}
+
+/**********************************************
+ * Function: readTable
+ * Description: Reads the lease header and every slot. A missing or empty file
+ *              holds no leases.
+ **********************************************/
+static void readTable(LeaseHeader& header, std::vector<LeaseSlot>& slots) {
+    std::memset(&header, 0, sizeof(header));
+    slots.clear();
+    std::ifstream in(LEASE_FILE, std::ios::binary);
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, LEASE_MAGIC, sizeof(LEASE_MAGIC)) != 0) {
+        std::memset(&header, 0, sizeof(header));
+        return;
+    }
+    LeaseSlot slot;
+    while (in.read(reinterpret_cast<char*>(&slot), sizeof(slot)))
+        slots.push_back(slot);
+}
+
+/**********************************************
+ * Function: writeTable
+ * Description: Writes the header and, if index is not negative, one slot.
+ *              Called with the table lock held.
+ **********************************************/
+static bool writeTable(LeaseHeader& header, long long index, const LeaseSlot* slot) {
+    std::fstream out(LEASE_FILE, std::ios::in | std::ios::out | std::ios::binary);
+    if (!out.is_open())
+        return false;
+    std::memcpy(header.magic, LEASE_MAGIC, sizeof(LEASE_MAGIC));
+    if (index >= 0) {
+        out.seekp(static_cast<std::streamoff>(sizeof(LeaseHeader) + index * sizeof(LeaseSlot)));
+        out.write(reinterpret_cast<const char*>(slot), sizeof(LeaseSlot));
+    }
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(out);
+}
+
+/**********************************************
+ * Function: findSlot
+ * Description: Returns the index of the slot holding a lease, or -1.
+ **********************************************/
+static long long findSlot(const std::vector<LeaseSlot>& slots, int changeId, int version) {
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].expires != 0 && slots[i].changeId == changeId && slots[i].version == version)
+            return static_cast<long long>(i);
+    }
+    return -1;
+}
+
+/**********************************************
+ * Function: addLease
+ * Description: Writes a lease into the first free slot and lowers the earliest expiry.
+ * Returns: bool - False if the lease file could not be locked or written.
+ **********************************************/
+static bool addLease(const WorkLease& lease) {
+    RecordLock tableLock(LEASE_FILE, 0, sizeof(LeaseHeader), true);
+    if (!tableLock.isLocked())
+        return false;
+    LeaseHeader header;
+    std::vector<LeaseSlot> slots;
+    readTable(header, slots);
+    size_t index = 0;
+    while (index < slots.size() && slots[index].expires != 0)
+        index++;
+
+    LeaseSlot slot{};
+    slot.changeId = lease.changeId;
+    slot.version = lease.version;
+    slot.expires = lease.expires;
+    std::strncpy(slot.holder, lease.holder.c_str(), sizeof(slot.holder) - 1);
+    std::strncpy(slot.product, lease.product.c_str(), sizeof(slot.product) - 1);
+    if (header.earliest == 0 || lease.expires < header.earliest)
+        header.earliest = lease.expires;
+    return writeTable(header, static_cast<long long>(index), &slot);
+}
+
+/**********************************************
+ * Function: dropLease
+ * Description: Frees the slot of a lease whose swap did not go through.
+ **********************************************/
+static void dropLease(const WorkLease& lease) {
+    RecordLock tableLock(LEASE_FILE, 0, sizeof(LeaseHeader), true);
+    LeaseHeader header;
+    std::vector<LeaseSlot> slots;
+    readTable(header, slots);
+    long long index = findSlot(slots, lease.changeId, lease.version);
+    if (index >= 0) {
+        LeaseSlot freed{};
+        writeTable(header, index, &freed);
+    }
+}
+
+//================================
+// Function Implementations
+//================================
+
+/**********************************************
+ * Function: takeNext
+ * Description:
+ * Pops the best waiting item and checks it against its record: an item that is no
+ * longer ASSESSED is dropped, and one whose priority changed is filed again under
+ * the new one, since it may no longer be the best. Otherwise the lease slot is
+ * written with the version the swap will produce, and the item is swapped to
+ * INPROGRESS. A taker that loses the swap to another writer frees its slot and
+ * files the item again to look at it afresh.
+ * Parameters:
+ * - product: The product to take work from, or empty for any
+ * - holder: Who takes the item
+ * - seconds: How long the lease lasts unless renewed
+ * - lease, changeItem: Receive the lease and the item after the move
+ * Returns: bool - False if no ASSESSED item is waiting
+ **********************************************/
+bool WorkQueue::takeNext(const std::string& product, const std::string& holder, int seconds, WorkLease& lease,
+                         ChangeItem& changeItem) {
+    Metrics::Timer timer(Metrics::WORK_TAKE);
+    reclaimExpired();
+    refresh(false);
+    bool refolded = false;
+    for (;;) {
+        int changeId;
+        int priority;
+        if (!popNext(product, changeId, priority)) {
+            if (refolded)
+                return false;
+            refresh(true); // Another thread may have been folding in the items still missing
+            refolded = true;
+            continue;
+        }
+
+        ChangeItem current;
+        if (!ChangeItem::findChangeItem(changeId, current) || current.getState() != ChangeItem::ASSESSED)
+            continue;
+        if (current.getPriority() != priority) {
+            fileItem(current.getProductName(), changeId, current.getPriority());
+            continue;
+        }
+
+        lease.changeId = changeId;
+        lease.version = (current.getVersion() + 1) & 0xFFFF;
+        lease.expires = now() + std::clamp(seconds, 1, MAX_LEASE_SECONDS);
+        lease.holder = holder;
+        lease.product = current.getProductName();
+        if (!addLease(lease)) {
+            std::cerr << "Failed to write " << LEASE_FILE << "." << std::endl;
+            fileItem(lease.product, changeId, priority);
+            return false;
+        }
+        ChangeItem::UpdateResult result = ChangeItem::compareAndSetStatus(ChangeItem::INPROGRESS, changeId, current.getVersion());
+        if (result == ChangeItem::UPDATE_OK) {
+            if (!ChangeItem::findChangeItem(changeId, changeItem))
+                changeItem = current;
+            return true;
+        }
+        dropLease(lease);
+        if (result == ChangeItem::UPDATE_CONFLICT)
+            fileItem(lease.product, changeId, priority);
+    }
+}
+
+/**********************************************
+ * Function: renew
+ * Description: Moves the expiry of a lease that is still held to seconds from now.
+ * Returns: bool - False if the lease was reclaimed or finished
+ **********************************************/
+bool WorkQueue::renew(WorkLease& lease, int seconds) {
+    RecordLock tableLock(LEASE_FILE, 0, sizeof(LeaseHeader), true);
+    if (!tableLock.isLocked())
+        return false;
+    LeaseHeader header;
+    std::vector<LeaseSlot> slots;
+    readTable(header, slots);
+    long long index = findSlot(slots, lease.changeId, lease.version);
+    if (index < 0)
+        return false;
+    LeaseSlot slot = slots[index];
+    slot.expires = now() + std::clamp(seconds, 1, MAX_LEASE_SECONDS);
+    if (!writeTable(header, index, &slot))
+        return false;
+    lease.expires = slot.expires;
+    return true;
+}
+
+/**********************************************
+ * Function: finish
+ * Description:
+ * Frees the lease's slot and sets the item's state in one step under the table
+ * lock, so a reclaim cannot move the item back in between. The swap expects the
+ * version the lease was taken with: if anyone changed the item meanwhile, the
+ * change stands and the lease simply ends.
+ * Returns: UpdateResult - UPDATE_CONFLICT if the lease was lost or the item changed
+ **********************************************/
+ChangeItem::UpdateResult WorkQueue::finish(const WorkLease& lease, ChangeItem::State state) {
+    Metrics::Timer timer(Metrics::WORK_FINISH);
+    RecordLock tableLock(LEASE_FILE, 0, sizeof(LeaseHeader), true);
+    if (!tableLock.isLocked())
+        return ChangeItem::UPDATE_CONFLICT;
+    LeaseHeader header;
+    std::vector<LeaseSlot> slots;
+    readTable(header, slots);
+    long long index = findSlot(slots, lease.changeId, lease.version);
+    if (index < 0)
+        return ChangeItem::UPDATE_CONFLICT;
+    ChangeItem::UpdateResult result = ChangeItem::compareAndSetStatus(state, lease.changeId, lease.version);
+    LeaseSlot freed{};
+    writeTable(header, index, &freed);
+    return result;
+}
+
+/**********************************************
+ * Function: reclaimExpired
+ * Description:
+ * Returns at once unless the header's earliest expiry has passed. Otherwise every
+ * lease that ran out is freed and its item swapped back to ASSESSED with the
+ * lease's version, which fails harmlessly if the item was changed since or the
+ * taker never got to swap it. The earliest expiry is then set from the leases left.
+ * Returns: int - The number of items moved back
+ **********************************************/
+int WorkQueue::reclaimExpired() {
+    long long current = now();
+    {
+        LeaseHeader header;
+        std::ifstream in(LEASE_FILE, std::ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.earliest == 0 || header.earliest > current)
+            return 0;
+    }
+
+    RecordLock tableLock(LEASE_FILE, 0, sizeof(LeaseHeader), true);
+    if (!tableLock.isLocked())
+        return 0;
+    LeaseHeader header;
+    std::vector<LeaseSlot> slots;
+    readTable(header, slots);
+    int reclaimed = 0;
+    long long earliest = 0;
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].expires == 0)
+            continue;
+        if (slots[i].expires > current) {
+            if (earliest == 0 || slots[i].expires < earliest)
+                earliest = slots[i].expires;
+            continue;
+        }
+        if (ChangeItem::compareAndSetStatus(ChangeItem::ASSESSED, slots[i].changeId, slots[i].version) == ChangeItem::UPDATE_OK)
+            reclaimed++;
+        LeaseSlot freed{};
+        writeTable(header, static_cast<long long>(i), &freed);
+    }
+    header.earliest = earliest;
+    writeTable(header, -1, nullptr);
+    return reclaimed;
+}
+
+/**********************************************
+ * Function: leases
+ * Description: Reads the leases held under a shared table lock.
+ * Returns: std::vector<WorkLease> - The leases, soonest to expire first
+ **********************************************/
+std::vector<WorkLease> WorkQueue::leases() {
+    RecordLock tableLock(LEASE_FILE, 0, sizeof(LeaseHeader), false);
+    LeaseHeader header;
+    std::vector<LeaseSlot> slots;
+    readTable(header, slots);
+    std::vector<WorkLease> held;
+    for (const LeaseSlot& slot : slots) {
+        if (slot.expires == 0)
+            continue;
+        WorkLease lease;
+        lease.changeId = slot.changeId;
+        lease.version = slot.version;
+        lease.expires = slot.expires;
+        lease.holder = fixedText(slot.holder, sizeof(slot.holder));
+        lease.product = fixedText(slot.product, sizeof(slot.product));
+        held.push_back(lease);
+    }
+    std::sort(held.begin(), held.end(), [](const WorkLease& a, const WorkLease& b) { return a.expires < b.expires; });
+    return held;
+}
+
+/**********************************************
+ * Function: waiting
+ * Description: Counts the items waiting after folding in the feed.
+ * Returns: size_t - The number of items waiting, of product or of all if it is empty
+ **********************************************/
+size_t WorkQueue::waiting(const std::string& product) {
+    refresh(true);
+    size_t count = 0;
+    std::shared_lock<std::shared_mutex> guard(queuesLock);
+    for (const auto& [name, queue] : queues) {
+        if (!product.empty() && name != product)
+            continue;
+        std::lock_guard<std::mutex> queueGuard(queue->lock);
+        count += queue->waiting.size();
+    }
+    return count;
+}
+
+/**********************************************
+ * Function: printLeases
+ * Description: Reclaims the leases that ran out, then prints one line per lease
+ *              held and the number of items waiting.
+ * Parameters:
+ * - out: The stream to print to
+ * Returns: int - The process exit status
+ **********************************************/
+int WorkQueue::printLeases(std::ostream& out) {
+    int reclaimed = reclaimExpired();
+    if (reclaimed > 0)
+        out << reclaimed << " change items whose lease ran out are waiting again." << std::endl;
+    std::vector<WorkLease> held = leases();
+    long long current = now();
+    if (held.empty()) {
+        out << "No change item is leased." << std::endl;
+    } else {
+        out << std::left << std::setw(11) << "Change ID" << std::setw(12) << "Product" << std::setw(33) << "Holder"
+            << "Expires in" << std::endl;
+        for (const WorkLease& lease : held) {
+            out << std::setw(11) << lease.changeId << std::setw(12) << lease.product << std::setw(33) << lease.holder;
+            if (lease.expires > current)
+                out << lease.expires - current << " s" << std::endl;
+            else
+                out << "ran out" << std::endl;
+        }
+        out << std::right;
+    }
+    out << waiting("") << " change items are waiting to be taken." << std::endl;
+    return 0;
+}
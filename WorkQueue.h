@@ -0,0 +1,110 @@
+/**********************************************
+ * WorkQueue Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ *--------------------------------
+ * Purpose:
+ * This module hands out work: the next work item is the ASSESSED change item with
+ * the best priority (1 first, then the lowest change ID), optionally of one
+ * product. Taking it moves the item to INPROGRESS and gives the taker a lease
+ * that runs out unless it is renewed; an item whose lease ran out goes back to
+ * ASSESSED for the next taker. Two takers never get the same item, because the
+ * move to INPROGRESS is a compare-and-swap on the item's version, and the version
+ * the swap produced identifies the lease from then on.
+ *
+ * Each process keeps the waiting items in memory, one ordered set per product,
+ * so finding the next item costs O(log n) under the lock of one product only;
+ * a taker of any product compares the products' best keys, which are published
+ * without a lock. The sets are built from the item segments once and then kept
+ * current from the change feed, like the release index, so items created,
+ * leased or changed by other processes show up after the next fold. Whatever
+ * the set says is checked against the record before the swap.
+ *
+ * Leases are kept in ChangeItem.lease so that every process sees them: a header
+ * with the earliest expiry, then one 64-byte slot per lease. The slot is written
+ * before the item is swapped, so a taker that crashes in between leaves only a
+ * slot that expires, never an INPROGRESS item nobody holds a lease on.
+ **********************************************/
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ChangeItem.h"
+
+//=============================
+// Constants
+//=============================
+const char* const LEASE_FILE = "ChangeItem.lease";
+const int DEFAULT_LEASE_SECONDS = 900;          // Lease length when the taker does not ask for one
+const int MAX_LEASE_SECONDS = 7 * 24 * 3600;    // Longest lease handed out or renewed
+
+//=============================
+// Record Types
+//=============================
+
+// A change item held by one taker.
+struct WorkLease {
+    int changeId = -1;
+    int version = 0;            // The item's version after it was taken; identifies the lease
+    long long expires = 0;      // Seconds since the epoch
+    std::string holder;
+    std::string product;
+};
+
+//=============================
+// Class Declaration
+//=============================
+
+class WorkQueue {
+public:
+    //=============================
+    // Function Declarations
+    //=============================
+
+    //----------------------------------------------------------
+    static bool takeNext(const std::string& product, const std::string& holder, int seconds, WorkLease& lease,
+                         ChangeItem& changeItem);
+    // Description: Leases the best waiting change item of product, or of any product if product is
+    //              empty, and moves it to INPROGRESS. Leases that ran out are reclaimed first.
+    // Parameters:
+    // - product: The product to take work from, or empty for any.
+    // - holder: Who takes the item; kept with the lease.
+    // - seconds: How long the lease lasts unless renewed.
+    // - lease, changeItem: Receive the lease and the item as it is after the move.
+    // Returns: bool - False if no ASSESSED item is waiting.
+
+    //----------------------------------------------------------
+    static bool renew(WorkLease& lease, int seconds);
+    // Description: Makes the lease last another seconds from now. A lease that ran out can still be
+    //              renewed until it is reclaimed.
+    // Returns: bool - False if the lease was reclaimed or finished.
+
+    //----------------------------------------------------------
+    static ChangeItem::UpdateResult finish(const WorkLease& lease, ChangeItem::State state);
+    // Description: Ends the lease and sets the item's state, e.g. DONE, or ASSESSED to hand it back.
+    // Returns: UpdateResult - UPDATE_CONFLICT if the lease was lost or the item was changed meanwhile.
+
+    //----------------------------------------------------------
+    static int reclaimExpired();
+    // Description: Ends every lease that ran out and moves its item back to ASSESSED, unless the item
+    //              was changed since it was taken. Costs one read of the lease file header when no
+    //              lease has run out.
+    // Returns: int - The number of items moved back.
+
+    //----------------------------------------------------------
+    static std::vector<WorkLease> leases();
+    // Description: Returns the leases held, soonest to expire first.
+
+    //----------------------------------------------------------
+    static size_t waiting(const std::string& product);
+    // Description: Returns the number of change items waiting to be taken, of one product or of all.
+
+    //----------------------------------------------------------
+    static int printLeases(std::ostream& out);
+    // Description: Reclaims the leases that ran out, then lists those held and the items waiting.
+    // Returns: int - The process exit status.
+};
+
+#endif // WORKQUEUE_H
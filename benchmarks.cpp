@@ -0,0 +1,988 @@
+/**********************************************
+ * File: benchmarks.cpp
+ * -------------------------------------------------------------------------
+ * Revision History:
+ * - 2026-10-19: Initial version created with the contention benchmark.
+ * - 2026-10-19: Added the ID allocation benchmark.
+ * - 2026-10-19: Added the snapshot read benchmark.
+ * - 2026-10-19: The contention check lists items into a query arena.
+ * - 2026-10-19: Added the work queue dispatch benchmark.
+ * - 2026-10-19: Added the tracing overhead benchmark.
+ * - 2026-10-19: Added the service layer throughput benchmark.
+ * - 2026-10-19: The service benchmark checks that an unknown requester is refused.
+ * - 2026-10-19: Service benchmark release IDs follow the X.X.X.X format.
+ * -------------------------------------------------------------------------
+ * Purpose:
+ * This file implements the command line benchmarks. Each benchmark creates a
+ * scratch data directory, works on its own copies of the data files and removes
+ * the directory when it is finished.
+ **********************************************/
+
+#include "benchmarks.h"
+#include "ChangeItem.h"
+#include "ChangeRequest.h"
+#include "Product.h"
+#include "ProductRelease.h"
+#include "Requester.h"
+#include "IdAllocator.h"
+#include "Snapshot.h"
+#include "StorageLayout.h"
+#include "Trace.h"
+#include "TrackerService.h"
+#include "WorkQueue.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//================================
+// Constants
+//================================
+const int CONTENTION_ITEMS_PER_PROCESS = 8;  // Items each process owns in the disjoint phase
+const int CONTENTION_SECONDS = 2;            // Length of each timed phase
+const int IDS_PER_THREAD = 2000000;          // IDs allocated by each thread in the ID benchmark
+const int IDS_PER_PROCESS = 200000;          // IDs allocated by each process in the ID benchmark
+const int ID_PROCESSES = 4;                  // Processes allocating at the same time
+const int SNAPSHOT_ITEMS = 3000;             // Items swept by the writer in the snapshot benchmark
+const int SNAPSHOT_SECONDS = 2;              // Length of each timed phase
+const int SNAPSHOT_SCAN_PAUSE_US = 100;      // Pause after each record, standing in for report work
+const int DISPATCH_ITEMS = 3000;             // Items waiting when the dispatch benchmark starts
+const int DISPATCH_PRODUCTS = 4;             // Products the waiting items are spread over
+const int DISPATCH_ORDERED_TAKES = 500;      // Items taken by one worker, whose order is checked
+const int DISPATCH_THREAD_TAKES = 1500;      // Items taken by the threads of this process
+const int DISPATCH_PROCESSES = 4;            // Processes taking the rest at the same time
+const int TRACE_ITEMS = 1000;                // Items looked up and updated in the trace benchmark
+const int TRACE_EMPTY_SPANS = 10000000;      // Spans around nothing timed in each phase
+const int TRACE_OPERATIONS = 100000;         // Lookups timed in each phase; every tenth is also an update
+const int SERVICE_PRODUCTS = 4;              // Products the service benchmark spreads its items over
+const int SERVICE_RELEASES = 3;              // Releases of each product
+const int SERVICE_REQUESTERS = 8;            // Requesters the change requests are made by
+const int SERVICE_REQUESTS = 2000;           // Change requests created; three in four also create an item
+const int SERVICE_VIEWS = 20000;             // Change items viewed
+const int SERVICE_UPDATES = 4000;            // State and priority updates, half each
+const int SERVICE_REPORTS = 2000;            // Release reports, every other one of a whole product
+
+//================================
+// Helper functions
+//================================
+
+/**********************************************
+ * Function: enterScratchDirectory
+ * Description: Creates an empty directory under /tmp and makes it the working directory.
+ * Parameters: string& directory - Receives the path of the directory.
+ * Returns: bool - True if the directory was created and entered.
+ **********************************************/
+static bool enterScratchDirectory(string& directory) {
+    std::error_code error;
+    filesystem::path base = filesystem::temp_directory_path(error);
+    if (error)
+        return false;
+    std::random_device seed;
+    for (int attempt = 0; attempt < 16; attempt++) {
+        filesystem::path candidate = base / ("tracker-bench-" + to_string(seed()));
+        if (filesystem::create_directory(candidate, error)) {
+            filesystem::current_path(candidate, error);
+            directory = candidate.string();
+            return !error;
+        }
+    }
+    return false;
+}
+
+/**********************************************
+ * Function: leaveScratchDirectory
+ * Description: Leaves and removes a directory created by enterScratchDirectory.
+ * Parameters: const string& directory - The path of the directory.
+ **********************************************/
+static void leaveScratchDirectory(const string& directory) {
+    std::error_code error;
+    filesystem::current_path(filesystem::temp_directory_path(error), error);
+    filesystem::remove_all(directory, error);
+}
+
+/**********************************************
+ * Function: newBenchItem
+ * Description: Builds a change item for the benchmark product.
+ **********************************************/
+static ChangeItem newBenchItem() {
+    Product product;
+    product.updateName("Bench");
+    ProductRelease release(product, "1.0.0.0", "2026-10-19");
+    return ChangeItem(product, "Contention item", ChangeItem::ASSESSED, 3, "2026-10-19", release);
+}
+
+#ifndef _WIN32
+
+// What a child process reports back to the parent.
+struct ContentionResult {
+    long long successes;
+    long long conflicts;
+    long long updates;      // Only used by the snapshot benchmark's writer
+};
+
+/**********************************************
+ * Function: runChildren
+ * Description:
+ * Forks one process per worker, runs work(i) in each one and collects the
+ * ContentionResult every child writes to its pipe.
+ * Parameters:
+ * - processes: The number of child processes
+ * - work: The body of child number i
+ * Returns: ContentionResult - The totals over all children.
+ **********************************************/
+template <typename Work>
+static ContentionResult runChildren(int processes, Work work) {
+    vector<int> pipes;
+    for (int i = 0; i < processes; i++) {
+        int channel[2];
+        if (pipe(channel) < 0)
+            break;
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(channel[0]);
+            ContentionResult result = work(i);
+            if (write(channel[1], &result, sizeof(result)) < 0)
+                _exit(1);
+            _exit(0);
+        }
+        close(channel[1]);
+        pipes.push_back(channel[0]);
+    }
+
+    ContentionResult total{0, 0, 0};
+    for (int channel : pipes) {
+        ContentionResult result{0, 0, 0};
+        if (read(channel, &result, sizeof(result)) == sizeof(result)) {
+            total.successes += result.successes;
+            total.conflicts += result.conflicts;
+            total.updates += result.updates;
+        }
+        close(channel);
+    }
+    while (wait(nullptr) > 0) {
+    }
+    return total;
+}
+
+/**********************************************
+ * Function: casLoop
+ * Description:
+ * Repeatedly reads a change item and bumps its priority with compare-and-swap
+ * until the deadline, counting successful and rejected updates.
+ **********************************************/
+static ContentionResult casLoop(const vector<int>& changeIds, chrono::steady_clock::time_point deadline) {
+    ContentionResult result{0, 0, 0};
+    size_t next = 0;
+    while (chrono::steady_clock::now() < deadline) {
+        int changeId = changeIds[next++ % changeIds.size()];
+        ChangeItem current = ChangeItem::getChangeItem(changeId);
+        int newPriority = current.getPriority() % 5 + 1;
+        if (ChangeItem::compareAndSetPriority(newPriority, changeId, current.getVersion()) == ChangeItem::UPDATE_OK)
+            result.successes++;
+        else
+            result.conflicts++;
+    }
+    return result;
+}
+
+/**********************************************
+ * Function: versionTotal
+ * Description: Sums the versions of the given change items.
+ **********************************************/
+static long long versionTotal(const vector<int>& changeIds) {
+    long long total = 0;
+    for (int changeId : changeIds)
+        total += ChangeItem::getChangeItem(changeId).getVersion();
+    return total;
+}
+
+//================================
+// Function implementations
+//================================
+
+/**********************************************
+ * Function: bench_contention
+ * Description:
+ * Measures cross-process updates of the change item file in three phases:
+ * - disjoint: every process updates its own items, so the record locks never collide;
+ * - hot: every process updates the same item, so most compare-and-swaps are rejected;
+ * - create: every process appends items, which serialize on the append lock.
+ * Every successful update must show up as exactly one version bump, and every
+ * created item must have a change ID no other item has.
+ * Parameters: int processes - The number of concurrent processes.
+ * Returns: int - 0 if no update or change ID was lost, 1 otherwise.
+ **********************************************/
+int bench_contention(int processes) {
+    if (processes < 1)
+        processes = 1;
+    string directory;
+    if (!enterScratchDirectory(directory)) {
+        cerr << "Failed to create the benchmark directory." << endl;
+        return 1;
+    }
+    ChangeItem::initChangeItem();
+
+    vector<int> changeIds;
+    for (int i = 0; i < processes * CONTENTION_ITEMS_PER_PROCESS; i++) {
+        ChangeItem changeItem = newBenchItem();
+        ChangeItem::createChangeItem(changeItem);
+        changeIds.push_back(changeItem.getChangeId());
+    }
+    bool consistent = true;
+    cout << "Contention benchmark with " << processes << " processes" << endl << endl;
+    cout << setw(10) << "phase" << setw(14) << "updates/s" << setw(14) << "conflicts" << setw(12) << "lost" << endl;
+
+    // Disjoint: process i owns items [i * N, (i + 1) * N)
+    long long before = versionTotal(changeIds);
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(CONTENTION_SECONDS);
+    ContentionResult disjoint = runChildren(processes, [&](int i) {
+        vector<int> own(changeIds.begin() + i * CONTENTION_ITEMS_PER_PROCESS, changeIds.begin() + (i + 1) * CONTENTION_ITEMS_PER_PROCESS);
+        return casLoop(own, deadline);
+    });
+    long long lost = (disjoint.successes - (versionTotal(changeIds) - before)) % 65536;
+    consistent = consistent && lost == 0;
+    cout << setw(10) << "disjoint" << setw(14) << disjoint.successes / CONTENTION_SECONDS << setw(14) << disjoint.conflicts << setw(12) << lost << endl;
+
+    // Hot: everybody updates the first item
+    vector<int> hot(1, changeIds[0]);
+    before = versionTotal(hot);
+    deadline = chrono::steady_clock::now() + chrono::seconds(CONTENTION_SECONDS);
+    ContentionResult shared = runChildren(processes, [&](int) { return casLoop(hot, deadline); });
+    lost = (shared.successes - (versionTotal(hot) - before)) % 65536;
+    consistent = consistent && lost == 0;
+    cout << setw(10) << "hot" << setw(14) << shared.successes / CONTENTION_SECONDS << setw(14) << shared.conflicts << setw(12) << lost << endl;
+
+    // Create: everybody appends; no two items may share a change ID. The parent's
+    // reserved block is given back first so forked children do not inherit a copy of it
+    ChangeItem::releaseChangeItemIds();
+    deadline = chrono::steady_clock::now() + chrono::seconds(CONTENTION_SECONDS);
+    ContentionResult created = runChildren(processes, [&](int) {
+        ContentionResult result{0, 0, 0};
+        while (chrono::steady_clock::now() < deadline) {
+            ChangeItem changeItem = newBenchItem();
+            ChangeItem::createChangeItem(changeItem);
+            result.successes++;
+        }
+        return result;
+    });
+    QueryArena arena;
+    ArenaVector<ChangeItem> all = ChangeItem::listChangeItems("Bench", arena);
+    set<int> unique;
+    for (const ChangeItem& changeItem : all)
+        unique.insert(changeItem.getChangeId());
+    long long duplicates = static_cast<long long>(all.size() - unique.size());
+    consistent = consistent && duplicates == 0 && all.size() == changeIds.size() + created.successes;
+    cout << setw(10) << "create" << setw(14) << created.successes / CONTENTION_SECONDS << setw(14) << "-" << setw(12) << duplicates << endl;
+
+    ChangeItem::closeChangeItem();
+    leaveScratchDirectory(directory);
+    cout << endl << (consistent ? "No lost updates or duplicate IDs." : "LOST UPDATES OR DUPLICATE IDS DETECTED.") << endl;
+    return consistent ? 0 : 1;
+}
+
+#else
+
+int bench_contention(int processes) {
+    cerr << "The contention benchmark is only supported on POSIX systems." << endl;
+    return 1;
+}
+
+#endif
+
+/**********************************************
+ * Function: noIds
+ * Description: Recovery scan for the ID benchmark's empty data file.
+ **********************************************/
+static int noIds() {
+    return -1;
+}
+
+/**********************************************
+ * Function: allocateIds
+ * Description: Allocates count IDs and appends them to ids.
+ **********************************************/
+static void allocateIds(IdAllocator& allocator, int count, vector<int>& ids) {
+    ids.reserve(ids.size() + count);
+    for (int i = 0; i < count; i++)
+        ids.push_back(allocator.nextId());
+}
+
+/**********************************************
+ * Function: bench_ids
+ * Description:
+ * Measures ID allocation in four phases, all drawing from the same durable mark:
+ * - one thread allocating back to back;
+ * - several threads sharing one allocator;
+ * - several processes, each with its own allocator;
+ * - a process that reserves IDs and exits without giving them back, as a crash would.
+ * Every ID from every phase is collected and checked for duplicates.
+ * Parameters: int threads - The number of threads in the multi-threaded phase.
+ * Returns: int - 0 if every ID was unique, 1 otherwise.
+ **********************************************/
+int bench_ids(int threads) {
+    if (threads < 1)
+        threads = 1;
+    string directory;
+    if (!enterScratchDirectory(directory)) {
+        cerr << "Failed to create the benchmark directory." << endl;
+        return 1;
+    }
+    ofstream("Bench.txt").close();
+
+    vector<int> all;
+    IdAllocator allocator("Bench.txt", "Bench.id");
+    allocator.init(noIds);
+    cout << "ID allocation benchmark" << endl << endl;
+    cout << setw(12) << "phase" << setw(14) << "IDs" << setw(12) << "ns/ID" << endl;
+
+    // One thread
+    auto start = chrono::steady_clock::now();
+    allocateIds(allocator, IDS_PER_THREAD, all);
+    double elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    cout << setw(12) << "1 thread" << setw(14) << IDS_PER_THREAD << setw(12) << fixed << setprecision(1) << elapsed / IDS_PER_THREAD << endl;
+
+    // Several threads on one allocator
+    vector<vector<int>> perThread(threads);
+    vector<thread> workers;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back(allocateIds, ref(allocator), IDS_PER_THREAD, ref(perThread[i]));
+    for (thread& worker : workers)
+        worker.join();
+    elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    for (const vector<int>& ids : perThread)
+        all.insert(all.end(), ids.begin(), ids.end());
+    cout << setw(12) << (to_string(threads) + " threads") << setw(14) << static_cast<long long>(threads) * IDS_PER_THREAD
+         << setw(12) << elapsed / (static_cast<double>(threads) * IDS_PER_THREAD) << endl;
+
+#ifndef _WIN32
+    // Several processes, each with its own allocator and block
+    start = chrono::steady_clock::now();
+    runChildren(ID_PROCESSES, [](int i) {
+        IdAllocator own("Bench.txt", "Bench.id");
+        own.init(noIds);
+        vector<int> ids;
+        allocateIds(own, IDS_PER_PROCESS, ids);
+        own.release();
+        ofstream out("ids." + to_string(i), ios::binary);
+        out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(int));
+        return ContentionResult{static_cast<long long>(ids.size()), 0, 0};
+    });
+    elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    for (int i = 0; i < ID_PROCESSES; i++) {
+        ifstream in("ids." + to_string(i), ios::binary);
+        int id;
+        while (in.read(reinterpret_cast<char*>(&id), sizeof(id)))
+            all.push_back(id);
+    }
+    cout << setw(12) << (to_string(ID_PROCESSES) + " procs") << setw(14) << ID_PROCESSES * IDS_PER_PROCESS
+         << setw(12) << elapsed / (ID_PROCESSES * IDS_PER_PROCESS) << endl;
+
+    // A process that dies holding a reserved block
+    runChildren(1, [](int) {
+        IdAllocator own("Bench.txt", "Bench.id");
+        own.init(noIds);
+        vector<int> ids;
+        allocateIds(own, 1000, ids);
+        ofstream out("ids.crash", ios::binary);
+        out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(int));
+        out.close();
+        _exit(0); // No release(), exactly like a crash
+        return ContentionResult{0, 0, 0};
+    });
+    ifstream crashed("ids.crash", ios::binary);
+    int id;
+    while (crashed.read(reinterpret_cast<char*>(&id), sizeof(id)))
+        all.push_back(id);
+    IdAllocator restarted("Bench.txt", "Bench.id");
+    restarted.init(noIds);
+    allocateIds(restarted, 1000, all);
+    cout << setw(12) << "crash" << setw(14) << 2000 << setw(12) << "-" << endl;
+#endif
+
+    allocator.release();
+    sort(all.begin(), all.end());
+    long long duplicates = 0;
+    long long failures = 0;
+    for (size_t i = 0; i < all.size(); i++) {
+        if (all[i] < 0)
+            failures++;
+        else if (i > 0 && all[i] == all[i - 1])
+            duplicates++;
+    }
+    leaveScratchDirectory(directory);
+    cout << endl << all.size() << " IDs, " << duplicates << " duplicates, " << failures << " failed allocations." << endl;
+    return duplicates == 0 && failures == 0 ? 0 : 1;
+}
+
+#ifndef _WIN32
+
+/**********************************************
+ * Function: scanIsConsistent
+ * Description:
+ * Checks the versions read by one scan against the writer's sweeps. The writer
+ * bumps the items in file order over and over, so at any single moment the
+ * versions never increase along the file and differ by at most one.
+ * Parameters: const vector<int>& versions - The versions in file order.
+ * Returns: bool - True if the scan could have been taken at a single moment.
+ **********************************************/
+static bool scanIsConsistent(const vector<int>& versions) {
+    for (size_t i = 1; i < versions.size(); i++) {
+        if (versions[i] > versions[i - 1])
+            return false;
+    }
+    return versions.empty() || versions.front() - versions.back() <= 1;
+}
+
+/**********************************************
+ * Function: scanLoop
+ * Description:
+ * Scans the benchmark items until the deadline, pausing after every record the
+ * way a long report would, and counts scans that mix versions.
+ * Parameters:
+ * - useSnapshot: Read through a Snapshot instead of straight from the file
+ * - deadline: When to stop
+ * Returns: ContentionResult - Scans in successes, mixed scans in conflicts.
+ **********************************************/
+static ContentionResult scanLoop(bool useSnapshot, chrono::steady_clock::time_point deadline) {
+    ContentionResult result{0, 0, 0};
+    while (chrono::steady_clock::now() < deadline) {
+        vector<int> versions;
+        auto visit = [&](const ChangeItem& changeItem) {
+            versions.push_back(changeItem.getVersion());
+            this_thread::sleep_for(chrono::microseconds(SNAPSHOT_SCAN_PAUSE_US));
+        };
+        if (useSnapshot) {
+            Snapshot snapshot;
+            snapshot.scan(StorageLayout::itemPath("Bench"), visit);
+        } else {
+            ifstream infile(StorageLayout::itemPath("Bench"), ios::binary);
+            ChangeItem changeItem;
+            while (infile.read(reinterpret_cast<char*>(&changeItem), sizeof(ChangeItem)))
+                visit(changeItem);
+        }
+        result.successes++;
+        if (!scanIsConsistent(versions))
+            result.conflicts++;
+    }
+    return result;
+}
+
+/**********************************************
+ * Function: bench_snapshot
+ * Description:
+ * Runs one writer process that sweeps the change items, bumping each one's
+ * priority, next to reader processes that scan them slowly:
+ * - alone: the writer on its own, as the baseline update rate;
+ * - snapshot: the readers scan through snapshots;
+ * - plain: the readers scan the file directly, for comparison.
+ * Snapshot scans must never mix versions, and the version log must be empty once
+ * the last snapshot is closed.
+ * Parameters: int readers - The number of reader processes.
+ * Returns: int - 0 if every snapshot scan was consistent and the log was reclaimed, 1 otherwise.
+ **********************************************/
+int bench_snapshot(int readers) {
+    if (readers < 1)
+        readers = 1;
+    string directory;
+    if (!enterScratchDirectory(directory)) {
+        cerr << "Failed to create the benchmark directory." << endl;
+        return 1;
+    }
+    ChangeItem::initChangeItem();
+
+    vector<int> changeIds;
+    for (int i = 0; i < SNAPSHOT_ITEMS; i++) {
+        ChangeItem changeItem = newBenchItem();
+        ChangeItem::createChangeItem(changeItem);
+        changeIds.push_back(changeItem.getChangeId());
+    }
+    ChangeItem::releaseChangeItemIds();
+
+    auto writer = [&](chrono::steady_clock::time_point deadline) {
+        ContentionResult result{0, 0, 0};
+        // Only whole sweeps, so every phase starts with all items at the same version
+        for (size_t next = 0; next % changeIds.size() != 0 || chrono::steady_clock::now() < deadline; next++) {
+            int changeId = changeIds[next % changeIds.size()];
+            if (ChangeItem::updatePriority(static_cast<int>(next % 5) + 1, changeId))
+                result.updates++;
+        }
+        return result;
+    };
+
+    cout << "Snapshot benchmark with " << SNAPSHOT_ITEMS << " items, 1 writer and " << readers << " readers" << endl << endl;
+    cout << setw(10) << "phase" << setw(14) << "updates/s" << setw(10) << "scans" << setw(14) << "mixed scans" << endl;
+
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::seconds(SNAPSHOT_SECONDS);
+    ContentionResult alone = runChildren(1, [&](int) { return writer(deadline); });
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(10) << "alone" << setw(14) << static_cast<long long>(alone.updates / elapsed) << setw(10) << "-" << setw(14) << "-" << endl;
+
+    long long mixedSnapshots = 0;
+    for (bool useSnapshot : {true, false}) {
+        start = chrono::steady_clock::now();
+        deadline = start + chrono::seconds(SNAPSHOT_SECONDS);
+        ContentionResult phase = runChildren(readers + 1, [&](int i) {
+            return i == 0 ? writer(deadline) : scanLoop(useSnapshot, deadline);
+        });
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (useSnapshot)
+            mixedSnapshots = phase.conflicts;
+        cout << setw(10) << (useSnapshot ? "snapshot" : "plain") << setw(14) << static_cast<long long>(phase.updates / elapsed)
+             << setw(10) << phase.successes << setw(14) << phase.conflicts << endl;
+    }
+
+    long long leftover = Snapshot::versionLogEntries();
+    bool consistent = mixedSnapshots == 0 && leftover == 0;
+    ChangeItem::closeChangeItem();
+    leaveScratchDirectory(directory);
+    cout << endl << leftover << " old versions left in the version log." << endl;
+    cout << (consistent ? "Every snapshot scan was consistent." : "SNAPSHOT SCANS MIXED VERSIONS.") << endl;
+    return consistent ? 0 : 1;
+}
+
+#else
+
+int bench_snapshot(int readers) {
+    cerr << "The snapshot benchmark is only supported on POSIX systems." << endl;
+    return 1;
+}
+
+#endif
+
+#ifndef _WIN32
+
+/**********************************************
+ * Function: takeAndFinish
+ * Description: Takes the next work item as holder, marks it Done and records its
+ *              priority and change ID. Counts an item that could not be finished.
+ * Returns: bool - False if nothing was waiting.
+ **********************************************/
+static bool takeAndFinish(const string& holder, vector<pair<int, int>>& taken, atomic<long long>& failures) {
+    WorkLease lease;
+    ChangeItem changeItem;
+    if (!WorkQueue::takeNext("", holder, DEFAULT_LEASE_SECONDS, lease, changeItem))
+        return false;
+    taken.push_back({changeItem.getPriority(), changeItem.getChangeId()});
+    if (WorkQueue::finish(lease, ChangeItem::DONE) != ChangeItem::UPDATE_OK)
+        failures++;
+    return true;
+}
+
+/**********************************************
+ * Function: bench_dispatch
+ * Description:
+ * Fills the work queue with assessed items of several products and random
+ * priorities, then takes them all, finishing each one:
+ * - 1 worker: takes items one after the other, which must come best first;
+ * - threads: many threads of this process take items at once;
+ * - processes: several processes, each with its own threads, take the rest.
+ * No item may be taken twice and none may be left. Finally a lease is left to
+ * run out and must be reclaimed.
+ * Parameters: int workers - The number of threads taking items at once.
+ * Returns: int - The process exit status; non-zero if an item was taken twice, out
+ *          of order or not at all, or a lease was not reclaimed.
+ **********************************************/
+int bench_dispatch(int workers) {
+    if (workers < 1)
+        workers = 1;
+    string directory;
+    if (!enterScratchDirectory(directory)) {
+        cerr << "Failed to create the benchmark directory." << endl;
+        return 1;
+    }
+    ChangeItem::initChangeItem();
+
+    mt19937 random(42);
+    for (int i = 0; i < DISPATCH_ITEMS; i++) {
+        Product product;
+        product.updateName(("Bench" + to_string(i % DISPATCH_PRODUCTS)).c_str());
+        ProductRelease release(product, "1.0.0.0", "2026-10-19");
+        ChangeItem changeItem(product, "Dispatch item", ChangeItem::ASSESSED, static_cast<int>(random() % 5) + 1, "2026-10-19", release);
+        ChangeItem::createChangeItem(changeItem);
+    }
+    ChangeItem::releaseChangeItemIds();
+    cout << "Dispatch benchmark with " << DISPATCH_ITEMS << " items over " << DISPATCH_PRODUCTS << " products" << endl << endl;
+    cout << setw(14) << "phase" << setw(10) << "items" << setw(12) << "items/s" << setw(10) << "failed" << endl;
+
+    // One worker: every item must come after the one before in (priority, change ID) order
+    vector<pair<int, int>> all;
+    atomic<long long> failed(0);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < DISPATCH_ORDERED_TAKES; i++) {
+        if (!takeAndFinish("single", all, failed))
+            failed++;
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    bool ordered = is_sorted(all.begin(), all.end());
+    cout << setw(14) << "1 worker" << setw(10) << all.size() << setw(12) << static_cast<long long>(all.size() / elapsed)
+         << setw(10) << failed << endl;
+
+    // Many threads of one process
+    mutex takenLock;
+    atomic<int> claimed(0);
+    long long failedBefore = failed;
+    vector<thread> threads;
+    size_t before = all.size();
+    start = chrono::steady_clock::now();
+    for (int t = 0; t < workers; t++) {
+        threads.emplace_back([&, t]() {
+            vector<pair<int, int>> taken;
+            while (claimed.fetch_add(1) < DISPATCH_THREAD_TAKES) {
+                if (!takeAndFinish("thread" + to_string(t), taken, failed))
+                    failed++;
+            }
+            lock_guard<mutex> guard(takenLock);
+            all.insert(all.end(), taken.begin(), taken.end());
+        });
+    }
+    for (thread& worker : threads)
+        worker.join();
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(14) << (to_string(workers) + " threads") << setw(10) << all.size() - before
+         << setw(12) << static_cast<long long>((all.size() - before) / elapsed) << setw(10) << failed - failedBefore << endl;
+
+    // Several processes, each with its own queues built from the files and the feed
+    before = all.size();
+    int perProcess = max(1, workers / DISPATCH_PROCESSES);
+    start = chrono::steady_clock::now();
+    ContentionResult processes = runChildren(DISPATCH_PROCESSES, [perProcess](int i) {
+        vector<pair<int, int>> taken;
+        mutex takenLock;
+        atomic<long long> failures(0);
+        vector<thread> own;
+        for (int t = 0; t < perProcess; t++) {
+            own.emplace_back([&, t]() {
+                vector<pair<int, int>> mine;
+                while (takeAndFinish("proc" + to_string(i) + "." + to_string(t), mine, failures)) {}
+                lock_guard<mutex> guard(takenLock);
+                taken.insert(taken.end(), mine.begin(), mine.end());
+            });
+        }
+        for (thread& worker : own)
+            worker.join();
+        ofstream out("taken." + to_string(i), ios::binary);
+        out.write(reinterpret_cast<const char*>(taken.data()), taken.size() * sizeof(pair<int, int>));
+        return ContentionResult{static_cast<long long>(taken.size()), failures.load(), 0};
+    });
+    elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (int i = 0; i < DISPATCH_PROCESSES; i++) {
+        ifstream in("taken." + to_string(i), ios::binary);
+        pair<int, int> item;
+        while (in.read(reinterpret_cast<char*>(&item), sizeof(item)))
+            all.push_back(item);
+    }
+    failed += processes.conflicts;
+    cout << setw(14) << (to_string(DISPATCH_PROCESSES) + " procs") << setw(10) << all.size() - before
+         << setw(12) << static_cast<long long>((all.size() - before) / elapsed) << setw(10) << processes.conflicts << endl;
+
+    sort(all.begin(), all.end(), [](const pair<int, int>& a, const pair<int, int>& b) { return a.second < b.second; });
+    long long duplicates = 0;
+    for (size_t i = 1; i < all.size(); i++) {
+        if (all[i].second == all[i - 1].second)
+            duplicates++;
+    }
+    long long left = static_cast<long long>(WorkQueue::waiting(""));
+    long long missing = DISPATCH_ITEMS - static_cast<long long>(all.size()) + duplicates;
+
+    // A lease that is not renewed
+    Product product;
+    product.updateName("Bench0");
+    ProductRelease release(product, "1.0.0.0", "2026-10-19");
+    ChangeItem abandoned(product, "Abandoned item", ChangeItem::ASSESSED, 1, "2026-10-19", release);
+    ChangeItem::createChangeItem(abandoned);
+    ChangeItem::releaseChangeItemIds();
+    WorkLease lease;
+    ChangeItem taken;
+    bool reclaimed = WorkQueue::takeNext("Bench0", "abandoner", 1, lease, taken) && lease.changeId == abandoned.getChangeId();
+    this_thread::sleep_for(chrono::milliseconds(2100));
+    reclaimed = reclaimed && WorkQueue::reclaimExpired() == 1 && !WorkQueue::renew(lease, 60) && WorkQueue::waiting("Bench0") == 1;
+
+    ChangeItem::closeChangeItem();
+    leaveScratchDirectory(directory);
+    cout << endl << all.size() << " items taken, " << duplicates << " twice, " << missing << " never, " << left
+         << " still waiting, " << failed << " not finished." << endl;
+    cout << (ordered ? "One worker took the items best first." : "ITEMS WERE TAKEN OUT OF ORDER.") << endl;
+    cout << (reclaimed ? "The lease that ran out was reclaimed." : "THE LEASE THAT RAN OUT WAS NOT RECLAIMED.") << endl;
+    return duplicates == 0 && missing == 0 && left == 0 && failed == 0 && ordered && reclaimed ? 0 : 1;
+}
+
+#else
+
+int bench_dispatch(int workers) {
+    cerr << "The dispatch benchmark is only supported on POSIX systems." << endl;
+    return 1;
+}
+
+#endif
+
+/**********************************************
+ * Function: traceLoops
+ * Description: Times spans around nothing and spans around item operations,
+ *              and prints a row for each.
+ * Parameters:
+ * - phase: The name printed for the phase
+ * - changeIds: The items to look up and update
+ * Returns: long long - The outermost spans opened
+ **********************************************/
+static long long traceLoops(const string& phase, const vector<int>& changeIds) {
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < TRACE_EMPTY_SPANS; i++) {
+        Trace::Span span("bench.empty", "bench");
+    }
+    double empty = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / TRACE_EMPTY_SPANS;
+
+    start = chrono::steady_clock::now();
+    ChangeItem changeItem;
+    for (int i = 0; i < TRACE_OPERATIONS; i++) {
+        Trace::Span span("bench.operation", "bench");
+        int changeId = changeIds[i % changeIds.size()];
+        ChangeItem::findChangeItem(changeId, changeItem);
+        if (i % 10 == 0)
+            ChangeItem::updatePriority(i % 5 + 1, changeId);
+    }
+    double operation = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / TRACE_OPERATIONS;
+    cout << setw(10) << phase << setw(16) << fixed << setprecision(1) << empty << setw(16) << operation << endl;
+    return static_cast<long long>(TRACE_EMPTY_SPANS) + TRACE_OPERATIONS;
+}
+
+/**********************************************
+ * Function: bench_trace
+ * Description:
+ * Runs the same loops with tracing off and then on at the given sample rate,
+ * writes the trace, and checks the file holds as many spans as the buffer
+ * could keep.
+ * Parameters: double sampleRate - The share of outermost spans kept.
+ * Returns: int - The process exit status.
+ **********************************************/
+int bench_trace(double sampleRate) {
+    string directory;
+    if (!enterScratchDirectory(directory)) {
+        cerr << "Failed to create the benchmark directory." << endl;
+        return 1;
+    }
+    ChangeItem::initChangeItem();
+    vector<int> changeIds;
+    for (int i = 0; i < TRACE_ITEMS; i++) {
+        ChangeItem changeItem = newBenchItem();
+        ChangeItem::createChangeItem(changeItem);
+        changeIds.push_back(changeItem.getChangeId());
+    }
+    ChangeItem::releaseChangeItemIds();
+
+    cout << "Trace benchmark with " << TRACE_ITEMS << " items at a sample rate of " << sampleRate << endl << endl;
+    cout << setw(10) << "tracing" << setw(16) << "ns/empty span" << setw(16) << "ns/operation" << endl;
+    traceLoops("off", changeIds);
+    string path = directory + "/trace.json";
+    if (!Trace::start(path, sampleRate)) {
+        ChangeItem::closeChangeItem();
+        leaveScratchDirectory(directory);
+        return 1;
+    }
+    long long opened = traceLoops("on", changeIds);
+    Trace::stop();
+
+    ifstream in(path);
+    string line;
+    long long written = 0, recorded = -1;
+    while (getline(in, line)) {
+        if (line.find("\"ph\":\"X\"") != string::npos)
+            written++;
+        size_t field = line.find("\"spansRecorded\":");
+        if (field != string::npos)
+            recorded = atoll(line.c_str() + field + 16);
+    }
+    ChangeItem::closeChangeItem();
+    leaveScratchDirectory(directory);
+
+    bool complete = recorded >= 0 && written == min(recorded, static_cast<long long>(DEFAULT_TRACE_CAPACITY));
+    cout << endl << opened << " outermost spans opened, " << recorded << " spans recorded with the spans nested in them, "
+         << written << " written." << endl;
+    cout << (complete ? "The trace holds every span the buffer kept." : "THE TRACE IS INCOMPLETE.") << endl;
+    return complete ? 0 : 1;
+}
+
+/**********************************************
+ * Function: servicePhase
+ * Description:
+ * Runs operation for the numbers 0 to count - 1 on several threads, each thread
+ * claiming the next number until none is left, and prints a row with the
+ * throughput and the outcomes.
+ * Parameters:
+ * - phase: The name printed for the phase
+ * - threads: The number of threads
+ * - count: The number of operations
+ * - operation: Runs operation number i and returns its status
+ * Returns: long long - The operations that neither succeeded nor lost a compare-and-swap
+ **********************************************/
+static long long servicePhase(const string& phase, int threads, int count, const function<ServiceStatus(int)>& operation) {
+    atomic<int> claimed(0);
+    atomic<long long> conflicts(0), failed(0);
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            for (int i = claimed.fetch_add(1); i < count; i = claimed.fetch_add(1)) {
+                ServiceStatus status = operation(i);
+                if (status == SERVICE_CONFLICT)
+                    conflicts++;
+                else if (status != SERVICE_OK)
+                    failed++;
+            }
+        });
+    }
+    for (thread& worker : workers)
+        worker.join();
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << setw(16) << phase << setw(10) << count << setw(12) << static_cast<long long>(count / elapsed)
+         << setw(11) << conflicts << setw(10) << failed << endl;
+    return failed;
+}
+
+/**********************************************
+ * Function: bench_service
+ * Description:
+ * Drives the service layer the way the menus do, without a console: sets up
+ * products, requesters and releases, then has several threads create change
+ * requests (most of them with a new change item), view items, update their
+ * state and priority with the version they viewed, and read release reports.
+ * Finally the reports must account for every change item created.
+ * Parameters: int threads - The number of threads calling the service at once.
+ * Returns: int - The process exit status; non-zero if a request failed or the
+ *          reports disagree with the items created.
+ **********************************************/
+int bench_service(int threads) {
+    if (threads < 1)
+        threads = 1;
+    string directory;
+    if (!enterScratchDirectory(directory)) {
+        cerr << "Failed to create the benchmark directory." << endl;
+        return 1;
+    }
+    ProductRelease::initProductRelease();
+    Product::initProduct();
+    Requester::initRequester();
+    ChangeItem::initChangeItem();
+    ChangeRequest::initChangeRequest();
+
+    long long failed = 0;
+    auto product = [](int i) { return "Bench" + to_string(i % SERVICE_PRODUCTS); };
+    auto release = [](int i) { return "1." + to_string(i % SERVICE_RELEASES) + ".0.0"; };
+    for (int i = 0; i < SERVICE_PRODUCTS; i++) {
+        failed += !TrackerService::createProduct({product(i)}).ok();
+        for (int r = 0; r < SERVICE_RELEASES; r++)
+            failed += !TrackerService::createRelease({product(i), release(r), "2026-10-19"}).ok();
+    }
+    for (int i = 0; i < SERVICE_REQUESTERS; i++)
+        failed += !TrackerService::createRequester({"Requester " + to_string(i), "5550100", "r" + to_string(i) + "@bench", "QA"}).ok();
+    // Each must be refused, not written twice
+    bool refused = TrackerService::createProduct({product(0)}).status == SERVICE_DUPLICATE &&
+                   TrackerService::createRelease({product(0), release(0), "2026-10-19"}).status == SERVICE_DUPLICATE &&
+                   TrackerService::createRequester({"Again", "5550100", "r0@bench", "QA"}).status == SERVICE_DUPLICATE &&
+                   TrackerService::createRequest({"Requester 0", "Nobody", "2026-10-19", 1, "", 3,
+                                                  ChangeItem::ASSESSED, "", ""}).status == SERVICE_NOT_FOUND &&
+                   TrackerService::createRequest({"Nobody", product(0), "2026-10-19", -1, "Unknown requester", 3,
+                                                  ChangeItem::ASSESSED, release(0), "2026-10-19"}).status == SERVICE_NOT_FOUND;
+    vector<string> requesters = TrackerService::requesters();
+    if (failed > 0 || requesters.size() != SERVICE_REQUESTERS || TrackerService::products().size() != SERVICE_PRODUCTS) {
+        cerr << "The service benchmark could not be set up." << endl;
+        leaveScratchDirectory(directory);
+        return 1;
+    }
+
+    cout << "Service benchmark with " << threads << " threads" << endl << endl;
+    cout << setw(16) << "phase" << setw(10) << "requests" << setw(12) << "requests/s" << setw(11) << "conflicts"
+         << setw(10) << "failed" << endl;
+
+    // Requests come in groups of four of one product; the fourth is about an item the group created,
+    // unless the other threads have not created one yet
+    vector<atomic<int>> changeIds(SERVICE_REQUESTS);
+    for (atomic<int>& changeId : changeIds)
+        changeId = -1;
+    atomic<int> created(0);
+    failed += servicePhase("create request", threads, SERVICE_REQUESTS, [&](int i) {
+        CreateRequestRequest request;
+        request.requester = requesters[static_cast<size_t>(i) % requesters.size()];
+        request.product = product(i / 4);
+        request.date = "2026-10-19";
+        for (int earlier = i - 1; i % 4 == 3 && earlier > i - 4 && request.changeId < 0; earlier--)
+            request.changeId = changeIds[static_cast<size_t>(earlier)].load();
+        if (request.changeId < 0) {
+            request.description = "Service item " + to_string(i);
+            request.priority = i % 5 + 1;
+            request.releaseId = release(i);
+            request.releaseDate = "2026-10-19";
+        }
+        CreateRequestResponse response = TrackerService::createRequest(request);
+        if (response.ok() && response.itemCreated) {
+            changeIds[static_cast<size_t>(i)] = response.changeId;
+            created++;
+        }
+        return response.status;
+    });
+    vector<int> items;
+    for (atomic<int>& changeId : changeIds)
+        if (changeId >= 0)
+            items.push_back(changeId);
+    if (items.empty()) {
+        ChangeItem::closeChangeItem();
+        leaveScratchDirectory(directory);
+        return 1;
+    }
+
+    failed += servicePhase("view item", threads, SERVICE_VIEWS, [&](int i) {
+        return TrackerService::viewItem({items[static_cast<size_t>(i * 7) % items.size()]}).status;
+    });
+    failed += servicePhase("update", threads, SERVICE_UPDATES, [&](int i) {
+        ViewItemResponse current = TrackerService::viewItem({items[static_cast<size_t>(i * 13) % items.size()]});
+        if (!current.ok())
+            return current.status;
+        if (i % 2 == 0)
+            return TrackerService::updateState({current.item.changeId, static_cast<ChangeItem::State>(i / 2 % 2),
+                                                current.item.version}).status;
+        return TrackerService::updatePriority({current.item.changeId, i % 5 + 1, current.item.version}).status;
+    });
+    failed += servicePhase("report", threads, SERVICE_REPORTS, [&](int i) {
+        return TrackerService::report({product(i), i % 2 == 0 ? "" : release(i / 2)}).status;
+    });
+
+    // Every item created targets one release of its product
+    long long reported = 0;
+    for (int i = 0; i < SERVICE_PRODUCTS; i++) {
+        ReportResponse report = TrackerService::report({product(i), ""});
+        for (const ReleaseSummary& summary : report.releases)
+            reported += summary.total;
+    }
+    ChangeRequest::closeChangeRequest();
+    ChangeItem::closeChangeItem();
+    Requester::closeRequester();
+    Product::closeProduct();
+    ProductRelease::closeProductRelease();
+    leaveScratchDirectory(directory);
+
+    bool complete = reported == created.load();
+    cout << endl << created << " change items created with their requests, " << reported << " in the release reports, "
+         << failed << " requests failed." << endl;
+    cout << (refused ? "Duplicates, unknown products and unknown requesters were refused."
+                     : "A DUPLICATE, AN UNKNOWN PRODUCT OR AN UNKNOWN REQUESTER WAS ACCEPTED.") << endl;
+    cout << (complete ? "The reports account for every item." : "THE REPORTS DO NOT ACCOUNT FOR EVERY ITEM.") << endl;
+    return failed == 0 && refused && complete ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+/**********************************************
+ * Benchmarks Header File
+ * Revision History:
+ * - 2026-10-19: Initial version created.
+ * - 2026-10-19: Added bench_dispatch.
+ * - 2026-10-19: Added bench_trace.
+ * - 2026-10-19: Added bench_service.
+ *--------------------------------
+ * Purpose: This module contains the declarations for the command line benchmarks.
+ *          Every benchmark runs in a scratch data directory under /tmp so it never
+ *          touches the operator's files, and prints its results to standard output.
+ **********************************************/
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+ //=============================
+ // Function Declarations
+ //=============================
+
+//----------------------------------------------------
+int bench_contention(int processes);
+// Description: Runs several processes that update change items at the same time and
+//              reports update throughput, compare-and-swap conflicts and whether any
+//              update or change ID was lost.
+// Returns: int - The process exit status; non-zero if a lost update or duplicate ID was found.
+
+//----------------------------------------------------
+int bench_ids(int threads);
+// Description: Measures the cost of allocating change IDs from one thread, from several
+//              threads and from several processes, simulates a crash, and checks that no
+//              ID was handed out twice.
+// Returns: int - The process exit status; non-zero if a duplicate ID was found.
+
+//----------------------------------------------------
+int bench_snapshot(int readers);
+// Description: Runs slow scans next to a writer that keeps updating the same change
+//              items, and checks that snapshot scans never mix old and new versions
+//              and that the writer is not slowed down by them.
+// Returns: int - The process exit status; non-zero if a snapshot scan was inconsistent.
+
+//----------------------------------------------------
+int bench_dispatch(int workers);
+// Description: Has many threads and several processes take work items from the work queue
+//              at once, and checks that items come best first, that none is taken twice or
+//              left behind, and that a lease that is not renewed is reclaimed.
+// Returns: int - The process exit status; non-zero if any check failed.
+
+//----------------------------------------------------
+int bench_trace(double sampleRate);
+// Description: Measures the cost of a span with tracing off and on at the given sample
+//              rate, alone and around item lookups and updates, and checks the trace
+//              written is complete.
+// Returns: int - The process exit status; non-zero if the trace could not be written.
+
+//----------------------------------------------------
+int bench_service(int threads);
+// Description: Calls the service layer from several threads: creates change requests with
+//              their items, views and updates items and reads release reports, and checks
+//              that no request failed and the reports count every item created.
+// Returns: int - The process exit status; non-zero if any check failed.
+
+#endif // BENCHMARKS_H
@@ -3,6 +3,32 @@
  * -------------------------------------------------------------------------
  * Revision History:
  * - 2024-07-02: Initial version created.
+ * - 2026-10-19: Added the --daemon and --bench-daemon command line modes.
+ * - 2026-10-19: Added the --bench-contention command line mode.
+ * - 2026-10-19: Added the --bench-ids command line mode.
+ * - 2026-10-19: Added the --migrate-partitions command line mode.
+ * - 2026-10-19: Added the --bench-snapshot command line mode.
+ * - 2026-10-19: Added the --tail-feed command line mode.
+ * - 2026-10-19: Added the --follow, --replica-status and --promote command line modes.
+ * - 2026-10-19: Added the --history and --cycle-times command line modes.
+ * - 2026-10-19: Added the --filter-stats command line mode.
+ * - 2026-10-19: Added the --release-status command line mode.
+ * - 2026-10-19: Added the --most-requested command line mode.
+ * - 2026-10-19: Added the --query command line mode.
+ * - 2026-10-19: Added the --scrub command line mode.
+ * - 2026-10-19: Added the --upgrade-files command line mode.
+ * - 2026-10-19: Added the --archive-items command line mode.
+ * - 2026-10-19: Added the --archive-stats command line mode.
+ * - 2026-10-19: Added the --bench-dispatch and --leases command line modes.
+ * - 2026-10-19: Added the --metrics command line option.
+ * - 2026-10-19: Added the --trace command line option and the --bench-trace mode.
+ * - 2026-10-19: Added the --perf command line option.
+ * - 2026-10-19: Added the --bench-service command line mode.
+ * - 2026-10-19: --filter-stats exits with the status of printStats.
+ * - 2026-10-19: --release-status exits with the status of printRelease.
+ * - 2026-10-19: --most-requested exits with the status of printMostRequested.
+ * - 2026-10-19: --query exits with the status of the query: 2 for a parse error, 1 when nothing matches.
+ * - 2026-10-19: --leases exits with the status of printLeases.
  * -------------------------------------------------------------------------
  * Purpose:
  * This file contains the main entry point for the Issue Tracking System. It 
@@ -13,7 +39,26 @@
 
 #include "ui.h"
 #include "systemControl.h"  // Contains startup and shutdown logic
+#include "TrackerDaemon.h"
+#include "TrackerClient.h"
+#include "benchmarks.h"
+#include "StorageLayout.h"
+#include "FileFormat.h"
+#include "ChangeFeed.h"
+#include "Replica.h"
+#include "ItemHistory.h"
+#include "BloomFilter.h"
+#include "ReleaseIndex.h"
+#include "RequestLinks.h"
+#include "Query.h"
+#include "RecordChecksum.h"
+#include "ItemArchive.h"
+#include "WorkQueue.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 
 //================================
 // Function implementations
@@ -23,13 +68,172 @@
  * Function: main
  * Description:
  * The entry point of the program. It calls the systemStartup function, runs the user interface, and then calls the systemShutdown function.
- * Parameters: None
+ * Command line options:
+ * - --metrics [address]: Serves GET /metrics on 127.0.0.1:9464, or on the given port or "unix:<path>", for as
+ *   long as the process runs.
+ * - --trace <file> [rate]: Traces the scenarios, daemon requests and entity operations as nested spans and
+ *   writes the latest of them to the file at exit, in the Chrome trace-event format Perfetto loads. Keeps
+ *   the given share of operations (default: 1, every one; 0.01 is cheap enough to leave on).
+ * - --perf: Counts cycles, instructions, last-level cache misses and branch misses of every entity operation,
+ *   report and scan with the hardware counters, and prints them per operation type with IPC and misses per
+ *   thousand instructions at exit. Needs Linux, a performance monitoring unit and perf_event_paranoid <= 2.
+ * The options come before the mode, in any order, and work with every mode and with the user interface.
+ * Command line modes:
+ * - --daemon [socket] [threads]: Serves the data files to local clients instead of running the user interface.
+ * - --bench-daemon [clients]: Measures daemon throughput and latency on a scratch data directory.
+ * - --bench-contention [processes]: Measures concurrent cross-process updates and checks none are lost.
+ * - --bench-ids [threads]: Measures change ID allocation and checks no ID is handed out twice.
+ * - --bench-snapshot [readers]: Measures updates next to slow snapshot scans and checks the scans are consistent.
+ * - --bench-dispatch [workers]: Measures taking work items from many threads and processes and checks that
+ *   none is taken twice or left behind.
+ * - --bench-trace [rate]: Measures the cost of tracing at a sample rate (default: 0.01) and checks the trace.
+ * - --bench-service [threads]: Measures the service layer under the menus from several threads and checks
+ *   that the release reports count every change item it created.
+ * - --tail-feed [from] [product] [state]: Prints change feed events from a sequence number on (default: new
+ *   events only) and keeps following the feed; product "*" and state -1 match everything.
+ * - --migrate-partitions: Splits the change item and request files into one segment per product.
+ * - --scrub [directory] [MB/s]: Verifies the checksum of every record in a data directory (default: the
+ *   current one), in parallel at full speed, or on one low-priority thread at the given rate while the
+ *   tracker runs. Exits with 1 if a record fails.
+ * - --upgrade-files [MB/s]: Rewrites the data files still in an older record version in the current one
+ *   (default rate: no limit). Can run while the tracker is in use.
+ * - --archive-items [days]: Moves the change items closed for at least the given number of days (default: 90)
+ *   out of the item files into their archives. Can run while the tracker is in use.
+ * - --archive-stats: Prints the blocks, compressed size, compression ratio and read speed of each archive.
+ * - --follow <primary> [socket] [threads]: Keeps this data directory a read-only copy of the primary's and
+ *   serves it like --daemon.
+ * - --replica-status [socket]: Prints the replication position and lag of a running daemon.
+ * - --promote [socket]: Makes a following daemon stop following and accept writes.
+ * - --history <changeId> [date]: Prints a change item's transitions and its state as of a date (default: now).
+ * - --cycle-times [product]: Prints lead, cycle and time-in-state percentiles per product.
+ * - --release-status <product> [release]: Prints a release's state counts and open items, or the counts
+ *   of every release of the product.
+ * - --most-requested [count]: Prints the change items with the most change requests (default: 10).
+ * - --query <statement|->: Runs one query, or one query per line of standard input for "-".
+ * - --filter-stats: Prints the key counts and false positive rates of the lookup filters.
+ * - --leases: Reclaims the work item leases that ran out, then lists the leases held and the items waiting.
+ * Parameters: int argc, char* argv[]: The command line arguments.
  * Returns: int: Exit status of the program.
  **********************************************/
-int main() {
+int main(int argc, char* argv[]) {
+    while (argc > 1 && (strcmp(argv[1], "--metrics") == 0 || strcmp(argv[1], "--trace") == 0 ||
+                        strcmp(argv[1], "--perf") == 0)) {
+        int shift;
+        if (strcmp(argv[1], "--perf") == 0) {
+            if (!Metrics::startCounters())
+                return 1;
+            shift = 1;
+        } else if (strcmp(argv[1], "--metrics") == 0) {
+            bool addressGiven = argc > 2 && strncmp(argv[2], "--", 2) != 0;
+            if (!Metrics::startServer(addressGiven ? argv[2] : DEFAULT_METRICS_ADDRESS))
+                return 1;
+            shift = addressGiven ? 2 : 1;
+        } else {
+            if (argc < 3) {
+                std::cerr << "--trace needs the file to write the trace to." << std::endl;
+                return 1;
+            }
+            char* end = nullptr;
+            double rate = argc > 3 ? strtod(argv[3], &end) : 1;
+            bool rateGiven = argc > 3 && end != argv[3] && *end == '\0';
+            if (!Trace::start(argv[2], rateGiven ? rate : 1))
+                return 1;
+            shift = rateGiven ? 3 : 2;
+        }
+        argv[shift] = argv[0];
+        argv += shift;
+        argc -= shift;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-daemon") == 0)
+        return TrackerClient::benchmarkDaemon(argc > 2 ? atoi(argv[2]) : 256);
+    if (argc > 1 && strcmp(argv[1], "--bench-contention") == 0)
+        return bench_contention(argc > 2 ? atoi(argv[2]) : 8);
+    if (argc > 1 && strcmp(argv[1], "--bench-ids") == 0)
+        return bench_ids(argc > 2 ? atoi(argv[2]) : 4);
+    if (argc > 1 && strcmp(argv[1], "--bench-snapshot") == 0)
+        return bench_snapshot(argc > 2 ? atoi(argv[2]) : 2);
+    if (argc > 1 && strcmp(argv[1], "--bench-dispatch") == 0)
+        return bench_dispatch(argc > 2 ? atoi(argv[2]) : 256);
+    if (argc > 1 && strcmp(argv[1], "--bench-trace") == 0)
+        return bench_trace(argc > 2 ? atof(argv[2]) : 0.01);
+    if (argc > 1 && strcmp(argv[1], "--bench-service") == 0)
+        return bench_service(argc > 2 ? atoi(argv[2]) : 8);
+    if (argc > 1 && strcmp(argv[1], "--tail-feed") == 0) {
+        FeedFilter filter;
+        if (argc > 3 && strcmp(argv[3], "*") != 0)
+            filter.product = argv[3];
+        filter.state = argc > 4 ? atoi(argv[4]) : -1;
+        return ChangeFeed::tailFeed(argc > 2 ? atoll(argv[2]) : -1, filter);
+    }
+    if (argc > 1 && strcmp(argv[1], "--migrate-partitions") == 0)
+        return StorageLayout::migrateToPartitions() ? 0 : 1;
+    if (argc > 1 && strcmp(argv[1], "--scrub") == 0)
+        return RecordChecksum::scrub(argc > 2 ? argv[2] : ".", argc > 3 ? atof(argv[3]) : 0, std::cout);
+    if (argc > 1 && strcmp(argv[1], "--upgrade-files") == 0)
+        return FileFormat::rewrite(StorageLayout::dataFiles("."), argc > 2 ? atof(argv[2]) : 0, std::cout);
+    if (argc > 1 && strcmp(argv[1], "--archive-items") == 0)
+        return ItemArchive::archiveClosed(argc > 2 ? atoi(argv[2]) : DEFAULT_ARCHIVE_AGE_DAYS, std::cout) < 0 ? 1 : 0;
+    if (argc > 1 && strcmp(argv[1], "--archive-stats") == 0) {
+        ItemArchive::printStats(std::cout);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--history") == 0)
+        return ItemHistory::printHistory(atoi(argv[2]), argc > 3 ? argv[3] : nullptr);
+    if (argc > 1 && strcmp(argv[1], "--cycle-times") == 0)
+        return ItemHistory::printCycleTimes(argc > 2 ? argv[2] : "");
+    if (argc > 1 && strcmp(argv[1], "--replica-status") == 0)
+        return Replica::printStatus(argc > 2 ? argv[2] : DEFAULT_SOCKET_PATH);
+    if (argc > 1 && strcmp(argv[1], "--promote") == 0)
+        return Replica::requestPromotion(argc > 2 ? argv[2] : DEFAULT_SOCKET_PATH);
+
     // Start-up operations for the system.
     systemStartup();
 
+    if (argc > 2 && strcmp(argv[1], "--release-status") == 0) {
+        int status = ReleaseIndex::printRelease(argv[2], argc > 3 ? argv[3] : "");
+        systemShutdown(status);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--most-requested") == 0) {
+        int count = argc > 2 ? atoi(argv[2]) : 10;
+        int status = RequestLinks::printMostRequested(count > 0 ? static_cast<size_t>(count) : 10);
+        systemShutdown(status);
+    }
+
+    if (argc > 2 && strcmp(argv[1], "--query") == 0) {
+        int status = strcmp(argv[2], "-") == 0 ? Query::runLines(std::cin, std::cout) : Query::run(argv[2], std::cout);
+        systemShutdown(status);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--filter-stats") == 0) {
+        int status = BloomFilter::printStats();
+        systemShutdown(status);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--leases") == 0) {
+        int status = WorkQueue::printLeases(std::cout);
+        systemShutdown(status);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--daemon") == 0) {
+        const char* socketPath = argc > 2 ? argv[2] : DEFAULT_SOCKET_PATH;
+        int threadCount = argc > 3 ? atoi(argv[3]) : 0;
+        if (!TrackerDaemon::runDaemon(socketPath, threadCount)) {
+            std::cerr << "Failed to start the daemon." << std::endl;
+            return 1;
+        }
+        systemShutdown();
+        return 0;
+    }
+
+    if (argc > 2 && strcmp(argv[1], "--follow") == 0) {
+        int status = Replica::runFollower(argv[2], argc > 3 ? argv[3] : DEFAULT_SOCKET_PATH, argc > 4 ? atoi(argv[4]) : 0);
+        if (status != 0)
+            return status;
+        systemShutdown();
+        return 0;
+    }
+
     // Running the user interface loop.
     runUserInterface();
 
@@ -7,6 +7,17 @@
  *      - Changed while loop in queryProducts
  *      - Removed seekFromBeg
  *      - Overloaded comparison operator to compare products
+ * - 2026-10-19: New products are published to the change feed.
+ * - 2026-10-19: Added getProductNameView.
+ * - 2026-10-19: Record sizes come from the record schema.
+ * - 2026-10-19: The duplicate name check consults a persisted Bloom filter first.
+ * - 2026-10-19: Products are written with checksums and verified when read.
+ * - 2026-10-19: The data file is brought up to the current record version when it is opened.
+ * - 2026-10-19: Operations timed for the metrics endpoint.
+ * - 2026-10-19: queryProducts is traced as a span.
+ * - 2026-10-19: queryProducts and createProduct replaced by listProducts and exists; prompting moved to the UI.
+ * - 2026-10-19: exists reads through its own stream.
+ * - 2026-10-19: New products are appended under the file's cross-process append lock.
  * -------------------------------------------------------------------------
  * Purpose:
  * This file contains the implementation of the Product module, showing the 
@@ -16,9 +27,22 @@
  **********************************************/
 
 #include "product.h"
+#include "BloomFilter.h"
+#include "ChangeFeed.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "Metrics.h"
+#include "RecordChecksum.h"
+#include "Trace.h"
+#include <filesystem>
 #include <string>
 using namespace std;
 
+//================================
+// Constants
+//================================
+static const std::streamsize RECORD_SIZE = Schema<Product>::SIZE;   // A product record is its name
+
 //================================
 // Static Variables
 //================================
@@ -26,6 +50,17 @@ static std::fstream pfio;
 /* Module scope variable of the file where products are stored. Must be static in order to make it usable by all functions.
 Opened in initProduct(). */
 
+// Passes the name in a packed product record to visit.
+static void productKeys(const char* record, const BloomFilter::KeyVisitor& visit) {
+    visit(Schema<Product>::text<Product::FIELD_NAME>(record));
+}
+
+static std::vector<std::string> productFiles() {
+    return {"Product.txt"};
+}
+
+static BloomFilter productFilter(PRODUCT_FILTER_FILE, "Product.txt", FILTER_LOCK_OFFSET, RECORD_SIZE, productFiles, productKeys);
+
 //================================
 // Function Implementations
 //================================
@@ -39,6 +74,8 @@ Opened in initProduct(). */
  * Returns: bool - True if the file is successfully opened and initialized, false otherwise.
  **********************************************/
 bool Product::initProduct() {
+    if (!FileFormat::ensureCurrent("Product.txt")) // A small file, upgraded whole when first opened
+        return false;
     pfio.open("Product.txt", ios::out | ios::in | ios::app | ios::binary);
 
     if(!pfio.good()){
@@ -48,6 +85,8 @@ bool Product::initProduct() {
 
     pfio.seekp(0, ios::end);
     pfio.seekg(0);
+    RecordChecksum::init("Product.txt", RECORD_SIZE);
+    productFilter.init();
     return true;
 }
 
@@ -58,11 +97,19 @@ bool Product::initProduct() {
  * Parameters: const char* n - The name of the product.
  **********************************************/
 Product::Product(const char* n) {   
+        Metrics::Timer timer(Metrics::PRODUCT_CREATE);
         strcpy(name, n);
-        pfio.write(reinterpret_cast<char *>(name), 11);
-        pfio.flush();
-
-        cout << "Product created!" << endl;
+        productFilter.growIfFull(); // Before any lock is held, since a rebuild waits for every writer
+        RecordLock appendLock("Product.txt", APPEND_LOCK_OFFSET, 1, true); // Serializes appends across processes
+        BloomFilter::WriteScope filterScope(productFilter);
+        productFilter.add(name);
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size("Product.txt", error);
+        long long offset = error ? 0 : static_cast<long long>(size - size % RECORD_SIZE);
+        RecordChecksum::store("Product.txt", RECORD_SIZE, offset, name, 1); // Before the record, so a torn append fails
+        pfio.write(reinterpret_cast<char *>(name), RECORD_SIZE);
+        pfio.flush(); // Before the append lock is released
+        ChangeFeed::publish(FeedEvent::PRODUCT, FeedEvent::CREATED, -1, name, name, -1, -1, -1);
 }
 
 /**********************************************
@@ -81,9 +128,13 @@ Product::Product() {}
  * Returns: const char* - The product name read from the file.
  **********************************************/
 const char* Product::getNextProduct(char* product) {   
-    if (!pfio.read(reinterpret_cast<char*>(product), 11)) {
-        return nullptr;  // End of file reached or read error
-    }
+    long long position;
+    do {
+        position = static_cast<long long>(pfio.tellg());
+        if (!pfio.read(reinterpret_cast<char*>(product), RECORD_SIZE)) {
+            return nullptr;  // End of file reached or read error
+        }
+    } while (!RecordChecksum::verify("Product.txt", RECORD_SIZE, position, product)); // Damaged products are skipped
     return product;
 }
 
@@ -96,83 +147,59 @@ const char* Product::getNextProduct(char* product) {
  * Returns: const char* - The product name read from the file.
  **********************************************/
 const char* Product::getProduct(char* product, int n) {
-    pfio.seekp(n*11);
-    pfio.read(reinterpret_cast<char *>(product), 11);
+    Metrics::Timer timer(Metrics::PRODUCT_GET);
+    pfio.seekp(n * RECORD_SIZE);
+    pfio.read(reinterpret_cast<char *>(product), RECORD_SIZE);
+    if (!RecordChecksum::verify("Product.txt", RECORD_SIZE, n * RECORD_SIZE, product))
+        product[0] = '\0'; // A damaged product has no name
 
     return product;
 }
 
 /**********************************************
- * Function: queryProducts
+ * Function: exists
  * Description:
- * Finds a specific product in the array holding all the products using its productID.
- * Parameters: None
- * Returns: int - The product ID if found, otherwise an exception is thrown or returns -1 if user wants to exit.
+ * Looks a product up by name. The file is only searched if the lookup filter
+ * has seen the name before, and then through a stream of its own, so lookups
+ * are reentrant and need no initProduct.
+ * Parameters: const std::string& productName - The name to look for.
+ * Returns: bool - True if an intact product record has the name.
  **********************************************/
-int Product::queryProducts() {
-    pfio.seekg(0);
-    char buffer[11];
-    int count = 0;
-    cout << "Please select the product: " << endl << endl;
-    string input = "N";
-    // Loops through reading 5 product names (55 bytes) at a time and
-    // asks the user for input if they want to see the next 5 products
-    // or select a product already listed.
-    // Will break out of loop when customer selects a number or when
-    // the end of the file is reached
-    while(input == "N"){
-        if(!pfio.read(reinterpret_cast<char *>(buffer), 11)){
-            cout << "0) Exit" << endl;
-            cout << "No more products" << endl;
-            cout << "Enter selection: ";
-            cin >> input;
-            break;
-        }
-        count++;
-        cout << count << ") " << buffer << endl;
-        if(count%5 == 0){
-            // if 0 returned user will be exited to previous menu
-            cout << "0) Exit" << endl;
-            cout << "To load next 5 items enter 'N'" << endl;
-            cout << "Enter selection: ";
-            cin >> input;
-        }
+bool Product::exists(const std::string& productName) {
+    if (!productFilter.mayContain(productName))
+        return false;
+    char buffer[RECORD_SIZE];
+    ifstream infile("Product.txt", ios::binary);
+    ChecksumReader checksums("Product.txt", RECORD_SIZE);
+    for (long long position = 0; infile.read(reinterpret_cast<char *>(buffer), RECORD_SIZE); position += RECORD_SIZE) {
+        if (strncmp(productName.c_str(), buffer, RECORD_SIZE) == 0 && checksums.check(position, buffer))
+            return true;
     }
-    pfio.clear();
-    return stoi(input) - 1;
+    productFilter.falsePositive();
+    return false;
 }
 
 /**********************************************
- * Function: createProduct
+ * Function: listProducts
  * Description:
- * Creates a product and stores it in the array holding all the products.
+ * Reads the names of all products in the order they were created. Damaged
+ * records are left out.
  * Parameters: None
- * Returns: true if the product created successfully and false if an existing product with that name exists
+ * Returns: std::vector<std::string> - The product names.
  **********************************************/
-bool Product::createProduct() {
-    string prod;
-    cout << "Enter product name (max 10 char): ";
-    cin >> prod;
-    if(prod.length() > 10){
-        cout << "Enter a name 10 char or less" << endl;
-        return false;
-    }
-    char buffer[11];
-    // the loop goes through the file and checks the product against each word already in the file
-    // one by one and if a match is found the error is reported to the user and false is returned,
-    // if no match is found the loop stops at the end of the file 
+std::vector<std::string> Product::listProducts() {
+    Trace::Span span("product.list", "entity");
+    std::vector<std::string> names;
+    char buffer[RECORD_SIZE];
+    pfio.clear();
     pfio.seekg(0);
-    while(pfio.read(reinterpret_cast<char *>(buffer), 11)){
-        if(strcmp(prod.c_str(), buffer) == 0){
-            cout << "==ERROR==" << endl;
-            cout << "The item you have entered already exists" << endl;
-            pfio.clear();
-            return false;
-        }
+    ChecksumReader checksums("Product.txt", RECORD_SIZE);
+    for (long long position = 0; pfio.read(reinterpret_cast<char *>(buffer), RECORD_SIZE); position += RECORD_SIZE) {
+        if (checksums.check(position, buffer))
+            names.emplace_back(buffer, strnlen(buffer, RECORD_SIZE));
     }
     pfio.clear();
-    new Product(prod.c_str());
-    return true;
+    return names;
 }
 
 /**********************************************
@@ -214,6 +241,15 @@ std::string Product::getProductName() const {
     return std::string(name);
 }
 
+/**********************************************
+ * Function: getProductNameView
+ * Description: Returns the name of the product without copying it.
+ * Returns: std::string_view - Points into this product's name field.
+ **********************************************/
+std::string_view Product::getProductNameView() const {
+    return std::string_view(name, strnlen(name, sizeof(name)));
+}
+
 /**********************************************
  * Function: updateName
  * Description: Updates the name of the product.
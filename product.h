@@ -3,6 +3,10 @@
  * Revision History:
  * - 2024-07-02: Initial version created.
  * - 2024-07-31: Version 2 created
+ * - 2026-10-19: Added getProductNameView.
+ * - 2026-10-19: Added the record schema.
+ * - 2026-10-19: Replaced queryProducts and createProduct with listProducts and exists.
+ * - 2026-10-19: exists may be called from any thread.
  *--------------------------------
  * Purpose: 
  * This module provides a cohesive interface for managing products, including initialization, 
@@ -14,10 +18,14 @@
 #define PRODUCT_H
 
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <iostream>
 #include <stdio.h>
 #include <cstring>
+#include <tuple>
+#include <vector>
+#include "RecordSchema.h"
 
 using namespace std;
 
@@ -62,17 +70,16 @@ class Product {
         // Returns: const char* - The product name read from the file.
 
         //----------------------------------------------------------
-        static int queryProducts();
-        // Description: Finds a specific product in the array holding all the products using its productID.
-        // Exceptions: IdNotFoundException - Thrown if no product with the associated ID is found in the array.
-        //             UninitializedException - Thrown if this function is called before initProduct().
-        // Returns: int - The product ID if found, otherwise an exception is thrown.
+        static bool exists(const std::string& productName);
+        // Description: Looks a product up by name, reading the file only if the lookup filter has seen the name.
+        //              Reads through its own stream, so it may be called from any thread.
+        // Parameters: const std::string& productName - The name to look for.
+        // Returns: bool - True if a product has the name.
 
         //----------------------------------------------------------
-        static bool createProduct();
-        // Description: Creates a product and stores it in the array holding all the products.
-        // Exceptions: KeyUniquenessException - Thrown if there is already a product with the same name.
-        //             UninitializedException - Thrown if this function is called before initProduct().
+        static std::vector<std::string> listProducts();
+        // Description: Reads the names of all products in the order they were created, without prompting.
+        // Returns: std::vector<std::string> - The product names; damaged records are left out.
 
         //----------------------------------------------------------
         static void closeProduct();
@@ -85,9 +92,29 @@ class Product {
 
         std::string getProductName() const;
 
+        std::string_view getProductNameView() const;
+        // Description: Returns the name without copying it; valid while the product is.
+
         void updateName(const char* newName);
 
+        //=============================
+        // Schema Declarations
+        //=============================
+        enum Field : size_t {   // Stored fields, in file order
+            FIELD_NAME,
+            FIELD_COUNT
+        };
+
     private:
+        friend class Schema<Product>;
+        static constexpr auto schemaFields() {
+            return std::make_tuple(SchemaField<&Product::name>{"name"});
+        }
+
         char name[11];
 };
+
+static_assert(Schema<Product>::COUNT == Product::FIELD_COUNT, "Product fields and schema disagree");
+static_assert(Schema<Product>::SIZE == 11, "Product records are 11 bytes in Product.txt");
+static_assert(Schema<Product>::PACKED_IN_MEMORY, "Products are embedded in other records as they are in memory");
 #endif
\ No newline at end of file
@@ -8,6 +8,17 @@
  *      - Switched createRequester to return a boolean value
  *      - Added getLastRequester
  *      - Removed seekFromBeg
+ * - 2026-10-19: New requesters are published to the change feed.
+ * - 2026-10-19: Record and field offsets come from the record schema.
+ * - 2026-10-19: The duplicate email check consults a persisted Bloom filter first.
+ * - 2026-10-19: Requesters are written with checksums; names are read from whole, verified records.
+ * - 2026-10-19: The data file is brought up to the current record version when it is opened.
+ * - 2026-10-19: Operations timed for the metrics endpoint.
+ * - 2026-10-19: queryRequesters is traced as a span.
+ * - 2026-10-19: createRequester and queryRequesters gave way to exists and listRequesters, which do no console I/O.
+ * - 2026-10-19: Added hasName, a lookup by the name a change request carries.
+ * - 2026-10-19: hasName reads through its own stream, so the daemon can call it.
+ * - 2026-10-19: The requester append holds the append sentinel lock of req.txt.
  * -------------------------------------------------------------------------
  * Purpose:
  * The implementation of the Requester module shows the composition of each function listed in the header file.
@@ -16,9 +27,27 @@
  **********************************************/
 
 #include "requester.h"
+#include "BloomFilter.h"
+#include "ChangeFeed.h"
+#include "FileFormat.h"
+#include "FileLock.h"
+#include "Metrics.h"
+#include "RecordChecksum.h"
+#include "Trace.h"
+#include <filesystem>
 #include <string>
+#include <string_view>
 using namespace std;
 
+//================================
+// Constants
+//================================
+using RequesterSchema = Schema<Requester>;
+static const std::streamsize RECORD_SIZE = RequesterSchema::SIZE;
+static const std::streamsize NAME_SIZE = RequesterSchema::size<Requester::FIELD_NAME>();
+static const std::streamsize EMAIL_OFFSET = RequesterSchema::offset<Requester::FIELD_EMAIL>();
+static const std::streamsize EMAIL_SIZE = RequesterSchema::size<Requester::FIELD_EMAIL>();
+
 //================================
 // Module scope variable
 //================================
@@ -26,6 +55,32 @@ static std::fstream rfio;
 /* Module scope variable of the file where requesters are stored. Must be static in order to make it usable by all functions.
 Opened in initRequester(). */
 
+// Passes the email in a packed requester record to visit.
+static void requesterKeys(const char* record, const BloomFilter::KeyVisitor& visit) {
+    visit(RequesterSchema::text<Requester::FIELD_EMAIL>(record));
+}
+
+static std::vector<std::string> requesterFiles() {
+    return {"req.txt"};
+}
+
+static BloomFilter requesterFilter(REQUESTER_FILTER_FILE, "req.txt", FILTER_LOCK_OFFSET, RECORD_SIZE, requesterFiles, requesterKeys);
+
+// Reads the whole record at offset, so its checksum can be verified, and copies its name.
+// A damaged record reads as an empty name.
+static bool readName(long long offset, char* name) {
+    Metrics::Timer timer(Metrics::REQUESTER_GET);
+    char record[RECORD_SIZE];
+    rfio.seekg(offset, ios::beg);
+    bool read = static_cast<bool>(rfio.read(record, RECORD_SIZE));
+    bool intact = read && RecordChecksum::verify("req.txt", RECORD_SIZE, offset, record);
+    if (intact)
+        memcpy(name, record, NAME_SIZE);
+    else
+        name[0] = '\0';
+    return read;
+}
+
 //================================
 // Function implementations
 //================================
@@ -39,6 +94,8 @@ Opened in initRequester(). */
  * Returns: bool: True if the file was opened successfully, otherwise false.
  **********************************************/
 bool Requester::initRequester() {
+    if (!FileFormat::ensureCurrent("req.txt")) // A small file, upgraded whole when first opened
+        return false;
     rfio.open("req.txt", ios::out | ios::in | ios::app | ios::binary);
 
     if(!rfio.good()){
@@ -48,6 +105,8 @@ bool Requester::initRequester() {
 
     rfio.seekg(0);
     rfio.seekp(0, ios::end);
+    RecordChecksum::init("req.txt", RECORD_SIZE);
+    requesterFilter.init();
     return true;
 }
 
@@ -68,15 +127,23 @@ Requester::Requester(
     const char* mail,         
     const char* dept   
 ) {
+    Metrics::Timer timer(Metrics::REQUESTER_CREATE);
     strcpy(name, n);
     strcpy(phoneNumber, num);
     strcpy(email, mail);
     strcpy(department, dept);
+    requesterFilter.growIfFull(); // Before any lock is held, since a rebuild waits for every writer
+    RecordLock appendLock("req.txt", APPEND_LOCK_OFFSET, 1, true); // Serializes appends across processes
+    BloomFilter::WriteScope filterScope(requesterFilter);
+    requesterFilter.add(email);
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size("req.txt", error);
+    long long offset = error ? 0 : static_cast<long long>(size - size % RECORD_SIZE);
+    RecordChecksum::store("req.txt", RECORD_SIZE, offset, this, 1); // Before the record, so a torn append fails
     rfio.seekp(0, ios::end);
-    rfio.write(reinterpret_cast<char *>(this), 81);
-    rfio.flush();
-
-    cout << "Requester added!" << endl;
+    rfio.write(reinterpret_cast<char *>(this), RECORD_SIZE);
+    rfio.flush(); // Before the append lock is released
+    ChangeFeed::publish(FeedEvent::REQUESTER, FeedEvent::CREATED, -1, "", email, -1, -1, -1);
 }
 
 /**********************************************
@@ -88,77 +155,64 @@ Requester::Requester(
 Requester::Requester(){}
 
 /**********************************************
- * Function: createRequester
+ * Function: exists
  * Description:
- * This function will create a new employee or customer requester and add them to the file holding the requesters.
- * Prompts the user for details like name, phone number, email, and department.
- * Parameters: None
- * Returns: true if the requester is successfully added or false if the requester already exists or if input length too long.
+ * Looks a requester up by their unique email. The file is only searched if the
+ * lookup filter has seen the email before.
+ * Parameters:
+ * - mail: The email to look for
+ * Returns: bool: True if an intact requester record has the email.
  **********************************************/
-bool Requester::createRequester() {   
-    string name;
-    string num;
-    string mail;
-    string dept;
-    cout << "New Requester: " << endl;
-    // get email first and check for matching a matching email already in the file
-    cout << "Email (24 char or less): ";
-    cin >> mail;
-    if(mail.length() > 24){
-        cout << "Enter an email 24 char or less" << endl;
+bool Requester::exists(const std::string& mail) {
+    if(!requesterFilter.mayContain(mail))
         return false;
-    }
-    char buffer[25];
-    rfio.seekg(43, ios::beg);
-    // the loop goes through the file and checks the product against each word already in the file
-    // one by one and if a match is found the error is reported to the user and false is returned,
-    // if no match is found the loop stops at the end of the file 
-    while(rfio.read(reinterpret_cast<char *>(buffer), 25)){
-        if(strcmp(mail.c_str(), buffer) == 0){
-            cout << "==ERROR==" << endl;
-            cout << "The item you have entered already exists" << endl;
+    char buffer[RECORD_SIZE];
+    rfio.clear();
+    rfio.seekg(0, ios::beg);
+    ChecksumReader checksums("req.txt", RECORD_SIZE);
+    for(long long position = 0; rfio.read(reinterpret_cast<char *>(buffer), RECORD_SIZE); position += RECORD_SIZE){
+        if(strcmp(mail.c_str(), buffer + EMAIL_OFFSET) == 0 && checksums.check(position, buffer)){
             rfio.clear();
-            return false;
+            return true;
         }
-        rfio.seekg(56, ios::cur);
     }
     rfio.clear();
-    cout << "Name (30 char max): ";
-    cin.ignore();
-    getline(cin, name);
-    if(name.length() > 30){
-        cout << "Enter a name 30 char or less" << endl;
-        return false;
-    }
-    cout <<  "Phone Number (11 digits max, no dashes): ";
-    cin >> num;
-    if(num.length() > 11){
-        cout << "Enter a number 11 char or less" << endl;
-        return false;
-    }
-    cout << "Department (12 char or less): ";
-    cin.ignore();
-    getline(cin, dept);
-    if(dept.length() > 12){
-        cout << "Enter a department name 12 char or less" << endl;
-        return false;
+    requesterFilter.falsePositive();
+    return false;
+}
+
+/**********************************************
+ * Function: hasName
+ * Description:
+ * Looks a requester up by name, as a change request names them. Names are not
+ * unique and the lookup filter holds emails, so the whole file is read, through
+ * a stream of its own so that lookups are reentrant and need no initRequester.
+ * Parameters:
+ * - name: The name to look for
+ * Returns: bool: True if an intact requester record has the name.
+ **********************************************/
+bool Requester::hasName(const std::string& name) {
+    char buffer[RECORD_SIZE];
+    ifstream infile("req.txt", ios::binary);
+    ChecksumReader checksums("req.txt", RECORD_SIZE);
+    for(long long position = 0; infile.read(reinterpret_cast<char *>(buffer), RECORD_SIZE); position += RECORD_SIZE){
+        if(name == std::string_view(buffer, strnlen(buffer, NAME_SIZE)) && checksums.check(position, buffer))
+            return true;
     }
-    new Requester(name.c_str(), num.c_str(), mail.c_str(), dept.c_str());
-    return true;
+    return false;
 }
 
 /**********************************************
  * Function: getNextRequester
  * Description:
  * This function will get the next requester name to be read from the file.
- * Reads the next 31 bytes of data from the file into the provided char array.
+ * Reads the next record and copies its name into the provided char array; a damaged record gives an empty name.
  * Parameters: 
  * - name: The char array to store the requester name
  * Returns: const char*: The requester name
  **********************************************/
 const char* Requester::getNextRequester(char* name) {
-    rfio.read(reinterpret_cast<char *>(name), 31);
-    rfio.seekg(50, ios::cur);
+    readName(static_cast<long long>(rfio.tellg()), name);
 
     return name;
 }
@@ -167,15 +221,15 @@ const char* Requester::getNextRequester(char* name) {
  * Function: getLastRequester
  * Description:
  * This function will get the last requester name to added to the file.
- * Should be used after using createRequester when the programmer needs the
+ * Should be used after adding a requester when the programmer needs the
  * requesters name to add to the changeRequest.
  * Parameters: 
  * - name: The char array to store the requester name
  * Returns: const char*: The requester name
  **********************************************/
 const char* Requester::getLastRequester(char* name) {
-    rfio.seekg(-81, ios::end);
-    rfio.read(reinterpret_cast<char *>(name), 31);
+    rfio.seekg(-RECORD_SIZE, ios::end);
+    readName(static_cast<long long>(rfio.tellg()), name);
     rfio.seekg(0);
 
     return name;
@@ -192,59 +246,32 @@ const char* Requester::getLastRequester(char* name) {
  * Returns: const char*: The requester name
  **********************************************/
 const char* Requester::getRequester(char* name, int n) {
-    rfio.seekg(n * 81, ios::beg);
-    rfio.read(reinterpret_cast<char *>(name), 31);
+    readName(n * RECORD_SIZE, name);
 
     return name;
 }
 
 /**********************************************
- * Function: queryRequesters
+ * Function: listRequesters
  * Description:
- * This function will find a specific requester based on their unique email associated with them.
- * Prompts the user to select a requester from the list.
- * Lists the requesters in batches of 5 and waits for user input to load more or make a selection.
+ * Reads the names of all requesters in the order they were added. Damaged
+ * records are left out.
  * Parameters: None
- * Returns: int: The position of the selected requester
+ * Returns: std::vector<std::string>: The requester names
  **********************************************/
-int Requester::queryRequesters() {
+std::vector<std::string> Requester::listRequesters() {
+    Trace::Span span("requester.list", "entity");
+    std::vector<std::string> names;
+    char buffer[RECORD_SIZE];
     rfio.clear();
     rfio.seekg(0);
-    char buffer[31];
-    int count = 0;
-    cout << "Please select the requester name: " << endl << endl;
-    string input = "N";
-    // Loops through reading 5 product names (55 bytes) at a time and
-    // asks the user for input if they want to see the next 5 products
-    // or select a product already listed.
-    // Will break out of loop when customer selects a number or when
-    // the end of the file is reached
-    while(input == "N"){
-        // if the read pointer cannot read anymore its reached the EOF and there are
-        // no names left
-        if(!rfio.read(reinterpret_cast<char *>(buffer), 31)){
-            cout << "0) Exit" << endl;
-            cout << "No more names" << endl;
-            cout << "Enter selection: ";
-            cin >> input;
-            break;
-        }
-        count++;
-        cout << count << ") " << buffer << endl;
-        // every 5 names the user is prompted for input
-        if(count%5 == 0){
-            // if 0 returned user will be exited to previous menu
-            cout << "0) Exit" << endl;
-            cout << "To load next 5 names enter 'N'" << endl;
-            cout << "Enter selection: ";
-            cin >> input;
-        }
-        // set get pointer to the next name
-        rfio.seekg(50, ios::cur);
+    ChecksumReader checksums("req.txt", RECORD_SIZE);
+    for(long long position = 0; rfio.read(reinterpret_cast<char *>(buffer), RECORD_SIZE); position += RECORD_SIZE){
+        if(checksums.check(position, buffer))
+            names.emplace_back(buffer, strnlen(buffer, NAME_SIZE));
     }
-    // return position of the product user wants and reset file from EOF state
     rfio.clear();
-    return stoi(input) - 1;
+    return names;
 }
 
 /**********************************************
@@ -3,6 +3,9 @@
  * Revision History:
  * - 2024-07-02: Initial version created by Sandeep Dhillon
  * - 2024-07-16: Edits by Jovin Dosanjh
+ * - 2026-10-19: Added the record schema.
+ * - 2026-10-19: Added exists and listRequesters in place of the prompting functions.
+ * - 2026-10-19: Added hasName.
  *--------------------------------
  * Purpose:
  * This header file defines the Requester class, which manages the initialization, creation, querying, and closing of requesters 
@@ -20,6 +23,9 @@
 #include <iostream>
 #include <stdio.h>
 #include <cstring>
+#include <tuple>
+#include <vector>
+#include "RecordSchema.h"
 
 //================================
 // Class Declaration
@@ -36,11 +42,15 @@ public:
     // Description: This function will initialize the file holding the requesters.
 
     //---------------------------------------------------------- 
-    static bool createRequester();
-    // Description: This function will create a new employee or customer requester and add them to the file holding the requesters.
-    // Exceptions: 
-    // A KeyUniquenessException will be thrown if there is already a requester with the same email.
-    // An UninitializedException will be thrown if this function is called before initProduct().
+    static bool exists(const std::string& email);
+    // Description: This function will look a requester up by their unique email, reading the file only if the lookup filter has seen it.
+    // Returns: bool - True if a requester has the email.
+
+    //---------------------------------------------------------- 
+    static bool hasName(const std::string& name);
+    // Description: This function will look for a requester with the name, reading the whole file since names are not unique.
+    //              It reads through its own stream, so it may be called from any thread.
+    // Returns: bool - True if an intact requester record has the name.
 
     //---------------------------------------------------------- 
     Requester(
@@ -65,24 +75,46 @@ public:
 
     //----------------------------------------------------------
     static const char* getRequester(char* name, int n); 
-    // Description: This function will get a specific requester name from the file given the place of the requester name which can be prompted from the user using queryRequesters().
+    // Description: This function will get a specific requester name from the file given the place of the requester name as listed by listRequesters().
 
     //----------------------------------------------------------
-    static int queryRequesters();        
-    // Description: This function will find a specific requester based on their unique email associated with them.
-    // Exceptions: 
-    // A RequesterNotFoundException will be thrown if no requester with the associated email.
-    // An UninitializedException will be thrown if this function is called before initProduct().
+    static std::vector<std::string> listRequesters();
+    // Description: This function will read the names of all requesters in the order they were added, without prompting.
+    // Returns: std::vector<std::string> - The requester names; damaged records are left out.
 
     //---------------------------------------------------------- 
     static void closeRequester();
     // Description: This function will close the file that contains all requesters.
 
+    //=============================
+    // Schema Declarations
+    //=============================
+    enum Field : size_t {   // Stored fields, in file order
+        FIELD_NAME,
+        FIELD_PHONE_NUMBER,
+        FIELD_EMAIL,
+        FIELD_DEPARTMENT,
+        FIELD_COUNT
+    };
+
 private:
+    friend class Schema<Requester>;
+    static constexpr auto schemaFields() {
+        return std::make_tuple(SchemaField<&Requester::name>{"name"},
+                               SchemaField<&Requester::phoneNumber>{"phoneNumber"},
+                               SchemaField<&Requester::email>{"email"},
+                               SchemaField<&Requester::department>{"department"});
+    }
+
     char name[31];
     char phoneNumber[12];
     char email[25];
     char department[13];
 };
 
+static_assert(Schema<Requester>::COUNT == Requester::FIELD_COUNT, "Requester fields and schema disagree");
+static_assert(Schema<Requester>::SIZE == 81, "Requester records are 81 bytes in req.txt");
+static_assert(Schema<Requester>::offset<Requester::FIELD_EMAIL>() == 43, "The email is the key of req.txt");
+static_assert(Schema<Requester>::PACKED_IN_MEMORY, "Requesters are written as they are in memory");
+
 #endif // REQUESTER_H
@@ -6,6 +6,20 @@
  * - 2024-07-16: Added the logic to each function except control_createRequest, control_updateItemPriority, 
  * control_viewReport, control_updateItemState, initRequest, closeRequest.
  * - 2024-07-31: ADded the logic for all the functions that werent implemented in previous releases.
+ * - 2026-10-19: Item updates are read first and written with compare-and-swap.
+ * - 2026-10-19: initRequest initializes the change requests; closing gives back unused change IDs.
+ * - 2026-10-19: Item lookups for updates use the non-throwing findChangeItem.
+ * - 2026-10-19: Added control_bulkUpdateItems.
+ * - 2026-10-19: control_viewReport prints release readiness from the release index.
+ * - 2026-10-19: Change requests are linked to the selected change item; added control_viewRequests.
+ * - 2026-10-19: Added control_runQuery.
+ * - 2026-10-19: Added control_takeNextItem.
+ * - 2026-10-19: Each control function is traced as a span.
+ * - 2026-10-19: The create, view, update and report scenarios prompt, call TrackerService and print its response; removed queryProducts, createItem and queryItems.
+ * - 2026-10-19: The bulk update asks again for a priority or priority range out of bounds.
+ * - 2026-10-19: Item pickers list through a QueryArena and ChangeItemView.
+ * - 2026-10-19: The new-release prompt shows the release ID format.
+ * - 2026-10-19: Bulk update, take-next-item and view-requests go through TrackerService.
  * -------------------------------------------------------------------------
  * Purpose:
  * This file implements the scenario control module. It contains functions 
@@ -19,12 +33,185 @@
 #include "ProductRelease.h"
 #include "Requester.h"
 #include "ChangeItem.h"
-#include "requester.h"
 #include "ChangeRequest.h"
+#include "ReleaseIndex.h"
+#include "RequestLinks.h"
+#include "Query.h"
+#include "RecordView.h"
+#include "Trace.h"
+#include "TrackerService.h"
+#include "WorkQueue.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 using namespace std;
+//================================
+// Constants
+//================================
+static const char* STATE_LABELS[] = {"Assessed", "In-Progress", "Done", "Cancelled"};
+
+//================================
+// Helper Functions
+//================================
+
+/**********************************************
+ * Function: show
+ * Description: Prints the message of a service response, on cerr if it failed.
+ * Parameters:
+ * - response: The response to print
+ * Returns: bool - True if the request succeeded.
+ **********************************************/
+static bool show(const ServiceResponse& response) {
+    if (response.ok())
+        cout << response.message << endl;
+    else
+        cerr << "==ERROR==" << endl << response.message << endl;
+    return response.ok();
+}
+
+/**********************************************
+ * Function: pickFrom
+ * Description: Lists entries a page at a time and lets the user pick one.
+ *              The user enters 'N' for the next page or 0 to exit.
+ * Parameters:
+ * - entries: The entries to list; any vector of strings or string views
+ * - heading: Printed above the list
+ * - page: Entries listed before each prompt
+ * - extra: An option offered after the last entry, e.g. "Add new ChangeItem", or nullptr
+ * Returns: int - The index of the entry picked, entries.size() for the extra option, or -1 to exit.
+ **********************************************/
+template <typename Entries>
+static int pickFrom(const Entries& entries, const string& heading, size_t page, const char* extra = nullptr) {
+    cout << heading << endl << endl;
+    size_t shown = 0;
+    size_t options = entries.size() + (extra != nullptr ? 1 : 0);
+    string input = "N";
+    while (input == "N") {
+        size_t end = min(shown + page, entries.size());
+        for (; shown < end; shown++)
+            cout << shown + 1 << ") " << entries[shown] << endl;
+        bool last = shown == entries.size();
+        if (last && extra != nullptr)
+            cout << entries.size() + 1 << ") " << extra << endl;
+        cout << "0) Exit" << endl;
+        if (last)
+            cout << "End of list" << endl;
+        else
+            cout << "To load the next " << page << " enter 'N'" << endl;
+        cout << "Enter selection: ";
+        if (!(cin >> input))
+            return -1;
+        if (input == "N" && last)
+            cout << "End of list, please choose an option" << endl;
+    }
+    int selection = atoi(input.c_str());
+    if (selection < 1 || static_cast<size_t>(selection) > options)
+        return -1;
+    return selection - 1;
+}
+
+/**********************************************
+ * Function: pickProduct
+ * Description: Lets the user pick a product from the list of products.
+ * Returns: string - The product's name, or "" if the user exited.
+ **********************************************/
+static string pickProduct() {
+    vector<string> products = TrackerService::products();
+    int picked = pickFrom(products, "Please select the product: ", 5);
+    return picked < 0 ? "" : products[static_cast<size_t>(picked)];
+}
+
+/**********************************************
+ * Function: pickState
+ * Description: Asks for a change item state until a valid one is entered.
+ * Returns: int - The state, or -1 if the user exited.
+ **********************************************/
+static int pickState() {
+    int selection;
+    do {
+        for (int state = ChangeItem::ASSESSED; state <= ChangeItem::CANCELLED; state++)
+            cout << state + 1 << ") " << STATE_LABELS[state] << endl;
+        cout << "0) Exit" << endl;
+        cout << "Enter Selection: ";
+        if (!(cin >> selection))
+            return -1;
+    } while (selection < 0 || selection > 4);
+    return selection - 1;
+}
+
+/**********************************************
+ * Function: promptNewRequester
+ * Description: Asks for a new requester's details and adds them.
+ * Parameters:
+ * - name: Receives the requester's name
+ * Returns: bool - True if the requester was added.
+ **********************************************/
+static bool promptNewRequester(string& name) {
+    CreateRequesterRequest request;
+    cout << "New Requester: " << endl;
+    cout << "Email (24 char or less): ";
+    cin >> request.email;
+    cout << "Name (29 char max): ";
+    cin >> ws;
+    getline(cin, request.name);
+    cout << "Phone Number (11 digits max, no dashes): ";
+    cin >> request.phoneNumber;
+    cout << "Department (12 char or less): ";
+    cin >> ws;
+    getline(cin, request.department);
+    if (!show(TrackerService::createRequester(request)))
+        return false;
+    name = request.name;
+    return true;
+}
+
+/**********************************************
+ * Function: pickItem
+ * Description: Lets the user pick a change item of a product, or ask for a new one
+ *              and enter its details into the request.
+ * Parameters:
+ * - request: The change request; receives the change ID or the new item's details
+ * Returns: bool - False if the user exited.
+ **********************************************/
+static bool pickItem(CreateRequestRequest& request) {
+    QueryArena arena;
+    ListItemsResponse items = TrackerService::listItems({request.product}, arena);
+    if (!show(items))
+        return false;
+    ArenaVector<string_view> descriptions = arena.vector<string_view>();
+    for (const ChangeItem& item : items.items)
+        descriptions.push_back(ChangeItemView(item).description());
+    int picked = pickFrom(descriptions, "Please select a ChangeItem", 20, "Add new ChangeItem");
+    if (picked < 0)
+        return false;
+    if (static_cast<size_t>(picked) < items.items.size()) {
+        request.changeId = ChangeItemView(items.items[static_cast<size_t>(picked)]).changeId();
+        return true;
+    }
+
+    request.changeId = -1;
+    cout << "Enter a description of the ChangeItem (max 149 char): ";
+    cin >> ws;
+    getline(cin, request.description);
+    cout << "Enter a priority (number between 1-5): ";
+    while (cin >> request.priority && (request.priority < 1 || request.priority > 5))
+        cout << "Not a valid priority. Try again: ";
+    cout << "Enter a status of the ChangeItem: " << endl;
+    int state = pickState();
+    if (state < 0)
+        return false;
+    request.state = static_cast<ChangeItem::State>(state);
+    cout << "Enter the release ID (Format: X.X.X.X): ";
+    cin >> request.releaseId;
+    cout << "Enter the date of the release (YYYY-MM-DD): ";
+    cin >> request.releaseDate;
+    return true;
+}
+
 //================================
 // Function implementations
 //================================
@@ -38,26 +225,18 @@ using namespace std;
  * Returns: void
  **********************************************/
 void control_createRelease() {
-    // Logic for creating a release
+    Trace::Span span("control_createRelease", "scenario");
     char anotherRelease = 'Y';
-    ProductRelease pr;
-    Product p1 = Product();
-    char buffer[11];
-    char okay[40];
-    char date[11];
     do {
-        int n = Product::queryProducts();
-        if(n == -1){
+        CreateReleaseRequest request;
+        request.product = pickProduct();
+        if (request.product.empty())
             return;
-        }
-        cout<< "Enter the releaseID: \n";
-        cin >> okay;
+        cout << "Enter the releaseID (Format: X.X.X.X): \n";
+        cin >> request.releaseId;
         cout << "Enter the date of the release (YYYY-MM-DD): \n";
-        cin >> date;
-        const char* charry = Product::getProduct(buffer,n);
-        p1.updateName(charry);
-        ProductRelease pr(p1, okay, date);
-        ProductRelease::createProductRelease(pr);
+        cin >> request.date;
+        show(TrackerService::createRelease(request));
         std::cout << "Would you like to add another product release?(Y/N): ";
         std::cin >> anotherRelease;
     } while (anotherRelease == 'Y');
@@ -66,51 +245,49 @@ void control_createRelease() {
 /**********************************************
  * Function: control_createRequest
  * Description: Handles the logic for creating a new change request. 
- *              It interacts with the user to input the necessary details, such as requester information, product, and date.
+ *              It interacts with the user to input the necessary details, such as requester information, product, and date,
+ *              and to pick the change item the request is about or describe a new one.
  *              It also allows the user to create multiple change requests in a loop.
  **********************************************/
 void control_createRequest() {
-    // Logic for creating a change request FIX THIS
+    Trace::Span span("control_createRequest", "scenario");
     char anotherRequest = 'Y';
-    //ChangeItem cc = ChangeItem();
-    char buffer[11];
-    std::string smallDate;
-    char name[30];
-    Product pr = Product();
     do {
+        CreateRequestRequest request;
         std::cout << "Create New Change Request:\n";
         std::cout << "Existing Requester? (Y/N)\n";
         char req;
         cin >> req;
 
-        if(req == 'N') {
+        if (req == 'N') {
             req = 'Y';
-                while((req == 'Y') && (!Requester::createRequester())) {
-                cout << "Try again? (Y//N) \n";
+            while ((req == 'Y') && (!promptNewRequester(request.requester))) {
+                cout << "Try again? (Y/N) \n";
                 cin >> req;
             }
-            if(req == 'N'){
+            if (req == 'N')
                 return;
-            }
-        } 
-        int i = Requester::queryRequesters();
-        if(i == -1){
-            return;
+        } else {
+            vector<string> requesters = TrackerService::requesters();
+            int picked = pickFrom(requesters, "Please select the requester name: ", 5);
+            if (picked < 0)
+                return;
+            request.requester = requesters[static_cast<size_t>(picked)];
         }
-        const char* requester = Requester::getRequester(name, i);
-        int v = Product::queryProducts();
-        if(v == -1){
+        request.product = pickProduct();
+        if (request.product.empty())
             return;
-        }
         cout << "Please input the date(YYYY-MM-DD): ";
-        cin >> smallDate;
-        const char* date = smallDate.c_str();
-        const char* products = Product::getProduct(buffer, v);
-        pr.updateName(products);
-        string str(products);
-        ChangeItem::queryChangeItem(str);
-        ChangeRequest ChangeRequest(requester, pr, date);
-        ChangeRequest::createChangeRequest(ChangeRequest);
+        cin >> request.date;
+        if (!pickItem(request))
+            return;
+
+        CreateRequestResponse response = TrackerService::createRequest(request);
+        if (response.releaseCreated)
+            cout << "Product Release created!" << endl;
+        if (response.itemCreated)
+            cout << "ChangeItem " << response.changeId << " created!" << endl;
+        show(response);
         std::cout << "Would you like to add another change request?(Y/N): ";
         std::cin >> anotherRequest;
     } while(anotherRequest == 'Y');
@@ -125,18 +302,34 @@ void control_createRequest() {
  * Returns: void
  **********************************************/
 void control_viewItem() {
-    // Logic for viewing a change item
+    Trace::Span span("control_viewItem", "scenario");
     char anotherViewItem = 'Y';
-    char buffer[11];
     do {
-        int i;
-        i = Product::queryProducts();
-        if(i == -1){
+        string product = pickProduct();
+        if (product.empty())
+            return;
+        QueryArena arena;
+        ListItemsResponse items = TrackerService::listItems({product}, arena);
+        if (!show(items))
             return;
+        ArenaVector<string_view> descriptions = arena.vector<string_view>();
+        for (const ChangeItem& item : items.items)
+            descriptions.push_back(ChangeItemView(item).description());
+        int picked = pickFrom(descriptions, "Please select a ChangeItem", 20);
+        if (picked < 0)
+            return;
+
+        // Read again, as it may have changed since it was listed
+        ViewItemResponse view = TrackerService::viewItem({ChangeItemView(items.items[static_cast<size_t>(picked)]).changeId()});
+        if (show(view)) {
+            std::cout << "Name: " << view.item.product << std::endl;
+            std::cout << "Description: " << view.item.description << std::endl;
+            std::cout << "ChangeID: " << view.item.changeId << std::endl;
+            std::cout << "First Reported: " << view.item.date << std::endl;
+            std::cout << "Priority: " << view.item.priority << std::endl;
+            std::cout << "State: " << STATE_LABELS[view.item.state] << std::endl;
+            std::cout << "Anticipated Release: " << view.item.releaseId << std::endl;
         }
-        const char* charry = Product::getProduct(buffer,i);
-        string str(charry);
-        ChangeItem::displayChangeItems(str);
         std::cout << "Would you like to view another ChangeItem(Y/N): ";
         std::cin >> anotherViewItem;
     } while (anotherViewItem == 'Y');
@@ -146,37 +339,27 @@ void control_viewItem() {
  * Function: control_updateItemState
  * Description: Handles the logic for updating the state of a change item.
  *              It prompts the user for the ChangeId and the new state, then updates the state of the change item.
+ *              The item is read first and only written if nobody changed it in the meantime.
  *              Allows the user to update multiple items in a loop.
  **********************************************/
 void control_updateItemState() {
-    // Logic for updating change item state
+    Trace::Span span("control_updateItemState", "scenario");
     char anotherUpdateItemState = 'Y';
     do{
-        int changeID;
+        UpdateStateRequest request;
         std::cout << "Enter the associated ChangeId of the Change Request: \n";
-        cin >> changeID;
-        int selection;
-        cout << "What status would you like to change this Change Request to: " << endl;
-        cout << "1) Assessed" << endl;
-        cout << "2) In-Progress" << endl;
-        cout << "3) Done" << endl;
-        cout << "4) Cancelled" << endl;
-        cout << "0) Exit" << endl;
-        cout << "Enter Selection: ";
-        cin >> selection;
-        
-        if (selection == 0)
-            return;
-        else if (selection == 1)
-            ChangeItem::updateStatus(ChangeItem::ASSESSED, changeID);
-        else if (selection == 2)
-            ChangeItem::updateStatus(ChangeItem::INPROGRESS, changeID);
-        else if (selection == 3)
-            ChangeItem::updateStatus(ChangeItem::DONE, changeID);
-        else if (selection == 4)
-            ChangeItem::updateStatus(ChangeItem::CANCELLED, changeID);
-        else
-            cout << "Invalid selection." << endl;
+        cin >> request.changeId;
+        ViewItemResponse current = TrackerService::viewItem({request.changeId});
+        if (show(current)) {
+            cout << "Current state: " << STATE_LABELS[current.item.state] << endl;
+            cout << "What status would you like to change this Change Request to: " << endl;
+            int state = pickState();
+            if (state < 0)
+                return;
+            request.state = static_cast<ChangeItem::State>(state);
+            request.expectedVersion = current.item.version;
+            show(TrackerService::updateState(request));
+        }
 
         std::cout << "Would you like to update another item state? (Y/N):  ";
         std::cin >> anotherUpdateItemState;
@@ -187,24 +370,143 @@ void control_updateItemState() {
  * Function: control_updateItemPriority
  * Description: Handles the logic for updating the priority of a change item.
  *              It prompts the user for the ChangeId and the new priority, then updates the priority of the change item.
+ *              The item is read first and only written if nobody changed it in the meantime.
  *              Allows the user to update multiple items in a loop.
  **********************************************/
 void control_updateItemPriority() {
-    // Logic for updating change item priority
+    Trace::Span span("control_updateItemPriority", "scenario");
     char anotherUpdateItemPriority = 'Y';
     do {
-        int changeID;
+        UpdatePriorityRequest request;
         cout << "Enter the associated ChangeId of the Change Item: ";
-        cin >> changeID;
-        int newPriority;
-        cout << "Enter a new Priority(number between 1-5): ";
-        cin >> newPriority;
-        ChangeItem::updatePriority(newPriority, changeID);
+        cin >> request.changeId;
+        ViewItemResponse current = TrackerService::viewItem({request.changeId});
+        if (show(current)) {
+            cout << "Current priority: " << current.item.priority << endl;
+            cout << "Enter a new Priority(number between 1-5): ";
+            cin >> request.priority;
+            request.expectedVersion = current.item.version;
+            show(TrackerService::updatePriority(request));
+        }
         std::cout << "Would you like to update another item priority? (Y/N): ";
         std::cin >> anotherUpdateItemPriority;
     } while(anotherUpdateItemPriority == 'Y');
 }
 
+/**********************************************
+ * Function: control_bulkUpdateItems
+ * Description: Handles the logic for changing the state or the priority of every change item
+ *              matching a product, a release, a state and a priority range at once.
+ *              A "-" for the product or the release, or 0 for the state, matches any.
+ *              Prints how many change items were changed.
+ **********************************************/
+void control_bulkUpdateItems() {
+    Trace::Span span("control_bulkUpdateItems", "scenario");
+    ChangeItem::Selection selection;
+    cout << "Enter the product name (- for any): ";
+    cin >> selection.product;
+    if (selection.product == "-")
+        selection.product.clear();
+    cout << "Enter the anticipated release ID (- for any): ";
+    cin >> selection.releaseId;
+    if (selection.releaseId == "-")
+        selection.releaseId.clear();
+
+    int current;
+    cout << "Current state of the items to update:" << endl;
+    cout << "1) Assessed" << endl;
+    cout << "2) In-Progress" << endl;
+    cout << "3) Done" << endl;
+    cout << "4) Cancelled" << endl;
+    cout << "0) Any" << endl;
+    cout << "Enter Selection: ";
+    cin >> current;
+    if (current < 0 || current > 4) {
+        cout << "Invalid selection." << endl;
+        return;
+    }
+    selection.state = current == 0 ? -1 : current - 1;
+    cout << "Enter the lowest and the highest priority of the items to update (1-5): ";
+    while (cin >> selection.minPriority >> selection.maxPriority &&
+           (selection.minPriority < 1 || selection.maxPriority > 5 || selection.minPriority > selection.maxPriority))
+        cout << "Not a valid priority range. Try again: ";
+
+    int change;
+    cout << "What would you like to change:" << endl;
+    cout << "1) State" << endl;
+    cout << "2) Priority" << endl;
+    cout << "0) Exit" << endl;
+    cout << "Enter Selection: ";
+    cin >> change;
+    if (change == 1) {
+        int newState;
+        cout << "New state (1) Assessed, 2) In-Progress, 3) Done, 4) Cancelled): ";
+        cin >> newState;
+        if (newState < 1 || newState > 4) {
+            cout << "Invalid selection." << endl;
+            return;
+        }
+        show(TrackerService::bulkUpdateState({selection, static_cast<ChangeItem::State>(newState - 1)}));
+    } else if (change == 2) {
+        int newPriority;
+        cout << "Enter a new Priority(number between 1-5): ";
+        while (cin >> newPriority && (newPriority < 1 || newPriority > 5))
+            cout << "Not a valid priority. Try again: ";
+        show(TrackerService::bulkUpdatePriority({selection, newPriority}));
+    }
+}
+
+/**********************************************
+ * Function: control_takeNextItem
+ * Description: Handles the logic for taking the next work item: the ASSESSED change item
+ *              with the best priority, of one product or of any. The item is leased to the
+ *              user and moved to In-Progress; the user then keeps it, renews the lease,
+ *              marks it Done or hands it back. A lease that is not renewed runs out and
+ *              the item waits for the next taker again.
+ **********************************************/
+void control_takeNextItem() {
+    Trace::Span span("control_takeNextItem", "scenario");
+    string holder;
+    string product;
+    cout << "Enter your name: ";
+    cin >> holder;
+    cout << "Enter the product name (- for any): ";
+    cin >> product;
+    if (product == "-")
+        product.clear();
+
+    TakeItemResponse taken = TrackerService::takeItem({product, holder, DEFAULT_LEASE_SECONDS});
+    if (!taken.ok()) {
+        cout << taken.message << endl;
+        return;
+    }
+    cout << "You have ChangeItem " << taken.item.changeId << " of " << taken.item.product
+         << " (priority " << taken.item.priority << "): " << taken.item.description << endl;
+
+    WorkLease lease = taken.lease;
+    int selection;
+    do {
+        cout << "Your lease runs out in " << (DEFAULT_LEASE_SECONDS / 60) << " minutes unless you renew it." << endl;
+        cout << "1) Renew lease" << endl;
+        cout << "2) Mark Done" << endl;
+        cout << "3) Hand back" << endl;
+        cout << "0) Keep working on it" << endl;
+        cout << "Enter Selection: ";
+        cin >> selection;
+        if (selection == 1) {
+            RenewLeaseResponse renewed = TrackerService::renewLease({lease, DEFAULT_LEASE_SECONDS});
+            if (!show(renewed))
+                return;
+            lease = renewed.lease;
+        }
+    } while (selection == 1);
+
+    if (selection == 2)
+        show(TrackerService::finishLease({lease, ChangeItem::DONE}));
+    else if (selection == 3)
+        show(TrackerService::finishLease({lease, ChangeItem::ASSESSED}));
+}
+
 /**********************************************
  * Function: control_createProduct
  * Description:
@@ -214,66 +516,120 @@ void control_updateItemPriority() {
  * Returns: void
  **********************************************/
 void control_createProduct() {
-    // Logic for creating a product
+    Trace::Span span("control_createProduct", "scenario");
     char anotherProduct = 'Y';
     do {
-        Product::createProduct();
+        CreateProductRequest request;
+        cout << "Enter product name (max 10 char): ";
+        cin >> request.name;
+        show(TrackerService::createProduct(request));
         std::cout << "Would you like to add another product?(Y/N): ";
         std::cin >> anotherProduct;
     } while (anotherProduct == 'Y');
 }
 
 /**********************************************
- * Function: queryProducts
+ * Function: control_viewReport
  * Description:
- * Queries the available products.
+ * Controls the viewing of a report: the readiness of a release, i.e. its change
+ * items per state and the ones still open, or an overview of every release of a
+ * product.
  * Parameters: None
  * Returns: void
  **********************************************/
-void queryProducts() {
-    // Logic for querying products
-    Product::queryProducts();
+void control_viewReport() {
+    Trace::Span span("control_viewReport", "scenario");
+    ReportRequest request;
+    cout << "Enter the product name: ";
+    cin >> request.product;
+    cout << "Enter the release ID (- for every release of the product): ";
+    cin >> request.releaseId;
+    if (request.releaseId == "-")
+        request.releaseId.clear();
+    ReportResponse response = TrackerService::report(request);
+    if (response.ok())
+        ReleaseIndex::printReport(cout, request.product, request.releaseId, response.releases, response.items);
+    else
+        cout << response.message << endl;
 }
 
 /**********************************************
- * Function: createItem
+ * Function: control_viewRequests
  * Description:
- * Controls the creation of a new change item.
+ * Controls the viewing of change requests through their links: the requests
+ * about a change item, the requests of a requester, or the change items with
+ * the most requests.
  * Parameters: None
  * Returns: void
  **********************************************/
-void createItem() {
-    // Logic for creating a change item
-    ChangeItem cc = ChangeItem();
-    ChangeItem::createChangeItem(cc);
+void control_viewRequests() {
+    Trace::Span span("control_viewRequests", "scenario");
+    char choice;
+    cout << "1) Requests for a ChangeItem\n"
+         << "2) Requests by a Requester\n"
+         << "3) Most Requested ChangeItems\n"
+         << "Enter selection: ";
+    cin >> choice;
+    if (choice == '1' || choice == '2') {
+        ListRequestsRequest request;
+        if (choice == '1') {
+            cout << "Enter the ChangeItem ID: ";
+            cin >> request.changeId;
+        } else {
+            cout << "Enter the requester name: ";
+            cin >> ws;
+            getline(cin, request.requester);
+        }
+        ListRequestsResponse response = TrackerService::listRequests(request);
+        if (response.ok())
+            RequestLinks::printRequests(response.requests);
+        else
+            cout << response.message << endl;
+    } else if (choice == '3') {
+        int count;
+        cout << "How many ChangeItems? ";
+        cin >> count;
+        MostRequestedResponse response = TrackerService::mostRequested({count > 0 ? static_cast<size_t>(count) : 10});
+        if (response.ok())
+            RequestLinks::printMostRequested(response.items);
+        else
+            cout << response.message << endl;
+    } else {
+        cout << "Invalid option." << endl;
+    }
 }
 
 /**********************************************
- * Function: viewReport
+ * Function: control_runQuery
  * Description:
- * Controls the viewing of a report.
+ * Runs queries typed one per line until an empty line, e.g.
+ * "items where state = ASSESSED group by product", or
+ * "explain requests where item = 3".
  * Parameters: None
  * Returns: void
  **********************************************/
-void control_viewReport() {
-    //Logic for viewing a report
+void control_runQuery() {
+    Trace::Span span("control_runQuery", "scenario");
+    cout << "Enter one query per line, an empty line to finish:\n"
+         << "  [explain] items|requests|releases|requesters [where <column> <op> <value> {and ...}]\n"
+         << "            [group by <column>] [show <column>{,<column>}] [limit <n>]\n"
+         << "  analyze [<source>]\n";
+    cin >> ws;
+    string line;
+    while (cout << "query> " && getline(cin, line) && !line.empty())
+        Query::run(line, cout);
 }
 
 /**********************************************
- * Function: queryItems
+ * Function: initRequest
  * Description:
- * Queries the available change items.
+ * Initializes the change requests.
  * Parameters: None
  * Returns: void
  **********************************************/
-void queryItems() {
-    // Logic for querying change items
-    ChangeItem::queryChangeItem("");
-}
-
 void initRequest() {
     // Logic for initializing requests
-    Requester::initRequester();
+    ChangeRequest::initChangeRequest();
 }
 
 /**********************************************
@@ -327,6 +683,7 @@ void initProduct() {
 void closeRequest() {
     // Logic for closing requests
     ChangeRequest::closeChangeRequest();
+    ChangeRequest::releaseChangeRequestIds();
 }
 
 /**********************************************
@@ -339,6 +696,7 @@ void closeRequest() {
 void closeItem() {
     // Logic for closing items
     ChangeItem::closeChangeItem();
+    ChangeItem::releaseChangeItemIds();
 }
 
 /**********************************************
@@ -2,6 +2,11 @@
  * Scenario Control Header File
  * Revision History:
  * - 2024-07-02: Initial version created.
+ * - 2026-10-19: Added control_bulkUpdateItems.
+ * - 2026-10-19: Added control_viewRequests.
+ * - 2026-10-19: Added control_runQuery.
+ * - 2026-10-19: Added control_takeNextItem.
+ * - 2026-10-19: Removed queryProducts, createItem and queryItems.
  *--------------------------------
  * Purpose: This module contains the declarations for the scenario control functions.
  *          It provides functionalities to manage different scenarios in the system.
@@ -31,6 +36,14 @@ void control_viewItem();
 void control_viewReport();
 // Description: Controls the viewing of reports.
 
+//----------------------------------------------------
+void control_viewRequests();
+// Description: Controls the viewing of change requests by change item or requester, and of the most requested change items.
+
+//----------------------------------------------------
+void control_runQuery();
+// Description: Controls the running of queries over change items, requests, releases and requesters.
+
 //----------------------------------------------------
 void control_updateItemState();
 // Description: Controls the updating of a change item's state.
@@ -40,20 +53,16 @@ void control_updateItemPriority();
 // Description: Controls the updating of a change item's priority.
 
 //----------------------------------------------------
-void control_createProduct();
-// Description: Controls the creation of a new product.
-
-//----------------------------------------------------
-void queryProducts();
-// Description: Queries and lists all products.
+void control_bulkUpdateItems();
+// Description: Controls the updating of the state or priority of every change item matching a selection.
 
 //----------------------------------------------------
-void createItem();
-// Description: Creates a new change item.
+void control_takeNextItem();
+// Description: Controls the leasing of the next work item, the highest-priority assessed change item.
 
 //----------------------------------------------------
-void queryItems();
-// Description: Queries and lists all change items.
+void control_createProduct();
+// Description: Controls the creation of a new product.
 
 //----------------------------------------------------
 void initRequest();
@@ -5,6 +5,7 @@
  * - 2024-07-02: Initial version created.
  * - 2024-07-16: Added the initalize statements to systemStartup and systemShutdown
  * - 2024-07-31: Added init and close statements modules that werent there before.
+ * - 2026-10-19: systemShutdown exits with the status it is given.
  * -------------------------------------------------------------------------
  * Purpose:
  * This file implements the system control module. It contains functions 
@@ -39,14 +40,15 @@ void systemStartup() {
  * Function: systemShutdown
  * Description: 
  * Shuts down the system by releasing resources and performing cleanup tasks.
- * Parameters: None
- * Returns: void
+ * Parameters:
+ * - status: The exit status of the process
+ * Returns: void; does not return
  **********************************************/
-void systemShutdown() {
+void systemShutdown(int status) {
     closeRelease();
     closeProduct();
     closeRequester();
     closeItem();
     closeRequest();
-    exit(0);
+    exit(status);
 }
\ No newline at end of file
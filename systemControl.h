@@ -2,6 +2,7 @@
  * System Control Header File
  * Revision History:
  * - 2024-07-02: Initial version created.
+ * - 2026-10-19: systemShutdown takes the exit status.
  *--------------------------------
  * Purpose: This module contains the declarations for the system control functions.
  *          It provides functionalities to initialize and shut down the system.
@@ -20,7 +21,8 @@ void systemStartup();
 // Description: Initializes the system by loading necessary resources and setting up the environment.
 
 //----------------------------------------------------
-void systemShutdown(); 
-// Description: Shuts down the system by releasing resources and performing cleanup tasks.
+void systemShutdown(int status = 0); 
+// Description: Shuts down the system by releasing resources and performing cleanup tasks, then exits
+//              the process with status, so a command line mode can report its result.
 
 #endif
\ No newline at end of file
@@ -6,6 +6,10 @@
  * - 2024-07-16: Added runUserInterface under each case selection for every switch statement
  * other than the first one, this way the sub-menus return to the main menu when their finished.
  * - 2024-07-31: Fixed the menus to fix up certain input errors.
+ * - 2026-10-19: Added Bulk Update ChangeItems to the update menu.
+ * - 2026-10-19: Added View Change Requests to the view menu.
+ * - 2026-10-19: The view menu runs queries.
+ * - 2026-10-19: Added Take Next Work Item to the update menu.
  * -------------------------------------------------------------------------
  * Purpose:
  * This file implements the user interface module. It contains functions 
@@ -108,6 +112,8 @@ void updateMenu() {
         std::cout << "\nUpdate Menu:\n"
                   << "1) Update ChangeItem State\n"
                   << "2) Update ChangeItem Priority\n"
+                  << "3) Bulk Update ChangeItems\n"
+                  << "4) Take Next Work Item\n"
                   << "0) Exit\n"
                   << "Enter selection: ";
         std::cin >> updateChoice;
@@ -118,6 +124,12 @@ void updateMenu() {
             case '2':
                 control_updateItemPriority();
                 break;
+            case '3':
+                control_bulkUpdateItems();
+                break;
+            case '4':
+                control_takeNextItem();
+                break;
             case '0':
                 return;
             default:
@@ -137,6 +149,8 @@ void viewMenu() {
         std::cout << "\nView Menu:\n"
                   << "1) View Specific ChangeItem\n"
                   << "2) View Reports\n"
+                  << "3) View Change Requests\n"
+                  << "4) Run a Query\n"
                   << "0) Exit\n"
                   << "Enter selection: ";
         std::cin >> viewChoice;
@@ -147,6 +161,12 @@ void viewMenu() {
             case '2':
                 control_viewReport();
                 break;
+            case '3':
+                control_viewRequests();
+                break;
+            case '4':
+                control_runQuery();
+                break;
             case '0':
                 return;
             default: